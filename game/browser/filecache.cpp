@@ -0,0 +1,326 @@
+/**
+  *  \file game/browser/filecache.cpp
+  *  \brief Class game::browser::FileCache
+  */
+
+#include "game/browser/filecache.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/data/defaultvaluefactory.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/bufferedstream.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/directoryentry.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/parser.hpp"
+#include "afl/io/json/writer.hpp"
+#include "afl/io/textfile.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/mutexguard.hpp"
+
+using afl::base::Ptr;
+using afl::base::Ref;
+using afl::io::Directory;
+using afl::io::DirectoryEntry;
+using afl::io::FileSystem;
+using afl::sys::LogListener;
+using afl::sys::MutexGuard;
+
+namespace {
+    const char LOG_NAME[] = "game.browser.cache";
+
+    /* Name of index file. Blobs are named by their hash and cannot clash with this. */
+    const char INDEX_FILE[] = "index.txt";
+
+    /* Name of cache directory in profile */
+    const char CACHE_DIR[] = "cache";
+
+    /* Index fields are separated by tabs; keys and validators must not contain tabs or line breaks. */
+    bool isValidField(const String_t& s)
+    {
+        return s.find_first_of("\t\r\n") == String_t::npos;
+    }
+
+    String_t computeHash(afl::base::ConstBytes_t content)
+    {
+        afl::checksums::SHA1 hasher;
+        hasher.add(content);
+        return hasher.getHashAsHexString();
+    }
+
+    /* Open or create a subdirectory. */
+    Ref<Directory> openSubdirectory(Directory& parent, const String_t& name)
+    {
+        Ref<DirectoryEntry> e = parent.getDirectoryEntryByName(name);
+        if (e->getFileType() != DirectoryEntry::tDirectory) {
+            e->createAsDirectory();
+        }
+        return e->openDirectory();
+    }
+}
+
+const size_t game::browser::FileCache::DEFAULT_MAX_ENTRIES;
+
+game::browser::FileCache::FileCache(afl::base::Ref<afl::io::Directory> dir, afl::sys::LogListener& log, afl::string::Translator& tx)
+    : m_mutex(),
+      m_pProfile(0),
+      m_name(),
+      m_directory(dir.asPtr()),
+      m_directoryFailed(false),
+      m_log(log),
+      m_translator(tx),
+      m_entries(),
+      m_loaded(false),
+      m_dirty(false),
+      m_maxEntries(DEFAULT_MAX_ENTRIES)
+{ }
+
+game::browser::FileCache::FileCache(util::ProfileDirectory& profile, String_t name, afl::sys::LogListener& log, afl::string::Translator& tx)
+    : m_mutex(),
+      m_pProfile(&profile),
+      m_name(name),
+      m_directory(),
+      m_directoryFailed(false),
+      m_log(log),
+      m_translator(tx),
+      m_entries(),
+      m_loaded(false),
+      m_dirty(false),
+      m_maxEntries(DEFAULT_MAX_ENTRIES)
+{ }
+
+game::browser::FileCache::~FileCache()
+{
+    // Save recency information collected by getFile()
+    if (m_dirty && m_directory.get() != 0) {
+        saveIndex(*m_directory);
+    }
+}
+
+void
+game::browser::FileCache::setMaxEntries(size_t n)
+{
+    MutexGuard g(m_mutex);
+    m_maxEntries = n;
+}
+
+afl::base::Ptr<afl::io::FileMapping>
+game::browser::FileCache::getFile(const String_t& key, const String_t& validator)
+{
+    MutexGuard g(m_mutex);
+    Directory* dir = openDirectory();
+    if (dir == 0) {
+        return 0;
+    }
+
+    Entries_t::iterator it = findEntry(key);
+    if (it == m_entries.end() || (!validator.empty() && it->validator != validator)) {
+        return 0;
+    }
+
+    try {
+        Ref<afl::io::FileMapping> content = dir->openFile(it->hash, FileSystem::OpenRead)->createVirtualMapping();
+        if (computeHash(content->get()) != it->hash) {
+            throw afl::except::FileProblemException(it->hash, m_translator("File has been modified"));
+        }
+
+        // Mark most recently used
+        Entry e = *it;
+        m_entries.erase(it);
+        m_entries.push_back(e);
+        m_dirty = true;
+        return content.asPtr();
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Warn, LOG_NAME, afl::string::Format(m_translator("Discarding damaged cache entry for \"%s\""), key), e);
+        removeEntry(*dir, it);
+        saveIndex(*dir);
+        return 0;
+    }
+}
+
+bool
+game::browser::FileCache::hasFile(const String_t& key, const String_t& validator)
+{
+    MutexGuard g(m_mutex);
+    Directory* dir = openDirectory();
+    if (dir == 0) {
+        return false;
+    }
+
+    Entries_t::iterator it = findEntry(key);
+    return it != m_entries.end()
+        && (validator.empty() || it->validator == validator);
+}
+
+void
+game::browser::FileCache::putFile(const String_t& key, const String_t& validator, afl::base::ConstBytes_t content)
+{
+    if (!isValidField(key) || !isValidField(validator)) {
+        return;
+    }
+
+    MutexGuard g(m_mutex);
+    Directory* dir = openDirectory();
+    if (dir == 0) {
+        return;
+    }
+
+    try {
+        // Drop previous version
+        Entries_t::iterator it = findEntry(key);
+        if (it != m_entries.end()) {
+            removeEntry(*dir, it);
+        }
+
+        // Store content unless we already have it
+        const String_t hash = computeHash(content);
+        if (!isReferenced(hash)) {
+            dir->openFile(hash, FileSystem::Create)->fullWrite(content);
+        }
+        m_entries.push_back(Entry(key, validator, hash));
+
+        // Enforce limit
+        while (m_entries.size() > m_maxEntries) {
+            removeEntry(*dir, m_entries.begin());
+        }
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Warn, LOG_NAME, afl::string::Format(m_translator("Unable to store \"%s\" in cache"), key), e);
+    }
+    saveIndex(*dir);
+}
+
+std::auto_ptr<afl::data::Value>
+game::browser::FileCache::getValue(const String_t& key, const String_t& validator)
+{
+    Ptr<afl::io::FileMapping> content = getFile(key, validator);
+    if (content.get() == 0) {
+        return std::auto_ptr<afl::data::Value>();
+    }
+
+    try {
+        afl::data::DefaultValueFactory factory;
+        afl::io::ConstMemoryStream cms(content->get());
+        afl::io::BufferedStream buf(cms);
+        return std::auto_ptr<afl::data::Value>(afl::io::json::Parser(buf, factory).parseComplete());
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Warn, LOG_NAME, afl::string::Format(m_translator("Unable to use cached copy of \"%s\""), key), e);
+        return std::auto_ptr<afl::data::Value>();
+    }
+}
+
+void
+game::browser::FileCache::putValue(const String_t& key, const String_t& validator, const afl::data::Value* value)
+{
+    afl::io::InternalSink sink;
+    afl::io::json::Writer(sink).visit(value);
+    putFile(key, validator, sink.getContent());
+}
+
+afl::io::Directory*
+game::browser::FileCache::openDirectory()
+{
+    // Open directory; called with mutex held
+    if (m_directory.get() == 0 && m_pProfile != 0 && !m_directoryFailed) {
+        try {
+            Ref<Directory> cacheDir = openSubdirectory(*m_pProfile->open(), CACHE_DIR);
+            m_directory = openSubdirectory(*cacheDir, m_name).asPtr();
+        }
+        catch (std::exception& e) {
+            m_log.write(LogListener::Warn, LOG_NAME, m_translator("Unable to open file cache"), e);
+            m_directoryFailed = true;
+        }
+    }
+
+    Directory* dir = m_directory.get();
+    if (dir != 0) {
+        loadIndex(*dir);
+    }
+    return dir;
+}
+
+void
+game::browser::FileCache::loadIndex(afl::io::Directory& dir)
+{
+    // Load index; called with mutex held
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+
+    Ptr<afl::io::Stream> file = dir.openFileNT(INDEX_FILE, FileSystem::OpenRead);
+    if (file.get() == 0) {
+        return;
+    }
+
+    try {
+        // Format: hash, validator, key, separated by tabs. Damaged lines are ignored.
+        afl::io::TextFile tf(*file);
+        String_t line;
+        while (tf.readLine(line)) {
+            String_t::size_type a = line.find('\t');
+            String_t::size_type b = (a == String_t::npos ? a : line.find('\t', a+1));
+            if (b != String_t::npos && a == 2*afl::checksums::SHA1::HASH_SIZE) {
+                String_t key = line.substr(b+1);
+                if (findEntry(key) == m_entries.end()) {
+                    m_entries.push_back(Entry(key, line.substr(a+1, b-a-1), line.substr(0, a)));
+                }
+            }
+        }
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Warn, LOG_NAME, m_translator("Unable to read cache index"), e);
+    }
+}
+
+void
+game::browser::FileCache::saveIndex(afl::io::Directory& dir)
+{
+    // Save index; called with mutex held.
+    // The file is written in-place; if this is interrupted, we lose some cache entries, which is harmless.
+    try {
+        Ref<afl::io::Stream> file = dir.openFile(INDEX_FILE, FileSystem::Create);
+        afl::io::TextFile tf(*file);
+        for (Entries_t::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+            tf.writeLine(it->hash + "\t" + it->validator + "\t" + it->key);
+        }
+        tf.flush();
+        m_dirty = false;
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Warn, LOG_NAME, m_translator("Unable to update cache index"), e);
+    }
+}
+
+game::browser::FileCache::Entries_t::iterator
+game::browser::FileCache::findEntry(const String_t& key)
+{
+    Entries_t::iterator it = m_entries.begin();
+    while (it != m_entries.end() && it->key != key) {
+        ++it;
+    }
+    return it;
+}
+
+void
+game::browser::FileCache::removeEntry(afl::io::Directory& dir, Entries_t::iterator it)
+{
+    // Remove entry, and its content if no other entry refers to it
+    const String_t hash = it->hash;
+    m_entries.erase(it);
+    if (!isReferenced(hash)) {
+        dir.eraseNT(hash);
+    }
+}
+
+bool
+game::browser::FileCache::isReferenced(const String_t& hash) const
+{
+    for (Entries_t::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->hash == hash) {
+            return true;
+        }
+    }
+    return false;
+}
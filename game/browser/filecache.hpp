@@ -0,0 +1,141 @@
+/**
+  *  \file game/browser/filecache.hpp
+  *  \brief Class game::browser::FileCache
+  */
+#ifndef C2NG_GAME_BROWSER_FILECACHE_HPP
+#define C2NG_GAME_BROWSER_FILECACHE_HPP
+
+#include <memory>
+#include <vector>
+#include "afl/base/memory.hpp"
+#include "afl/base/ptr.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/data/value.hpp"
+#include "afl/io/directory.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/string/string.hpp"
+#include "afl/string/translator.hpp"
+#include "afl/sys/loglistener.hpp"
+#include "afl/sys/mutex.hpp"
+#include "util/profiledirectory.hpp"
+
+namespace game { namespace browser {
+
+    /** Local cache for files downloaded from a server.
+        Keeps copies of downloaded files so they can be reused without network access,
+        and, if the network is not available, used instead of the server's copy.
+
+        Each file is identified by a key (e.g. its path name on the server) and a validator.
+        The validator is provided by the server and changes whenever the file changes, e.g. a content hash.
+        A lookup with a validator only succeeds if the stored validator matches;
+        a lookup with an empty validator accepts any stored version.
+
+        Files are stored content-addressed in the cache directory, named by their SHA-1 hash
+        (compare util::doc::FileBlobStore), and an index file maps keys to validators and hashes.
+        Files are verified against their hash when read.
+        The cache is limited to a number of entries; the least recently used entries are discarded first.
+
+        The cache is an optimisation only.
+        Errors are logged and otherwise ignored; a damaged cache behaves like an empty one.
+        All methods can be called from multiple threads. */
+    class FileCache : private afl::base::Uncopyable {
+     public:
+        /** Default limit for number of entries. */
+        static const size_t DEFAULT_MAX_ENTRIES = 500;
+
+        /** Constructor.
+            @param dir  Cache directory
+            @param log  Logger
+            @param tx   Translator */
+        FileCache(afl::base::Ref<afl::io::Directory> dir, afl::sys::LogListener& log, afl::string::Translator& tx);
+
+        /** Constructor for cache in profile directory.
+            The cache will be placed in subdirectory "cache/<name>" of the profile directory,
+            which is created when first needed.
+            @param profile Profile directory
+            @param name    Name of cache
+            @param log     Logger
+            @param tx      Translator */
+        FileCache(util::ProfileDirectory& profile, String_t name, afl::sys::LogListener& log, afl::string::Translator& tx);
+
+        /** Destructor. */
+        ~FileCache();
+
+        /** Set limit for number of entries.
+            The limit is enforced when the next file is stored.
+            @param n Limit */
+        void setMaxEntries(size_t n);
+
+        /** Get file.
+            @param key       Key
+            @param validator Validator; empty to accept any version
+            @return File content; null if the file is not cached or does not match the validator */
+        afl::base::Ptr<afl::io::FileMapping> getFile(const String_t& key, const String_t& validator);
+
+        /** Check presence of file.
+            This does not verify the file content.
+            @param key       Key
+            @param validator Validator; empty to accept any version
+            @return true if file is cached */
+        bool hasFile(const String_t& key, const String_t& validator);
+
+        /** Store file.
+            Replaces a previous version of the file.
+            @param key       Key
+            @param validator Validator; may be empty if the server does not provide one
+            @param content   File content */
+        void putFile(const String_t& key, const String_t& validator, afl::base::ConstBytes_t content);
+
+        /** Get JSON value.
+            Like getFile(), but parses the file as JSON.
+            @param key       Key
+            @param validator Validator; empty to accept any version
+            @return Value; null if the file is not cached, does not match the validator, or cannot be parsed */
+        std::auto_ptr<afl::data::Value> getValue(const String_t& key, const String_t& validator);
+
+        /** Store JSON value.
+            Like putFile(), but stores a value in JSON format.
+            @param key       Key
+            @param validator Validator
+            @param value     Value */
+        void putValue(const String_t& key, const String_t& validator, const afl::data::Value* value);
+
+     private:
+        struct Entry {
+            String_t key;
+            String_t validator;
+            String_t hash;
+            Entry(const String_t& key, const String_t& validator, const String_t& hash)
+                : key(key), validator(validator), hash(hash)
+                { }
+        };
+        typedef std::vector<Entry> Entries_t;
+
+        afl::sys::Mutex m_mutex;
+
+        util::ProfileDirectory* m_pProfile;
+        String_t m_name;
+        afl::base::Ptr<afl::io::Directory> m_directory;
+        bool m_directoryFailed;
+
+        afl::sys::LogListener& m_log;
+        afl::string::Translator& m_translator;
+
+        /** Index, least recently used first. Loaded on first use. */
+        Entries_t m_entries;
+        bool m_loaded;
+        bool m_dirty;
+        size_t m_maxEntries;
+
+        afl::io::Directory* openDirectory();
+        void loadIndex(afl::io::Directory& dir);
+        void saveIndex(afl::io::Directory& dir);
+        Entries_t::iterator findEntry(const String_t& key);
+        void removeEntry(afl::io::Directory& dir, Entries_t::iterator it);
+        bool isReferenced(const String_t& hash) const;
+    };
+
+} }
+
+#endif
@@ -247,6 +247,15 @@ game::interface::PlanetContext::lookup(const afl::data::NameQuery& name, Propert
     }
 }
 
+interpreter::Context::PropertyAccessor*
+game::interface::PlanetContext::getCacheableAccessor(LookupKey& key)
+{
+    // Result of lookup() depends only on the predefined table and the user-defined property names.
+    // Names are never removed from planetPropertyNames(), so its size identifies its state.
+    key = LookupKey(planet_mapping, m_session.world().planetPropertyNames().getNumNames());
+    return this;
+}
+
 void
 game::interface::PlanetContext::set(PropertyIndex_t index, const afl::data::Value* value)
 {
@@ -246,6 +246,15 @@ game::interface::ShipContext::lookup(const afl::data::NameQuery& name, PropertyI
     }
 }
 
+interpreter::Context::PropertyAccessor*
+game::interface::ShipContext::getCacheableAccessor(LookupKey& key)
+{
+    // Result of lookup() depends only on the predefined table and the user-defined property names.
+    // Names are never removed from shipPropertyNames(), so its size identifies its state.
+    key = LookupKey(ship_mapping, m_session.world().shipPropertyNames().getNumNames());
+    return this;
+}
+
 void
 game::interface::ShipContext::set(PropertyIndex_t index, const afl::data::Value* value)
 {
@@ -0,0 +1,140 @@
+/**
+  *  \file game/map/locationindex.cpp
+  *  \brief Class game::map::LocationIndex
+  */
+
+#include <algorithm>
+#include "game/map/locationindex.hpp"
+#include "game/map/configuration.hpp"
+
+/* Sort order for entries: by cell (column-major), then by Id.
+   Entries of one column form a contiguous range, ordered by row. */
+struct game::map::LocationIndex::CompareEntries {
+    bool operator()(const Entry& a, const Entry& b) const
+        {
+            if (a.cellX != b.cellX) {
+                return a.cellX < b.cellX;
+            }
+            if (a.cellY != b.cellY) {
+                return a.cellY < b.cellY;
+            }
+            return a.id < b.id;
+        }
+};
+
+// Constructor.
+game::map::LocationIndex::LocationIndex()
+    : m_entries()
+{ }
+
+// Destructor.
+game::map::LocationIndex::~LocationIndex()
+{ }
+
+// Clear.
+void
+game::map::LocationIndex::clear()
+{
+    m_entries.clear();
+}
+
+// Add an object.
+void
+game::map::LocationIndex::add(Id_t id, Point pt)
+{
+    Entry e;
+    e.cellX = getCell(pt.getX());
+    e.cellY = getCell(pt.getY());
+    e.id = id;
+    e.pos = pt;
+    m_entries.push_back(e);
+}
+
+// Prepare for queries.
+void
+game::map::LocationIndex::sort()
+{
+    std::sort(m_entries.begin(), m_entries.end(), CompareEntries());
+}
+
+// Get number of entries.
+size_t
+game::map::LocationIndex::size() const
+{
+    return m_entries.size();
+}
+
+// Find objects at a location.
+void
+game::map::LocationIndex::findAt(Point pt, std::vector<Id_t>& result) const
+{
+    findInRectangle(pt, pt, result);
+}
+
+// Find objects in a rectangle.
+void
+game::map::LocationIndex::findInRectangle(Point a, Point b, std::vector<Id_t>& result) const
+{
+    const size_t start = result.size();
+    findInRectangleUnsorted(a, b, result);
+    std::sort(result.begin() + start, result.end());
+}
+
+// Find objects near a location, considering map wrap.
+void
+game::map::LocationIndex::findInRange(Point pt, int radius, const Configuration& config, std::vector<Id_t>& result) const
+{
+    // An object is near pt if it is near one of pt's images.
+    // The images of pt are a superset of the offsets needed to reach the object's images.
+    const size_t start = result.size();
+    const Point delta(radius, radius);
+    for (int img = 0, n = config.getNumPointImages(); img < n; ++img) {
+        const Point center = config.getSimplePointAlias(pt, img);
+        findInRectangleUnsorted(center - delta, center + delta, result);
+    }
+    std::sort(result.begin() + start, result.end());
+    result.erase(std::unique(result.begin() + start, result.end()), result.end());
+}
+
+/** Get cell number for a coordinate.
+    Rounds towards negative infinity, so that negative coordinates (which are possible with some map configurations) work.
+    \param coord Coordinate
+    \return cell number */
+int
+game::map::LocationIndex::getCell(int coord)
+{
+    return coord >= 0
+        ? coord / CELL_SIZE
+        : -((-coord + CELL_SIZE - 1) / CELL_SIZE);
+}
+
+/** Find objects in a rectangle, unsorted.
+    \param [in]  a,b    Opposite corners of the rectangle, inclusive; can be in any order
+    \param [out] result Ids are appended here */
+void
+game::map::LocationIndex::findInRectangleUnsorted(Point a, Point b, std::vector<Id_t>& result) const
+{
+    const int minX = std::min(a.getX(), b.getX());
+    const int maxX = std::max(a.getX(), b.getX());
+    const int minY = std::min(a.getY(), b.getY());
+    const int maxY = std::max(a.getY(), b.getY());
+    const int maxCellY = getCell(maxY);
+
+    for (int cx = getCell(minX), maxCellX = getCell(maxX); cx <= maxCellX; ++cx) {
+        // Find first entry of this column that can be in range
+        Entry key;
+        key.cellX = cx;
+        key.cellY = getCell(minY);
+        key.id = 0;
+        std::vector<Entry>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), key, CompareEntries());
+
+        // Check all entries of this column up to the last row in range
+        while (it != m_entries.end() && it->cellX == cx && it->cellY <= maxCellY) {
+            const int x = it->pos.getX(), y = it->pos.getY();
+            if (x >= minX && x <= maxX && y >= minY && y <= maxY) {
+                result.push_back(it->id);
+            }
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/**
+  *  \file game/map/locationindex.hpp
+  *  \brief Class game::map::LocationIndex
+  */
+#ifndef C2NG_GAME_MAP_LOCATIONINDEX_HPP
+#define C2NG_GAME_MAP_LOCATIONINDEX_HPP
+
+#include <vector>
+#include "game/map/point.hpp"
+#include "game/types.hpp"
+
+namespace game { namespace map {
+
+    class Configuration;
+
+    /** Spatial index for map objects.
+        Maps locations to object Ids, to find objects near a location without checking every object.
+
+        Objects are sorted into a grid of square cells.
+        The index is a sorted list of (cell, Id, position) entries;
+        a query looks up the cells covering the requested area and checks the positions of the entries found.
+
+        The index only stores Ids and positions; it does not observe the objects.
+        Its owner (Universe) must rebuild it when objects change.
+        Query results are sorted by Id, so callers that want the first matching object
+        get the same result as a linear scan. */
+    class LocationIndex {
+     public:
+        /** Size of a grid cell, in light years. */
+        static const int CELL_SIZE = 64;
+
+        /** Constructor.
+            Makes an empty index. */
+        LocationIndex();
+
+        /** Destructor. */
+        ~LocationIndex();
+
+        /** Clear.
+            Removes all entries. */
+        void clear();
+
+        /** Add an object.
+            After adding objects, call sort() before querying.
+            \param id Object Id
+            \param pt Position */
+        void add(Id_t id, Point pt);
+
+        /** Prepare for queries.
+            Call after add(). */
+        void sort();
+
+        /** Get number of entries.
+            \return number of entries */
+        size_t size() const;
+
+        /** Find objects at a location.
+            \param [in]  pt     Location. Must be canonical (see Configuration::getCanonicalLocation) to find all objects.
+            \param [out] result Ids of objects at exactly this location are appended here, sorted by Id */
+        void findAt(Point pt, std::vector<Id_t>& result) const;
+
+        /** Find objects in a rectangle.
+            Does not consider map wrap.
+            \param [in]  a,b    Opposite corners of the rectangle, inclusive; can be in any order
+            \param [out] result Ids of objects in the rectangle are appended here, sorted by Id */
+        void findInRectangle(Point a, Point b, std::vector<Id_t>& result) const;
+
+        /** Find objects near a location, considering map wrap.
+            Finds all objects for which an image of the object's location is within a square
+            of the given "radius" around the location, i.e. |dx| <= radius and |dy| <= radius.
+            This includes all objects within a circle of the given radius;
+            callers that want a circle must check the distance (e.g. Configuration::getSquaredDistance).
+            \param [in]  pt       Location
+            \param [in]  radius   Radius (>= 0)
+            \param [in]  config   Map configuration
+            \param [out] result   Ids of objects found are appended here, sorted by Id, without duplicates */
+        void findInRange(Point pt, int radius, const Configuration& config, std::vector<Id_t>& result) const;
+
+     private:
+        struct Entry {
+            int cellX;
+            int cellY;
+            Id_t id;
+            Point pos;
+        };
+        struct CompareEntries;
+
+        std::vector<Entry> m_entries;
+
+        static int getCell(int coord);
+        void findInRectangleUnsorted(Point a, Point b, std::vector<Id_t>& result) const;
+    };
+
+} }
+
+#endif
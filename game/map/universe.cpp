@@ -3,6 +3,7 @@
   *  \brief Class game::map::Universe
   */
 
+#include <algorithm>
 #include "game/map/universe.hpp"
 #include "afl/string/format.hpp"
 #include "game/map/anyplanettype.hpp"
@@ -131,6 +132,11 @@ game::map::Universe::Universe()
       m_explosions(),
       m_drawings(),
       m_universeChanged(false),
+      m_planetLocations(),
+      m_shipLocations(),
+      m_locationIndexValid(false),
+      m_numIndexedPlanets(0),
+      m_numIndexedShips(0),
       m_playedShips(m_ships),
       m_historyShips(m_ships),
       m_playedPlanets(m_planets),
@@ -222,6 +228,7 @@ game::map::Universe::notifyListeners()
 
     /* Tell everyone we did updates */
     if (changed || m_universeChanged) {
+        m_locationIndexValid = false;
         sig_universeChange.raise();
     }
     m_universeChanged = false;
@@ -306,6 +313,9 @@ game::map::Universe::postprocess(PlayerSet_t playingSet, PlayerSet_t availablePl
     }
 
     // FIXME: synthesize scores if a score blanker is used
+
+    // Positions and visibility may have changed
+    m_locationIndexValid = false;
 }
 
 bool
@@ -330,7 +340,16 @@ game::Id_t
 game::map::Universe::findPlanetAt(Point pt) const
 {
     // ex GUniverse::getPlanetAt, global.pas:PlanetAt
-    return AnyPlanetType(const_cast<Universe&>(*this).planets()).findNextObjectAt(pt, 0, false);
+    std::vector<Id_t> ids;
+    planetLocations().findAt(pt, ids);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const Planet* p = m_planets.get(ids[i]);
+        Point pos;
+        if (p != 0 && p->isVisible() && p->getPosition().get(pos) && pos == pt) {
+            return ids[i];
+        }
+    }
+    return 0;
 }
 
 game::Id_t
@@ -367,8 +386,12 @@ game::map::Universe::findGravityPlanetAt(Point pt,
      case HostVersion::Unknown:
      case HostVersion::PHost: {
         /* PHost gravity wells */
-        int sqs = util::squareInteger(config[config.GravityWellRange]());
-        for (Id_t i = ty.getPreviousIndex(0); i != 0; i = ty.getPreviousIndex(i)) {
+        const int range = config[config.GravityWellRange]();
+        int sqs = util::squareInteger(range);
+        std::vector<Id_t> candidates;
+        planetLocations().findInRange(pt, std::max(range, 0), mapConfig, candidates);
+        for (size_t ci = candidates.size(); ci > 0; --ci) {
+            const Id_t i = candidates[ci-1];
             if (const Planet* p = ty.getObjectByIndex(i)) {
                 Point pos;
                 if (p->getPosition().get(pos)) {
@@ -413,7 +436,16 @@ game::map::Universe::findFirstShipAt(Point pt) const
 {
     // ex GUniverse::getAnyShipAt
     // ex shipacc.pas:ShipAt
-    return AnyShipType(const_cast<Universe&>(*this).ships()).findNextObjectAt(pt, 0, false);
+    std::vector<Id_t> ids;
+    shipLocations().findAt(pt, ids);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const Ship* sh = m_ships.get(ids[i]);
+        Point pos;
+        if (sh != 0 && sh->isVisible() && sh->getPosition().get(pos) && pos == pt) {
+            return ids[i];
+        }
+    }
+    return 0;
 }
 
 String_t
@@ -480,7 +512,10 @@ game::map::Universe::findLocationUnitNames(Point pt,
     Id_t myShipId = 0;
     String_t myShipName;
     AnyShipType ty(const_cast<Universe&>(*this).ships());
-    for (Id_t sid = ty.findNextIndex(0); sid != 0; sid = ty.findNextIndex(sid)) {
+    std::vector<Id_t> shipIds;
+    shipLocations().findAt(realPos, shipIds);
+    for (size_t i = 0; i < shipIds.size(); ++i) {
+        const Id_t sid = shipIds[i];
         if (const Ship* sh = ty.getObjectByIndex(sid)) {
             Point shipPos;
             int shipOwner;
@@ -618,6 +653,20 @@ game::map::Universe::findUniversalMinefieldFriendlyCodePlanetId(int forPlayer) c
     return umfPlanet;
 }
 
+const game::map::LocationIndex&
+game::map::Universe::planetLocations() const
+{
+    updateLocationIndex();
+    return m_planetLocations;
+}
+
+const game::map::LocationIndex&
+game::map::Universe::shipLocations() const
+{
+    updateLocationIndex();
+    return m_shipLocations;
+}
+
 int
 game::map::Universe::markObjectsInRange(Point a, Point b, const game::map::Configuration& mapConfig)
 {
@@ -631,3 +680,33 @@ game::map::Universe::markObjectsInRange(Point a, Point b, const game::map::Confi
     return numShips + numPlanets;
 }
 
+/** Rebuild location index if needed. */
+void
+game::map::Universe::updateLocationIndex() const
+{
+    if (!m_locationIndexValid || m_numIndexedPlanets != m_planets.size() || m_numIndexedShips != m_ships.size()) {
+        m_planetLocations.clear();
+        for (Id_t i = 1, n = m_planets.size(); i <= n; ++i) {
+            const Planet* p = m_planets.get(i);
+            Point pos;
+            if (p != 0 && p->isVisible() && p->getPosition().get(pos)) {
+                m_planetLocations.add(i, pos);
+            }
+        }
+        m_planetLocations.sort();
+
+        m_shipLocations.clear();
+        for (Id_t i = 1, n = m_ships.size(); i <= n; ++i) {
+            const Ship* sh = m_ships.get(i);
+            Point pos;
+            if (sh != 0 && sh->isVisible() && sh->getPosition().get(pos)) {
+                m_shipLocations.add(i, pos);
+            }
+        }
+        m_shipLocations.sort();
+
+        m_locationIndexValid = true;
+        m_numIndexedPlanets = m_planets.size();
+        m_numIndexedShips = m_ships.size();
+    }
+}
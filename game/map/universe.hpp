@@ -16,6 +16,7 @@
 #include "game/map/fleettype.hpp"
 #include "game/map/historyshiptype.hpp"
 #include "game/map/ionstormtype.hpp"
+#include "game/map/locationindex.hpp"
 #include "game/map/minefieldtype.hpp"
 #include "game/map/object.hpp"
 #include "game/map/objectvector.hpp"
@@ -292,6 +293,19 @@ namespace game { namespace map {
             \return planet Id; 0 if none */
         Id_t findUniversalMinefieldFriendlyCodePlanetId(int forPlayer) const;
 
+        /** Get location index for planets.
+            Contains all visible planets, i.e. the same as allPlanets().
+            The index is built when needed, and discarded on markChanged() and when notifyListeners() reports a change.
+            Because it does not observe individual objects, callers should verify the objects they find.
+            \return index */
+        const LocationIndex& planetLocations() const;
+
+        /** Get location index for ships.
+            Contains all visible ships, i.e. the same as allShips().
+            \see planetLocations()
+            \return index */
+        const LocationIndex& shipLocations() const;
+
         /** Mark objects within a range of coordinates.
             Coordinates describe a rectangle and can be in any order
             \param a First coordinates
@@ -325,6 +339,14 @@ namespace game { namespace map {
         // Change tracking
         bool m_universeChanged;
 
+        // Location index; built on demand.
+        // Valid if m_locationIndexValid is set and the containers did not change size.
+        mutable LocationIndex m_planetLocations;
+        mutable LocationIndex m_shipLocations;
+        mutable bool m_locationIndexValid;
+        mutable Id_t m_numIndexedPlanets;
+        mutable Id_t m_numIndexedShips;
+
         // Types (required for everything that has a cursor)
         PlayedShipType m_playedShips;
         HistoryShipType m_historyShips;
@@ -340,6 +362,8 @@ namespace game { namespace map {
 
         // Set of players that have reliable data
         PlayerSet_t m_availablePlayers;     // ex data_set
+
+        void updateLocationIndex() const;
     };
 
 } }
@@ -537,6 +561,7 @@ inline void
 game::map::Universe::markChanged()
 {
     m_universeChanged = true;
+    m_locationIndexValid = false;
 }
 
 #endif
@@ -27,15 +27,6 @@ using game::browser::UserCallback;
 
 namespace {
     const char LOG_NAME[] = "game.nu";
-
-    String_t buildUrl(const game::browser::Account& acc)
-    {
-        String_t url = acc.get("url", "http://api." + acc.get("host", "planets.nu") + "/");
-        if (!url.empty() && url[url.size()-1] == '/') {
-            url.erase(url.size()-1);
-        }
-        return url;
-    }
 }
 
 class game::nu::BrowserHandler::LoginTask : public Task_t {
@@ -102,6 +93,7 @@ game::nu::BrowserHandler::BrowserHandler(game::browser::Browser& b, afl::net::ht
     : m_browser(b),
       m_manager(mgr),
       m_defaultSpecificationDirectory(defaultSpecificationDirectory),
+      m_fileCache(b.profile(), "nu", b.log(), b.translator()),
       m_gameList(),
       m_gameListAccount()
 { }
@@ -159,9 +151,17 @@ std::auto_ptr<afl::data::Value>
 game::nu::BrowserHandler::callServer(game::browser::Account& acc,
                                      String_t endpoint,
                                      const afl::net::HeaderTable& args)
+{
+    return callServer(getServerUrl(acc), endpoint, args);
+}
+
+std::auto_ptr<afl::data::Value>
+game::nu::BrowserHandler::callServer(const String_t& serverUrl,
+                                     String_t endpoint,
+                                     const afl::net::HeaderTable& args)
 {
     // Build URL
-    String_t url = buildUrl(acc);
+    String_t url = serverUrl;
     url += endpoint;
 
     afl::net::Url parsedUrl;
@@ -234,6 +234,17 @@ game::nu::BrowserHandler::getGameListPreAuthenticated(game::browser::Account& ac
         afl::net::HeaderTable tab;
         tab.add("apikey", *key);
         m_gameList = callServer(acc, "/account/mygames?version=2", tab);
+
+        // Keep a copy for offline use
+        const String_t cacheKey = makeCacheKey(acc, "mygames");
+        if (m_gameList.get() == 0) {
+            m_gameList = m_fileCache.getValue(cacheKey, String_t());
+            if (m_gameList.get() != 0) {
+                log().write(LogListener::Warn, LOG_NAME, translator()("Server not reachable; using cached game list"));
+            }
+        } else if (afl::data::Access(m_gameList)("games").getArraySize() != 0) {
+            m_fileCache.putValue(cacheKey, String_t(), m_gameList.get());
+        }
     }
     return m_gameList;
 }
@@ -261,3 +272,25 @@ game::nu::BrowserHandler::getDefaultSpecificationDirectory()
 {
     return m_defaultSpecificationDirectory;
 }
+
+game::browser::FileCache&
+game::nu::BrowserHandler::fileCache()
+{
+    return m_fileCache;
+}
+
+String_t
+game::nu::BrowserHandler::getServerUrl(const game::browser::Account& acc)
+{
+    String_t url = acc.get("url", "http://api." + acc.get("host", "planets.nu") + "/");
+    if (!url.empty() && url[url.size()-1] == '/') {
+        url.erase(url.size()-1);
+    }
+    return url;
+}
+
+String_t
+game::nu::BrowserHandler::makeCacheKey(const game::browser::Account& acc, String_t name)
+{
+    return Format("%s@%s:%s", acc.getUser(), acc.getHost(), name);
+}
@@ -11,6 +11,7 @@
 #include "afl/net/http/manager.hpp"
 #include "afl/string/translator.hpp"
 #include "game/browser/browser.hpp"
+#include "game/browser/filecache.hpp"
 #include "game/browser/handler.hpp"
 
 namespace game { namespace nu {
@@ -61,6 +62,21 @@ namespace game { namespace nu {
         std::auto_ptr<afl::data::Value> callServer(game::browser::Account& acc,
                                                    String_t endpoint,
                                                    const afl::net::HeaderTable& args);
+
+        /** Call server, given a server URL.
+            This does not access an Account and can therefore be used from a background thread.
+            @param serverUrl Server URL, see getServerUrl()
+            @param endpoint  Endpoint name (must start with slash, e.g. '/account/mygames?version=2')
+            @param args      Parameters to pass (including `apikey` etc.)
+            @return Raw result; null on error */
+        std::auto_ptr<afl::data::Value> callServer(const String_t& serverUrl,
+                                                   String_t endpoint,
+                                                   const afl::net::HeaderTable& args);
+
+        /** Get server URL for an account.
+            @param acc Account
+            @return URL of API endpoints, without trailing slash */
+        static String_t getServerUrl(const game::browser::Account& acc);
         /** Get game list, pre-authenticated.
             The account must have been logged in already.
             If the account is not or no longer logged in, the request will fail.
@@ -84,12 +100,24 @@ namespace game { namespace nu {
             @return default specification directory as passed to constructor */
         afl::base::Ref<afl::io::Directory> getDefaultSpecificationDirectory();
 
+        /** Access file cache.
+            Keeps downloaded results and game lists for reuse and offline operation.
+            @return file cache */
+        game::browser::FileCache& fileCache();
+
+        /** Make key for file cache.
+            @param acc  Account
+            @param name Item name
+            @return key */
+        static String_t makeCacheKey(const game::browser::Account& acc, String_t name);
+
      private:
         class LoginTask;
 
         game::browser::Browser& m_browser;
         afl::net::http::Manager& m_manager;
         afl::base::Ref<afl::io::Directory> m_defaultSpecificationDirectory;
+        game::browser::FileCache m_fileCache;
 
         // Cache:
         std::auto_ptr<afl::data::Value> m_gameList;
@@ -5,11 +5,18 @@
 
 #include "game/nu/gamestate.hpp"
 #include "afl/base/countof.hpp"
+#include "afl/base/runnable.hpp"
 #include "afl/net/headertable.hpp"
 #include "afl/string/format.hpp"
+#include "afl/sys/mutexguard.hpp"
 #include "game/nu/browserhandler.hpp"
 
+using afl::string::Format;
+using afl::sys::LogListener;
+
 namespace {
+    const char LOG_NAME[] = "game.nu";
+
     // Race names. Nu has these built-in to its JavaScript.
     const char*const RACE_NAMES[][3] = {
         { "The Solar Federation", "The Feds", "Fed" },
@@ -27,7 +34,27 @@ namespace {
     };
 }
 
-
+/* Background task to download a history result.
+   The Account belongs to the game thread; everything needed from it has been copied when the task was posted. */
+class game::nu::GameState::PrefetchTask : public afl::base::Runnable {
+ public:
+    PrefetchTask(GameState& parent, const String_t& serverUrl, const String_t& apiKey, const String_t& cacheKey, int turn)
+        : m_parent(parent), m_serverUrl(serverUrl), m_apiKey(apiKey), m_cacheKey(cacheKey), m_turn(turn)
+        { }
+    virtual void run()
+        {
+            if (!m_parent.isPrefetchCancelled() && !m_parent.m_handler.fileCache().hasFile(m_cacheKey, String_t())) {
+                m_parent.m_handler.log().write(LogListener::Trace, LOG_NAME, Format("Prefetching turn %d of game %d", m_turn, m_parent.m_gameNr));
+                m_parent.downloadHistoryResult(m_serverUrl, m_apiKey, m_cacheKey, m_turn);
+            }
+        }
+ private:
+    GameState& m_parent;
+    const String_t m_serverUrl;
+    const String_t m_apiKey;
+    const String_t m_cacheKey;
+    const int m_turn;
+};
 
 game::nu::GameState::GameState(BrowserHandler& handler, game::browser::Account& acc, int32_t gameNr, size_t hint)
     : m_handler(handler),
@@ -35,11 +62,21 @@ game::nu::GameState::GameState(BrowserHandler& handler, game::browser::Account&
       m_gameNr(gameNr),
       m_hint(hint),
       m_resultValid(false),
-      m_result()
+      m_result(),
+      m_prefetchMutex(),
+      m_prefetchCancelled(false),
+      m_prefetchThread()
 { }
 
 game::nu::GameState::~GameState()
-{ }
+{
+    // Stop prefetching. A download in progress will complete, remaining ones are skipped.
+    {
+        afl::sys::MutexGuard g(m_prefetchMutex);
+        m_prefetchCancelled = true;
+    }
+    m_prefetchThread.reset();
+}
 
 afl::data::Access
 game::nu::GameState::loadResultPreAuthenticated()
@@ -54,6 +91,17 @@ game::nu::GameState::loadResultPreAuthenticated()
             tab.add("activity", "true");  // not sure what this is for...
             m_result = m_handler.callServer(m_account, "/game/loadturn", tab);
             m_resultValid = true;
+
+            // Keep a copy for offline use
+            const String_t cacheKey = BrowserHandler::makeCacheKey(m_account, Format("game%d/current", m_gameNr));
+            if (m_result.get() == 0) {
+                m_result = m_handler.fileCache().getValue(cacheKey, String_t());
+                if (m_result.get() != 0) {
+                    m_handler.log().write(LogListener::Warn, LOG_NAME, m_handler.translator()("Server not reachable; using cached result"));
+                }
+            } else if (afl::data::Access(m_result)("success").toInteger()) {
+                m_handler.fileCache().putValue(cacheKey, String_t(), m_result.get());
+            }
         } else {
             // FIXME: log this failure. Better yet: handle it.
             // Could happen if we open a game without going through the browser first.
@@ -62,6 +110,46 @@ game::nu::GameState::loadResultPreAuthenticated()
     return m_result;
 }
 
+std::auto_ptr<afl::data::Value>
+game::nu::GameState::loadHistoryResultPreAuthenticated(int turn)
+{
+    const String_t cacheKey = getHistoryCacheKey(turn);
+    std::auto_ptr<afl::data::Value> result(m_handler.fileCache().getValue(cacheKey, String_t()));
+    if (result.get() == 0) {
+        if (const String_t* key = m_account.get("api_key")) {
+            result = downloadHistoryResult(BrowserHandler::getServerUrl(m_account), *key, cacheKey, turn);
+        }
+    }
+    return result;
+}
+
+bool
+game::nu::GameState::hasHistoryResult(int turn)
+{
+    return m_handler.fileCache().hasFile(getHistoryCacheKey(turn), String_t());
+}
+
+void
+game::nu::GameState::prefetchHistoryResults(int currentTurn, int count)
+{
+    const String_t* key = m_account.get("api_key");
+    if (key == 0) {
+        return;
+    }
+
+    // Most recent turns first; those are the most likely to be looked at.
+    const String_t serverUrl = BrowserHandler::getServerUrl(m_account);
+    for (int turn = currentTurn-1; turn > 0 && turn >= currentTurn - count; --turn) {
+        const String_t cacheKey = getHistoryCacheKey(turn);
+        if (!m_handler.fileCache().hasFile(cacheKey, String_t())) {
+            if (m_prefetchThread.get() == 0) {
+                m_prefetchThread.reset(new util::RequestThread("game.nu.prefetch", m_handler.log(), m_handler.translator()));
+            }
+            m_prefetchThread->postNewRunnable(new PrefetchTask(*this, serverUrl, *key, cacheKey, turn));
+        }
+    }
+}
+
 afl::data::Access
 game::nu::GameState::loadGameListEntryPreAuthenticated()
 {
@@ -99,6 +187,37 @@ game::nu::GameState::invalidateResult()
     m_result.reset();
 }
 
+String_t
+game::nu::GameState::getHistoryCacheKey(int turn) const
+{
+    return BrowserHandler::makeCacheKey(m_account, Format("game%d/turn%d", m_gameNr, turn));
+}
+
+std::auto_ptr<afl::data::Value>
+game::nu::GameState::downloadHistoryResult(const String_t& serverUrl, const String_t& apiKey, const String_t& cacheKey, int turn)
+{
+    // Called from the game thread or the prefetch thread.
+    // This must not access m_account or m_result; FileCache and the URL-based callServer() can be used from multiple threads.
+    afl::net::HeaderTable tab;
+    tab.add("gameid", Format("%d", m_gameNr));
+    tab.add("apikey", apiKey);
+    tab.add("turn", Format("%d", turn));
+    std::auto_ptr<afl::data::Value> result(m_handler.callServer(serverUrl, "/game/loadturn", tab));
+
+    // History results do not change, so store them without validator
+    if (afl::data::Access(result)("success").toInteger()) {
+        m_handler.fileCache().putValue(cacheKey, String_t(), result.get());
+    }
+    return result;
+}
+
+bool
+game::nu::GameState::isPrefetchCancelled()
+{
+    afl::sys::MutexGuard g(m_prefetchMutex);
+    return m_prefetchCancelled;
+}
+
 bool
 game::nu::GameState::setRaceName(Player& pl, int race)
 {
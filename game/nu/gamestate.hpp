@@ -8,9 +8,11 @@
 #include <memory>
 #include "afl/base/refcounted.hpp"
 #include "afl/data/access.hpp"
+#include "afl/sys/mutex.hpp"
 #include "game/browser/account.hpp"
 #include "game/player.hpp"
 #include "game/task.hpp"
+#include "util/requestthread.hpp"
 
 namespace game { namespace nu {
 
@@ -21,7 +23,11 @@ namespace game { namespace nu {
         so we always download the entire result file to present a GameFolder.
 
         This object is used to pass information from the GameFolder to the actual game,
-        to avoid downloading the result a second time. */
+        to avoid downloading the result a second time.
+
+        Results are kept in BrowserHandler::fileCache().
+        The current result is always downloaded, and the cached copy is only used if the server cannot be reached.
+        History results do not change and are downloaded only once. */
     class GameState : public afl::base::RefCounted {
      public:
         /** Constructor.
@@ -42,6 +48,26 @@ namespace game { namespace nu {
             @return Handle to result JSON */
         afl::data::Access loadResultPreAuthenticated();
 
+        /** Load history result, pre-authenticated.
+            Returns the cached copy if there is one; otherwise, downloads the result.
+            The account must have been logged in already.
+            @param turn Turn number
+            @return result JSON; null on error */
+        std::auto_ptr<afl::data::Value> loadHistoryResultPreAuthenticated(int turn);
+
+        /** Check for cached history result.
+            @param turn Turn number
+            @return true if the history result is available without network access */
+        bool hasHistoryResult(int turn);
+
+        /** Prefetch history results, pre-authenticated.
+            Downloads the results for up to the given number of turns before the current turn in the background,
+            unless they are already cached.
+            The account must have been logged in already.
+            @param currentTurn Current turn number
+            @param count       Number of turns */
+        void prefetchHistoryResults(int currentTurn, int count);
+
         /** Get game list entry for this game, pre-authenticated.
             The account must have been logged in already.
             If the account is not or no longer logged in, the request will fail (return null).
@@ -65,6 +91,8 @@ namespace game { namespace nu {
         static bool setRaceName(Player& pl, int race);
 
      private:
+        class PrefetchTask;
+
         BrowserHandler& m_handler;
         game::browser::Account& m_account;
         int32_t m_gameNr;
@@ -72,6 +100,17 @@ namespace game { namespace nu {
 
         bool m_resultValid;
         std::auto_ptr<afl::data::Value> m_result;
+
+        /** Mutex protecting m_prefetchCancelled. */
+        afl::sys::Mutex m_prefetchMutex;
+        bool m_prefetchCancelled;
+
+        /** Background thread for prefetchHistoryResults(). Created on first use. */
+        std::auto_ptr<util::RequestThread> m_prefetchThread;
+
+        String_t getHistoryCacheKey(int turn) const;
+        std::auto_ptr<afl::data::Value> downloadHistoryResult(const String_t& serverUrl, const String_t& apiKey, const String_t& cacheKey, int turn);
+        bool isPrefetchCancelled();
     };
 
 } }
@@ -23,6 +23,9 @@ namespace {
 
     const char LOG_NAME[] = "game.nu.turnloader";
 
+    /** Number of history turns to download in the background after loading the current turn. */
+    const int HISTORY_PREFETCH_TURNS = 5;
+
     /** Check for known planet.
         A planet is known (possibly as unowned) if we have a sensible value in any of its fields.
         There is no explicit flag regarding this fact in the data. */
@@ -243,6 +246,7 @@ game::nu::TurnLoader::loadCurrentTurn(Turn& turn, Game& game, int player, Root&
                 m_parent.m_log.write(LogListener::Trace, LOG_NAME, "Task: loadCurrentTurn");
                 try {
                     m_parent.doLoadCurrentTurn(m_turn, m_game, m_player);
+                    m_parent.m_gameState->prefetchHistoryResults(m_turn.getTurnNumber(), HISTORY_PREFETCH_TURNS);
                     m_then->call(true);
                 }
                 catch (std::exception& e) {
@@ -280,8 +284,7 @@ game::nu::TurnLoader::getHistoryStatus(int /*player*/, int turn, afl::base::Memo
 {
     /*
      *  Basic idea: be optimistic (WeaklyPositive) that we have a history result for each turn before the current one.
-     *  FIXME: when we download a history result, cache it locally (using the regular Backup mechanism we use for v3)
-     *  so we can give StronglyPositive answers and avoid network traffic later on.
+     *  Downloaded history results are cached locally, so we can give StronglyPositive answers for those.
      */
 
     // Fetch the result. This should not produce a network access, we already have it.
@@ -294,7 +297,7 @@ game::nu::TurnLoader::getHistoryStatus(int /*player*/, int turn, afl::base::Memo
         int currentTurn = rst("rst")("game")("turn").toInteger();
         while (HistoryStatus* p = status.eat()) {
             if (turn >= 0 && turn < currentTurn) {
-                *p = WeaklyPositive;
+                *p = m_gameState->hasHistoryResult(turn) ? StronglyPositive : WeaklyPositive;
             } else {
                 *p = Negative;
             }
@@ -304,15 +307,34 @@ game::nu::TurnLoader::getHistoryStatus(int /*player*/, int turn, afl::base::Memo
 }
 
 std::auto_ptr<game::Task_t>
-game::nu::TurnLoader::loadHistoryTurn(Turn& turn, Game& game, int player, int turnNumber, Root& root, std::auto_ptr<StatusTask_t> then)
+game::nu::TurnLoader::loadHistoryTurn(Turn& turn, Game& /*game*/, int player, int turnNumber, Root& /*root*/, std::auto_ptr<StatusTask_t> then)
 {
-    (void) turn;
-    (void) game;
-    (void) player;
-    (void) turnNumber;
-    (void) root;
-    m_log.write(LogListener::Error, LOG_NAME, "!FIXME: loadHistoryTurn not implemented");
-    return makeConfirmationTask(false, then);
+    class Task : public Task_t {
+     public:
+        Task(TurnLoader& parent, Turn& turn, int player, int turnNumber, std::auto_ptr<StatusTask_t>& then)
+            : m_parent(parent), m_turn(turn), m_player(player), m_turnNumber(turnNumber), m_then(then)
+            { }
+
+        virtual void call()
+            {
+                m_parent.m_log.write(LogListener::Trace, LOG_NAME, "Task: loadHistoryTurn");
+                try {
+                    m_parent.doLoadHistoryTurn(m_turn, m_player, m_turnNumber);
+                    m_then->call(true);
+                }
+                catch (std::exception& e) {
+                    m_parent.m_log.write(LogListener::Error, LOG_NAME, String_t(), e);
+                    m_then->call(false);
+                }
+            }
+     private:
+        TurnLoader& m_parent;
+        Turn& m_turn;
+        int m_player;
+        int m_turnNumber;
+        std::auto_ptr<StatusTask_t> m_then;
+    };
+    return m_gameState->login(std::auto_ptr<Task_t>(new Task(*this, turn, player, turnNumber, then)));
 }
 
 std::auto_ptr<game::Task_t>
@@ -346,6 +368,32 @@ game::nu::TurnLoader::doLoadCurrentTurn(Turn& turn, Game& game, int player)
         throw std::runtime_error(m_translator("Unable to download result file"));
     }
 
+    // expression lists
+    game.expressionLists().loadRecentFiles(m_profile, m_log, m_translator);
+    game.expressionLists().loadPredefinedFiles(m_profile, *m_defaultSpecificationDirectory, m_log, m_translator);
+
+    loadTurn(turn, rst, player);
+}
+
+void
+game::nu::TurnLoader::doLoadHistoryTurn(Turn& turn, int player, int turnNumber)
+{
+    // Load result; this will use the cached copy if possible
+    std::auto_ptr<afl::data::Value> value(m_gameState->loadHistoryResultPreAuthenticated(turnNumber));
+    afl::data::Access rst(value);
+    if (rst.isNull() || rst("success").toInteger() == 0) {
+        throw std::runtime_error(m_translator("Unable to download result file"));
+    }
+    if (rst("rst")("game")("turn").toInteger() != turnNumber) {
+        throw afl::except::InvalidDataException(m_translator("Server returned wrong turn"));
+    }
+
+    loadTurn(turn, rst, player);
+}
+
+void
+game::nu::TurnLoader::loadTurn(Turn& turn, afl::data::Access rst, int player)
+{
     // rst attributes:
     // - settings
     // - game
@@ -385,10 +433,6 @@ game::nu::TurnLoader::doLoadCurrentTurn(Turn& turn, Game& game, int player)
     // FIXME: loadCurrentDatabases()
     // must create all planets/ships before.
 
-    // expression lists
-    game.expressionLists().loadRecentFiles(m_profile, m_log, m_translator);
-    game.expressionLists().loadPredefinedFiles(m_profile, *m_defaultSpecificationDirectory, m_log, m_translator);
-
     loadPlanets(turn.universe(), rst("rst")("planets"), PlayerSet_t(player));
     loadStarbases(turn.universe(), rst("rst")("starbases"), PlayerSet_t(player));
     loadShips(turn.universe(), rst("rst")("ships"), PlayerSet_t(player));
@@ -40,6 +40,8 @@ namespace game { namespace nu {
         afl::base::Ref<afl::io::Directory> m_defaultSpecificationDirectory;
 
         void doLoadCurrentTurn(Turn& turn, Game& game, int player);
+        void doLoadHistoryTurn(Turn& turn, int player, int turnNumber);
+        void loadTurn(Turn& turn, afl::data::Access rst, int player);
 
         void loadPlanets(game::map::Universe& univ, afl::data::Access planets, PlayerSet_t players);
         void loadStarbases(game::map::Universe& univ, afl::data::Access bases, PlayerSet_t players);
@@ -4,6 +4,7 @@
   */
 
 #include <algorithm>
+#include <iterator>
 #include "game/parser/messageparser.hpp"
 #include "afl/io/textfile.hpp"
 #include "afl/string/format.hpp"
@@ -13,6 +14,7 @@
 #include "game/parser/messageinformation.hpp"
 #include "game/parser/messagetemplate.hpp"
 #include "game/parser/messagevalue.hpp"
+#include "util/parallelfor.hpp"
 #include "util/string.hpp"
 
 using afl::string::strTrim;
@@ -381,13 +383,49 @@ namespace {
     }
 }
 
+/*
+ *  parseMessages() helper
+ */
+
+namespace {
+    /* Body for parseMessages().
+       Each message has its own, preallocated output list, so results need no further synchronisation. */
+    class Body : public afl::base::Closure<void(size_t)> {
+     public:
+        Body(const game::parser::MessageParser& parser,
+             const std::vector<String_t>& messages,
+             const std::vector<afl::container::PtrVector<game::parser::MessageInformation>*>& results,
+             const game::parser::DataInterface& iface,
+             int turnNr,
+             afl::string::Translator& tx,
+             afl::sys::LogListener& log)
+            : m_parser(parser), m_messages(messages), m_results(results), m_iface(iface), m_turnNr(turnNr), m_translator(tx), m_log(log)
+            { }
+
+        virtual void call(size_t index)
+            { m_parser.parseMessage(m_messages[index], m_iface, m_turnNr, *m_results[index], m_translator, m_log); }
+
+     private:
+        const game::parser::MessageParser& m_parser;
+        const std::vector<String_t>& m_messages;
+        const std::vector<afl::container::PtrVector<game::parser::MessageInformation>*>& m_results;
+        const game::parser::DataInterface& m_iface;
+        int m_turnNr;
+        afl::string::Translator& m_translator;
+        afl::sys::LogListener& m_log;
+    };
+}
+
+
 /*
  *  Class MessageParser
  */
 
 // Default constructor.
 game::parser::MessageParser::MessageParser()
-    : m_templates()
+    : m_templates(),
+      m_genericTemplates(),
+      m_templatesByKind()
 {
     // ex GMessageParser::GMessageParser
 }
@@ -514,27 +552,86 @@ game::parser::MessageParser::load(afl::io::Stream& file, afl::string::Translator
         }
     }
     checkTemplate(currentTemplate, tf, currentTemplateLine, tx, log);
+    buildIndex();
 }
 
 // Parse a message, main entry point.
 void
 game::parser::MessageParser::parseMessage(String_t theMessage, const DataInterface& iface, int turnNr, afl::container::PtrVector<MessageInformation>& info,
-                                          afl::string::Translator& tx, afl::sys::LogListener& log)
+                                          afl::string::Translator& tx, afl::sys::LogListener& log) const
 {
     // ex GMessageParser::parseMessage
     // Split message into lines
     MessageLines_t lines;
     splitMessage(lines, theMessage);
 
-    // Parse all templates and gather information
-    for (afl::container::PtrVector<MessageTemplate>::iterator i = m_templates.begin(); i != m_templates.end(); ++i) {
+    // Parse all candidate templates and gather information
+    const IndexList_t& candidates = getCandidates(getMessageHeaderInformation(lines, MsgHdrKind));
+    for (IndexList_t::const_iterator i = candidates.begin(); i != candidates.end(); ++i) {
+        const MessageTemplate& tpl = *m_templates[*i];
         std::vector<String_t> values;
-        if ((*i)->match(lines, iface, values)) {
+        if (tpl.match(lines, iface, values)) {
             // Matches. Produce output.
-            generateOutput(values, **i, iface, turnNr - getMessageHeaderInformation(lines, MsgHdrAge), info, tx, log);
-            if (!(*i)->getContinueFlag()) {
+            generateOutput(values, tpl, iface, turnNr - getMessageHeaderInformation(lines, MsgHdrAge), info, tx, log);
+            if (!tpl.getContinueFlag()) {
                 break;
             }
         }
     }
 }
+
+// Parse multiple messages.
+void
+game::parser::MessageParser::parseMessages(const std::vector<String_t>& messages, const DataInterface& iface, int turnNr, afl::container::PtrVector<afl::container::PtrVector<MessageInformation> >& info,
+                                           afl::string::Translator& tx, afl::sys::LogListener& log, size_t numThreads) const
+{
+    // Prepare output, so that results end up in message order no matter which thread produces them
+    std::vector<afl::container::PtrVector<MessageInformation>*> results;
+    for (size_t i = 0, n = messages.size(); i < n; ++i) {
+        results.push_back(info.pushBackNew(new afl::container::PtrVector<MessageInformation>()));
+    }
+
+    // Process
+    Body body(*this, messages, results, iface, turnNr, tx, log);
+    util::parallelFor(messages.size(), numThreads, "game.parser.parse", body);
+}
+
+/** Build template index.
+    Recomputes m_genericTemplates and m_templatesByKind from m_templates. */
+void
+game::parser::MessageParser::buildIndex()
+{
+    m_genericTemplates.clear();
+    m_templatesByKind.clear();
+
+    // Sort templates into lists
+    for (size_t i = 0, n = m_templates.size(); i < n; ++i) {
+        int32_t kind = m_templates[i]->getRequiredMessageKind();
+        if (kind == 0) {
+            m_genericTemplates.push_back(i);
+        } else {
+            m_templatesByKind[kind].push_back(i);
+        }
+    }
+
+    // Merge generic templates into each kind's list, keeping definition order
+    for (std::map<int32_t, IndexList_t>::iterator it = m_templatesByKind.begin(); it != m_templatesByKind.end(); ++it) {
+        IndexList_t merged;
+        std::merge(it->second.begin(), it->second.end(), m_genericTemplates.begin(), m_genericTemplates.end(), std::back_inserter(merged));
+        it->second.swap(merged);
+    }
+}
+
+/** Get candidate templates for a message.
+    \param kind Message kind (see getMessageHeaderInformation(), MsgHdrKind)
+    \return list of indexes into m_templates, in ascending order */
+const game::parser::MessageParser::IndexList_t&
+game::parser::MessageParser::getCandidates(int32_t kind) const
+{
+    std::map<int32_t, IndexList_t>::const_iterator it = m_templatesByKind.find(kind);
+    if (it != m_templatesByKind.end()) {
+        return it->second;
+    } else {
+        return m_genericTemplates;
+    }
+}
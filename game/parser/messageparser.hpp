@@ -5,6 +5,9 @@
 #ifndef C2NG_GAME_PARSER_MESSAGEPARSER_HPP
 #define C2NG_GAME_PARSER_MESSAGEPARSER_HPP
 
+#include <map>
+#include <vector>
+#include "afl/base/types.hpp"
 #include "afl/container/ptrvector.hpp"
 #include "afl/io/stream.hpp"
 #include "afl/string/string.hpp"
@@ -20,7 +23,14 @@ namespace game { namespace parser {
     /** Message parser.
         Used for extracting data from in-game messages.
         A MessageParser instance stores a set of templates that it applies to each messages given to it.
-        The templates are loaded from a file (msgparse.ini). */
+        The templates are loaded from a file (msgparse.ini).
+
+        To avoid trying every template on every message, templates are indexed by the message kind they require
+        (first character of the message Id, see MessageTemplate::getRequiredMessageKind()).
+        A message is only matched against the templates for its kind and the templates that accept any kind,
+        in the order in which they were defined.
+
+        After load(), a MessageParser is only read, and can be used by multiple threads at once. */
     class MessageParser {
      public:
         /** Default constructor.
@@ -44,7 +54,23 @@ namespace game { namespace parser {
             \param [out] info        Information will be appended here
             \param [in]  tx          Translator
             \param [in]  log         Logger */
-        void parseMessage(String_t theMessage, const DataInterface& iface, int turnNr, afl::container::PtrVector<MessageInformation>& info, afl::string::Translator& tx, afl::sys::LogListener& log);
+        void parseMessage(String_t theMessage, const DataInterface& iface, int turnNr, afl::container::PtrVector<MessageInformation>& info, afl::string::Translator& tx, afl::sys::LogListener& log) const;
+
+        /** Parse multiple messages.
+            Messages are independent of each other and are distributed to multiple threads.
+            The result is the same as calling parseMessage() for each message in turn:
+            for each message, one element is appended to \c info, containing the information produced for that message.
+
+            The DataInterface, translator and logger are used by all threads simultaneously.
+            \param [in]  messages    Message texts
+            \param [in]  iface       Data interface (for names)
+            \param [in]  turnNr      Turn number
+            \param [out] info        Information for each message will be appended here
+            \param [in]  tx          Translator
+            \param [in]  log         Logger
+            \param [in]  numThreads  Number of threads to use; 1 or 0 to parse all messages in the calling thread */
+        void parseMessages(const std::vector<String_t>& messages, const DataInterface& iface, int turnNr, afl::container::PtrVector<afl::container::PtrVector<MessageInformation> >& info,
+                           afl::string::Translator& tx, afl::sys::LogListener& log, size_t numThreads) const;
 
         /** Get number of templates.
             Mainly for testing purposes.
@@ -52,7 +78,19 @@ namespace game { namespace parser {
         size_t getNumTemplates() const;
 
      private:
+        typedef std::vector<size_t> IndexList_t;
+
         afl::container::PtrVector<MessageTemplate> m_templates;
+
+        /** Indexes of templates that accept any message kind. */
+        IndexList_t m_genericTemplates;
+
+        /** Indexes of candidate templates for each message kind.
+            Each list contains the templates that require this kind, and the generic templates, in ascending order. */
+        std::map<int32_t, IndexList_t> m_templatesByKind;
+
+        void buildIndex();
+        const IndexList_t& getCandidates(int32_t kind) const;
     };
 
 } }
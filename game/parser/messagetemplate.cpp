@@ -258,6 +258,18 @@ game::parser::MessageTemplate::getNumRestrictions() const
     return total;
 }
 
+// Get required message kind.
+int32_t
+game::parser::MessageTemplate::getRequiredMessageKind() const
+{
+    for (std::vector<Instruction>::const_iterator i = m_instructions.begin(); i != m_instructions.end(); ++i) {
+        if (i->opcode == iMatchKind) {
+            return i->index;
+        }
+    }
+    return 0;
+}
+
 // Find variable slot by name.
 afl::base::Optional<size_t>
 game::parser::MessageTemplate::getVariableSlotByName(const String_t name) const
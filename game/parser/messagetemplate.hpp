@@ -119,6 +119,13 @@ namespace game { namespace parser {
             \return Number of restrictions */
         size_t getNumRestrictions() const;
 
+        /** Get required message kind.
+            If the template contains a iMatchKind instruction, it can only match messages of that kind
+            (see getMessageHeaderInformation(), MsgHdrKind).
+            This can be used to pre-select candidate templates for a message.
+            \return message kind (character code); 0 if this template does not restrict the message kind */
+        int32_t getRequiredMessageKind() const;
+
         /** Find variable slot by name.
             \param name Name to search for, in upper-case
             \return Index such that getVariableName(out) == name if name was found */
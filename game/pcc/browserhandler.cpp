@@ -137,6 +137,7 @@ game::pcc::BrowserHandler::BrowserHandler(game::browser::Browser& b,
       m_manager(mgr),
       m_defaultSpecificationDirectory(defaultSpecificationDirectory),
       m_profile(profile),
+      m_fileCache(profile, "pcc", b.log(), b.translator()),
       m_gameList(),
       m_gameListAccount()
 { }
@@ -255,6 +256,17 @@ game::pcc::BrowserHandler::getGameListPreAuthenticated(game::browser::Account& a
         tab.set("dir", "u/" + user);
         tab.set("action", "lsgame");
         m_gameList = callServer(acc, "file", tab);
+
+        // Keep a copy for offline use
+        const String_t cacheKey = makeCacheKey(acc, "lsgame:u/" + user);
+        if (m_gameList.get() == 0) {
+            m_gameList = m_fileCache.getValue(cacheKey, String_t());
+            if (m_gameList.get() != 0) {
+                log().write(LogListener::Warn, LOG_NAME, translator()("Server not reachable; using cached game list"));
+            }
+        } else if (afl::data::Access(m_gameList)("result").toInteger()) {
+            m_fileCache.putValue(cacheKey, String_t(), m_gameList.get());
+        }
     }
     return m_gameList.get();
 }
@@ -368,6 +380,18 @@ game::pcc::BrowserHandler::callback()
     return m_browser.callback();
 }
 
+game::browser::FileCache&
+game::pcc::BrowserHandler::fileCache()
+{
+    return m_fileCache;
+}
+
+String_t
+game::pcc::BrowserHandler::makeCacheKey(const game::browser::Account& acc, String_t name)
+{
+    return Format("%s@%s:%s", acc.getUser(), acc.getHost(), name);
+}
+
 afl::base::Ptr<game::Root>
 game::pcc::BrowserHandler::loadRoot(game::browser::Account& account, afl::data::Access gameListEntry, const game::config::UserConfiguration& config)
 {
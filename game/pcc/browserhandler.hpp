@@ -12,6 +12,7 @@
 #include "afl/net/http/manager.hpp"
 #include "afl/net/http/simpledownloadlistener.hpp"
 #include "game/browser/browser.hpp"
+#include "game/browser/filecache.hpp"
 #include "game/browser/handler.hpp"
 
 namespace game { namespace pcc {
@@ -129,6 +130,17 @@ namespace game { namespace pcc {
             @return user callback */
         game::browser::UserCallback& callback();
 
+        /** Access file cache.
+            Keeps downloaded files, directory listings and game lists for reuse and offline operation.
+            @return file cache */
+        game::browser::FileCache& fileCache();
+
+        /** Make key for file cache.
+            @param acc  Account
+            @param name Item name (e.g. path name on server)
+            @return key */
+        static String_t makeCacheKey(const game::browser::Account& acc, String_t name);
+
         afl::base::Ptr<Root> loadRoot(game::browser::Account& account,
                                       afl::data::Access gameListEntry,
                                       const game::config::UserConfiguration& config);
@@ -141,6 +153,7 @@ namespace game { namespace pcc {
 
         afl::base::Ref<afl::io::Directory> m_defaultSpecificationDirectory;
         util::ProfileDirectory& m_profile;
+        game::browser::FileCache m_fileCache;
 
         // Cache:
         std::auto_ptr<afl::data::Value> m_gameList;
@@ -6,6 +6,7 @@
 #include "game/pcc/serverdirectory.hpp"
 #include "afl/except/fileproblemexception.hpp"
 #include "afl/io/directoryentry.hpp"
+#include "afl/io/filemapping.hpp"
 #include "afl/io/internalstream.hpp"
 #include "afl/net/http/downloadlistener.hpp"
 #include "afl/net/http/simpledownloadlistener.hpp"
@@ -14,6 +15,12 @@
 #include "afl/string/posixfilenames.hpp"
 #include "game/pcc/browserhandler.hpp"
 
+using afl::sys::LogListener;
+
+namespace {
+    const char LOG_NAME[] = "game.pcc";
+}
+
 /*
  *  DirectoryEntry implementation
  */
@@ -23,13 +30,15 @@ class game::pcc::ServerDirectory::Entry : public afl::io::DirectoryEntry {
     Entry(afl::base::Ref<ServerDirectory> container, afl::data::Access data)
         : m_container(container),
           m_title(data("name").toString()),
-          m_url()
+          m_url(),
+          m_contentId()
         {
             String_t type = data("type").toString();
             if (type == "file") {
                 setFileType(tFile);
                 setFileSize(data("size").toInteger());
                 m_url = data("url").toString();
+                m_contentId = data("id").toString();
             } else if (type == "dir") {
                 setFileType(tDirectory);
             } else {
@@ -41,7 +50,8 @@ class game::pcc::ServerDirectory::Entry : public afl::io::DirectoryEntry {
     Entry(afl::base::Ref<ServerDirectory> container, String_t title)
         : m_container(container),
           m_title(title),
-          m_url()
+          m_url(),
+          m_contentId()
         {
             setFileType(tUnknown);
         }
@@ -55,6 +65,7 @@ class game::pcc::ServerDirectory::Entry : public afl::io::DirectoryEntry {
         { return String_t(); }
 
     // Open as file. For now, we can only open for reading, and download the file completely.
+    // Downloaded files are cached; if the server reports a content Id, an unchanged file is not downloaded again.
     afl::base::Ref<afl::io::Stream> openFile(afl::io::FileSystem::OpenMode mode)
         {
             if (getFileType() != tFile) {
@@ -64,25 +75,39 @@ class game::pcc::ServerDirectory::Entry : public afl::io::DirectoryEntry {
                 throw afl::except::FileProblemException(m_title, afl::string::Messages::cannotWrite());
             }
 
+            // Cached?
+            BrowserHandler& handler = m_container->m_handler;
+            game::browser::FileCache& cache = handler.fileCache();
+            const String_t cacheKey = BrowserHandler::makeCacheKey(m_container->m_account, afl::string::PosixFileNames().makePathName(m_container->m_name, m_title));
+            if (!m_contentId.empty()) {
+                afl::base::Ptr<afl::io::FileMapping> cached = cache.getFile(cacheKey, m_contentId);
+                if (cached.get() != 0) {
+                    return makeStream(cached->get());
+                }
+            }
+
             // Download the file
             afl::net::http::SimpleDownloadListener listener;
-            m_container->m_handler.getFilePreAuthenticated(m_container->m_account, m_url, listener);
+            handler.getFilePreAuthenticated(m_container->m_account, m_url, listener);
 
             switch (listener.wait()) {
              case afl::net::http::SimpleDownloadListener::Succeeded:
                 break;
              case afl::net::http::SimpleDownloadListener::Failed:
              case afl::net::http::SimpleDownloadListener::TimedOut:
-             case afl::net::http::SimpleDownloadListener::LimitExceeded:
-                throw afl::except::FileProblemException(m_title, afl::string::Messages::networkError());
+             case afl::net::http::SimpleDownloadListener::LimitExceeded: {
+                // Use whatever version we have
+                afl::base::Ptr<afl::io::FileMapping> cached = cache.getFile(cacheKey, String_t());
+                if (cached.get() == 0) {
+                    throw afl::except::FileProblemException(m_title, afl::string::Messages::networkError());
+                }
+                handler.log().write(LogListener::Warn, LOG_NAME, afl::string::Format(handler.translator()("%s: server not reachable, using cached copy"), m_title));
+                return makeStream(cached->get());
+             }
             }
 
-            // Create InternalStream object for user to work with
-            afl::base::Ref<afl::io::InternalStream> s(*new afl::io::InternalStream());
-            s->setName(m_title);
-            s->write(listener.getResponseData());
-            s->setPos(0);
-            return s;
+            cache.putFile(cacheKey, m_contentId, listener.getResponseData());
+            return makeStream(listener.getResponseData());
         }
 
     // Open as directory.
@@ -124,6 +149,17 @@ class game::pcc::ServerDirectory::Entry : public afl::io::DirectoryEntry {
     afl::base::Ref<ServerDirectory> m_container;
     String_t m_title;
     String_t m_url;
+    String_t m_contentId;
+
+    // Create InternalStream object for user to work with
+    afl::base::Ref<afl::io::Stream> makeStream(afl::base::ConstBytes_t content)
+        {
+            afl::base::Ref<afl::io::InternalStream> s(*new afl::io::InternalStream());
+            s->setName(m_title);
+            s->write(content);
+            s->setPos(0);
+            return s;
+        }
 };
 
 /**************************** ServerDirectory ****************************/
@@ -240,7 +276,18 @@ game::pcc::ServerDirectory::load()
     m_loaded = true;
     m_entries = new ContentVector_t();
 
+    // Keep a copy of the listing so the game can be opened offline
+    const String_t cacheKey = BrowserHandler::makeCacheKey(m_account, "ls:" + m_name);
     std::auto_ptr<afl::data::Value> content(m_handler.getDirectoryContentPreAuthenticated(m_account, m_name));
+    if (content.get() == 0) {
+        content = m_handler.fileCache().getValue(cacheKey, String_t());
+        if (content.get() != 0) {
+            m_handler.log().write(LogListener::Warn, LOG_NAME, afl::string::Format(m_handler.translator()("%s: server not reachable, using cached directory content"), m_name));
+        }
+    } else if (afl::data::Access(content)("result").toInteger()) {
+        m_handler.fileCache().putValue(cacheKey, String_t(), content.get());
+    }
+
     afl::data::Access a(content);
     if (a("result").toInteger()) {
         for (size_t i = 0, n = a("reply").getArraySize(); i < n; ++i) {
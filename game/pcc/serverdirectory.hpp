@@ -20,7 +20,9 @@ namespace game { namespace pcc {
         - read-only for now;
         - cannot authenticate: the account must be logged in previously (use BrowserHandler::login()).
           If the login expires, future accesses will fail until an external component logs in the account again;
-        - takes it easy on caching. */
+        - files and directory listings are kept in BrowserHandler::fileCache().
+          A file is only downloaded again if the server reports a different content Id.
+          If the server cannot be reached, cached copies are used. */
     class ServerDirectory : public afl::io::Directory {
      public:
         /** Constructor.
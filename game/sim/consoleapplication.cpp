@@ -3,12 +3,23 @@
   *  \brief Class game::sim::ConsoleApplication
   */
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include "game/sim/consoleapplication.hpp"
 #include "afl/base/optional.hpp"
+#include "afl/data/floatvalue.hpp"
+#include "afl/data/hash.hpp"
+#include "afl/data/hashvalue.hpp"
+#include "afl/data/integervalue.hpp"
+#include "afl/data/stringvalue.hpp"
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
 #include "afl/except/commandlineexception.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/writer.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/parse.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
@@ -24,6 +35,8 @@
 #include "game/sim/setup.hpp"
 #include "game/sim/ship.hpp"
 #include "game/sim/simplerunner.hpp"
+#include "game/sim/sweep.hpp"
+#include "game/sim/sweeprunner.hpp"
 #include "game/specificationloader.hpp"
 #include "game/v3/rootloader.hpp"
 #include "util/charsetfactory.hpp"
@@ -115,6 +128,42 @@ namespace {
         }
     }
 
+    /* Quote a CSV field if needed */
+    String_t quoteCSV(const String_t& value)
+    {
+        if (value.find_first_of(",\"\n ") == String_t::npos) {
+            return value;
+        } else {
+            String_t result = "\"";
+            for (size_t i = 0; i < value.size(); ++i) {
+                if (value[i] == '"') {
+                    result += '"';
+                }
+                result += value[i];
+            }
+            result += '"';
+            return result;
+        }
+    }
+
+    /* Format a ClassResult's class for CSV output, as "PLAYER:COUNT" pairs */
+    String_t formatClass(const game::sim::ClassResult& r)
+    {
+        String_t result;
+        for (int pl = 1; pl <= game::MAX_PLAYERS; ++pl) {
+            if (int numSurvivors = r.getClass().get(pl)) {
+                if (!result.empty()) {
+                    result += ' ';
+                }
+                result += Format("%d:%d", pl, numSurvivors);
+            }
+        }
+        if (result.empty()) {
+            result = "none";
+        }
+        return result;
+    }
+
     void writeScalar(afl::io::TextWriter& out, String_t name, int value)
     {
         out.writeLine(Format("  %s: %d", name, value));
@@ -144,6 +193,9 @@ struct game::sim::ConsoleApplication::Parameters {
     Optional<String_t> charsetName;                        // -C
     Optional<size_t> runSimCount;                          // --run
     bool runSimSeries;                                     // --run-series
+    Optional<double> runPrecision;                         // --precision
+    Sweep sweep;                                           // --sweep
+    bool sweepJSON;                                        // --sweep-format
     Optional<Configuration::VcrMode> vcrMode;              // --mode
     Optional<int> engineShieldBonus;                       // --esb
     Optional<bool> scottyBonus;                            // --scotty
@@ -158,7 +210,7 @@ struct game::sim::ConsoleApplication::Parameters {
 
     Parameters()
         : hadAction(false), saveFileName(), enableReport(false), enableVerify(false), gameDirectoryName(), rootDirectoryName(),
-          numThreads(0), charsetName(), runSimCount(), runSimSeries(false),
+          numThreads(0), charsetName(), runSimCount(), runSimSeries(false), runPrecision(), sweep(), sweepJSON(false),
           vcrMode(), engineShieldBonus(), scottyBonus(), randomLeftRight(),
           honorAlliances(), onlyOneSimulation(), seedControl(), randomizeFCodesOnEveryFight(),
           balancingMode(), loadFileNames()
@@ -239,7 +291,10 @@ game::sim::ConsoleApplication::appMain()
     }
 
     // Sim
-    if (p.runSimSeries || p.runSimCount.isValid()) {
+    if (p.sweep.getNumParameters() != 0) {
+        loadSession(session, p, *cs);
+        runSweep(setup, session, p);
+    } else if (p.runSimSeries || p.runSimCount.isValid() || p.runPrecision.isValid()) {
         loadSession(session, p, *cs);
         runSimulation(setup, session, p);
     }
@@ -301,6 +356,31 @@ game::sim::ConsoleApplication::parseCommandLine(Parameters& p)
             } else if (text == "run-series") {
                 p.runSimSeries = true;
                 p.hadAction = true;
+            } else if (text == "precision") {
+                String_t param = parser.getRequiredParameter(text);
+                const char* begin = param.c_str();
+                char* end = 0;
+                double d = std::strtod(begin, &end);
+                if (end == begin || *end != '\0' || !(d > 0 && d < 100)) {
+                    errorExit(Format(tx("invalid precision, '%s'"), param));
+                }
+                p.runPrecision = d;
+                p.hadAction = true;
+            } else if (text == "sweep") {
+                String_t param = parser.getRequiredParameter(text);
+                if (!p.sweep.addParameter(param)) {
+                    errorExit(Format(tx("invalid sweep parameter, '%s'"), param));
+                }
+                p.hadAction = true;
+            } else if (text == "sweep-format") {
+                String_t param = parser.getRequiredParameter(text);
+                if (param == "csv") {
+                    p.sweepJSON = false;
+                } else if (param == "json") {
+                    p.sweepJSON = true;
+                } else {
+                    errorExit(Format(tx("parameter '%s' to '--%s' is not valid"), param, text));
+                }
             } else if (text == "mode") {
                 p.vcrMode = parseVcrMode(parser.getRequiredParameter(text), text, tx);
             } else if (text == "esb") {
@@ -360,12 +440,15 @@ game::sim::ConsoleApplication::help()
                                                 "--verify\tVerify simulation against ship list\n"
                                                 "--run N\tRun N simulations\n"
                                                 "--run-series\tRun a series\n"
+                                                "--precision P\tRun until results are accurate to P percent (limit with --run N)\n"
+                                                "--sweep UNIT:PROP=VALUES\tRun all variants of the setup, write class results (repeatable)\n"
                                                 "\n"
                                                 "Options:\n"
                                                 "--game/-G DIR\tGame directory\n"
                                                 "--root/-R DIR\tRoot directory\n"
                                                 "--charset/-C CS\tSet game character set\n"
                                                 "-q\tDo not show progress messages\n"
+                                                "--sweep-format=FMT\tSet sweep output format (csv, json)\n"
                                                 "--log CONFIG\tConfigure log output\n"
                                                 "\n"
                                                 "Simulation options:\n"
@@ -503,10 +586,8 @@ game::sim::ConsoleApplication::showSetup(const Setup& setup, const Session& sess
 }
 
 void
-game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& session, const Parameters& params)
+game::sim::ConsoleApplication::buildConfiguration(Configuration& opts, const Session& session, const Parameters& params)
 {
-    // Build configuration
-    Configuration opts;
     if (const Configuration::VcrMode* vcrMode = params.vcrMode.get()) {
         opts.setMode(*vcrMode, 0, session.root->hostConfiguration());
     }
@@ -534,6 +615,14 @@ game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& sessio
     if (const Configuration::BalancingMode* balancingMode = params.balancingMode.get()) {
         opts.setBalancingMode(*balancingMode);
     }
+}
+
+void
+game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& session, const Parameters& params)
+{
+    // Build configuration
+    Configuration opts;
+    buildConfiguration(opts, session, params);
 
     // Build RNG
     util::RandomNumberGenerator rng(params.seed.orElse(afl::sys::Time::getTickCounter()));
@@ -559,6 +648,14 @@ game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& sessio
     util::StopSignal sig;
     if (params.runSimSeries) {
         runner->run(runner->makeSeriesLimit(), sig);
+    } else if (const double* precision = params.runPrecision.get()) {
+        // With --run N, N is the maximum number of simulations; first one already ran
+        const size_t* n = params.runSimCount.get();
+        if (n == 0) {
+            runner->run(runner->makePrecisionLimit(*precision / 100.0, 0), sig);
+        } else if (*n > 1) {
+            runner->run(runner->makePrecisionLimit(*precision / 100.0, *n-1), sig);
+        }
     } else {
         size_t n = params.runSimCount.orElse(0);
         if (n > 1) {
@@ -568,11 +665,109 @@ game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& sessio
 
     // Show results
     out.writeLine(Format(tx("Results after %d simulation%!1{s%}"), runner->resultList().getNumBattles()));
+    if (params.runPrecision.isValid()) {
+        out.writeLine(Format(tx("Precision: %.2f%%"), 100.0 * runner->resultList().getPrecision()));
+    }
     out.writeLine();
     showClassResults(setup, session, runner->resultList());
     showUnitResults(setup, session, runner->resultList());
 }
 
+void
+game::sim::ConsoleApplication::runSweep(const Setup& setup, const Session& session, const Parameters& params)
+{
+    afl::string::Translator& tx = translator();
+    afl::io::TextWriter& out = standardOutput();
+    const Sweep& sweep = params.sweep;
+
+    // Build configuration
+    Configuration opts;
+    buildConfiguration(opts, session, params);
+
+    // Build variants. All variants use the same seed, so differences between them are not due to chance.
+    const uint32_t seed = params.seed.orElse(afl::sys::Time::getTickCounter());
+    SweepRunner runner(opts, *session.shipList, session.root->hostConfiguration(), session.root->flakConfiguration(), consoleLogger());
+    for (size_t i = 0, n = sweep.getNumVariants(); i < n; ++i) {
+        Setup variant(setup);
+        if (!sweep.buildVariant(i, variant)) {
+            errorExit(tx("sweep parameter refers to a unit that does not exist"));
+        }
+        runner.addVariant(variant, seed);
+    }
+
+    // Run
+    util::StopSignal sig;
+    const double* precision = params.runPrecision.get();
+    runner.run(std::max(params.numThreads, size_t(1)), params.runSimCount.orElse(0), precision != 0 ? *precision / 100.0 : 0.0, sig);
+
+    // Show results
+    if (params.sweepJSON) {
+        afl::data::Vector::Ref_t list = afl::data::Vector::create();
+        for (size_t i = 0, n = runner.getNumVariants(); i < n; ++i) {
+            afl::data::Hash::Ref_t variant = afl::data::Hash::create();
+            variant->setNew("variant", new afl::data::IntegerValue(int32_t(i)));
+
+            afl::data::Hash::Ref_t values = afl::data::Hash::create();
+            for (size_t j = 0, m = sweep.getNumParameters(); j < m; ++j) {
+                values->setNew(sweep.getParameterName(j), new afl::data::StringValue(sweep.getVariantValue(i, j)));
+            }
+            variant->setNew("parameters", new afl::data::HashValue(values));
+
+            afl::data::Vector::Ref_t classes = afl::data::Vector::create();
+            const ResultList* resultList = runner.getResultList(i);
+            variant->setNew("battles", new afl::data::IntegerValue(resultList != 0 ? int32_t(resultList->getNumBattles()) : 0));
+            for (size_t j = 0, m = (resultList != 0 ? resultList->getNumClassResults() : 0); j < m; ++j) {
+                if (const ClassResult* r = resultList->getClassResult(j)) {
+                    afl::data::Hash::Ref_t owners = afl::data::Hash::create();
+                    for (int pl = 1; pl <= MAX_PLAYERS; ++pl) {
+                        if (int numSurvivors = r->getClass().get(pl)) {
+                            owners->setNew(Format("%d", pl), new afl::data::IntegerValue(numSurvivors));
+                        }
+                    }
+                    afl::data::Hash::Ref_t cls = afl::data::Hash::create();
+                    cls->setNew("owners", new afl::data::HashValue(owners));
+                    cls->setNew("probability", new afl::data::FloatValue(double(r->getWeight()) / resultList->getCumulativeWeight()));
+                    classes->pushBackNew(new afl::data::HashValue(cls));
+                }
+            }
+            variant->setNew("classes", new afl::data::VectorValue(classes));
+            list->pushBackNew(new afl::data::HashValue(variant));
+        }
+
+        afl::io::InternalSink sink;
+        afl::io::json::Writer writer(sink);
+        afl::data::VectorValue listValue(list);
+        writer.visit(&listValue);
+        out.writeLine(afl::string::fromBytes(sink.getContent()));
+    } else {
+        String_t header = "variant";
+        for (size_t j = 0, m = sweep.getNumParameters(); j < m; ++j) {
+            header += ",";
+            header += quoteCSV(sweep.getParameterName(j));
+        }
+        header += ",battles,class,probability";
+        out.writeLine(header);
+
+        for (size_t i = 0, n = runner.getNumVariants(); i < n; ++i) {
+            String_t prefix = Format("%d", i);
+            for (size_t j = 0, m = sweep.getNumParameters(); j < m; ++j) {
+                prefix += ",";
+                prefix += quoteCSV(sweep.getVariantValue(i, j));
+            }
+            if (const ResultList* resultList = runner.getResultList(i)) {
+                for (size_t j = 0, m = resultList->getNumClassResults(); j < m; ++j) {
+                    if (const ClassResult* r = resultList->getClassResult(j)) {
+                        out.writeLine(Format("%s,%d,%s,%.4f", prefix, resultList->getNumBattles(), quoteCSV(formatClass(*r)),
+                                             double(r->getWeight()) / resultList->getCumulativeWeight()));
+                    }
+                }
+            } else {
+                out.writeLine(prefix + ",0,,");
+            }
+        }
+    }
+}
+
 void
 game::sim::ConsoleApplication::showClassResults(const Setup& /*setup*/, const Session& session, const ResultList& resultList)
 {
@@ -10,6 +10,7 @@
 
 namespace game { namespace sim {
 
+    class Configuration;
     class Setup;
     class ResultList;
 
@@ -40,7 +41,9 @@ namespace game { namespace sim {
         void loadSession(Session& session, const Parameters& params, afl::charset::Charset& charset);
         void verifySetup(const Setup& setup, const Session& session);
         void showSetup(const Setup& setup, const Session& session);
+        void buildConfiguration(Configuration& opts, const Session& session, const Parameters& params);
         void runSimulation(Setup& setup, const Session& session, const Parameters& params);
+        void runSweep(const Setup& setup, const Session& session, const Parameters& params);
         void showClassResults(const Setup& setup, const Session& session, const ResultList& resultList);
         void showUnitResults(const Setup& setup, const Session& session, const ResultList& resultList);
     };
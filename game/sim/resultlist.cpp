@@ -3,6 +3,8 @@
   *  \brief Class game::sim::ResultList
   */
 
+#include <algorithm>
+#include <cmath>
 #include "game/sim/resultlist.hpp"
 #include "game/sim/setup.hpp"
 #include "game/sim/ship.hpp"
@@ -10,17 +12,46 @@
 #include "afl/string/format.hpp"
 
 namespace {
+    /* Factor to obtain half-width of 95% confidence interval from standard error */
+    const double CONFIDENCE_FACTOR = 1.96;
+
     afl::base::Ptr<game::vcr::Database> pickSample(const game::sim::UnitResult::Item& item, bool max)
     {
         return max ? item.maxSpecimen : item.minSpecimen;
     }
+
+    /* Get relative half-width of confidence interval of a probability.
+       p is the observed probability, n the effective number of battles. */
+    double getProbabilityPrecision(double p, double n)
+    {
+        // Agresti-Coull: add z^2/2 successes and failures
+        const double z2 = CONFIDENCE_FACTOR * CONFIDENCE_FACTOR;
+        const double adjN = n + z2;
+        const double adjP = (p*n + z2/2) / adjN;
+        return CONFIDENCE_FACTOR * std::sqrt(adjP * (1 - adjP) / adjN);
+    }
+
+    /* Get relative half-width of confidence interval of a UnitResult::Item's average.
+       n is the effective number of battles. */
+    double getItemPrecision(const game::sim::UnitResult::Item& item, int32_t cumulativeWeight, double n)
+    {
+        if (item.max <= item.min || cumulativeWeight <= 0) {
+            // All battles produced the same value
+            return 0.0;
+        }
+
+        const double mean = double(item.totalScaled) / cumulativeWeight;
+        const double variance = std::max(0.0, item.totalSquaredScaled / cumulativeWeight - mean*mean);
+        return CONFIDENCE_FACTOR * std::sqrt(variance / n) / (item.max - item.min);
+    }
 }
 
 const size_t game::sim::ResultList::UnitInfo::MAX_TYPE;
 
 // Make blank ResultList.
 game::sim::ResultList::ResultList()
-    : m_totalWeight(0), m_cumulativeWeight(0), m_numBattles(0), m_lastClassResultIndex(0), m_unitResults(), m_classResults()
+    : m_totalWeight(0), m_cumulativeWeight(0), m_numBattles(0), m_lastClassResultIndex(0), m_sumWeights(0), m_sumSquaredWeights(0),
+      m_unitResults(), m_classResults()
 {
     // ex GSimResultSummary
 }
@@ -104,6 +135,11 @@ game::sim::ResultList::addResult(const Setup& oldState, const Setup& newState, a
     /* Finally, adjust our counters */
     m_cumulativeWeight += result.this_battle_weight;
     ++m_numBattles;
+    if (m_totalWeight > 0) {
+        const double w = double(result.this_battle_weight) / m_totalWeight;
+        m_sumWeights += w;
+        m_sumSquaredWeights += w*w;
+    }
 }
 
 // Get cumulative weight.
@@ -255,6 +291,39 @@ game::sim::ResultList::getLastClassResultIndex() const
     return m_lastClassResultIndex;
 }
 
+// Get effective number of battles.
+double
+game::sim::ResultList::getEffectiveNumBattles() const
+{
+    return m_sumSquaredWeights > 0
+        ? m_sumWeights * m_sumWeights / m_sumSquaredWeights
+        : 0.0;
+}
+
+// Get precision of the result.
+double
+game::sim::ResultList::getPrecision() const
+{
+    const double n = getEffectiveNumBattles();
+    if (m_numBattles < 2 || n < 1.0 || m_cumulativeWeight <= 0) {
+        return 1.0;
+    }
+
+    double result = 0.0;
+    for (size_t i = 0, e = m_classResults.size(); i < e; ++i) {
+        result = std::max(result, getProbabilityPrecision(double(m_classResults[i]->getWeight()) / m_cumulativeWeight, n));
+    }
+    for (size_t i = 0, e = m_unitResults.size(); i < e; ++i) {
+        const UnitResult& r = *m_unitResults[i];
+        result = std::max(result, getItemPrecision(r.getDamage(),                m_cumulativeWeight, n));
+        result = std::max(result, getItemPrecision(r.getShield(),                m_cumulativeWeight, n));
+        result = std::max(result, getItemPrecision(r.getCrewLeftOrDefenseLost(), m_cumulativeWeight, n));
+        result = std::max(result, getItemPrecision(r.getNumTorpedoesFired(),     m_cumulativeWeight, n));
+        result = std::max(result, getItemPrecision(r.getNumFightersLost(),       m_cumulativeWeight, n));
+    }
+    return std::min(result, 1.0);
+}
+
 
 /** Update class result sort order. Assuming value at change_index was
     modified (count increased), sort it into its place. */
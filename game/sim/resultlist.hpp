@@ -158,11 +158,34 @@ namespace game { namespace sim {
             \return Index */
         size_t getLastClassResultIndex() const;
 
+        /** Get effective number of battles.
+            Battles with a higher weight contribute more to the result than others.
+            This is the number of equally-weighted battles that would give the same statistical precision
+            (Kish's effective sample size).
+            \return effective number of battles */
+        double getEffectiveNumBattles() const;
+
+        /** Get precision of the result.
+            Determines the half-width of the 95% confidence interval of every tracked quantity:
+            - the probability of each result class;
+            - the average damage, shield, crew (defense lost), torpedoes fired and fighters lost of each unit.
+
+            Each half-width is given relative to the range of the quantity
+            ([0,1] for probabilities, observed minimum to maximum for unit results),
+            so a precision of 0.01 means that every quantity is known to within 1% of its range.
+            Probabilities use the Agresti-Coull estimate, so that a result class that has been
+            seen in all (or none) of the battles does not produce a zero-width interval.
+
+            \return largest relative half-width; 1.0 if there are not enough battles to tell */
+        double getPrecision() const;
+
      private:
         int32_t m_totalWeight;            ///< Total weight. This is the value to which the battles are "normalized". ex total_weight. FIXME: name
         int32_t m_cumulativeWeight;       ///< Sum of weights of all fights. ex cumulative_weight. FIXME: name
         int m_numBattles;                 ///< Total number of battles so far. ex battle_count.
         size_t m_lastClassResultIndex;    ///< Last class result index.
+        double m_sumWeights;              ///< Sum of normalized battle weights (this_battle_weight/total_battle_weight).
+        double m_sumSquaredWeights;       ///< Sum of squared normalized battle weights.
 
         typedef afl::container::PtrVector<UnitResult> UnitResults_t;
         typedef afl::container::PtrVector<ClassResult> ClassResults_t;
@@ -143,23 +143,34 @@ game::sim::Runner::makeSeriesLimit() const
 game::sim::Runner::Limit_t
 game::sim::Runner::makeNoLimit() const
 {
-    return Limit_t(0);
+    return Limit_t();
 }
 
 game::sim::Runner::Limit_t
 game::sim::Runner::makeFiniteLimit(size_t n) const
 {
-    return m_count + n;
+    return Limit_t(m_count + n, 0);
+}
+
+game::sim::Runner::Limit_t
+game::sim::Runner::makePrecisionLimit(double precision, size_t maxCount) const
+{
+    return Limit_t(maxCount != 0 ? m_count + maxCount : 0, precision);
 }
 
 game::sim::Runner::Job*
 game::sim::Runner::makeJob(Limit_t& limit, util::StopSignal& stopper)
 {
-    if (!stopper.get() && (limit == 0 || m_count < limit)) {
-        return new Job(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log, m_rng, m_count++);
-    } else {
+    if (stopper.get()) {
+        return 0;
+    }
+    if (limit.count != 0 && m_count >= limit.count) {
+        return 0;
+    }
+    if (limit.precision > 0 && m_resultList.getPrecision() <= limit.precision) {
         return 0;
     }
+    return new Job(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log, m_rng, m_count++);
 }
 
 void
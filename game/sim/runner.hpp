@@ -37,8 +37,18 @@ namespace game { namespace sim {
         /** Opaque class to represent a simulation job. */
         struct Job;
 
-        /** Opaque data type to represent a simulation count limit. */
-        typedef size_t Limit_t;
+        /** Opaque data type to represent a simulation limit. */
+        struct Limit_t {
+            size_t count;         ///< Stop when this many simulations have been started. 0 for no count limit.
+            double precision;     ///< Stop when ResultList::getPrecision() reaches this value. 0 for no precision limit.
+
+            Limit_t()
+                : count(0), precision(0)
+                { }
+            Limit_t(size_t count, double precision)
+                : count(count), precision(precision)
+                { }
+        };
 
         /** Constructor.
             \param [in]     setup   Simulation setup
@@ -64,7 +74,7 @@ namespace game { namespace sim {
             Computes more simulations until the specified count limit has been reached,
             or the StopSignal signals stop.
 
-            \param [in]     limit    Count limit. Use makeSeriesLimit(), makeNoLimit(), makeFiniteLimit() to create.
+            \param [in]     limit    Limit. Use makeSeriesLimit(), makeNoLimit(), makeFiniteLimit(), makePrecisionLimit() to create.
             \param [in,out] stopper  Can be signaled by another thread to stop early
 
             Implementations must repeatedly
@@ -112,6 +122,20 @@ namespace game { namespace sim {
             \return limit value. Value is only meaningful until next run() invocation. */
         Limit_t makeFiniteLimit(size_t n) const;
 
+        /** Make limit: precision.
+            If makePrecisionLimit(p, n) is passed as limit to run(),
+            simulations will be run until the result has reached the given precision
+            (see ResultList::getPrecision()), or n more simulations have been run.
+
+            The precision is checked on the results received so far;
+            a multi-threaded runner may produce a few simulations more.
+            The run may stop in the middle of a series.
+
+            \param precision Desired precision (relative half-width of 95% confidence interval, e.g. 0.01 for 1%)
+            \param maxCount  Maximum number of simulations to run; 0 for no maximum
+            \return limit value. Value is only meaningful until next run() invocation. */
+        Limit_t makePrecisionLimit(double precision, size_t maxCount) const;
+
         /** Signal: update.
             Called whenever new simulations have been produced and the configured update interval has elapsed */
         afl::base::Signal<void()> sig_update;
@@ -0,0 +1,309 @@
+/**
+  *  \file game/sim/sweep.cpp
+  *  \brief Class game::sim::Sweep
+  */
+
+#include <memory>
+#include "game/sim/sweep.hpp"
+#include "afl/base/countof.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
+#include "game/sim/planet.hpp"
+#include "game/sim/setup.hpp"
+#include "game/sim/ship.hpp"
+
+namespace {
+    enum Property {
+        Ammo,
+        Aggressiveness,
+        NumBeams,
+        BeamType,
+        NumLaunchers,
+        TorpedoType,
+        NumBays,
+        Crew,
+        EngineType,
+        Defense,
+        BaseDefense,
+        BaseBeamTech,
+        BaseTorpedoTech,
+        NumBaseFighters,
+        FriendlyCode,
+        Damage,
+        Shield,
+        Owner,
+        ExperienceLevel
+    };
+
+    struct PropertyInfo {
+        const char* name;
+        Property property;
+        bool forShip;
+        bool forPlanet;
+    };
+
+    const PropertyInfo PROPERTIES[] = {
+        { "ammo",           Ammo,            true,  false },
+        { "aggressiveness", Aggressiveness,  true,  false },
+        { "beams",          NumBeams,        true,  false },
+        { "beamtype",       BeamType,        true,  false },
+        { "launchers",      NumLaunchers,    true,  false },
+        { "torptype",       TorpedoType,     true,  false },
+        { "bays",           NumBays,         true,  false },
+        { "crew",           Crew,            true,  false },
+        { "engine",         EngineType,      true,  false },
+        { "defense",        Defense,         false, true  },
+        { "basedefense",    BaseDefense,     false, true  },
+        { "basebeamtech",   BaseBeamTech,    false, true  },
+        { "basetorptech",   BaseTorpedoTech, false, true  },
+        { "basefighters",   NumBaseFighters, false, true  },
+        { "fcode",          FriendlyCode,    true,  true  },
+        { "damage",         Damage,          true,  true  },
+        { "shield",         Shield,          true,  true  },
+        { "owner",          Owner,           true,  true  },
+        { "level",          ExperienceLevel, true,  true  },
+    };
+
+    const PropertyInfo* findProperty(const String_t& name)
+    {
+        for (size_t i = 0; i < countof(PROPERTIES); ++i) {
+            if (name == PROPERTIES[i].name) {
+                return &PROPERTIES[i];
+            }
+        }
+        return 0;
+    }
+
+    /* Parse a numeric value. Accepts aggressiveness names for Aggressiveness. */
+    bool parseNumber(Property prop, const String_t& value, int& result)
+    {
+        if (prop == Aggressiveness) {
+            if (value == "kill") {
+                result = game::sim::Ship::agg_Kill;
+                return true;
+            }
+            if (value == "passive") {
+                result = game::sim::Ship::agg_Passive;
+                return true;
+            }
+            if (value == "nofuel") {
+                result = game::sim::Ship::agg_NoFuel;
+                return true;
+            }
+        }
+        return afl::string::strToInteger(value, result);
+    }
+
+    /* Parse one element of a value list into out. */
+    bool parseElement(Property prop, const String_t& elem, std::vector<String_t>& out)
+    {
+        if (prop == FriendlyCode) {
+            // Friendly codes are taken verbatim
+            if (elem.size() > 3) {
+                return false;
+            }
+            out.push_back(elem);
+            return true;
+        }
+
+        String_t::size_type dots = elem.find("..");
+        if (dots == String_t::npos) {
+            // Single value
+            int n;
+            if (!parseNumber(prop, elem, n)) {
+                return false;
+            }
+            out.push_back(elem);
+            return true;
+        } else {
+            // Range
+            String_t::size_type slash = elem.find('/', dots);
+            int from, to, step = 1;
+            if (!afl::string::strToInteger(elem.substr(0, dots), from)
+                || !afl::string::strToInteger(elem.substr(dots+2, slash == String_t::npos ? String_t::npos : slash - dots - 2), to)
+                || (slash != String_t::npos && !afl::string::strToInteger(elem.substr(slash+1), step))
+                || step <= 0
+                || from > to
+                || size_t((to - from) / step) >= game::sim::Sweep::MAX_VARIANTS)
+            {
+                return false;
+            }
+            for (int i = from; i <= to && i >= from; i += step) {
+                out.push_back(afl::string::Format("%d", i));
+            }
+            return true;
+        }
+    }
+
+    void applyValue(game::sim::Object& obj, Property prop, const String_t& value)
+    {
+        game::sim::Ship* sh = dynamic_cast<game::sim::Ship*>(&obj);
+        game::sim::Planet* pl = dynamic_cast<game::sim::Planet*>(&obj);
+        int n = 0;
+        if (prop == FriendlyCode) {
+            obj.setFriendlyCode(value);
+            return;
+        }
+        parseNumber(prop, value, n);
+        switch (prop) {
+         case Ammo:            if (sh) { sh->setAmmo(n); }            break;
+         case Aggressiveness:  if (sh) { sh->setAggressiveness(n); }  break;
+         case NumBeams:        if (sh) { sh->setNumBeams(n); }        break;
+         case BeamType:        if (sh) { sh->setBeamType(n); }        break;
+         case NumLaunchers:    if (sh) { sh->setNumLaunchers(n); }    break;
+         case TorpedoType:     if (sh) { sh->setTorpedoType(n); }     break;
+         case NumBays:         if (sh) { sh->setNumBays(n); }         break;
+         case Crew:            if (sh) { sh->setCrew(n); }            break;
+         case EngineType:      if (sh) { sh->setEngineType(n); }      break;
+         case Defense:         if (pl) { pl->setDefense(n); }         break;
+         case BaseDefense:     if (pl) { pl->setBaseDefense(n); }     break;
+         case BaseBeamTech:    if (pl) { pl->setBaseBeamTech(n); }    break;
+         case BaseTorpedoTech: if (pl) { pl->setBaseTorpedoTech(n); } break;
+         case NumBaseFighters: if (pl) { pl->setNumBaseFighters(n); } break;
+         case FriendlyCode:                                           break;
+         case Damage:          obj.setDamage(n);                      break;
+         case Shield:          obj.setShield(n);                      break;
+         case Owner:           obj.setOwner(n);                       break;
+         case ExperienceLevel: obj.setExperienceLevel(n);             break;
+        }
+    }
+}
+
+struct game::sim::Sweep::Parameter {
+    String_t name;                    ///< Name, "UNIT:PROPERTY".
+    Id_t shipId;                      ///< Ship Id; 0 for planet.
+    Property property;                ///< Property to modify.
+    std::vector<String_t> values;     ///< Values.
+};
+
+const size_t game::sim::Sweep::MAX_VARIANTS;
+
+// Constructor.
+game::sim::Sweep::Sweep()
+    : m_parameters()
+{ }
+
+// Destructor.
+game::sim::Sweep::~Sweep()
+{ }
+
+// Add a parameter.
+bool
+game::sim::Sweep::addParameter(const String_t& spec)
+{
+    // Split "UNIT:PROPERTY=VALUES"
+    String_t::size_type colon = spec.find(':');
+    String_t::size_type equals = spec.find('=');
+    if (colon == String_t::npos || equals == String_t::npos || equals < colon) {
+        return false;
+    }
+    const String_t unit = spec.substr(0, colon);
+    const String_t propName = spec.substr(colon+1, equals - colon - 1);
+    const String_t valueList = spec.substr(equals+1);
+
+    // Unit
+    std::auto_ptr<Parameter> p(new Parameter());
+    p->name = spec.substr(0, equals);
+    p->shipId = 0;
+    const PropertyInfo* info = findProperty(propName);
+    if (info == 0) {
+        return false;
+    }
+    if (unit == "planet") {
+        if (!info->forPlanet) {
+            return false;
+        }
+    } else {
+        if (!afl::string::strToInteger(unit, p->shipId) || p->shipId <= 0 || !info->forShip) {
+            return false;
+        }
+    }
+    p->property = info->property;
+
+    // Values
+    String_t::size_type pos = 0;
+    while (1) {
+        String_t::size_type comma = valueList.find(',', pos);
+        if (!parseElement(p->property, valueList.substr(pos, comma == String_t::npos ? String_t::npos : comma - pos), p->values)) {
+            return false;
+        }
+        if (comma == String_t::npos) {
+            break;
+        }
+        pos = comma+1;
+    }
+
+    // Limit number of variants
+    if (p->values.empty() || getNumVariants() > MAX_VARIANTS / p->values.size()) {
+        return false;
+    }
+
+    m_parameters.pushBackNew(p.release());
+    return true;
+}
+
+// Get number of parameters.
+size_t
+game::sim::Sweep::getNumParameters() const
+{
+    return m_parameters.size();
+}
+
+// Get parameter name.
+String_t
+game::sim::Sweep::getParameterName(size_t index) const
+{
+    return index < m_parameters.size()
+        ? m_parameters[index]->name
+        : String_t();
+}
+
+// Get number of variants.
+size_t
+game::sim::Sweep::getNumVariants() const
+{
+    size_t result = 1;
+    for (size_t i = 0, n = m_parameters.size(); i < n; ++i) {
+        result *= m_parameters[i]->values.size();
+    }
+    return result;
+}
+
+// Get parameter value for a variant.
+String_t
+game::sim::Sweep::getVariantValue(size_t variant, size_t index) const
+{
+    return index < m_parameters.size()
+        ? m_parameters[index]->values[getValueIndex(variant, index)]
+        : String_t();
+}
+
+// Build a variant.
+bool
+game::sim::Sweep::buildVariant(size_t variant, Setup& setup) const
+{
+    for (size_t i = 0, n = m_parameters.size(); i < n; ++i) {
+        const Parameter& p = *m_parameters[i];
+        Object* obj = (p.shipId != 0
+                       ? static_cast<Object*>(setup.findShipById(p.shipId))
+                       : static_cast<Object*>(setup.getPlanet()));
+        if (obj == 0) {
+            return false;
+        }
+        applyValue(*obj, p.property, p.values[getValueIndex(variant, i)]);
+    }
+    return true;
+}
+
+/** Get index into a parameter's value list for a variant.
+    \param variant Variant index
+    \param index   Parameter index
+    \return value index */
+size_t
+game::sim::Sweep::getValueIndex(size_t variant, size_t index) const
+{
+    for (size_t i = m_parameters.size(); i > index+1; --i) {
+        variant /= m_parameters[i-1]->values.size();
+    }
+    return variant % m_parameters[index]->values.size();
+}
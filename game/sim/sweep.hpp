@@ -0,0 +1,91 @@
+/**
+  *  \file game/sim/sweep.hpp
+  *  \brief Class game::sim::Sweep
+  */
+#ifndef C2NG_GAME_SIM_SWEEP_HPP
+#define C2NG_GAME_SIM_SWEEP_HPP
+
+#include <vector>
+#include "afl/container/ptrvector.hpp"
+#include "afl/string/string.hpp"
+#include "game/types.hpp"
+
+namespace game { namespace sim {
+
+    class Setup;
+
+    /** Parameter sweep.
+        Describes a set of variants of a simulation setup.
+        Each parameter names a unit property and a list of values for it;
+        the variants are all combinations of these values.
+
+        Parameters are given in textual form, "UNIT:PROPERTY=VALUES".
+        - UNIT is a ship Id, or "planet"
+        - PROPERTY is a property name, e.g. "ammo", "fcode", "aggressiveness" (see addParameter())
+        - VALUES is a comma-separated list of values.
+          For numeric properties, an element can be a range "FROM..TO" or "FROM..TO/STEP".
+
+        For example, "12:ammo=10..50/10" produces five variants with ship #12 having 10, 20, 30, 40, 50 torpedoes.
+
+        Variants are numbered from 0 to getNumVariants()-1.
+        The last parameter varies fastest. */
+    class Sweep {
+     public:
+        /** Maximum number of variants. */
+        static const size_t MAX_VARIANTS = 100000;
+
+        /** Constructor.
+            Makes a sweep without parameters, i.e. a single variant that is identical to the base setup. */
+        Sweep();
+
+        /** Destructor. */
+        ~Sweep();
+
+        /** Add a parameter.
+
+            Ship properties: "ammo", "aggressiveness" (number, "kill", "passive", "nofuel"),
+            "beams", "beamtype", "launchers", "torptype", "bays", "crew", "engine".
+            Planet properties: "defense", "basedefense", "basebeamtech", "basetorptech", "basefighters".
+            Properties for both: "fcode", "damage", "shield", "owner", "level".
+
+            \param spec Parameter specification, "UNIT:PROPERTY=VALUES"
+            \return true on success; false if the specification is invalid or produces too many variants */
+        bool addParameter(const String_t& spec);
+
+        /** Get number of parameters.
+            \return number of parameters */
+        size_t getNumParameters() const;
+
+        /** Get parameter name.
+            \param index Parameter index [0,getNumParameters())
+            \return name, "UNIT:PROPERTY"; empty if index out of range */
+        String_t getParameterName(size_t index) const;
+
+        /** Get number of variants.
+            \return number of variants (at least 1) */
+        size_t getNumVariants() const;
+
+        /** Get parameter value for a variant.
+            \param variant Variant index [0,getNumVariants())
+            \param index   Parameter index [0,getNumParameters())
+            \return value as given in the specification; empty if index out of range */
+        String_t getVariantValue(size_t variant, size_t index) const;
+
+        /** Build a variant.
+            Applies the parameter values of the variant to the given setup.
+            \param [in]     variant Variant index [0,getNumVariants())
+            \param [in,out] setup   Setup; should be a copy of the base setup
+            \return true on success; false if a unit named by a parameter does not exist in the setup */
+        bool buildVariant(size_t variant, Setup& setup) const;
+
+     private:
+        struct Parameter;
+
+        afl::container::PtrVector<Parameter> m_parameters;
+
+        size_t getValueIndex(size_t variant, size_t index) const;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,270 @@
+/**
+  *  \file game/sim/sweeprunner.cpp
+  *  \brief Class game::sim::SweepRunner
+  */
+
+#include <memory>
+#include "game/sim/sweeprunner.hpp"
+#include "afl/base/runnable.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "game/sim/run.hpp"
+#include "game/sim/simplerunner.hpp"
+#include "util/randomnumbergenerator.hpp"
+
+/* Runner for a single variant.
+   We do our own job scheduling across variants, and therefore need access to the job primitives. */
+class game::sim::SweepRunner::VariantRunner : public SimpleRunner {
+ public:
+    VariantRunner(const Setup& setup,
+                  const Configuration& opts,
+                  const game::spec::ShipList& list,
+                  const game::config::HostConfiguration& config,
+                  const game::vcr::flak::Configuration& flakConfig,
+                  afl::sys::LogListener& log,
+                  util::RandomNumberGenerator& rng)
+        : SimpleRunner(setup, opts, list, config, flakConfig, log, rng)
+        { }
+
+    using Runner::makeJob;
+    using Runner::finishJob;
+    using Runner::runJob;
+};
+
+/* Worker thread body */
+class game::sim::SweepRunner::Worker : public afl::base::Runnable {
+ public:
+    Worker(SweepRunner& parent)
+        : m_parent(parent)
+        { }
+    void run()
+        { m_parent.work(); }
+ private:
+    SweepRunner& m_parent;
+};
+
+/* A variant */
+struct game::sim::SweepRunner::Variant {
+    Setup setup;
+    util::RandomNumberGenerator rng;
+    std::auto_ptr<VariantRunner> runner;
+    Runner::Limit_t limit;
+    bool ready;                  ///< true if first simulation has been run and limit is valid.
+    bool valid;                  ///< true if first simulation produced battles.
+    bool done;                   ///< true if makeJob() reported completion.
+
+    Variant(const Setup& setup, uint32_t seed)
+        : setup(setup), rng(seed), runner(), limit(), ready(false), valid(false), done(false)
+        { }
+};
+
+
+// Constructor.
+game::sim::SweepRunner::SweepRunner(const Configuration& opts,
+                                    const game::spec::ShipList& list,
+                                    const game::config::HostConfiguration& config,
+                                    const game::vcr::flak::Configuration& flakConfig,
+                                    afl::sys::LogListener& log)
+    : m_options(opts),
+      m_shipList(list),
+      m_config(config),
+      m_flakConfiguration(flakConfig),
+      m_log(log),
+      m_variants(),
+      m_mutex(),
+      m_nextInit(0),
+      m_firstOpen(0),
+      m_numInitializing(0),
+      m_numWaiting(0),
+      m_readySignal(0),
+      m_count(0),
+      m_precision(0),
+      m_pStopper(0)
+{ }
+
+// Destructor.
+game::sim::SweepRunner::~SweepRunner()
+{ }
+
+// Add a variant.
+size_t
+game::sim::SweepRunner::addVariant(const Setup& setup, uint32_t seed)
+{
+    Variant* v = m_variants.pushBackNew(new Variant(setup, seed));
+    prepareSimulation(v->setup, m_options, v->rng);
+    v->runner.reset(new VariantRunner(v->setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log, v->rng));
+    return m_variants.size() - 1;
+}
+
+// Get number of variants.
+size_t
+game::sim::SweepRunner::getNumVariants() const
+{
+    return m_variants.size();
+}
+
+// Run simulations.
+void
+game::sim::SweepRunner::run(size_t numThreads, size_t count, double precision, util::StopSignal& stopper)
+{
+    // Save parameters where threads can find them
+    m_count = count;
+    m_precision = precision;
+    m_pStopper = &stopper;
+
+    // Variants initialized by a previous run() receive a new limit
+    for (size_t i = 0, n = m_variants.size(); i < n; ++i) {
+        Variant& v = *m_variants[i];
+        if (v.ready && v.valid) {
+            v.limit = makeLimit(*v.runner);
+            v.done = false;
+        }
+    }
+    m_firstOpen = 0;
+    m_numInitializing = 0;
+    m_numWaiting = 0;
+
+    // Run
+    if (numThreads <= 1) {
+        work();
+    } else {
+        Worker worker(*this);
+        afl::container::PtrVector<afl::sys::Thread> threads;
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.pushBackNew(new afl::sys::Thread("game.sim.sweep", worker))->start();
+        }
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads[i]->join();
+        }
+    }
+
+    // Clear
+    m_pStopper = 0;
+}
+
+// Get result list of a variant.
+const game::sim::ResultList*
+game::sim::SweepRunner::getResultList(size_t index) const
+{
+    if (index < m_variants.size() && m_variants[index]->valid) {
+        return &m_variants[index]->runner->resultList();
+    } else {
+        return 0;
+    }
+}
+
+/** Worker thread body.
+    Processes requests until there is no more work. */
+void
+game::sim::SweepRunner::work()
+{
+    while (processRequest()) {
+        // nix
+    }
+}
+
+/** Process a single request.
+    Runs the first simulation of a variant, or one simulation job,
+    or waits for a variant to become ready.
+    \return true to continue, false if there is no more work */
+bool
+game::sim::SweepRunner::processRequest()
+{
+    // Initialize variants first; this does not need any shared state
+    Variant* pInit = 0;
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        if (m_pStopper->get()) {
+            return false;
+        }
+        if (m_nextInit < m_variants.size()) {
+            pInit = m_variants[m_nextInit++];
+            ++m_numInitializing;
+        }
+    }
+    if (pInit != 0) {
+        bool ok = pInit->runner->init();
+
+        afl::sys::MutexGuard g(m_mutex);
+        pInit->valid = ok;
+        pInit->done = !ok;
+        if (ok) {
+            pInit->limit = makeLimit(*pInit->runner);
+        }
+        pInit->ready = true;
+
+        // Wake threads that are waiting for work
+        --m_numInitializing;
+        while (m_numWaiting > 0) {
+            m_readySignal.post();
+            --m_numWaiting;
+        }
+        return true;
+    }
+
+    // Fetch a job from the first variant that still has work
+    std::auto_ptr<Runner::Job> job;
+    Variant* pJob = 0;
+    bool wait = false;
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        for (size_t i = m_firstOpen, n = m_variants.size(); i < n && job.get() == 0; ++i) {
+            Variant& v = *m_variants[i];
+            if (v.ready && !v.done) {
+                job.reset(v.runner->makeJob(v.limit, *m_pStopper));
+                if (job.get() != 0) {
+                    pJob = &v;
+                } else {
+                    v.done = true;
+                }
+            }
+        }
+        while (m_firstOpen < m_variants.size() && m_variants[m_firstOpen]->done) {
+            ++m_firstOpen;
+        }
+
+        // No job, but a variant is still being initialized: wait for it instead of quitting.
+        if (job.get() == 0 && m_numInitializing != 0) {
+            ++m_numWaiting;
+            wait = true;
+        }
+    }
+    if (job.get() == 0) {
+        if (wait) {
+            m_readySignal.wait();
+            return true;
+        }
+        return false;
+    }
+
+    // Do it
+    VariantRunner::runJob(job.get());
+
+    // Put back
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        pJob->runner->finishJob(job.release());
+    }
+    return true;
+}
+
+/** Make limit for a variant, according to the current run() parameters.
+    \param r Runner. Must have been initialized.
+    \return limit */
+game::sim::Runner::Limit_t
+game::sim::SweepRunner::makeLimit(const Runner& r) const
+{
+    if (m_precision > 0) {
+        if (m_count == 0) {
+            return r.makePrecisionLimit(m_precision, 0);
+        } else if (m_count > 1) {
+            return r.makePrecisionLimit(m_precision, m_count - 1);
+        } else {
+            return r.makeFiniteLimit(0);
+        }
+    } else if (m_count != 0) {
+        return r.makeFiniteLimit(m_count - 1);
+    } else {
+        return r.makeSeriesLimit();
+    }
+}
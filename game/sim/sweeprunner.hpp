@@ -0,0 +1,128 @@
+/**
+  *  \file game/sim/sweeprunner.hpp
+  *  \brief Class game::sim::SweepRunner
+  */
+#ifndef C2NG_GAME_SIM_SWEEPRUNNER_HPP
+#define C2NG_GAME_SIM_SWEEPRUNNER_HPP
+
+#include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/sys/loglistener.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/semaphore.hpp"
+#include "game/config/hostconfiguration.hpp"
+#include "game/sim/resultlist.hpp"
+#include "game/sim/runner.hpp"
+#include "game/sim/setup.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/vcr/flak/configuration.hpp"
+#include "util/stopsignal.hpp"
+
+namespace game { namespace sim {
+
+    class Configuration;
+
+    /** Simulation runner for multiple setups.
+        Runs simulations for a list of setup variants (e.g. produced by Sweep) using one shared set of threads.
+
+        Each variant has its own Runner and ResultList, but simulation jobs are taken from a common pool:
+        a worker thread takes the next job from the first variant that still has work to do,
+        so all threads work on a variant until it is complete,
+        and idle threads help with the remaining variants towards the end.
+        A thread that finds no job while another thread is still running a variant's first simulation
+        waits for that to complete, so it can help with that variant.
+
+        Worker threads work on the configuration, ship list and host configuration passed to the constructor,
+        which must therefore out-live the SweepRunner and not be modified while run() is active. */
+    class SweepRunner : afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param [in]     opts    Simulation options
+            \param [in]     list    Ship list
+            \param [in]     config  Host configuration
+            \param [in]     flakConfig FLAK configuration
+            \param [in,out] log     Logger (for errors) */
+        SweepRunner(const Configuration& opts,
+                    const game::spec::ShipList& list,
+                    const game::config::HostConfiguration& config,
+                    const game::vcr::flak::Configuration& flakConfig,
+                    afl::sys::LogListener& log);
+
+        /** Destructor. */
+        ~SweepRunner();
+
+        /** Add a variant.
+            The setup is copied and prepared for simulation (see prepareSimulation()).
+            \param setup Setup
+            \param seed  Random number seed for this variant
+            \return index of new variant */
+        size_t addVariant(const Setup& setup, uint32_t seed);
+
+        /** Get number of variants.
+            \return number of variants */
+        size_t getNumVariants() const;
+
+        /** Run simulations.
+            For each variant, runs the first simulation, and then more simulations until the limit is reached:
+            - if count is nonzero, a total of count simulations per variant, otherwise,
+            - if precision is nonzero, until the precision has been reached (see Runner::makePrecisionLimit()), otherwise
+            - one series (see Runner::makeSeriesLimit()).
+
+            If count and precision are both given, count is the maximum.
+
+            \param numThreads Number of threads to use (at least 1)
+            \param count      Number of simulations per variant, see above
+            \param precision  Precision, see above
+            \param stopper    Can be signaled by another thread to stop early */
+        void run(size_t numThreads, size_t count, double precision, util::StopSignal& stopper);
+
+        /** Get result list of a variant.
+            \param index Variant index [0,getNumVariants())
+            \return result list; null if index is out of range or the variant did not produce any battles */
+        const ResultList* getResultList(size_t index) const;
+
+     private:
+        class VariantRunner;
+        class Worker;
+        struct Variant;
+
+        const Configuration& m_options;
+        const game::spec::ShipList& m_shipList;
+        const game::config::HostConfiguration& m_config;
+        const game::vcr::flak::Configuration& m_flakConfiguration;
+        afl::sys::LogListener& m_log;
+
+        /** Variants. */
+        afl::container::PtrVector<Variant> m_variants;
+
+        /** Mutex protecting the scheduling state and the runners' makeJob(), finishJob(). */
+        afl::sys::Mutex m_mutex;
+
+        /** Index of next variant to initialize. */
+        size_t m_nextInit;
+
+        /** Index of first variant that may still have jobs. */
+        size_t m_firstOpen;
+
+        /** Number of variants whose first simulation is currently running. */
+        size_t m_numInitializing;
+
+        /** Number of threads waiting for m_readySignal. */
+        size_t m_numWaiting;
+
+        /** Signal for waiting threads; posted once per waiting thread when a variant becomes ready. */
+        afl::sys::Semaphore m_readySignal;
+
+        /** Parameters of current run(). */
+        size_t m_count;
+        double m_precision;
+        util::StopSignal* m_pStopper;
+
+        void work();
+        bool processRequest();
+        Runner::Limit_t makeLimit(const Runner& r) const;
+    };
+
+} }
+
+#endif
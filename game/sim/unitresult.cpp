@@ -10,7 +10,7 @@
 
 // Make blank result.
 game::sim::UnitResult::Item::Item()
-    : min(0), max(0), totalScaled(0), minSpecimen(), maxSpecimen()
+    : min(0), max(0), totalScaled(0), totalSquaredScaled(0), minSpecimen(), maxSpecimen()
 {
     // ex GSimStatItem
 }
@@ -20,6 +20,7 @@ game::sim::UnitResult::Item::Item(const Item& orig, int32_t subtract_from, int32
     : min(subtract_from - orig.max),
       max(subtract_from - orig.min),
       totalScaled(subtract_from * scale - orig.totalScaled),
+      totalSquaredScaled(double(subtract_from) * subtract_from * scale - 2.0 * subtract_from * orig.totalScaled + orig.totalSquaredScaled),
       minSpecimen(orig.maxSpecimen),
       maxSpecimen(orig.minSpecimen)
 { }
@@ -197,6 +198,7 @@ game::sim::UnitResult::add(Item& it, int32_t value, const Result& w)
         }
     }
     it.totalScaled += value * w.this_battle_weight;
+    it.totalSquaredScaled += double(value) * value * w.this_battle_weight;
 }
 
 // Change weight proportionally.
@@ -204,4 +206,5 @@ void
 game::sim::UnitResult::changeWeight(Item& it, int32_t oldWeight, int32_t newWeight)
 {
     it.totalScaled = it.totalScaled * newWeight / oldWeight;
+    it.totalSquaredScaled = it.totalSquaredScaled * newWeight / oldWeight;
 }
@@ -20,11 +20,12 @@ namespace game { namespace sim {
     class UnitResult {
      public:
         /** Statistics counter.
-            Counts minimum, maximum and total (for average computation). */
+            Counts minimum, maximum, total (for average computation) and total of squares (for variance computation). */
         struct Item {
             int32_t  min;
             int32_t  max;
             int32_t  totalScaled;            // ex total_scaled
+            double   totalSquaredScaled;
             Database_t minSpecimen;          // ex min_specimen
             Database_t maxSpecimen;          // ex max_specimen
 
@@ -99,6 +99,14 @@ game::spec::FriendlyCode::FriendlyCode(String_t code, String_t descriptionLine,
     initFromString(descriptionLine, tx);
 }
 
+// Construct from attributes.
+game::spec::FriendlyCode::FriendlyCode(String_t code, String_t description, PlayerSet_t races, FlagSet_t flags)
+    : m_code(code),
+      m_description(description),
+      m_races(races),
+      m_flags(flags)
+{ }
+
 // Destructor.
 game::spec::FriendlyCode::~FriendlyCode()
 { }
@@ -119,6 +127,13 @@ game::spec::FriendlyCode::getDescription(const PlayerList& playerList, afl::stri
     return playerList.expandNames(m_description, false, tx);
 }
 
+// Get description text, unexpanded.
+const String_t&
+game::spec::FriendlyCode::getRawDescription() const
+{
+    return m_description;
+}
+
 // Get flags.
 game::spec::FriendlyCode::FlagSet_t
 game::spec::FriendlyCode::getFlags() const
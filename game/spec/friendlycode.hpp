@@ -119,6 +119,13 @@ namespace game { namespace spec {
             \throw std::runtime_error descriptionLine is invalid */
         FriendlyCode(String_t code, String_t descriptionLine, afl::string::Translator& tx);
 
+        /** Construct from attributes.
+            \param code        Friendly code
+            \param description Description text, see getRawDescription()
+            \param races       Set of races who can use this friendly code
+            \param flags       Flags */
+        FriendlyCode(String_t code, String_t description, PlayerSet_t races, FlagSet_t flags);
+
         /** Destructor. */
         ~FriendlyCode();
 
@@ -132,6 +139,10 @@ namespace game { namespace spec {
             \return formatted description */
         String_t getDescription(const PlayerList& playerList, afl::string::Translator& tx) const;
 
+        /** Get description text, with player name placeholders unexpanded.
+            \return description text */
+        const String_t& getRawDescription() const;
+
         /** Get flags.
             \return Flags */
         FlagSet_t getFlags() const;
@@ -111,6 +111,30 @@ game::spec::HullAssignmentList::getPlayersForHull(const game::config::HostConfig
     return result;
 }
 
+// Get hull, given a player slot and an index, as stored.
+int
+game::spec::HullAssignmentList::getStoredHull(int player, int index) const
+{
+    if (player <= 0 || player >= int(m_mapping.size())) {
+        return 0;
+    } else if (index <= 0 || index >= int(m_mapping[player].size())) {
+        return 0;
+    } else {
+        return m_mapping[player][index];
+    }
+}
+
+// Get maximum index for a player slot, as stored.
+int
+game::spec::HullAssignmentList::getStoredMaxIndex(int player) const
+{
+    if (player <= 0 || player >= int(m_mapping.size()) || m_mapping[player].size() <= 1) {
+        return 0;
+    } else {
+        return int(m_mapping[player].size() - 1);
+    }
+}
+
 int
 game::spec::HullAssignmentList::mapPlayer(const game::config::HostConfiguration& config, int player) const
 {
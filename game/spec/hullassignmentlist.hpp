@@ -68,6 +68,19 @@ namespace game { namespace spec {
             \return Set of players such that for each set player, getIndexFromHull() is nonzero. */
         PlayerSet_t getPlayersForHull(const game::config::HostConfiguration& config, int hullNr) const;
 
+        /** Get hull, given a player slot and an index, as stored with add().
+            Unlike getHullFromIndex(), this does not apply MapTruehullByPlayerRace.
+            \param player Player slot (>0)
+            \param index Index (>0)
+            \return Hull number. Zero if parameters are out of range, or the slot is empty. */
+        int getStoredHull(int player, int index) const;
+
+        /** Get maximum index for a player slot, as stored with add().
+            Unlike getMaxIndex(), this does not apply MapTruehullByPlayerRace.
+            \param player Player slot (>0)
+            \return Maximum index (inclusive) */
+        int getStoredMaxIndex(int player) const;
+
      private:
         /** Mapping; first by player, then by index.
             Note that as of 20170412, we include the unused 0th element in both dimensions. */
@@ -85,3 +85,21 @@ game::spec::ModifiedHullFunctionList::getFunctionDefinition(Function_t id, HullF
         }
     }
 }
+
+// Get number of modified functions.
+size_t
+game::spec::ModifiedHullFunctionList::getNumFunctions() const
+{
+    return m_modifiedFunctions.size();
+}
+
+// Get modified function by index.
+const game::spec::HullFunction*
+game::spec::ModifiedHullFunctionList::getFunctionByIndex(size_t index) const
+{
+    if (index < m_modifiedFunctions.size()) {
+        return m_modifiedFunctions[index];
+    } else {
+        return 0;
+    }
+}
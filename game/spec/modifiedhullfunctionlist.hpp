@@ -59,6 +59,16 @@ namespace game { namespace spec {
             \retval false id was not valid; def not set to a valid definition */
         bool getFunctionDefinition(Function_t id, HullFunction& def) const;
 
+        /** Get number of modified functions.
+            \return Number of modified functions */
+        size_t getNumFunctions() const;
+
+        /** Get modified function by index.
+            Passing the definitions to getFunctionIdFromDefinition() in index order re-creates the same Ids.
+            \param index Index [0,getNumFunctions())
+            \return Function definition; null if index is invalid */
+        const HullFunction* getFunctionByIndex(size_t index) const;
+
      private:
         /** Modified hull functions.
             This defines the modified (=level-restricted) hull functions.
@@ -172,3 +172,26 @@ game::spec::StandardComponentNameProvider::load(afl::io::Directory& dir, afl::st
         parser.parseFile(*file);
     }
 }
+
+void
+game::spec::StandardComponentNameProvider::addTranslation(Type type, const String_t& name, const String_t& value)
+{
+    if (size_t(type) < NUM_TRANSLATIONS) {
+        Translations_t& tx = m_translations[type];
+        const String_t key(afl::string::strUCase(name));
+        if (tx.find(key) == tx.end()) {
+            tx.insert(std::make_pair(key, value));
+        }
+    }
+}
+
+const game::spec::StandardComponentNameProvider::Translations_t&
+game::spec::StandardComponentNameProvider::getTranslations(Type type) const
+{
+    static const Translations_t EMPTY;
+    if (size_t(type) < NUM_TRANSLATIONS) {
+        return m_translations[type];
+    } else {
+        return EMPTY;
+    }
+}
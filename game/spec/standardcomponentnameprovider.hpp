@@ -19,6 +19,9 @@ namespace game { namespace spec {
         Call load() to initialize this object by loading the names.cc file. */
     class StandardComponentNameProvider : public ComponentNameProvider {
      public:
+        /** Translations for one component type: upper-case name to short name. */
+        typedef std::map<String_t, String_t> Translations_t;
+
         /** Default constructor.
             Makes an empty object. */
         StandardComponentNameProvider();
@@ -41,9 +44,21 @@ namespace game { namespace spec {
             @param log Logger */
         void load(afl::io::Directory& dir, afl::string::Translator& tx, afl::sys::LogListener& log);
 
+        /** Add a translation.
+            As in load(), if the name already has a translation, that one is kept.
+            \param type  Component type (Hull, Engine, Beam, Torpedo; others are ignored)
+            \param name  Component name (case-insensitive)
+            \param value Short name */
+        void addTranslation(Type type, const String_t& name, const String_t& value);
+
+        /** Get translations.
+            \param type Component type (Hull, Engine, Beam, Torpedo)
+            \return translations; empty for other types */
+        const Translations_t& getTranslations(Type type) const;
+
      private:
         static const size_t NUM_TRANSLATIONS = 4;
-        std::map<String_t, String_t> m_translations[NUM_TRANSLATIONS];
+        Translations_t m_translations[NUM_TRANSLATIONS];
 
         class NameFileParser;
         friend class NameFileParser;
@@ -48,6 +48,7 @@ game::test::SimpleTurn::addShip(Id_t shipId, int owner, game::map::Object::Playa
     pShip->addCurrentShipData(sd, game::PlayerSet_t(owner));
     pShip->internalCheck(game::PlayerSet_t(owner), m_turn.getTurnNumber());
     pShip->setPlayability(playability);
+    universe().markChanged();
 
     // - set some nice properties
     pShip->setHull(m_hullNr);
@@ -89,6 +90,7 @@ game::test::SimpleTurn::addPlanet(Id_t planetId, int owner, game::map::Object::P
     afl::sys::Log log;
     pPlanet->internalCheck(game::map::Configuration(), game::PlayerSet_t(owner), m_turn.getTurnNumber(), tx, log);
     pPlanet->setPlayability(playability);
+    universe().markChanged();
 
     return *pPlanet;
 }
@@ -7,6 +7,8 @@
 #include "afl/base/staticassert.hpp"
 #include "afl/except/assertionfailedexception.hpp"
 #include "afl/except/fileformatexception.hpp"
+#include "afl/except/filetooshortexception.hpp"
+#include "afl/io/filemapping.hpp"
 #include "afl/string/format.hpp"
 #include "game/alliance/hosthandler.hpp"
 #include "game/alliance/phosthandler.hpp"
@@ -39,9 +41,11 @@
 #include "game/vcr/flak/database.hpp"
 #include "util/translation.hpp"
 
+using afl::base::ConstBytes_t;
 using afl::base::Ref;
 using afl::except::FileFormatException;
 using afl::except::checkAssertion;
+using afl::io::FileMapping;
 using afl::io::FileSystem;
 using afl::io::Stream;
 using afl::string::Format;
@@ -134,6 +138,26 @@ namespace {
         // Use directory name
         gameName.setAndMarkUpdated(dir.getTitle(), game::config::ConfigurationOption::Game);
     }
+
+    /* Read a block of records.
+       Reads all records at once, using a file mapping if the stream supports it, instead of reading them one by one.
+       The whole block is validated against the file size up-front; the stream is positioned after the block.
+       \param file       File
+       \param recordSize Size of a record
+       \param count      Number of records; can be zero or negative to read nothing
+       \return mapping containing exactly count*recordSize bytes
+       \throw afl::except::FileTooShortException if the file is too short */
+    Ref<FileMapping> readRecords(Stream& file, size_t recordSize, int count)
+    {
+        const size_t size = (count > 0 ? recordSize * size_t(count) : 0);
+        const Stream::FileSize_t pos = file.getPos();
+        Ref<FileMapping> result = file.createVirtualMapping(size);
+        if (result->get().size() != size) {
+            throw afl::except::FileTooShortException(file);
+        }
+        file.setPos(pos + size);
+        return result;
+    }
 }
 
 // Constructor.
@@ -188,9 +212,11 @@ game::v3::Loader::loadPlanets(game::map::Universe& univ, afl::io::Stream& file,
     // ex game/load.cc:loadPlanets
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d planet%!1{s%}..."), count));
     Reverter* pReverter = dynamic_cast<Reverter*>(univ.getReverter());
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::Planet), count);
+    ConstBytes_t data = block->get();
     while (count > 0) {
         gt::Planet rawPlanet;
-        file.fullRead(afl::base::fromObject(rawPlanet));
+        afl::base::fromObject(rawPlanet).copyFrom(data.split(sizeof(rawPlanet)));
 
         const int planetId = rawPlanet.planetId;
         map::Planet* p = univ.planets().get(planetId);
@@ -275,9 +301,11 @@ game::v3::Loader::loadBases(game::map::Universe& univ, afl::io::Stream& file, in
     // ex game/load.h:loadBases, ccload.pas:LoadBases
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d starbase%!1{s%}..."), count));
     Reverter* pReverter = dynamic_cast<Reverter*>(univ.getReverter());
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::Base), count);
+    ConstBytes_t data = block->get();
     while (count > 0) {
         gt::Base rawBase;
-        file.fullRead(afl::base::fromObject(rawBase));
+        afl::base::fromObject(rawBase).copyFrom(data.split(sizeof(rawBase)));
 
         const int baseId = rawBase.baseId;
         map::Planet* p = univ.planets().get(baseId);
@@ -311,36 +339,31 @@ game::v3::Loader::loadShipXY(game::map::Universe& univ, afl::io::Stream& file, a
     size_t numShips = (bytes != 0 && bytes >= 999 * sizeof(gt::ShipXY)) ? 999 : 500;
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading up to %d ship position%!1{s%}..."), numShips));
 
-    // Read file in chunks
-    const size_t CHUNK_SIZE = 100;
-    Id_t id = 0;
-    while (numShips > 0) {
-        gt::ShipXY buffer[CHUNK_SIZE];
-        size_t now = std::min(numShips, CHUNK_SIZE);
-        file.fullRead(afl::base::fromObject(buffer).trim(now * sizeof(buffer[0])));
-        for (size_t i = 0; i < now; ++i) {
-            ++id;
-
-            /* Detect bogus files made by Winplan999/Unpack999 when used with Host500.
-               The SHIPXY file continues with a (mangled) copy of GENx.DAT which results in unlikely high coordinates.
-               Only test for ship #501, to keep the risk of false positives low
-               (if someone actually goes that far -- it's not forbidden after all).
-               Stupid "solution" for stupid problem. */
-            int x = buffer[i].x;
-            int y = buffer[i].y;
-            int owner = buffer[i].owner;
-            int mass = buffer[i].mass;
-            if (id == 501 && (x < 0 || x >= 0x3030 || owner >= 0x2020)) {
-                return;
-            }
+    // Read file
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::ShipXY), int(numShips));
+    ConstBytes_t data = block->get();
+    for (Id_t id = 1; id <= Id_t(numShips); ++id) {
+        gt::ShipXY pos;
+        afl::base::fromObject(pos).copyFrom(data.split(sizeof(pos)));
+
+        /* Detect bogus files made by Winplan999/Unpack999 when used with Host500.
+           The SHIPXY file continues with a (mangled) copy of GENx.DAT which results in unlikely high coordinates.
+           Only test for ship #501, to keep the risk of false positives low
+           (if someone actually goes that far -- it's not forbidden after all).
+           Stupid "solution" for stupid problem. */
+        int x = pos.x;
+        int y = pos.y;
+        int owner = pos.owner;
+        int mass = pos.mass;
+        if (id == 501 && (x < 0 || x >= 0x3030 || owner >= 0x2020)) {
+            return;
+        }
 
-            if (owner > 0 && owner <= gt::NUM_OWNERS && !reject.contains(owner)) {
-                if (game::map::Ship* ship = univ.ships().get(id)) {
-                    ship->addShipXYData(game::map::Point(x, y), owner, mass, source);
-                }
+        if (owner > 0 && owner <= gt::NUM_OWNERS && !reject.contains(owner)) {
+            if (game::map::Ship* ship = univ.ships().get(id)) {
+                ship->addShipXYData(game::map::Point(x, y), owner, mass, source);
             }
         }
-        numShips -= now;
     }
 }
 
@@ -349,9 +372,11 @@ game::v3::Loader::loadShips(game::map::Universe& univ, afl::io::Stream& file, in
 {
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d ship%!1{s%}..."), count));
     Reverter* pReverter = dynamic_cast<Reverter*>(univ.getReverter());
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::Ship), count);
+    ConstBytes_t data = block->get();
     while (count > 0) {
         gt::Ship rawShip;
-        file.fullRead(afl::base::fromObject(rawShip));
+        afl::base::fromObject(rawShip).copyFrom(data.split(sizeof(rawShip)));
 
         const int shipId = rawShip.shipId;
         map::Ship* s = univ.ships().get(shipId);
@@ -381,9 +406,11 @@ game::v3::Loader::loadTargets(game::map::Universe& univ, afl::io::Stream& file,
 {
     // ex game/load.cc:loadTargets, ccmain.pas:LoadTargets, ccmain.pas:LoadTargetFile
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d visual contact%!1{s%}..."), count));
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::ShipTarget), count);
+    ConstBytes_t data = block->get();
     while (count > 0) {
         gt::ShipTarget target;
-        file.fullRead(afl::base::fromObject(target));
+        afl::base::fromObject(target).copyFrom(data.split(sizeof(target)));
 
         // Decrypt the target
         if (fmt == TargetEncrypted) {
@@ -441,9 +468,11 @@ game::v3::Loader::loadKoreMinefields(game::map::Universe& univ, afl::io::Stream&
     ty.setAllMinefieldsKnown(player);
 
     // Read the file
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::KoreMine), count);
+    ConstBytes_t data = block->get();
     for (int i = 1; i <= count; ++i) {
         gt::KoreMine mf;
-        file.fullRead(afl::base::fromObject(mf));
+        afl::base::fromObject(mf).copyFrom(data.split(sizeof(mf)));
         if (mf.ownerTypeFlag != 0) {
             // Use get() if radius is 0; we don't want the minefield to start existing in this case
             if (game::map::Minefield* p = (mf.radius == 0 ? ty.get(i) : ty.create(i))) {
@@ -473,9 +502,11 @@ game::v3::Loader::loadKoreIonStorms(game::map::Universe& univ, afl::io::Stream&
 {
     // ex game/load.cc:loadKoreIonStorms
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading up to %d ion storm%!1{s%}..."), count));
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::KoreStorm), count);
+    ConstBytes_t data = block->get();
     for (int i = 1; i <= count; ++i) {
         gt::KoreStorm st;
-        file.fullRead(afl::base::fromObject(st));
+        afl::base::fromObject(st).copyFrom(data.split(sizeof(st)));
         if (st.voltage > 0 && st.radius > 0) {
             game::map::IonStorm* s = univ.ionStorms().get(i);
             if (!s) {
@@ -498,9 +529,11 @@ game::v3::Loader::loadKoreExplosions(game::map::Universe& univ, afl::io::Stream&
     // ex game/load.cc:loadKoreExplosions
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading up to %d explosion%!1{s%}..."), count));
 
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::KoreExplosion), count);
+    ConstBytes_t data = block->get();
     for (int i = 1; i <= count; ++i) {
         gt::KoreExplosion kx;
-        file.fullRead(afl::base::fromObject(kx));
+        afl::base::fromObject(kx).copyFrom(data.split(sizeof(kx)));
         int x = kx.x;
         int y = kx.y;
         if (x != 0 || y != 0) {
@@ -574,9 +607,11 @@ game::v3::Loader::loadUfos(game::map::Universe& univ, afl::io::Stream& file, int
 {
     // ex game/load.h:loadUfos, GUfoType::addUfoData, GUfo::addUfoData
     game::map::UfoType& ufos = univ.ufos();
+    Ref<FileMapping> block = readRecords(file, sizeof(gt::Ufo), count);
+    ConstBytes_t data = block->get();
     for (int i = 0; i < count; ++i) {
         gt::Ufo in;
-        file.fullRead(afl::base::fromObject(in));
+        afl::base::fromObject(in).copyFrom(data.split(sizeof(in)));
         if (in.color != 0) {
             // uc.addUfoData(first_id + i, ufo);
             if (game::map::Ufo* out = ufos.addUfo(firstId+i, in.typeCode, in.color)) {
@@ -9,6 +9,7 @@
 #include "game/parser/messageparser.hpp"
 #include "game/turn.hpp"
 #include "game/v3/udata/parser.hpp"
+#include "util/systeminformation.hpp"
 
 using afl::string::strTrim;
 using afl::string::strCaseCompare;
@@ -141,15 +142,20 @@ game::v3::Parser::parseMessages(afl::io::Stream& in, game::msg::Inbox& inbox, af
         afl::sys::LogListener& m_log;
     };
 
-    // Parse messages
+    // Parse messages. Messages are independent, so parse them in parallel; results are processed in message order.
     DataInterface gdi(m_player, m_root, m_shipList, m_translator);
+    std::vector<String_t> texts;
     for (size_t i = 0, n = inbox.getNumMessages(); i < n; ++i) {
+        texts.push_back(inbox.getMessageText(i, m_translator, m_root.playerList()));
+    }
+    afl::container::PtrVector<afl::container::PtrVector<game::parser::MessageInformation> > results;
+    p.parseMessages(texts, gdi, m_game.currentTurn().getTurnNumber(), results, m_translator, m_log, util::getSystemInformation().numProcessors);
+
+    for (size_t i = 0, n = texts.size(); i < n; ++i) {
         Consumer c(*this, i);
 
         // Normal parsing
-        String_t text = inbox.getMessageText(i, m_translator, m_root.playerList());
-        afl::container::PtrVector<game::parser::MessageInformation> info;
-        p.parseMessage(text, gdi, m_game.currentTurn().getTurnNumber(), info, m_translator, m_log);
+        const afl::container::PtrVector<game::parser::MessageInformation>& info = *results[i];
         c.addMessageInformation(info);
 
         // Determine reference
@@ -3,7 +3,18 @@
   *  \brief Interface game::vcr::classic::Algorithm
   */
 
+#include <typeinfo>
 #include "game/vcr/classic/algorithm.hpp"
+#include "game/vcr/classic/nullvisualizer.hpp"
+
+namespace {
+    /* Check whether a visualizer needs to be called.
+       Only an exact NullVisualizer can be skipped; derived classes may override its methods. */
+    bool needVisualizer(game::vcr::classic::Visualizer& vis)
+    {
+        return typeid(vis) != typeid(game::vcr::classic::NullVisualizer);
+    }
+}
 
 const int32_t game::vcr::classic::Algorithm::MAX_COORDINATE;
 
@@ -14,7 +25,8 @@ const int game::vcr::classic::Algorithm::MAX_FIGHTER_TRACKS;
 
 // Constructor.
 game::vcr::classic::Algorithm::Algorithm(Visualizer& vis)
-    : m_pVisualizer(&vis)
+    : m_pVisualizer(&vis),
+      m_isVisualizing(needVisualizer(vis))
 { }
 
 // Destructor.
@@ -26,6 +38,7 @@ void
 game::vcr::classic::Algorithm::setVisualizer(Visualizer& vis)
 {
     m_pVisualizer = &vis;
+    m_isVisualizing = needVisualizer(vis);
 }
 
 // Get visualizer.
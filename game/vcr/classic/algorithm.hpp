@@ -61,6 +61,13 @@ namespace game { namespace vcr { namespace classic {
         /** Get visualizer. */
         Visualizer& visualizer();
 
+        /** Check whether visualisation is needed.
+            Algorithms use this to skip visualizer calls in their inner loops
+            when the visualizer is a NullVisualizer, i.e. when only the outcome of a fight is needed.
+            This does not change the outcome of a fight.
+            \return false if visualizer is a NullVisualizer */
+        bool isVisualizing() const;
+
         /** Check battle.
             Limits values in \c left, \c right, \c seed to those this algorithm can handle.
             \param left [in/out] left unit
@@ -190,8 +197,16 @@ namespace game { namespace vcr { namespace classic {
 
      private:
         Visualizer* m_pVisualizer;
+        bool m_isVisualizing;
     };
 
 } } }
 
+// Check whether visualisation is needed.
+inline bool
+game::vcr::classic::Algorithm::isVisualizing() const
+{
+    return m_isVisualizing;
+}
+
 #endif
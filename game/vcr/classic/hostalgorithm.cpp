@@ -702,7 +702,9 @@ game::vcr::classic::HostAlgorithm::launchFighter(Status& st)
             st.m_fighterStatus[i] = FighterAttacks;
             st.m_fighterX[i] = st.m_objectX;
             ++st.m_numFightersOut;
-            visualizer().startFighter(*this, st.m_side, i);
+            if (isVisualizing()) {
+                visualizer().startFighter(*this, st.m_side, i);
+            }
             m_statistic[st.m_side].handleFightersAboard(st.m_obj.getNumFighters());
             return;
         }
@@ -735,7 +737,9 @@ game::vcr::classic::HostAlgorithm::fighterShoot(Status& st, Status& opp, int i)
     // ex VcrPlayerTHost::fighterShoot
     if (std::abs(st.m_fighterX[i] - opp.m_objectX) < 20) {
         hit(opp, 2, 2);
-        visualizer().fireBeam(*this, st.m_side, i, -1, 1, 2, 2);
+        if (isVisualizing()) {
+            visualizer().fireBeam(*this, st.m_side, i, -1, 1, 2, 2);
+        }
     }
 }
 
@@ -746,7 +750,9 @@ void
 game::vcr::classic::HostAlgorithm::killFighter(Status& st, int i)
 {
     // ex VcrPlayerTHost::killFighter, ccvcr.pas:KillFighter
-    visualizer().killFighter(*this, st.m_side, i);
+    if (isVisualizing()) {
+        visualizer().killFighter(*this, st.m_side, i);
+    }
     st.m_fighterStatus[i] = FighterIdle;
     --st.m_numFightersOut;
 }
@@ -775,7 +781,9 @@ game::vcr::classic::HostAlgorithm::fighterStuff()
         } else if (m_status[LeftSide].m_fighterStatus[i] == FighterReturns) {
             if (m_status[LeftSide].m_fighterX[i] < m_status[LeftSide].m_objectX) {
                 m_status[LeftSide].m_obj.addFighters(+1);
-                visualizer().landFighter(*this, LeftSide, i);
+                if (isVisualizing()) {
+                    visualizer().landFighter(*this, LeftSide, i);
+                }
                 m_status[LeftSide].m_fighterStatus[i] = FighterIdle;
                 --m_status[LeftSide].m_numFightersOut;
             } else {
@@ -795,7 +803,9 @@ game::vcr::classic::HostAlgorithm::fighterStuff()
         } else if (m_status[RightSide].m_fighterStatus[i] == FighterReturns) {
             if (m_status[RightSide].m_fighterX[i] > m_status[RightSide].m_objectX) {
                 m_status[RightSide].m_obj.addFighters(+1);
-                visualizer().landFighter(*this, RightSide, i);
+                if (isVisualizing()) {
+                    visualizer().landFighter(*this, RightSide, i);
+                }
                 m_status[RightSide].m_fighterStatus[i] = FighterIdle;
                 --m_status[RightSide].m_numFightersOut;
             } else {
@@ -822,10 +832,14 @@ game::vcr::classic::HostAlgorithm::fighterStuff()
                             } else {
                                 /* regular fighter intercept code */
                                 if (n < 50) {
-                                    visualizer().fireBeam(*this, RightSide, j, i, 1, 2, 2);
+                                    if (isVisualizing()) {
+                                        visualizer().fireBeam(*this, RightSide, j, i, 1, 2, 2);
+                                    }
                                     killFighter(m_status[LeftSide], i);
                                 } else {
-                                    visualizer().fireBeam(*this, LeftSide, i, j, 1, 2, 2);
+                                    if (isVisualizing()) {
+                                        visualizer().fireBeam(*this, LeftSide, i, j, 1, 2, 2);
+                                    }
                                     killFighter(m_status[RightSide], j);
                                 }
                             }
@@ -849,7 +863,9 @@ game::vcr::classic::HostAlgorithm::rechargeBeams(Status& st)
         register int j = st.m_beamStatus[i];
         if (getRandom_1_100() > 50 && j < 100) {
             st.m_beamStatus[i] = static_cast<int8_t>(j + st.m_obj.getBeamChargeRate());
-            visualizer().updateBeam(*this, st.m_side, i);
+            if (isVisualizing()) {
+                visualizer().updateBeam(*this, st.m_side, i);
+            }
         }
     }
 }
@@ -864,13 +880,17 @@ game::vcr::classic::HostAlgorithm::fireBeam(Status& st, Status& opp, int which)
     // ex VcrPlayerTHost::fireBeam, ccvcr.pas:FireBeam
     int charge = st.m_beamStatus[which];
     st.m_beamStatus[which] = 0;
-    visualizer().updateBeam(*this, st.m_side, which);
+    if (isVisualizing()) {
+        visualizer().updateBeam(*this, st.m_side, which);
+    }
 
     int da = rdivadd(charge * st.m_beamDamagePower, 100, 0);
     int ki = rdivadd(charge * st.m_beamKillPower,   100, 0) * st.m_obj.getBeamKillRate();
 
     hit(opp, da, ki);
-    visualizer().fireBeam(*this, st.m_side, -1 - which, -1, 1, da, ki);
+    if (isVisualizing()) {
+        visualizer().fireBeam(*this, st.m_side, -1 - which, -1, 1, da, ki);
+    }
 }
 
 /** Fire beams from specified object.
@@ -913,8 +933,10 @@ game::vcr::classic::HostAlgorithm::fireAtFighter(Status& st, Status& opp, int be
 
     if (ftr_id >= 0) {
         st.m_beamStatus[beam] = 0;
-        visualizer().updateBeam(*this, st.m_side, beam);
-        visualizer().fireBeam(*this, st.m_side, -1 - beam, ftr_id, 1, 2, 2 /* FIXME */);
+        if (isVisualizing()) {
+            visualizer().updateBeam(*this, st.m_side, beam);
+            visualizer().fireBeam(*this, st.m_side, -1 - beam, ftr_id, 1, 2, 2 /* FIXME */);
+        }
         killFighter(opp, ftr_id);
     }
 }
@@ -956,9 +978,13 @@ game::vcr::classic::HostAlgorithm::fireTorp(Status& st, Status& opp, int launche
     if (n >= st.m_obj.getTorpMissRate()) {
         hit(opp, st.m_torpDamagePower, st.m_torpKillPower);
         m_statistic[st.m_side].handleTorpedoHit();
-        visualizer().fireTorpedo(*this, st.m_side, n, launcher);
+        if (isVisualizing()) {
+            visualizer().fireTorpedo(*this, st.m_side, n, launcher);
+        }
     } else {
-        visualizer().fireTorpedo(*this, st.m_side, -n, launcher);
+        if (isVisualizing()) {
+            visualizer().fireTorpedo(*this, st.m_side, -n, launcher);
+        }
     }
 }
 
@@ -976,11 +1002,15 @@ game::vcr::classic::HostAlgorithm::fireTorpedoes(Status& st, Status& opp)
             if (st.m_launcherStatus[i] > 40 || (st.m_launcherStatus[i] > 30 && n < st.m_obj.getTorpedoType())) {
                 st.m_obj.addTorpedoes(-1);
                 st.m_launcherStatus[i] = 0;
-                visualizer().updateLauncher(*this, st.m_side, i);
+                if (isVisualizing()) {
+                    visualizer().updateLauncher(*this, st.m_side, i);
+                }
                 fireTorp(st, opp, i);
             }
             advance(st.m_launcherStatus[i], +st.m_obj.getTorpChargeRate());
-            visualizer().updateLauncher(*this, st.m_side, i);
+            if (isVisualizing()) {
+                visualizer().updateLauncher(*this, st.m_side, i);
+            }
         }
     }
 }
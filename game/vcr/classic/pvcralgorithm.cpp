@@ -1070,7 +1070,9 @@ game::vcr::classic::PVCRAlgorithm::fighterLaunch(Status& st)
                     st.r.m_activeFighters++;
                     st.r.obj.addFighters(-1);
                     st.r.m_launchCountdown = st.f.BayLaunchInterval;
-                    visualizer().startFighter(*this, st.f.side, track);
+                    if (isVisualizing()) {
+                        visualizer().startFighter(*this, st.f.side, track);
+                    }
                     st.m_statistic.handleFightersAboard(st.r.obj.getNumFighters());
                     return;
                 }
@@ -1102,7 +1104,9 @@ game::vcr::classic::PVCRAlgorithm::fighterMove(Status& st)
                 /* fighter comes back to baseship */
                 st.r.m_activeFighters--;
                 st.r.obj.addFighters(+1);
-                visualizer().landFighter(*this, side, track);
+                if (isVisualizing()) {
+                    visualizer().landFighter(*this, side, track);
+                }
                 st.r.m_fighterStatus[track] = FighterIdle;
             }
         }
@@ -1183,14 +1187,22 @@ game::vcr::classic::PVCRAlgorithm::fighterIntercept()
                        while a "left" one can not. Whether this is
                        relevant in practice is unknown. */
                     if (randomRange100LT(m_rightProbability)) {
-                        visualizer().fireBeam(*this, RightSide, rf, lf, 1, m_status[RightSide].f.FighterBeamExplosive, m_status[RightSide].f.FighterBeamKill);
+                        if (isVisualizing()) {
+                            visualizer().fireBeam(*this, RightSide, rf, lf, 1, m_status[RightSide].f.FighterBeamExplosive, m_status[RightSide].f.FighterBeamKill);
+                        }
                         m_status[LeftSide].r.m_activeFighters--;
-                        visualizer().killFighter(*this, LeftSide, lf);
+                        if (isVisualizing()) {
+                            visualizer().killFighter(*this, LeftSide, lf);
+                        }
                         m_status[LeftSide].r.m_fighterStatus[lf] = FighterIdle;
                     } else {
-                        visualizer().fireBeam(*this, LeftSide, lf, rf, 1, m_status[LeftSide].f.FighterBeamExplosive, m_status[LeftSide].f.FighterBeamKill);
+                        if (isVisualizing()) {
+                            visualizer().fireBeam(*this, LeftSide, lf, rf, 1, m_status[LeftSide].f.FighterBeamExplosive, m_status[LeftSide].f.FighterBeamKill);
+                        }
                         m_status[RightSide].r.m_activeFighters--;
-                        visualizer().killFighter(*this, RightSide, rf);
+                        if (isVisualizing()) {
+                            visualizer().killFighter(*this, RightSide, rf);
+                        }
                         m_status[RightSide].r.m_fighterStatus[rf] = FighterIdle;
                         rmatch[rs] = NEVER;
                     }
@@ -1220,7 +1232,9 @@ game::vcr::classic::PVCRAlgorithm::fighterAttack(Status& st, Status& opp)
                 }
 
                 bool hitres = hit(opp, st.f.FighterBeamKill, st.f.FighterBeamExplosive, false);
-                visualizer().fireBeam(*this, st.f.side, i, -1, 1, st.f.FighterBeamExplosive, st.f.FighterBeamKill);
+                if (isVisualizing()) {
+                    visualizer().fireBeam(*this, st.f.side, i, -1, 1, st.f.FighterBeamExplosive, st.f.FighterBeamKill);
+                }
                 if (hitres)
                     return true;
             } else if ((m_capabilities & game::v3::structures::BeamCapability) != 0) {
@@ -1276,7 +1290,9 @@ game::vcr::classic::PVCRAlgorithm::beamRecharge(Status& st)
     for (int i = 0; i < mx; ++i) {
         if (st.r.m_beamStatus[i] < 1000) {
             st.r.m_beamStatus[i] += randomRange(st.f.beam_recharge);
-            visualizer().updateBeam(*this, st.f.side, i);
+            if (isVisualizing()) {
+                visualizer().updateBeam(*this, st.f.side, i);
+            }
         }
     }
 }
@@ -1346,10 +1362,14 @@ game::vcr::classic::PVCRAlgorithm::beamFire(Status& st, Status& opp)
             if (fighter >= 0) {
                 /* We fire at a fighter. */
                 st.r.m_beamStatus[beam] = 0;
-                visualizer().updateBeam(*this, st.f.side, beam);
-                visualizer().fireBeam(*this, st.f.side, -1-beam, fighter, missing ? -1 : +1, st.f.beam_damage, st.f.beam_kill);
+                if (isVisualizing()) {
+                    visualizer().updateBeam(*this, st.f.side, beam);
+                    visualizer().fireBeam(*this, st.f.side, -1-beam, fighter, missing ? -1 : +1, st.f.beam_damage, st.f.beam_kill);
+                }
                 if (!missing) {
-                    visualizer().killFighter(*this, opp.f.side, fighter);
+                    if (isVisualizing()) {
+                        visualizer().killFighter(*this, opp.f.side, fighter);
+                    }
                     opp.r.m_fighterStatus[fighter] = FighterIdle;
                     opp.r.m_activeFighters--;
                 }
@@ -1367,15 +1387,21 @@ game::vcr::classic::PVCRAlgorithm::beamFire(Status& st, Status& opp)
             int dest = st.f.beam_damage * (st.r.m_beamStatus[beam]/10) / 100;
 
             st.r.m_beamStatus[beam] = 0;
-            visualizer().updateBeam(*this, st.f.side, beam);
+            if (isVisualizing()) {
+                visualizer().updateBeam(*this, st.f.side, beam);
+            }
 
             if (!missing) {
                 bool hitr = hit(opp, kill, dest, st.f.beam_damage == 0);
-                visualizer().fireBeam(*this, st.f.side, -1-beam, -1, 1, dest, kill);
+                if (isVisualizing()) {
+                    visualizer().fireBeam(*this, st.f.side, -1-beam, -1, 1, dest, kill);
+                }
                 if (hitr)
                     return true;
             } else {
-                visualizer().fireBeam(*this, st.f.side, -1-beam, -1, -1, dest, kill);
+                if (isVisualizing()) {
+                    visualizer().fireBeam(*this, st.f.side, -1-beam, -1, -1, dest, kill);
+                }
             }
             return false;
         }
@@ -1414,7 +1440,9 @@ game::vcr::classic::PVCRAlgorithm::torpsRecharge(Status& st)
     for (int i = 0; i < mx; ++i) {
         if (st.r.m_launcherStatus[i] < 1000) {
             st.r.m_launcherStatus[i] += randomRange(st.f.torp_recharge);
-            visualizer().updateLauncher(*this, st.f.side, i);
+            if (isVisualizing()) {
+                visualizer().updateLauncher(*this, st.f.side, i);
+            }
         }
     }
 }
@@ -1434,7 +1462,9 @@ game::vcr::classic::PVCRAlgorithm::torpsFire(Status& st, Status& opp)
 
             st.r.obj.addTorpedoes(-1);
             st.r.m_launcherStatus[launcher] = 0;
-            visualizer().updateLauncher(*this, st.f.side, launcher);
+            if (isVisualizing()) {
+                visualizer().updateLauncher(*this, st.f.side, launcher);
+            }
             if (rr <= st.f.torp_hit_odds) {
                 /* Scaling factor for torpedo effect has already been applied in initialisation. */
                 int kill = st.f.torp_kill;
@@ -1443,11 +1473,15 @@ game::vcr::classic::PVCRAlgorithm::torpsFire(Status& st, Status& opp)
                 /* we hit the enemy */
                 bool hitr = hit(opp, kill, damage, damage == 0);
                 st.m_statistic.handleTorpedoHit();
-                visualizer().fireTorpedo(*this, st.f.side, rr, launcher);
+                if (isVisualizing()) {
+                    visualizer().fireTorpedo(*this, st.f.side, rr, launcher);
+                }
                 return hitr;
             } else {
                 /* miss */
-                visualizer().fireTorpedo(*this, st.f.side, -1-rr, launcher);
+                if (isVisualizing()) {
+                    visualizer().fireTorpedo(*this, st.f.side, -1-rr, launcher);
+                }
                 return false;
             }
         }
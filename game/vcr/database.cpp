@@ -0,0 +1,48 @@
+/**
+  *  \file game/vcr/database.cpp
+  *  \brief Base class game::vcr::Database
+  */
+
+#include <vector>
+#include "game/vcr/database.hpp"
+#include "game/vcr/battle.hpp"
+#include "util/parallelfor.hpp"
+
+namespace {
+    /* Body for prepareResults(). */
+    class Body : public afl::base::Closure<void(size_t)> {
+     public:
+        Body(const std::vector<game::vcr::Battle*>& battles, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel)
+            : m_battles(battles), m_config(config), m_shipList(shipList), m_resultLevel(resultLevel)
+            { }
+
+        virtual void call(size_t index)
+            { m_battles[index]->prepareResult(m_config, m_shipList, m_resultLevel); }
+
+     private:
+        const std::vector<game::vcr::Battle*>& m_battles;
+        const game::config::HostConfiguration& m_config;
+        const game::spec::ShipList& m_shipList;
+        int m_resultLevel;
+    };
+}
+
+// Prepare results of all battles.
+void
+game::vcr::Database::prepareResults(const game::config::HostConfiguration& config,
+                                    const game::spec::ShipList& shipList,
+                                    int resultLevel,
+                                    size_t numThreads)
+{
+    // Collect battles. getBattle() is only called from this thread.
+    std::vector<Battle*> battles;
+    for (size_t i = 0, n = getNumBattles(); i < n; ++i) {
+        if (Battle* b = getBattle(i)) {
+            battles.push_back(b);
+        }
+    }
+
+    // Process
+    Body body(battles, config, shipList, resultLevel);
+    util::parallelFor(battles.size(), numThreads, "game.vcr.prepare", body);
+}
@@ -8,6 +8,11 @@
 #include "afl/base/deletable.hpp"
 #include "afl/base/types.hpp"
 
+namespace game {
+    namespace config { class HostConfiguration; }
+    namespace spec { class ShipList; }
+}
+
 namespace game { namespace vcr {
 
     class Battle;
@@ -22,6 +27,22 @@ namespace game { namespace vcr {
         /** Get a VCR entry.
             \param nr Number, [0,getNumBattles()) */
         virtual Battle* getBattle(size_t nr) = 0;
+
+        /** Prepare results of all battles.
+            Calls Battle::prepareResult() for all battles, distributing the battles to multiple threads.
+            Battles cache their results, so subsequent getOutcome() or computeScores() calls do not need to play the fight again.
+
+            Battles are independent of each other, and the configuration and ship list are only read.
+            However, the caller must make sure that no other thread accesses the database or the battles during this call.
+
+            \param config      Host configuration
+            \param shipList    Ship list
+            \param resultLevel Requested result level (Battle::NeedQuickOutcome, Battle::NeedCompleteResult, or combination thereof)
+            \param numThreads  Number of threads to use; 1 or 0 to compute all results in the calling thread */
+        void prepareResults(const game::config::HostConfiguration& config,
+                            const game::spec::ShipList& shipList,
+                            int resultLevel,
+                            size_t numThreads);
     };
 
 } }
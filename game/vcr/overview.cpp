@@ -6,6 +6,7 @@
 #include "game/vcr/overview.hpp"
 #include "afl/string/format.hpp"
 #include "game/vcr/object.hpp"
+#include "util/systeminformation.hpp"
 
 namespace {
     struct SortGroups {
@@ -44,6 +45,9 @@ game::vcr::Overview::Overview(Database& battles, const game::config::HostConfigu
       m_units(),
       m_groupCounter(0)
 {
+    // Compute outcomes in parallel; addBattle() will then find them cached
+    battles.prepareResults(config, shipList, Battle::NeedQuickOutcome, util::getSystemInformation().numProcessors);
+
     for (size_t i = 0, n = battles.getNumBattles(); i < n; ++i) {
         if (Battle* b = battles.getBattle(i)) {
             addBattle(*b, i);
@@ -69,6 +73,7 @@ game::vcr::Overview::buildScoreSummary(ScoreSummary& out)
     out.players.clear();
     out.scores.setAll(Score());
     out.numBattles = numBattles;
+    m_battles.prepareResults(m_config, m_shipList, Battle::NeedCompleteResult, util::getSystemInformation().numProcessors);
     for (size_t battleNr = 0; battleNr < numBattles; ++battleNr) {
         if (Battle* b = m_battles.getBattle(battleNr)) {
             b->prepareResult(m_config, m_shipList, Battle::NeedCompleteResult);
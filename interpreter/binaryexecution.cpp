@@ -9,6 +9,7 @@
 #include "afl/charset/utf8.hpp"
 #include "afl/data/booleanvalue.hpp"
 #include "afl/data/floatvalue.hpp"
+#include "afl/data/integervalue.hpp"
 #include "afl/data/scalarvalue.hpp"
 #include "afl/data/stringvalue.hpp"
 #include "afl/data/visitor.hpp"
@@ -1098,6 +1099,30 @@ interpreter::executeBinaryOperation(World& world, uint8_t op, const afl::data::V
     }
 }
 
+// Execute binary operation in-place, if possible.
+bool
+interpreter::executeBinaryOperationInPlace(uint8_t op, afl::data::Value* a, const afl::data::Value* b)
+{
+    // Integer +/- integer produces an integer (FAdd, FSub), so we can update a's value.
+    // BooleanValue derives from IntegerValue, but produces an IntegerValue result; leave that to FAdd/FSub.
+    if (op == biAdd || op == biSub) {
+        afl::data::IntegerValue* ia = dynamic_cast<afl::data::IntegerValue*>(a);
+        const afl::data::IntegerValue* ib = dynamic_cast<const afl::data::IntegerValue*>(b);
+        if (ia != 0 && ib != 0
+            && dynamic_cast<const afl::data::BooleanValue*>(a) == 0
+            && dynamic_cast<const afl::data::BooleanValue*>(b) == 0)
+        {
+            if (op == biAdd) {
+                ia->add(ib->getValue());
+            } else {
+                ia->add(-ib->getValue());
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 // Execute a comparison operation.
 int
 interpreter::executeComparison(uint8_t op, const afl::data::Value* a, const afl::data::Value* b)
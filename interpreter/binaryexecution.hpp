@@ -19,6 +19,17 @@ namespace interpreter {
         \return New value to push on value stack */
     afl::data::Value* executeBinaryOperation(World& world, uint8_t op, const afl::data::Value* a, const afl::data::Value* b);
 
+    /** Execute binary operation in-place, if possible.
+        This is a shortcut for simple integer arithmetic on a value owned by the caller (i.e. the value stack).
+        If the operation can be performed by modifying \c a, does so and returns true;
+        the result is the same as executeBinaryOperation() would produce, but without allocating a new value.
+        Otherwise, returns false without modifying anything; call executeBinaryOperation() then.
+        \param op Operation (see BinaryOperation; appears typed as uint8_t in bytecode)
+        \param a  [in/out] First argument; receives result
+        \param b  [in] Second argument
+        \return true if operation was performed */
+    bool executeBinaryOperationInPlace(uint8_t op, afl::data::Value* a, const afl::data::Value* b);
+
     /** Execute a comparison operation.
         \param op Operation (see BinaryOperation; appears typed as uint8_t in bytecode)
         \param a,b User-supplied arguments taken from value stack
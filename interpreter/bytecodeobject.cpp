@@ -3,6 +3,7 @@
   *  \brief Class interpreter::BytecodeObject
   */
 
+#include <algorithm>
 #include <cassert>
 #include "interpreter/bytecodeobject.hpp"
 #include "afl/base/optional.hpp"
@@ -111,7 +112,8 @@ interpreter::BytecodeObject::BytecodeObject()
       m_subroutineName(),
       m_fileName(),
       m_origin(),
-      m_lineNumbers()
+      m_lineNumbers(),
+      m_lookupCache()
 {
     // ex IntBytecodeObject::IntBytecodeObject
 }
@@ -623,6 +625,22 @@ interpreter::BytecodeObject::getJumpTarget(uint8_t minor, uint16_t arg) const
     }
 }
 
+// Cache lookup result (inline cache).
+void
+interpreter::BytecodeObject::setCachedLookup(PC_t pc, uint16_t nameIndex, const Context::LookupKey& key, Context::PropertyIndex_t index)
+{
+    if (pc >= m_lookupCache.size()) {
+        LookupCacheEntry empty;
+        empty.index = 0;
+        empty.nameIndex = 0;
+        m_lookupCache.resize(std::max(pc+1, m_code.size()), empty);
+    }
+    LookupCacheEntry& e = m_lookupCache[pc];
+    e.key = key;
+    e.index = index;
+    e.nameIndex = nameIndex;
+}
+
 // Format instruction in human-readable way.
 String_t
 interpreter::BytecodeObject::getDisassembly(PC_t index, const World& w) const
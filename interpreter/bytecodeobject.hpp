@@ -12,6 +12,7 @@
 #include "afl/data/namemap.hpp"
 #include "afl/data/segment.hpp"
 #include "afl/data/value.hpp"
+#include "interpreter/context.hpp"
 #include "interpreter/opcode.hpp"
 
 namespace interpreter {
@@ -336,6 +337,23 @@ namespace interpreter {
             \param index Index [0,names().getNumNames()) */
         const String_t& getName(uint16_t index) const;
 
+        /** Get cached lookup result (inline cache).
+            Process uses this to avoid repeated name lookups for instructions referring to a name.
+            \param [in]  pc        Program counter of instruction
+            \param [in]  nameIndex Name referenced by the instruction (index into names())
+            \param [in]  key       Lookup key of context being searched (Context::getCacheableAccessor())
+            \param [out] index     Property index
+            \return true if a result for the given parameters has been cached, \c index has been set */
+        bool getCachedLookup(PC_t pc, uint16_t nameIndex, const Context::LookupKey& key, Context::PropertyIndex_t& index) const;
+
+        /** Cache lookup result (inline cache).
+            Each instruction caches one result; a previous one is replaced.
+            \param pc        Program counter of instruction
+            \param nameIndex Name referenced by the instruction (index into names())
+            \param key       Lookup key of context where the name was found (Context::getCacheableAccessor())
+            \param index     Property index */
+        void setCachedLookup(PC_t pc, uint16_t nameIndex, const Context::LookupKey& key, Context::PropertyIndex_t index);
+
         /** Access local variable names.
             \return names */
         const afl::data::NameMap& localVariables() const;
@@ -374,6 +392,16 @@ namespace interpreter {
         String_t              m_fileName;
         String_t              m_origin;
         std::vector<uint32_t> m_lineNumbers; ///< Line numbers. Pairs of address,line.
+
+        /* Inline cache, indexed by PC; allocated when first used.
+           An entry remains valid when code is moved around (relocate() etc.)
+           because it is validated against the name and context key. */
+        struct LookupCacheEntry {
+            Context::LookupKey key;
+            Context::PropertyIndex_t index;
+            uint16_t nameIndex;
+        };
+        std::vector<LookupCacheEntry> m_lookupCache;
     };
 
 
@@ -531,6 +559,20 @@ interpreter::BytecodeObject::getName(uint16_t index) const
     return m_names.getNameByIndex(index);
 }
 
+// Get cached lookup result (inline cache).
+inline bool
+interpreter::BytecodeObject::getCachedLookup(PC_t pc, uint16_t nameIndex, const Context::LookupKey& key, Context::PropertyIndex_t& index) const
+{
+    if (pc < m_lookupCache.size()) {
+        const LookupCacheEntry& e = m_lookupCache[pc];
+        if (e.key.type != 0 && e.nameIndex == nameIndex && e.key == key) {
+            index = e.index;
+            return true;
+        }
+    }
+    return false;
+}
+
 // Access local variable names.
 inline const afl::data::NameMap&
 interpreter::BytecodeObject::localVariables() const
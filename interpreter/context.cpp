@@ -11,3 +11,9 @@ interpreter::Context::ReadOnlyAccessor::set(PropertyIndex_t /*index*/, const afl
 {
     throw Error::notAssignable();
 }
+
+interpreter::Context::PropertyAccessor*
+interpreter::Context::getCacheableAccessor(LookupKey& /*key*/)
+{
+    return 0;
+}
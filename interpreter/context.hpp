@@ -43,6 +43,22 @@ namespace interpreter {
             virtual void set(PropertyIndex_t index, const afl::data::Value* value);
         };
 
+        /** Key for caching lookup() results.
+            \see getCacheableAccessor() */
+        struct LookupKey {
+            const void* type;           ///< Identifies the set of names. Null if lookups cannot be cached.
+            size_t generation;          ///< Changes whenever the set of names changes.
+
+            LookupKey()
+                : type(0), generation(0)
+                { }
+            LookupKey(const void* type, size_t generation)
+                : type(type), generation(generation)
+                { }
+            bool operator==(const LookupKey& other) const
+                { return type == other.type && generation == other.generation; }
+        };
+
 
         /** Look up a symbol by its name.
             \param name [in] Name query
@@ -53,6 +69,20 @@ namespace interpreter {
             This will cause g++-3.4 to miscompile this code (it fails to adjust null pointers). */
         virtual PropertyAccessor* lookup(const afl::data::NameQuery& name, PropertyIndex_t& result) = 0;
 
+        /** Get accessor for cached lookups.
+            Process remembers results of lookup() for instructions that are executed repeatedly (inline cache).
+            A context can allow this by returning a non-null key and accessor.
+            It thereby guarantees that
+            - every context returning the same key produces the same lookup() result (found/not found, same index) for a given name;
+            - lookup() returns the same accessor as this function.
+
+            For example, a context that looks up names in a static table can use the table address as key.
+            The default implementation returns null (lookups cannot be cached).
+
+            \param [out] key Key
+            \return Accessor; null if lookups cannot be cached */
+        virtual PropertyAccessor* getCacheableAccessor(LookupKey& key);
+
         /** Advance to next object.
             Return true on success, false on failure. */
         virtual bool next() = 0;
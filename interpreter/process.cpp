@@ -55,6 +55,25 @@ namespace {
         if ((minor & Opcode::miIMRefuseProcedures) != 0 && isProcedure)
             throw Error::typeError(Error::ExpectIndexable);
     }
+
+    /* Look up a name in a context, using the instruction's inline cache if possible. */
+    interpreter::Context::PropertyAccessor* lookupCached(interpreter::Context& ctx, interpreter::BytecodeObject& bco, interpreter::BytecodeObject::PC_t pc, uint16_t nameIndex, interpreter::Context::PropertyIndex_t& index)
+    {
+        interpreter::Context::LookupKey key;
+        interpreter::Context::PropertyAccessor* acc = ctx.getCacheableAccessor(key);
+        if (acc != 0 && key.type != 0) {
+            if (bco.getCachedLookup(pc, nameIndex, key, index)) {
+                return acc;
+            }
+            interpreter::Context::PropertyAccessor* result = ctx.lookup(bco.getName(nameIndex), index);
+            if (result != 0) {
+                bco.setCachedLookup(pc, nameIndex, key, index);
+            }
+            return result;
+        } else {
+            return ctx.lookup(bco.getName(nameIndex), index);
+        }
+    }
 }
 
 /***************************** Process::Frame ****************************/
@@ -737,7 +756,7 @@ interpreter::Process::executeInstruction()
          case Opcode::sNamedVariable:
          {
              Context::PropertyIndex_t index;
-             if (Context::PropertyAccessor* ctx = lookup(f.bco->getName(op.arg), index)) {
+             if (Context::PropertyAccessor* ctx = lookupNamedVariable(f, op.arg, index)) {
                  valueStack.pushBackNew(ctx->get(index));
              } else {
                  throw Error::unknownIdentifier(f.bco->getName(op.arg));
@@ -783,9 +802,13 @@ interpreter::Process::executeInstruction()
             checkStack(2);
             afl::data::Value* a = valueStack.top(1);
             afl::data::Value* b = valueStack.top(0);
-            afl::data::Value* result = executeBinaryOperation(m_world, op.minor, a, b);
-            valueStack.popBackN(2);
-            valueStack.pushBackNew(result);
+            if (executeBinaryOperationInPlace(op.minor, a, b)) {
+                valueStack.popBack();
+            } else {
+                afl::data::Value* result = executeBinaryOperation(m_world, op.minor, a, b);
+                valueStack.popBackN(2);
+                valueStack.pushBackNew(result);
+            }
         }
         break;
 
@@ -793,9 +816,11 @@ interpreter::Process::executeInstruction()
         /* Unary operations */
         {
             checkStack(1);
-            afl::data::Value* result = executeUnaryOperation(m_world, op.minor, valueStack.top(0));
-            valueStack.popBack();
-            valueStack.pushBackNew(result);
+            if (!executeUnaryOperationInPlace(op.minor, valueStack.top(0))) {
+                afl::data::Value* result = executeUnaryOperation(m_world, op.minor, valueStack.top(0));
+                valueStack.popBack();
+                valueStack.pushBackNew(result);
+            }
         }
         break;
 
@@ -957,7 +982,7 @@ interpreter::Process::executeInstruction()
          case Opcode::sNamedVariable:
          {
              Context::PropertyIndex_t index;
-             if (Context::PropertyAccessor* ctx = lookup(f.bco->getName(op.arg), index)) {
+             if (Context::PropertyAccessor* ctx = lookupNamedVariable(f, op.arg, index)) {
                  ctx->set(index, valueStack.top());
              } else {
                  throw Error::unknownIdentifier(f.bco->getName(op.arg));
@@ -995,7 +1020,7 @@ interpreter::Process::executeInstruction()
          case Opcode::sNamedVariable:
          {
              Context::PropertyIndex_t index;
-             if (Context::PropertyAccessor* ctx = lookup(f.bco->getName(op.arg), index)) {
+             if (Context::PropertyAccessor* ctx = lookupNamedVariable(f, op.arg, index)) {
                  ctx->set(index, valueStack.top());
                  valueStack.popBack();
              } else {
@@ -1041,7 +1066,7 @@ interpreter::Process::executeInstruction()
             } else if (Context* cv = dynamic_cast<Context*>(valueStack.top())) {
                 /* It's a context */
                 Context::PropertyIndex_t index;
-                if (Context::PropertyAccessor* foundContext = cv->lookup(f.bco->getName(op.arg), index)) {
+                if (Context::PropertyAccessor* foundContext = lookupCached(*cv, *f.bco, f.pc-1, op.arg, index)) {
                     /* Load permitted */
                     afl::data::Value* v = foundContext->get(index);
                     valueStack.popBack();
@@ -1067,7 +1092,7 @@ interpreter::Process::executeInstruction()
             if (Context* cv = dynamic_cast<Context*>(valueStack.top())) {
                 /* It's a context */
                 Context::PropertyIndex_t index;
-                if (Context::PropertyAccessor* foundContext = cv->lookup(f.bco->getName(op.arg), index)) {
+                if (Context::PropertyAccessor* foundContext = lookupCached(*cv, *f.bco, f.pc-1, op.arg, index)) {
                     /* Assignment permitted */
                     foundContext->set(index, valueStack.top(1));
                 } else {
@@ -1328,9 +1353,12 @@ interpreter::Process::executeInstruction()
             checkStack(1);
             afl::data::Value* a = valueStack.top(0);
             afl::data::Value* b = getReferencedValue(op);
-            afl::data::Value* result = executeBinaryOperation(m_world, (*f.bco)(f.pc).minor, a, b);
-            valueStack.popBack();
-            valueStack.pushBackNew(result);
+            const uint8_t binaryOp = (*f.bco)(f.pc).minor;
+            if (!executeBinaryOperationInPlace(binaryOp, a, b)) {
+                afl::data::Value* result = executeBinaryOperation(m_world, binaryOp, a, b);
+                valueStack.popBack();
+                valueStack.pushBackNew(result);
+            }
             ++f.pc;
         } else {
             handleInvalidOpcode();
@@ -1470,6 +1498,23 @@ interpreter::Process::lookup(const afl::data::NameQuery& q, Context::PropertyInd
     return 0;
 }
 
+/** Look up named variable for an instruction.
+    Same as lookup(), but uses the instruction's inline cache.
+    \param [in]  f          Frame executing the instruction; its pc points after the instruction
+    \param [in]  nameIndex  Name (index into f.bco->names())
+    \param [out] index      On success, property index
+    \return non-null PropertyAccessor if found, null on failure. */
+interpreter::Context::PropertyAccessor*
+interpreter::Process::lookupNamedVariable(Frame& f, uint16_t nameIndex, Context::PropertyIndex_t& index)
+{
+    for (size_t i = m_contexts.size(); i > 0; --i) {
+        if (Context::PropertyAccessor* fc = lookupCached(*m_contexts[i-1], *f.bco, f.pc-1, nameIndex, index)) {
+            return fc;
+        }
+    }
+    return 0;
+}
+
 bool
 interpreter::Process::setVariable(String_t name, afl::data::Value* value)
 {
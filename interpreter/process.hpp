@@ -503,6 +503,7 @@ namespace interpreter {
         void handleBind(uint16_t nargs);
         bool handleDecrement();
         afl::data::Value* getReferencedValue(const Opcode& op);
+        Context::PropertyAccessor* lookupNamedVariable(Frame& f, uint16_t nameIndex, Context::PropertyIndex_t& index);
 
         void logProcessState(const char* why);
 
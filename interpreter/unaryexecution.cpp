@@ -10,7 +10,9 @@
 #include "afl/base/countof.hpp"
 #include "afl/charset/utf8.hpp"
 #include "afl/charset/utf8reader.hpp"
+#include "afl/data/booleanvalue.hpp"
 #include "afl/data/floatvalue.hpp"
+#include "afl/data/integervalue.hpp"
 #include "afl/data/scalarvalue.hpp"
 #include "afl/data/stringvalue.hpp"
 #include "afl/data/visitor.hpp"
@@ -20,6 +22,7 @@
 #include "interpreter/error.hpp"
 #include "interpreter/filevalue.hpp"
 #include "interpreter/keymapvalue.hpp"
+#include "interpreter/unaryoperation.hpp"
 #include "interpreter/values.hpp"
 #include "interpreter/world.hpp"
 #include "util/math.hpp"
@@ -667,3 +670,30 @@ interpreter::executeUnaryOperation(World& world, uint8_t op, const afl::data::Va
         throw Error::internalError("invalid unary operation");
     }
 }
+
+// Execute unary operation in-place, if possible.
+bool
+interpreter::executeUnaryOperationInPlace(uint8_t op, afl::data::Value* arg)
+{
+    // These operations (FInc, FDec, FPos) preserve the type of integers and floats.
+    // Booleans produce an integer; leave those to executeUnaryOperation().
+    int32_t delta;
+    switch (op) {
+     case unInc: delta = +1; break;
+     case unDec: delta = -1; break;
+     case unPos: delta = 0;  break;
+     default:    return false;
+    }
+
+    if (dynamic_cast<const afl::data::BooleanValue*>(arg) != 0) {
+        return false;
+    } else if (afl::data::IntegerValue* iv = dynamic_cast<afl::data::IntegerValue*>(arg)) {
+        iv->add(delta);
+        return true;
+    } else if (afl::data::FloatValue* fv = dynamic_cast<afl::data::FloatValue*>(arg)) {
+        fv->add(delta);
+        return true;
+    } else {
+        return false;
+    }
+}
@@ -19,6 +19,16 @@ namespace interpreter {
         \return New value to push on value stack */
     afl::data::Value* executeUnaryOperation(World& world, uint8_t op, const afl::data::Value* arg);
 
+    /** Execute unary operation in-place, if possible.
+        This is a shortcut for simple arithmetic on a value owned by the caller (i.e. the value stack).
+        If the operation can be performed by modifying \c arg, does so and returns true;
+        the result is the same as executeUnaryOperation() would produce, but without allocating a new value.
+        Otherwise, returns false without modifying anything; call executeUnaryOperation() then.
+        \param op  Operation (see UnaryOperation; appears typed as uint8_t in bytecode)
+        \param arg [in/out] Argument; receives result
+        \return true if operation was performed */
+    bool executeUnaryOperationInPlace(uint8_t op, afl::data::Value* arg);
+
 }
 
 #endif
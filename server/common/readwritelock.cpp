@@ -0,0 +1,56 @@
+/**
+  *  \file server/common/readwritelock.cpp
+  *  \brief Class server::common::ReadWriteLock
+  */
+
+#include "server/common/readwritelock.hpp"
+#include "afl/sys/mutexguard.hpp"
+
+server::common::ReadWriteLock::ReadWriteLock()
+    : m_mutex(),
+      m_turnstile(1),
+      m_access(1),
+      m_numReaders(0)
+{ }
+
+server::common::ReadWriteLock::~ReadWriteLock()
+{ }
+
+void
+server::common::ReadWriteLock::lockShared()
+{
+    // Pass the turnstile; this blocks while a writer is waiting.
+    m_turnstile.wait();
+    m_turnstile.post();
+
+    // First reader locks out writers.
+    afl::sys::MutexGuard g(m_mutex);
+    if (m_numReaders++ == 0) {
+        m_access.wait();
+    }
+}
+
+void
+server::common::ReadWriteLock::unlockShared()
+{
+    // Last reader lets writers in.
+    afl::sys::MutexGuard g(m_mutex);
+    if (--m_numReaders == 0) {
+        m_access.post();
+    }
+}
+
+void
+server::common::ReadWriteLock::lockExclusive()
+{
+    // Hold the turnstile while waiting so that no new readers arrive.
+    m_turnstile.wait();
+    m_access.wait();
+    m_turnstile.post();
+}
+
+void
+server::common::ReadWriteLock::unlockExclusive()
+{
+    m_access.post();
+}
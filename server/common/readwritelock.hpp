@@ -0,0 +1,78 @@
+/**
+  *  \file server/common/readwritelock.hpp
+  *  \brief Class server::common::ReadWriteLock
+  */
+#ifndef C2NG_SERVER_COMMON_READWRITELOCK_HPP
+#define C2NG_SERVER_COMMON_READWRITELOCK_HPP
+
+#include "afl/base/uncopyable.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/semaphore.hpp"
+
+namespace server { namespace common {
+
+    /** Reader/writer lock.
+        Any number of threads can hold the lock shared (readers), or one thread can hold it exclusively (writer).
+
+        The lock is fair: a writer waiting for the lock blocks readers that arrive later,
+        so a steady stream of readers cannot starve a writer.
+
+        The lock is not recursive.
+        In particular, a thread holding the lock shared must not try to get it exclusively. */
+    class ReadWriteLock : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            Makes an unlocked lock. */
+        ReadWriteLock();
+
+        /** Destructor. */
+        ~ReadWriteLock();
+
+        /** Acquire lock shared.
+            Waits until no writer holds or waits for the lock. */
+        void lockShared();
+
+        /** Release shared lock. */
+        void unlockShared();
+
+        /** Acquire lock exclusively.
+            Waits until no other thread holds the lock. */
+        void lockExclusive();
+
+        /** Release exclusive lock. */
+        void unlockExclusive();
+
+        /** Guard for a shared lock (RAII). */
+        class ReadGuard : private afl::base::Uncopyable {
+         public:
+            explicit ReadGuard(ReadWriteLock& lock)
+                : m_lock(lock)
+                { m_lock.lockShared(); }
+            ~ReadGuard()
+                { m_lock.unlockShared(); }
+         private:
+            ReadWriteLock& m_lock;
+        };
+
+        /** Guard for an exclusive lock (RAII). */
+        class WriteGuard : private afl::base::Uncopyable {
+         public:
+            explicit WriteGuard(ReadWriteLock& lock)
+                : m_lock(lock)
+                { m_lock.lockExclusive(); }
+            ~WriteGuard()
+                { m_lock.unlockExclusive(); }
+         private:
+            ReadWriteLock& m_lock;
+        };
+
+     private:
+        afl::sys::Mutex m_mutex;            ///< Protects m_numReaders.
+        afl::sys::Semaphore m_turnstile;    ///< Passed by every thread entering; held by a waiting writer.
+        afl::sys::Semaphore m_access;       ///< Held by the writer or, collectively, by the readers.
+        int m_numReaders;                   ///< Number of readers holding the lock.
+    };
+
+} }
+
+#endif
@@ -0,0 +1,200 @@
+/**
+  *  \file server/common/threadpoolserver.cpp
+  *  \brief Class server::common::ThreadPoolServer
+  */
+
+#include <algorithm>
+#include <memory>
+#include "server/common/threadpoolserver.hpp"
+#include "afl/async/controller.hpp"
+#include "afl/async/receiveoperation.hpp"
+#include "afl/async/sendoperation.hpp"
+#include "afl/net/protocolhandler.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "afl/sys/time.hpp"
+
+namespace {
+    const char*const LOG_NAME = "net.pool";
+    const char*const THREAD_NAME = "net.pool";
+
+    /* Maximum time to block in accept() or receive() before checking for a stop request */
+    const afl::sys::Timeout_t POLL_INTERVAL = 500;
+
+    /* Maximum time to send a reply */
+    const afl::sys::Timeout_t SEND_TIMEOUT = 30000;
+}
+
+/*********************** ThreadPoolServer::Worker ************************/
+
+class server::common::ThreadPoolServer::Worker : private afl::base::Stoppable {
+ public:
+    Worker(ThreadPoolServer& parent)
+        : m_parent(parent),
+          m_thread(THREAD_NAME, *this)
+        { m_thread.start(); }
+
+    void join()
+        { m_thread.join(); }
+
+    virtual void run()
+        { m_parent.runWorker(); }
+
+    virtual void stop()
+        { m_parent.stop(); }
+
+ private:
+    ThreadPoolServer& m_parent;
+    afl::sys::Thread m_thread;
+};
+
+/*************************** ThreadPoolServer ****************************/
+
+server::common::ThreadPoolServer::ThreadPoolServer(afl::base::Ref<afl::net::Listener> listener, afl::net::ProtocolHandlerFactory& factory, size_t numThreads)
+    : m_listener(listener),
+      m_factory(factory),
+      m_numThreads(std::max(numThreads, size_t(1))),
+      m_log(),
+      m_wake(0),
+      m_mutex(),
+      m_stopRequest(false),
+      m_connections()
+{ }
+
+server::common::ThreadPoolServer::~ThreadPoolServer()
+{ }
+
+// Access logger.
+afl::sys::Log&
+server::common::ThreadPoolServer::log()
+{
+    return m_log;
+}
+
+void
+server::common::ThreadPoolServer::run()
+{
+    // Start workers
+    afl::container::PtrVector<Worker> workers;
+    for (size_t i = 0; i < m_numThreads; ++i) {
+        workers.pushBackNew(new Worker(*this));
+    }
+
+    // Accept connections
+    while (!isStopRequested()) {
+        try {
+            afl::base::Ptr<afl::net::Socket> socket = m_listener->accept(POLL_INTERVAL);
+            if (socket.get() != 0) {
+                addConnection(socket);
+            }
+        }
+        catch (std::exception& e) {
+            // Probably out of file descriptors; do not spin.
+            m_log.write(afl::sys::LogListener::Warn, LOG_NAME, "accept", e);
+            afl::sys::Thread::sleep(POLL_INTERVAL);
+        }
+    }
+
+    // Stop workers. stop() has already posted m_wake; it is passed on from worker to worker.
+    for (size_t i = 0, n = workers.size(); i < n; ++i) {
+        workers[i]->join();
+    }
+}
+
+void
+server::common::ThreadPoolServer::stop()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    if (!m_stopRequest) {
+        m_stopRequest = true;
+        m_wake.post();
+    }
+}
+
+bool
+server::common::ThreadPoolServer::isStopRequested()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    return m_stopRequest;
+}
+
+bool
+server::common::ThreadPoolServer::waitForConnection(afl::base::Ptr<afl::net::Socket>& result)
+{
+    // Wait for work. If this is a stop request, pass it on to the next worker.
+    m_wake.wait();
+    afl::sys::MutexGuard g(m_mutex);
+    if (m_stopRequest) {
+        m_wake.post();
+        return false;
+    } else {
+        result = m_connections.front();
+        m_connections.pop_front();
+        return true;
+    }
+}
+
+void
+server::common::ThreadPoolServer::addConnection(afl::base::Ptr<afl::net::Socket> socket)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    m_connections.push_back(socket);
+    m_wake.post();
+}
+
+void
+server::common::ThreadPoolServer::runWorker()
+{
+    afl::base::Ptr<afl::net::Socket> socket;
+    while (waitForConnection(socket)) {
+        try {
+            serveConnection(*socket);
+        }
+        catch (std::exception& e) {
+            m_log.write(afl::sys::LogListener::Warn, LOG_NAME, socket->getPeerName().toString(), e);
+        }
+        socket.reset();
+    }
+}
+
+void
+server::common::ThreadPoolServer::serveConnection(afl::net::Socket& socket)
+{
+    std::auto_ptr<afl::net::ProtocolHandler> handler(m_factory.create());
+    afl::async::Controller ctl;
+    uint8_t buffer[4096];
+    while (1) {
+        // Send everything the protocol handler wants to send
+        afl::net::ProtocolHandler::Operation op;
+        handler->getOperation(op);
+        if (!op.m_dataToSend.empty()) {
+            afl::base::ConstBytes_t data = op.m_dataToSend;
+            while (!data.empty()) {
+                afl::async::SendOperation sendOp(data);
+                if (!socket.send(ctl, sendOp, SEND_TIMEOUT)) {
+                    handler->handleSendTimeout(data);
+                    return;
+                }
+                data.split(sendOp.getNumSentBytes());
+            }
+            continue;
+        }
+        if (op.m_close || isStopRequested()) {
+            return;
+        }
+
+        // Wait for more data
+        afl::async::ReceiveOperation recvOp(buffer);
+        const uint32_t startTime = afl::sys::Time::getTickCounter();
+        if (socket.receive(ctl, recvOp, std::min(op.m_timeToWait, POLL_INTERVAL))) {
+            if (recvOp.getReceivedBytes().empty()) {
+                handler->handleConnectionClose();
+                return;
+            }
+            handler->handleData(recvOp.getReceivedBytes());
+        } else {
+            handler->advanceTime(afl::sys::Time::getTickCounter() - startTime);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/**
+  *  \file server/common/threadpoolserver.hpp
+  *  \brief Class server::common::ThreadPoolServer
+  */
+#ifndef C2NG_SERVER_COMMON_THREADPOOLSERVER_HPP
+#define C2NG_SERVER_COMMON_THREADPOOLSERVER_HPP
+
+#include <list>
+#include "afl/base/ptr.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/net/listener.hpp"
+#include "afl/net/protocolhandlerfactory.hpp"
+#include "afl/net/socket.hpp"
+#include "afl/sys/log.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/semaphore.hpp"
+
+namespace server { namespace common {
+
+    /** Network server with a pool of worker threads.
+        This is an alternative to afl::net::Server for services whose commands can run in parallel.
+
+        afl::net::Server serves all connections from a single thread,
+        so a slow command delays the commands of all other connections.
+        ThreadPoolServer accepts connections in its own thread (run()),
+        and hands each connection to one of a fixed number of worker threads.
+        A worker serves its connection until the connection is closed,
+        using blocking I/O and a ProtocolHandler created by the given factory.
+
+        The number of worker threads therefore is the maximum number of connections served in parallel.
+        Connections beyond that number are accepted but wait until a worker becomes free.
+
+        ProtocolHandlers are called from worker threads.
+        The objects they share (service root etc.) must therefore be thread-safe. */
+    class ThreadPoolServer : public afl::base::Stoppable,
+                             private afl::base::Uncopyable
+    {
+     public:
+        /** Constructor.
+            \param listener   Listener to accept connections from
+            \param factory    ProtocolHandlerFactory. Must live longer than the ThreadPoolServer.
+            \param numThreads Number of worker threads (at least 1) */
+        ThreadPoolServer(afl::base::Ref<afl::net::Listener> listener, afl::net::ProtocolHandlerFactory& factory, size_t numThreads);
+
+        /** Destructor. */
+        ~ThreadPoolServer();
+
+        /** Access logger.
+            Attach a listener to receive log messages.
+            \return logger */
+        afl::sys::Log& log();
+
+        // Stoppable:
+        virtual void run();
+        virtual void stop();
+
+     private:
+        class Worker;
+
+        afl::base::Ref<afl::net::Listener> m_listener;
+        afl::net::ProtocolHandlerFactory& m_factory;
+        const size_t m_numThreads;
+        afl::sys::Log m_log;
+
+        afl::sys::Semaphore m_wake;                                 ///< Wake a worker. Posted for each connection added to m_connections, or for stop request.
+        afl::sys::Mutex m_mutex;                                    ///< Mutex protecting the following variables.
+        bool m_stopRequest;                                         ///< Set to true to stop the acceptor and the workers.
+        std::list<afl::base::Ptr<afl::net::Socket> > m_connections; ///< Accepted connections waiting for a worker.
+
+        bool isStopRequested();
+        bool waitForConnection(afl::base::Ptr<afl::net::Socket>& result);
+        void addConnection(afl::base::Ptr<afl::net::Socket> socket);
+
+        void runWorker();
+        void serveConnection(afl::net::Socket& socket);
+    };
+
+} }
+
+#endif
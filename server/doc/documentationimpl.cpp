@@ -3,6 +3,7 @@
   *  \brief Class server::doc::DocumentationImpl
   */
 
+#include <algorithm>
 #include <stdexcept>
 #include "server/doc/documentationimpl.hpp"
 #include "afl/base/staticassert.hpp"
@@ -31,6 +32,86 @@ using util::doc::Index;
 
 namespace {
     const int DEFAULT_MAX_DEPTH = 2;
+    const int32_t DEFAULT_MAX_RESULTS = 20;
+    const int32_t MAX_MAX_RESULTS = 1000;
+
+    // Convert render options.
+    // @param opts   Options given by user
+    // @param docId  Document Id containing the node
+    // @return options for renderHTML
+    util::doc::RenderOptions convertRenderOptions(const Documentation::RenderOptions& opts, const String_t& docId)
+    {
+        util::doc::RenderOptions result;
+        if (const String_t* p = opts.siteRoot.get()) {
+            result.setSiteRoot(*p);
+        }
+        if (const String_t* p = opts.assetRoot.get()) {
+            result.setAssetRoot(*p);
+        }
+        if (const String_t* p = opts.docRoot.get()) {
+            result.setDocumentRoot(*p);
+        }
+        if (const String_t* p = opts.docSuffix.get()) {
+            result.setDocumentLinkSuffix(*p);
+        }
+        result.setDocumentId(docId);
+        return result;
+    }
+
+    // Render content blob.
+    // @param blobStore BlobStore
+    // @param objId     Object Id of page source (XML)
+    // @param opts      Render options
+    // @return rendered page
+    String_t renderContent(const BlobStore& blobStore, const BlobStore::ObjectId_t& objId, const util::doc::RenderOptions& opts)
+    {
+        // Parse XML
+        Ref<FileMapping> content = blobStore.getObject(objId);
+        ConstMemoryStream ms(content->get());
+        CharsetFactory csFactory;
+        DefaultEntityHandler eh;
+        Nodes_t nodes;
+        Reader rdr(ms, eh, csFactory);
+        rdr.setWhitespaceMode(Reader::AllWS);
+        Parser(rdr).parseNodes(nodes);
+
+        // Render
+        return renderHTML(nodes, opts);
+    }
+
+    // Pre-render a node and its children into the render cache.
+    // @param [in]     root   Service root
+    // @param [in]     node   Node
+    // @param [in]     opts   Options given by user
+    // @param [in,out] count  Counter for rendered nodes
+    void prerenderTree(Root& root, Index::Handle_t node, const Documentation::RenderOptions& opts, int32_t& count)
+    {
+        const Index& index = root.index();
+        const BlobStore::ObjectId_t objId = index.getNodeContentId(node);
+        const String_t address = index.getNodeAddress(node, String_t());
+        if (!objId.empty() && !address.empty()) {
+            // Look up node the same way renderNode() does, to obtain the same document Id
+            Index::Handle_t hdl;
+            String_t docId;
+            if (index.findNodeByAddress(address, hdl, docId)) {
+                util::doc::RenderOptions opts2 = convertRenderOptions(opts, docId);
+                String_t key = server::doc::RenderCache::makeKey(objId, opts2);
+                if (!root.renderCache().contains(key)) {
+                    // A page that fails to render is skipped here; renderNode() will report the error when it is requested.
+                    try {
+                        root.renderCache().put(key, renderContent(root.blobStore(), objId, opts2));
+                        ++count;
+                    }
+                    catch (std::exception&) {
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0, n = index.getNumNodeChildren(node); i < n; ++i) {
+            prerenderTree(root, index.getNodeChildByIndex(node, i), opts, count);
+        }
+    }
 
     // Shortcut for looking up a node.
     // Throws exception on error.
@@ -103,7 +184,7 @@ namespace {
 
 
 
-server::doc::DocumentationImpl::DocumentationImpl(const Root& root)
+server::doc::DocumentationImpl::DocumentationImpl(Root& root)
     : m_root(root)
 { }
 
@@ -134,41 +215,44 @@ server::doc::DocumentationImpl::renderNode(String_t nodeId, const RenderOptions&
     Index::Handle_t node = findNode(m_root, nodeId, docId);
 
     // Build options
-    util::doc::RenderOptions opts2;
-    if (const String_t* p = opts.siteRoot.get()) {
-        opts2.setSiteRoot(*p);
-    }
-    if (const String_t* p = opts.assetRoot.get()) {
-        opts2.setAssetRoot(*p);
-    }
-    if (const String_t* p = opts.docRoot.get()) {
-        opts2.setDocumentRoot(*p);
-    }
-    if (const String_t* p = opts.docSuffix.get()) {
-        opts2.setDocumentLinkSuffix(*p);
-    }
-    opts2.setDocumentId(docId);
+    util::doc::RenderOptions opts2 = convertRenderOptions(opts, docId);
 
     // Retrieve document
     BlobStore::ObjectId_t objId = m_root.index().getNodeContentId(node);
     if (!objId.empty()) {
-        // Parse XML
-        Ref<FileMapping> content = m_root.blobStore().getObject(objId);
-        ConstMemoryStream ms(content->get());
-        CharsetFactory csFactory;
-        DefaultEntityHandler eh;
-        Nodes_t nodes;
-        Reader rdr(ms, eh, csFactory);
-        rdr.setWhitespaceMode(Reader::AllWS);
-        Parser(rdr).parseNodes(nodes);
-
-        // Render
-        return renderHTML(nodes, opts2);
+        // Content is immutable for a content Id, so we can use a cached copy
+        String_t key = RenderCache::makeKey(objId, opts2);
+        String_t result;
+        if (!m_root.renderCache().get(key, result)) {
+            result = renderContent(m_root.blobStore(), objId, opts2);
+            m_root.renderCache().put(key, result);
+        }
+        return result;
     } else {
         return String_t();
     }
 }
 
+int32_t
+server::doc::DocumentationImpl::prerenderNodes(const RenderOptions& opts)
+{
+    int32_t count = 0;
+    prerenderTree(m_root, m_root.index().root(), opts, count);
+    return count;
+}
+
+Documentation::CacheStatus
+server::doc::DocumentationImpl::getCacheStatus()
+{
+    const RenderCache& cache = m_root.renderCache();
+    CacheStatus result;
+    result.numEntries = static_cast<int32_t>(cache.getNumEntries());
+    result.totalSize  = static_cast<int32_t>(cache.getTotalSize());
+    result.numHits    = static_cast<int32_t>(cache.getNumHits());
+    result.numMisses  = static_cast<int32_t>(cache.getNumMisses());
+    return result;
+}
+
 Documentation::NodeInfo
 server::doc::DocumentationImpl::getNodeInfo(String_t nodeId)
 {
@@ -258,3 +342,41 @@ server::doc::DocumentationImpl::getNodeRelatedVersions(String_t nodeId)
     }
     return result;
 }
+
+std::vector<Documentation::SearchResult>
+server::doc::DocumentationImpl::search(String_t query, const SearchOptions& opts)
+{
+    const Index& index = m_root.index();
+
+    // Resolve document restriction. The search index uses canonical addresses.
+    String_t prefix;
+    String_t docId;
+    if (const String_t* p = opts.docId.get()) {
+        String_t userDocId;
+        Index::Handle_t node = findNode(m_root, *p, userDocId);
+        if (node != index.root()) {
+            prefix = index.getNodeAddress(node, String_t());
+            docId = userDocId;
+        }
+    }
+
+    // Search
+    const int32_t maxResults = std::max(0, std::min(opts.maxResults.orElse(DEFAULT_MAX_RESULTS), MAX_MAX_RESULTS));
+    std::vector<util::doc::SearchIndex::Result> found = m_root.searchIndex().search(query, prefix, size_t(maxResults));
+
+    // Build result, using the user's document name
+    std::vector<SearchResult> result;
+    for (size_t i = 0, n = found.size(); i < n; ++i) {
+        Index::Handle_t hdl;
+        String_t foundDocId;
+        if (index.findNodeByAddress(found[i].address, hdl, foundDocId)) {
+            SearchResult r;
+            r.nodeId = index.getNodeAddress(hdl, docId);
+            r.title = index.getNodeTitle(hdl);
+            r.snippet = found[i].snippet;
+            r.score = found[i].score;
+            result.push_back(r);
+        }
+    }
+    return result;
+}
@@ -16,20 +16,23 @@ namespace server { namespace doc {
      public:
         /** Constructor.
             @param root Service root. Must live longer than the DocumentationImpl. */
-        explicit DocumentationImpl(const Root& root);
+        explicit DocumentationImpl(Root& root);
         ~DocumentationImpl();
 
         // Interface methods:
         String_t getBlob(String_t blobId);
         String_t renderNode(String_t nodeId, const RenderOptions& opts);
+        int32_t prerenderNodes(const RenderOptions& opts);
+        CacheStatus getCacheStatus();
         NodeInfo getNodeInfo(String_t nodeId);
         std::vector<NodeInfo> getNodeChildren(String_t nodeId, const ChildOptions& opts);
         std::vector<NodeInfo> getNodeParents(String_t nodeId);
         std::vector<NodeInfo> getNodeNavigationContext(String_t nodeId);
         std::vector<NodeInfo> getNodeRelatedVersions(String_t nodeId);
+        std::vector<SearchResult> search(String_t query, const SearchOptions& opts);
 
      private:
-        const Root& m_root;
+        Root& m_root;
     };
 
 } }
@@ -0,0 +1,155 @@
+/**
+  *  \file server/doc/rendercache.cpp
+  *  \brief Class server::doc::RenderCache
+  */
+
+#include "server/doc/rendercache.hpp"
+#include "util/doc/renderoptions.hpp"
+
+namespace {
+    size_t getEntrySize(const String_t& key, const String_t& value)
+    {
+        return key.size() + value.size();
+    }
+}
+
+const size_t server::doc::RenderCache::DEFAULT_LIMIT;
+
+// Constructor.
+server::doc::RenderCache::RenderCache(size_t limit)
+    : m_entries(),
+      m_map(),
+      m_limit(limit),
+      m_totalSize(0),
+      m_numHits(0),
+      m_numMisses(0)
+{ }
+
+// Destructor.
+server::doc::RenderCache::~RenderCache()
+{ }
+
+// Make cache key.
+String_t
+server::doc::RenderCache::makeKey(const String_t& contentId, const util::doc::RenderOptions& opts)
+{
+    // Use '\0' as separator; it cannot appear in any of the components
+    String_t result = contentId;
+    result += '\0';
+    result += opts.getDocumentId();
+    result += '\0';
+    result += opts.getSiteRoot();
+    result += '\0';
+    result += opts.getAssetRoot();
+    result += '\0';
+    result += opts.getDocumentRoot();
+    result += '\0';
+    result += opts.getDocumentLinkSuffix();
+    return result;
+}
+
+// Look up a rendered page.
+bool
+server::doc::RenderCache::get(const String_t& key, String_t& result)
+{
+    Map_t::iterator it = m_map.find(key);
+    if (it != m_map.end()) {
+        // Move to front
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        result = it->second->value;
+        ++m_numHits;
+        return true;
+    } else {
+        ++m_numMisses;
+        return false;
+    }
+}
+
+// Store a rendered page.
+void
+server::doc::RenderCache::put(const String_t& key, const String_t& value)
+{
+    Map_t::iterator it = m_map.find(key);
+    if (it != m_map.end()) {
+        remove(it);
+    }
+
+    size_t size = getEntrySize(key, value);
+    if (size <= m_limit) {
+        m_entries.push_front(Entry(key, value));
+        m_map.insert(std::make_pair(key, m_entries.begin()));
+        m_totalSize += size;
+        trim();
+    }
+}
+
+// Check for presence of a page.
+bool
+server::doc::RenderCache::contains(const String_t& key) const
+{
+    return m_map.find(key) != m_map.end();
+}
+
+// Set size limit.
+void
+server::doc::RenderCache::setLimit(size_t limit)
+{
+    m_limit = limit;
+    trim();
+}
+
+// Remove all entries.
+void
+server::doc::RenderCache::clear()
+{
+    m_entries.clear();
+    m_map.clear();
+    m_totalSize = 0;
+}
+
+// Get number of entries.
+size_t
+server::doc::RenderCache::getNumEntries() const
+{
+    return m_map.size();
+}
+
+// Get total size of entries.
+size_t
+server::doc::RenderCache::getTotalSize() const
+{
+    return m_totalSize;
+}
+
+// Get number of successful get() calls.
+size_t
+server::doc::RenderCache::getNumHits() const
+{
+    return m_numHits;
+}
+
+// Get number of unsuccessful get() calls.
+size_t
+server::doc::RenderCache::getNumMisses() const
+{
+    return m_numMisses;
+}
+
+/** Remove an entry.
+    @param it Entry */
+void
+server::doc::RenderCache::remove(Map_t::iterator it)
+{
+    m_totalSize -= getEntrySize(it->second->key, it->second->value);
+    m_entries.erase(it->second);
+    m_map.erase(it);
+}
+
+/** Drop least-recently-used entries until the cache is within its limit. */
+void
+server::doc::RenderCache::trim()
+{
+    while (m_totalSize > m_limit && !m_entries.empty()) {
+        remove(m_map.find(m_entries.back().key));
+    }
+}
@@ -0,0 +1,116 @@
+/**
+  *  \file server/doc/rendercache.hpp
+  *  \brief Class server::doc::RenderCache
+  */
+#ifndef C2NG_SERVER_DOC_RENDERCACHE_HPP
+#define C2NG_SERVER_DOC_RENDERCACHE_HPP
+
+#include <list>
+#include <map>
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/string/string.hpp"
+
+namespace util { namespace doc { class RenderOptions; } }
+
+namespace server { namespace doc {
+
+    /** Cache for rendered pages.
+        Page content is immutable for a given content Id,
+        so a rendered page can be reused whenever the same content is rendered with the same options.
+
+        The cache is bounded by the total size of stored keys and values;
+        if it exceeds the limit, least-recently-used entries are dropped.
+
+        This class is not thread-safe; c2doc-server processes all requests in one thread. */
+    class RenderCache : private afl::base::Uncopyable {
+     public:
+        /** Default size limit in bytes. */
+        static const size_t DEFAULT_LIMIT = 16*1024*1024;
+
+        /** Constructor.
+            @param limit Size limit in bytes */
+        explicit RenderCache(size_t limit = DEFAULT_LIMIT);
+
+        /** Destructor. */
+        ~RenderCache();
+
+        /** Make cache key.
+            @param contentId Content Id (blob Id of page source)
+            @param opts      Render options, including the document Id
+            @return key */
+        static String_t makeKey(const String_t& contentId, const util::doc::RenderOptions& opts);
+
+        /** Look up a rendered page.
+            Counts a hit or miss, and marks the entry as most-recently-used.
+            @param [in]  key     Key (see makeKey())
+            @param [out] result  Rendered page
+            @return true if found */
+        bool get(const String_t& key, String_t& result);
+
+        /** Store a rendered page.
+            Replaces a possible previous entry with the same key, and drops old entries as needed to stay within the limit.
+            A page too large for the cache is not stored.
+            @param key   Key (see makeKey())
+            @param value Rendered page */
+        void put(const String_t& key, const String_t& value);
+
+        /** Check for presence of a page, without affecting statistics or LRU order.
+            @param key Key (see makeKey())
+            @return true if present */
+        bool contains(const String_t& key) const;
+
+        /** Set size limit.
+            Drops old entries as needed.
+            @param limit Size limit in bytes */
+        void setLimit(size_t limit);
+
+        /** Remove all entries.
+            Statistics are not reset. */
+        void clear();
+
+        /** Get number of entries.
+            @return number of entries */
+        size_t getNumEntries() const;
+
+        /** Get total size of entries.
+            @return size in bytes */
+        size_t getTotalSize() const;
+
+        /** Get number of successful get() calls.
+            @return count */
+        size_t getNumHits() const;
+
+        /** Get number of unsuccessful get() calls.
+            @return count */
+        size_t getNumMisses() const;
+
+     private:
+        struct Entry {
+            String_t key;
+            String_t value;
+            Entry(const String_t& key, const String_t& value)
+                : key(key), value(value)
+                { }
+        };
+        typedef std::list<Entry> List_t;
+        typedef std::map<String_t, List_t::iterator> Map_t;
+
+        /** Entries, most-recently-used first. */
+        List_t m_entries;
+
+        /** Lookup by key. */
+        Map_t m_map;
+
+        size_t m_limit;
+        size_t m_totalSize;
+        size_t m_numHits;
+        size_t m_numMisses;
+
+        void remove(Map_t::iterator it);
+        void trim();
+    };
+
+} }
+
+#endif
@@ -5,22 +5,28 @@
 #ifndef C2NG_SERVER_DOC_ROOT_HPP
 #define C2NG_SERVER_DOC_ROOT_HPP
 
+#include "server/doc/rendercache.hpp"
 #include "util/doc/blobstore.hpp"
 #include "util/doc/index.hpp"
+#include "util/doc/searchindex.hpp"
 
 namespace server { namespace doc {
 
     /** Documentation server global state.
         Global state includes:
         - a BlobStore
-        - an Index */
+        - an Index
+        - a SearchIndex
+        - a RenderCache */
     class Root {
      public:
         /** Constructor.
             @param blobStore BlobStore to serve */
         explicit Root(util::doc::BlobStore& blobStore)
             : m_blobStore(blobStore),
-              m_index()
+              m_index(),
+              m_searchIndex(),
+              m_renderCache()
             { }
 
         /** Access index.
@@ -33,14 +39,31 @@ namespace server { namespace doc {
         const util::doc::Index& index() const
             { return m_index; }
 
+        /** Access search index.
+            @return search index */
+        util::doc::SearchIndex& searchIndex()
+            { return m_searchIndex; }
+
+        /** Access search index (const version).
+            @return search index */
+        const util::doc::SearchIndex& searchIndex() const
+            { return m_searchIndex; }
+
         /** Access BlobStore.
             @return BlobStore */
         const util::doc::BlobStore& blobStore() const
             { return m_blobStore; }
 
+        /** Access render cache.
+            @return RenderCache */
+        RenderCache& renderCache()
+            { return m_renderCache; }
+
      private:
         util::doc::BlobStore& m_blobStore;
         util::doc::Index m_index;
+        util::doc::SearchIndex m_searchIndex;
+        RenderCache m_renderCache;
     };
 
 } }
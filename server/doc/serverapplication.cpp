@@ -5,11 +5,13 @@
 
 #include "server/doc/serverapplication.hpp"
 #include "afl/async/controller.hpp"
+#include "afl/except/commandlineexception.hpp"
 #include "afl/net/protocolhandler.hpp"
 #include "afl/net/protocolhandlerfactory.hpp"
 #include "afl/net/resp/protocolhandler.hpp"
 #include "afl/net/server.hpp"
 #include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
 #include "afl/sys/thread.hpp"
 #include "server/doc/documentationimpl.hpp"
 #include "server/doc/root.hpp"
@@ -52,6 +54,7 @@ server::doc::ServerApplication::ServerApplication(afl::sys::Environment& env, af
     : Application(LOG_NAME, env, fs, net),
       m_listenAddress(DEFAULT_ADDRESS, DOC_PORT),
       m_directoryName(),
+      m_renderCacheSize(RenderCache::DEFAULT_LIMIT),
       m_interrupt(intr)
 { }
 
@@ -86,6 +89,16 @@ server::doc::ServerApplication::serverMain()
     // Set up root (global data)
     Root root(*blobStore);
     root.index().load(*dir->openFile("index.xml", FileSystem::OpenRead));
+    root.renderCache().setLimit(m_renderCacheSize);
+
+    // Search index is optional; without it, searches find nothing
+    Ptr<Stream> searchFile = dir->openFileNT("search.idx", FileSystem::OpenRead);
+    if (searchFile.get() != 0) {
+        root.searchIndex().load(*searchFile);
+        log().write(LogListener::Info, LOG_NAME, Format("Search index contains %d pages, %d words.", root.searchIndex().getNumNodes(), root.searchIndex().getNumTerms()));
+    } else {
+        log().write(LogListener::Warn, LOG_NAME, "No search index found, search is disabled.");
+    }
 
     // Command handler
     DocumentationImpl impl(root);
@@ -129,9 +142,24 @@ server::doc::ServerApplication::handleConfiguration(const String_t& key, const S
         /* @q Doc.Dir:Str (Config)
            Directory name of documentation repository.
            Directory must contain a "index.xml" file and a "content/" directory or a "content.tar" file.
+           It should contain a "search.idx" file (created by c2docmanager) to enable searching.
            @since PCC2 2.40.12 */
         m_directoryName = value;
         return true;
+    } else if (key == "DOC.CACHESIZE") {
+        /* @q Doc.CacheSize:Int (Config)
+           Size of render cache, in bytes.
+           Rendered pages are kept in memory up to this size.
+           0 disables the cache.
+           Default is 16 MB.
+           @since PCC2 2.41 */
+        size_t n;
+        if (afl::string::strToInteger(value, n)) {
+            m_renderCacheSize = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else {
         return false;
     }
@@ -40,6 +40,8 @@ namespace server { namespace doc {
 
         String_t m_directoryName;
 
+        size_t m_renderCacheSize;
+
         afl::async::Interrupt& m_interrupt;
     };
 
@@ -23,6 +23,7 @@ server::file::ca::GarbageCollector::GarbageCollector(ObjectStore& objStore, afl:
       m_objectsToKeep(),
       m_treesToCheck(),
       m_nextPrefixToCheck(0),
+      m_nextPackToCheck(0),
       m_numObjectsRemoved(0),
       m_numErrors(0)
 { }
@@ -98,6 +99,7 @@ server::file::ca::GarbageCollector::checkObject()
         }
 
         m_nextPrefixToCheck = 0;
+        m_nextPackToCheck = 0;
         return true;
     } else {
         return false;
@@ -171,6 +173,21 @@ server::file::ca::GarbageCollector::removeGarbageObjects()
         }
 
         ++m_nextPrefixToCheck;
+        if (m_nextPrefixToCheck == 256) {
+            // Loose objects done; continue with packs.
+            // Process them backwards because removeGarbageFromPack() does not affect lower indexes.
+            m_nextPackToCheck = m_objectStore.getNumPacks();
+        }
+        return true;
+    } else if (m_nextPackToCheck > 0) {
+        // Check one pack
+        --m_nextPackToCheck;
+        try {
+            m_numObjectsRemoved += m_objectStore.removeGarbageFromPack(m_nextPackToCheck, m_objectsToKeep);
+        }
+        catch (std::exception& e) {
+            m_log.write(LogListener::Warn, LOG_NAME, Format("pack #%d: error cleaning up", m_nextPackToCheck), e);
+        }
         return true;
     } else {
         // Completed
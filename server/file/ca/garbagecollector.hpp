@@ -22,6 +22,7 @@ namespace server { namespace file { namespace ca {
         objects that were created in a previous lifecycle will not be deleted in a future lifecycle.
         The garbage collector is intended to clean this up.
         (An alternative could have been to rebuild the reference counters.)
+        Likewise, objects in pack files are never deleted individually; the garbage collector rewrites packs that contain garbage.
 
         This class focuses on cleaning up, not on detecting and fixing inconsistencies.
         However, some warnings are generated.
@@ -73,6 +74,7 @@ namespace server { namespace file { namespace ca {
 
         /** Main sequence: remove garbage objects.
             If there are still objects to remove, pick some and remove them.
+            This first processes loose objects, then rewrites pack files that contain garbage.
             @retval true  Made some progress
             @retval false No more objects to remove */
         bool removeGarbageObjects();
@@ -108,6 +110,7 @@ namespace server { namespace file { namespace ca {
         IdSet_t m_treesToCheck;
 
         size_t m_nextPrefixToCheck;
+        size_t m_nextPackToCheck;
         size_t m_numObjectsRemoved;
         size_t m_numErrors;
     };
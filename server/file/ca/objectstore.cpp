@@ -2,6 +2,8 @@
   *  \file server/file/ca/objectstore.cpp
   */
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include "server/file/ca/objectstore.hpp"
 #include "afl/checksums/sha1.hpp"
@@ -18,6 +20,8 @@
 #include "server/file/ca/referencecounter.hpp"
 #include "server/file/ca/objectcache.hpp"
 #include "server/file/ca/internalobjectcache.hpp"
+#include "server/file/ca/packbuilder.hpp"
+#include "server/file/ca/packfile.hpp"
 
 namespace {
     const char*const BAD_HASH = "500 Bad hash";
@@ -31,6 +35,16 @@ namespace {
 
     const char KEYWORDS[][8] = { "blob ", "tree ", "commit " };
 
+    /* Name of pack directory (same as git) */
+    const char*const PACK_DIRECTORY = "pack";
+
+    /* Maximum size of a pack file created by repack().
+       Packs are assembled in memory, and loaded as a whole when accessed. */
+    const size_t PACK_SIZE_LIMIT = 16*1024*1024;
+
+    /* Maximum number of packs to keep loaded. */
+    const size_t MAX_LOADED_PACKS = 4;
+
     int hexValue(char c)
     {
         if (c >= '0' && c <= '9') {
@@ -82,6 +96,38 @@ namespace {
         return result;
     }
 
+    size_t verifyAnyHeader(afl::base::Bytes_t& data, server::file::ca::ObjectStore::Type& type)
+    {
+        for (size_t i = 0; i < sizeof(KEYWORDS)/sizeof(KEYWORDS[0]); ++i) {
+            const size_t len = std::strlen(KEYWORDS[i]);
+            if (data.size() >= len && std::memcmp(data.unsafeData(), KEYWORDS[i], len) == 0) {
+                type = server::file::ca::ObjectStore::Type(i);
+                return verifyHeader(data, KEYWORDS[i]);
+            }
+        }
+        throw std::runtime_error(BAD_OBJECT_TYPE);
+    }
+
+    void inflateRemainder(afl::io::InflateTransform& tx, afl::base::ConstBytes_t& compressedContent, afl::base::GrowableBytes_t& mem)
+    {
+        uint8_t uncompressedBuffer[4096];
+        while (!compressedContent.empty()) {
+            afl::base::Bytes_t uncompressedContent(uncompressedBuffer);
+            tx.transform(compressedContent, uncompressedContent);
+            mem.append(uncompressedContent);
+        }
+
+        tx.flush();
+        while (1) {
+            afl::base::Bytes_t uncompressedContent(uncompressedBuffer);
+            tx.transform(compressedContent, uncompressedContent);
+            mem.append(uncompressedContent);
+            if (compressedContent.empty()) {
+                break;
+            }
+        }
+    }
+
     void transformAdd(afl::base::GrowableMemory<uint8_t>& out, afl::io::Transform& tx, afl::base::ConstBytes_t in)
     {
         while (!in.empty()) {
@@ -114,7 +160,12 @@ server::file::ca::ObjectStore::ObjectStore(DirectoryHandler& dir)
     : m_directory(dir),
       m_subdirectories(),
       m_refCounter(new InternalReferenceCounter()),
-      m_cache(new InternalObjectCache())
+      m_cache(new InternalObjectCache()),
+      m_packDirectory(),
+      m_packs(),
+      m_loadedPacks(),
+      m_deferredWrite(false),
+      m_pendingObjects()
 {
     readDirectory();
 }
@@ -123,6 +174,52 @@ server::file::ca::ObjectStore::ObjectStore(DirectoryHandler& dir)
 server::file::ca::ObjectStore::~ObjectStore()
 { }
 
+// Set reference counter.
+void
+server::file::ca::ObjectStore::setReferenceCounter(std::auto_ptr<ReferenceCounter> p)
+{
+    m_refCounter = p;
+}
+
+// Set object cache.
+void
+server::file::ca::ObjectStore::setObjectCache(std::auto_ptr<ObjectCache> p)
+{
+    m_cache = p;
+}
+
+// Set deferred write mode.
+void
+server::file::ca::ObjectStore::setDeferredWrite(bool enable)
+{
+    m_deferredWrite = enable;
+    if (!enable) {
+        flush();
+    }
+}
+
+// Write pending objects.
+size_t
+server::file::ca::ObjectStore::flush()
+{
+    size_t n = 0;
+    while (!m_pendingObjects.empty()) {
+        // Remove from map only after successful write, so an error leaves the object pending
+        PendingMap_t::iterator it = m_pendingObjects.begin();
+        writeLooseObject(it->first, it->second.type, it->second.content->get());
+        m_pendingObjects.erase(it);
+        ++n;
+    }
+    return n;
+}
+
+// Get number of pending objects.
+size_t
+server::file::ca::ObjectStore::getNumPendingObjects() const
+{
+    return m_pendingObjects.size();
+}
+
 // Get object content.
 afl::base::Ref<afl::io::FileMapping>
 server::file::ca::ObjectStore::getObject(const ObjectId& id, Type expectedType)
@@ -173,14 +270,7 @@ server::file::ca::ObjectStore::addObject(Type type, afl::base::ConstBytes_t data
     // (it doesn't save much, and git does not like it).
 
     // Compute object Id
-    const String_t prefix = afl::string::Format("%s%d", KEYWORDS[type], data.size());
-    static const uint8_t ZERO[1] = {0};
-    afl::checksums::SHA1 checksummer;
-    checksummer.add(afl::string::toBytes(prefix));
-    checksummer.add(ZERO);
-    checksummer.add(data);
-
-    const ObjectId id = ObjectId::fromHash(checksummer);
+    const ObjectId id = computeObjectId(type, data);
 
     // Verify object content
     afl::base::Ptr<afl::io::FileMapping> existingContent;
@@ -198,39 +288,40 @@ server::file::ca::ObjectStore::addObject(Type type, afl::base::ConstBytes_t data
         int32_t tmp;
         m_refCounter->modify(id, +1, tmp);
     } else {
-        // Object does not exist, create it
-        const uint8_t firstChar = id.m_bytes[0];
-        if (!m_subdirectories[firstChar]) {
-            String_t name;
-            afl::string::putHexByte(name, firstChar, afl::string::HEX_DIGITS_LOWER);
-            DirectoryHandler::Info info = m_directory.createDirectory(name);
-            m_subdirectories.replaceElementNew(firstChar, m_directory.getDirectory(info));
+        // Object does not exist, create it (keep a copy of the original data)
+        afl::base::GrowableMemory<uint8_t> originalContent;
+        originalContent.append(data);
+        afl::base::Ref<afl::io::FileMapping> map(*new afl::io::InternalFileMapping(originalContent));
+        if (m_deferredWrite && type != DataObject) {
+            // Keep it until flush()
+            m_pendingObjects.insert(std::make_pair(id, PendingObject(type, map.asPtr())));
+        } else {
+            writeLooseObject(id, type, data);
         }
 
-        // Compression
-        afl::base::GrowableMemory<uint8_t> newContent;
-        afl::io::DeflateTransform tx(afl::io::DeflateTransform::Zlib);
-
-        transformAdd(newContent, tx, afl::string::toBytes(prefix));
-        transformAdd(newContent, tx, ZERO);
-        transformAdd(newContent, tx, data);
-        transformFinish(newContent, tx);
-
-        // Create file
-        m_subdirectories[firstChar]->createFile(getTailName(id), newContent);
-
         // Set initial reference counter
         m_refCounter->set(id, 1);
 
-        // Cache it (cache the original data!)
-        afl::base::GrowableMemory<uint8_t> originalContent;
-        originalContent.append(data);
-        m_cache->addObject(id, type, *new afl::io::InternalFileMapping(originalContent));
+        // Cache it
+        m_cache->addObject(id, type, map);
     }
 
     return id;
 }
 
+// Compute object Id.
+server::file::ca::ObjectId
+server::file::ca::ObjectStore::computeObjectId(Type type, afl::base::ConstBytes_t data)
+{
+    const String_t prefix = afl::string::Format("%s%d", KEYWORDS[type], data.size());
+    static const uint8_t ZERO[1] = {0};
+    afl::checksums::SHA1 checksummer;
+    checksummer.add(afl::string::toBytes(prefix));
+    checksummer.add(ZERO);
+    checksummer.add(data);
+    return ObjectId::fromHash(checksummer);
+}
+
 // Link an object.
 void
 server::file::ca::ObjectStore::linkObject(const ObjectId& id)
@@ -254,9 +345,16 @@ server::file::ca::ObjectStore::unlinkObject(Type type, const ObjectId& id)
                 unlinkContent(type, getObject(id, type)->get());
             }
 
-            // Remove the file
+            // Remove the file.
+            // A pending object has never been written, so just forget it.
+            // A packed object cannot be removed individually; it remains until the pack is garbage-collected.
             const uint8_t firstChar = id.m_bytes[0];
-            if (firstChar < m_subdirectories.size() && m_subdirectories[firstChar] != 0) {
+            PackFile* pPack;
+            size_t packIndex;
+            PendingMap_t::iterator pendingIt = m_pendingObjects.find(id);
+            if (pendingIt != m_pendingObjects.end()) {
+                m_pendingObjects.erase(pendingIt);
+            } else if (!findPackedObject(id, pPack, packIndex) && firstChar < m_subdirectories.size() && m_subdirectories[firstChar] != 0) {
                 m_subdirectories[firstChar]->removeFile(getTailName(id));
             }
 
@@ -277,6 +375,129 @@ server::file::ca::ObjectStore::getObjectDirectory(size_t prefix)
     }
 }
 
+// Merge loose objects into pack files.
+size_t
+server::file::ca::ObjectStore::repack()
+{
+    // Collect names of loose objects in a first-byte directory
+    class Collector : public DirectoryHandler::Callback {
+     public:
+        Collector(uint8_t firstByte, std::vector<ObjectId>& result)
+            : m_firstByte(firstByte), m_result(result)
+            { }
+        virtual void addItem(const DirectoryHandler::Info& info)
+            {
+                if (info.type == DirectoryHandler::IsFile) {
+                    String_t name;
+                    afl::string::putHexByte(name, m_firstByte, afl::string::HEX_DIGITS_LOWER);
+                    name += info.name;
+                    ObjectId id = ObjectId::fromHex(name);
+                    if (id.toHex() == name) {
+                        m_result.push_back(id);
+                    }
+                }
+            }
+     private:
+        const uint8_t m_firstByte;
+        std::vector<ObjectId>& m_result;
+    };
+
+    PackBuilder builder;
+    std::vector<ObjectId> looseObjects;   // Loose objects to remove after the current pack has been written
+    size_t numPacked = 0;
+    for (size_t prefix = 0; prefix < m_subdirectories.size(); ++prefix) {
+        if (DirectoryHandler* dir = m_subdirectories[prefix]) {
+            std::vector<ObjectId> ids;
+            Collector c(static_cast<uint8_t>(prefix), ids);
+            dir->readContent(c);
+
+            for (size_t i = 0, n = ids.size(); i < n; ++i) {
+                PackFile* pPack;
+                size_t packIndex;
+                if (findPackedObject(ids[i], pPack, packIndex)) {
+                    // Already packed (e.g. previous repack was interrupted); just drop the loose copy.
+                    looseObjects.push_back(ids[i]);
+                } else {
+                    Type type;
+                    afl::base::GrowableBytes_t content;
+                    bool ok;
+                    try {
+                        ok = loadLooseObject(ids[i], type, content);
+                    }
+                    catch (std::exception&) {
+                        // Damaged object; leave it for someone to look at.
+                        ok = false;
+                    }
+                    if (ok) {
+                        builder.addObject(ids[i], type, content);
+                        looseObjects.push_back(ids[i]);
+                        ++numPacked;
+                    }
+                }
+
+                if (builder.getSize() >= PACK_SIZE_LIMIT) {
+                    finishPack(builder);
+                    removeLooseObjects(looseObjects);
+                    looseObjects.clear();
+                }
+            }
+        }
+    }
+
+    if (builder.getNumObjects() != 0) {
+        finishPack(builder);
+    }
+    removeLooseObjects(looseObjects);
+    removeEmptyObjectDirectories();
+
+    return numPacked;
+}
+
+// Get number of pack files.
+size_t
+server::file::ca::ObjectStore::getNumPacks() const
+{
+    return m_packs.size();
+}
+
+// Remove garbage from a pack file.
+size_t
+server::file::ca::ObjectStore::removeGarbageFromPack(size_t index, const std::set<ObjectId>& objectsToKeep)
+{
+    if (index >= m_packs.size()) {
+        return 0;
+    }
+
+    // Copy objects to keep into new pack
+    PackFile& pack = *m_packs[index];
+    PackBuilder builder;
+    std::vector<ObjectId> garbage;
+    for (size_t i = 0, n = pack.getNumObjects(); i < n; ++i) {
+        const ObjectId id = pack.getObjectId(i);
+        if (objectsToKeep.find(id) != objectsToKeep.end()) {
+            Type type;
+            size_t size;
+            afl::base::GrowableBytes_t content;
+            readPackedObject(pack, i, type, size, &content);
+            builder.addObject(id, type, content);
+        } else {
+            garbage.push_back(id);
+        }
+    }
+
+    // If there is garbage, replace the pack
+    if (!garbage.empty()) {
+        if (builder.getNumObjects() != 0) {
+            finishPack(builder);
+        }
+        removePack(index);
+        for (size_t i = 0, n = garbage.size(); i < n; ++i) {
+            m_cache->removeObject(garbage[i]);
+        }
+    }
+    return garbage.size();
+}
+
 /** Load an object, internal.
     \param id Object Id
     \param expectedType Expected type
@@ -289,6 +510,9 @@ bool
 server::file::ca::ObjectStore::loadObject(const ObjectId& id, Type expectedType, size_t* pSize, afl::base::Ptr<afl::io::FileMapping>* pContent)
 {
     const uint8_t firstChar = id.m_bytes[0];
+    PackFile* pPack = 0;
+    size_t packIndex = 0;
+    PendingMap_t::const_iterator pendingIt;
     if (id == ObjectId::nil) {
         // Null matches anything
         if (pSize != 0) {
@@ -301,6 +525,18 @@ server::file::ca::ObjectStore::loadObject(const ObjectId& id, Type expectedType,
             *pContent = new afl::io::InternalFileMapping(mem);
         }
         return true;
+    } else if ((pendingIt = m_pendingObjects.find(id)) != m_pendingObjects.end()) {
+        // Object not yet written
+        if (pendingIt->second.type != expectedType) {
+            throw std::runtime_error(BAD_OBJECT_TYPE);
+        }
+        if (pSize != 0) {
+            *pSize = pendingIt->second.content->get().size();
+        }
+        if (pContent != 0) {
+            *pContent = pendingIt->second.content;
+        }
+        return true;
     } else if (pSize != 0 && pContent == 0 && m_cache->getObjectSize(id, expectedType).get(*pSize)) {
         // Satisified size request from cache
         return true;
@@ -310,6 +546,26 @@ server::file::ca::ObjectStore::loadObject(const ObjectId& id, Type expectedType,
             *pSize = (*pContent)->get().size();
         }
         return true;
+    } else if (findPackedObject(id, pPack, packIndex)) {
+        // Packed object
+        Type type;
+        size_t size;
+        afl::base::GrowableBytes_t mem;
+        readPackedObject(*pPack, packIndex, type, size, pContent != 0 ? &mem : 0);
+        if (type != expectedType) {
+            throw std::runtime_error(BAD_OBJECT_TYPE);
+        }
+        if (pSize != 0) {
+            *pSize = size;
+        }
+        if (pContent != 0) {
+            afl::base::Ref<afl::io::FileMapping> map(*new afl::io::InternalFileMapping(mem));
+            m_cache->addObject(id, expectedType, map);
+            *pContent = map.asPtr();
+        } else {
+            m_cache->addObjectSize(id, expectedType, size);
+        }
+        return true;
     } else if (firstChar >= m_subdirectories.size() || m_subdirectories[firstChar] == 0) {
         // Directory does not exist
         return false;
@@ -347,21 +603,7 @@ server::file::ca::ObjectStore::loadObject(const ObjectId& id, Type expectedType,
             afl::base::GrowableBytes_t mem;
             mem.reserve(size);
             mem.append(uncompressedContent);
-            while (!compressedContent.empty()) {
-                uncompressedContent = uncompressedBuffer;
-                tx.transform(compressedContent, uncompressedContent);
-                mem.append(uncompressedContent);
-            }
-
-            tx.flush();
-            while (1) {
-                uncompressedContent = uncompressedBuffer;
-                tx.transform(compressedContent, uncompressedContent);
-                mem.append(uncompressedContent);
-                if (compressedContent.empty()) {
-                    break;
-                }
-            }
+            inflateRemainder(tx, compressedContent, mem);
 
             if (size != mem.size()) {
                 throw afl::except::FileProblemException(id.toHex(), BAD_OBJECT_CONTENT);
@@ -383,6 +625,174 @@ server::file::ca::ObjectStore::loadObject(const ObjectId& id, Type expectedType,
     }
 }
 
+/** Load a loose object, with any type.
+    \param [in]  id      Object Id
+    \param [out] type    Object type
+    \param [out] content Object content
+    \retval true Object loaded successfully
+    \retval false Object does not exist as loose object
+    \throw afl::except::FileProblemException Object is damaged */
+bool
+server::file::ca::ObjectStore::loadLooseObject(const ObjectId& id, Type& type, afl::base::GrowableBytes_t& content)
+{
+    const uint8_t firstChar = id.m_bytes[0];
+    if (firstChar >= m_subdirectories.size() || m_subdirectories[firstChar] == 0) {
+        return false;
+    }
+
+    afl::base::Ptr<afl::io::FileMapping> compressedMapping;
+    try {
+        compressedMapping = m_subdirectories[firstChar]->getFileByName(getTailName(id)).asPtr();
+    }
+    catch (std::exception&) {
+        return false;
+    }
+    afl::base::ConstBytes_t compressedContent(compressedMapping->get());
+
+    // Decompress and check header
+    uint8_t uncompressedBuffer[4096];
+    afl::base::Bytes_t uncompressedContent(uncompressedBuffer);
+    afl::io::InflateTransform tx(afl::io::InflateTransform::Zlib);
+    tx.transform(compressedContent, uncompressedContent);
+    size_t size = verifyAnyHeader(uncompressedContent, type);
+
+    // Decompress remainder
+    content.reserve(size);
+    content.append(uncompressedContent);
+    inflateRemainder(tx, compressedContent, content);
+    if (size != content.size()) {
+        throw afl::except::FileProblemException(id.toHex(), BAD_OBJECT_CONTENT);
+    }
+    return true;
+}
+
+/** Find packed object.
+    \param [in]  id    Object Id
+    \param [out] pPack Pack containing the object
+    \param [out] index Index of object in pack
+    \return true if object found */
+bool
+server::file::ca::ObjectStore::findPackedObject(const ObjectId& id, PackFile*& pPack, size_t& index)
+{
+    for (size_t i = 0, n = m_packs.size(); i < n; ++i) {
+        if (m_packs[i]->findObject(id, index)) {
+            pPack = m_packs[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Read packed object.
+    Wraps PackFile::readObject() to limit the number of loaded packs.
+    \param pack     Pack
+    \param index    Index of object in pack
+    \param type     [out] Object type
+    \param size     [out] Object size
+    \param pContent [out,optional] Object content */
+void
+server::file::ca::ObjectStore::readPackedObject(PackFile& pack, size_t index, Type& type, size_t& size, afl::base::GrowableBytes_t* pContent)
+{
+    // Mark pack most-recently used; unload least-recently used ones
+    std::vector<PackFile*>::iterator it = std::find(m_loadedPacks.begin(), m_loadedPacks.end(), &pack);
+    if (it != m_loadedPacks.end()) {
+        m_loadedPacks.erase(it);
+    }
+    m_loadedPacks.insert(m_loadedPacks.begin(), &pack);
+    while (m_loadedPacks.size() > MAX_LOADED_PACKS) {
+        m_loadedPacks.back()->unload();
+        m_loadedPacks.pop_back();
+    }
+
+    pack.readObject(index, type, size, pContent);
+}
+
+/** Get pack directory, create if needed.
+    \return DirectoryHandler */
+server::file::DirectoryHandler&
+server::file::ca::ObjectStore::getPackDirectory()
+{
+    if (m_packDirectory.get() == 0) {
+        m_packDirectory.reset(m_directory.getDirectory(m_directory.createDirectory(PACK_DIRECTORY)));
+    }
+    return *m_packDirectory;
+}
+
+/** Write a pack and make it available for reading.
+    \param builder PackBuilder containing the objects
+    \return base name of new pack */
+String_t
+server::file::ca::ObjectStore::finishPack(PackBuilder& builder)
+{
+    DirectoryHandler& dir = getPackDirectory();
+    String_t baseName = builder.finish(dir);
+    m_packs.pushBackNew(new PackFile(dir, baseName));
+    return baseName;
+}
+
+/** Remove a pack.
+    The last pack takes its place.
+    \param index Index [0,getNumPacks()) */
+void
+server::file::ca::ObjectStore::removePack(size_t index)
+{
+    PackFile* pack = m_packs[index];
+    m_loadedPacks.erase(std::remove(m_loadedPacks.begin(), m_loadedPacks.end(), pack), m_loadedPacks.end());
+
+    // Remove index first; a pack file without index is ignored.
+    DirectoryHandler& dir = getPackDirectory();
+    dir.removeFile(pack->getBaseName() + ".idx");
+    dir.removeFile(pack->getBaseName() + ".pack");
+
+    m_packs.swapElements(index, m_packs.size()-1);
+    m_packs.popBack();
+}
+
+/** Remove loose objects.
+    \param ids Object Ids */
+void
+server::file::ca::ObjectStore::removeLooseObjects(const std::vector<ObjectId>& ids)
+{
+    for (size_t i = 0, n = ids.size(); i < n; ++i) {
+        const uint8_t firstChar = ids[i].m_bytes[0];
+        if (DirectoryHandler* dir = getObjectDirectory(firstChar)) {
+            dir->removeFile(getTailName(ids[i]));
+        }
+    }
+}
+
+/** Remove empty first-byte directories.
+    They will be re-created when needed. */
+void
+server::file::ca::ObjectStore::removeEmptyObjectDirectories()
+{
+    class Counter : public DirectoryHandler::Callback {
+     public:
+        Counter()
+            : m_count(0)
+            { }
+        virtual void addItem(const DirectoryHandler::Info& /*info*/)
+            { ++m_count; }
+        size_t get() const
+            { return m_count; }
+     private:
+        size_t m_count;
+    };
+
+    for (size_t prefix = 0; prefix < m_subdirectories.size(); ++prefix) {
+        if (DirectoryHandler* dir = m_subdirectories[prefix]) {
+            Counter c;
+            dir->readContent(c);
+            if (c.get() == 0) {
+                String_t name;
+                afl::string::putHexByte(name, static_cast<uint8_t>(prefix), afl::string::HEX_DIGITS_LOWER);
+                m_directory.removeDirectory(name);
+                m_subdirectories.replaceElementNew(prefix, 0);
+            }
+        }
+    }
+}
+
 /** Read directory.
     Initially populates the m_subdirectories member. */
 void
@@ -402,6 +812,9 @@ server::file::ca::ObjectStore::readDirectory()
                         m_parent.m_subdirectories.replaceElementNew(16*a+b, m_parent.m_directory.getDirectory(info));
                     }
                 }
+                if (info.name == PACK_DIRECTORY && info.type == DirectoryHandler::IsDirectory) {
+                    m_parent.m_packDirectory.reset(m_parent.m_directory.getDirectory(info));
+                }
             }
      private:
         ObjectStore& m_parent;
@@ -409,6 +822,62 @@ server::file::ca::ObjectStore::readDirectory()
     Callback cb(*this);
     m_subdirectories.resize(256);
     m_directory.readContent(cb);
+
+    // Packs
+    class PackCallback : public DirectoryHandler::Callback {
+     public:
+        virtual void addItem(const DirectoryHandler::Info& info)
+            {
+                if (info.type == DirectoryHandler::IsFile) {
+                    m_names.insert(info.name);
+                }
+            }
+        std::set<String_t> m_names;
+    };
+    if (m_packDirectory.get() != 0) {
+        PackCallback pcb;
+        m_packDirectory->readContent(pcb);
+        for (std::set<String_t>::const_iterator it = pcb.m_names.begin(); it != pcb.m_names.end(); ++it) {
+            // Accept "XXX.idx" if "XXX.pack" exists
+            const String_t& name = *it;
+            if (name.size() > 4 && name.compare(name.size()-4, 4, ".idx") == 0) {
+                const String_t baseName = name.substr(0, name.size()-4);
+                if (pcb.m_names.find(baseName + ".pack") != pcb.m_names.end()) {
+                    m_packs.pushBackNew(new PackFile(*m_packDirectory, baseName));
+                }
+            }
+        }
+    }
+}
+
+/** Write a loose object.
+    \param id   Object Id (must match type and data)
+    \param type Object type
+    \param data Object payload */
+void
+server::file::ca::ObjectStore::writeLooseObject(const ObjectId& id, Type type, afl::base::ConstBytes_t data)
+{
+    // Create directory if needed
+    const uint8_t firstChar = id.m_bytes[0];
+    if (!m_subdirectories[firstChar]) {
+        String_t name;
+        afl::string::putHexByte(name, firstChar, afl::string::HEX_DIGITS_LOWER);
+        DirectoryHandler::Info info = m_directory.createDirectory(name);
+        m_subdirectories.replaceElementNew(firstChar, m_directory.getDirectory(info));
+    }
+
+    // Compression
+    static const uint8_t ZERO[1] = {0};
+    afl::base::GrowableMemory<uint8_t> newContent;
+    afl::io::DeflateTransform tx(afl::io::DeflateTransform::Zlib);
+
+    transformAdd(newContent, tx, afl::string::toBytes(afl::string::Format("%s%d", KEYWORDS[type], data.size())));
+    transformAdd(newContent, tx, ZERO);
+    transformAdd(newContent, tx, data);
+    transformFinish(newContent, tx);
+
+    // Create file
+    m_subdirectories[firstChar]->createFile(getTailName(id), newContent);
 }
 
 /** Unlink an object's content.
@@ -5,7 +5,10 @@
 #ifndef C2NG_SERVER_FILE_CA_OBJECTSTORE_HPP
 #define C2NG_SERVER_FILE_CA_OBJECTSTORE_HPP
 
+#include <map>
 #include <memory>
+#include <set>
+#include <vector>
 #include "server/file/directoryhandler.hpp"
 #include "afl/base/growablememory.hpp"
 #include "afl/base/memory.hpp"
@@ -20,6 +23,8 @@ namespace server { namespace file { namespace ca {
 
     class ReferenceCounter;
     class ObjectCache;
+    class PackFile;
+    class PackBuilder;
 
     /** Object storage.
         This is the central component of the content-addressable storage backend.
@@ -33,9 +38,18 @@ namespace server { namespace file { namespace ca {
 
         Reference counting enables removal of objects that become unused.
 
-        We do not try to combine or cancel writes.
+        By default, we do not try to combine or cancel writes.
         Updating 3 files in a directory will write out the individual versions of that directory several times.
-        With reference counting enabled, the superseded versions will immediately be deleted again and, with Linux, never hit the disk I/O. */
+        With reference counting enabled, the superseded versions will immediately be deleted again and, with Linux, never hit the disk I/O.
+
+        In deferred write mode (setDeferredWrite()), new tree and commit objects are kept in memory until flush().
+        Superseded versions that become unreferenced before that are dropped without ever being written.
+        The caller must make sure that nothing on disk refers to an object that has not yet been flushed (see Root::flush()).
+
+        New objects are always created as loose objects (one file each).
+        repack() merges loose objects into pack files (see PackFile), which are looked up first when reading.
+        Objects in a pack are never deleted individually; unreferenced packed objects remain until
+        the GarbageCollector rewrites the pack using removeGarbageFromPack(). */
     class ObjectStore : private afl::base::Uncopyable {
      public:
         /** Object type. */
@@ -52,6 +66,32 @@ namespace server { namespace file { namespace ca {
         /** Destructor. */
         ~ObjectStore();
 
+        /** Set reference counter.
+            Replaces the default InternalReferenceCounter.
+            Call before modifying the ObjectStore; reference counts collected so far are discarded.
+            \param p New ReferenceCounter. Must not be null. */
+        void setReferenceCounter(std::auto_ptr<ReferenceCounter> p);
+
+        /** Set object cache.
+            Replaces the default InternalObjectCache.
+            \param p New ObjectCache. Must not be null. */
+        void setObjectCache(std::auto_ptr<ObjectCache> p);
+
+        /** Set deferred write mode.
+            \param enable true to keep new tree and commit objects in memory until flush(); false to write them immediately.
+            Disabling deferred write mode flushes pending objects. */
+        void setDeferredWrite(bool enable);
+
+        /** Write pending objects.
+            In deferred write mode, writes all tree and commit objects created since the last flush()
+            that are still referenced.
+            \return Number of objects written */
+        size_t flush();
+
+        /** Get number of pending objects.
+            \return Number of objects that will be written by flush() */
+        size_t getNumPendingObjects() const;
+
         /** Get object content.
             \param id Object Id
             \param expectedType Expected type
@@ -94,6 +134,14 @@ namespace server { namespace file { namespace ca {
             \return Object Id */
         ObjectId addObject(Type type, afl::base::ConstBytes_t data);
 
+        /** Compute object Id.
+            Computes the Id an object would have in the store, without storing it.
+            For a DataObject, this is the same Id git uses for a blob.
+            \param type Object type
+            \param data Payload
+            \return Object Id */
+        static ObjectId computeObjectId(Type type, afl::base::ConstBytes_t data);
+
         /** Link an object.
             Adds one to the object's reference counter.
             \param id Object Id */
@@ -112,9 +160,47 @@ namespace server { namespace file { namespace ca {
             \return DirectoryHandler if one exists, null if this directory does not exist (=has no objects) */
         DirectoryHandler* getObjectDirectory(size_t prefix);
 
+        /** Merge loose objects into pack files.
+            Moves all loose objects into one or more new pack files, and removes the loose files
+            (and first-byte directories that become empty).
+            Damaged loose objects are left alone.
+            \return Number of objects packed */
+        size_t repack();
+
+        /** Get number of pack files.
+            \return number */
+        size_t getNumPacks() const;
+
+        /** Remove garbage from a pack file.
+            If the pack contains objects that are not in \c objectsToKeep, rewrites the pack with only the objects to keep.
+            The rewritten pack is added at the end of the list of packs; the original pack is removed.
+            Therefore, to process all packs, iterate backwards from getNumPacks().
+            \param index Index of pack [0,getNumPacks())
+            \param objectsToKeep Set of objects to keep
+            \return Number of objects removed */
+        size_t removeGarbageFromPack(size_t index, const std::set<ObjectId>& objectsToKeep);
+
      private:
+        struct PendingObject {
+            Type type;
+            afl::base::Ptr<afl::io::FileMapping> content;
+            PendingObject(Type type, afl::base::Ptr<afl::io::FileMapping> content)
+                : type(type), content(content)
+                { }
+        };
+        typedef std::map<ObjectId, PendingObject> PendingMap_t;
+
         bool loadObject(const ObjectId& id, Type expectedType, size_t* pSize, afl::base::Ptr<afl::io::FileMapping>* pContent);
+        bool loadLooseObject(const ObjectId& id, Type& type, afl::base::GrowableBytes_t& content);
+        bool findPackedObject(const ObjectId& id, PackFile*& pPack, size_t& index);
+        void readPackedObject(PackFile& pack, size_t index, Type& type, size_t& size, afl::base::GrowableBytes_t* pContent);
+        DirectoryHandler& getPackDirectory();
+        String_t finishPack(PackBuilder& builder);
+        void removePack(size_t index);
+        void removeLooseObjects(const std::vector<ObjectId>& ids);
+        void removeEmptyObjectDirectories();
         void readDirectory();
+        void writeLooseObject(const ObjectId& id, Type type, afl::base::ConstBytes_t data);
         void unlinkContent(Type type, afl::base::ConstBytes_t data);
 
         // DirectoryHandler for the "objects" directory.
@@ -128,6 +214,21 @@ namespace server { namespace file { namespace ca {
 
         // Cache
         std::auto_ptr<ObjectCache> m_cache;
+
+        // DirectoryHandler for the "pack" directory. Null if it does not exist (yet).
+        std::auto_ptr<DirectoryHandler> m_packDirectory;
+
+        // Pack files.
+        afl::container::PtrVector<PackFile> m_packs;
+
+        // Pack files whose data is loaded, most-recently used first.
+        std::vector<PackFile*> m_loadedPacks;
+
+        // Deferred write mode.
+        bool m_deferredWrite;
+
+        // Objects not yet written (deferred write mode).
+        PendingMap_t m_pendingObjects;
     };
 
 } } }
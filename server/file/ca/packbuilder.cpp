@@ -0,0 +1,206 @@
+/**
+  *  \file server/file/ca/packbuilder.cpp
+  *  \brief Class server::file::ca::PackBuilder
+  */
+
+#include <algorithm>
+#include "server/file/ca/packbuilder.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/deflatetransform.hpp"
+
+namespace {
+    const char*const PACK_TOO_LARGE = "500 Pack too large";
+
+    const uint8_t INDEX_MAGIC[] = { 0xFF, 't', 'O', 'c', 0, 0, 0, 2 };
+    const uint8_t PACK_MAGIC[] = { 'P', 'A', 'C', 'K', 0, 0, 0, 2 };
+
+    void storeUInt32BE(uint8_t (&out)[4], uint32_t value)
+    {
+        out[0] = uint8_t(value >> 24);
+        out[1] = uint8_t(value >> 16);
+        out[2] = uint8_t(value >> 8);
+        out[3] = uint8_t(value);
+    }
+
+    void appendUInt32BE(afl::base::GrowableBytes_t& out, uint32_t value)
+    {
+        uint8_t bytes[4];
+        storeUInt32BE(bytes, value);
+        out.append(bytes);
+    }
+
+    void appendHash(afl::base::GrowableBytes_t& out, afl::base::ConstBytes_t data)
+    {
+        afl::checksums::SHA1 hash;
+        hash.add(data);
+        const server::file::ca::ObjectId id = server::file::ca::ObjectId::fromHash(hash);
+        out.append(id.m_bytes);
+    }
+
+    void transformAdd(afl::base::GrowableBytes_t& out, afl::io::Transform& tx, afl::base::ConstBytes_t in)
+    {
+        while (!in.empty()) {
+            uint8_t outBuffer[4096];
+            afl::base::Bytes_t outContent(outBuffer);
+            tx.transform(in, outContent);
+            out.append(outContent);
+        }
+    }
+
+    void transformFinish(afl::base::GrowableBytes_t& out, afl::io::Transform& tx)
+    {
+        afl::base::ConstBytes_t in;
+        tx.flush();
+        while (1) {
+            uint8_t outBuffer[4096];
+            afl::base::Bytes_t outContent(outBuffer);
+            tx.transform(in, outContent);
+            out.append(outContent);
+            if (outContent.empty()) {
+                break;
+            }
+        }
+    }
+
+    /* CRC-32 as used by zlib/git (index stores it for each packed object) */
+    uint32_t computeCrc(afl::base::ConstBytes_t data)
+    {
+        static const uint32_t POLY = 0xEDB88320U;
+        uint32_t crc = 0xFFFFFFFFU;
+        while (const uint8_t* p = data.eat()) {
+            crc ^= *p;
+            for (int i = 0; i < 8; ++i) {
+                crc = (crc >> 1) ^ (POLY & (0U - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+}
+
+struct server::file::ca::PackBuilder::CompareEntries {
+    bool operator()(const Entry& a, const Entry& b) const
+        { return a.id < b.id; }
+};
+
+// Constructor.
+server::file::ca::PackBuilder::PackBuilder()
+    : m_pack(),
+      m_entries()
+{
+    reset();
+}
+
+// Destructor.
+server::file::ca::PackBuilder::~PackBuilder()
+{ }
+
+// Add an object.
+void
+server::file::ca::PackBuilder::addObject(const ObjectId& id, ObjectStore::Type type, afl::base::ConstBytes_t data)
+{
+    // We only produce 32-bit offsets
+    const size_t offset = m_pack.size();
+    if (offset >= 0x80000000U) {
+        throw afl::except::FileProblemException(id.toHex(), PACK_TOO_LARGE);
+    }
+
+    // Object header: type and size
+    uint8_t typeCode = 0;
+    switch (type) {
+     case ObjectStore::CommitObject: typeCode = 1; break;
+     case ObjectStore::TreeObject:   typeCode = 2; break;
+     case ObjectStore::DataObject:   typeCode = 3; break;
+    }
+    size_t size = data.size();
+    uint8_t header = uint8_t((typeCode << 4) | (size & 15));
+    size >>= 4;
+    while (size != 0) {
+        m_pack.append(uint8_t(header | 0x80));
+        header = uint8_t(size & 0x7F);
+        size >>= 7;
+    }
+    m_pack.append(header);
+
+    // Compressed payload
+    afl::io::DeflateTransform tx(afl::io::DeflateTransform::Zlib);
+    transformAdd(m_pack, tx, data);
+    transformFinish(m_pack, tx);
+
+    // Remember it
+    Entry e;
+    e.id = id;
+    e.crc = computeCrc(m_pack.subrange(offset));
+    e.offset = uint32_t(offset);
+    m_entries.push_back(e);
+}
+
+// Get number of objects added so far.
+size_t
+server::file::ca::PackBuilder::getNumObjects() const
+{
+    return m_entries.size();
+}
+
+// Get current size of the pack file.
+size_t
+server::file::ca::PackBuilder::getSize() const
+{
+    return m_pack.size();
+}
+
+// Write the pack.
+String_t
+server::file::ca::PackBuilder::finish(DirectoryHandler& dir)
+{
+    // Complete the pack: object count and checksum
+    uint8_t count[4];
+    storeUInt32BE(count, uint32_t(m_entries.size()));
+    m_pack.subrange(sizeof(PACK_MAGIC), 4).copyFrom(count);
+    appendHash(m_pack, m_pack);
+    afl::base::ConstBytes_t packHash = afl::base::ConstBytes_t(m_pack).subrange(m_pack.size() - sizeof(ObjectId));
+
+    // Build the index
+    std::sort(m_entries.begin(), m_entries.end(), CompareEntries());
+
+    afl::base::GrowableBytes_t index;
+    index.append(INDEX_MAGIC);
+    size_t n = 0;
+    for (size_t i = 0; i < 256; ++i) {
+        while (n < m_entries.size() && m_entries[n].id.m_bytes[0] == i) {
+            ++n;
+        }
+        appendUInt32BE(index, uint32_t(n));
+    }
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        index.append(m_entries[i].id.m_bytes);
+    }
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        appendUInt32BE(index, m_entries[i].crc);
+    }
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        appendUInt32BE(index, m_entries[i].offset);
+    }
+    index.append(packHash);
+    appendHash(index, index);
+
+    // Write it. Name is derived from the pack checksum, like git does.
+    ObjectId name;
+    afl::base::Bytes_t(name.m_bytes).copyFrom(packHash);
+    const String_t baseName = "pack-" + name.toHex();
+    dir.createFile(baseName + ".pack", m_pack);
+    dir.createFile(baseName + ".idx", index);
+
+    reset();
+    return baseName;
+}
+
+/** Reset to empty pack (just the header). */
+void
+server::file::ca::PackBuilder::reset()
+{
+    m_pack.clear();
+    m_pack.append(PACK_MAGIC);
+    appendUInt32BE(m_pack, 0);
+    m_entries.clear();
+}
@@ -0,0 +1,72 @@
+/**
+  *  \file server/file/ca/packbuilder.hpp
+  *  \brief Class server::file::ca::PackBuilder
+  */
+#ifndef C2NG_SERVER_FILE_CA_PACKBUILDER_HPP
+#define C2NG_SERVER_FILE_CA_PACKBUILDER_HPP
+
+#include <vector>
+#include "afl/base/growablememory.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "server/file/ca/objectid.hpp"
+#include "server/file/ca/objectstore.hpp"
+#include "server/file/directoryhandler.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    /** Pack file builder.
+        Collects objects in memory and writes them as a pack file and index (see PackFile).
+
+        Usage:
+        - call addObject() for each object;
+        - call finish() to write the files.
+
+        Because DirectoryHandler can only create files as a whole, the pack is assembled in memory.
+        Callers should therefore limit the pack size (see getSize()) and start a new pack when it grows too large. */
+    class PackBuilder : private afl::base::Uncopyable {
+     public:
+        /** Constructor. Makes an empty pack. */
+        PackBuilder();
+
+        /** Destructor. */
+        ~PackBuilder();
+
+        /** Add an object.
+            The caller must make sure that each object is added only once.
+            \param id   Object Id (must match type and content)
+            \param type Object type
+            \param data Object payload */
+        void addObject(const ObjectId& id, ObjectStore::Type type, afl::base::ConstBytes_t data);
+
+        /** Get number of objects added so far.
+            \return number of objects */
+        size_t getNumObjects() const;
+
+        /** Get current size of the pack file.
+            \return size in bytes */
+        size_t getSize() const;
+
+        /** Write the pack.
+            Writes the pack file first, then the index, so an interrupted write never leaves a usable index for a partial pack.
+            Resets the PackBuilder to empty state afterwards.
+            \param dir Directory to write to ("objects/pack")
+            \return base name of the new pack ("pack-XXXX") */
+        String_t finish(DirectoryHandler& dir);
+
+     private:
+        struct Entry {
+            ObjectId id;
+            uint32_t crc;
+            uint32_t offset;
+        };
+        struct CompareEntries;
+
+        void reset();
+
+        afl::base::GrowableBytes_t m_pack;
+        std::vector<Entry> m_entries;
+    };
+
+} } }
+
+#endif
@@ -0,0 +1,258 @@
+/**
+  *  \file server/file/ca/packfile.cpp
+  *  \brief Class server::file::ca::PackFile
+  */
+
+#include <algorithm>
+#include <cstring>
+#include "server/file/ca/packfile.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/inflatetransform.hpp"
+
+namespace {
+    const char*const BAD_INDEX = "500 Bad pack index";
+    const char*const BAD_PACK = "500 Bad pack file";
+    const char*const BAD_OBJECT_SIZE = "500 Bad object size";
+    const char*const BAD_OBJECT_CONTENT = "500 Bad object content";
+    const char*const UNSUPPORTED_OBJECT = "500 Unsupported object type";
+
+    const uint8_t INDEX_MAGIC[] = { 0xFF, 't', 'O', 'c', 0, 0, 0, 2 };
+    const uint8_t PACK_MAGIC[] = { 'P', 'A', 'C', 'K', 0, 0, 0, 2 };
+
+    /* Index layout: header (8 bytes), fan-out table (256 x 4 bytes), then Ids, CRCs, offsets per object. */
+    const size_t INDEX_HEADER_SIZE = 8 + 256*4;
+    const size_t ID_SIZE = sizeof(server::file::ca::ObjectId);
+    const size_t TRAILER_SIZE = 2*ID_SIZE;
+
+    uint32_t getUInt32BE(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 24) + (uint32_t(p[1]) << 16) + (uint32_t(p[2]) << 8) + uint32_t(p[3]);
+    }
+}
+
+// Constructor.
+server::file::ca::PackFile::PackFile(DirectoryHandler& dir, const String_t& baseName)
+    : m_directory(dir),
+      m_baseName(baseName),
+      m_index(dir.getFileByName(baseName + ".idx")),
+      m_numObjects(0),
+      m_pack(),
+      m_sortedOffsets()
+{
+    // Validate header
+    afl::base::ConstBytes_t idx = m_index->get();
+    if (idx.size() < INDEX_HEADER_SIZE + TRAILER_SIZE || std::memcmp(idx.unsafeData(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        throw afl::except::FileProblemException(baseName, BAD_INDEX);
+    }
+
+    // Validate fan-out table; it must be monotonous
+    uint32_t prev = 0;
+    for (size_t i = 0; i < 256; ++i) {
+        uint32_t n = getUInt32BE(idx.unsafeData() + 8 + 4*i);
+        if (n < prev) {
+            throw afl::except::FileProblemException(baseName, BAD_INDEX);
+        }
+        prev = n;
+    }
+    m_numObjects = prev;
+
+    // Validate size
+    if ((idx.size() - INDEX_HEADER_SIZE - TRAILER_SIZE) / (ID_SIZE + 8) < m_numObjects) {
+        throw afl::except::FileProblemException(baseName, BAD_INDEX);
+    }
+
+    // Build offset table
+    m_sortedOffsets.reserve(m_numObjects);
+    for (size_t i = 0; i < m_numObjects; ++i) {
+        m_sortedOffsets.push_back(getObjectOffset(i));
+    }
+    std::sort(m_sortedOffsets.begin(), m_sortedOffsets.end());
+}
+
+// Destructor.
+server::file::ca::PackFile::~PackFile()
+{ }
+
+// Get base name.
+const String_t&
+server::file::ca::PackFile::getBaseName() const
+{
+    return m_baseName;
+}
+
+// Get number of objects in this pack.
+size_t
+server::file::ca::PackFile::getNumObjects() const
+{
+    return m_numObjects;
+}
+
+// Get Id of an object.
+server::file::ca::ObjectId
+server::file::ca::PackFile::getObjectId(size_t index) const
+{
+    ObjectId result = ObjectId::nil;
+    if (index < m_numObjects) {
+        std::memcpy(result.m_bytes, getIndexEntry(INDEX_HEADER_SIZE + ID_SIZE*index, ID_SIZE), ID_SIZE);
+    }
+    return result;
+}
+
+// Find an object.
+bool
+server::file::ca::PackFile::findObject(const ObjectId& id, size_t& index) const
+{
+    // Fan-out table limits the search range to objects with the same first byte
+    const uint8_t firstByte = id.m_bytes[0];
+    size_t lo = (firstByte == 0 ? 0 : getUInt32BE(getIndexEntry(8 + 4*(firstByte-1), 4)));
+    size_t hi = getUInt32BE(getIndexEntry(8 + 4*firstByte, 4));
+
+    // Binary search
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo)/2;
+        int cmp = std::memcmp(getIndexEntry(INDEX_HEADER_SIZE + ID_SIZE*mid, ID_SIZE), id.m_bytes, ID_SIZE);
+        if (cmp == 0) {
+            index = mid;
+            return true;
+        } else if (cmp < 0) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+    return false;
+}
+
+// Read an object.
+void
+server::file::ca::PackFile::readObject(size_t index, ObjectStore::Type& type, size_t& size, afl::base::GrowableBytes_t* pContent)
+{
+    afl::base::ConstBytes_t pack = getPackData();
+    const String_t name = getObjectId(index).toHex();
+
+    // Locate object. Its data ends where the next object (or the trailer) starts.
+    const size_t start = getObjectOffset(index);
+    std::vector<size_t>::const_iterator it = std::upper_bound(m_sortedOffsets.begin(), m_sortedOffsets.end(), start);
+    const size_t end = (it != m_sortedOffsets.end() ? *it : pack.size() - ID_SIZE);
+    if (start < sizeof(PACK_MAGIC)+4 || start >= end || end > pack.size() - ID_SIZE) {
+        throw afl::except::FileProblemException(name, BAD_PACK);
+    }
+    afl::base::ConstBytes_t data = pack.subrange(start, end - start);
+
+    // Object header: type in bits 4..6 of first byte, size in little-endian groups of 7 bits
+    const uint8_t* p = data.eat();
+    switch ((*p >> 4) & 7) {
+     case 1: type = ObjectStore::CommitObject; break;
+     case 2: type = ObjectStore::TreeObject;   break;
+     case 3: type = ObjectStore::DataObject;   break;
+     default: throw afl::except::FileProblemException(name, UNSUPPORTED_OBJECT);
+    }
+    size = *p & 15;
+    int shift = 4;
+    while ((*p & 0x80) != 0) {
+        p = data.eat();
+        if (p == 0 || shift > 24) {
+            // Limit to about 2G, same as loose objects
+            throw afl::except::FileProblemException(name, BAD_OBJECT_SIZE);
+        }
+        size += size_t(*p & 0x7F) << shift;
+        shift += 7;
+    }
+
+    // Content
+    if (pContent != 0) {
+        const size_t origSize = pContent->size();
+        pContent->reserve(origSize + size);
+
+        afl::io::InflateTransform tx(afl::io::InflateTransform::Zlib);
+        uint8_t uncompressedBuffer[4096];
+        while (!data.empty()) {
+            afl::base::Bytes_t uncompressedContent(uncompressedBuffer);
+            tx.transform(data, uncompressedContent);
+            pContent->append(uncompressedContent);
+        }
+
+        tx.flush();
+        while (1) {
+            afl::base::Bytes_t uncompressedContent(uncompressedBuffer);
+            tx.transform(data, uncompressedContent);
+            pContent->append(uncompressedContent);
+            if (uncompressedContent.empty()) {
+                break;
+            }
+        }
+
+        if (pContent->size() - origSize != size) {
+            throw afl::except::FileProblemException(name, BAD_OBJECT_CONTENT);
+        }
+    }
+}
+
+// Check whether pack data is loaded.
+bool
+server::file::ca::PackFile::isLoaded() const
+{
+    return m_pack.get() != 0;
+}
+
+// Release pack data.
+void
+server::file::ca::PackFile::unload()
+{
+    m_pack.reset();
+}
+
+/** Access index data.
+    \param offset Offset into index file
+    \param size Number of bytes required
+    \return pointer to data; never null
+    \throw afl::except::FileProblemException index too short */
+const uint8_t*
+server::file::ca::PackFile::getIndexEntry(size_t offset, size_t size) const
+{
+    afl::base::ConstBytes_t entry = m_index->get().subrange(offset, size);
+    if (entry.size() != size) {
+        throw afl::except::FileProblemException(m_baseName, BAD_INDEX);
+    }
+    return entry.unsafeData();
+}
+
+/** Get offset of an object within the pack file.
+    \param index Index [0,getNumObjects())
+    \return offset */
+size_t
+server::file::ca::PackFile::getObjectOffset(size_t index) const
+{
+    const size_t offsetTable = INDEX_HEADER_SIZE + (ID_SIZE + 4)*m_numObjects;
+    uint32_t value = getUInt32BE(getIndexEntry(offsetTable + 4*index, 4));
+    if ((value & 0x80000000U) == 0) {
+        return value;
+    } else {
+        // Large offset. We do not create these, but git might.
+        const uint8_t* p = getIndexEntry(offsetTable + 4*m_numObjects + 8*(value & 0x7FFFFFFFU), 8);
+        if (getUInt32BE(p) != 0) {
+            throw afl::except::FileProblemException(m_baseName, BAD_INDEX);
+        }
+        return getUInt32BE(p+4);
+    }
+}
+
+/** Get pack data, loading it if needed.
+    \return pack file content
+    \throw afl::except::FileProblemException pack cannot be read or has bad header */
+afl::base::ConstBytes_t
+server::file::ca::PackFile::getPackData()
+{
+    if (m_pack.get() == 0) {
+        afl::base::Ref<afl::io::FileMapping> pack = m_directory.getFileByName(m_baseName + ".pack");
+        afl::base::ConstBytes_t bytes = pack->get();
+        if (bytes.size() < sizeof(PACK_MAGIC) + 4 + ID_SIZE
+            || std::memcmp(bytes.unsafeData(), PACK_MAGIC, sizeof(PACK_MAGIC)) != 0
+            || getUInt32BE(bytes.unsafeData() + sizeof(PACK_MAGIC)) != m_numObjects)
+        {
+            throw afl::except::FileProblemException(m_baseName, BAD_PACK);
+        }
+        m_pack = pack.asPtr();
+    }
+    return m_pack->get();
+}
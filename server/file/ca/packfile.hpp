@@ -0,0 +1,113 @@
+/**
+  *  \file server/file/ca/packfile.hpp
+  *  \brief Class server::file::ca::PackFile
+  */
+#ifndef C2NG_SERVER_FILE_CA_PACKFILE_HPP
+#define C2NG_SERVER_FILE_CA_PACKFILE_HPP
+
+#include <vector>
+#include "afl/base/growablememory.hpp"
+#include "afl/base/ptr.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/io/filemapping.hpp"
+#include "server/file/ca/objectid.hpp"
+#include "server/file/ca/objectstore.hpp"
+#include "server/file/directoryhandler.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    /** Pack file, read access.
+        A pack file stores many objects in a single file, to avoid the per-file overhead of loose objects
+        (inode use, directory scans, one open() per cold read).
+
+        A pack consists of two files in the `objects/pack` directory:
+        - `pack-XXXX.pack`: the object data
+        - `pack-XXXX.idx`: the sorted index
+
+        Both use git's format (pack version 2, index version 2), restricted to non-delta objects.
+        Pack files are never modified once written; new objects go into new packs.
+        See PackBuilder for creating pack files.
+
+        The index is loaded when the PackFile is created; a lookup is a binary search within one fan-out slot.
+        The pack data is loaded on demand when the first object is read and can be released using unload().
+
+        <b>Estimate 20261016:</b>
+
+        For the "import hostfile data" data set (see InternalObjectCache):
+        - loose: 113772 objects = 113772 files in 256 directories
+        - packed (16 MB per pack): 615114k effective object data = approx. 38 packs = 76 files in 1 directory
+        - startup reads 38 index files (28 bytes per object, approx. 3 MB total) instead of listing 256 directories
+
+        Use testapps/benchpack to measure read times for loose and packed objects. */
+    class PackFile : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            Loads and validates the index.
+            \param dir      Directory containing the pack ("objects/pack")
+            \param baseName Base name of the pack ("pack-XXXX", without extension)
+            \throw afl::except::FileProblemException index cannot be read or is damaged */
+        PackFile(DirectoryHandler& dir, const String_t& baseName);
+
+        /** Destructor. */
+        ~PackFile();
+
+        /** Get base name.
+            \return base name, as given to constructor */
+        const String_t& getBaseName() const;
+
+        /** Get number of objects in this pack.
+            \return number of objects */
+        size_t getNumObjects() const;
+
+        /** Get Id of an object.
+            \param index Index [0,getNumObjects()); objects are sorted by Id
+            \return Object Id; ObjectId::nil if index is out of range */
+        ObjectId getObjectId(size_t index) const;
+
+        /** Find an object.
+            \param [in]  id    Object Id
+            \param [out] index Index of object
+            \retval true Object found, index has been set
+            \retval false Object not contained in this pack */
+        bool findObject(const ObjectId& id, size_t& index) const;
+
+        /** Read an object.
+            Loads the pack data if needed.
+            \param [in]  index    Index [0,getNumObjects())
+            \param [out] type     Object type
+            \param [out] size     Object payload size
+            \param [out] pContent If non-null, object payload is appended here
+            \throw afl::except::FileProblemException pack is damaged or contains an unsupported object */
+        void readObject(size_t index, ObjectStore::Type& type, size_t& size, afl::base::GrowableBytes_t* pContent);
+
+        /** Check whether pack data is loaded.
+            \return true if loaded */
+        bool isLoaded() const;
+
+        /** Release pack data.
+            The next readObject() will reload it. */
+        void unload();
+
+     private:
+        const uint8_t* getIndexEntry(size_t offset, size_t size) const;
+        size_t getObjectOffset(size_t index) const;
+        afl::base::ConstBytes_t getPackData();
+
+        DirectoryHandler& m_directory;
+        const String_t m_baseName;
+
+        // Index file content
+        afl::base::Ref<afl::io::FileMapping> m_index;
+        size_t m_numObjects;
+
+        // Pack file content; null if not loaded
+        afl::base::Ptr<afl::io::FileMapping> m_pack;
+
+        // Object offsets in ascending order, to determine each object's end
+        std::vector<size_t> m_sortedOffsets;
+    };
+
+} } }
+
+#endif
@@ -0,0 +1,407 @@
+/**
+  *  \file server/file/ca/persistentindex.cpp
+  *  \brief Class server::file::ca::PersistentIndex
+  */
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include "server/file/ca/persistentindex.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
+
+namespace {
+    const char*const HASH_COLLISION = "500 Hash collision";
+
+    const char*const SNAPSHOT_PREFIX = "index-";
+    const char*const LOG_PREFIX = "log-";
+
+    const uint8_t SNAPSHOT_MAGIC[] = { 'C', '2', 'I', 'X', 0, 0, 0, 1 };
+    const uint8_t LOG_MAGIC[] = { 'C', '2', 'I', 'L', 0, 0, 0, 1 };
+
+    /* File layout: magic (8 bytes), marker, record count (4 bytes), records, checksum */
+    const size_t ID_SIZE = sizeof(server::file::ca::ObjectId);
+    const size_t HEADER_SIZE = 8 + ID_SIZE + 4;
+    const size_t RECORD_SIZE = ID_SIZE + 4 + 4 + 1;
+
+    /* Entry flags: bit 7 = size is known, bits 0..1 = type */
+    const uint8_t HAS_SIZE = 0x80;
+    const uint8_t TYPE_MASK = 0x03;
+
+    /* Compact after this many log files */
+    const size_t MAX_LOG_FILES = 100;
+
+    uint32_t getUInt32BE(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 24) + (uint32_t(p[1]) << 16) + (uint32_t(p[2]) << 8) + uint32_t(p[3]);
+    }
+
+    void appendUInt32BE(afl::base::GrowableBytes_t& out, uint32_t value)
+    {
+        const uint8_t bytes[4] = { uint8_t(value >> 24), uint8_t(value >> 16), uint8_t(value >> 8), uint8_t(value) };
+        out.append(bytes);
+    }
+
+    void appendRecord(afl::base::GrowableBytes_t& out, const server::file::ca::ObjectId& id, int32_t refCount, uint32_t size, uint8_t flags)
+    {
+        out.append(id.m_bytes);
+        appendUInt32BE(out, uint32_t(refCount));
+        appendUInt32BE(out, size);
+        out.append(flags);
+    }
+
+    String_t makeFileName(const char* prefix, uint32_t sequence)
+    {
+        return afl::string::Format("%s%08d", prefix, sequence);
+    }
+
+    /* Parse a file name. Returns true if the name has the given prefix and a valid sequence number. */
+    bool parseFileName(const String_t& name, const char* prefix, uint32_t& sequence)
+    {
+        const size_t n = std::strlen(prefix);
+        return name.size() > n
+            && name.compare(0, n, prefix) == 0
+            && afl::string::strToInteger(name.substr(n), sequence)
+            && makeFileName(prefix, sequence) == name;
+    }
+
+    /* Collect names of index files */
+    class FileCollector : public server::file::DirectoryHandler::Callback {
+     public:
+        FileCollector(std::map<uint32_t, String_t>& snapshots, std::map<uint32_t, String_t>& logs)
+            : m_snapshots(snapshots), m_logs(logs)
+            { }
+        virtual void addItem(const server::file::DirectoryHandler::Info& info)
+            {
+                uint32_t seq;
+                if (info.type == server::file::DirectoryHandler::IsFile) {
+                    if (parseFileName(info.name, SNAPSHOT_PREFIX, seq)) {
+                        m_snapshots[seq] = info.name;
+                    } else if (parseFileName(info.name, LOG_PREFIX, seq)) {
+                        m_logs[seq] = info.name;
+                    }
+                }
+            }
+     private:
+        std::map<uint32_t, String_t>& m_snapshots;
+        std::map<uint32_t, String_t>& m_logs;
+    };
+}
+
+// Constructor.
+server::file::ca::PersistentIndex::PersistentIndex(DirectoryHandler& dir, const ObjectId& marker)
+    : m_directory(dir),
+      m_data(),
+      m_dirty(),
+      m_marker(ObjectId::nil),
+      m_nextSequence(1),
+      m_numLogFiles(0)
+{
+    load(marker);
+}
+
+// Destructor.
+server::file::ca::PersistentIndex::~PersistentIndex()
+{ }
+
+// Set reference counter.
+void
+server::file::ca::PersistentIndex::setReferenceCount(const ObjectId& id, int32_t value)
+{
+    Map_t::iterator it = m_data.insert(std::make_pair(id, Entry())).first;
+    it->second.refCount = value;
+    update(it);
+}
+
+// Modify reference counter.
+bool
+server::file::ca::PersistentIndex::modifyReferenceCount(const ObjectId& id, int32_t delta, int32_t& result)
+{
+    Map_t::iterator it = m_data.find(id);
+    if (it != m_data.end() && it->second.refCount != 0) {
+        // Same logic as InternalReferenceCounter: a count that reaches zero becomes unknown
+        it->second.refCount += delta;
+        result = it->second.refCount;
+        update(it);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Set object size.
+void
+server::file::ca::PersistentIndex::setObjectSize(const ObjectId& id, ObjectStore::Type type, size_t size)
+{
+    // Sizes beyond 32 bits are not stored; the ObjectStore does not produce those anyway.
+    if (uint32_t(size) == size) {
+        Map_t::iterator it = m_data.insert(std::make_pair(id, Entry())).first;
+        const uint8_t flags = uint8_t(HAS_SIZE | type);
+        if (it->second.flags != flags || it->second.size != size) {
+            it->second.flags = flags;
+            it->second.size = uint32_t(size);
+            update(it);
+        }
+    }
+}
+
+// Get object size.
+bool
+server::file::ca::PersistentIndex::getObjectSize(const ObjectId& id, ObjectStore::Type type, size_t& size)
+{
+    Map_t::const_iterator it = m_data.find(id);
+    if (it != m_data.end() && (it->second.flags & HAS_SIZE) != 0) {
+        if ((it->second.flags & TYPE_MASK) != type) {
+            throw afl::except::FileProblemException(id.toHex(), HASH_COLLISION);
+        }
+        size = it->second.size;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Remove object.
+void
+server::file::ca::PersistentIndex::removeObject(const ObjectId& id)
+{
+    Map_t::iterator it = m_data.find(id);
+    if (it != m_data.end()) {
+        it->second = Entry();
+        update(it);
+    }
+}
+
+// Write pending changes.
+void
+server::file::ca::PersistentIndex::commit(const ObjectId& marker)
+{
+    if (!m_dirty.empty() || marker != m_marker) {
+        afl::base::GrowableBytes_t records;
+        records.reserve(m_dirty.size() * RECORD_SIZE);
+        for (std::set<ObjectId>::const_iterator it = m_dirty.begin(); it != m_dirty.end(); ++it) {
+            Map_t::const_iterator e = m_data.find(*it);
+            const Entry entry = (e != m_data.end() ? e->second : Entry());
+            appendRecord(records, *it, entry.refCount, entry.size, entry.flags);
+        }
+        writeFile(makeFileName(LOG_PREFIX, m_nextSequence), LOG_MAGIC, marker, records, m_dirty.size());
+        ++m_nextSequence;
+        ++m_numLogFiles;
+        m_dirty.clear();
+        m_marker = marker;
+
+        if (m_numLogFiles >= MAX_LOG_FILES) {
+            compact(marker);
+        }
+    }
+}
+
+// Write a new snapshot.
+void
+server::file::ca::PersistentIndex::compact(const ObjectId& marker)
+{
+    afl::base::GrowableBytes_t records;
+    records.reserve(m_data.size() * RECORD_SIZE);
+    for (Map_t::const_iterator it = m_data.begin(); it != m_data.end(); ++it) {
+        appendRecord(records, it->first, it->second.refCount, it->second.size, it->second.flags);
+    }
+
+    const uint32_t seq = m_nextSequence++;
+    writeFile(makeFileName(SNAPSHOT_PREFIX, seq), SNAPSHOT_MAGIC, marker, records, m_data.size());
+    m_dirty.clear();
+    m_marker = marker;
+    m_numLogFiles = 0;
+    removeOldFiles(seq);
+}
+
+// Get number of known objects.
+size_t
+server::file::ca::PersistentIndex::getNumObjects() const
+{
+    return m_data.size();
+}
+
+// Get number of log files.
+size_t
+server::file::ca::PersistentIndex::getNumLogFiles() const
+{
+    return m_numLogFiles;
+}
+
+/** Load index.
+    Loads the newest valid snapshot and all following log files.
+    \param marker Id of current master commit */
+void
+server::file::ca::PersistentIndex::load(const ObjectId& marker)
+{
+    std::map<uint32_t, String_t> snapshots, logs;
+    FileCollector collector(snapshots, logs);
+    m_directory.readContent(collector);
+
+    // Next sequence number must be above everything that exists, even broken files
+    if (!snapshots.empty()) {
+        m_nextSequence = std::max(m_nextSequence, snapshots.rbegin()->first + 1);
+    }
+    if (!logs.empty()) {
+        m_nextSequence = std::max(m_nextSequence, logs.rbegin()->first + 1);
+    }
+
+    // Load newest valid snapshot. If there is no snapshot, start with an empty index.
+    // An empty index is consistent with an empty store, and harmless otherwise.
+    bool ok = true;
+    ObjectId fileMarker = ObjectId::nil;
+    uint32_t seq = 0;
+    for (std::map<uint32_t, String_t>::reverse_iterator it = snapshots.rbegin(); it != snapshots.rend(); ++it) {
+        if (loadFile(it->second, SNAPSHOT_MAGIC, fileMarker)) {
+            seq = it->first;
+            break;
+        }
+        ok = false;
+    }
+
+    // Apply logs, until a gap or broken file is found
+    for (std::map<uint32_t, String_t>::const_iterator it = logs.upper_bound(seq); it != logs.end(); ++it) {
+        if (it->first != seq+1 || !loadFile(it->second, LOG_MAGIC, fileMarker)) {
+            ok = false;
+            break;
+        }
+        seq = it->first;
+        ++m_numLogFiles;
+    }
+
+    // Validate reference counts
+    if (fileMarker != marker) {
+        Map_t::iterator it = m_data.begin();
+        while (it != m_data.end()) {
+            it->second.refCount = 0;
+            if (it->second.flags == 0) {
+                m_data.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+        ok = false;
+    }
+    m_marker = fileMarker;
+
+    // If anything was discarded, write a fresh snapshot so we start from a clean state
+    if (!ok) {
+        compact(marker);
+    }
+}
+
+/** Load a file and apply its records.
+    The file is validated completely before any record is applied.
+    \param [in]  name   File name
+    \param [in]  magic  Expected magic number
+    \param [out] marker Marker from file
+    \retval true File loaded successfully
+    \retval false File cannot be read or is damaged */
+bool
+server::file::ca::PersistentIndex::loadFile(const String_t& name, afl::base::ConstBytes_t magic, ObjectId& marker)
+{
+    afl::base::Ptr<afl::io::FileMapping> map;
+    try {
+        map = m_directory.getFileByName(name).asPtr();
+    }
+    catch (std::exception&) {
+        return false;
+    }
+    afl::base::ConstBytes_t data = map->get();
+
+    // Header
+    if (data.size() < HEADER_SIZE + ID_SIZE || !data.subrange(0, magic.size()).equalContent(magic)) {
+        return false;
+    }
+    const size_t numRecords = getUInt32BE(data.unsafeData() + 8 + ID_SIZE);
+    if ((data.size() - HEADER_SIZE - ID_SIZE) / RECORD_SIZE != numRecords
+        || (data.size() - HEADER_SIZE - ID_SIZE) % RECORD_SIZE != 0)
+    {
+        return false;
+    }
+
+    // Checksum
+    afl::checksums::SHA1 hash;
+    hash.add(data.subrange(0, data.size() - ID_SIZE));
+    const ObjectId checksum = ObjectId::fromHash(hash);
+    if (!data.subrange(data.size() - ID_SIZE).equalContent(afl::base::ConstBytes_t(checksum.m_bytes))) {
+        return false;
+    }
+
+    // Apply records
+    std::memcpy(marker.m_bytes, data.unsafeData() + 8, ID_SIZE);
+    const uint8_t* p = data.unsafeData() + HEADER_SIZE;
+    for (size_t i = 0; i < numRecords; ++i, p += RECORD_SIZE) {
+        ObjectId id;
+        std::memcpy(id.m_bytes, p, ID_SIZE);
+
+        Entry e;
+        e.refCount = int32_t(getUInt32BE(p + ID_SIZE));
+        e.size = getUInt32BE(p + ID_SIZE + 4);
+        e.flags = p[ID_SIZE + 8];
+        if (e.refCount == 0 && e.flags == 0) {
+            m_data.erase(id);
+        } else {
+            m_data[id] = e;
+        }
+    }
+    return true;
+}
+
+/** Write a file.
+    \param name       File name
+    \param magic      Magic number
+    \param marker     Marker
+    \param records    Records
+    \param numRecords Number of records */
+void
+server::file::ca::PersistentIndex::writeFile(const String_t& name, afl::base::ConstBytes_t magic, const ObjectId& marker, afl::base::ConstBytes_t records, size_t numRecords)
+{
+    afl::base::GrowableBytes_t out;
+    out.reserve(HEADER_SIZE + records.size() + ID_SIZE);
+    out.append(magic);
+    out.append(marker.m_bytes);
+    appendUInt32BE(out, uint32_t(numRecords));
+    out.append(records);
+
+    afl::checksums::SHA1 hash;
+    hash.add(out);
+    const ObjectId checksum = ObjectId::fromHash(hash);
+    out.append(checksum.m_bytes);
+
+    m_directory.createFile(name, out);
+}
+
+/** Remove old files.
+    Removes all snapshot and log files other than the given snapshot.
+    \param sequence Sequence number of snapshot to keep */
+void
+server::file::ca::PersistentIndex::removeOldFiles(uint32_t sequence)
+{
+    std::map<uint32_t, String_t> snapshots, logs;
+    FileCollector collector(snapshots, logs);
+    m_directory.readContent(collector);
+
+    snapshots.erase(sequence);
+    for (std::map<uint32_t, String_t>::const_iterator it = snapshots.begin(); it != snapshots.end(); ++it) {
+        m_directory.removeFile(it->second);
+    }
+    for (std::map<uint32_t, String_t>::const_iterator it = logs.begin(); it != logs.end(); ++it) {
+        m_directory.removeFile(it->second);
+    }
+}
+
+/** Process update of an entry.
+    Marks the entry for the next commit(), and drops it from memory if it is empty.
+    \param it Entry */
+void
+server::file::ca::PersistentIndex::update(Map_t::iterator it)
+{
+    m_dirty.insert(it->first);
+    if (it->second.refCount == 0 && it->second.flags == 0) {
+        m_data.erase(it);
+    }
+}
@@ -0,0 +1,150 @@
+/**
+  *  \file server/file/ca/persistentindex.hpp
+  *  \brief Class server::file::ca::PersistentIndex
+  */
+#ifndef C2NG_SERVER_FILE_CA_PERSISTENTINDEX_HPP
+#define C2NG_SERVER_FILE_CA_PERSISTENTINDEX_HPP
+
+#include <map>
+#include <set>
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "server/file/ca/objectid.hpp"
+#include "server/file/ca/objectstore.hpp"
+#include "server/file/directoryhandler.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    /** Persistent object index.
+        Stores reference counts and object sizes on disk, so they survive a restart of the service.
+        Use with PersistentReferenceCounter and PersistentObjectCache.
+
+        <b>Storage:</b>
+
+        The index lives in its own directory and consists of
+        - a snapshot file `index-NNNNNNNN`: all entries, sorted by ObjectId;
+        - log files `log-NNNNNNNN`: changes since the snapshot, one file per commit().
+
+        Each file contains a header, the marker (Id of the master commit the state corresponds to),
+        fixed-size records, and a SHA-1 checksum. A file with bad checksum (interrupted write) ends the log.
+        When enough log files accumulate, they are merged into a new snapshot (compact()),
+        which is written before the files it replaces are removed.
+
+        All entries are kept in memory; the files are only read on startup.
+
+        <b>Consistency:</b>
+
+        Object sizes never change for a given ObjectId and therefore are always valid.
+        Reference counts are only valid if they correspond to the current master commit.
+        If the marker does not match the master commit given to the constructor
+        (e.g. service stopped after writing a commit but before updating the index),
+        all reference counts are discarded.
+        As with InternalReferenceCounter, an object without reference count is never deleted;
+        the GarbageCollector will eventually clean up.
+
+        <b>Estimate 20261016:</b>
+
+        For the "import hostfile data" data set (see InternalReferenceCounter):
+        113772 objects x 29 bytes = approx. 3.2 MB snapshot.
+        With the index loaded, computing directory sizes (DirectoryItem::computeTotals) needs to read only the tree objects,
+        no longer one header per file; see InternalObjectCache for the effect of the size cache. */
+    class PersistentIndex : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            Loads the index.
+            \param dir    Directory containing the index
+            \param marker Id of current master commit
+            \throw afl::except::FileProblemException on I/O errors */
+        PersistentIndex(DirectoryHandler& dir, const ObjectId& marker);
+
+        /** Destructor.
+            Does not write anything; call commit() before. */
+        ~PersistentIndex();
+
+        /** Set reference counter.
+            \param id Object Id
+            \param value New value */
+        void setReferenceCount(const ObjectId& id, int32_t value);
+
+        /** Modify reference counter.
+            \param id [in] Object Id
+            \param delta [in] Value to add to reference counter
+            \param result [out] New value of reference counter
+            \retval true Operation succeeded, \c result has been set
+            \retval false Reference count not known, \c result has not been set
+            \see ReferenceCounter::modify */
+        bool modifyReferenceCount(const ObjectId& id, int32_t delta, int32_t& result);
+
+        /** Set object size.
+            \param id Object Id
+            \param type Object type
+            \param size Object size */
+        void setObjectSize(const ObjectId& id, ObjectStore::Type type, size_t size);
+
+        /** Get object size.
+            \param [in]  id   Object Id
+            \param [in]  type Object type
+            \param [out] size Object size
+            \retval true Size known, \c size has been set
+            \retval false Size not known
+            \throw afl::except::FileProblemException object is known with a different type (hash collision) */
+        bool getObjectSize(const ObjectId& id, ObjectStore::Type type, size_t& size);
+
+        /** Remove object.
+            Call when the object is destroyed.
+            \param id Object Id */
+        void removeObject(const ObjectId& id);
+
+        /** Write pending changes.
+            Writes a new log file containing all changes since the last commit() and the given marker.
+            Compacts the index if enough log files have accumulated.
+            \param marker Id of current master commit */
+        void commit(const ObjectId& marker);
+
+        /** Write a new snapshot.
+            Writes all entries into a new snapshot file, and removes the previous snapshot and log files.
+            \param marker Id of current master commit */
+        void compact(const ObjectId& marker);
+
+        /** Get number of known objects.
+            \return number of objects that have a reference count or a size */
+        size_t getNumObjects() const;
+
+        /** Get number of log files.
+            \return number of log files since last snapshot */
+        size_t getNumLogFiles() const;
+
+     private:
+        struct Entry {
+            int32_t refCount;           // 0 = unknown
+            uint32_t size;
+            uint8_t flags;              // HasSize + type
+            Entry()
+                : refCount(0), size(0), flags(0)
+                { }
+        };
+        typedef std::map<ObjectId, Entry> Map_t;
+
+        void load(const ObjectId& marker);
+        bool loadFile(const String_t& name, afl::base::ConstBytes_t magic, ObjectId& marker);
+        void writeFile(const String_t& name, afl::base::ConstBytes_t magic, const ObjectId& marker, afl::base::ConstBytes_t records, size_t numRecords);
+        void removeOldFiles(uint32_t sequence);
+        void update(Map_t::iterator it);
+
+        DirectoryHandler& m_directory;
+        Map_t m_data;
+        std::set<ObjectId> m_dirty;
+
+        // Marker written last
+        ObjectId m_marker;
+
+        // Sequence number of next file
+        uint32_t m_nextSequence;
+
+        // Number of log files since snapshot
+        size_t m_numLogFiles;
+    };
+
+} } }
+
+#endif
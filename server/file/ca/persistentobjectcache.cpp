@@ -0,0 +1,59 @@
+/**
+  *  \file server/file/ca/persistentobjectcache.cpp
+  *  \brief Class server::file::ca::PersistentObjectCache
+  */
+
+#include "server/file/ca/persistentobjectcache.hpp"
+#include "server/file/ca/persistentindex.hpp"
+
+server::file::ca::PersistentObjectCache::PersistentObjectCache(PersistentIndex& index)
+    : m_index(index),
+      m_content()
+{ }
+
+server::file::ca::PersistentObjectCache::~PersistentObjectCache()
+{ }
+
+server::file::ca::InternalObjectCache&
+server::file::ca::PersistentObjectCache::contentCache()
+{
+    return m_content;
+}
+
+void
+server::file::ca::PersistentObjectCache::addObject(const ObjectId& id, ObjectStore::Type type, afl::base::Ref<afl::io::FileMapping> content)
+{
+    m_index.setObjectSize(id, type, content->get().size());
+    m_content.addObject(id, type, content);
+}
+
+void
+server::file::ca::PersistentObjectCache::addObjectSize(const ObjectId& id, ObjectStore::Type type, size_t size)
+{
+    // Sizes are not passed to m_content; m_index is authoritative for those.
+    m_index.setObjectSize(id, type, size);
+}
+
+void
+server::file::ca::PersistentObjectCache::removeObject(const ObjectId& id)
+{
+    m_index.removeObject(id);
+    m_content.removeObject(id);
+}
+
+afl::base::Ptr<afl::io::FileMapping>
+server::file::ca::PersistentObjectCache::getObject(const ObjectId& id, ObjectStore::Type type)
+{
+    return m_content.getObject(id, type);
+}
+
+afl::base::Optional<size_t>
+server::file::ca::PersistentObjectCache::getObjectSize(const ObjectId& id, ObjectStore::Type type)
+{
+    size_t size;
+    if (m_index.getObjectSize(id, type, size)) {
+        return size;
+    } else {
+        return m_content.getObjectSize(id, type);
+    }
+}
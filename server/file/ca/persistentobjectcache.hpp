@@ -0,0 +1,46 @@
+/**
+  *  \file server/file/ca/persistentobjectcache.hpp
+  *  \brief Class server::file::ca::PersistentObjectCache
+  */
+#ifndef C2NG_SERVER_FILE_CA_PERSISTENTOBJECTCACHE_HPP
+#define C2NG_SERVER_FILE_CA_PERSISTENTOBJECTCACHE_HPP
+
+#include "server/file/ca/objectcache.hpp"
+#include "server/file/ca/internalobjectcache.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    class PersistentIndex;
+
+    /** Persistent object cache.
+        Stores object sizes in a PersistentIndex, so they survive a restart of the service.
+        Object content is cached in memory, using an InternalObjectCache. */
+    class PersistentObjectCache : public ObjectCache {
+     public:
+        /** Constructor.
+            \param index PersistentIndex. Must out-live the PersistentObjectCache. */
+        explicit PersistentObjectCache(PersistentIndex& index);
+
+        /** Destructor. */
+        ~PersistentObjectCache();
+
+        /** Access content cache.
+            Use to configure limits.
+            \return InternalObjectCache instance */
+        InternalObjectCache& contentCache();
+
+        // ObjectCache:
+        virtual void addObject(const ObjectId& id, ObjectStore::Type type, afl::base::Ref<afl::io::FileMapping> content);
+        virtual void addObjectSize(const ObjectId& id, ObjectStore::Type type, size_t size);
+        virtual void removeObject(const ObjectId& id);
+        virtual afl::base::Ptr<afl::io::FileMapping> getObject(const ObjectId& id, ObjectStore::Type type);
+        virtual afl::base::Optional<size_t> getObjectSize(const ObjectId& id, ObjectStore::Type type);
+
+     private:
+        PersistentIndex& m_index;
+        InternalObjectCache m_content;
+    };
+
+} } }
+
+#endif
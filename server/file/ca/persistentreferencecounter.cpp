@@ -0,0 +1,23 @@
+/**
+  *  \file server/file/ca/persistentreferencecounter.cpp
+  *  \brief Class server::file::ca::PersistentReferenceCounter
+  */
+
+#include "server/file/ca/persistentreferencecounter.hpp"
+#include "server/file/ca/persistentindex.hpp"
+
+server::file::ca::PersistentReferenceCounter::PersistentReferenceCounter(PersistentIndex& index)
+    : m_index(index)
+{ }
+
+void
+server::file::ca::PersistentReferenceCounter::set(const ObjectId& id, int32_t value)
+{
+    m_index.setReferenceCount(id, value);
+}
+
+bool
+server::file::ca::PersistentReferenceCounter::modify(const ObjectId& id, int32_t delta, int32_t& result)
+{
+    return m_index.modifyReferenceCount(id, delta, result);
+}
@@ -0,0 +1,33 @@
+/**
+  *  \file server/file/ca/persistentreferencecounter.hpp
+  *  \brief Class server::file::ca::PersistentReferenceCounter
+  */
+#ifndef C2NG_SERVER_FILE_CA_PERSISTENTREFERENCECOUNTER_HPP
+#define C2NG_SERVER_FILE_CA_PERSISTENTREFERENCECOUNTER_HPP
+
+#include "server/file/ca/referencecounter.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    class PersistentIndex;
+
+    /** Persistent reference counter.
+        Stores reference counts in a PersistentIndex, so they survive a restart of the service.
+        Otherwise, behaves like InternalReferenceCounter. */
+    class PersistentReferenceCounter : public ReferenceCounter {
+     public:
+        /** Constructor.
+            \param index PersistentIndex. Must out-live the PersistentReferenceCounter. */
+        explicit PersistentReferenceCounter(PersistentIndex& index);
+
+        // ReferenceCounter:
+        virtual void set(const ObjectId& id, int32_t value);
+        virtual bool modify(const ObjectId& id, int32_t delta, int32_t& result);
+
+     private:
+        PersistentIndex& m_index;
+    };
+
+} } }
+
+#endif
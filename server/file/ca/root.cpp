@@ -3,14 +3,24 @@
   *  \brief Class server::file::ca::Root
   */
 
+#include <stdexcept>
 #include "server/file/ca/root.hpp"
 #include "server/file/ca/commit.hpp"
 #include "server/file/ca/directoryhandler.hpp"
 #include "server/file/ca/objectid.hpp"
 #include "server/file/ca/objectstore.hpp"
+#include "server/file/ca/persistentindex.hpp"
+#include "server/file/ca/persistentobjectcache.hpp"
+#include "server/file/ca/persistentreferencecounter.hpp"
 #include "server/file/directoryhandler.hpp"
 
 namespace {
+    /* Name of directory containing the PersistentIndex */
+    const char*const INDEX_DIRECTORY = "c2index";
+
+    /* In deferred mode, save automatically when this many objects are pending */
+    const size_t MAX_PENDING_OBJECTS = 10000;
+
     server::file::DirectoryHandler* getCreateDirectory(server::file::DirectoryHandler& parent, String_t name)
     {
         server::file::DirectoryHandler::Info info;
@@ -23,34 +33,75 @@ namespace {
 
 /*
  *  RootUpdater: create a commit and rewrite the `refs/heads/master` file
+ *
+ *  In deferred mode, the commit is only recorded; save() writes it.
+ *  Until then, the commit that is in `refs/heads/master` remains linked,
+ *  so that nothing it refers to is deleted before the new commit is on disk.
  */
 
 class server::file::ca::Root::RootUpdater : public server::file::ca::ReferenceUpdater {
  public:
     RootUpdater(Root& parent, const ObjectId& commitId)
         : m_parent(parent),
-          m_commitId(commitId)
+          m_commitId(commitId),
+          m_savedCommitId(commitId)
         { }
 
     virtual void updateDirectoryReference(const String_t& /*name*/, const ObjectId& newId)
         {
+            // Save updates of another root handler first
+            if (m_parent.m_pendingUpdater.get() != 0 && m_parent.m_pendingUpdater.get() != this) {
+                m_parent.flush();
+            }
+
             // Create a commit that points to this reference
             afl::base::GrowableMemory<uint8_t> out;
             server::file::ca::Commit(newId).store(out);
             ObjectId commitId = m_parent.m_store->addObject(ObjectStore::CommitObject, out);
 
-            // Update master
-            String_t id = commitId.toHex();
-            id += '\n';
-            m_parent.m_refsHeads->createFile("master", afl::string::toBytes(id));
-
-            // Update link count
-            m_parent.m_store->unlinkObject(ObjectStore::CommitObject, m_commitId);
+            // Update link count.
+            // The saved commit keeps its link until save(); a superseded unsaved commit is dropped.
+            if (m_commitId != m_savedCommitId) {
+                m_parent.m_store->unlinkObject(ObjectStore::CommitObject, m_commitId);
+            }
+            if (commitId == m_savedCommitId) {
+                m_parent.m_store->unlinkObject(ObjectStore::CommitObject, commitId);
+            }
             m_commitId = commitId;
+
+            if (!m_parent.m_deferredUpdates || m_parent.m_store->getNumPendingObjects() >= MAX_PENDING_OBJECTS) {
+                save();
+                m_parent.m_pendingUpdater.reset();
+            } else {
+                m_parent.m_pendingUpdater = this;
+            }
+        }
+
+    void save()
+        {
+            // Write objects first, so master never refers to an object that is not on disk
+            m_parent.m_store->flush();
+
+            if (m_commitId != m_savedCommitId) {
+                // Update master
+                String_t id = m_commitId.toHex();
+                id += '\n';
+                m_parent.m_refsHeads->createFile("master", afl::string::toBytes(id));
+
+                // Update link count
+                m_parent.m_store->unlinkObject(ObjectStore::CommitObject, m_savedCommitId);
+                m_savedCommitId = m_commitId;
+            }
+
+            // Persist reference counts that correspond to the new master
+            if (m_parent.m_index.get() != 0) {
+                m_parent.m_index->commit(m_commitId);
+            }
         }
  private:
     Root& m_parent;
     ObjectId m_commitId;
+    ObjectId m_savedCommitId;
 };
 
 /*
@@ -63,14 +114,29 @@ server::file::ca::Root::Root(server::file::DirectoryHandler& root)
       m_refs(),
       m_refsHeads(),
       m_objects(),
-      m_store()
+      m_indexDirectory(),
+      m_index(),
+      m_store(),
+      m_deferredUpdates(false),
+      m_pendingUpdater()
 {
     init();
 }
 
 // Destructor.
 server::file::ca::Root::~Root()
-{ }
+{
+    // Save pending updates, and cached sizes obtained since the last commit
+    try {
+        flush();
+        if (m_index.get() != 0) {
+            m_index->commit(getMasterCommitId());
+        }
+    }
+    catch (std::exception&) {
+        // Ignore; worst case is that the last updates are lost and reference counts are discarded on next start
+    }
+}
 
 // Get ObjectId of the `master` commit.
 server::file::ca::ObjectId
@@ -115,6 +181,39 @@ server::file::ca::Root::objectStore()
     return *m_store;
 }
 
+// Enable persistent index.
+void
+server::file::ca::Root::enablePersistentIndex()
+{
+    if (m_index.get() == 0) {
+        m_indexDirectory.reset(getCreateDirectory(m_root, INDEX_DIRECTORY));
+        m_index.reset(new PersistentIndex(*m_indexDirectory, getMasterCommitId()));
+        m_store->setReferenceCounter(std::auto_ptr<ReferenceCounter>(new PersistentReferenceCounter(*m_index)));
+        m_store->setObjectCache(std::auto_ptr<ObjectCache>(new PersistentObjectCache(*m_index)));
+    }
+}
+
+// Set deferred update mode.
+void
+server::file::ca::Root::setDeferredUpdates(bool enable)
+{
+    m_deferredUpdates = enable;
+    m_store->setDeferredWrite(enable);
+    if (!enable) {
+        flush();
+    }
+}
+
+// Save deferred updates.
+void
+server::file::ca::Root::flush()
+{
+    if (m_pendingUpdater.get() != 0) {
+        m_pendingUpdater->save();
+        m_pendingUpdater.reset();
+    }
+}
+
 // Initialize.
 void
 server::file::ca::Root::init()
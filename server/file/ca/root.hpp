@@ -7,17 +7,21 @@
 
 #include <memory>
 #include "afl/base/deletable.hpp"
+#include "afl/base/ptr.hpp"
 #include "server/file/ca/objectid.hpp"
 #include "server/file/directoryhandler.hpp"
 
 namespace server { namespace file { namespace ca {
 
     class ObjectStore;
+    class PersistentIndex;
 
     /** Root of a content-addressable file store.
         Implements bootstrapping of a file store in a git-compatible way:
         - create the ObjectStore on directory `objects`
-        - create the `HEAD` and `refs/heads/master` metadata files */
+        - create the `HEAD` and `refs/heads/master` metadata files
+
+        Optionally, reference counts and object sizes can be kept in a PersistentIndex in directory `c2index`. */
     class Root : public afl::base::Deletable {
      public:
         /** Constructor.
@@ -42,6 +46,28 @@ namespace server { namespace file { namespace ca {
             @return ObjectStore instance */
         ObjectStore& objectStore();
 
+        /** Enable persistent index.
+            Loads the PersistentIndex and makes the ObjectStore use it for reference counts and object sizes.
+            The index is updated whenever the `master` commit changes, and when the Root is destroyed.
+            Call directly after construction, before modifying anything. */
+        void enablePersistentIndex();
+
+        /** Set deferred update mode.
+            In deferred update mode, changes are kept in memory and written by flush()
+            (see ObjectStore::setDeferredWrite()).
+            Updating many files in a directory then writes each tree and the commit only once per flush().
+            Until flush(), `refs/heads/master` and all objects it refers to remain unchanged,
+            so an interrupted service loses the unsaved changes but leaves a consistent store.
+            To limit memory usage, changes are also saved when many objects are pending.
+            @param enable true to enable deferred mode; false to disable (this saves pending changes) */
+        void setDeferredUpdates(bool enable);
+
+        /** Save deferred updates.
+            Writes pending objects, then updates `refs/heads/master`.
+            No-op if nothing is pending.
+            @throw afl::except::FileProblemException on errors; changes remain pending and can be saved again */
+        void flush();
+
      private:
         /** Implementation of ReferenceUpdater for root directory */
         class RootUpdater;
@@ -61,8 +87,21 @@ namespace server { namespace file { namespace ca {
         /** Directory m_root/objects. */
         std::auto_ptr<server::file::DirectoryHandler> m_objects;
 
+        /** Directory m_root/c2index. Null if persistent index is not enabled. */
+        std::auto_ptr<server::file::DirectoryHandler> m_indexDirectory;
+
+        /** PersistentIndex instance. Null if persistent index is not enabled.
+            Declared before m_store, so it out-lives the ObjectStore which refers to it. */
+        std::auto_ptr<PersistentIndex> m_index;
+
         /** ObjectStore instance. Never null during lifetime of this object. */
         std::auto_ptr<ObjectStore> m_store;
+
+        /** Deferred update mode. */
+        bool m_deferredUpdates;
+
+        /** RootUpdater that has unsaved changes. Null if none. */
+        afl::base::Ptr<RootUpdater> m_pendingUpdater;
     };
 
 } } }
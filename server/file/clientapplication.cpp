@@ -12,6 +12,7 @@
 #include "afl/string/format.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
 #include "server/file/ca/garbagecollector.hpp"
+#include "server/file/ca/objectstore.hpp"
 #include "server/file/ca/root.hpp"
 #include "server/file/directoryhandler.hpp"
 #include "server/file/directoryhandlerfactory.hpp"
@@ -69,6 +70,8 @@ server::file::ClientApplication::appMain()
         doServe(commandLine);
     } else if (*pCommand == "gc") {
         doGC(commandLine);
+    } else if (*pCommand == "repack") {
+        doRepack(commandLine);
     } else {
         errorExit(afl::string::Format(tx("invalid command '%s'. Use '%s -h' for help.").c_str(), *pCommand, environment().getInvocationName()));
     }
@@ -79,6 +82,7 @@ server::file::ClientApplication::doCopy(afl::sys::CommandLineParser& cmdl)
 {
     afl::string::Translator& tx = translator();
     DirectoryHandlerFactory dhf(fileSystem(), networkStack());
+    dhf.setDeferredUpdates(true);
     ReadOnlyDirectoryHandler* in = 0;
     DirectoryHandler* out = 0;
     CopyFlags_t flags;
@@ -109,6 +113,7 @@ server::file::ClientApplication::doCopy(afl::sys::CommandLineParser& cmdl)
     }
 
     copyDirectory(*out, *in, flags);
+    dhf.flush();
 }
 
 void
@@ -116,6 +121,7 @@ server::file::ClientApplication::doSync(afl::sys::CommandLineParser& cmdl)
 {
     afl::string::Translator& tx = translator();
     DirectoryHandlerFactory dhf(fileSystem(), networkStack());
+    dhf.setDeferredUpdates(true);
     ReadOnlyDirectoryHandler* in = 0;
     DirectoryHandler* out = 0;
     String_t p;
@@ -143,6 +149,7 @@ server::file::ClientApplication::doSync(afl::sys::CommandLineParser& cmdl)
     }
 
     synchronizeDirectories(*out, *in);
+    dhf.flush();
 }
 
 void
@@ -374,6 +381,41 @@ server::file::ClientApplication::doGC(afl::sys::CommandLineParser& cmdl)
     }
 }
 
+void
+server::file::ClientApplication::doRepack(afl::sys::CommandLineParser& cmdl)
+{
+    // Parse parameters
+    afl::string::Translator& tx = translator();
+    afl::base::Optional<String_t> dir;
+
+    String_t p;
+    bool opt;
+    while (cmdl.getNext(opt, p)) {
+        if (opt) {
+            errorExit(afl::string::Format(tx("invalid option specified. Use '%s -h' for help.").c_str(), environment().getInvocationName()));
+        } else if (!dir.isValid()) {
+            dir = p;
+        } else {
+            errorExit(afl::string::Format(tx("too many parameters. Use '%s -h' for help.").c_str(), environment().getInvocationName()));
+        }
+    }
+
+    const String_t* pDir = dir.get();
+    if (pDir == 0) {
+        errorExit(afl::string::Format(tx("too few parameters. Use '%s -h' for help.").c_str(), environment().getInvocationName()));
+    }
+
+    // Objects
+    // (Intentionally do not use DirectoryHandlerFactory; we don't want to use 'ca:DIR' here.)
+    FileSystemHandler handler(fileSystem(), *pDir);
+    server::file::ca::Root root(handler);
+
+    // Do it!
+    size_t n = root.objectStore().repack();
+    standardOutput().writeLine(afl::string::Format("Total objects packed: %d", n));
+    standardOutput().writeLine(afl::string::Format("Total packs: %d", root.objectStore().getNumPacks()));
+}
+
 void
 server::file::ClientApplication::help()
 {
@@ -398,6 +440,8 @@ server::file::ClientApplication::help()
                                          "                      Serve SOURCE via HTTP for testing\n"
                                          "  %$0s gc [-n] [-f] PATH\n"
                                          "                      Garbage-collect a CA file system\n"
+                                         "  %$0s repack PATH\n"
+                                         "                      Merge loose objects of a CA file system into pack files\n"
                                          "\n"
                                          "Command Options:\n"
                                          "  -f                  Force garbage-collection even on error\n"
@@ -5,6 +5,7 @@
 
 #include "server/file/clientdirectoryhandler.hpp"
 #include "server/interface/filebaseclient.hpp"
+#include "afl/data/stringlist.hpp"
 #include "afl/io/constmemorystream.hpp"
 #include "afl/io/internalfilemapping.hpp"
 #include "afl/net/reconnectable.hpp"
@@ -29,7 +30,8 @@ namespace {
 // Constructor.
 server::file::ClientDirectoryHandler::ClientDirectoryHandler(afl::net::CommandHandler& commandHandler, String_t basePath)
     : m_commandHandler(commandHandler),
-      m_basePath(basePath)
+      m_basePath(basePath),
+      m_prefetchedFiles()
 { }
 
 String_t
@@ -47,7 +49,14 @@ server::file::ClientDirectoryHandler::getFile(const Info& info)
 afl::base::Ref<afl::io::FileMapping>
 server::file::ClientDirectoryHandler::getFileByName(String_t name)
 {
-    String_t fileContent = FileBaseClient(m_commandHandler).getFile(makePath(name));
+    String_t fileContent;
+    std::map<String_t, String_t>::iterator it = m_prefetchedFiles.find(name);
+    if (it != m_prefetchedFiles.end()) {
+        fileContent.swap(it->second);
+        m_prefetchedFiles.erase(it);
+    } else {
+        fileContent = FileBaseClient(m_commandHandler).getFile(makePath(name));
+    }
     afl::io::ConstMemoryStream stream(afl::string::toBytes(fileContent));
     return *new afl::io::InternalFileMapping(stream);
 }
@@ -55,6 +64,7 @@ server::file::ClientDirectoryHandler::getFileByName(String_t name)
 server::file::DirectoryHandler::Info
 server::file::ClientDirectoryHandler::createFile(String_t name, afl::base::ConstBytes_t content)
 {
+    m_prefetchedFiles.erase(name);
     FileBaseClient(m_commandHandler).putFile(makePath(name), afl::string::fromBytes(content));
 
     // FIXME: this Info structure is synthetic. Server should normally supply it
@@ -66,6 +76,7 @@ server::file::ClientDirectoryHandler::createFile(String_t name, afl::base::Const
 void
 server::file::ClientDirectoryHandler::removeFile(String_t name)
 {
+    m_prefetchedFiles.erase(name);
     FileBaseClient(m_commandHandler).removeFile(makePath(name));
 }
 
@@ -127,6 +138,44 @@ server::file::ClientDirectoryHandler::copyFile(ReadOnlyDirectoryHandler& source,
     }
 }
 
+// Prefetch files.
+void
+server::file::ClientDirectoryHandler::prefetchFiles(afl::base::Memory<const String_t> names)
+{
+    afl::data::StringList_t paths;
+    afl::base::Memory<const String_t> it = names;
+    while (const String_t* p = it.eat()) {
+        paths.push_back(makePath(*p));
+    }
+
+    afl::data::StringList_t contents;
+    try {
+        FileBaseClient(m_commandHandler).getMultipleFiles(paths, contents);
+    }
+    catch (std::exception&) {
+        // Ignore; getFile() will report the error
+        return;
+    }
+
+    for (size_t i = 0, n = contents.size(); i < n; ++i) {
+        if (const String_t* p = names.at(i)) {
+            m_prefetchedFiles[*p].swap(contents[i]);
+        }
+    }
+}
+
+// Create multiple files.
+void
+server::file::ClientDirectoryHandler::createFiles(afl::base::Memory<const String_t> names, afl::base::Memory<const String_t> contents)
+{
+    afl::data::StringList_t paths;
+    while (const String_t* p = names.eat()) {
+        paths.push_back(makePath(*p));
+        m_prefetchedFiles.erase(*p);
+    }
+    FileBaseClient(m_commandHandler).putMultipleFiles(paths, contents);
+}
+
 String_t
 server::file::ClientDirectoryHandler::makePath(String_t userPath)
 {
@@ -5,7 +5,9 @@
 #ifndef C2NG_SERVER_FILE_CLIENTDIRECTORYHANDLER_HPP
 #define C2NG_SERVER_FILE_CLIENTDIRECTORYHANDLER_HPP
 
+#include <map>
 #include "server/file/directoryhandler.hpp"
+#include "afl/base/memory.hpp"
 #include "afl/net/commandhandler.hpp"
 
 namespace server { namespace file {
@@ -40,11 +42,26 @@ namespace server { namespace file {
         virtual void removeDirectory(String_t name);
         virtual afl::base::Optional<Info> copyFile(ReadOnlyDirectoryHandler& source, const Info& sourceInfo, String_t name);
 
+        /** Prefetch files.
+            Retrieves the given files in one batch (see FileBaseClient::getMultipleFiles()),
+            and keeps their content until it is requested using getFile() or getFileByName().
+            Each prefetched content is handed out once.
+            If prefetching fails, it is silently ignored; the files are then retrieved (and errors reported) normally.
+            \param names File names */
+        void prefetchFiles(afl::base::Memory<const String_t> names);
+
+        /** Create multiple files.
+            Stores the given files in one batch (see FileBaseClient::putMultipleFiles()).
+            \param names    File names
+            \param contents File contents, one per file name */
+        void createFiles(afl::base::Memory<const String_t> names, afl::base::Memory<const String_t> contents);
+
      private:
         String_t makePath(String_t userPath);
 
         afl::net::CommandHandler& m_commandHandler;
         const String_t m_basePath;
+        std::map<String_t, String_t> m_prefetchedFiles;
     };
 
 } }
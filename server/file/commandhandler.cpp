@@ -5,8 +5,10 @@
 
 #include <stdexcept>
 #include "server/file/commandhandler.hpp"
+#include "afl/base/countof.hpp"
 #include "afl/string/char.hpp"
 #include "interpreter/arguments.hpp"
+#include "server/common/readwritelock.hpp"
 #include "server/errors.hpp"
 #include "server/file/filebase.hpp"
 #include "server/file/filegame.hpp"
@@ -52,19 +54,62 @@ server::file::CommandHandler::handleCommand(const String_t& upcasedCommand, inte
         ok = true;
     }
     if (!ok) {
-        // Most commands
-        FileBase base(m_session, m_root);
-        ok = server::interface::FileBaseServer(base).handleCommand(upcasedCommand, args, result);
-    }
-    if (!ok) {
-        // GAME/REG commands
-        FileGame game(m_session, m_root);
-        ok = server::interface::FileGameServer(game).handleCommand(upcasedCommand, args, result);
+        // File space commands.
+        // Commands that only read can run in parallel (if the server runs multiple threads); everything else runs alone.
+        if (isReadOnlyCommand(upcasedCommand)) {
+            server::common::ReadWriteLock::ReadGuard g(m_root.commandLock());
+            ok = handleFileCommand(upcasedCommand, args, result);
+        } else {
+            server::common::ReadWriteLock::WriteGuard g(m_root.commandLock());
+            ok = handleFileCommand(upcasedCommand, args, result);
+        }
     }
+
     // @change PCC2 returns 405 here
     return ok;
 }
 
+bool
+server::file::CommandHandler::handleFileCommand(const String_t& upcasedCommand, interpreter::Arguments& args, std::auto_ptr<Value_t>& result)
+{
+    bool ok = false;
+    try {
+        if (!ok) {
+            // Most commands
+            FileBase base(m_session, m_root);
+            ok = server::interface::FileBaseServer(base).handleCommand(upcasedCommand, args, result);
+        }
+        if (!ok) {
+            // GAME/REG commands
+            FileGame game(m_session, m_root);
+            ok = server::interface::FileGameServer(game).handleCommand(upcasedCommand, args, result);
+        }
+    }
+    catch (...) {
+        // A failing command may have made partial changes; save those like a succeeding one.
+        m_root.finishCommand();
+        throw;
+    }
+    m_root.finishCommand();
+    return ok;
+}
+
+bool
+server::file::CommandHandler::isReadOnlyCommand(const String_t& upcasedCommand)
+{
+    // Commands that do not modify the file space.
+    // Unknown commands are treated as modifying.
+    static const char*const COMMANDS[] = {
+        "FTEST", "GET", "LS", "LSGAME", "LSPERM", "LSREG", "PROPGET", "STAT", "STATGAME", "STATREG", "USAGE",
+    };
+    for (size_t i = 0; i < countof(COMMANDS); ++i) {
+        if (upcasedCommand == COMMANDS[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 String_t
 server::file::CommandHandler::getHelp()
 {
@@ -29,10 +29,18 @@ namespace server { namespace file {
 
         virtual bool handleCommand(const String_t& upcasedCommand, interpreter::Arguments& args, std::auto_ptr<Value_t>& result);
 
+        /** Check whether a command only reads the file space.
+            Such commands are executed holding Root::commandLock() shared, all others hold it exclusively.
+            \param upcasedCommand Command verb, in upper case
+            \return true if command is read-only */
+        static bool isReadOnlyCommand(const String_t& upcasedCommand);
+
      private:
         Root& m_root;
         Session& m_session;
 
+        bool handleFileCommand(const String_t& upcasedCommand, interpreter::Arguments& args, std::auto_ptr<Value_t>& result);
+
         String_t getHelp();
 
         void logCommand(const String_t& verb, interpreter::Arguments args);
@@ -11,6 +11,7 @@
 #include "afl/net/url.hpp"
 #include "afl/string/format.hpp"
 #include "server/file/ca/garbagecollector.hpp"
+#include "server/file/ca/objectstore.hpp"
 #include "server/file/ca/root.hpp"
 #include "server/file/clientdirectoryhandler.hpp"
 #include "server/file/directoryhandler.hpp"
@@ -64,6 +65,13 @@ namespace {
             ;
         log.write(LogListener::Info, LOG_NAME, Format("Total objects removed: %d", gc.getNumObjectsRemoved()));
     }
+
+    void doRepack(server::file::ca::Root& root, afl::sys::LogListener& log)
+    {
+        log.write(LogListener::Info, LOG_NAME, "Repacking...");
+        size_t n = root.objectStore().repack();
+        log.write(LogListener::Info, LOG_NAME, Format("Total objects packed: %d", n));
+    }
 }
 
 // Constructor.
@@ -73,7 +81,11 @@ server::file::DirectoryHandlerFactory::DirectoryHandlerFactory(afl::io::FileSyst
       m_clientCache(),
       m_fs(fs),
       m_networkStack(net),
-      m_gcEnabled(false)
+      m_gcEnabled(false),
+      m_repackEnabled(false),
+      m_indexEnabled(false),
+      m_deferredUpdates(false),
+      m_caRoots()
 { }
 
 // Set garbage collection mode.
@@ -83,6 +95,36 @@ server::file::DirectoryHandlerFactory::setGarbageCollection(bool enabled)
     m_gcEnabled = enabled;
 }
 
+// Set repack mode.
+void
+server::file::DirectoryHandlerFactory::setRepack(bool enabled)
+{
+    m_repackEnabled = enabled;
+}
+
+// Set persistent index mode.
+void
+server::file::DirectoryHandlerFactory::setPersistentIndex(bool enabled)
+{
+    m_indexEnabled = enabled;
+}
+
+// Set deferred update mode.
+void
+server::file::DirectoryHandlerFactory::setDeferredUpdates(bool enabled)
+{
+    m_deferredUpdates = enabled;
+}
+
+// Save deferred updates.
+void
+server::file::DirectoryHandlerFactory::flush()
+{
+    for (size_t i = 0, n = m_caRoots.size(); i < n; ++i) {
+        m_caRoots[i]->flush();
+    }
+}
+
 // Create a DirectoryHandler.
 server::file::DirectoryHandler&
 server::file::DirectoryHandlerFactory::createDirectoryHandler(const String_t& str, afl::sys::LogListener& log)
@@ -156,9 +198,19 @@ server::file::DirectoryHandlerFactory::createDirectoryHandler(const String_t& st
                 // Content-addressable
                 DirectoryHandler& backend = createDirectoryHandler(str.substr(3), log);
                 server::file::ca::Root& root = m_deleter.addNew(new server::file::ca::Root(backend));
+                if (m_indexEnabled) {
+                    root.enablePersistentIndex();
+                }
                 if (m_gcEnabled) {
                     doGarbageCollection(root, log, str.substr(3));
                 }
+                if (m_repackEnabled) {
+                    doRepack(root, log);
+                }
+                if (m_deferredUpdates) {
+                    root.setDeferredUpdates(true);
+                }
+                m_caRoots.push_back(&root);
                 result = &m_deleter.addNew(root.createRootHandler());
             } else if (str.size() >= 4 && str.compare(0, 4, "int:", 4) == 0) {
                 // Internal
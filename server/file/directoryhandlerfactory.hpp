@@ -6,6 +6,7 @@
 #define C2NG_SERVER_FILE_DIRECTORYHANDLERFACTORY_HPP
 
 #include <map>
+#include <vector>
 #include "afl/base/deleter.hpp"
 #include "afl/io/filesystem.hpp"
 #include "afl/net/commandhandler.hpp"
@@ -15,6 +16,7 @@
 namespace server { namespace file {
 
     class DirectoryHandler;
+    namespace ca { class Root; }
 
     /** Factory for DirectoryHandler instances.
         This is mainly used to create the back-ends of a c2file storage.
@@ -36,6 +38,29 @@ namespace server { namespace file {
                            If false (default), no garbage collection is run */
         void setGarbageCollection(bool enabled);
 
+        /** Set repack mode.
+            \param enabled Set status.
+                           If true, loose objects are merged into pack files (after garbage collection, if enabled) when a CA backend is created.
+                           If false (default), objects are not repacked */
+        void setRepack(bool enabled);
+
+        /** Set persistent index mode.
+            \param enabled Set status.
+                           If true, reference counts and object sizes of a CA backend are kept on disk (see server::file::ca::PersistentIndex).
+                           If false (default), they are only kept in memory */
+        void setPersistentIndex(bool enabled);
+
+        /** Set deferred update mode.
+            \param enabled Set status.
+                           If true, CA backends keep changes in memory until flush() (see server::file::ca::Root::setDeferredUpdates()).
+                           If false (default), changes are written immediately */
+        void setDeferredUpdates(bool enabled);
+
+        /** Save deferred updates.
+            Saves pending changes of all CA backends created by this factory.
+            \throw FileProblemException on error */
+        void flush();
+
         /** Create a DirectoryHandler.
             \param str Descriptor
             \param log Logger (for GC)
@@ -64,6 +89,10 @@ namespace server { namespace file {
         afl::io::FileSystem& m_fs;
         afl::net::NetworkStack& m_networkStack;
         bool m_gcEnabled;
+        bool m_repackEnabled;
+        bool m_indexEnabled;
+        bool m_deferredUpdates;
+        std::vector<server::file::ca::Root*> m_caRoots;
     };
 
 } }
@@ -9,6 +9,7 @@
 #include "afl/io/internalstream.hpp"
 #include "afl/io/textfile.hpp"
 #include "afl/string/format.hpp"
+#include "afl/sys/mutexguard.hpp"
 #include "server/errors.hpp"
 #include "server/file/gamestatus.hpp"
 #include "server/file/root.hpp"
@@ -43,6 +44,9 @@ void
 server::file::DirectoryItem::readContent(Root& root)
 {
     // ex UserDirectory::read
+    // Readers may get here in parallel; the first one reads, the others wait for it.
+    afl::sys::MutexGuard g(root.storageMutex());
+
     // Do we need to read?
     if (m_wasRead) {
         return;
@@ -131,6 +135,7 @@ server::file::GameStatus&
 server::file::DirectoryItem::readGameStatus(Root& root)
 {
     // ex UserDirectory::getDirInfo
+    afl::sys::MutexGuard g(root.storageMutex());
     if (m_gameStatus.get() == 0) {
         root.log().write(afl::sys::LogListener::Debug, LOG_NAME, afl::string::Format("checking %s", m_handler->getName()));
         m_gameStatus.reset(new GameStatus());
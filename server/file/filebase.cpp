@@ -7,6 +7,7 @@
 #include "server/file/filebase.hpp"
 #include "afl/io/constmemorystream.hpp"
 #include "afl/io/textfile.hpp"
+#include "afl/sys/mutexguard.hpp"
 #include "server/errors.hpp"
 #include "server/file/directoryitem.hpp"
 #include "server/file/fileitem.hpp"
@@ -127,7 +128,9 @@ server::file::FileBase::getFile(String_t fileName)
     PathResolver res(m_root, m_root.rootDirectory(), m_session.getUser());
     FileItem& file = res.resolveToFile(fileName, DirectoryItem::AllowRead);
 
-    // Load
+    // Load. GET runs in parallel with other readers, so serialize the storage access.
+    // The mapping may be shared with a storage cache; do not let it escape the lock.
+    afl::sys::MutexGuard g(m_root.storageMutex());
     afl::base::Ref<afl::io::FileMapping> map(res.getDirectory().getFileContent(file));
     afl::base::ConstBytes_t bytes(map->get());
 
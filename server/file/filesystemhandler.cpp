@@ -9,10 +9,12 @@
 #include "afl/io/directory.hpp"
 #include "afl/io/directoryentry.hpp"
 #include "afl/io/internalfilemapping.hpp"
+#include "server/file/ca/objectstore.hpp"
 
-server::file::FileSystemHandler::FileSystemHandler(afl::io::FileSystem& fs, String_t name)
+server::file::FileSystemHandler::FileSystemHandler(afl::io::FileSystem& fs, String_t name, bool computeContentIds)
     : m_fileSystem(fs),
-      m_name(name)
+      m_name(name),
+      m_computeContentIds(computeContentIds)
 { }
 
 server::file::FileSystemHandler::~FileSystemHandler()
@@ -88,6 +90,9 @@ server::file::FileSystemHandler::readContent(Callback& callback)
          case DirectoryEntry::tFile:
             i.size = convertSize(p->getFileSize());
             i.type = IsFile;
+            if (m_computeContentIds) {
+                i.contentId = ca::ObjectStore::computeObjectId(ca::ObjectStore::DataObject, getFileByName(i.name)->get()).toHex();
+            }
             break;
          case DirectoryEntry::tDirectory:
             i.type = IsDirectory;
@@ -108,7 +113,7 @@ server::file::FileSystemHandler::readContent(Callback& callback)
 server::file::DirectoryHandler*
 server::file::FileSystemHandler::getDirectory(const Info& info)
 {
-    return new FileSystemHandler(m_fileSystem, m_fileSystem.makePathName(m_name, info.name));
+    return new FileSystemHandler(m_fileSystem, m_fileSystem.makePathName(m_name, info.name), m_computeContentIds);
 }
 
 server::file::FileSystemHandler::Info
@@ -9,9 +9,19 @@
 
 namespace server { namespace file {
 
+    /** DirectoryHandler for a directory in an afl::io::FileSystem.
+
+        The file system does not provide content Ids.
+        If enabled using the \c computeContentIds parameter, readContent() computes them from the file content,
+        using the same Ids as the CA backend (git blob Ids).
+        This requires reading each file, but allows synchronizeDirectories() to skip files that did not change. */
     class FileSystemHandler : public DirectoryHandler {
      public:
-        FileSystemHandler(afl::io::FileSystem& fs, String_t name);
+        /** Constructor.
+            \param fs                FileSystem instance
+            \param name              Directory name
+            \param computeContentIds true to report content Ids in readContent() */
+        FileSystemHandler(afl::io::FileSystem& fs, String_t name, bool computeContentIds = false);
         ~FileSystemHandler();
 
         virtual String_t getName();
@@ -30,6 +40,7 @@ namespace server { namespace file {
      private:
         afl::io::FileSystem& m_fileSystem;
         const String_t m_name;
+        const bool m_computeContentIds;
     };
 
 } }
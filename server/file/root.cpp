@@ -6,6 +6,8 @@
 #include "afl/charset/codepage.hpp"
 #include "afl/io/filemapping.hpp"
 #include "afl/string/format.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/time.hpp"
 
 server::file::Root::Root(DirectoryItem& rootDirectory, afl::base::Ref<afl::io::Directory> defaultSpecificationDirectory)
     : m_log(),
@@ -15,7 +17,13 @@ server::file::Root::Root(DirectoryItem& rootDirectory, afl::base::Ref<afl::io::D
       m_defaultRaceNames(),
       m_defaultSpecificationDirectory(defaultSpecificationDirectory),
       m_translator(),
-      m_scanner(*m_defaultSpecificationDirectory, m_translator, m_log)
+      m_scanner(*m_defaultSpecificationDirectory, m_translator, m_log),
+      m_flushHandler(),
+      m_flushDelay(0),
+      m_flushTime(0),
+      m_flushPending(false),
+      m_commandLock(),
+      m_storageMutex()
 {
     loadRaceNames();
 }
@@ -67,6 +75,71 @@ server::file::Root::setMaxFileSize(afl::io::Stream::FileSize_t limit)
     m_maxFileSize = limit;
 }
 
+void
+server::file::Root::setFlushHandler(afl::base::Closure<void()>* handler, uint32_t maxDelay)
+{
+    m_flushHandler.reset(handler);
+    m_flushDelay = maxDelay;
+    m_flushPending = false;
+}
+
+void
+server::file::Root::finishCommand()
+{
+    // Commands holding the command lock shared can get here in parallel.
+    afl::sys::MutexGuard g(m_storageMutex);
+    if (m_flushHandler.get() != 0) {
+        // Start the clock with the first command after a flush.
+        // We do not know whether a command actually modified something, but flushing an unmodified storage is cheap.
+        const uint32_t now = afl::sys::Time::getTickCounter();
+        if (!m_flushPending) {
+            m_flushPending = true;
+            m_flushTime = now;
+        }
+        if (now - m_flushTime >= m_flushDelay) {
+            m_flushPending = false;
+            m_flushHandler->call();
+        }
+    }
+}
+
+void
+server::file::Root::checkFlush()
+{
+    // The flush handler modifies the storage; keep commands out like a modifying command would.
+    server::common::ReadWriteLock::WriteGuard wg(m_commandLock);
+    afl::sys::MutexGuard g(m_storageMutex);
+    if (m_flushHandler.get() != 0 && m_flushPending) {
+        const uint32_t now = afl::sys::Time::getTickCounter();
+        if (now - m_flushTime >= m_flushDelay) {
+            m_flushPending = false;
+            m_flushHandler->call();
+        }
+    }
+}
+
+void
+server::file::Root::flush()
+{
+    afl::sys::MutexGuard g(m_storageMutex);
+    if (m_flushHandler.get() != 0) {
+        m_flushPending = false;
+        m_flushHandler->call();
+    }
+}
+
+server::common::ReadWriteLock&
+server::file::Root::commandLock()
+{
+    return m_commandLock;
+}
+
+afl::sys::Mutex&
+server::file::Root::storageMutex()
+{
+    return m_storageMutex;
+}
+
 void
 server::file::Root::loadRaceNames()
 {
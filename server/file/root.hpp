@@ -4,6 +4,8 @@
 #ifndef C2NG_SERVER_FILE_ROOT_HPP
 #define C2NG_SERVER_FILE_ROOT_HPP
 
+#include <memory>
+#include "afl/base/closure.hpp"
 #include "afl/sys/log.hpp"
 #include "afl/io/stream.hpp"
 #include "afl/charset/charset.hpp"
@@ -11,8 +13,10 @@
 #include "game/v3/directoryscanner.hpp"
 #include "afl/io/directory.hpp"
 #include "afl/string/nulltranslator.hpp"
+#include "afl/sys/mutex.hpp"
 #include "game/playerarray.hpp"
 #include "server/common/racenames.hpp"
+#include "server/common/readwritelock.hpp"
 
 namespace server { namespace file {
 
@@ -42,6 +46,43 @@ namespace server { namespace file {
         afl::io::Stream::FileSize_t getMaxFileSize() const;
         void setMaxFileSize(afl::io::Stream::FileSize_t limit);
 
+        /** Set flush handler.
+            The flush handler saves deferred updates of the underlying storage
+            (see DirectoryHandlerFactory::flush()).
+            \param handler  Newly-allocated closure; null to disable
+            \param maxDelay Maximum time in milliseconds to defer saving; 0 to save after every command */
+        void setFlushHandler(afl::base::Closure<void()>* handler, uint32_t maxDelay);
+
+        /** Notify end of a command.
+            Calls the flush handler if the configured delay has elapsed. */
+        void finishCommand();
+
+        /** Save deferred updates if they are due.
+            Must be called periodically, to save updates when no further command arrives.
+            Calls the flush handler if the configured delay has elapsed since the first unsaved command.
+            Acquires the command lock exclusively; must not be called from within a command. */
+        void checkFlush();
+
+        /** Save deferred updates now.
+            Calls the flush handler, if any. */
+        void flush();
+
+        /** Access command lock.
+            When commands are executed by multiple threads,
+            commands that only read the file space hold this lock shared,
+            commands that modify it hold it exclusively (see CommandHandler).
+            \return lock */
+        server::common::ReadWriteLock& commandLock();
+
+        /** Access storage mutex.
+            Commands holding the command lock shared may still need to modify cached state
+            (DirectoryItem::readContent(), DirectoryItem::readGameStatus()),
+            and access the underlying storage, which is not generally thread-safe.
+            Those places lock this mutex (recursively).
+            Holders of the exclusive command lock need not lock it.
+            \return mutex */
+        afl::sys::Mutex& storageMutex();
+
      private:
         afl::sys::Log m_log;
 
@@ -58,6 +99,13 @@ namespace server { namespace file {
         afl::string::NullTranslator m_translator;
 
         game::v3::DirectoryScanner m_scanner;
+        std::auto_ptr<afl::base::Closure<void()> > m_flushHandler;
+        uint32_t m_flushDelay;
+        uint32_t m_flushTime;
+        bool m_flushPending;
+
+        server::common::ReadWriteLock m_commandLock;
+        afl::sys::Mutex m_storageMutex;
 
         void loadRaceNames();
     };
@@ -3,6 +3,7 @@
   *  \brief Class server::file::ServerApplication
   */
 
+#include <algorithm>
 #include "server/file/serverapplication.hpp"
 #include "afl/except/commandlineexception.hpp"
 #include "afl/net/resp/protocolhandler.hpp"
@@ -11,6 +12,7 @@
 #include "afl/string/parse.hpp"
 #include "afl/sys/thread.hpp"
 #include "server/common/sessionprotocolhandlerfactory.hpp"
+#include "server/common/threadpoolserver.hpp"
 #include "server/file/commandhandler.hpp"
 #include "server/file/directoryhandler.hpp"
 #include "server/file/directoryhandlerfactory.hpp"
@@ -26,6 +28,8 @@ using afl::async::InterruptOperation;
 namespace {
     const char LOG_NAME[] = "file";
 
+    const size_t MAX_WORKERS = 32;
+
     /** Proxy DirectoryHandler.
         DirectoryHandler's created by DirectoryHandlerFactory are owned by that,
         but DirectoryItem wants a DirectoryHandler it owns, so we need to proxy that.
@@ -120,7 +124,11 @@ server::file::ServerApplication::ServerApplication(afl::sys::Environment& env, a
       m_rootDirectory("."),
       m_maxFileSize(10UL*1024*1024),
       m_interrupt(intr),
-      m_gcEnabled(true)
+      m_gcEnabled(true),
+      m_repackEnabled(false),
+      m_indexEnabled(false),
+      m_flushDelay(0),
+      m_numWorkers(0)
 { }
 
 server::file::ServerApplication::~ServerApplication()
@@ -136,6 +144,12 @@ server::file::ServerApplication::handleCommandLineOption(const String_t& option,
     } else if (option == "nogc") {
         m_gcEnabled = false;
         return true;
+    } else if (option == "repack") {
+        m_repackEnabled = true;
+        return true;
+    } else if (option == "index") {
+        m_indexEnabled = true;
+        return true;
     } else {
         return false;
     }
@@ -148,6 +162,9 @@ server::file::ServerApplication::serverMain()
     afl::io::FileSystem& fs = fileSystem();
     DirectoryHandlerFactory dhFactory(fs, networkStack());
     dhFactory.setGarbageCollection(m_gcEnabled);
+    dhFactory.setRepack(m_repackEnabled);
+    dhFactory.setPersistentIndex(m_indexEnabled);
+    dhFactory.setDeferredUpdates(true);
     DirectoryItem item("(root)", 0, std::auto_ptr<DirectoryHandler>(new ProxyDirectoryHandler(dhFactory.createDirectoryHandler(m_rootDirectory, log()))));
 
     afl::base::Ref<afl::io::Directory> defaultSpecDirectory = fs.openDirectory(fs.makePathName(fs.makePathName(environment().getInstallationDirectoryName(), "share"), "specs"));
@@ -156,26 +173,46 @@ server::file::ServerApplication::serverMain()
     Root root(item, defaultSpecDirectory);
     root.log().addListener(log());
     root.setMaxFileSize(m_maxFileSize);
+    root.setFlushHandler(afl::base::Closure<void()>::makeBound(&dhFactory, &DirectoryHandlerFactory::flush), m_flushDelay);
 
     // Protocol Handler
     server::common::SessionProtocolHandlerFactory<Root, Session, afl::net::resp::ProtocolHandler, CommandHandler> factory(root);
 
     // Server
-    afl::net::Server server(networkStack().listen(m_listenAddress, 10), factory);
-    log().write(afl::sys::LogListener::Info, "file", afl::string::Format("Listening on %s", m_listenAddress.toString()));
+    std::auto_ptr<afl::base::Stoppable> server;
+    if (m_numWorkers == 0) {
+        server.reset(new afl::net::Server(networkStack().listen(m_listenAddress, 10), factory));
+        log().write(afl::sys::LogListener::Info, "file", afl::string::Format("Listening on %s", m_listenAddress.toString()));
+    } else {
+        std::auto_ptr<server::common::ThreadPoolServer> pool(new server::common::ThreadPoolServer(networkStack().listen(m_listenAddress, 10), factory, m_numWorkers));
+        pool->log().addListener(log());
+        server.reset(pool.release());
+        log().write(afl::sys::LogListener::Info, "file", afl::string::Format("Listening on %s with %d workers", m_listenAddress.toString(), m_numWorkers));
+    }
 
     // Server thread
-    afl::sys::Thread serverThread("file.server", server);
+    afl::sys::Thread serverThread("file.server", *server);
     serverThread.start();
 
-    // Wait for termination request
+    // Wait for termination request.
+    // With deferred updates, save those periodically even if no further command arrives.
     afl::async::Controller ctl;
-    m_interrupt.wait(ctl, InterruptOperation::Kinds_t() + InterruptOperation::Break + InterruptOperation::Terminate);
+    if (m_flushDelay == 0) {
+        m_interrupt.wait(ctl, InterruptOperation::Kinds_t() + InterruptOperation::Break + InterruptOperation::Terminate);
+    } else {
+        const uint32_t interval = std::max(m_flushDelay / 2, uint32_t(1));
+        while (m_interrupt.wait(ctl, InterruptOperation::Kinds_t() + InterruptOperation::Break + InterruptOperation::Terminate, interval).empty()) {
+            root.checkFlush();
+        }
+    }
 
     // Stop
     log().write(afl::sys::LogListener::Info, LOG_NAME, "Received stop signal, shutting down.");
-    server.stop();
+    server->stop();
     serverThread.join();
+
+    // Save deferred updates
+    root.flush();
 }
 
 bool
@@ -209,6 +246,41 @@ server::file::ServerApplication::handleConfiguration(const String_t& key, const
             throw afl::except::CommandLineException(afl::string::Format("Invalid number for '%s'", key));
         }
         return true;
+    } else if (key == m_instanceName + ".FLUSHDELAY") {
+        /* @q File.FlushDelay:Int (Config), HostFile.FlushDelay:Int (Config)
+           Maximum time (milliseconds) to keep changes to a content-addressable object pool in memory.
+           Changes made by multiple commands within this time are written together,
+           so a directory that receives many files is written only once.
+           Changes are written when this time has elapsed since the first unsaved command
+           (checked after each command, and every half of this time), and on shutdown.
+           Default is 0, meaning changes are written after every command.
+
+           A nonzero value trades durability for speed:
+           commands are confirmed to the client before their changes are written,
+           so if the server process dies without a regular shutdown (crash, kill, power loss),
+           changes made within the last 1.5 times this value are lost. */
+        if (!afl::string::strToInteger(value, m_flushDelay)) {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid number for '%s'", key));
+        }
+        return true;
+    } else if (key == m_instanceName + ".WORKERS") {
+        /* @q File.Workers:Int (Config), HostFile.Workers:Int (Config)
+           Number of worker threads.
+           If nonzero, each connection is served by a worker thread.
+           Commands that only read (e.g. GET, LS, STAT) run in parallel; commands that modify the file space run alone.
+           The number of workers is the maximum number of connections served at the same time;
+           further connections wait until a worker becomes free,
+           so this must be larger than the number of permanent connections from other services.
+           Valid values are 1 to 32.
+           Default is 0, meaning all connections are served by a single thread; 0 can also be set explicitly.
+           @since PCC2 2.41 */
+        size_t n;
+        if (afl::string::strToInteger(value, n) && n <= MAX_WORKERS) {
+            m_numWorkers = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (key == m_instanceName + ".THREADS") {
         /* @q File.Threads:Int (Config), HostFile.Threads:Int (Config)
            Ignored in c2file-ng for compatibility reasons.
@@ -229,6 +301,8 @@ String_t
 server::file::ServerApplication::getCommandLineOptionHelp() const
 {
     return "--instance=NAME\tInstance name (default: \"FILE\")\n"
-        "--nogc\tDisable garbage collection\n";
+        "--nogc\tDisable garbage collection\n"
+        "--repack\tMerge loose objects into pack files on startup\n"
+        "--index\tKeep reference counts and object sizes on disk\n";
 }
 
@@ -41,6 +41,10 @@ namespace server { namespace file {
         afl::io::Stream::FileSize_t m_maxFileSize;   // ex arg_file_size_limit
         afl::async::Interrupt& m_interrupt;
         bool m_gcEnabled;
+        bool m_repackEnabled;
+        bool m_indexEnabled;
+        uint32_t m_flushDelay;
+        size_t m_numWorkers;
     };
 
 } }
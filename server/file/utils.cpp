@@ -5,6 +5,7 @@
 
 #include <memory>
 #include "server/file/utils.hpp"
+#include "afl/data/stringlist.hpp"
 #include "afl/except/fileproblemexception.hpp"
 #include "afl/io/archive/tarreader.hpp"
 #include "afl/io/constmemorystream.hpp"
@@ -12,6 +13,7 @@
 #include "afl/io/inflatetransform.hpp"
 #include "afl/io/transformreaderstream.hpp"
 #include "server/errors.hpp"
+#include "server/file/clientdirectoryhandler.hpp"
 #include "server/file/directoryhandler.hpp"
 
 using server::file::DirectoryHandler;
@@ -44,24 +46,69 @@ namespace {
         return false;
     }
 
-    /** Copy a file.
+    /* Limits for batched file transfers (see copyFiles) */
+    const size_t MAX_BATCH_FILES = 50;
+    const int64_t MAX_BATCH_BYTES = 4*1024*1024;
+
+    /** Copy files.
+        Equivalent to copying each file individually,
+        but transfers files in batches if either side is a ClientDirectoryHandler,
+        to avoid paying a network round-trip per file.
         \param out Output directory
         \param in Input directory
-        \param inChild Input file info */
-    void copyFile(DirectoryHandler& out, ReadOnlyDirectoryHandler& in, const DirectoryHandler::Info& inChild)
+        \param files Input files */
+    void copyFiles(DirectoryHandler& out, ReadOnlyDirectoryHandler& in, const server::file::InfoVector_t& files)
     {
-        if (!out.copyFile(in, inChild, inChild.name).isValid()) {
-            out.createFile(inChild.name, in.getFile(inChild)->get());
+        server::file::ClientDirectoryHandler* clientIn = dynamic_cast<server::file::ClientDirectoryHandler*>(&in);
+        server::file::ClientDirectoryHandler* clientOut = dynamic_cast<server::file::ClientDirectoryHandler*>(&out);
+
+        size_t index = 0;
+        while (index < files.size()) {
+            // Build a batch of files the target cannot copy by itself
+            server::file::InfoVector_t batch;
+            afl::data::StringList_t names;
+            int64_t totalSize = 0;
+            while (index < files.size() && batch.size() < MAX_BATCH_FILES && totalSize < MAX_BATCH_BYTES) {
+                const DirectoryHandler::Info& inChild = files[index++];
+                if (!out.copyFile(in, inChild, inChild.name).isValid()) {
+                    batch.push_back(inChild);
+                    names.push_back(inChild.name);
+                    if (const int32_t* pSize = inChild.size.get()) {
+                        totalSize += *pSize;
+                    }
+                }
+            }
+
+            // Transfer the batch
+            if (batch.empty()) {
+                continue;
+            }
+            if (clientIn != 0) {
+                clientIn->prefetchFiles(names);
+            }
+            if (clientOut != 0) {
+                afl::data::StringList_t contents;
+                for (size_t i = 0, n = batch.size(); i < n; ++i) {
+                    contents.push_back(afl::string::fromBytes(in.getFile(batch[i])->get()));
+                }
+                clientOut->createFiles(names, contents);
+            } else {
+                for (size_t i = 0, n = batch.size(); i < n; ++i) {
+                    out.createFile(batch[i].name, in.getFile(batch[i])->get());
+                }
+            }
         }
     }
 
     /** Copy child.
         Copies files or directories.
         Requires that the target does not exist (or, that we're overwriting a file with a file).
+        Files are not copied immediately, but added to pendingFiles, to be copied using copyFiles().
         \param out Output directory
         \param in Input directory
-        \param inChild Input item info */
-    void copyChild(DirectoryHandler& out, ReadOnlyDirectoryHandler& in, const DirectoryHandler::Info& inChild)
+        \param inChild Input item info
+        \param pendingFiles [out] Files to copy */
+    void copyChild(DirectoryHandler& out, ReadOnlyDirectoryHandler& in, const DirectoryHandler::Info& inChild, server::file::InfoVector_t& pendingFiles)
     {
         switch (inChild.type) {
          case DirectoryHandler::IsUnknown:
@@ -69,7 +116,7 @@ namespace {
             break;
 
          case DirectoryHandler::IsFile:
-            copyFile(out, in, inChild);
+            pendingFiles.push_back(inChild);
             break;
 
          case DirectoryHandler::IsDirectory: {
@@ -168,6 +215,7 @@ server::file::copyDirectory(DirectoryHandler& out, ReadOnlyDirectoryHandler& in,
     listDirectory(outChildren, out);
 
     // Process it
+    InfoVector_t pendingFiles;
     for (size_t i = 0, n = inChildren.size(); i < n; ++i) {
         const DirectoryHandler::Info& ch = inChildren[i];
         switch (ch.type) {
@@ -186,7 +234,7 @@ server::file::copyDirectory(DirectoryHandler& out, ReadOnlyDirectoryHandler& in,
                 copyTarball(out, in, ch, elementBaseName);
             } else {
                 // Normal file
-                copyFile(out, in, ch);
+                pendingFiles.push_back(ch);
             }
             break;
          }
@@ -220,6 +268,7 @@ server::file::copyDirectory(DirectoryHandler& out, ReadOnlyDirectoryHandler& in,
             break;
         }
     }
+    copyFiles(out, in, pendingFiles);
 }
 
 // Remove a directory's content.
@@ -250,6 +299,7 @@ server::file::synchronizeDirectories(DirectoryHandler& out, ReadOnlyDirectoryHan
     std::sort(outChildren.begin(), outChildren.end(), CompareListItems());
 
     // Process it
+    InfoVector_t pendingFiles;
     size_t inIndex = 0;
     size_t outIndex = 0;
     while (inIndex < inChildren.size() && outIndex < outChildren.size()) {
@@ -257,7 +307,7 @@ server::file::synchronizeDirectories(DirectoryHandler& out, ReadOnlyDirectoryHan
         const DirectoryHandler::Info& outChild = outChildren[outIndex];
         if (inChild.name < outChild.name) {
             // inChild comes first -> copy
-            copyChild(out, in, inChild);
+            copyChild(out, in, inChild, pendingFiles);
             ++inIndex;
         } else if (inChild.name > outChild.name) {
             // outChild comes first -> delete
@@ -267,17 +317,22 @@ server::file::synchronizeDirectories(DirectoryHandler& out, ReadOnlyDirectoryHan
             // Same name -> check for overwrite
             if (inChild.type != outChild.type) {
                 removeChild(out, outChild);
-                copyChild(out, in, inChild);
+                copyChild(out, in, inChild, pendingFiles);
             } else {
                 switch (inChild.type) {
                  case DirectoryHandler::IsUnknown:
                     // Ignore unknown
                     break;
 
-                 case DirectoryHandler::IsFile:
-                    // File: just overwrite
-                    copyChild(out, in, inChild);
+                 case DirectoryHandler::IsFile: {
+                    // File: overwrite unless known to be identical
+                    const String_t* inId = inChild.contentId.get();
+                    const String_t* outId = outChild.contentId.get();
+                    if (inId == 0 || outId == 0 || *inId != *outId) {
+                        copyChild(out, in, inChild, pendingFiles);
+                    }
                     break;
+                 }
 
                  case DirectoryHandler::IsDirectory: {
                     // Recursively erase directory
@@ -293,7 +348,7 @@ server::file::synchronizeDirectories(DirectoryHandler& out, ReadOnlyDirectoryHan
     }
     while (inIndex < inChildren.size()) {
         // copy missing child
-        copyChild(out, in, inChildren[inIndex]);
+        copyChild(out, in, inChildren[inIndex], pendingFiles);
         ++inIndex;
     }
     while (outIndex < outChildren.size()) {
@@ -301,4 +356,5 @@ server::file::synchronizeDirectories(DirectoryHandler& out, ReadOnlyDirectoryHan
         removeChild(out, outChildren[outIndex]);
         ++outIndex;
     }
+    copyFiles(out, in, pendingFiles);
 }
@@ -53,6 +53,8 @@ namespace server { namespace file {
         (target has a file where source has a directory, and vice versa).
 
         Synchronisation is always recursive.
+        Files that have the same content Id in source and target are not copied.
+        Files without content Id are always copied.
 
         <b>Note:</b> this works on the DirectoryHandler level and therefore bypasses caches on DirectoryItem level.
         If the DirectoryHandler's are derived from DirectoryItem's somehow, call DirectoryItem::forgetContent()
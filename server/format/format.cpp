@@ -22,6 +22,7 @@
 #include "server/format/stringpacker.hpp"
 #include "server/format/torpedopacker.hpp"
 #include "server/format/truehullpacker.hpp"
+#include "server/format/unpackcache.hpp"
 #include "server/types.hpp"
 #include "server/errors.hpp"
 #include "util/charsetfactory.hpp"
@@ -89,7 +90,8 @@ namespace {
 
 }
 
-server::format::Format::Format()
+server::format::Format::Format(UnpackCache* pCache)
+    : m_pCache(pCache)
 { }
 
 server::format::Format::~Format()
@@ -130,8 +132,18 @@ server::format::Format::unpack(String_t formatName, afl::data::Value* data, afl:
     bool flag = makeJsonFlag(format);
     afl::charset::Charset& cs = makeCharset(charset, del);
 
+    // Check cache
+    const String_t input = toString(data);
+    String_t key;
+    if (m_pCache != 0) {
+        key = UnpackCache::makeKey(formatName, flag, charset.orElse(String_t()), input);
+        if (afl::data::Value* cached = m_pCache->get(key)) {
+            return cached;
+        }
+    }
+
     // Convert
-    std::auto_ptr<afl::data::Value> result(p.unpack(toString(data), cs));
+    std::auto_ptr<afl::data::Value> result(p.unpack(input, cs));
 
     // Convert to JSON if desired
     if (flag) {
@@ -141,5 +153,9 @@ server::format::Format::unpack(String_t formatName, afl::data::Value* data, afl:
         writer.visit(result.get());
         result.reset(makeStringValue(afl::string::fromBytes(sink.getContent())));
     }
+
+    if (m_pCache != 0) {
+        m_pCache->put(key, result.get());
+    }
     return result.release();
 }
@@ -8,12 +8,19 @@
 
 namespace server { namespace format {
 
+    class UnpackCache;
+
     class Format : public server::interface::Format {
      public:
-        Format();
+        /** Constructor.
+            \param pCache Cache for unpack results; can be null */
+        explicit Format(UnpackCache* pCache = 0);
         ~Format();
         virtual afl::data::Value* pack(String_t formatName, afl::data::Value* data, afl::base::Optional<String_t> format, afl::base::Optional<String_t> charset);
         virtual afl::data::Value* unpack(String_t formatName, afl::data::Value* data, afl::base::Optional<String_t> format, afl::base::Optional<String_t> charset);
+
+     private:
+        UnpackCache* m_pCache;
     };
 
 } }
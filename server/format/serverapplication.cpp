@@ -4,13 +4,16 @@
   */
 
 #include "server/format/serverapplication.hpp"
+#include "afl/except/commandlineexception.hpp"
 #include "afl/net/commandhandler.hpp"
 #include "afl/net/protocolhandlerfactory.hpp"
 #include "afl/net/resp/protocolhandler.hpp"
 #include "afl/net/server.hpp"
 #include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
 #include "afl/sys/thread.hpp"
 #include "server/format/format.hpp"
+#include "server/format/unpackcache.hpp"
 #include "server/interface/formatserver.hpp"
 #include "server/ports.hpp"
 #include "version.hpp"
@@ -35,7 +38,8 @@ namespace {
 server::format::ServerApplication::ServerApplication(afl::sys::Environment& env, afl::io::FileSystem& fs, afl::net::NetworkStack& net, afl::async::Interrupt& intr)
     : Application(LOG_NAME, env, fs, net),
       m_listenAddress(DEFAULT_ADDRESS, FORMAT_PORT),
-      m_interrupt(intr)
+      m_interrupt(intr),
+      m_cacheSize(100)
 { }
 
 server::format::ServerApplication::~ServerApplication()
@@ -44,8 +48,9 @@ server::format::ServerApplication::~ServerApplication()
 void
 server::format::ServerApplication::serverMain()
 {
-    // Server implementation (stateless)
-    Format fmt;
+    // Server implementation (stateless except for the cache)
+    UnpackCache cache(m_cacheSize);
+    Format fmt(&cache);
 
     // Command handler (stateless)
     server::interface::FormatServer fs(fmt);
@@ -69,6 +74,7 @@ server::format::ServerApplication::serverMain()
     log().write(afl::sys::LogListener::Info, LOG_NAME, "Received stop signal, shutting down.");
     server.stop();
     serverThread.join();
+    log().write(afl::sys::LogListener::Info, LOG_NAME, afl::string::Format("Unpack cache: %d hits, %d misses", cache.getNumHits(), cache.getNumMisses()));
 }
 
 bool
@@ -90,6 +96,21 @@ server::format::ServerApplication::handleConfiguration(const String_t& key, cons
            Ignored in c2ng/c2format-server for compatibility reasons.
            Number of threads (=maximum number of parallel connections). */
         return true;
+    } else if (key == "FORMAT.CACHESIZE") {
+        /* @q Format.CacheSize:Int (Config)
+           Number of unpack results to keep in memory.
+           Specification files are shared between many games;
+           a cached result is reused when the same file content is unpacked again with the same parameters.
+           0 disables the cache.
+           Default is 100.
+           @since PCC2 2.41 */
+        size_t n;
+        if (afl::string::strToInteger(value, n)) {
+            m_cacheSize = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else {
         return false;
     }
@@ -31,6 +31,7 @@ namespace server { namespace format {
      private:
         afl::net::Name m_listenAddress;
         afl::async::Interrupt& m_interrupt;
+        size_t m_cacheSize;
     };
 
 } }
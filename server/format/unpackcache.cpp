@@ -0,0 +1,101 @@
+/**
+  *  \file server/format/unpackcache.cpp
+  *  \brief Class server::format::UnpackCache
+  */
+
+#include "server/format/unpackcache.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/string/format.hpp"
+
+// Constructor.
+server::format::UnpackCache::UnpackCache(size_t maxEntries)
+    : m_maxEntries(maxEntries),
+      m_entries(),
+      m_useCounter(0),
+      m_numHits(0),
+      m_numMisses(0)
+{ }
+
+// Destructor.
+server::format::UnpackCache::~UnpackCache()
+{ }
+
+// Build a cache key.
+String_t
+server::format::UnpackCache::makeKey(const String_t& formatName, bool json, const String_t& charset, const String_t& data)
+{
+    afl::checksums::SHA1 hash;
+    hash.add(afl::string::toBytes(data));
+    return afl::string::Format("%s:%d:%s:%s", formatName, int(json), charset, hash.getHashAsHexString());
+}
+
+// Look up a result.
+afl::data::Value*
+server::format::UnpackCache::get(const String_t& key)
+{
+    Map_t::iterator it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        ++m_numHits;
+        it->second->lastUse = ++m_useCounter;
+        return afl::data::Value::cloneOf(it->second->value.get());
+    } else {
+        ++m_numMisses;
+        return 0;
+    }
+}
+
+// Store a result.
+void
+server::format::UnpackCache::put(const String_t& key, const afl::data::Value* value)
+{
+    if (m_maxEntries != 0) {
+        Entry* e;
+        Map_t::iterator it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            e = it->second;
+        } else {
+            while (m_entries.size() >= m_maxEntries) {
+                removeOldest();
+            }
+            e = m_entries.insertNew(key, new Entry());
+        }
+        e->value.reset(afl::data::Value::cloneOf(value));
+        e->lastUse = ++m_useCounter;
+    }
+}
+
+// Get number of entries.
+size_t
+server::format::UnpackCache::getNumEntries() const
+{
+    return m_entries.size();
+}
+
+// Get number of get() calls that found a result.
+size_t
+server::format::UnpackCache::getNumHits() const
+{
+    return m_numHits;
+}
+
+// Get number of get() calls that did not find a result.
+size_t
+server::format::UnpackCache::getNumMisses() const
+{
+    return m_numMisses;
+}
+
+/** Remove least-recently used entry. */
+void
+server::format::UnpackCache::removeOldest()
+{
+    Map_t::iterator oldest = m_entries.begin();
+    for (Map_t::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->second->lastUse < oldest->second->lastUse) {
+            oldest = it;
+        }
+    }
+    if (oldest != m_entries.end()) {
+        m_entries.erase(oldest);
+    }
+}
@@ -0,0 +1,86 @@
+/**
+  *  \file server/format/unpackcache.hpp
+  *  \brief Class server::format::UnpackCache
+  */
+#ifndef C2NG_SERVER_FORMAT_UNPACKCACHE_HPP
+#define C2NG_SERVER_FORMAT_UNPACKCACHE_HPP
+
+#include <memory>
+#include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrmap.hpp"
+#include "afl/data/value.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace format {
+
+    /** Cache for unpack results.
+        Most games use one of a handful of ship lists,
+        so c2format-server is asked to unpack the same specification files over and over.
+        Unpacking is a pure function of the file content, the format, and the character set;
+        this cache stores results keyed by these parameters and a content hash of the file.
+
+        Results are stored as afl::data::Value trees and handed out as copies (afl::data::Value::cloneOf).
+        Hash and vector values share their content with the cached copy;
+        callers therefore must not modify results obtained from the cache.
+
+        The cache is limited by number of entries; when it is full, the least-recently used entry is dropped.
+
+        This class is not thread-safe; c2format-server processes all requests in one thread. */
+    class UnpackCache : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param maxEntries Maximum number of entries. 0 means the cache stores nothing. */
+        explicit UnpackCache(size_t maxEntries);
+
+        /** Destructor. */
+        ~UnpackCache();
+
+        /** Build a cache key.
+            \param formatName Format name (see server::interface::Format::unpack)
+            \param json       true if result is to be converted to JSON
+            \param charset    Character set name, empty for default
+            \param data       File content
+            \return key */
+        static String_t makeKey(const String_t& formatName, bool json, const String_t& charset, const String_t& data);
+
+        /** Look up a result.
+            \param key Key, see makeKey()
+            \return Copy of cached result, to be owned by caller; null if not cached */
+        afl::data::Value* get(const String_t& key);
+
+        /** Store a result.
+            \param key   Key, see makeKey()
+            \param value Result (will be copied) */
+        void put(const String_t& key, const afl::data::Value* value);
+
+        /** Get number of entries.
+            \return number of entries */
+        size_t getNumEntries() const;
+
+        /** Get number of get() calls that found a result.
+            \return number */
+        size_t getNumHits() const;
+
+        /** Get number of get() calls that did not find a result.
+            \return number */
+        size_t getNumMisses() const;
+
+     private:
+        struct Entry {
+            std::auto_ptr<afl::data::Value> value;
+            uint32_t lastUse;
+        };
+        typedef afl::container::PtrMap<String_t, Entry> Map_t;
+
+        const size_t m_maxEntries;
+        Map_t m_entries;
+        uint32_t m_useCounter;
+        size_t m_numHits;
+        size_t m_numMisses;
+
+        void removeOldest();
+    };
+
+} }
+
+#endif
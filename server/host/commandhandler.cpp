@@ -173,6 +173,7 @@ server::host::CommandHandler::getHelp(String_t topic) const
             " CRONKICK gid\n"
             " CRONLIST [LIMIT n]\n"
             " CRONLSBROKEN\n"
+            " CRONSTATUS\n"
             " CRONSUSPEND time\n";
     } else if (topic == "FILE") {
         return "File Commands:\n"
@@ -13,10 +13,12 @@ server::host::Configuration::Configuration()
       binDirectory("."),
       useCron(true),
       unpackBackups(false),
+      incrementalExport(false),
       usersSeeTemporaryTurns(true),
       numMissedTurnsForKick(0),
       hostFileAddress(DEFAULT_ADDRESS, HOSTFILE_PORT),
       initialSuspend(0),
+      numHostWorkers(1),
       maxStoredKeys(10),
       keyTitle(),
       keySecret()
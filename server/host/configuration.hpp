@@ -38,6 +38,11 @@ namespace server { namespace host {
         /** Backup mode. */
         bool unpackBackups;
 
+        /** Export mode.
+            If enabled, games are exported into persistent per-game directories, and only changed files are transferred.
+            See Exporter. */
+        bool incrementalExport;
+
         /** Users see temporary turns flag.
             If enabled (default since Jan 2018), users see the temporary flag for all turns.
             If disabled, only the player of a slot sees that it is temporary. */
@@ -54,6 +59,10 @@ namespace server { namespace host {
         /** Initial suspension time. */
         Time_t initialSuspend;
 
+        /** Number of host workers.
+            This many games can be hosted in parallel. */
+        int numHostWorkers;
+
         /** Number of keys to store per user. */
         int maxStoredKeys;
 
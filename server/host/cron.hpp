@@ -23,6 +23,9 @@ namespace server { namespace host {
         /** Shortcut for a scheduler action. */
         typedef server::interface::HostCron::Action Action_t;
 
+        /** Shortcut for scheduler status. */
+        typedef server::interface::HostCron::Status Status_t;
+
 
         /** Get next event for a game.
             \param gameId Game Id
@@ -41,6 +44,10 @@ namespace server { namespace host {
         /** Suspend scheduler.
             \param absTime Absolute time */
         virtual void suspendScheduler(Time_t absTime) = 0;
+
+        /** Get scheduler status.
+            \return status (queue length, worker utilisation) */
+        virtual Status_t getStatus() = 0;
     };
 
 } }
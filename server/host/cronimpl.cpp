@@ -32,6 +32,17 @@ namespace {
     /** Delay from last join to game actually starting. */
     const int32_t MASTER_DELAY = 15;
 
+    /** Name of work directory for a worker.
+        The first worker uses the same name as previous versions. */
+    String_t getWorkDirName(size_t index)
+    {
+        if (index == 0) {
+            return "host";
+        } else {
+            return afl::string::Format("host%d", index);
+        }
+    }
+
     /** Predicate to find a game in a list of ScheduleItems. */
     class IsGame {
      public:
@@ -230,12 +241,88 @@ namespace {
     }
 }
 
+/*
+ *  Worker
+ *
+ *  A worker waits for the scheduler to assign a game, processes it, and reports back.
+ *  m_gameId is protected by the parent's mutex; nonzero means the worker is busy.
+ */
+
+class server::host::CronImpl::Worker : private afl::base::Stoppable {
+ public:
+    Worker(CronImpl& parent, util::ProcessRunner& runner, const String_t& workDirName)
+        : m_parent(parent),
+          m_runner(runner),
+          m_workDirName(workDirName),
+          m_wake(0),
+          m_gameId(0),
+          m_thread("host.worker", *this)
+        { m_thread.start(); }
+
+    // Assign a game. Caller must hold parent's mutex.
+    void start(int32_t gameId)
+        {
+            m_gameId = gameId;
+            m_wake.post();
+        }
+
+    bool isBusy() const
+        { return m_gameId != 0; }
+
+    int32_t getGameId() const
+        { return m_gameId; }
+
+    void setIdle()
+        { m_gameId = 0; }
+
+    util::ProcessRunner& runner()
+        { return m_runner; }
+
+    const String_t& getWorkDirName() const
+        { return m_workDirName; }
+
+    void join()
+        { m_thread.join(); }
+
+    virtual void run()
+        {
+            while (1) {
+                m_wake.wait();
+                int32_t gameId;
+                {
+                    afl::sys::MutexGuard g(m_parent.m_mutex);
+                    if (m_parent.m_stopFlag) {
+                        break;
+                    }
+                    gameId = m_gameId;
+                }
+                if (gameId != 0) {
+                    m_parent.processDueItem(*this, gameId);
+                }
+            }
+        }
+
+    virtual void stop()
+        { m_wake.post(); }
+
+ private:
+    CronImpl& m_parent;
+    util::ProcessRunner& m_runner;
+    const String_t m_workDirName;
+    afl::sys::Semaphore m_wake;
+    int32_t m_gameId;
+    afl::sys::Thread m_thread;
+};
+
+
+/*
+ *  CronImpl
+ */
 
 // Constructor.
-server::host::CronImpl::CronImpl(Root& root, util::ProcessRunner& runner)
+server::host::CronImpl::CronImpl(Root& root, afl::container::PtrVector<util::ProcessRunner>& runners)
     : Cron(), Uncopyable(), Stoppable(),
       m_root(root),
-      m_runner(runner),
       m_thread("host.cron", *this),
       m_mutex(),
       m_wake(0),
@@ -243,9 +330,13 @@ server::host::CronImpl::CronImpl(Root& root, util::ProcessRunner& runner)
       m_changedGames(),
       m_suspendUntil(0),
       m_futureEvents(),
-      m_dueEvents()
+      m_dueEvents(),
+      m_workers()
 {
     // ex Cron::Cron, Cron::start
+    for (size_t i = 0, n = runners.size(); i < n; ++i) {
+        m_workers.pushBackNew(new Worker(*this, *runners[i], getWorkDirName(i)));
+    }
     m_root.setCron(this);
     m_thread.start();
 }
@@ -256,6 +347,9 @@ server::host::CronImpl::~CronImpl()
     m_root.setCron(0);
     stop();
     m_thread.join();
+    for (size_t i = 0, n = m_workers.size(); i < n; ++i) {
+        m_workers[i]->join();
+    }
 }
 
 // Get next action for a game. Looks only at the schedules.
@@ -331,6 +425,22 @@ server::host::CronImpl::suspendScheduler(Time_t absTime)
     m_wake.post();
 }
 
+// Get status.
+server::host::Cron::Status_t
+server::host::CronImpl::getStatus()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    Status_t result;
+    for (size_t i = 0, n = m_workers.size(); i < n; ++i) {
+        if (m_workers[i]->isBusy()) {
+            ++result.numRunningGames;
+        }
+    }
+    result.numWorkers = int32_t(m_workers.size());
+    result.numWaitingGames = std::max(int32_t(m_dueEvents.size()) - result.numRunningGames, 0);
+    return result;
+}
+
 // Cron main loop.
 void
 server::host::CronImpl::run()
@@ -365,6 +475,9 @@ server::host::CronImpl::stop()
         m_stopFlag = true;
     }
     m_wake.post();
+    for (size_t i = 0, n = m_workers.size(); i < n; ++i) {
+        m_workers[i]->stop();
+    }
 }
 
 // Scheduler main entry point.
@@ -385,42 +498,27 @@ server::host::CronImpl::schedulerMain()
         // Move due items to the m_dueEvents list
         moveDueItems();
 
-        // Figure out what to do
-        enum { Nothing, Run, Wait } what = Nothing;
+        // Hand due items to idle workers
+        startDueItems();
+
+        // Figure out what to do next.
+        // Workers report completion through m_wake, so we need not wait for them explicitly.
+        bool haveFuture = false;
         Event_t item(0, HostCron::NoAction, 0);
         {
             afl::sys::MutexGuard g(m_mutex);
-            if (!m_dueEvents.empty()) {
-                item = m_dueEvents.front();
-                what = Run;
-            } else if (!m_futureEvents.empty()) {
+            if (!m_futureEvents.empty()) {
                 item = m_futureEvents.front();
-                what = Wait;
+                haveFuture = true;
             }
         }
 
-        // Process it
-        if (what == Wait) {
+        if (haveFuture) {
             // Wait for scheduled event
             int64_t ms = (m_root.getSystemTimeFromTime(item.time) - afl::sys::Time::getCurrentTime()).getMilliseconds();
             if (ms > 0) {
                 m_wake.wait(1 + afl::sys::Timeout_t(std::min(ms, int64_t(0x10000000))));
             }
-        } else if (what == Run) {
-            // Execute item
-            std::list<Event_t> newSchedule;
-            runDueItem(item.gameId, newSchedule);
-
-            {
-                // Update schedules
-                afl::sys::MutexGuard g1(m_root.mutex());
-                afl::sys::MutexGuard g2(m_mutex);
-                m_dueEvents.remove_if(IsGame(item.gameId));
-                m_futureEvents.merge(newSchedule, ByTime());
-
-                // Unlock the game
-                m_root.arbiter().unlock(item.gameId, GameArbiter::Host);
-            }
         } else {
             // Nothing to do, wait for request
             m_wake.wait();
@@ -581,11 +679,82 @@ server::host::CronImpl::moveDueItems()
     }
 }
 
+// Hand due items to idle workers.
+// Each game in m_dueEvents is processed by at most one worker.
+void
+server::host::CronImpl::startDueItems()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    for (std::list<Event_t>::const_iterator it = m_dueEvents.begin(); it != m_dueEvents.end(); ++it) {
+        // Find idle worker; check that game is not already being processed
+        Worker* idle = 0;
+        bool running = false;
+        for (size_t i = 0, n = m_workers.size(); i < n; ++i) {
+            Worker* w = m_workers[i];
+            if (w->getGameId() == it->gameId) {
+                running = true;
+            } else if (idle == 0 && !w->isBusy()) {
+                idle = w;
+            }
+        }
+
+        if (!running) {
+            if (idle == 0) {
+                // All workers busy
+                break;
+            }
+            idle->start(it->gameId);
+        }
+    }
+}
+
+// Process a due item in a worker.
+// Runs the item, updates the schedule, and makes the worker available again.
+// \param worker Worker
+// \param gameId Game to work on
+void
+server::host::CronImpl::processDueItem(Worker& worker, int32_t gameId)
+{
+    // Execute item
+    std::list<Event_t> newSchedule;
+    bool failed = false;
+    try {
+        runDueItem(worker.runner(), worker.getWorkDirName(), gameId, newSchedule);
+    }
+    catch (std::exception& e) {
+        // Not a host error (those are handled by runDueItem), but e.g. a database problem.
+        // Have the game reconsidered instead of losing it.
+        m_root.log().write(afl::sys::LogListener::Error, "host.except", afl::string::Format("Exception in worker for game %d", gameId), e);
+        newSchedule.clear();
+        failed = true;
+    }
+
+    {
+        // Update schedules
+        afl::sys::MutexGuard g1(m_root.mutex());
+        afl::sys::MutexGuard g2(m_mutex);
+        m_dueEvents.remove_if(IsGame(gameId));
+        m_futureEvents.merge(newSchedule, ByTime());
+        if (failed) {
+            m_changedGames.push_back(gameId);
+        }
+
+        // Unlock the game
+        m_root.arbiter().unlock(gameId, GameArbiter::Host);
+        worker.setIdle();
+    }
+
+    // Let scheduler hand out the next item
+    m_wake.post();
+}
+
 // Run due item.
+// \param runner      [in]  ProcessRunner to use
+// \param workDirName [in]  Name of work directory to use
 // \param gameId      [in]  Game to work on
 // \param newSchedule [out] New schedule for next event will be produced here
 void
-server::host::CronImpl::runDueItem(const int32_t gameId, std::list<Event_t>& newSchedule)
+server::host::CronImpl::runDueItem(util::ProcessRunner& runner, const String_t& workDirName, const int32_t gameId, std::list<Event_t>& newSchedule)
 {
     // ex Cron::runDueItem
     // Check that schedule is still current (it should be because the game is locked).
@@ -621,9 +790,9 @@ server::host::CronImpl::runDueItem(const int32_t gameId, std::list<Event_t>& new
         Event_t& item = newSchedule.front();
         logAction("executing", newSchedule.front());
         if (item.action == HostCron::HostAction) {
-            runHost(m_runner, m_root, gameId);
+            runHost(runner, m_root, gameId, workDirName);
         } else if (item.action == HostCron::MasterAction) {
-            runMaster(m_runner, m_root, gameId);
+            runMaster(runner, m_root, gameId, workDirName);
         }
     }
     catch (std::exception& e) {
@@ -8,6 +8,7 @@
 #include <list>
 #include "afl/base/stoppable.hpp"
 #include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/sys/mutex.hpp"
 #include "afl/sys/semaphore.hpp"
 #include "afl/sys/thread.hpp"
@@ -34,20 +35,27 @@ namespace server { namespace host {
         An important property of CronImpl is that it exports the game (under exclusive access),
         runs host, and then re-imports the game (under exclusive access).
         During the host run, the game is locked using GameArbiter (e.g. preventing modifications),
-        but otherwise, the database can be accessed by other users. */
+        but otherwise, the database can be accessed by other users.
+
+        Due events are processed by a pool of workers, one per ProcessRunner given to the constructor.
+        Each worker has its own thread and work directory; the scheduler thread assigns due games to idle workers.
+        Because a game appears in m_dueEvents only once, and stays there (locked) until its worker finishes,
+        a game is never processed by two workers at the same time.
+        With a single worker, games are processed one after the other, as before. */
     class CronImpl : public Cron,
                      private afl::base::Uncopyable,
                      private afl::base::Stoppable
     {
      public:
         /** Constructor.
-            This will start a separate thread to process scheduler events.
+            This will start a separate thread to process scheduler events, and one worker thread per runner.
             \param root Service root
-            \param runner Runner to use. Should be distinct from Root's runner. */
-        CronImpl(Root& root, util::ProcessRunner& runner);
+            \param runners Runners to use, one per worker. Should be distinct from Root's runner. Should not be empty. */
+        CronImpl(Root& root, afl::container::PtrVector<util::ProcessRunner>& runners);
 
         /** Destructor.
-            This will stop the separate thread. */
+            This will stop the separate threads.
+            Workers finish the game they are working on. */
         ~CronImpl();
 
         // Cron:
@@ -55,10 +63,12 @@ namespace server { namespace host {
         virtual void listGameEvents(std::vector<Event_t>& result);
         virtual void handleGameChange(int32_t gameId);
         virtual void suspendScheduler(Time_t absTime);
+        virtual Status_t getStatus();
 
      private:
+        class Worker;
+
         Root& m_root;
-        util::ProcessRunner& m_runner;
         afl::sys::Thread m_thread;
 
         // FIXME: we can probably get rid of this mutex and rely on Root's, to avoid nested-mutex trouble.
@@ -75,6 +85,9 @@ namespace server { namespace host {
         std::list<Event_t> m_futureEvents;       ///< Future actions.
         std::list<Event_t> m_dueEvents;          ///< Due actions. Games in this list are locked if they are MasterAction or HostAction.
 
+        // Workers. Assignment of games is protected by mutex.
+        afl::container::PtrVector<Worker> m_workers;
+
         virtual void run();
         virtual void stop();
 
@@ -86,7 +99,9 @@ namespace server { namespace host {
         void generateInitialSchedule();
         void processRequests();
         void moveDueItems();
-        void runDueItem(int32_t gameId, std::list<Event_t>& newSchedule);
+        void startDueItems();
+        void processDueItem(Worker& worker, int32_t gameId);
+        void runDueItem(util::ProcessRunner& runner, const String_t& workDirName, int32_t gameId, std::list<Event_t>& newSchedule);
         void adjustForSuspension(std::list<Event_t>& newSchedule);
     };
 
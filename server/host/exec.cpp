@@ -615,13 +615,13 @@ namespace {
 
 // Run host on a game.
 void
-server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
+server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId, const String_t& workDirName)
 {
     // ex planetscentral/host/exec.h:runHost
 
     // Build base directory
     afl::base::Ref<afl::io::DirectoryEntry> workdirEntry =
-        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName("host");
+        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName(getExportDirectoryName(root.config(), gameId, workDirName));
     try {
         workdirEntry->createAsDirectory();
     }
@@ -637,7 +637,7 @@ server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
         root.configureReconnect();
         Game game(root, gameId, Game::NoExistanceCheck);
         turnNr = unimportGameData(root, game);
-        gameDir = Exporter(root.hostFile(), root.fileSystem(), root.log()).exportGame(game, root, workdirEntry->getPathName());
+        gameDir = Exporter(root.exportFile(), root.fileSystem(), root.log()).exportGame(game, root, workdirEntry->getPathName());
     }
 
     // Locate missing turns
@@ -645,7 +645,11 @@ server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
     for (int32_t i = 1; i <= Game::NUM_PLAYERS; ++i) {
         importMissingTurns(runner, root, *workdir, gameDir, gameId, i);
     }
-    BaseClient(root.hostFile()).setUserContext(String_t());
+    {
+        // Connection is shared with other threads, so this needs the mutex
+        afl::sys::MutexGuard g(root.mutex());
+        BaseClient(root.hostFile()).setUserContext(String_t());
+    }
 
     // Run host
     doRunHost(runner, root, workdirEntry->getPathName(), gameDir, gameId, turnNr+1);
@@ -655,7 +659,7 @@ server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
         afl::sys::MutexGuard g(root.mutex());
         root.configureReconnect();
         Game game(root, gameId, Game::NoExistanceCheck);
-        Exporter(root.hostFile(), root.fileSystem(), root.log()).importGame(game, root, workdirEntry->getPathName());
+        Exporter(root.exportFile(), root.fileSystem(), root.log()).importGame(game, root, workdirEntry->getPathName());
         processTurnStatus(root, gameId);
         importGameData(root, game);
         processInactivityKicks(root, gameId);
@@ -667,12 +671,12 @@ server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
 
 // Run master on a game.
 void
-server::host::runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId)
+server::host::runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId, const String_t& workDirName)
 {
     // ex planetscentral/host/exec.h:runMaster
     // Build base directory
     afl::base::Ref<afl::io::DirectoryEntry> workdirEntry =
-        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName("host");
+        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName(getExportDirectoryName(root.config(), gameId, workDirName));
     try {
         workdirEntry->createAsDirectory();
     }
@@ -685,7 +689,7 @@ server::host::runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId)
         afl::sys::MutexGuard g(root.mutex());
         root.configureReconnect();
         Game game(root, gameId, Game::NoExistanceCheck);
-        gameDir = Exporter(root.hostFile(), root.fileSystem(), root.log()).exportGame(game, root, workdirEntry->getPathName());
+        gameDir = Exporter(root.exportFile(), root.fileSystem(), root.log()).exportGame(game, root, workdirEntry->getPathName());
     }
 
     // Run it
@@ -714,7 +718,7 @@ server::host::runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId)
         afl::sys::MutexGuard g(root.mutex());
         root.configureReconnect();
         Game game(root, gameId, Game::NoExistanceCheck);
-        Exporter(root.hostFile(), root.fileSystem(), root.log()).importGame(game, root, workdirEntry->getPathName());
+        Exporter(root.exportFile(), root.fileSystem(), root.log()).importGame(game, root, workdirEntry->getPathName());
         importGameData(root, game);
         ResultSender(root, game).sendAllResults();
     }
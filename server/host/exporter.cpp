@@ -3,6 +3,8 @@
   *  \brief Class server::host::Exporter
   */
 
+#include <memory>
+#include <set>
 #include "server/host/exporter.hpp"
 #include "afl/base/countof.hpp"
 #include "afl/io/archive/tarreader.hpp"
@@ -18,6 +20,7 @@
 #include "server/file/clientdirectoryhandler.hpp"
 #include "server/file/filesystemhandler.hpp"
 #include "server/file/utils.hpp"
+#include "server/host/configuration.hpp"
 #include "server/host/game.hpp"
 #include "server/host/root.hpp"
 #include "server/interface/filebaseclient.hpp"
@@ -55,6 +58,48 @@ namespace {
         removeDirectoryContent(handler);
     }
 
+    /** Create a directory if it does not exist yet.
+        \param entry Directory entry */
+    void createDirectory(DirectoryEntry& entry)
+    {
+        // In incremental mode, the directory may already exist
+        if (entry.getFileType() != DirectoryEntry::tDirectory) {
+            entry.createAsDirectory();
+        }
+    }
+
+    /** Remove stale items from a directory.
+        Removes everything whose name is not in the given set.
+        \param fs        FileSystem instance
+        \param fsDirName Directory name
+        \param keep      Names of items to keep */
+    void removeStaleItems(afl::io::FileSystem& fs, const String_t& fsDirName, const std::set<String_t>& keep)
+    {
+        server::file::FileSystemHandler handler(fs, fsDirName);
+        server::file::InfoVector_t children;
+        server::file::listDirectory(children, handler);
+        for (size_t i = 0, n = children.size(); i < n; ++i) {
+            const server::file::DirectoryHandler::Info& ch = children[i];
+            if (keep.find(ch.name) == keep.end()) {
+                switch (ch.type) {
+                 case server::file::DirectoryHandler::IsFile:
+                    handler.removeFile(ch.name);
+                    break;
+
+                 case server::file::DirectoryHandler::IsDirectory: {
+                    std::auto_ptr<server::file::DirectoryHandler> sub(handler.getDirectory(ch));
+                    server::file::removeDirectoryContent(*sub);
+                    handler.removeDirectory(ch.name);
+                    break;
+                 }
+
+                 case server::file::DirectoryHandler::IsUnknown:
+                    break;
+                }
+            }
+        }
+    }
+
     /** Split extension off a file name.
         \param fullName [in] Full file name (without directory etc.)
         \param ext      [in] Expected extension
@@ -94,13 +139,18 @@ server::host::Exporter::exportGame(Game& game, Root& root, String_t fsDirName)
     // In classic, this only creates the c2host.ini file, and otherwise operates directly in the hostfile space.
     // c2ng uses copy-in/copy-out and therefore has to copy around files here.
     ConfigurationBuilder ini;
+    const bool incremental = root.config().incrementalExport;
 
     server::interface::BaseClient(root.hostFile()).setUserContext(String_t());
 
     uint32_t startTicks = afl::sys::Time::getTickCounter();
 
-    removeDirectoryContent(m_fileSystem, fsDirName);
+    // In incremental mode, keep previous content; stale items are removed below.
+    if (!incremental) {
+        removeDirectoryContent(m_fileSystem, fsDirName);
+    }
     Ref<Directory> target = m_fileSystem.openDirectory(fsDirName);
+    std::set<String_t> exportedItems;
 
     // Bindir
     ini.addValue("bindir", root.config().binDirectory);
@@ -112,17 +162,20 @@ server::host::Exporter::exportGame(Game& game, Root& root, String_t fsDirName)
     // Host
     String_t host = game.getConfig("host");
     ini.addValue("game_host", host);
-    exportTool(ini, *target, "host", "game_host", root.hostRoot().byName(host));
+    exportTool(ini, *target, "host", "game_host", root.hostRoot().byName(host), incremental);
+    exportedItems.insert("host");
 
     // Master
     String_t master = game.getConfig("master");
     ini.addValue("game_master", master);
-    exportTool(ini, *target, "master", "game_master", root.masterRoot().byName(master));
+    exportTool(ini, *target, "master", "game_master", root.masterRoot().byName(master), incremental);
+    exportedItems.insert("master");
 
     // Ship list
     String_t sl = game.getConfig("shiplist");
     ini.addValue("game_sl", sl);
-    exportTool(ini, *target, "shiplist", "game_sl", root.shipListRoot().byName(sl));
+    exportTool(ini, *target, "shiplist", "game_sl", root.shipListRoot().byName(sl), incremental);
+    exportedItems.insert("shiplist");
 
     // Tools
     afl::data::StringList_t tools;
@@ -130,7 +183,8 @@ server::host::Exporter::exportGame(Game& game, Root& root, String_t fsDirName)
     game.toolsByKind().getAll(tools);
     for (size_t i = 0; i+1 < tools.size(); i += 2) {
         ini.addValue("game_tool_" + tools[i], tools[i+1]);
-        exportTool(ini, *target, Format("tool%d", i), "game_tool_" + tools[i], root.toolRoot().byName(tools[i+1]));
+        exportTool(ini, *target, Format("tool%d", i), "game_tool_" + tools[i], root.toolRoot().byName(tools[i+1]), incremental);
+        exportedItems.insert(Format("tool%d", i));
         if (i != 0) {
             toolList += " ";
         }
@@ -156,13 +210,27 @@ server::host::Exporter::exportGame(Game& game, Root& root, String_t fsDirName)
     const char* GAME_PATH = "game";
     String_t gamePath = game.getDirectory();
     Ref<DirectoryEntry> gameEntry = target->getDirectoryEntryByName(GAME_PATH);
-    gameEntry->createAsDirectory();
-    exportSubdirectory(gamePath + "/in", gameEntry->getPathName(), "in");
-    exportSubdirectory(gamePath + "/out", gameEntry->getPathName(), "out");
-    exportSubdirectory(gamePath + "/data", gameEntry->getPathName(), "data");
+    createDirectory(*gameEntry);
+    exportSubdirectory(gamePath + "/in", gameEntry->getPathName(), "in", incremental);
+    exportSubdirectory(gamePath + "/out", gameEntry->getPathName(), "out", incremental);
+    exportSubdirectory(gamePath + "/data", gameEntry->getPathName(), "data", incremental);
+    exportedItems.insert(GAME_PATH);
 
     // Existing game scripts will attempt to make backups. Make the directory so they don't fail.
-    gameEntry->openDirectory()->getDirectoryEntryByName("backup")->createAsDirectory();
+    // Backups and log files are only imported, so in incremental mode, remove those from the previous run.
+    Ref<DirectoryEntry> backupEntry = gameEntry->openDirectory()->getDirectoryEntryByName("backup");
+    if (incremental) {
+        std::set<String_t> gameItems;
+        gameItems.insert("in");
+        gameItems.insert("out");
+        gameItems.insert("data");
+        gameItems.insert("backup");
+        removeStaleItems(m_fileSystem, gameEntry->getPathName(), gameItems);
+        createDirectory(*backupEntry);
+        removeDirectoryContent(m_fileSystem, backupEntry->getPathName());
+    } else {
+        backupEntry->createAsDirectory();
+    }
 
     // Create 'new' directory.
     // This directory is no longer part of the filespace
@@ -178,15 +246,22 @@ server::host::Exporter::exportGame(Game& game, Root& root, String_t fsDirName)
     { }
 
     // Main scripts
-    exportSubdirectory("bin", fsDirName, "bin");
-    exportSubdirectory("defaults", fsDirName, "defaults");
+    exportSubdirectory("bin", fsDirName, "bin", incremental);
+    exportSubdirectory("defaults", fsDirName, "defaults", incremental);
+    exportedItems.insert("bin");
+    exportedItems.insert("defaults");
+
+    // Remove leftovers of previous exports (e.g. tools no longer in use)
+    if (incremental) {
+        removeStaleItems(m_fileSystem, fsDirName, exportedItems);
+    }
 
     // Save config
     storeConfigurationFile(ini, *gameEntry->openDirectory());
 
     // Log
     uint32_t elapsedTicks = afl::sys::Time::getTickCounter() - startTicks;
-    m_log.write(afl::sys::LogListener::Info, LOG_NAME, Format("Export complete: host:%s -> %s, %d ms", gamePath, fsDirName, elapsedTicks));
+    m_log.write(afl::sys::LogListener::Info, LOG_NAME, Format("Export complete: host:%s -> %s, %d ms%s", gamePath, fsDirName, elapsedTicks, incremental ? " (incremental)" : ""));
 
     return GAME_PATH;
 }
@@ -209,9 +284,10 @@ server::host::Exporter::importGame(Game& game, Root& root, String_t fsDirName)
     importBackups(gamePath + "/backup", gameEntry->getPathName(), "backup", root.config().unpackBackups);
 
     // Remainder
-    importSubdirectory(gamePath + "/in", gameEntry->getPathName(), "in");
-    importSubdirectory(gamePath + "/out", gameEntry->getPathName(), "out");
-    importSubdirectory(gamePath + "/data", gameEntry->getPathName(), "data");
+    const bool incremental = root.config().incrementalExport;
+    importSubdirectory(gamePath + "/in", gameEntry->getPathName(), "in", incremental);
+    importSubdirectory(gamePath + "/out", gameEntry->getPathName(), "out", incremental);
+    importSubdirectory(gamePath + "/data", gameEntry->getPathName(), "data", incremental);
     importLogFiles(gamePath, gameEntry->getPathName());
 
     // Log
@@ -221,21 +297,27 @@ server::host::Exporter::importGame(Game& game, Root& root, String_t fsDirName)
 
 // Export a tool.
 void
-server::host::Exporter::exportTool(ConfigurationBuilder& ini, afl::io::Directory& parent, const String_t& dirName, const String_t& prefix, afl::net::redis::HashKey hash)
+server::host::Exporter::exportTool(ConfigurationBuilder& ini, afl::io::Directory& parent, const String_t& dirName, const String_t& prefix, afl::net::redis::HashKey hash, bool incremental)
 {
     // Create target directory
     Ref<DirectoryEntry> dirEntry = parent.getDirectoryEntryByName(dirName);
-    dirEntry->createAsDirectory();
+    createDirectory(*dirEntry);
 
     // Get source directory
     String_t sourceName = hash.stringField("path").get();
 
     // Sync
+    server::file::FileSystemHandler targetHandler(m_fileSystem, dirEntry->getPathName(), incremental);
     if (!sourceName.empty()) {
         m_log.write(afl::sys::LogListener::Trace, LOG_NAME, Format("Exporting host:%s -> %s (tool)", sourceName, dirEntry->getPathName()));
-        server::file::FileSystemHandler targetHandler(m_fileSystem, dirEntry->getPathName());
         server::file::ClientDirectoryHandler sourceHandler(m_source, sourceName);
-        copyDirectory(targetHandler, sourceHandler, server::file::CopyFlags_t(server::file::CopyRecursively));
+        if (incremental) {
+            synchronizeDirectories(targetHandler, sourceHandler);
+        } else {
+            copyDirectory(targetHandler, sourceHandler, server::file::CopyFlags_t(server::file::CopyRecursively));
+        }
+    } else if (incremental) {
+        server::file::removeDirectoryContent(targetHandler);
     }
 
     // Copy config
@@ -273,17 +355,21 @@ server::host::Exporter::exportTool(ConfigurationBuilder& ini, afl::io::Directory
 
 // Export a subdirectory.
 void
-server::host::Exporter::exportSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub)
+server::host::Exporter::exportSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub, bool incremental)
 {
     // Create target
     Ref<DirectoryEntry> dirEntry = m_fileSystem.openDirectory(targetBase)->getDirectoryEntryByName(targetSub);
-    dirEntry->createAsDirectory();
+    createDirectory(*dirEntry);
 
     // Copy
     m_log.write(afl::sys::LogListener::Trace, LOG_NAME, Format("Exporting host:%s -> %s (game)", source, dirEntry->getPathName()));
-    server::file::FileSystemHandler targetHandler(m_fileSystem, dirEntry->getPathName());
+    server::file::FileSystemHandler targetHandler(m_fileSystem, dirEntry->getPathName(), incremental);
     server::file::ClientDirectoryHandler sourceHandler(m_source, source);
-    copyDirectory(targetHandler, sourceHandler, server::file::CopyFlags_t(server::file::CopyRecursively));
+    if (incremental) {
+        synchronizeDirectories(targetHandler, sourceHandler);
+    } else {
+        copyDirectory(targetHandler, sourceHandler, server::file::CopyFlags_t(server::file::CopyRecursively));
+    }
 }
 
 // Store configuration file.
@@ -297,12 +383,13 @@ server::host::Exporter::storeConfigurationFile(const ConfigurationBuilder& ini,
 
 // Import a subdirectory.
 void
-server::host::Exporter::importSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub)
+server::host::Exporter::importSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub, bool incremental)
 {
     String_t targetName = m_fileSystem.makePathName(targetBase, targetSub);
     m_log.write(afl::sys::LogListener::Trace, LOG_NAME, Format("Importing host:%s <- %s (game)", source, targetName));
 
-    server::file::FileSystemHandler targetHandler(m_fileSystem, targetName);
+    // In incremental mode, compute content Ids so unchanged files are not transferred.
+    server::file::FileSystemHandler targetHandler(m_fileSystem, targetName, incremental);
     server::file::ClientDirectoryHandler sourceHandler(m_source, source);
 
     // This synchronizes the target back into the source.
@@ -383,3 +470,14 @@ server::host::Exporter::importTarball(const String_t& source, const String_t& ta
         }
     }
 }
+
+// Get name of work directory for exporting a game.
+String_t
+server::host::getExportDirectoryName(const Configuration& config, int32_t gameId, const String_t& sharedName)
+{
+    if (config.incrementalExport) {
+        return Format("game%d", gameId);
+    } else {
+        return sharedName;
+    }
+}
@@ -16,6 +16,7 @@ namespace server { namespace host {
 
     class Game;
     class Root;
+    struct Configuration;
 
     /** Exporter.
         Unlike c2host-classic, c2host-ng will not rely on sharing a dataspace with the host filer.
@@ -45,7 +46,19 @@ namespace server { namespace host {
 
         This export will be performed for every host action (checkturn, master, host).
         On a well-populated game, export will move give-or-take 5 megabytes.
-        Using c2file-classic, this will take a few seconds; using c2file-ng, it will be <1 second. */
+        Using c2file-classic, this will take a few seconds; using c2file-ng, it will be <1 second.
+
+        <b>Incremental mode:</b>
+
+        If enabled in the configuration (Configuration::incrementalExport), the target directory is kept between runs
+        (see getExportDirectoryName()), and export/import only transfer files whose content differs.
+        Files are compared by content Id: the host filer reports them (c2file-ng with CA backend),
+        and the local copy computes them from the file content (see server::file::FileSystemHandler).
+        If the host filer does not report content Ids, all files are transferred as in normal mode,
+        but stale files are still removed instead of clearing the whole directory.
+
+        Items in the target directory that are not part of an export (e.g. old log files, tools no longer used)
+        are removed on export, so the result is the same as in normal mode. */
     class Exporter {
      public:
         /** Constructor.
@@ -82,15 +95,17 @@ namespace server { namespace host {
             \param parent  [in] Root directory for export (same as fsDirName)
             \param dirName [in] Name of directory to export to (relative to parent), will be created
             \param prefix  [in] Prefix for configuration variables
-            \param hash    [in] Tool configuration hash from database */
-        void exportTool(ConfigurationBuilder& ini, afl::io::Directory& parent, const String_t& dirName, const String_t& prefix, afl::net::redis::HashKey hash);
+            \param hash    [in] Tool configuration hash from database
+            \param incremental [in] true to synchronize an existing directory, false to copy into an empty one */
+        void exportTool(ConfigurationBuilder& ini, afl::io::Directory& parent, const String_t& dirName, const String_t& prefix, afl::net::redis::HashKey hash, bool incremental);
 
         /** Export a subdirectory.
             Exports the content of \c source into a directory \c targetSub, created beneath \c targetBase.
-            \param source     [in] Source directory in host filer
-            \param targetBase [in] Output base directory
-            \param targetSub  [in] Output directory, relative to \c targetBase, will be created */
-        void exportSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub);
+            \param source      [in] Source directory in host filer
+            \param targetBase  [in] Output base directory
+            \param targetSub   [in] Output directory, relative to \c targetBase, will be created
+            \param incremental [in] true to synchronize an existing directory, false to copy into an empty one */
+        void exportSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub, bool incremental);
 
         /** Store configuration file.
             \param ini    [in] Configuration
@@ -99,10 +114,11 @@ namespace server { namespace host {
 
         /** Import a subdirectory.
             This is the inverse operation to exportSubdirectory.
-            \param source     [in] Source (target) directory in host filer
-            \param targetBase [in] Output (input) base directory
-            \param targetSub  [in] Output (input) directory, relative to \c targetBase */
-        void importSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub);
+            \param source      [in] Source (target) directory in host filer
+            \param targetBase  [in] Output (input) base directory
+            \param targetSub   [in] Output (input) directory, relative to \c targetBase
+            \param incremental [in] true to only transfer changed files */
+        void importSubdirectory(const String_t& source, const String_t& targetBase, const String_t& targetSub, bool incremental);
 
         /** Import logfiles.
             Logfiles are only imported, stale/outdated logfiles not overwritten.
@@ -131,6 +147,15 @@ namespace server { namespace host {
         afl::sys::LogListener& m_log;
     };
 
+    /** Get name of work directory for exporting a game.
+        In incremental mode, every game has its own persistent directory.
+        Otherwise, the given shared directory is used; it is cleared on every export.
+        \param config     Configuration
+        \param gameId     Game Id
+        \param sharedName Name of shared directory (e.g. "check")
+        \return Directory name, relative to Configuration::workDirectory */
+    String_t getExportDirectoryName(const Configuration& config, int32_t gameId, const String_t& sharedName);
+
 } }
 
 #endif
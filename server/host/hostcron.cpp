@@ -121,3 +121,16 @@ server::host::HostCron::getBrokenGames(BrokenMap_t& result)
     }
 }
 
+// Get scheduler status.
+server::interface::HostCron::Status
+server::host::HostCron::getStatus()
+{
+    // Must be admin
+    m_session.checkAdmin();
+
+    if (Cron* p = m_root.getCron()) {
+        return p->getStatus();
+    } else {
+        return Status();
+    }
+}
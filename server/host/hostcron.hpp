@@ -26,6 +26,7 @@ namespace server { namespace host {
         virtual bool kickstartGame(int32_t gameId);
         virtual void suspendScheduler(int32_t relativeTime);
         virtual void getBrokenGames(BrokenMap_t& result);
+        virtual Status getStatus();
 
      private:
         const Session& m_session;
@@ -182,7 +182,7 @@ server::host::HostTurn::submit(const String_t& blob,
 
     // Build base directory
     afl::base::Ref<afl::io::DirectoryEntry> workdirEntry =
-        m_root.fileSystem().openDirectory(m_root.config().workDirectory)->getDirectoryEntryByName("check");
+        m_root.fileSystem().openDirectory(m_root.config().workDirectory)->getDirectoryEntryByName(getExportDirectoryName(m_root.config(), gameNumber, "check"));
     try {
         workdirEntry->createAsDirectory();
     }
@@ -192,7 +192,7 @@ server::host::HostTurn::submit(const String_t& blob,
     // Export
     String_t relative;
     try {
-        relative = Exporter(m_root.hostFile(), m_root.fileSystem(), m_root.log()).exportGame(game, m_root, workdirEntry->getPathName());
+        relative = Exporter(m_root.exportFile(), m_root.fileSystem(), m_root.log()).exportGame(game, m_root, workdirEntry->getPathName());
     }
     catch (std::exception& e) {
         // Convert errors.
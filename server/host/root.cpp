@@ -63,6 +63,7 @@ server::host::Root::Root(afl::net::CommandHandler& db,
       m_pTalkListener(0),
       m_pCron(0),
       m_pRouter(0),
+      m_pExportFile(0),
       m_config(config),
       m_rng(afl::sys::Time::getTickCounter())
 { }
@@ -97,8 +98,12 @@ server::host::Root::configureReconnect()
     // - mail queue is stateful. However, since we only have the interface reference, we cannot access the underlying CommandHandler.
     //   However, the worst thing that can happen if the connection drops midway is that a result mail gets lost,
     //   which I consider acceptable.
+    // - export file does not carry a user context, but follows the same rules as host file
     configure(m_hostFile);
     configure(m_userFile);
+    if (m_pExportFile != 0) {
+        configure(*m_pExportFile);
+    }
 }
 
 void
@@ -119,6 +124,12 @@ server::host::Root::setRouter(server::interface::SessionRouter* p)
     m_pRouter = p;
 }
 
+void
+server::host::Root::setExportFile(afl::net::CommandHandler* p)
+{
+    m_pExportFile = p;
+}
+
 afl::net::CommandHandler&
 server::host::Root::hostFile()
 {
@@ -126,6 +137,12 @@ server::host::Root::hostFile()
     return m_hostFile;
 }
 
+afl::net::CommandHandler&
+server::host::Root::exportFile()
+{
+    return m_pExportFile != 0 ? *m_pExportFile : m_hostFile;
+}
+
 afl::net::CommandHandler&
 server::host::Root::userFile()
 {
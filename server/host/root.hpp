@@ -96,10 +96,21 @@ namespace server { namespace host {
             The host server can run with or without a session router. */
         void setRouter(server::interface::SessionRouter* p);
 
+        /** Set host filer connection for exports.
+            Exporter transfers many files; a connection supporting batches (server::interface::BatchCommandHandler)
+            saves a round-trip per file. That connection must not carry a user context.
+            Its reconnect behaviour is set by configureReconnect(), like for hostFile().
+            If not set, hostFile() is used. */
+        void setExportFile(afl::net::CommandHandler* p);
+
         /** Access host filer.
             \return host filer */
         afl::net::CommandHandler& hostFile();
 
+        /** Access host filer for exports.
+            \return host filer connection set using setExportFile(), or hostFile() */
+        afl::net::CommandHandler& exportFile();
+
         /** Access user filer.
             \return user filer */
         afl::net::CommandHandler& userFile();
@@ -215,6 +226,7 @@ namespace server { namespace host {
         TalkListener* m_pTalkListener;
         Cron* m_pCron;
         server::interface::SessionRouter* m_pRouter;
+        afl::net::CommandHandler* m_pExportFile;
 
         Configuration m_config;
         util::RandomNumberGenerator m_rng;
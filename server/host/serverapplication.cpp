@@ -4,6 +4,7 @@
   */
 
 #include "server/host/serverapplication.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/except/commandlineexception.hpp"
 #include "afl/except/fileproblemexception.hpp"
 #include "afl/io/directory.hpp"
@@ -23,6 +24,7 @@
 #include "server/host/session.hpp"
 #include "server/host/talkadapter.hpp"
 #include "server/interface/mailqueueclient.hpp"
+#include "server/interface/pipelinedclient.hpp"
 #include "server/interface/sessionrouterclient.hpp"
 #include "server/interface/talkforumclient.hpp"
 #include "server/ports.hpp"
@@ -34,6 +36,9 @@ using afl::async::InterruptOperation;
 
 namespace {
     const char LOG_NAME[] = "host";
+
+    /* Maximum number of host workers (Host.Workers). Each one needs a helper process. */
+    const int MAX_HOST_WORKERS = 32;
 }
 
 server::host::ServerApplication::ServerApplication(afl::sys::Environment& env, afl::io::FileSystem& fs, afl::net::NetworkStack& net, afl::async::Interrupt& intr)
@@ -84,7 +89,10 @@ server::host::ServerApplication::serverMain()
     // is now feasible as all afl components properly set FD_CLOEXEC. However, this complicates matters, and having the
     // extra process around and wasting a few kilobytes of memory for a non-production usecase just isn't worth it.
     util::ProcessRunner checkturnRunner;
-    util::ProcessRunner hostRunner;
+    afl::container::PtrVector<util::ProcessRunner> hostRunners;
+    for (int i = 0; i < m_config.numHostWorkers; ++i) {
+        hostRunners.pushBackNew(new util::ProcessRunner());
+    }
 
     // Set up work directory
     setupWorkDirectory();
@@ -102,6 +110,10 @@ server::host::ServerApplication::serverMain()
     Root root(db, hostFile, userFile, mailClient, checkturnRunner, fileSystem(), m_config);
     root.log().addListener(log());
 
+    // Exports use a separate connection that can send file transfers in batches.
+    // Reconnect is configured by Root::configureReconnect(), like for hostFile.
+    root.setExportFile(&del.addNew(new server::interface::PipelinedClient(clientNetworkStack(), m_config.hostFileAddress)));
+
     // Set up talk if desired
     if (!m_talkAddress.getName().empty()) {
         // We are only using stateless commands with the forum, so just use auto-reconnect.
@@ -118,7 +130,7 @@ server::host::ServerApplication::serverMain()
     // Set up cron if desired
     std::auto_ptr<Cron> pCron;
     if (m_config.useCron) {
-        pCron.reset(new CronImpl(root, hostRunner));
+        pCron.reset(new CronImpl(root, hostRunners));
         if (m_config.initialSuspend > 0) {
             pCron->suspendScheduler(root.getTime() + m_config.initialSuspend);
         }
@@ -217,11 +229,39 @@ server::host::ServerApplication::handleConfiguration(const String_t& key, const
             throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
         }
         return true;
+    } else if (key == "HOST.EXPORT") {
+        /* @q Host.Export:Str (Config)
+           How to export games for running host, master and checkturn.
+           - full: (default) copy all files into a shared directory every time
+           - incremental: keep a directory per game below {Host.WorkDir (Config)}, transfer only changed files.
+             This needs a host filer that reports content Ids (CA backend) to be effective.
+           @since PCC2 2.41 */
+        if (value == "full") {
+            m_config.incrementalExport = false;
+        } else if (value == "incremental") {
+            m_config.incrementalExport = true;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (key == "HOST.THREADS") {
         /* @q Host.Threads:Int (Config)
            Ignored in c2ng/c2host-server for compatibility reasons.
            Number of threads (=maximum number of parallel connections). */
         return true;
+    } else if (key == "HOST.WORKERS") {
+        /* @q Host.Workers:Int (Config)
+           Number of games that can be hosted/mastered in parallel.
+           Each worker uses its own helper process and its own directory below {Host.WorkDir (Config)}.
+           Default is 1, i.e. games are processed one after the other.
+           @since PCC2 2.41 */
+        int n;
+        if (afl::string::strToInteger(value, n) && n > 0 && n <= MAX_HOST_WORKERS) {
+            m_config.numHostWorkers = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (key == "HOST.INITIALSUSPEND") {
         /* @q Host.InitialSuspend:Int (Config)
            Suspend scheduler for the given relative time after startup.
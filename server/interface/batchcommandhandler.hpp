@@ -0,0 +1,32 @@
+/**
+  *  \file server/interface/batchcommandhandler.hpp
+  *  \brief Interface server::interface::BatchCommandHandler
+  */
+#ifndef C2NG_SERVER_INTERFACE_BATCHCOMMANDHANDLER_HPP
+#define C2NG_SERVER_INTERFACE_BATCHCOMMANDHANDLER_HPP
+
+#include "afl/net/commandhandler.hpp"
+
+namespace server { namespace interface {
+
+    class CommandBatch;
+
+    /** CommandHandler that can execute a batch of commands at once.
+        A network client implementing this interface can send all commands of a batch
+        before waiting for the replies, saving a round-trip per command.
+
+        \see CommandBatch::execute() */
+    class BatchCommandHandler : public afl::net::CommandHandler {
+     public:
+        /** Execute a batch of commands.
+            Must execute all commands of the batch in order,
+            and set each command's result using CommandBatch::setResult() or CommandBatch::setError().
+            Errors of individual commands are reported through the batch;
+            an exception means the batch could not be executed at all (e.g. connection loss).
+            \param batch Batch */
+        virtual void callBatch(CommandBatch& batch) = 0;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,124 @@
+/**
+  *  \file server/interface/commandbatch.cpp
+  *  \brief Class server::interface::CommandBatch
+  */
+
+#include <stdexcept>
+#include "server/interface/commandbatch.hpp"
+#include "afl/except/remoteerrorexception.hpp"
+#include "server/interface/batchcommandhandler.hpp"
+
+// Constructor.
+server::interface::CommandBatch::CommandBatch()
+    : m_commands()
+{ }
+
+// Destructor.
+server::interface::CommandBatch::~CommandBatch()
+{ }
+
+// Add a command.
+server::interface::CommandBatch::Segment_t&
+server::interface::CommandBatch::add()
+{
+    return m_commands.pushBackNew(new Command())->command;
+}
+
+// Get number of commands.
+size_t
+server::interface::CommandBatch::size() const
+{
+    return m_commands.size();
+}
+
+// Get command.
+const server::interface::CommandBatch::Segment_t&
+server::interface::CommandBatch::getCommand(size_t index) const
+{
+    return m_commands[index]->command;
+}
+
+// Execute all commands.
+void
+server::interface::CommandBatch::execute(afl::net::CommandHandler& handler)
+{
+    if (BatchCommandHandler* batchHandler = dynamic_cast<BatchCommandHandler*>(&handler)) {
+        batchHandler->callBatch(*this);
+    } else {
+        for (size_t i = 0, n = m_commands.size(); i < n; ++i) {
+            try {
+                setResult(i, handler.call(m_commands[i]->command));
+            }
+            catch (afl::except::RemoteErrorException& e) {
+                setRemoteError(i, e.getFileName(), e.what());
+            }
+            catch (std::exception& e) {
+                setError(i, e.what());
+            }
+        }
+    }
+}
+
+// Set result of a command.
+void
+server::interface::CommandBatch::setResult(size_t index, Value_t* value)
+{
+    Command& cmd = *m_commands[index];
+    cmd.result.reset(value);
+    cmd.errorMessage.clear();
+    cmd.errorSource.clear();
+    cmd.failed = false;
+    cmd.remote = false;
+}
+
+// Set error of a command.
+void
+server::interface::CommandBatch::setError(size_t index, const String_t& message)
+{
+    Command& cmd = *m_commands[index];
+    cmd.result.reset();
+    cmd.errorMessage = message;
+    cmd.errorSource.clear();
+    cmd.failed = true;
+    cmd.remote = false;
+}
+
+// Set error reported by a remote service.
+void
+server::interface::CommandBatch::setRemoteError(size_t index, const String_t& source, const String_t& message)
+{
+    Command& cmd = *m_commands[index];
+    cmd.result.reset();
+    cmd.errorMessage = message;
+    cmd.errorSource = source;
+    cmd.failed = true;
+    cmd.remote = true;
+}
+
+// Check whether command failed.
+bool
+server::interface::CommandBatch::isError(size_t index) const
+{
+    return m_commands[index]->failed;
+}
+
+// Get result of a command.
+const server::interface::CommandBatch::Value_t*
+server::interface::CommandBatch::getResult(size_t index) const
+{
+    const Command& cmd = *m_commands[index];
+    if (cmd.failed) {
+        if (cmd.remote) {
+            throw afl::except::RemoteErrorException(cmd.errorSource, cmd.errorMessage);
+        }
+        throw std::runtime_error(cmd.errorMessage);
+    }
+    return cmd.result.get();
+}
+
+// Remove all commands.
+void
+server::interface::CommandBatch::clear()
+{
+    m_commands.clear();
+}
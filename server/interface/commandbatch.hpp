@@ -0,0 +1,114 @@
+/**
+  *  \file server/interface/commandbatch.hpp
+  *  \brief Class server::interface::CommandBatch
+  */
+#ifndef C2NG_SERVER_INTERFACE_COMMANDBATCH_HPP
+#define C2NG_SERVER_INTERFACE_COMMANDBATCH_HPP
+
+#include <memory>
+#include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/data/segment.hpp"
+#include "afl/data/value.hpp"
+#include "afl/net/commandhandler.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace interface {
+
+    /** Batch of commands.
+        Collects a list of commands, executes them as a group, and stores each command's result or error.
+
+        If the CommandHandler executing the batch is a BatchCommandHandler,
+        it can send all commands at once (e.g. pipelined on a network connection), saving round-trips.
+        Otherwise, the commands are executed one-by-one.
+
+        In either case, all commands are executed, even if some fail;
+        the error is reported when the result of the failed command is retrieved.
+
+        Usage:
+        - call add() for each command and fill in the returned Segment
+        - call execute()
+        - retrieve the results using getResult() */
+    class CommandBatch : private afl::base::Uncopyable {
+     public:
+        typedef afl::data::Segment Segment_t;
+        typedef afl::data::Value Value_t;
+
+        /** Constructor.
+            Makes an empty batch. */
+        CommandBatch();
+
+        /** Destructor. */
+        ~CommandBatch();
+
+        /** Add a command.
+            \return Segment to receive the command (verb and parameters) */
+        Segment_t& add();
+
+        /** Get number of commands.
+            \return number of commands */
+        size_t size() const;
+
+        /** Get command.
+            \param index Index [0,size())
+            \return command */
+        const Segment_t& getCommand(size_t index) const;
+
+        /** Execute all commands.
+            \param handler CommandHandler */
+        void execute(afl::net::CommandHandler& handler);
+
+        /** Set result of a command.
+            For use by BatchCommandHandler implementations.
+            \param index Index [0,size())
+            \param value Newly-allocated result; CommandBatch takes ownership */
+        void setResult(size_t index, Value_t* value);
+
+        /** Set error of a command.
+            For use by BatchCommandHandler implementations.
+            \param index Index [0,size())
+            \param message Error message */
+        void setError(size_t index, const String_t& message);
+
+        /** Set error reported by a remote service.
+            For use by BatchCommandHandler implementations.
+            getResult() will report this error as afl::except::RemoteErrorException, like a single call would.
+            \param index Index [0,size())
+            \param source Name of the service (see afl::except::RemoteErrorException)
+            \param message Error message */
+        void setRemoteError(size_t index, const String_t& source, const String_t& message);
+
+        /** Check whether command failed.
+            \param index Index [0,size())
+            \return true if command has reported an error */
+        bool isError(size_t index) const;
+
+        /** Get result of a command.
+            \param index Index [0,size())
+            \return result, owned by CommandBatch; can be null
+            \throw afl::except::RemoteErrorException if the command failed with an error from a remote service
+            \throw std::runtime_error if the command failed otherwise */
+        const Value_t* getResult(size_t index) const;
+
+        /** Remove all commands. */
+        void clear();
+
+     private:
+        struct Command {
+            Segment_t command;
+            std::auto_ptr<Value_t> result;
+            String_t errorMessage;
+            String_t errorSource;
+            bool failed;
+            bool remote;
+
+            Command()
+                : command(), result(), errorMessage(), errorSource(), failed(false), remote(false)
+                { }
+        };
+        afl::container::PtrVector<Command> m_commands;
+    };
+
+} }
+
+#endif
@@ -8,6 +8,7 @@
 #include <vector>
 #include "afl/base/deletable.hpp"
 #include "afl/base/optional.hpp"
+#include "afl/base/types.hpp"
 #include "afl/string/string.hpp"
 
 namespace server { namespace interface {
@@ -50,6 +51,34 @@ namespace server { namespace interface {
                 { }
         };
 
+        /** Render cache status. */
+        struct CacheStatus {
+            int32_t numEntries;                           ///< Number of rendered pages in cache.
+            int32_t totalSize;                            ///< Total size of cache content, bytes.
+            int32_t numHits;                              ///< Number of render requests answered from cache.
+            int32_t numMisses;                            ///< Number of render requests that needed rendering.
+            CacheStatus()
+                : numEntries(), totalSize(), numHits(), numMisses()
+                { }
+        };
+
+        /** Options for search(). */
+        struct SearchOptions {
+            afl::base::Optional<String_t> docId;          ///< If given, only search within this document.
+            afl::base::Optional<int32_t> maxResults;      ///< Maximum number of results.
+        };
+
+        /** Search result. */
+        struct SearchResult {
+            String_t nodeId;                              ///< Id (=path) of node.
+            String_t title;                               ///< Title (=heading).
+            String_t snippet;                             ///< Excerpt of the text showing the match.
+            int32_t score;                                ///< Score; higher is better.
+            SearchResult()
+                : nodeId(), title(), snippet(), score()
+                { }
+        };
+
         static const int NAV_PREVIOUS_INDIRECT = -2;      ///< Previous indirect (e.g. last child of previous sibling).
         static const int NAV_PREVIOUS_DIRECT = -1;        ///< Previous direct (previous sibling).
         static const int NAV_UP = 0;                      ///< Up (direct parent).
@@ -70,6 +99,19 @@ namespace server { namespace interface {
             @return formatted blob, UTF-8 */
         virtual String_t renderNode(String_t nodeId, const RenderOptions& opts) = 0;
 
+        /** Pre-render all pages (PRERENDER).
+            Renders all nodes that have content, using the given options, and places the results in the render cache,
+            so that following renderNode() calls with the same options are answered from cache.
+            Nodes are addressed using their primary Id.
+
+            @param opts    Options
+            @return number of nodes rendered (i.e. not found in cache) */
+        virtual int32_t prerenderNodes(const RenderOptions& opts) = 0;
+
+        /** Get render cache status (CACHESTAT).
+            @return status */
+        virtual CacheStatus getCacheStatus() = 0;
+
         /** Get information about a node (STAT).
             @param nodeId  Node Id
             @return node information */
@@ -95,6 +137,13 @@ namespace server { namespace interface {
             @param nodeId  Node Id
             @return related nodes; infoTag is nonzero if text is identical to current page */
         virtual std::vector<NodeInfo> getNodeRelatedVersions(String_t nodeId) = 0;
+
+        /** Full-text search (SEARCH).
+            Finds nodes containing all words of the query.
+            @param query   Search query (words)
+            @param opts    Options
+            @return results, best first */
+        virtual std::vector<SearchResult> search(String_t query, const SearchOptions& opts) = 0;
     };
 
 } }
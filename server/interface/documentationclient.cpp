@@ -41,6 +41,18 @@ namespace {
             cmd.pushBackString("ACROSS");
         }
     }
+
+    void packSearchOptions(Segment& cmd, const Documentation::SearchOptions& opts)
+    {
+        if (const String_t* p = opts.docId.get()) {
+            cmd.pushBackString("IN");
+            cmd.pushBackString(*p);
+        }
+        if (const int32_t* p = opts.maxResults.get()) {
+            cmd.pushBackString("LIMIT");
+            cmd.pushBackInteger(*p);
+        }
+    }
 }
 
 server::interface::DocumentationClient::DocumentationClient(afl::net::CommandHandler& commandHandler)
@@ -67,6 +79,29 @@ server::interface::DocumentationClient::renderNode(String_t nodeId, const Render
     return m_commandHandler.callString(cmd);
 }
 
+int32_t
+server::interface::DocumentationClient::prerenderNodes(const RenderOptions& opts)
+{
+    Segment cmd;
+    cmd.pushBackString("PRERENDER");
+    packRenderOptions(cmd, opts);
+    return m_commandHandler.callInt(cmd);
+}
+
+Documentation::CacheStatus
+server::interface::DocumentationClient::getCacheStatus()
+{
+    std::auto_ptr<Value_t> p(m_commandHandler.call(Segment().pushBackString("CACHESTAT")));
+    afl::data::Access a(p.get());
+
+    CacheStatus result;
+    result.numEntries = a("entries").toInteger();
+    result.totalSize  = a("size").toInteger();
+    result.numHits    = a("hits").toInteger();
+    result.numMisses  = a("misses").toInteger();
+    return result;
+}
+
 Documentation::NodeInfo
 server::interface::DocumentationClient::getNodeInfo(String_t nodeId)
 {
@@ -107,6 +142,29 @@ server::interface::DocumentationClient::getNodeRelatedVersions(String_t nodeId)
     return unpackNodeInfos(p.get());
 }
 
+std::vector<Documentation::SearchResult>
+server::interface::DocumentationClient::search(String_t query, const SearchOptions& opts)
+{
+    Segment cmd;
+    cmd.pushBackString("SEARCH");
+    cmd.pushBackString(query);
+    packSearchOptions(cmd, opts);
+
+    std::auto_ptr<Value_t> p(m_commandHandler.call(cmd));
+    afl::data::Access a(p.get());
+
+    std::vector<SearchResult> result;
+    for (size_t i = 0, n = a.getArraySize(); i < n; ++i) {
+        SearchResult r;
+        r.nodeId  = a[i]("id").toString();
+        r.title   = a[i]("title").toString();
+        r.snippet = a[i]("snippet").toString();
+        r.score   = a[i]("score").toInteger();
+        result.push_back(r);
+    }
+    return result;
+}
+
 Documentation::NodeInfo
 server::interface::DocumentationClient::unpackNodeInfo(afl::data::Access a)
 {
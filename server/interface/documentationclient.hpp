@@ -22,11 +22,14 @@ namespace server { namespace interface {
         // Interface methods:
         virtual String_t getBlob(String_t blobId);
         virtual String_t renderNode(String_t nodeId, const RenderOptions& opts);
+        virtual int32_t prerenderNodes(const RenderOptions& opts);
+        virtual CacheStatus getCacheStatus();
         virtual NodeInfo getNodeInfo(String_t nodeId);
         virtual std::vector<NodeInfo> getNodeChildren(String_t nodeId, const ChildOptions& opts);
         virtual std::vector<NodeInfo> getNodeParents(String_t nodeId);
         virtual std::vector<NodeInfo> getNodeNavigationContext(String_t nodeId);
         virtual std::vector<NodeInfo> getNodeRelatedVersions(String_t nodeId);
+        virtual std::vector<SearchResult> search(String_t query, const SearchOptions& opts);
 
         static NodeInfo unpackNodeInfo(afl::data::Access a);
         static std::vector<NodeInfo> unpackNodeInfos(afl::data::Access a);
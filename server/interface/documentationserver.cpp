@@ -70,9 +70,12 @@ server::interface::DocumentationServer::handleCommand(const String_t& upcasedCom
                                      "  HELP\n"
                                      "  GET blob\n"
                                      "  RENDER node [ASSET pfx] [SITE pfx] [DOC pfx] [DOCSUFFIX suf]\n"
+                                     "  PRERENDER [ASSET pfx] [SITE pfx] [DOC pfx] [DOCSUFFIX suf]\n"
+                                     "  CACHESTAT\n"
                                      "  STAT node\n"
                                      "  LS node [DEPTH n] [ACROSS]\n"
-                                     "  PATH node\n"));
+                                     "  PATH node\n"
+                                     "  SEARCH query [IN node] [LIMIT n]\n"));
         return true;
     } else if (upcasedCommand == "GET") {
         /* @q GET blobId:Str (Documentation Command)
@@ -107,6 +110,45 @@ server::interface::DocumentationServer::handleCommand(const String_t& upcasedCom
 
         result.reset(makeStringValue(m_implementation.renderNode(nodeId, opts)));
         return true;
+    } else if (upcasedCommand == "PRERENDER") {
+        /* @q PRERENDER [ASSET pfx:Str] [SITE pfx:Str] [DOC pfx:Str] [DOCSUFFIX suf:Str] (Documentation Command)
+           Render all documents and pages into the render cache.
+           Following RENDER commands with the same parameters will be answered from the cache.
+           Parameters are the same as for {RENDER (Documentation Command)|RENDER}.
+
+           @retval Int Number of nodes rendered */
+        Documentation::RenderOptions opts;
+        while (args.getNumArgs() > 0) {
+            String_t keyword = afl::string::strUCase(toString(args.getNext()));
+            if (!handleRenderOption(keyword, args, opts)) {
+                throw std::runtime_error(INVALID_OPTION);
+            }
+        }
+
+        result.reset(makeIntegerValue(m_implementation.prerenderNodes(opts)));
+        return true;
+    } else if (upcasedCommand == "CACHESTAT") {
+        /* @q CACHESTAT (Documentation Command)
+           Get render cache status.
+
+           @retval DocCacheStatus Status */
+        args.checkArgumentCount(0);
+        Documentation::CacheStatus st = m_implementation.getCacheStatus();
+
+        /* @type DocCacheStatus
+           Render cache status.
+
+           @key entries:Int  (Number of rendered pages in cache)
+           @key size:Int     (Total size of cache content, bytes)
+           @key hits:Int     (Number of RENDER commands answered from cache)
+           @key misses:Int   (Number of RENDER commands that needed rendering) */
+        Hash::Ref_t h = Hash::create();
+        h->setNew("entries", makeIntegerValue(st.numEntries));
+        h->setNew("size",    makeIntegerValue(st.totalSize));
+        h->setNew("hits",    makeIntegerValue(st.numHits));
+        h->setNew("misses",  makeIntegerValue(st.numMisses));
+        result.reset(new HashValue(h));
+        return true;
     } else if (upcasedCommand == "STAT") {
         /* @q STAT node:DocNodeId (Documentation Command)
            Get node information.
@@ -182,6 +224,50 @@ server::interface::DocumentationServer::handleCommand(const String_t& upcasedCom
 
         result.reset(packNodeInfos(m_implementation.getNodeRelatedVersions(nodeId)));
         return true;
+    } else if (upcasedCommand == "SEARCH") {
+        /* @q SEARCH query:Str [IN node:DocNodeId] [LIMIT n:Int] (Documentation Command)
+           Full-text search.
+           Finds pages that contain all words of the query, best match first.
+           Use IN to restrict the search to a document, LIMIT to limit the number of results.
+
+           @retval DocSearchResult[] Results */
+        args.checkArgumentCountAtLeast(1);
+        String_t query = toString(args.getNext());
+
+        Documentation::SearchOptions opts;
+        while (args.getNumArgs() > 0) {
+            String_t keyword = afl::string::strUCase(toString(args.getNext()));
+            if (keyword == "IN") {
+                args.checkArgumentCountAtLeast(1);
+                opts.docId = toString(args.getNext());
+            } else if (keyword == "LIMIT") {
+                args.checkArgumentCountAtLeast(1);
+                opts.maxResults = toInteger(args.getNext());
+            } else {
+                throw std::runtime_error(INVALID_OPTION);
+            }
+        }
+
+        std::vector<Documentation::SearchResult> results = m_implementation.search(query, opts);
+
+        /* @type DocSearchResult
+           Search result.
+
+           @key id:DocNodeId (Id of node)
+           @key title:Str    (Title)
+           @key snippet:Str  (Excerpt of text)
+           @key score:Int    (Score, higher is better) */
+        Vector::Ref_t vec = Vector::create();
+        for (size_t i = 0; i < results.size(); ++i) {
+            Hash::Ref_t h = Hash::create();
+            h->setNew("id",      makeStringValue(results[i].nodeId));
+            h->setNew("title",   makeStringValue(results[i].title));
+            h->setNew("snippet", makeStringValue(results[i].snippet));
+            h->setNew("score",   makeIntegerValue(results[i].score));
+            vec->pushBackNew(new HashValue(h));
+        }
+        result.reset(new VectorValue(vec));
+        return true;
     } else {
         return false;
     }
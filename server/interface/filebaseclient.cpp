@@ -6,6 +6,7 @@
 #include "afl/data/segment.hpp"
 #include "afl/data/access.hpp"
 #include "server/types.hpp"
+#include "server/interface/commandbatch.hpp"
 
 using afl::data::Segment;
 using afl::data::Access;
@@ -167,6 +168,54 @@ server::interface::FileBaseClient::getDiskUsage(String_t dirName)
     return result;
 }
 
+void
+server::interface::FileBaseClient::getMultipleFiles(afl::base::Memory<const String_t> fileNames, afl::data::StringList_t& result)
+{
+    CommandBatch batch;
+    while (const String_t* p = fileNames.eat()) {
+        batch.add().pushBackString("GET").pushBackString(*p);
+    }
+    batch.execute(m_commandHandler);
+
+    for (size_t i = 0, n = batch.size(); i < n; ++i) {
+        result.push_back(server::toString(batch.getResult(i)));
+    }
+}
+
+void
+server::interface::FileBaseClient::putMultipleFiles(afl::base::Memory<const String_t> fileNames, afl::base::Memory<const String_t> contents)
+{
+    CommandBatch batch;
+    while (const String_t* pName = fileNames.eat()) {
+        const String_t* pContent = contents.eat();
+        batch.add().pushBackString("PUT").pushBackString(*pName).pushBackString(pContent != 0 ? *pContent : String_t());
+    }
+    batch.execute(m_commandHandler);
+
+    // Report first error, if any
+    for (size_t i = 0, n = batch.size(); i < n; ++i) {
+        batch.getResult(i);
+    }
+}
+
+void
+server::interface::FileBaseClient::getMultipleFileInformation(afl::base::Memory<const String_t> fileNames, std::vector<afl::base::Optional<Info> >& result)
+{
+    CommandBatch batch;
+    while (const String_t* p = fileNames.eat()) {
+        batch.add().pushBackString("STAT").pushBackString(*p);
+    }
+    batch.execute(m_commandHandler);
+
+    for (size_t i = 0, n = batch.size(); i < n; ++i) {
+        if (batch.isError(i)) {
+            result.push_back(afl::base::Nothing);
+        } else {
+            result.push_back(unpackInfo(batch.getResult(i)));
+        }
+    }
+}
+
 server::interface::FileBase::Info
 server::interface::FileBaseClient::unpackInfo(const afl::data::Value* p)
 {
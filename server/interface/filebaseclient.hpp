@@ -4,6 +4,9 @@
 #ifndef C2NG_SERVER_INTERFACE_FILEBASECLIENT_HPP
 #define C2NG_SERVER_INTERFACE_FILEBASECLIENT_HPP
 
+#include <vector>
+#include "afl/base/optional.hpp"
+#include "afl/data/stringlist.hpp"
 #include "afl/net/commandhandler.hpp"
 #include "server/interface/filebase.hpp"
 
@@ -32,6 +35,27 @@ namespace server { namespace interface {
         virtual Info getFileInformation(String_t fileName);
         virtual Usage getDiskUsage(String_t dirName);
 
+        /** Get multiple files.
+            Retrieves all files in one CommandBatch, saving round-trips if the CommandHandler supports that.
+            \param fileNames [in]  File names
+            \param result    [out] File contents, one per file name, in the same order
+            \throw std::exception if any file cannot be read */
+        void getMultipleFiles(afl::base::Memory<const String_t> fileNames, afl::data::StringList_t& result);
+
+        /** Store multiple files.
+            Stores all files in one CommandBatch, saving round-trips if the CommandHandler supports that.
+            All files are attempted even if some fail.
+            \param fileNames File names
+            \param contents  File contents, one per file name
+            \throw std::exception if any file cannot be stored */
+        void putMultipleFiles(afl::base::Memory<const String_t> fileNames, afl::base::Memory<const String_t> contents);
+
+        /** Get information about multiple files.
+            Retrieves all information in one CommandBatch, saving round-trips if the CommandHandler supports that.
+            \param fileNames [in]  File names
+            \param result    [out] File information, one per file name, in the same order; Nothing if the file cannot be accessed */
+        void getMultipleFileInformation(afl::base::Memory<const String_t> fileNames, std::vector<afl::base::Optional<Info> >& result);
+
         static Info unpackInfo(const afl::data::Value* p);
 
      public:
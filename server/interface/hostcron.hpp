@@ -40,6 +40,17 @@ namespace server { namespace interface {
                 { }
         };
 
+        /** Scheduler status. */
+        struct Status {
+            int32_t numWaitingGames;   ///< Number of games that are due but wait for a worker.
+            int32_t numRunningGames;   ///< Number of games currently being processed by a worker.
+            int32_t numWorkers;        ///< Number of workers.
+
+            Status()
+                : numWaitingGames(0), numRunningGames(0), numWorkers(0)
+                { }
+        };
+
         /** Map of broken games.
             Keys are game Ids, values are crash messages. */
         typedef std::map<int32_t, String_t> BrokenMap_t;
@@ -68,6 +79,10 @@ namespace server { namespace interface {
         /** List broken games and reasons of breakage (CRONLSBROKEN).
             \param [out] result BrokenMap_t Result */
         virtual void getBrokenGames(BrokenMap_t& result) = 0;
+
+        /** Get scheduler status (CRONSTATUS).
+            \return status */
+        virtual Status getStatus() = 0;
     };
 
 } }
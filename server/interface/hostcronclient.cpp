@@ -61,6 +61,19 @@ server::interface::HostCronClient::getBrokenGames(BrokenMap_t& result)
     }
 }
 
+server::interface::HostCron::Status
+server::interface::HostCronClient::getStatus()
+{
+    std::auto_ptr<afl::data::Value> p(m_commandHandler.call(Segment().pushBackString("CRONSTATUS")));
+    Access a(p);
+
+    Status result;
+    result.numWaitingGames = a("waiting").toInteger();
+    result.numRunningGames = a("running").toInteger();
+    result.numWorkers      = a("workers").toInteger();
+    return result;
+}
+
 server::interface::HostCron::Event
 server::interface::HostCronClient::unpackEvent(const afl::data::Value* p)
 {
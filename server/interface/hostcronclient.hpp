@@ -25,6 +25,7 @@ namespace server { namespace interface {
         virtual bool kickstartGame(int32_t gameId);
         virtual void suspendScheduler(int32_t relativeTime);
         virtual void getBrokenGames(BrokenMap_t& result);
+        virtual Status getStatus();
 
         /** Unpack an event received from the server.
             @param p Value tree received from server
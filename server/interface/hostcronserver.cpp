@@ -121,6 +121,26 @@ server::interface::HostCronServer::handleCommand(const String_t& upcasedCommand,
         }
         result.reset(new afl::data::VectorValue(resultVector));
         return true;
+    } else if (upcasedCommand == "CRONSTATUS") {
+        /* @q CRONSTATUS (Host Command)
+           Get scheduler status.
+           @retkey waiting:Int (number of games that are due and wait for a host worker)
+           @retkey running:Int (number of games currently being hosted/mastered)
+           @retkey workers:Int (number of host workers, see {Host.Workers (Config)})
+
+           Permissions: admin
+
+           @since PCC2 2.41 */
+        args.checkArgumentCount(0);
+
+        HostCron::Status st = m_implementation.getStatus();
+
+        afl::data::Hash::Ref_t h = afl::data::Hash::create();
+        h->setNew("waiting", makeIntegerValue(st.numWaitingGames));
+        h->setNew("running", makeIntegerValue(st.numRunningGames));
+        h->setNew("workers", makeIntegerValue(st.numWorkers));
+        result.reset(new afl::data::HashValue(h));
+        return true;
     } else {
         return false;
     }
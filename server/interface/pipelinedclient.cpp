@@ -0,0 +1,248 @@
+/**
+  *  \file server/interface/pipelinedclient.cpp
+  *  \brief Class server::interface::PipelinedClient
+  */
+
+#include <memory>
+#include "server/interface/pipelinedclient.hpp"
+#include "afl/async/receiveoperation.hpp"
+#include "afl/async/sendoperation.hpp"
+#include "afl/data/defaultvaluefactory.hpp"
+#include "afl/data/visitor.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/except/remoteerrorexception.hpp"
+#include "afl/io/resp/parser.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/messages.hpp"
+#include "afl/sys/types.hpp"
+#include "server/interface/commandbatch.hpp"
+#include "server/types.hpp"
+
+namespace {
+    /* Timeout for connection setup */
+    const afl::sys::Timeout_t CONNECT_TIMEOUT = 10000;
+
+    /* Append a command to a buffer, in RESP format (array of bulk strings). */
+    void appendCommand(String_t& out, const afl::data::Segment& command)
+    {
+        out += afl::string::Format("*%d\r\n", command.size());
+        for (size_t i = 0, n = command.size(); i < n; ++i) {
+            const String_t arg = server::toString(command[i]);
+            out += afl::string::Format("$%d\r\n", arg.size());
+            out += arg;
+            out += "\r\n";
+        }
+    }
+
+    /* Check whether a reply is an error; if so, return its text. */
+    bool getErrorText(const afl::data::Value* value, String_t& text)
+    {
+        class Detector : public afl::data::Visitor {
+         public:
+            Detector(String_t& text)
+                : m_text(text), m_result(false)
+                { }
+            virtual void visitString(const String_t& /*str*/)
+                { }
+            virtual void visitInteger(int32_t /*iv*/)
+                { }
+            virtual void visitFloat(double /*fv*/)
+                { }
+            virtual void visitBoolean(bool /*bv*/)
+                { }
+            virtual void visitHash(const afl::data::Hash& /*hv*/)
+                { }
+            virtual void visitVector(const afl::data::Vector& /*vv*/)
+                { }
+            virtual void visitOther(const afl::data::Value& /*other*/)
+                { }
+            virtual void visitNull()
+                { }
+            virtual void visitError(const String_t& /*source*/, const String_t& str)
+                {
+                    m_text = str;
+                    m_result = true;
+                }
+            bool getResult() const
+                { return m_result; }
+         private:
+            String_t& m_text;
+            bool m_result;
+        };
+        Detector d(text);
+        d.visit(value);
+        return d.getResult();
+    }
+}
+
+// Constructor.
+server::interface::PipelinedClient::PipelinedClient(afl::net::NetworkStack& stack, const afl::net::Name& name)
+    : m_networkStack(stack),
+      m_name(name),
+      m_socket(),
+      m_controller(),
+      m_reconnectMode(Never),
+      m_connectionLost(false),
+      m_pendingData()
+{ }
+
+// Destructor.
+server::interface::PipelinedClient::~PipelinedClient()
+{ }
+
+server::interface::PipelinedClient::Value_t*
+server::interface::PipelinedClient::call(const Segment_t& command)
+{
+    String_t request;
+    appendCommand(request, command);
+
+    std::auto_ptr<Value_t> result(startRequest(afl::string::toBytes(request)));
+
+    String_t errorText;
+    if (getErrorText(result.get(), errorText)) {
+        throw afl::except::RemoteErrorException(m_name.toString(), errorText);
+    }
+    return result.release();
+}
+
+void
+server::interface::PipelinedClient::callVoid(const Segment_t& command)
+{
+    delete call(command);
+}
+
+void
+server::interface::PipelinedClient::callBatch(CommandBatch& batch)
+{
+    if (batch.size() == 0) {
+        return;
+    }
+
+    // Send all commands at once
+    String_t request;
+    for (size_t i = 0, n = batch.size(); i < n; ++i) {
+        appendCommand(request, batch.getCommand(i));
+    }
+
+    // Collect replies. The service answers in order.
+    try {
+        std::auto_ptr<Value_t> result(startRequest(afl::string::toBytes(request)));
+        for (size_t i = 0, n = batch.size(); i < n; ++i) {
+            if (i != 0) {
+                result.reset(receiveReply());
+            }
+            String_t errorText;
+            if (getErrorText(result.get(), errorText)) {
+                batch.setRemoteError(i, m_name.toString(), errorText);
+            } else {
+                batch.setResult(i, result.release());
+            }
+        }
+    }
+    catch (...) {
+        // We do not know how many replies are still in flight; the connection is unusable.
+        disconnect();
+        throw;
+    }
+}
+
+void
+server::interface::PipelinedClient::setReconnectMode(Mode mode)
+{
+    m_reconnectMode = mode;
+}
+
+afl::net::Socket&
+server::interface::PipelinedClient::connect()
+{
+    if (m_socket.get() == 0) {
+        // Replacing a lost connection needs permission
+        if (m_connectionLost) {
+            switch (m_reconnectMode) {
+             case Never:
+                throw afl::except::FileProblemException(m_name.toString(), afl::string::Messages::networkError());
+             case Once:
+                m_reconnectMode = Never;
+                break;
+             case Always:
+                break;
+            }
+        }
+        m_socket = m_networkStack.connect(m_name, CONNECT_TIMEOUT).asPtr();
+        m_connectionLost = false;
+        m_pendingData = afl::base::ConstBytes_t();
+    }
+    return *m_socket;
+}
+
+void
+server::interface::PipelinedClient::disconnect()
+{
+    if (m_socket.get() != 0) {
+        m_socket.reset();
+        m_connectionLost = true;
+    }
+    m_pendingData = afl::base::ConstBytes_t();
+}
+
+void
+server::interface::PipelinedClient::sendData(afl::base::ConstBytes_t data)
+{
+    afl::net::Socket& socket = connect();
+    while (!data.empty()) {
+        afl::async::SendOperation op(data);
+        if (!socket.send(m_controller, op, afl::sys::INFINITE_TIMEOUT) || op.getNumSentBytes() == 0) {
+            throw afl::except::FileProblemException(m_name.toString(), afl::string::Messages::networkError());
+        }
+        data.split(op.getNumSentBytes());
+    }
+}
+
+server::interface::PipelinedClient::Value_t*
+server::interface::PipelinedClient::receiveReply()
+{
+    afl::net::Socket& socket = connect();
+    afl::data::DefaultValueFactory factory;
+    afl::io::resp::Parser parser(factory);
+    while (1) {
+        if (m_pendingData.empty()) {
+            afl::async::ReceiveOperation op(m_buffer);
+            if (!socket.receive(m_controller, op, afl::sys::INFINITE_TIMEOUT) || op.getReceivedBytes().empty()) {
+                throw afl::except::FileProblemException(m_name.toString(), afl::string::Messages::networkError());
+            }
+            m_pendingData = op.getReceivedBytes();
+        }
+        if (parser.handleData(m_pendingData)) {
+            return parser.extract();
+        }
+    }
+}
+
+/* Send a request and receive its first reply.
+   If a connection that has been used before fails, the other side has probably closed it while idle.
+   In this case, the request is sent again on a new connection if the reconnect mode permits.
+   A connection we just opened is not retried. */
+server::interface::PipelinedClient::Value_t*
+server::interface::PipelinedClient::startRequest(afl::base::ConstBytes_t request)
+{
+    const bool reused = (m_socket.get() != 0);
+    try {
+        sendData(request);
+        return receiveReply();
+    }
+    catch (...) {
+        disconnect();
+        if (!reused || m_reconnectMode == Never) {
+            throw;
+        }
+    }
+
+    try {
+        sendData(request);
+        return receiveReply();
+    }
+    catch (...) {
+        disconnect();
+        throw;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+  *  \file server/interface/pipelinedclient.hpp
+  *  \brief Class server::interface::PipelinedClient
+  */
+#ifndef C2NG_SERVER_INTERFACE_PIPELINEDCLIENT_HPP
+#define C2NG_SERVER_INTERFACE_PIPELINEDCLIENT_HPP
+
+#include "afl/async/controller.hpp"
+#include "afl/base/ptr.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/net/name.hpp"
+#include "afl/net/networkstack.hpp"
+#include "afl/net/reconnectable.hpp"
+#include "afl/net/socket.hpp"
+#include "server/interface/batchcommandhandler.hpp"
+
+namespace server { namespace interface {
+
+    /** RESP client with support for pipelining.
+        Like afl::net::resp::Client, this sends commands to a RESP service and waits for the replies.
+        In addition, it implements BatchCommandHandler:
+        all commands of a CommandBatch are sent in one write, and the replies are collected in order afterwards.
+        This saves a network round-trip per command.
+        Because the replies are only read after the whole batch has been sent,
+        a single batch should not combine many large requests (PUT) with many large replies (GET).
+
+        The connection is opened on first use.
+        Reconnecting is controlled by the afl::net::Reconnectable mode, like for afl::net::resp::Client:
+        if a connection that has been used before fails while sending a request or receiving its first reply,
+        a new connection is opened and the request (the whole batch) is sent again, if the mode permits.
+        A failure after the first reply of a batch is not retried, because part of the batch has already been executed.
+        Because the new connection does not inherit the old one's state (in particular, a "USER" context),
+        use this class for connections that do not carry state, or re-establish the state after an error. */
+    class PipelinedClient : public BatchCommandHandler,
+                            public afl::net::Reconnectable,
+                            private afl::base::Uncopyable
+    {
+     public:
+        /** Constructor.
+            \param stack Network stack
+            \param name  Name of service to connect to */
+        PipelinedClient(afl::net::NetworkStack& stack, const afl::net::Name& name);
+
+        /** Destructor. */
+        ~PipelinedClient();
+
+        // CommandHandler:
+        virtual Value_t* call(const Segment_t& command);
+        virtual void callVoid(const Segment_t& command);
+
+        // BatchCommandHandler:
+        virtual void callBatch(CommandBatch& batch);
+
+        // Reconnectable:
+        virtual void setReconnectMode(Mode mode);
+
+     private:
+        afl::net::NetworkStack& m_networkStack;
+        afl::net::Name m_name;
+        afl::base::Ptr<afl::net::Socket> m_socket;
+        afl::async::Controller m_controller;
+        Mode m_reconnectMode;
+        bool m_connectionLost;
+
+        uint8_t m_buffer[4096];
+        afl::base::ConstBytes_t m_pendingData;
+
+        afl::net::Socket& connect();
+        void disconnect();
+        void sendData(afl::base::ConstBytes_t data);
+        Value_t* receiveReply();
+        Value_t* startRequest(afl::base::ConstBytes_t request);
+    };
+
+} }
+
+#endif
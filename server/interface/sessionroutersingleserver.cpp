@@ -127,7 +127,10 @@ server::interface::SessionRouterSingleServer::handleCommand(const String_t& line
            - idle time in seconds
            - "," if the session was used, "V" if it is still virgin (indicates a browser without JavaScript)
            - "." if the session was modified, "S" if it was saved
-           - command line parameters of the session */
+           - command line parameters of the session
+
+           If {Router.PoolSize (Config)|the warm pool} is enabled, the header line also reports
+           the number of standby processes, and the number of sessions started with and without a standby process. */
         response.handleLine(m_impl.getStatus());
         return finish();
     } else if (verb == "INFO") {
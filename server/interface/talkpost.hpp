@@ -11,7 +11,9 @@
 #include "afl/container/ptrvector.hpp"
 #include "afl/data/integerlist.hpp"
 #include "afl/data/stringlist.hpp"
+#include "afl/data/value.hpp"
 #include "afl/string/string.hpp"
+#include "server/interface/talkforum.hpp"
 #include "server/interface/talkrender.hpp"
 #include "server/types.hpp"
 
@@ -19,6 +21,8 @@ namespace server { namespace interface {
 
     class TalkPost : public afl::base::Deletable {
      public:
+        typedef TalkForum::ListParameters ListParameters;
+
         struct CreateOptions {
             afl::base::Optional<String_t> userId;
             afl::base::Optional<String_t> readPermissions;
@@ -76,6 +80,13 @@ namespace server { namespace interface {
 
         // POSTLSNEW n:Int (Talk Command)
         virtual void getNewest(int count, afl::data::IntegerList_t& postIds) = 0;
+
+        // POSTSEARCH forum:FID query:Str [listParameters...] (Talk Command)
+        // @retval Any result depending on listParameters (list of MIDs, size, or membership flag)
+        virtual afl::data::Value* search(int32_t forumId, String_t query, const ListParameters& params) = 0;
+
+        // POSTREINDEX forum:FID (Talk Command)
+        virtual int32_t reindex(int32_t forumId) = 0;
     };
 
 } }
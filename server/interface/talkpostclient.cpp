@@ -4,6 +4,7 @@
 
 #include "server/interface/talkpostclient.hpp"
 #include "afl/data/access.hpp"
+#include "server/interface/talkforumclient.hpp"
 #include "server/interface/talkrenderclient.hpp"
 
 using afl::data::Segment;
@@ -149,6 +150,25 @@ server::interface::TalkPostClient::getNewest(int count, afl::data::IntegerList_t
     afl::data::Access(p).toIntegerList(postIds);
 }
 
+// POSTSEARCH forum:FID query:Str [listParameters...] (Talk Command)
+afl::data::Value*
+server::interface::TalkPostClient::search(int32_t forumId, String_t query, const ListParameters& params)
+{
+    Segment cmd;
+    cmd.pushBackString("POSTSEARCH");
+    cmd.pushBackInteger(forumId);
+    cmd.pushBackString(query);
+    TalkForumClient::packListParameters(cmd, params);
+    return m_commandHandler.call(cmd);
+}
+
+// POSTREINDEX forum:FID (Talk Command)
+int32_t
+server::interface::TalkPostClient::reindex(int32_t forumId)
+{
+    return m_commandHandler.callInt(Segment().pushBackString("POSTREINDEX").pushBackInteger(forumId));
+}
+
 server::interface::TalkPost::Info
 server::interface::TalkPostClient::unpackInfo(const afl::data::Value* value)
 {
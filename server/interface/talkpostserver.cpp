@@ -6,6 +6,7 @@
 #include "server/interface/talkpostserver.hpp"
 #include "interpreter/arguments.hpp"
 #include "server/types.hpp"
+#include "server/interface/talkforumserver.hpp"
 #include "server/interface/talkpost.hpp"
 #include "server/interface/talkrenderserver.hpp"
 #include "afl/data/vectorvalue.hpp"
@@ -284,6 +285,57 @@ server::interface::TalkPostServer::handleCommand(const String_t& upcasedCommand,
 
         result.reset(new afl::data::VectorValue(afl::data::Vector::create(afl::data::Segment().pushBackElements(ids))));
         return true;
+    } else if (upcasedCommand == "POSTSEARCH") {
+        /* @q POSTSEARCH forum:FID query:Str [listParameters...] (Talk Command)
+           Search postings.
+           Finds all postings the user can see that match the query.
+           If %forum is nonzero, only postings in that forum are searched, otherwise, all forums.
+
+           The query consists of words, which must all appear in the posting's subject or text.
+           - <tt>"fuel tank"</tt>: double-quoted words must appear in this order
+           - <tt>-torpedo</tt>: postings containing this word (or phrase) are excluded
+           - <tt>fuel OR gas</tt>: alternatives
+           Matching is case-insensitive. Quoted text in postings is not searched.
+
+           The list can be accessed in different ways, see {pcc:talk:listparams|listParameters}.
+           Valid sort keys are the same as for {THREADLSPOST}.
+           The resulting {@type MID}s can be used with {POSTMSTAT} to obtain subjects and
+           the RfC Message-Ids used on the NNTP side.
+
+           Permissions: none (only accessible postings are returned).
+
+           @err 404 No such forum
+
+           @rettype Any
+           @rettype MID
+           @uses forum:$FID:search:$TERM, msg:$MID:terms */
+        args.checkArgumentCountAtLeast(2);
+        int32_t forumId = toInteger(args.getNext());
+        String_t query  = toString(args.getNext());
+
+        TalkPost::ListParameters p;
+        TalkForumServer::parseListParameters(p, args);
+
+        result.reset(m_implementation.search(forumId, query, p));
+        return true;
+    } else if (upcasedCommand == "POSTREINDEX") {
+        /* @q POSTREINDEX forum:FID (Talk Command)
+           Rebuild search index.
+           Re-indexes all postings in the forum for {POSTSEARCH}.
+           If %forum is zero, all forums are re-indexed.
+           The index is normally maintained when postings are created or modified;
+           use this command for postings that were created before the search index existed.
+
+           Permissions: admin.
+
+           @err 404 No such forum
+
+           @retval Int number of postings indexed
+           @uses forum:$FID:messages, forum:$FID:search:$TERM, msg:$MID:terms */
+        args.checkArgumentCount(1);
+        int32_t forumId = toInteger(args.getNext());
+        result.reset(makeIntegerValue(m_implementation.reindex(forumId)));
+        return true;
     } else {
         return false;
     }
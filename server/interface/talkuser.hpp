@@ -7,6 +7,7 @@
 #include "afl/base/deletable.hpp"
 #include "afl/base/types.hpp"
 #include "afl/base/memory.hpp"
+#include "afl/data/integerlist.hpp"
 #include "server/interface/talkforum.hpp"
 
 namespace server { namespace interface {
@@ -61,6 +62,9 @@ namespace server { namespace interface {
 
         // USERLSPOSTED user:UID [listParameters...] (Talk Command)
         virtual afl::data::Value* getPostedMessages(String_t user, const ListParameters& params) = 0;
+
+        // USERUNREAD forum:FID... (Talk Command)
+        virtual void getUnreadCounts(afl::base::Memory<const int32_t> forumIds, afl::data::IntegerList_t& result) = 0;
     };
 
 } }
@@ -3,8 +3,10 @@
   */
 
 #include "server/interface/talkuserclient.hpp"
+#include "afl/data/access.hpp"
 #include "server/interface/talkforumclient.hpp"
 
+using afl::data::Access;
 using afl::data::Segment;
 
 server::interface::TalkUserClient::TalkUserClient(afl::net::CommandHandler& commandHandler)
@@ -104,6 +106,20 @@ server::interface::TalkUserClient::getPostedMessages(String_t user, const ListPa
     return m_commandHandler.call(cmd);
 }
 
+// USERUNREAD forum:FID... (Talk Command)
+void
+server::interface::TalkUserClient::getUnreadCounts(afl::base::Memory<const int32_t> forumIds, afl::data::IntegerList_t& result)
+{
+    Segment cmd;
+    cmd.pushBackString("USERUNREAD");
+    while (const int32_t* p = forumIds.eat()) {
+        cmd.pushBackInteger(*p);
+    }
+
+    std::auto_ptr<afl::data::Value> p(m_commandHandler.call(cmd));
+    Access(p).toIntegerList(result);
+}
+
 void
 server::interface::TalkUserClient::packSelections(afl::data::Segment& cmd, afl::base::Memory<const Selection> selections)
 {
@@ -21,6 +21,7 @@ namespace server { namespace interface {
         virtual afl::data::Value* getWatchedThreads(const ListParameters& params);
         virtual afl::data::Value* getWatchedForums(const ListParameters& params);
         virtual afl::data::Value* getPostedMessages(String_t user, const ListParameters& params);
+        virtual void getUnreadCounts(afl::base::Memory<const int32_t> forumIds, afl::data::IntegerList_t& result);
 
         static void packSelections(afl::data::Segment& cmd, afl::base::Memory<const Selection> selection);
 
@@ -6,11 +6,16 @@
 #include <stdexcept>
 #include "server/interface/talkuserserver.hpp"
 #include "afl/data/integerlist.hpp"
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
 #include "server/types.hpp"
 #include "interpreter/arguments.hpp"
 #include "server/interface/talkforumserver.hpp"
 #include "server/errors.hpp"
 
+using afl::data::Vector;
+using afl::data::VectorValue;
+
 server::interface::TalkUserServer::TalkUserServer(TalkUser& implementation)
     : m_implementation(implementation)
 { }
@@ -54,7 +59,8 @@ server::interface::TalkUserServer::handleCommand(const String_t& upcasedCommand,
            @rettype MID
            @rettype Str
            @rettype Int
-           @uses user:$UID:forum:newsrc:data, user:$UID:forum:newsrc:index */
+           @uses user:$UID:forum:newsrc:data, user:$UID:forum:newsrc:index, user:$UID:forum:unread
+           @see USERUNREAD */
         /* @change PCC2 would accept actions and ranges in any order, and apply them on the go.
            This would yield combinations such as FIRSTSET + ALL becoming FIRSTCLEAR,
            or FIRSTSET <range> FIRSTCLEAR <range> looking for a read post in the first range, and an unread in the second.
@@ -236,6 +242,32 @@ server::interface::TalkUserServer::handleCommand(const String_t& upcasedCommand,
         TalkForumServer::parseListParameters(params, args);
         result.reset(m_implementation.getPostedMessages(user, params));
         return true;
+    } else if (upcasedCommand == "USERUNREAD") {
+        /* @q USERUNREAD forum:FID... (Talk Command)
+           Get number of unread postings in forums.
+           Returns one integer for each forum, the number of postings the user has not yet read (see USERNEWSRC).
+
+           This command uses cached counters and is therefore much faster than
+           counting using "USERNEWSRC ALL FORUM n" or similar.
+
+           Permissions: user context required, accesses user's newsrc
+
+           @err 404 Forum not found
+           @retval IntList number of unread postings
+           @uses user:$UID:forum:unread, forum:$FID:unreadusers, user:$UID:forum:newsrc:data
+           @see USERNEWSRC */
+        afl::data::IntegerList_t forumIds;
+        while (args.getNumArgs() > 0) {
+            forumIds.push_back(toInteger(args.getNext()));
+        }
+
+        afl::data::IntegerList_t counts;
+        m_implementation.getUnreadCounts(forumIds, counts);
+
+        Vector::Ref_t vec = Vector::create();
+        vec->pushBackElements(counts);
+        result.reset(new VectorValue(vec));
+        return true;
     } else {
         return false;
     }
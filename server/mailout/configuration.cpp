@@ -9,5 +9,8 @@ server::mailout::Configuration::Configuration()
     : baseUrl("unconfigured"),
       confirmationKey(),
       maximumAge(24*60*32),
-      useTransmitter(true)
+      useTransmitter(true),
+      numTransmitters(1),
+      usePipelining(true),
+      statisticsInterval(60)
 { }
@@ -26,6 +26,15 @@ namespace server { namespace mailout {
 
         /// Transmitter configuration. Mailout can be run without a transmitter.
         bool useTransmitter;
+
+        /// Number of transmitter workers. Each worker uses its own SMTP connection.
+        int numTransmitters;
+
+        /// SMTP pipelining. If enabled, pipelining is used if the SMTP server supports it.
+        bool usePipelining;
+
+        /// Statistics interval in minutes. If nonzero, transmitter statistics are logged in this interval.
+        int32_t statisticsInterval;
     };
 
 } }
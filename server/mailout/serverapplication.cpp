@@ -23,6 +23,14 @@
 
 namespace {
     const char* LOG_NAME = "mailout";
+    const int MAX_TRANSMITTERS = 32;
+
+    void logStatistics(afl::sys::LogListener& log, const server::mailout::TransmitterImpl::Statistics& st)
+    {
+        log.write(afl::sys::LogListener::Info, LOG_NAME,
+                  afl::string::Format("Statistics: %d queued, %d active, %d postponed; %d sent, %d failed, %d connections; %d workers",
+                                      st.numQueued, st.numActive, st.numPostponed, st.numSent, st.numFailed, st.numConnections, st.numWorkers));
+    }
 }
 
 
@@ -74,13 +82,15 @@ server::mailout::ServerApplication::serverMain()
     // This is required because Transmitter will access the root.
     // At that point, no other component will be alive that attempts to access Root::getTransmitter().
     std::auto_ptr<Transmitter> tx;
+    TransmitterImpl* txImpl = 0;
     if (m_config.useTransmitter) {
         // Open template directory and verify that it is ok. getDirectoryEntries() will fail if it's not.
         afl::base::Ref<afl::io::Directory> templateDir = fileSystem().openDirectory(m_templateDirectoryName);
         templateDir->getDirectoryEntries();
 
         // Create transmitter. Need an intermediate upcast, otherwise the compiler sees an ambiguity re Deletable.
-        tx.reset(new TransmitterImpl(root, templateDir, networkStack(), m_smtpAddress, m_smtpConfig));
+        txImpl = new TransmitterImpl(root, templateDir, networkStack(), m_smtpAddress, m_smtpConfig);
+        tx.reset(txImpl);
         root.setTransmitter(tx.get());
         log().write(afl::sys::LogListener::Info, LOG_NAME, "Transmitter enabled.");
     } else {
@@ -101,12 +111,22 @@ server::mailout::ServerApplication::serverMain()
     afl::sys::Thread serverThread("mailout.server", server);
     serverThread.start();
 
-    // Wait for termination request
+    // Wait for termination request, logging statistics in between
     afl::async::Controller ctl;
-    m_interrupt.wait(ctl, InterruptOperation::Kinds_t() + InterruptOperation::Break + InterruptOperation::Terminate);
+    const InterruptOperation::Kinds_t kinds = InterruptOperation::Kinds_t() + InterruptOperation::Break + InterruptOperation::Terminate;
+    if (txImpl != 0 && m_config.statisticsInterval > 0) {
+        while (m_interrupt.wait(ctl, kinds, 60000 * m_config.statisticsInterval).empty()) {
+            logStatistics(log(), txImpl->getStatistics());
+        }
+    } else {
+        m_interrupt.wait(ctl, kinds);
+    }
 
     // Stop
     log().write(afl::sys::LogListener::Info, LOG_NAME, "Received stop signal, shutting down.");
+    if (txImpl != 0) {
+        logStatistics(log(), txImpl->getStatistics());
+    }
     server.stop();
     serverThread.join();
 }
@@ -135,6 +155,15 @@ server::mailout::ServerApplication::handleConfiguration(const String_t& key, con
            Fully-qualified domain name to use as originator in SMTP "HELO". */
         m_smtpConfig.hello = value;
         return true;
+    } else if (key == "SMTP.PIPELINING") {
+        /* @q SMTP.Pipelining:Bool (Config)
+           If enabled (default), use SMTP pipelining (RFC 2920) if the SMTP server supports it.
+           Disable if the SMTP server misbehaves.
+           @since PCC2 2.41 */
+        if (!util::parseBooleanValue(value, m_config.usePipelining)) {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (key == "WWW.KEY") {
         m_config.confirmationKey = value;
         return true;
@@ -167,6 +196,34 @@ server::mailout::ServerApplication::handleConfiguration(const String_t& key, con
            Ignored in c2ng/c2mailout-server for compatibility reasons; maximum number of connections is not limited.
            Number of threads (=maximum number of parallel connections). */
         return true;
+    } else if (key == "MAILOUT.TRANSMITTERS") {
+        /* @q Mailout.Transmitters:Int (Config)
+           Number of mails that are transmitted in parallel.
+           Each transmitter uses its own SMTP connection, and sends all mails it has picked from the queue on that connection.
+           Default is 1.
+           @since PCC2 2.41 */
+        int n;
+        if (afl::string::strToInteger(value, n) && n > 0 && n <= MAX_TRANSMITTERS) {
+            m_config.numTransmitters = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
+    } else if (key == "MAILOUT.STATISTICSINTERVAL") {
+        /* @q Mailout.StatisticsInterval:Int (Config)
+           Interval in minutes at which transmitter statistics
+           (queued, active and postponed messages; sent and failed mails; SMTP connections) are logged.
+           Statistics are also logged on shutdown.
+           0 disables the periodic statistics.
+           Default is 60.
+           @since PCC2 2.41 */
+        int32_t n;
+        if (afl::string::strToInteger(value, n) && n >= 0 && n <= 24*60) {
+            m_config.statisticsInterval = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (key == "MAILOUT.TEMPLATEDIR") {
         /* @q Mailout.TemplateDir:Str (Config)
            Directory containing template files for outgoing mails. */
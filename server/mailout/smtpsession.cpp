@@ -0,0 +1,282 @@
+/**
+  *  \file server/mailout/smtpsession.cpp
+  *  \brief Class server::mailout::SmtpSession
+  */
+
+#include "server/mailout/smtpsession.hpp"
+#include "afl/net/line/linesink.hpp"
+#include "afl/string/string.hpp"
+
+namespace {
+    /** Parse SMTP reply code.
+        \param line Reply line
+        \return reply code (e.g. 250); 0 if line does not start with a code */
+    int getReplyCode(const String_t& line)
+    {
+        int result = 0;
+        for (size_t i = 0; i < 3; ++i) {
+            if (i >= line.size() || line[i] < '0' || line[i] > '9') {
+                return 0;
+            }
+            result = 10*result + (line[i] - '0');
+        }
+        return result;
+    }
+
+    /** Check for positive completion reply.
+        \param code Reply code
+        \return true if code is 2xx */
+    bool isSuccess(int code)
+    {
+        return code >= 200 && code < 300;
+    }
+}
+
+// Constructor.
+server::mailout::SmtpSession::SmtpSession(const afl::net::smtp::Configuration& config, bool allowPipelining)
+    : m_config(config),
+      m_allowPipelining(allowPipelining),
+      m_mails(),
+      m_expectedReplies(),
+      m_currentMail(0),
+      m_serverPipelining(false),
+      m_pipelining(false),
+      m_mailAccepted(false),
+      m_receiverAccepted(false)
+{ }
+
+// Destructor.
+server::mailout::SmtpSession::~SmtpSession()
+{ }
+
+// Add a mail.
+size_t
+server::mailout::SmtpSession::addMail(const String_t& to, const String_t& content)
+{
+    m_mails.push_back(Mail(to, content));
+    return m_mails.size() - 1;
+}
+
+// Get number of mails.
+size_t
+server::mailout::SmtpSession::getNumMails() const
+{
+    return m_mails.size();
+}
+
+// Get status of a mail.
+server::mailout::SmtpSession::Status
+server::mailout::SmtpSession::getStatus(size_t index) const
+{
+    return index < m_mails.size() ? m_mails[index].status : Failed;
+}
+
+// Check whether pipelining was used.
+bool
+server::mailout::SmtpSession::isPipelining() const
+{
+    return m_pipelining;
+}
+
+bool
+server::mailout::SmtpSession::handleOpening(afl::net::line::LineSink& /*response*/)
+{
+    // Server speaks first
+    m_expectedReplies.push_back(GreetingReply);
+    return false;
+}
+
+bool
+server::mailout::SmtpSession::handleLine(const String_t& line, afl::net::line::LineSink& response)
+{
+    if (m_expectedReplies.empty()) {
+        // Unsolicited reply; ignore
+        return false;
+    }
+
+    // Multi-line reply. Each line of an EHLO reply is an extension keyword (except for the first one which we don't care for).
+    const Reply reply = m_expectedReplies.front();
+    if (reply == EhloReply && line.size() > 4 && afl::string::strUCase(line.substr(4, 10)) == "PIPELINING") {
+        m_serverPipelining = true;
+    }
+    if (line.size() > 3 && line[3] == '-') {
+        return false;
+    }
+
+    // Final reply line
+    const int code = getReplyCode(line);
+    m_expectedReplies.pop_front();
+    switch (reply) {
+     case GreetingReply:
+        if (isSuccess(code)) {
+            sendCommand(response, "EHLO " + m_config.hello, EhloReply);
+        } else {
+            abortSession(response);
+        }
+        break;
+
+     case EhloReply:
+        if (isSuccess(code)) {
+            m_pipelining = m_allowPipelining && m_serverPipelining;
+            startTransaction(response);
+        } else {
+            // Server does not know ESMTP
+            sendCommand(response, "HELO " + m_config.hello, HeloReply);
+        }
+        break;
+
+     case HeloReply:
+        if (isSuccess(code)) {
+            m_pipelining = false;
+            startTransaction(response);
+        } else {
+            abortSession(response);
+        }
+        break;
+
+     case MailReply:
+        m_mailAccepted = isSuccess(code);
+        if (!m_pipelining) {
+            if (m_mailAccepted) {
+                sendCommand(response, "RCPT TO:<" + m_mails[m_currentMail].to + ">", RcptReply);
+            } else {
+                abortTransaction(response);
+            }
+        }
+        break;
+
+     case RcptReply:
+        m_receiverAccepted = isSuccess(code);
+        if (!m_pipelining) {
+            if (m_receiverAccepted) {
+                sendCommand(response, "DATA", DataReply);
+            } else {
+                abortTransaction(response);
+            }
+        }
+        break;
+
+     case DataReply:
+        if (code == 354) {
+            // If MAIL or RCPT failed, the server should have rejected DATA.
+            // If it did not, we must still terminate the (empty) data phase, and then discard the result.
+            if (m_mailAccepted && m_receiverAccepted) {
+                sendContent(response, m_mails[m_currentMail].content);
+            }
+            sendCommand(response, ".", EndDataReply);
+        } else {
+            abortTransaction(response);
+        }
+        break;
+
+     case EndDataReply:
+        finishTransaction(response, isSuccess(code) && m_mailAccepted && m_receiverAccepted ? Sent : Failed);
+        break;
+
+     case ResetReply:
+        startTransaction(response);
+        break;
+
+     case QuitReply:
+        return true;
+    }
+    return false;
+}
+
+void
+server::mailout::SmtpSession::handleConnectionClose()
+{
+    // Everything not confirmed by now has not been sent; the caller decides what to do with it.
+    m_expectedReplies.clear();
+}
+
+/** Send a command.
+    \param response Sink
+    \param command  Command line
+    \param reply    Expected reply */
+void
+server::mailout::SmtpSession::sendCommand(afl::net::line::LineSink& response, const String_t& command, Reply reply)
+{
+    response.handleLine(command);
+    m_expectedReplies.push_back(reply);
+}
+
+/** Start transaction for the current mail, or end the session if all mails are done.
+    In pipelining mode, sends MAIL, RCPT and DATA in one go.
+    \param response Sink */
+void
+server::mailout::SmtpSession::startTransaction(afl::net::line::LineSink& response)
+{
+    if (m_currentMail < m_mails.size()) {
+        m_mailAccepted = false;
+        m_receiverAccepted = false;
+        sendCommand(response, "MAIL FROM:<" + m_config.from + ">", MailReply);
+        if (m_pipelining) {
+            sendCommand(response, "RCPT TO:<" + m_mails[m_currentMail].to + ">", RcptReply);
+            sendCommand(response, "DATA", DataReply);
+        }
+    } else {
+        sendCommand(response, "QUIT", QuitReply);
+    }
+}
+
+/** Send message content.
+    Splits the content into lines and applies dot-stuffing.
+    \param response Sink
+    \param content  Message content */
+void
+server::mailout::SmtpSession::sendContent(afl::net::line::LineSink& response, const String_t& content)
+{
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t end = content.find('\n', pos);
+        if (end == String_t::npos) {
+            end = content.size();
+        }
+
+        String_t line(content, pos, end - pos);
+        if (!line.empty() && line[line.size()-1] == '\r') {
+            line.erase(line.size()-1);
+        }
+        if (!line.empty() && line[0] == '.') {
+            line.insert(0, 1, '.');
+        }
+        response.handleLine(line);
+        pos = end + 1;
+    }
+}
+
+/** Finish transaction for the current mail and start the next one.
+    \param response Sink
+    \param status   Status of the current mail */
+void
+server::mailout::SmtpSession::finishTransaction(afl::net::line::LineSink& response, Status status)
+{
+    m_mails[m_currentMail].status = status;
+    ++m_currentMail;
+    startTransaction(response);
+}
+
+/** Abort transaction for the current mail.
+    Marks the mail failed and resets the transaction; the next mail is started when the reset is confirmed.
+    \param response Sink */
+void
+server::mailout::SmtpSession::abortTransaction(afl::net::line::LineSink& response)
+{
+    m_mails[m_currentMail].status = Failed;
+    ++m_currentMail;
+    sendCommand(response, "RSET", ResetReply);
+}
+
+/** Abort session.
+    Marks all remaining mails failed and ends the session.
+    \param response Sink */
+void
+server::mailout::SmtpSession::abortSession(afl::net::line::LineSink& response)
+{
+    for (size_t i = m_currentMail; i < m_mails.size(); ++i) {
+        m_mails[i].status = Failed;
+    }
+    m_currentMail = m_mails.size();
+    sendCommand(response, "QUIT", QuitReply);
+}
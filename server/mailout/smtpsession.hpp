@@ -0,0 +1,113 @@
+/**
+  *  \file server/mailout/smtpsession.hpp
+  *  \brief Class server::mailout::SmtpSession
+  */
+#ifndef C2NG_SERVER_MAILOUT_SMTPSESSION_HPP
+#define C2NG_SERVER_MAILOUT_SMTPSESSION_HPP
+
+#include <deque>
+#include <vector>
+#include "afl/net/line/linehandler.hpp"
+#include "afl/net/smtp/configuration.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace mailout {
+
+    /** SMTP session sending multiple mails over one connection.
+        Use as handler for afl::net::line::Client:
+        add all mails using addMail(), call the connection, and check the result using getStatus().
+
+        The session greets the server with EHLO (falling back to HELO),
+        and sends one MAIL/RCPT/DATA transaction per mail.
+        If the server announces PIPELINING and pipelining is enabled,
+        MAIL, RCPT and DATA of a transaction are sent without waiting for the individual replies (RFC 2920).
+
+        A mail that is rejected does not affect the other mails;
+        the session resets the transaction and continues with the next one. */
+    class SmtpSession : public afl::net::line::LineHandler {
+     public:
+        /** Status of a mail. */
+        enum Status {
+            Pending,            ///< Not yet sent (or connection lost before it could be sent).
+            Sent,               ///< Accepted by the server.
+            Failed              ///< Rejected by the server.
+        };
+
+        /** Constructor.
+            \param config          SMTP configuration (hello string and originator)
+            \param allowPipelining true to use pipelining if the server supports it */
+        SmtpSession(const afl::net::smtp::Configuration& config, bool allowPipelining);
+
+        /** Destructor. */
+        ~SmtpSession();
+
+        /** Add a mail.
+            \param to      Receiver (SMTP address)
+            \param content Message content, including headers (e.g. produced by afl::net::MimeBuilder); lines separated by "\r\n" or "\n"
+            \return index of the mail, for getStatus() */
+        size_t addMail(const String_t& to, const String_t& content);
+
+        /** Get number of mails.
+            \return number of mails added using addMail() */
+        size_t getNumMails() const;
+
+        /** Get status of a mail.
+            \param index Index, [0,getNumMails())
+            \return status */
+        Status getStatus(size_t index) const;
+
+        /** Check whether pipelining was used.
+            Valid after the session has greeted the server.
+            \return true if pipelining is in use */
+        bool isPipelining() const;
+
+        // LineHandler:
+        virtual bool handleOpening(afl::net::line::LineSink& response);
+        virtual bool handleLine(const String_t& line, afl::net::line::LineSink& response);
+        virtual void handleConnectionClose();
+
+     private:
+        /** Expected reply. */
+        enum Reply {
+            GreetingReply,
+            EhloReply,
+            HeloReply,
+            MailReply,
+            RcptReply,
+            DataReply,
+            EndDataReply,
+            ResetReply,
+            QuitReply
+        };
+
+        struct Mail {
+            String_t to;
+            String_t content;
+            Status status;
+            Mail(const String_t& to, const String_t& content)
+                : to(to), content(content), status(Pending)
+                { }
+        };
+
+        const afl::net::smtp::Configuration m_config;
+        const bool m_allowPipelining;
+
+        std::vector<Mail> m_mails;
+        std::deque<Reply> m_expectedReplies;
+        size_t m_currentMail;
+        bool m_serverPipelining;
+        bool m_pipelining;
+        bool m_mailAccepted;
+        bool m_receiverAccepted;
+
+        void sendCommand(afl::net::line::LineSink& response, const String_t& command, Reply reply);
+        void startTransaction(afl::net::line::LineSink& response);
+        void sendContent(afl::net::line::LineSink& response, const String_t& content);
+        void finishTransaction(afl::net::line::LineSink& response, Status status);
+        void abortTransaction(afl::net::line::LineSink& response);
+        void abortSession(afl::net::line::LineSink& response);
+    };
+
+} }
+
+#endif
@@ -0,0 +1,61 @@
+/**
+  *  \file server/mailout/templatecache.cpp
+  *  \brief Class server::mailout::TemplateCache
+  */
+
+#include "server/mailout/templatecache.hpp"
+#include "afl/io/directoryentry.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/io/stream.hpp"
+#include "afl/sys/mutexguard.hpp"
+
+// Constructor.
+server::mailout::TemplateCache::TemplateCache(afl::base::Ref<afl::io::Directory> dir)
+    : m_directory(dir),
+      m_mutex(),
+      m_entries()
+{ }
+
+// Destructor.
+server::mailout::TemplateCache::~TemplateCache()
+{ }
+
+// Get template content.
+String_t
+server::mailout::TemplateCache::get(const String_t& name)
+{
+    // File access happens outside the mutex, so a slow file system does not block other workers.
+    const afl::sys::Time fileTime = m_directory->getDirectoryEntryByName(name)->getModificationTime();
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        std::map<String_t, Entry>::const_iterator it = m_entries.find(name);
+        if (it != m_entries.end() && (it->second.modificationTime - fileTime).getMilliseconds() == 0) {
+            return it->second.content;
+        }
+    }
+
+    // Not cached or outdated: load it
+    Entry e;
+    e.content = afl::string::fromBytes(m_directory->openFile(name, afl::io::FileSystem::OpenRead)->createVirtualMapping()->get());
+    e.modificationTime = fileTime;
+
+    afl::sys::MutexGuard g(m_mutex);
+    m_entries[name] = e;
+    return e.content;
+}
+
+// Remove all entries.
+void
+server::mailout::TemplateCache::clear()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    m_entries.clear();
+}
+
+// Get number of entries.
+size_t
+server::mailout::TemplateCache::getNumEntries() const
+{
+    afl::sys::MutexGuard g(m_mutex);
+    return m_entries.size();
+}
@@ -0,0 +1,61 @@
+/**
+  *  \file server/mailout/templatecache.hpp
+  *  \brief Class server::mailout::TemplateCache
+  */
+#ifndef C2NG_SERVER_MAILOUT_TEMPLATECACHE_HPP
+#define C2NG_SERVER_MAILOUT_TEMPLATECACHE_HPP
+
+#include <map>
+#include "afl/base/ref.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/io/directory.hpp"
+#include "afl/string/string.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/time.hpp"
+
+namespace server { namespace mailout {
+
+    /** Cache for template files.
+        Keeps the content of template files in memory, keyed by template name,
+        so that a mail sent to many receivers does not re-read the file for each receiver.
+
+        An entry is revalidated against the file's modification time on each access,
+        so templates can still be updated while the service is running.
+
+        This class is thread-safe; it is shared by all transmitter workers. */
+    class TemplateCache : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param dir Template directory */
+        explicit TemplateCache(afl::base::Ref<afl::io::Directory> dir);
+
+        /** Destructor. */
+        ~TemplateCache();
+
+        /** Get template content.
+            \param name Template name (file name in template directory)
+            \return file content
+            \throw afl::except::FileProblemException if the file cannot be read */
+        String_t get(const String_t& name);
+
+        /** Remove all entries. */
+        void clear();
+
+        /** Get number of entries.
+            \return number of cached templates */
+        size_t getNumEntries() const;
+
+     private:
+        struct Entry {
+            String_t content;
+            afl::sys::Time modificationTime;
+        };
+
+        afl::base::Ref<afl::io::Directory> m_directory;
+        mutable afl::sys::Mutex m_mutex;
+        std::map<String_t, Entry> m_entries;
+    };
+
+} }
+
+#endif
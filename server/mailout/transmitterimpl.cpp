@@ -3,15 +3,23 @@
   *  \brief Class server::mailout::TransmitterImpl
   */
 
+#include <algorithm>
 #include <memory>
 #include "server/mailout/transmitterimpl.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/internalsink.hpp"
 #include "afl/io/textfile.hpp"
+#include "afl/net/line/client.hpp"
 #include "afl/net/mimebuilder.hpp"
 #include "afl/net/redis/subtree.hpp"
 #include "afl/string/format.hpp"
 #include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "afl/sys/time.hpp"
 #include "server/mailout/message.hpp"
 #include "server/mailout/root.hpp"
+#include "server/mailout/smtpsession.hpp"
 #include "server/mailout/template.hpp"
 
 using afl::string::Format;
@@ -19,6 +27,28 @@ using afl::string::Format;
 namespace {
     const char*const LOG_NAME = "mailout.transmit";
     const char*const THREAD_NAME = "mailout.transmit";
+
+    /* Maximum number of messages a worker takes from the queue for one connection */
+    const size_t MAX_BATCH_SIZE = 50;
+
+    /* Disposition of a receiver in TransmitterImpl::processWork() */
+    enum ReceiverState {
+        Postponed,              // Address not confirmed; keep receiver
+        Rejected,               // Mail could not be prepared
+        Queued                  // Mail has been added to the SMTP session
+    };
+
+    /* A receiver in TransmitterImpl::processWork() */
+    struct Receiver {
+        size_t messageIndex;
+        String_t address;
+        ReceiverState state;
+        size_t mailIndex;
+
+        Receiver(size_t messageIndex, const String_t& address)
+            : messageIndex(messageIndex), address(address), state(Rejected), mailIndex(0)
+            { }
+    };
 }
 
 /************************* TransmitterImpl::Data *************************/
@@ -29,14 +59,25 @@ server::mailout::TransmitterImpl::Data::Data()
       m_mutex(),
       m_stopRequest(false),
       m_workQueue(),
-      m_postponedMessages()
+      m_activeMessages(),
+      m_postponedMessages(),
+      m_numSent(0),
+      m_numFailed(0),
+      m_numConnections(0)
 { }
 
 inline bool
-server::mailout::TransmitterImpl::Data::isStopRequested()
+server::mailout::TransmitterImpl::Data::wait()
 {
+    // Wait for work. If this is a stop request, pass it on to the next worker.
+    m_wake.wait();
     afl::sys::MutexGuard g(m_mutex);
-    return m_stopRequest;
+    if (m_stopRequest) {
+        m_wake.post();
+        return false;
+    } else {
+        return true;
+    }
 }
 
 inline void
@@ -48,15 +89,22 @@ server::mailout::TransmitterImpl::Data::requestStop()
 }
 
 inline bool
-server::mailout::TransmitterImpl::Data::getNextWork(int32_t& msgId)
+server::mailout::TransmitterImpl::Data::isStopRequested()
 {
     afl::sys::MutexGuard g(m_mutex);
-    if (m_workQueue.empty()) {
-        return false;
-    } else {
-        msgId = m_workQueue.front();
-        return true;
+    return m_stopRequest;
+}
+
+inline bool
+server::mailout::TransmitterImpl::Data::getNextWork(std::vector<int32_t>& msgIds, size_t maxMessages)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    msgIds.clear();
+    while (!m_workQueue.empty() && msgIds.size() < maxMessages) {
+        msgIds.push_back(m_workQueue.front());
+        m_activeMessages.splice(m_activeMessages.end(), m_workQueue, m_workQueue.begin());
     }
+    return !msgIds.empty();
 }
 
 inline void
@@ -69,18 +117,27 @@ server::mailout::TransmitterImpl::Data::addToWork(int32_t msgId)
 }
 
 inline void
-server::mailout::TransmitterImpl::Data::removeFromWork(int32_t msgId)
+server::mailout::TransmitterImpl::Data::finishWork(int32_t msgId, bool keep)
 {
     afl::sys::MutexGuard g(m_mutex);
-    m_workQueue.remove(msgId);
+    m_activeMessages.remove(msgId);
+    if (keep) {
+        m_postponedMessages.push_back(msgId);
+    }
 }
 
 inline void
-server::mailout::TransmitterImpl::Data::moveToPending(int32_t msgId)
+server::mailout::TransmitterImpl::Data::releaseWork(const std::vector<int32_t>& msgIds)
 {
+    // Return unfinished messages to the front of the queue, without waking anyone.
+    // Like a failed message in a single-threaded transmitter, they will be retried with the next wake-up.
     afl::sys::MutexGuard g(m_mutex);
-    m_workQueue.remove(msgId);
-    m_postponedMessages.push_back(msgId);
+    for (size_t i = msgIds.size(); i > 0; --i) {
+        std::list<int32_t>::iterator it = std::find(m_activeMessages.begin(), m_activeMessages.end(), msgIds[i-1]);
+        if (it != m_activeMessages.end()) {
+            m_workQueue.splice(m_workQueue.begin(), m_activeMessages, it);
+        }
+    }
 }
 
 inline void
@@ -97,11 +154,51 @@ server::mailout::TransmitterImpl::Data::movePendingToWork()
 }
 
 inline void
-server::mailout::TransmitterImpl::Data::wait()
+server::mailout::TransmitterImpl::Data::addStatistics(int32_t numSent, int32_t numFailed, int32_t numConnections)
 {
-    m_wake.wait();
+    afl::sys::MutexGuard g(m_mutex);
+    m_numSent += numSent;
+    m_numFailed += numFailed;
+    m_numConnections += numConnections;
+}
+
+inline void
+server::mailout::TransmitterImpl::Data::getStatistics(Statistics& st)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    st.numQueued = m_workQueue.size();
+    st.numActive = m_activeMessages.size();
+    st.numPostponed = m_postponedMessages.size();
+    st.numSent = m_numSent;
+    st.numFailed = m_numFailed;
+    st.numConnections = m_numConnections;
 }
 
+/************************ TransmitterImpl::Worker ************************/
+
+class server::mailout::TransmitterImpl::Worker : private afl::base::Stoppable {
+ public:
+    Worker(TransmitterImpl& parent, size_t index)
+        : m_parent(parent),
+          m_index(index),
+          m_thread(THREAD_NAME, *this)
+        { m_thread.start(); }
+
+    void join()
+        { m_thread.join(); }
+
+    virtual void run()
+        { m_parent.runWorker(m_index); }
+
+    virtual void stop()
+        { m_parent.m_data.requestStop(); }
+
+ private:
+    TransmitterImpl& m_parent;
+    const size_t m_index;
+    afl::sys::Thread m_thread;
+};
+
 /**************************** TransmitterImpl ****************************/
 
 server::mailout::TransmitterImpl::TransmitterImpl(Root& root,
@@ -109,29 +206,29 @@ server::mailout::TransmitterImpl::TransmitterImpl(Root& root,
                                                   afl::net::NetworkStack& net,
                                                   afl::net::Name smtpAddress,
                                                   const afl::net::smtp::Configuration& smtpConfig)
-    : m_thread(THREAD_NAME, *this),
-      m_root(root),
-      m_templateDirectory(templateDir),
-      m_smtpClient(net, smtpAddress, smtpConfig),
+    : m_root(root),
+      m_templateCache(templateDir),
+      m_smtpAddress(smtpAddress),
       m_smtpConfig(smtpConfig),
       m_networkStack(net),
-      m_data()
+      m_data(),
+      m_workers()
 {
     // ex Transmitter::Transmitter
 
-    // Logger
-    m_smtpClient.log().addListener(m_root.log());
-
-    // Start worker thread
-    m_thread.start();
+    // Start worker threads
+    const int numWorkers = std::max(1, m_root.config().numTransmitters);
+    for (int i = 0; i < numWorkers; ++i) {
+        m_workers.pushBackNew(new Worker(*this, size_t(i)));
+    }
 }
 
 server::mailout::TransmitterImpl::~TransmitterImpl()
 {
-    stop();
-    m_thread.join();
-
-    m_smtpClient.log().removeListener(m_root.log());
+    m_data.requestStop();
+    for (size_t i = 0, n = m_workers.size(); i < n; ++i) {
+        m_workers[i]->join();
+    }
 }
 
 // Send a message. Called after an element is added to the Sending queue.
@@ -157,155 +254,240 @@ server::mailout::TransmitterImpl::runQueue()
     m_data.movePendingToWork();
 }
 
+// Get statistics.
+server::mailout::TransmitterImpl::Statistics
+server::mailout::TransmitterImpl::getStatistics()
+{
+    Statistics st;
+    m_data.getStatistics(st);
+    st.numWorkers = m_workers.size();
+    return st;
+}
+
+/** Worker main loop.
+    \param workerIndex Index of worker, for logging */
 void
-server::mailout::TransmitterImpl::run()
+server::mailout::TransmitterImpl::runWorker(size_t workerIndex)
 {
     // ex Transmitter::entry
-    while (1) {
-        m_data.wait();
-        if (m_data.isStopRequested()) {
-            break;
-        }
-        try {
-            processWork();
-        }
-        catch (std::exception& e) {
-            const bool inShutdown = m_data.isStopRequested();
-            m_root.log().write(inShutdown ? afl::sys::LogListener::Info : afl::sys::LogListener::Warn, LOG_NAME, "exception in transmitter", e);
-            if (!inShutdown) {
-                afl::sys::Thread::sleep(2000);
+    std::vector<int32_t> messageIds;
+    while (m_data.wait()) {
+        if (m_data.getNextWork(messageIds, MAX_BATCH_SIZE)) {
+            try {
+                processWork(workerIndex, messageIds);
+            }
+            catch (std::exception& e) {
+                m_data.releaseWork(messageIds);
+                const bool inShutdown = m_data.isStopRequested();
+                m_root.log().write(inShutdown ? afl::sys::LogListener::Info : afl::sys::LogListener::Warn, LOG_NAME, "exception in transmitter", e);
+                if (!inShutdown) {
+                    afl::sys::Thread::sleep(2000);
+                }
             }
         }
     }
 }
 
+/** Process a batch of messages.
+    Prepares mails for all receivers, sends them on one SMTP connection, and updates the database.
+    \param workerIndex Index of worker, for logging
+    \param messageIds  Messages; must have been taken from the queue using Data::getNextWork() */
 void
-server::mailout::TransmitterImpl::stop()
-{
-    m_data.requestStop();
-}
-
-void
-server::mailout::TransmitterImpl::processWork()
+server::mailout::TransmitterImpl::processWork(size_t workerIndex, const std::vector<int32_t>& messageIds)
 {
     // ex Transmitter::processWork
-    // Fetch message id
-    int32_t mid;
-    if (!m_data.getNextWork(mid)) {
-        return;
-    }
+    const uint32_t startTime = afl::sys::Time::getTickCounter();
+    SmtpSession session(m_smtpConfig, m_root.config().usePipelining);
+    std::vector<Receiver> receivers;
+    std::vector<bool> isActive(messageIds.size());
+
+    // Prepare mails
+    for (size_t i = 0; i < messageIds.size(); ++i) {
+        // Obtain message object
+        const int32_t mid = messageIds[i];
+        Message msg(m_root, mid, Message::Sending);
+
+        // Still active?
+        bool active = true;
+        String_t uid = msg.uniqueId().get();
+        if (!uid.empty() && m_root.uniqueIdMap().intField(uid).get() != mid) {
+            m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] expired (replaced by new instance)", mid));
+            active = false;
+        }
 
-    // Obtain message object
-    Message msg(m_root, mid, Message::Sending);
+        if (m_root.getCurrentTime() > msg.expireTime().get()) {
+            m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] expired (too old)", mid));
+            active = false;
+        }
 
-    // Still active?
-    bool active = true;
-    String_t uid = msg.uniqueId().get();
-    if (!uid.empty() && m_root.uniqueIdMap().intField(uid).get() != mid) {
-        m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] expired (replaced by new instance)", mid));
-        active = false;
-    }
+        if (!active) {
+            msg.remove();
+            m_data.finishWork(mid, false);
+            continue;
+        }
+        isActive[i] = true;
 
-    if (m_root.getCurrentTime() > msg.expireTime().get()) {
-        m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] expired (too old)", mid));
-        active = false;
+        // Get message parameters
+        afl::data::StringList_t addresses, args, atts;
+        msg.receivers().getAll(addresses);
+        msg.arguments().getAll(args);
+        msg.attachments().getAll(atts);
+        const String_t templateName = msg.templateName().get();
+
+        // Prepare a mail for each receiver
+        for (size_t j = 0; j < addresses.size(); ++j) {
+            Receiver r(i, addresses[j]);
+            try {
+                String_t smtpAddress, content;
+                if (prepareMail(templateName, args, atts, addresses[j], smtpAddress, content)) {
+                    r.state = Queued;
+                    r.mailIndex = session.addMail(smtpAddress, content);
+                } else {
+                    r.state = Postponed;
+                }
+            }
+            catch (std::exception& e) {
+                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' failed", mid, addresses[j]), e);
+            }
+            receivers.push_back(r);
+        }
     }
 
-    if (!active) {
-        msg.remove();
-        m_data.removeFromWork(mid);
-        return;
+    // Send all mails on one connection
+    int32_t numConnections = 0;
+    if (session.getNumMails() != 0) {
+        try {
+            ++numConnections;
+            afl::net::line::Client(m_networkStack, m_smtpAddress).call(session);
+        }
+        catch (std::exception& e) {
+            m_root.log().write(afl::sys::LogListener::Warn, LOG_NAME, Format("[worker:%d] SMTP connection failed", workerIndex), e);
+        }
     }
 
-    // Get receivers
-    afl::data::StringList_t receivers;
-    msg.receivers().getAll(receivers);
-
-    // Send it
-    bool keep = false;
+    // Evaluate result
+    const bool inShutdown = m_data.isStopRequested();
+    std::vector<bool> keep(messageIds.size());
+    int32_t numSent = 0;
+    int32_t numFailed = 0;
     for (size_t i = 0; i < receivers.size(); ++i) {
+        const Receiver& r = receivers[i];
+        const int32_t mid = messageIds[r.messageIndex];
         bool keepThis = false;
-        try {
-            if (!sendMessage(msg, receivers[i])) {
-                keepThis = true;
-                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' postponed", mid, receivers[i]));
-            } else {
-                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' succeeded", mid, receivers[i]));
-            }
-        }
-        catch (std::exception& e) {
-            m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' failed", mid, receivers[i]), e);
-            if (m_data.isStopRequested()) {
-                // Exception may be caused by shutdown; better keep the message
-                keepThis = true;
+        bool failed = true;
+        switch (r.state) {
+         case Postponed:
+            m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' postponed", mid, r.address));
+            keepThis = true;
+            failed = false;
+            break;
+
+         case Rejected:
+            // Exception may be caused by shutdown; better keep the message
+            keepThis = inShutdown;
+            break;
+
+         case Queued:
+            switch (session.getStatus(r.mailIndex)) {
+             case SmtpSession::Sent:
+                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' succeeded", mid, r.address));
+                failed = false;
+                break;
+             case SmtpSession::Failed:
+                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' rejected by SMTP server", mid, r.address));
+                break;
+             case SmtpSession::Pending:
+                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] receiver '%s' failed", mid, r.address));
+                keepThis = inShutdown;
+                break;
             }
+            break;
         }
+
         if (!keepThis) {
             // Message failed or succeeded: remove from database
-            msg.receivers().remove(receivers[i]);
+            Message(m_root, mid, Message::Sending).receivers().remove(r.address);
+            if (failed) {
+                ++numFailed;
+            } else {
+                ++numSent;
+            }
         } else {
             // Message postponed: keep it
-            keep = true;
+            keep[r.messageIndex] = true;
         }
     }
 
     // Postprocess
-    if (keep) {
-        // Keep message because it has unverified addresses
-        m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] keeping", mid));
-        m_data.moveToPending(mid);
-    } else {
-        // Discard message because it has been sent or permanently failed
-        m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] finished", mid));
-        msg.remove();
-        m_data.removeFromWork(mid);
+    for (size_t i = 0; i < messageIds.size(); ++i) {
+        if (isActive[i]) {
+            const int32_t mid = messageIds[i];
+            if (keep[i]) {
+                // Keep message because it has unverified addresses
+                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] keeping", mid));
+                m_data.finishWork(mid, true);
+            } else {
+                // Discard message because it has been sent or permanently failed
+                m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, Format("[msg:%d] finished", mid));
+                Message(m_root, mid, Message::Sending).remove();
+                m_data.finishWork(mid, false);
+            }
+        }
+    }
+
+    // Statistics
+    m_data.addStatistics(numSent, numFailed, numConnections);
+    if (session.getNumMails() != 0) {
+        m_root.log().write(afl::sys::LogListener::Info, LOG_NAME,
+                           Format("[worker:%d] %d mail(s) in %d ms, %d sent, %d failed%s",
+                                  workerIndex, session.getNumMails(), afl::sys::Time::getTickCounter() - startTime,
+                                  numSent, numFailed, session.isPipelining() ? ", pipelined" : ""));
     }
 }
 
+/** Prepare a mail.
+    \param [in]  templateName  Name of template file
+    \param [in]  args          Message arguments (name/value pairs)
+    \param [in]  atts          Message attachments (URLs)
+    \param [in]  address       Receiver address as stored in the message (e.g. "user:foo" or "mail:foo@bar")
+    \param [out] smtpAddress   SMTP address of receiver
+    \param [out] content       Mail content
+    \retval true  Mail prepared
+    \retval false Address not resolvable at this time; postpone this receiver */
 bool
-server::mailout::TransmitterImpl::sendMessage(Message& msg, String_t address)
+server::mailout::TransmitterImpl::prepareMail(const String_t& templateName, const afl::data::StringList_t& args, const afl::data::StringList_t& atts,
+                                              const String_t& address, String_t& smtpAddress, String_t& content)
 {
     // ex Transmitter::sendMessage
     // Resolve email address
-    String_t smtpAddress;
     String_t authUser;
     if (!m_root.resolveAddress(address, smtpAddress, authUser)) {
         return false;
     }
 
     // Prepare message
-    String_t tplName;
     Template tpl;
     tpl.addVariable("SMTP_FROM", m_smtpConfig.from);
     tpl.addVariable("SMTP_FQDN", m_smtpConfig.hello);
     tpl.addVariable("SMTP_TO", smtpAddress);
     tpl.addVariable("USER", authUser);
     tpl.addVariable("CGI_ROOT", m_root.config().baseUrl);
-
-    {
-        afl::data::StringList_t args;
-        msg.arguments().getAll(args);
-        for (size_t i = 0; i+1 < args.size(); i += 2) {
-            tpl.addVariable(args[i], args[i+1]);
-        }
+    for (size_t i = 0; i+1 < args.size(); i += 2) {
+        tpl.addVariable(args[i], args[i+1]);
     }
-    {
-        afl::data::StringList_t atts;
-        msg.attachments().getAll(atts);
-        for (size_t i = 0; i < atts.size(); ++i) {
-            tpl.addFile(atts[i]);
-        }
+    for (size_t i = 0; i < atts.size(); ++i) {
+        tpl.addFile(atts[i]);
     }
-    tplName = msg.templateName().get();
 
     // Generate
-    afl::base::Ref<afl::io::Stream> s = m_templateDirectory->openFile(tplName, afl::io::FileSystem::OpenRead);
-    afl::io::TextFile tf(*s);
+    const String_t templateText = m_templateCache.get(templateName);
+    afl::io::ConstMemoryStream s(afl::string::toBytes(templateText));
+    afl::io::TextFile tf(s);
     std::auto_ptr<afl::net::MimeBuilder> smtpMessage(tpl.generate(tf, m_networkStack, authUser, smtpAddress));
 
-    // Send
-    const String_t to[] = {smtpAddress};
-    m_smtpClient.send(to, *smtpMessage);
-
+    // Serialize
+    afl::io::InternalSink out;
+    smtpMessage->write(out, false);
+    content = afl::string::fromBytes(out.getContent());
     return true;
 }
@@ -6,22 +6,23 @@
 #define C2NG_SERVER_MAILOUT_TRANSMITTERIMPL_HPP
 
 #include <list>
+#include <vector>
 #include "afl/base/ref.hpp"
-#include "afl/base/stoppable.hpp"
 #include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/data/stringlist.hpp"
 #include "afl/io/directory.hpp"
 #include "afl/net/name.hpp"
-#include "afl/net/smtp/client.hpp"
+#include "afl/net/networkstack.hpp"
 #include "afl/net/smtp/configuration.hpp"
 #include "afl/sys/mutex.hpp"
 #include "afl/sys/semaphore.hpp"
-#include "afl/sys/thread.hpp"
+#include "server/mailout/templatecache.hpp"
 #include "server/mailout/transmitter.hpp"
 
 namespace server { namespace mailout {
 
     class Root;
-    class Message;
 
     /** Transmitter for sending mails on SMTP.
         This is the main implementation of the Transmitter interface for production use.
@@ -45,18 +46,35 @@ namespace server { namespace mailout {
         If they cannot be sent right now, they are moved to the m_postponedMessages and reconsidered at a later time
         by moving them back to m_workQueue.
 
+        <b>Workers</b>
+
+        Messages are sent by a pool of workers (Configuration::numTransmitters), each running in its own thread.
+        A worker takes a batch of messages from m_workQueue (moving them to m_activeMessages),
+        prepares mails for all their receivers, and sends them all on a single SMTP connection
+        (see SmtpSession), using pipelining if enabled and supported by the server.
+        Template files are cached in a TemplateCache shared by all workers.
+
         <b>Mutual Exclusion</b>
 
-        TransmitterImpl spawns a thread that processes the queue.
-        That thread will access the database.
+        The worker threads access the database.
         The database CommandHandler is expected to be multithread-safe.
 
         Explicit protection is required only for TransmitterImpl's own members. */
     class TransmitterImpl : public Transmitter,
-                            private afl::base::Uncopyable,
-                            private afl::base::Stoppable
+                            private afl::base::Uncopyable
     {
      public:
+        /** Statistics. */
+        struct Statistics {
+            size_t numQueued;           ///< Number of messages waiting for a worker.
+            size_t numActive;           ///< Number of messages currently being processed by a worker.
+            size_t numPostponed;        ///< Number of messages waiting for an address to be confirmed.
+            int32_t numSent;            ///< Total number of mails (=receivers) accepted by the SMTP server.
+            int32_t numFailed;          ///< Total number of mails (=receivers) that failed.
+            int32_t numConnections;     ///< Total number of SMTP connections.
+            size_t numWorkers;          ///< Number of workers.
+        };
+
         /** Constructor.
             \param root Service root; must live longer than TransmitterImpl instance
             \param templateDir Template directory
@@ -69,7 +87,8 @@ namespace server { namespace mailout {
                         afl::net::Name smtpAddress,
                         const afl::net::smtp::Configuration& smtpConfig);
 
-        /** Destructor. */
+        /** Destructor.
+            Stops all workers. */
         ~TransmitterImpl();
 
         // Transmitter:
@@ -77,46 +96,58 @@ namespace server { namespace mailout {
         virtual void notifyAddress(String_t address);
         virtual void runQueue();
 
-     private:
-        virtual void run();
-        virtual void stop();
+        /** Get statistics.
+            \return statistics */
+        Statistics getStatistics();
 
-        void processWork();
-        bool sendMessage(Message& msg, String_t address);
+     private:
+        class Worker;
 
-        afl::sys::Thread m_thread;
+        void runWorker(size_t workerIndex);
+        void processWork(size_t workerIndex, const std::vector<int32_t>& messageIds);
+        bool prepareMail(const String_t& templateName, const afl::data::StringList_t& args, const afl::data::StringList_t& atts,
+                         const String_t& address, String_t& smtpAddress, String_t& content);
 
         Root& m_root;
-        afl::base::Ref<afl::io::Directory> m_templateDirectory;
+        TemplateCache m_templateCache;
 
-        afl::net::smtp::Client m_smtpClient;
+        afl::net::Name m_smtpAddress;
         afl::net::smtp::Configuration m_smtpConfig;
         afl::net::NetworkStack& m_networkStack;
 
         /** Protected data.
-            Stuff in this class is protected by a mutex and can be accessed by the worker thread
+            Stuff in this class is protected by a mutex and can be accessed by the worker threads
             as well as the main service thread. */
         class Data {
          public:
             Data();
 
-            bool isStopRequested();
+            bool wait();
             void requestStop();
-            bool getNextWork(int32_t& msgId);
+            bool isStopRequested();
+            bool getNextWork(std::vector<int32_t>& msgIds, size_t maxMessages);
             void addToWork(int32_t msgId);
-            void removeFromWork(int32_t msgId);
-            void moveToPending(int32_t msgId);
+            void finishWork(int32_t msgId, bool keep);
+            void releaseWork(const std::vector<int32_t>& msgIds);
             void movePendingToWork();
-            void wait();
+            void addStatistics(int32_t numSent, int32_t numFailed, int32_t numConnections);
+            void getStatistics(Statistics& st);
 
          private:
-            afl::sys::Semaphore m_wake;             ///< Wake the worker. Posted for each element added to m_workQueue, or for stop request.
+            afl::sys::Semaphore m_wake;             ///< Wake a worker. Posted for each element added to m_workQueue, or for stop request.
             afl::sys::Mutex m_mutex;                ///< Mutex protecting all of the following variables.
-            bool m_stopRequest;                     ///< Set to true to trigger stop of the worker thread.
-            std::list<int32_t> m_workQueue;         ///< List of items to process. Head is currently being worked on.
+            bool m_stopRequest;                     ///< Set to true to trigger stop of the worker threads.
+            std::list<int32_t> m_workQueue;         ///< List of items to process.
+            std::list<int32_t> m_activeMessages;    ///< List of items currently being worked on.
             std::list<int32_t> m_postponedMessages; ///< List of items that failed because of an unverified address.
+            int32_t m_numSent;                      ///< Statistics: number of mails sent.
+            int32_t m_numFailed;                    ///< Statistics: number of mails failed.
+            int32_t m_numConnections;               ///< Statistics: number of connections.
         };
         Data m_data;
+
+        // Workers. Last member, so everything is set up when they start.
+        afl::container::PtrVector<Worker> m_workers;
     };
 
 } }
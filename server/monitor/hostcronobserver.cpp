@@ -0,0 +1,96 @@
+/**
+  *  \file server/monitor/hostcronobserver.cpp
+  *  \brief Class server::monitor::HostCronObserver
+  */
+
+#include "server/monitor/hostcronobserver.hpp"
+#include "afl/net/resp/client.hpp"
+#include "server/interface/hostcronclient.hpp"
+
+// Constructor.
+server::monitor::HostCronObserver::HostCronObserver(Flavor flavor, afl::net::NetworkStack& net, afl::net::Name defaultAddress)
+    : Observer(),
+      m_flavor(flavor),
+      m_networkStack(net),
+      m_address(defaultAddress)
+{ }
+
+// Destructor.
+server::monitor::HostCronObserver::~HostCronObserver()
+{ }
+
+// Get user-readable name of service.
+String_t
+server::monitor::HostCronObserver::getName()
+{
+    switch (m_flavor) {
+     case QueueLength: return "Host Queue";
+     case Utilisation: return "Host Workers";
+    }
+    return String_t();
+}
+
+// Get machine-readable identifier of service.
+String_t
+server::monitor::HostCronObserver::getId()
+{
+    switch (m_flavor) {
+     case QueueLength: return "HOSTQUEUE";
+     case Utilisation: return "HOSTWORKERS";
+    }
+    return String_t();
+}
+
+// Get unit of result value.
+String_t
+server::monitor::HostCronObserver::getUnit()
+{
+    switch (m_flavor) {
+     case QueueLength: return "games";
+     case Utilisation: return "%";
+    }
+    return String_t();
+}
+
+// Handle configuration item.
+bool
+server::monitor::HostCronObserver::handleConfiguration(const String_t& key, const String_t& value)
+{
+    // Same keys as the "Host Manager" NetworkObserver
+    if (key == "HOST.HOST") {
+        m_address.setName(value);
+        return true;
+    } else if (key == "HOST.PORT") {
+        m_address.setService(value);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Determine result.
+server::monitor::Observer::Result
+server::monitor::HostCronObserver::check()
+{
+    // Special case: if host is 0.0.0.0, connect to localhost
+    afl::net::Name name = m_address;
+    if (name.getName().find_first_not_of("0.") == String_t::npos) {
+        name.setName("127.0.0.1");
+    }
+
+    // Query status. This throws if the service is not reachable; the caller will report that.
+    afl::net::resp::Client client(m_networkStack, name);
+    const server::interface::HostCron::Status st = server::interface::HostCronClient(client).getStatus();
+
+    switch (m_flavor) {
+     case QueueLength:
+        return Result(Value, st.numWaitingGames);
+
+     case Utilisation:
+        if (st.numWorkers > 0) {
+            return Result(Value, 100 * st.numRunningGames / st.numWorkers);
+        }
+        break;
+    }
+    return Result();
+}
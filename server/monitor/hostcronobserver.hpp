@@ -0,0 +1,51 @@
+/**
+  *  \file server/monitor/hostcronobserver.hpp
+  *  \brief Class server::monitor::HostCronObserver
+  */
+#ifndef C2NG_SERVER_MONITOR_HOSTCRONOBSERVER_HPP
+#define C2NG_SERVER_MONITOR_HOSTCRONOBSERVER_HPP
+
+#include "server/monitor/observer.hpp"
+#include "afl/net/name.hpp"
+#include "afl/net/networkstack.hpp"
+
+namespace server { namespace monitor {
+
+    /** Observer for the host scheduler.
+        Reports the status of c2host-server's cron workers, as obtained by the CRONSTATUS command. */
+    class HostCronObserver : public Observer {
+     public:
+        /** Value to report. */
+        enum Flavor {
+            /** Number of due games waiting for a worker. */
+            QueueLength,
+
+            /** Percentage of workers that are busy. */
+            Utilisation
+        };
+
+        /** Constructor.
+            \param flavor Value to report
+            \param net NetworkStack instance
+            \param defaultAddress Default address of host service if none configured (HOST.HOST, HOST.PORT) */
+        HostCronObserver(Flavor flavor, afl::net::NetworkStack& net, afl::net::Name defaultAddress);
+
+        /** Destructor. */
+        ~HostCronObserver();
+
+        // Observer:
+        virtual String_t getName();
+        virtual String_t getId();
+        virtual String_t getUnit();
+        virtual bool handleConfiguration(const String_t& key, const String_t& value);
+        virtual Result check();
+
+     private:
+        Flavor m_flavor;
+        afl::net::NetworkStack& m_networkStack;
+        afl::net::Name m_address;
+    };
+
+} }
+
+#endif
@@ -14,6 +14,7 @@
 #include "afl/sys/thread.hpp"
 #include "afl/sys/time.hpp"
 #include "server/monitor/badnessfileobserver.hpp"
+#include "server/monitor/hostcronobserver.hpp"
 #include "server/monitor/loadaverageobserver.hpp"
 #include "server/monitor/networkobserver.hpp"
 #include "server/monitor/statuspage.hpp"
@@ -68,6 +69,8 @@ server::monitor::ServerApplication::ServerApplication(afl::sys::Environment& env
     m_status.addNewObserver(new NetworkObserver("Binary File I/O",  "FORMAT",   NetworkObserver::Service, clientNetworkStack(), afl::net::Name(DEFAULT_ADDRESS, FORMAT_PORT)));
     m_status.addNewObserver(new BadnessFileObserver("Mail Fetch", "POP3.ERROR", fileSystem()));
     m_status.addNewObserver(new LoadAverageObserver(fileSystem(), "/proc/loadavg"));
+    m_status.addNewObserver(new HostCronObserver(HostCronObserver::QueueLength, clientNetworkStack(), afl::net::Name(DEFAULT_ADDRESS, HOST_PORT)));
+    m_status.addNewObserver(new HostCronObserver(HostCronObserver::Utilisation, clientNetworkStack(), afl::net::Name(DEFAULT_ADDRESS, HOST_PORT)));
 }
 
 server::monitor::ServerApplication::~ServerApplication()
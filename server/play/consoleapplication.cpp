@@ -3,6 +3,7 @@
   */
 
 #include "server/play/consoleapplication.hpp"
+#include "afl/base/vectorenumerator.hpp"
 #include "afl/charset/charset.hpp"
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
@@ -24,6 +25,7 @@
 #include "server/play/fs/session.hpp"
 #include "server/play/gameaccess.hpp"
 #include "server/play/mainpacker.hpp"
+#include "server/play/specificationcache.hpp"
 #include "server/ports.hpp"
 #include "util/charsetfactory.hpp"
 #include "util/messagecollector.hpp"
@@ -35,14 +37,18 @@ using afl::string::Format;
 struct server::play::ConsoleApplication::Parameters {
     afl::base::Optional<String_t> arg_gamedir;  // -G
     afl::base::Optional<String_t> arg_rootdir;  // -R
+    afl::base::Optional<String_t> arg_cachedir; // --cache
     std::auto_ptr<afl::charset::Charset> gameCharset;
     int playerNumber;
+    bool standby;                               // --standby
 
     Parameters()
         : arg_gamedir(),
           arg_rootdir(),
+          arg_cachedir(),
           gameCharset(new afl::charset::CodepageCharset(afl::charset::g_codepageLatin1)),
-          playerNumber(0)
+          playerNumber(0),
+          standby(false)
         { }
 };
 
@@ -62,50 +68,41 @@ server::play::ConsoleApplication::appMain()
 
     // Parser
     afl::sys::StandardCommandLineParser commandLine(environment().getCommandLine());
-    String_t p;
-    bool opt;
-    while (commandLine.getNext(opt, p)) {
-        if (opt) {
-            if (p == "h" || p == "help") {
-                help();
-            } else if (p == "C") {
-                // character set
-                if (afl::charset::Charset* cs = util::CharsetFactory().createCharset(commandLine.getRequiredParameter(p))) {
-                    params.gameCharset.reset(cs);
-                } else {
-                    errorExit(tx("the specified character set is not known"));
-                }
-            } else if (p == "R" || p == "W") {
-                // session conflict management; skip those
-                commandLine.getRequiredParameter(p);
-            } else if (p == "D") {
-                // property
-                String_t key = commandLine.getRequiredParameter(p);
-                String_t value;
-                String_t::size_type eq = key.find('=');
-                if (eq != String_t::npos) {
-                    value.assign(key, eq+1, String_t::npos);
-                    key.erase(eq);
-                }
-                m_properties[key] = value;
-            } else {
-                errorExit(Format(tx("invalid option '%s' specified. Use '%s -h' for help."), p, environment().getInvocationName()));
+    parseParameters(commandLine, params);
+
+    // Central logger
+    util::MessageCollector logCollector;
+
+    // Make a session
+    game::Session session(tx, fileSystem());
+    session.log().addListener(logCollector);
+
+    afl::base::Ref<afl::io::TextReader> reader = environment().attachTextReader(afl::sys::Environment::Input);
+
+    // Standby mode (router's warm pool): everything that does not depend on parameters has been set up.
+    // Report readiness, then wait for the actual parameters, one per line, terminated by ".".
+    if (params.standby) {
+        if (params.playerNumber != 0 || params.arg_gamedir.isValid()) {
+            errorExit(tx("option '--standby' cannot be combined with a game"));
+        }
+        standardOutput().writeLine("100 standby");
+        standardOutput().flush();
+
+        afl::base::Ref<afl::base::VectorEnumerator<String_t> > args = *new afl::base::VectorEnumerator<String_t>();
+        String_t line;
+        while (1) {
+            if (!reader->readLine(line)) {
+                // Router discarded us without assigning a game
+                exit(0);
             }
-        } else {
-            int n;
-            if (afl::string::strToInteger(p, n) && n > 0 && n <= game::MAX_PLAYERS) {
-                if (params.playerNumber != 0) {
-                    errorExit(tx("only one player number allowed"));
-                }
-                params.playerNumber = n;
-            } else if (!params.arg_gamedir.isValid()) {
-                params.arg_gamedir = p;
-            } else if (!params.arg_rootdir.isValid()) {
-                params.arg_rootdir = p;
-            } else {
-                errorExit(tx("too many arguments"));
+            if (line == ".") {
+                break;
             }
+            args->add(line);
         }
+
+        afl::sys::StandardCommandLineParser standbyCommandLine(args);
+        parseParameters(standbyCommandLine, params);
     }
 
     if (params.playerNumber == 0) {
@@ -117,13 +114,6 @@ server::play::ConsoleApplication::appMain()
         errorExit(tx("missing directory name"));
     }
 
-    // Central logger
-    util::MessageCollector logCollector;
-
-    // Make a session
-    game::Session session(tx, fileSystem());
-    session.log().addListener(logCollector);
-
     // Check game data
     afl::base::Ptr<game::Root> root = loadRoot(gameDir, params, session.log());
     if (root.get() == 0 || root->getTurnLoader().get() == 0) {
@@ -140,8 +130,7 @@ server::play::ConsoleApplication::appMain()
     session.setGame(new game::Game());
     session.setRoot(root);
     session.setShipList(new game::spec::ShipList());
-    root->specificationLoader().loadShipList(*session.getShipList(), *root, game::makeResultTask(ok))->call();
-    if (!ok) {
+    if (!loadShipList(session, *root, params)) {
         errorExit(tx("unable to load ship list"));
     }
 
@@ -171,8 +160,6 @@ server::play::ConsoleApplication::appMain()
         afl::io::TextWriter& m_out;
     };
 
-    afl::base::Ref<afl::io::TextReader> reader = environment().attachTextReader(afl::sys::Environment::Input);
-
     Sink sink(standardOutput());
     GameAccess impl(session, logCollector);
     server::interface::GameAccessServer server(impl);
@@ -191,6 +178,63 @@ server::play::ConsoleApplication::appMain()
     impl.save();
 }
 
+void
+server::play::ConsoleApplication::parseParameters(afl::sys::CommandLineParser& commandLine, Parameters& params)
+{
+    afl::string::Translator& tx = translator();
+    String_t p;
+    bool opt;
+    while (commandLine.getNext(opt, p)) {
+        if (opt) {
+            if (p == "h" || p == "help") {
+                help();
+            } else if (p == "standby") {
+                // warm pool; see appMain
+                params.standby = true;
+            } else if (p == "cache") {
+                // precompiled specification cache; see loadShipList
+                params.arg_cachedir = commandLine.getRequiredParameter(p);
+            } else if (p == "C") {
+                // character set
+                if (afl::charset::Charset* cs = util::CharsetFactory().createCharset(commandLine.getRequiredParameter(p))) {
+                    params.gameCharset.reset(cs);
+                } else {
+                    errorExit(tx("the specified character set is not known"));
+                }
+            } else if (p == "R" || p == "W") {
+                // session conflict management; skip those
+                commandLine.getRequiredParameter(p);
+            } else if (p == "D") {
+                // property
+                String_t key = commandLine.getRequiredParameter(p);
+                String_t value;
+                String_t::size_type eq = key.find('=');
+                if (eq != String_t::npos) {
+                    value.assign(key, eq+1, String_t::npos);
+                    key.erase(eq);
+                }
+                m_properties[key] = value;
+            } else {
+                errorExit(Format(tx("invalid option '%s' specified. Use '%s -h' for help."), p, environment().getInvocationName()));
+            }
+        } else {
+            int n;
+            if (afl::string::strToInteger(p, n) && n > 0 && n <= game::MAX_PLAYERS) {
+                if (params.playerNumber != 0) {
+                    errorExit(tx("only one player number allowed"));
+                }
+                params.playerNumber = n;
+            } else if (!params.arg_gamedir.isValid()) {
+                params.arg_gamedir = p;
+            } else if (!params.arg_rootdir.isValid()) {
+                params.arg_rootdir = p;
+            } else {
+                errorExit(tx("too many arguments"));
+            }
+        }
+    }
+}
+
 void
 server::play::ConsoleApplication::help()
 {
@@ -199,7 +243,9 @@ server::play::ConsoleApplication::help()
         util::formatOptions(tx("Options:\n"
                                "-Ccs\tSet game character set\n"
                                "-Rkey, -Wkey\tIgnored; used for session conflict resolution\n"
-                               "-Dkey=value\tDefine a property\n"));
+                               "-Dkey=value\tDefine a property\n"
+                               "--standby\tWait for parameters on standard input (router's warm pool)\n"
+                               "--cache=DIR\tShare precompiled ship lists in DIR\n"));
 
     afl::io::TextWriter& out = standardOutput();
     out.writeLine(Format(tx("PCC2 Play Server v%s - (c) 2019-2023 Stefan Reuther").c_str(), PCC2_VERSION));
@@ -245,3 +291,36 @@ server::play::ConsoleApplication::loadRoot(const String_t& gameDir, const Parame
     const game::config::UserConfiguration uc;
     return loader.load(fs.openDirectory(gameDir), *params.gameCharset, uc, false);
 }
+
+bool
+server::play::ConsoleApplication::loadShipList(game::Session& session, game::Root& root, const Parameters& params)
+{
+    // The specification cache is shared between all instances, and is an optimisation only.
+    // If it cannot be used, load normally.
+    afl::string::Translator& tx = translator();
+    std::auto_ptr<SpecificationCache> cache;
+    String_t cacheDir, key;
+    if (params.arg_cachedir.get(cacheDir)) {
+        try {
+            cache.reset(new SpecificationCache(fileSystem().openDirectory(cacheDir), session.log(), tx));
+            key = SpecificationCache::computeKey(root, tx);
+        }
+        catch (std::exception& e) {
+            session.log().write(afl::sys::LogListener::Warn, "play.cache", tx("Unable to use specification cache"), e);
+            cache.reset();
+        }
+    }
+
+    if (cache.get() != 0 && cache->load(key, *session.getShipList(), root.hostConfiguration())) {
+        return true;
+    }
+
+    // Cache miss: load from scratch. Start with a fresh ship list in case cache->load() left it partially populated.
+    bool ok = false;
+    session.setShipList(new game::spec::ShipList());
+    root.specificationLoader().loadShipList(*session.getShipList(), root, game::makeResultTask(ok))->call();
+    if (ok && cache.get() != 0) {
+        cache->save(key, *session.getShipList(), root.hostConfiguration());
+    }
+    return ok;
+}
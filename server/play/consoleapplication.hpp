@@ -8,7 +8,9 @@
 #include "afl/base/ptr.hpp"
 #include "afl/io/nullfilesystem.hpp"
 #include "afl/net/networkstack.hpp"
+#include "afl/sys/commandlineparser.hpp"
 #include "game/root.hpp"
+#include "game/session.hpp"
 #include "util/application.hpp"
 
 namespace server { namespace play {
@@ -22,6 +24,7 @@ namespace server { namespace play {
      private:
         struct Parameters;
 
+        void parseParameters(afl::sys::CommandLineParser& commandLine, Parameters& params);
         void help();
 
         afl::net::NetworkStack& m_network;
@@ -29,6 +32,7 @@ namespace server { namespace play {
         afl::io::NullFileSystem m_nullFileSystem;
 
         afl::base::Ptr<game::Root> loadRoot(const String_t& gameDir, const Parameters& params, afl::sys::LogListener& log);
+        bool loadShipList(game::Session& session, game::Root& root, const Parameters& params);
     };
 
 } }
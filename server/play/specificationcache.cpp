@@ -0,0 +1,676 @@
+/**
+  *  \file server/play/specificationcache.cpp
+  *  \brief Class server::play::SpecificationCache
+  *
+  *  Image format (all integers are 32-bit little-endian, strings are a length followed by UTF-8 data):
+  *  - header: MAGIC, FORMAT_VERSION
+  *  - host configuration: count, then (name, value, source) for each option
+  *  - beams, torpedo launchers, engines, hulls: count, then each component starting with its Id
+  *  - hull assignments, basic hull functions, modified hull functions, racial abilities
+  *  - component names, friendly codes, missions
+  *
+  *  The format is private to this module; FORMAT_VERSION must be changed whenever it or
+  *  the interpretation of the source files changes, so that images from older versions are ignored.
+  */
+
+#include "server/play/specificationcache.hpp"
+#include "afl/base/countof.hpp"
+#include "afl/bits/int32le.hpp"
+#include "afl/bits/value.hpp"
+#include "afl/charset/charset.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/except/fileformatexception.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/directoryentry.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/time.hpp"
+#include "game/limits.hpp"
+#include "game/spec/basichullfunction.hpp"
+#include "game/spec/hullfunction.hpp"
+#include "game/spec/mission.hpp"
+#include "game/specificationloader.hpp"
+
+using afl::base::ConstBytes_t;
+using afl::base::GrowableBytes_t;
+using afl::base::Ptr;
+using afl::io::FileSystem;
+using afl::string::Format;
+using afl::sys::LogListener;
+using game::config::ConfigurationOption;
+using game::config::HostConfiguration;
+using game::spec::ComponentNameProvider;
+using game::spec::Cost;
+using game::spec::HullFunctionAssignmentList;
+using game::spec::ShipList;
+
+namespace {
+    const char LOG_NAME[] = "play.cache";
+
+    /** Name of an image in exceptions. */
+    const char IMAGE_NAME[] = "<specification image>";
+
+    /** File signature. */
+    const uint8_t MAGIC[] = { 'C','C','s','p','e','c',13,26 };
+
+    /** Format version. */
+    const int32_t FORMAT_VERSION = 1;
+
+    /** Specification files read by game::v3::SpecificationLoader::loadShipList(). */
+    const char*const SPECIFICATION_FILES[] = {
+        "beamspec.dat", "torpspec.dat", "engspec.dat", "hullspec.dat", "truehull.dat",
+        "hullfunc.usr", "hullfunc.cc", "shiplist.txt", "hullfunc.txt",
+        "names.usr", "names.cc",
+        "fcodes.cc", "fcodes.usr", "xtrfcode.txt",
+        "mission.usr", "mission.cc", "mission.ini",
+    };
+
+    /** Configuration files read by game::v3::Loader::loadConfiguration(). */
+    const char*const CONFIGURATION_FILES[] = {
+        "pconfig.src", "shiplist.txt", "friday.dat", "hconfig.hst",
+    };
+
+    const Cost::Type COST_TYPES[] = { Cost::Tritanium, Cost::Duranium, Cost::Molybdenum, Cost::Money, Cost::Supplies };
+
+    const ComponentNameProvider::Type NAME_TYPES[] = { ComponentNameProvider::Hull, ComponentNameProvider::Engine, ComponentNameProvider::Beam, ComponentNameProvider::Torpedo };
+
+    typedef afl::bits::Value<afl::bits::Int32LE> Int32_t;
+
+    /*
+     *  Key computation
+     */
+
+    void addString(afl::checksums::SHA1& hash, const String_t& str)
+    {
+        hash.add(afl::string::toBytes(str));
+    }
+
+    void addFile(afl::checksums::SHA1& hash, const String_t& name, afl::io::Stream* file)
+    {
+        if (file != 0) {
+            afl::base::Ref<afl::io::FileMapping> content = file->createVirtualMapping();
+            addString(hash, Format("%s:%d\n", name, content->get().size()));
+            hash.add(content->get());
+        } else {
+            addString(hash, Format("%s:-\n", name));
+        }
+    }
+
+    Ptr<afl::io::Stream> openSpecificationFileNT(game::SpecificationLoader& loader, const String_t& name)
+    {
+        try {
+            return loader.openSpecificationFile(name).asPtr();
+        }
+        catch (afl::except::FileProblemException&) {
+            return 0;
+        }
+    }
+
+    /*
+     *  Writing
+     */
+
+    /* Component name provider that reports names as stored in the component. */
+    class RawNameProvider : public ComponentNameProvider {
+     public:
+        virtual String_t getName(Type /*type*/, int /*index*/, const String_t& name) const
+            { return name; }
+        virtual String_t getShortName(Type /*type*/, int /*index*/, const String_t& /*name*/, const String_t& shortName) const
+            { return shortName; }
+    };
+
+    void storeInt(GrowableBytes_t& out, int32_t value)
+    {
+        Int32_t v;
+        v = value;
+        out.append(afl::base::fromObject(v));
+    }
+
+    void storeString(GrowableBytes_t& out, const String_t& str)
+    {
+        storeInt(out, int32_t(str.size()));
+        out.append(afl::string::toBytes(str));
+    }
+
+    void storeCost(GrowableBytes_t& out, const Cost& cost)
+    {
+        for (size_t i = 0; i < countof(COST_TYPES); ++i) {
+            storeInt(out, cost.get(COST_TYPES[i]));
+        }
+    }
+
+    void storeComponent(GrowableBytes_t& out, const game::spec::Component& c)
+    {
+        RawNameProvider raw;
+        storeInt(out, c.getId());
+        storeString(out, c.getName(raw));
+        storeString(out, c.getShortName(raw));
+        storeInt(out, c.getMass());
+        storeInt(out, c.getTechLevel());
+        storeCost(out, c.cost());
+    }
+
+    template<typename T>
+    int32_t countComponents(const game::spec::ComponentVector<T>& vec)
+    {
+        int32_t n = 0;
+        for (int i = 1, size = vec.size(); i <= size; ++i) {
+            if (vec.get(i) != 0) {
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    void storeAssignments(GrowableBytes_t& out, const HullFunctionAssignmentList& list)
+    {
+        storeInt(out, int32_t(list.getNumEntries()));
+        for (size_t i = 0, n = list.getNumEntries(); i < n; ++i) {
+            const HullFunctionAssignmentList::Entry* e = list.getEntryByIndex(i);
+            storeInt(out, e->m_function);
+            storeInt(out, int32_t(e->m_addedPlayers.toInteger()));
+            storeInt(out, int32_t(e->m_removedPlayers.toInteger()));
+        }
+    }
+
+    void storeConfiguration(GrowableBytes_t& out, const HostConfiguration& config)
+    {
+        std::vector<HostConfiguration::OptionInfo_t> options;
+        HostConfiguration::OptionInfo_t info;
+        afl::base::Ref<HostConfiguration::Enumerator_t> e = config.getOptions();
+        while (e->getNextElement(info)) {
+            // Options at their default value need not be stored
+            if (info.second->getSource() != ConfigurationOption::Default) {
+                options.push_back(info);
+            }
+        }
+
+        storeInt(out, int32_t(options.size()));
+        for (size_t i = 0; i < options.size(); ++i) {
+            storeString(out, options[i].first);
+            storeString(out, options[i].second->toString());
+            storeInt(out, options[i].second->getSource());
+        }
+    }
+
+    void storeShipList(GrowableBytes_t& out, const ShipList& sl)
+    {
+        // Beams
+        storeInt(out, countComponents(sl.beams()));
+        for (const game::spec::Beam* p = sl.beams().findNext(0); p != 0; p = sl.beams().findNext(p->getId())) {
+            storeComponent(out, *p);
+            storeInt(out, p->getKillPower());
+            storeInt(out, p->getDamagePower());
+        }
+
+        // Torpedo launchers
+        storeInt(out, countComponents(sl.launchers()));
+        for (const game::spec::TorpedoLauncher* p = sl.launchers().findNext(0); p != 0; p = sl.launchers().findNext(p->getId())) {
+            storeComponent(out, *p);
+            storeInt(out, p->getKillPower());
+            storeInt(out, p->getDamagePower());
+            storeCost(out, p->torpedoCost());
+        }
+
+        // Engines
+        storeInt(out, countComponents(sl.engines()));
+        for (const game::spec::Engine* p = sl.engines().findNext(0); p != 0; p = sl.engines().findNext(p->getId())) {
+            storeComponent(out, *p);
+            for (int warp = 1; warp <= game::spec::Engine::MAX_WARP; ++warp) {
+                int32_t ff = 0;
+                p->getFuelFactor(warp, ff);
+                storeInt(out, ff);
+            }
+            storeInt(out, p->getMaxEfficientWarp());
+        }
+
+        // Hulls
+        storeInt(out, countComponents(sl.hulls()));
+        for (const game::spec::Hull* p = sl.hulls().findNext(0); p != 0; p = sl.hulls().findNext(p->getId())) {
+            storeComponent(out, *p);
+            storeInt(out, p->getExternalPictureNumber());
+            storeInt(out, p->getInternalPictureNumber());
+            storeInt(out, p->getMaxFuel());
+            storeInt(out, p->getMaxCrew());
+            storeInt(out, p->getNumEngines());
+            storeInt(out, p->getMaxCargo());
+            storeInt(out, p->getNumBays());
+            storeInt(out, p->getMaxLaunchers());
+            storeInt(out, p->getMaxBeams());
+            storeAssignments(out, p->getHullFunctions(true));
+            storeAssignments(out, p->getHullFunctions(false));
+        }
+
+        // Hull assignments
+        for (int player = 1; player <= game::MAX_PLAYERS; ++player) {
+            const int n = sl.hullAssignments().getStoredMaxIndex(player);
+            storeInt(out, n);
+            for (int i = 1; i <= n; ++i) {
+                storeInt(out, sl.hullAssignments().getStoredHull(player, i));
+            }
+        }
+
+        // Basic hull functions
+        const game::spec::BasicHullFunctionList& basic = sl.basicHullFunctions();
+        storeInt(out, int32_t(basic.getNumFunctions()));
+        for (size_t i = 0, n = basic.getNumFunctions(); i < n; ++i) {
+            const game::spec::BasicHullFunction* f = basic.getFunctionByIndex(i);
+            storeInt(out, f->getId());
+            storeString(out, f->getName());
+            storeString(out, f->getDescription());
+            storeString(out, f->getExplanation());
+            storeString(out, f->getPictureName());
+            storeInt(out, f->getImpliedFunctionId());
+        }
+
+        // Modified hull functions
+        const game::spec::ModifiedHullFunctionList& modified = sl.modifiedHullFunctions();
+        storeInt(out, int32_t(modified.getNumFunctions()));
+        for (size_t i = 0, n = modified.getNumFunctions(); i < n; ++i) {
+            const game::spec::HullFunction* f = modified.getFunctionByIndex(i);
+            storeInt(out, f->getBasicFunctionId());
+            storeInt(out, int32_t(f->getLevels().toInteger()));
+            storeInt(out, int32_t(f->getPlayers().toInteger()));
+            storeInt(out, f->getKind());
+            storeInt(out, f->getHostId());
+        }
+
+        // Racial abilities
+        storeAssignments(out, sl.racialAbilities());
+
+        // Component names
+        for (size_t i = 0; i < countof(NAME_TYPES); ++i) {
+            const game::spec::StandardComponentNameProvider::Translations_t& tx = sl.componentNamer().getTranslations(NAME_TYPES[i]);
+            storeInt(out, int32_t(tx.size()));
+            for (game::spec::StandardComponentNameProvider::Translations_t::const_iterator it = tx.begin(); it != tx.end(); ++it) {
+                storeString(out, it->first);
+                storeString(out, it->second);
+            }
+        }
+
+        // Friendly codes
+        storeInt(out, int32_t(sl.friendlyCodes().size()));
+        for (game::spec::FriendlyCodeList::Iterator_t it = sl.friendlyCodes().begin(); it != sl.friendlyCodes().end(); ++it) {
+            storeString(out, (*it)->getCode());
+            storeString(out, (*it)->getRawDescription());
+            storeInt(out, int32_t((*it)->getRaces().toInteger()));
+            storeInt(out, int32_t((*it)->getFlags().toInteger()));
+        }
+
+        // Missions
+        storeInt(out, int32_t(sl.missions().size()));
+        for (game::spec::MissionList::Iterator_t it = sl.missions().begin(); it != sl.missions().end(); ++it) {
+            storeInt(out, it->getNumber());
+            storeInt(out, int32_t(it->getRaceMask().toInteger()));
+            storeInt(out, int32_t(it->getFlags().toInteger()));
+            storeString(out, it->getName());
+            storeString(out, it->getShortName());
+            storeInt(out, it->getHotkey());
+            for (int p = game::InterceptParameter; p <= game::TowParameter; ++p) {
+                const game::MissionParameter mp = game::MissionParameter(p);
+                storeInt(out, it->getParameterType(mp));
+                storeInt(out, int32_t(it->getParameterFlags(mp).toInteger()));
+                storeString(out, it->getParameterName(mp));
+            }
+            storeString(out, it->getConditionExpression());
+            storeString(out, it->getWarningExpression());
+            storeString(out, it->getLabelExpression());
+            storeString(out, it->getSetCommand());
+        }
+    }
+
+    /*
+     *  Reading
+     */
+
+    class Reader {
+     public:
+        Reader(ConstBytes_t in, afl::string::Translator& tx)
+            : m_in(in), m_translator(tx)
+            { }
+
+        int32_t getInt()
+            {
+                Int32_t v;
+                ConstBytes_t bytes = m_in.split(sizeof(v));
+                if (bytes.size() != sizeof(v)) {
+                    fail();
+                }
+                afl::base::fromObject(v).copyFrom(bytes);
+                return v;
+            }
+
+        size_t getCount()
+            {
+                // Every element needs at least one byte, so larger counts are invalid
+                int32_t n = getInt();
+                if (n < 0 || size_t(n) > m_in.size()) {
+                    fail();
+                }
+                return size_t(n);
+            }
+
+        String_t getString()
+            {
+                return afl::string::fromBytes(m_in.split(getCount()));
+            }
+
+        void getCost(Cost& cost)
+            {
+                for (size_t i = 0; i < countof(COST_TYPES); ++i) {
+                    cost.set(COST_TYPES[i], getInt());
+                }
+            }
+
+        bool isAtEnd() const
+            { return m_in.empty(); }
+
+        void fail()
+            { throw afl::except::FileFormatException(IMAGE_NAME, m_translator("File is invalid")); }
+
+     private:
+        ConstBytes_t m_in;
+        afl::string::Translator& m_translator;
+    };
+
+    template<typename T>
+    T& loadComponent(Reader& in, game::spec::ComponentVector<T>& vec)
+    {
+        T* p = vec.create(in.getInt());
+        if (p == 0) {
+            in.fail();
+        }
+        p->setName(in.getString());
+        p->setShortName(in.getString());
+        p->setMass(in.getInt());
+        p->setTechLevel(in.getInt());
+        in.getCost(p->cost());
+        return *p;
+    }
+
+    void loadAssignments(Reader& in, HullFunctionAssignmentList& list)
+    {
+        std::vector<HullFunctionAssignmentList::Entry> entries;
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            const game::spec::ModifiedHullFunctionList::Function_t fn = in.getInt();
+            const game::PlayerSet_t added = game::PlayerSet_t::fromInteger(in.getInt());
+            const game::PlayerSet_t removed = game::PlayerSet_t::fromInteger(in.getInt());
+            entries.push_back(HullFunctionAssignmentList::Entry(fn, added, removed));
+        }
+
+        // clear() creates entries for functions with a configurable default; drop those that were removed.
+        list.clear();
+        for (size_t i = list.getNumEntries(); i > 0; --i) {
+            const HullFunctionAssignmentList::Entry* e = list.getEntryByIndex(i-1);
+            bool found = false;
+            for (size_t j = 0; j < entries.size() && !found; ++j) {
+                found = (entries[j].m_function == e->m_function);
+            }
+            if (!found) {
+                list.removeEntry(e->m_function);
+            }
+        }
+
+        // change() is defined as "add, then remove"; this reproduces the stored sets exactly.
+        for (size_t i = 0; i < entries.size(); ++i) {
+            list.change(entries[i].m_function, entries[i].m_addedPlayers + entries[i].m_removedPlayers, game::PlayerSet_t());
+            list.change(entries[i].m_function, game::PlayerSet_t(), entries[i].m_removedPlayers);
+        }
+    }
+
+    void loadConfiguration(Reader& in, HostConfiguration& config)
+    {
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            const String_t name = in.getString();
+            const String_t value = in.getString();
+            const int32_t source = in.getInt();
+            if (source < ConfigurationOption::Default || source > ConfigurationOption::Game) {
+                in.fail();
+            }
+            config.setOption(name, value, ConfigurationOption::Source(source));
+        }
+    }
+
+    void loadShipList(Reader& in, ShipList& sl)
+    {
+        // Beams
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            game::spec::Beam& b = loadComponent(in, sl.beams());
+            b.setKillPower(in.getInt());
+            b.setDamagePower(in.getInt());
+        }
+
+        // Torpedo launchers
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            game::spec::TorpedoLauncher& t = loadComponent(in, sl.launchers());
+            t.setKillPower(in.getInt());
+            t.setDamagePower(in.getInt());
+            in.getCost(t.torpedoCost());
+        }
+
+        // Engines
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            game::spec::Engine& e = loadComponent(in, sl.engines());
+            for (int warp = 1; warp <= game::spec::Engine::MAX_WARP; ++warp) {
+                e.setFuelFactor(warp, in.getInt());
+            }
+            e.setMaxEfficientWarp(in.getInt());
+        }
+
+        // Hulls
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            game::spec::Hull& h = loadComponent(in, sl.hulls());
+            h.setExternalPictureNumber(in.getInt());
+            h.setInternalPictureNumber(in.getInt());
+            h.setMaxFuel(in.getInt());
+            h.setMaxCrew(in.getInt());
+            h.setNumEngines(in.getInt());
+            h.setMaxCargo(in.getInt());
+            h.setNumBays(in.getInt());
+            h.setMaxLaunchers(in.getInt());
+            h.setMaxBeams(in.getInt());
+            loadAssignments(in, h.getHullFunctions(true));
+            loadAssignments(in, h.getHullFunctions(false));
+        }
+
+        // Hull assignments
+        for (int player = 1; player <= game::MAX_PLAYERS; ++player) {
+            for (int i = 1, n = int(in.getCount()); i <= n; ++i) {
+                sl.hullAssignments().add(player, i, in.getInt());
+            }
+        }
+
+        // Basic hull functions
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            const int id = in.getInt();
+            game::spec::BasicHullFunction* f = sl.basicHullFunctions().addFunction(id, in.getString());
+            f->setDescription(in.getString());
+            f->setExplanation(in.getString());
+            f->setPictureName(in.getString());
+            f->setImpliedFunctionId(in.getInt());
+        }
+
+        // Modified hull functions
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            game::spec::HullFunction f(in.getInt());
+            f.setLevels(game::ExperienceLevelSet_t::fromInteger(in.getInt()));
+            f.setPlayers(game::PlayerSet_t::fromInteger(in.getInt()));
+            f.setKind(game::spec::HullFunction::Kind(in.getInt()));
+            f.setHostId(in.getInt());
+            sl.modifiedHullFunctions().getFunctionIdFromDefinition(f);
+        }
+
+        // Racial abilities
+        loadAssignments(in, sl.racialAbilities());
+
+        // Component names
+        for (size_t i = 0; i < countof(NAME_TYPES); ++i) {
+            for (size_t j = 0, n = in.getCount(); j < n; ++j) {
+                const String_t name = in.getString();
+                const String_t value = in.getString();
+                sl.componentNamer().addTranslation(NAME_TYPES[i], name, value);
+            }
+        }
+
+        // Friendly codes
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            const String_t code = in.getString();
+            const String_t description = in.getString();
+            const game::PlayerSet_t races = game::PlayerSet_t::fromInteger(in.getInt());
+            const game::spec::FriendlyCode::FlagSet_t flags = game::spec::FriendlyCode::FlagSet_t::fromInteger(in.getInt());
+            sl.friendlyCodes().addCode(game::spec::FriendlyCode(code, description, races, flags));
+        }
+
+        // Missions
+        for (size_t i = 0, n = in.getCount(); i < n; ++i) {
+            game::spec::Mission m(in.getInt(), String_t());
+            m.setRaceMask(game::PlayerSet_t::fromInteger(in.getInt()));
+            m.setFlags(game::spec::Mission::FlagSet_t::fromInteger(in.getInt()));
+            m.setName(in.getString());
+            m.setShortName(in.getString());
+            m.setHotkey(char(in.getInt()));
+            for (int p = game::InterceptParameter; p <= game::TowParameter; ++p) {
+                const game::MissionParameter mp = game::MissionParameter(p);
+                m.setParameterType(mp, game::spec::Mission::ParameterType(in.getInt()));
+                m.setParameterFlags(mp, game::spec::Mission::ParameterFlagSet_t::fromInteger(in.getInt()));
+                m.setParameterName(mp, in.getString());
+            }
+            m.setConditionExpression(in.getString());
+            m.setWarningExpression(in.getString());
+            m.setLabelExpression(in.getString());
+            m.setSetCommand(in.getString());
+            sl.missions().addMission(m);
+        }
+    }
+
+    String_t getFileName(const String_t& key)
+    {
+        return key + ".spec";
+    }
+}
+
+// Constructor.
+server::play::SpecificationCache::SpecificationCache(afl::base::Ref<afl::io::Directory> dir, afl::sys::LogListener& log, afl::string::Translator& tx)
+    : m_directory(dir),
+      m_log(log),
+      m_translator(tx)
+{ }
+
+// Destructor.
+server::play::SpecificationCache::~SpecificationCache()
+{ }
+
+// Compute key for a game.
+String_t
+server::play::SpecificationCache::computeKey(game::Root& root, afl::string::Translator& tx)
+{
+    afl::checksums::SHA1 hash;
+    addString(hash, Format("version:%d\n", FORMAT_VERSION));
+
+    // Host version: affects interpretation of hull functions
+    addString(hash, Format("host:%d:%d\n", int(root.hostVersion().getKind()), root.hostVersion().getVersion()));
+
+    // Character set: identify it by its mapping of the upper half
+    uint8_t upperHalf[128];
+    for (size_t i = 0; i < countof(upperHalf); ++i) {
+        upperHalf[i] = uint8_t(128 + i);
+    }
+    addString(hash, "charset:");
+    addString(hash, root.charset().decode(afl::base::ConstBytes_t(upperHalf)));
+    addString(hash, "\n");
+
+    // Language: selects component name files
+    const String_t languageCode = tx("{languageCode}");
+    addString(hash, Format("language:%s\n", languageCode));
+
+    // Specification files
+    game::SpecificationLoader& loader = root.specificationLoader();
+    for (size_t i = 0; i < countof(SPECIFICATION_FILES); ++i) {
+        addFile(hash, SPECIFICATION_FILES[i], openSpecificationFileNT(loader, SPECIFICATION_FILES[i]).get());
+    }
+    if (!languageCode.empty() && languageCode[0] != '{') {
+        const String_t names[] = { Format("names_%s.usr", languageCode), Format("names_%s.cc", languageCode) };
+        for (size_t i = 0; i < countof(names); ++i) {
+            addFile(hash, names[i], openSpecificationFileNT(loader, names[i]).get());
+        }
+    }
+
+    // Configuration files
+    for (size_t i = 0; i < countof(CONFIGURATION_FILES); ++i) {
+        addFile(hash, String_t("config/") + CONFIGURATION_FILES[i], root.gameDirectory().openFileNT(CONFIGURATION_FILES[i], FileSystem::OpenRead).get());
+    }
+
+    return hash.getHashAsHexString();
+}
+
+// Load ship list and configuration from cache.
+bool
+server::play::SpecificationCache::load(const String_t& key, game::spec::ShipList& shipList, game::config::HostConfiguration& config)
+{
+    Ptr<afl::io::Stream> file = m_directory->openFileNT(getFileName(key), FileSystem::OpenRead);
+    if (file.get() == 0) {
+        return false;
+    }
+
+    try {
+        afl::base::Ref<afl::io::FileMapping> image = file->createVirtualMapping();
+        loadImage(image->get(), shipList, config, m_translator);
+        m_log.write(LogListener::Debug, LOG_NAME, Format("Using precompiled specification %s", key));
+        return true;
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Warn, LOG_NAME, Format(m_translator("Ignoring damaged precompiled specification %s"), key), e);
+        return false;
+    }
+}
+
+// Save ship list and configuration to cache.
+void
+server::play::SpecificationCache::save(const String_t& key, const game::spec::ShipList& shipList, const game::config::HostConfiguration& config)
+{
+    // Write under a temporary name and rename it into place,
+    // so that other processes never see a partial image.
+    const String_t fileName = getFileName(key);
+    const String_t tempName = Format("%s.%d.tmp", fileName, afl::sys::Time::getTickCounter());
+    try {
+        GrowableBytes_t image;
+        storeImage(image, shipList, config);
+        m_directory->openFile(tempName, FileSystem::Create)->fullWrite(image);
+        m_directory->getDirectoryEntryByName(tempName)->renameTo(fileName);
+        m_log.write(LogListener::Debug, LOG_NAME, Format("Saved precompiled specification %s", key));
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Warn, LOG_NAME, Format(m_translator("Unable to save precompiled specification %s"), key), e);
+        m_directory->eraseNT(tempName);
+    }
+}
+
+// Create image.
+void
+server::play::SpecificationCache::storeImage(afl::base::GrowableBytes_t& out, const game::spec::ShipList& shipList, const game::config::HostConfiguration& config)
+{
+    out.append(ConstBytes_t(MAGIC));
+    storeInt(out, FORMAT_VERSION);
+    storeConfiguration(out, config);
+    storeShipList(out, shipList);
+}
+
+// Load image.
+void
+server::play::SpecificationCache::loadImage(afl::base::ConstBytes_t in, game::spec::ShipList& shipList, game::config::HostConfiguration& config, afl::string::Translator& tx)
+{
+    if (!in.split(sizeof(MAGIC)).equalContent(ConstBytes_t(MAGIC))) {
+        throw afl::except::FileFormatException(IMAGE_NAME, tx("File is missing required signature"));
+    }
+
+    Reader rdr(in, tx);
+    if (rdr.getInt() != FORMAT_VERSION) {
+        throw afl::except::FileFormatException(IMAGE_NAME, tx("Unsupported file format"));
+    }
+    loadConfiguration(rdr, config);
+    loadShipList(rdr, shipList);
+    if (!rdr.isAtEnd()) {
+        rdr.fail();
+    }
+    shipList.sig_change.raise();
+}
@@ -0,0 +1,90 @@
+/**
+  *  \file server/play/specificationcache.hpp
+  *  \brief Class server::play::SpecificationCache
+  */
+#ifndef C2NG_SERVER_PLAY_SPECIFICATIONCACHE_HPP
+#define C2NG_SERVER_PLAY_SPECIFICATIONCACHE_HPP
+
+#include "afl/base/growablememory.hpp"
+#include "afl/base/memory.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/io/directory.hpp"
+#include "afl/string/string.hpp"
+#include "afl/string/translator.hpp"
+#include "afl/sys/loglistener.hpp"
+#include "game/config/hostconfiguration.hpp"
+#include "game/root.hpp"
+#include "game/spec/shiplist.hpp"
+
+namespace server { namespace play {
+
+    /** Cache for precompiled specifications.
+        Most games share one of a few ship lists.
+        This stores a loaded ShipList and HostConfiguration in a binary image that can be loaded
+        (from a memory mapping) without parsing the specification files again.
+
+        Images are stored in a directory shared by all c2play-server processes, one file per key.
+        The key is a hash over everything that affects the loaded ship list:
+        the content of the specification and configuration files, host version, character set, and language.
+        An image is produced the first time a ship list is loaded, and used by all further sessions with the same key.
+
+        Default hull function assignments (BasicHullFunctionList::addDefaultAssignment()) are not stored;
+        they are only used while loading and are already applied to the hulls.
+
+        The cache is an optimisation only.
+        Errors are logged and otherwise ignored; a damaged image is treated as missing. */
+    class SpecificationCache : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param dir Cache directory
+            \param log Logger
+            \param tx  Translator */
+        SpecificationCache(afl::base::Ref<afl::io::Directory> dir, afl::sys::LogListener& log, afl::string::Translator& tx);
+
+        /** Destructor. */
+        ~SpecificationCache();
+
+        /** Compute key for a game.
+            Reads the specification files (using root.specificationLoader()) and configuration files (from root.gameDirectory()).
+            \param root Root
+            \param tx   Translator (determines the language of component names)
+            \return key */
+        static String_t computeKey(game::Root& root, afl::string::Translator& tx);
+
+        /** Load ship list and configuration from cache.
+            \param [in]  key      Key, see computeKey()
+            \param [out] shipList Ship list
+            \param [out] config   Host configuration
+            \return true on success; false if there is no usable image. In this case, shipList and config may have been partially modified. */
+        bool load(const String_t& key, game::spec::ShipList& shipList, game::config::HostConfiguration& config);
+
+        /** Save ship list and configuration to cache.
+            \param key      Key, see computeKey()
+            \param shipList Ship list
+            \param config   Host configuration */
+        void save(const String_t& key, const game::spec::ShipList& shipList, const game::config::HostConfiguration& config);
+
+        /** Create image.
+            \param [out] out      Image is appended here
+            \param [in]  shipList Ship list
+            \param [in]  config   Host configuration */
+        static void storeImage(afl::base::GrowableBytes_t& out, const game::spec::ShipList& shipList, const game::config::HostConfiguration& config);
+
+        /** Load image.
+            \param [in]  in       Image
+            \param [out] shipList Ship list; should be empty
+            \param [out] config   Host configuration
+            \param [in]  tx       Translator (for error messages)
+            \throw afl::except::FileProblemException image is damaged or has an unsupported format */
+        static void loadImage(afl::base::ConstBytes_t in, game::spec::ShipList& shipList, game::config::HostConfiguration& config, afl::string::Translator& tx);
+
+     private:
+        afl::base::Ref<afl::io::Directory> m_directory;
+        afl::sys::LogListener& m_log;
+        afl::string::Translator& m_translator;
+    };
+
+} }
+
+#endif
@@ -29,6 +29,12 @@ namespace server { namespace router {
 
         /** true if new sessions displace old ones (Router.NewSessionsWin). */
         bool newSessionsWin;               // ex arg_newsessionswin
+
+        /** Number of standby processes in the warm pool; 0 to disable (Router.PoolSize). */
+        size_t poolSize;
+
+        /** Directory for precompiled ship lists shared by all sessions; empty to disable (Router.CacheDir). */
+        String_t cacheDir;
     };
 
 } }
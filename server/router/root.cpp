@@ -11,6 +11,16 @@
 
 namespace {
     const char*const LOG_NAME = "router";
+
+    /* Arguments given to every c2play-server process, whether standby or not. */
+    afl::data::StringList_t getServerArguments(const server::router::Configuration& config)
+    {
+        afl::data::StringList_t result;
+        if (!config.cacheDir.empty()) {
+            result.push_back("--cache=" + config.cacheDir);
+        }
+        return result;
+    }
 }
 
 server::router::Root::Root(util::process::Factory& factory,
@@ -22,11 +32,16 @@ server::router::Root::Root(util::process::Factory& factory,
       m_generator(gen),
       m_pFileBase(pFileBase),
       m_config(config),
-      m_sessions()
+      m_sessions(),
+      m_pool(),
+      m_numPoolHits(0),
+      m_numPoolMisses(0)
 { }
 
 server::router::Root::~Root()
-{ }
+{
+    stopPool();
+}
 
 afl::sys::Log&
 server::router::Root::log()
@@ -68,7 +83,7 @@ server::router::Root::createSession(afl::base::Memory<const String_t> args)
     }
 
     // Start the session
-    if (!p->start(m_config.serverPath)) {
+    if (!startSession(*p)) {
         throw std::runtime_error(CANNOT_START_SESSION);
     }
     return *m_sessions.pushBackNew(p.release());
@@ -79,7 +94,7 @@ server::router::Root::restartSession(Session& s)
 {
     // ex RouterSession::restart
     s.stop();
-    if (!s.start(m_config.serverPath)) {
+    if (!s.start(m_config.serverPath, getServerArguments(m_config))) {
         throw std::runtime_error(CANNOT_START_SESSION);
     }
 }
@@ -157,4 +172,70 @@ server::router::Root::stopAllSessions()
         }
     }
     m_sessions.clear();
+    stopPool();
+}
+
+void
+server::router::Root::fillPool()
+{
+    afl::data::StringList_t args = getServerArguments(m_config);
+    args.push_back("--standby");
+    while (m_pool.size() < m_config.poolSize) {
+        std::auto_ptr<util::process::Subprocess> p(m_factory.createNewProcess());
+        if (!p->start(m_config.serverPath, args)) {
+            m_log.write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("failed to start standby process: %s", p->getStatus()));
+            break;
+        }
+        m_pool.pushBackNew(p.release());
+    }
+}
+
+size_t
+server::router::Root::getNumStandbyProcesses() const
+{
+    return m_pool.size();
+}
+
+size_t
+server::router::Root::getNumPoolHits() const
+{
+    return m_numPoolHits;
+}
+
+size_t
+server::router::Root::getNumPoolMisses() const
+{
+    return m_numPoolMisses;
+}
+
+bool
+server::router::Root::startSession(Session& s)
+{
+    if (m_config.poolSize > 0) {
+        // Oldest standby process first; it is most likely to have completed its startup
+        bool ok = false;
+        if (!m_pool.empty()) {
+            ok = s.startFromPool(std::auto_ptr<util::process::Subprocess>(m_pool.extractFront()));
+        }
+        if (ok) {
+            ++m_numPoolHits;
+        } else {
+            ++m_numPoolMisses;
+            m_log.write(afl::sys::LogListener::Info, LOG_NAME, afl::string::Format("session %s: no standby process, starting normally", s.getId()));
+        }
+        fillPool();
+        if (ok) {
+            return true;
+        }
+    }
+    return s.start(m_config.serverPath, getServerArguments(m_config));
+}
+
+void
+server::router::Root::stopPool()
+{
+    while (!m_pool.empty()) {
+        std::auto_ptr<util::process::Subprocess> p(m_pool.extractFront());
+        p->stop();
+    }
 }
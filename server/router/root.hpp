@@ -4,12 +4,14 @@
 #ifndef C2NG_SERVER_ROUTER_ROOT_HPP
 #define C2NG_SERVER_ROUTER_ROOT_HPP
 
+#include "afl/container/ptrqueue.hpp"
 #include "afl/container/ptrvector.hpp"
 #include "afl/sys/log.hpp"
 #include "server/common/idgenerator.hpp"
 #include "server/interface/filebase.hpp"
 #include "server/router/configuration.hpp"
 #include "util/process/factory.hpp"
+#include "util/process/subprocess.hpp"
 
 namespace server { namespace router {
 
@@ -42,6 +44,24 @@ namespace server { namespace router {
 
         void stopAllSessions();
 
+        /** Fill the warm pool.
+            Starts standby processes ("--standby") until Configuration::poolSize of them exist.
+            Standby processes do not count towards Configuration::maxSessions.
+            createSession() takes processes from this pool and refills it. */
+        void fillPool();
+
+        /** Get number of standby processes in the warm pool.
+            \return number */
+        size_t getNumStandbyProcesses() const;
+
+        /** Get number of sessions started from the warm pool.
+            \return number */
+        size_t getNumPoolHits() const;
+
+        /** Get number of sessions that had to be started normally although the warm pool is enabled.
+            \return number */
+        size_t getNumPoolMisses() const;
+
      private:
         afl::sys::Log m_log;
 
@@ -54,6 +74,13 @@ namespace server { namespace router {
         Configuration m_config;
 
         Sessions_t m_sessions;
+
+        afl::container::PtrQueue<util::process::Subprocess> m_pool;
+        size_t m_numPoolHits;
+        size_t m_numPoolMisses;
+
+        bool startSession(Session& s);
+        void stopPool();
     };
 
 } }
@@ -100,6 +100,7 @@ server::router::ServerApplication::serverMain()
     // Set up root (global data)
     Root root(m_factory, *m_generator, m_config, pFileBase);
     root.log().addListener(log());
+    root.fillPool();
 
     // Protocol Handler
     SessionRouter impl(root);
@@ -187,6 +188,32 @@ server::router::ServerApplication::handleConfiguration(const String_t& key, cons
             throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
         }
         return true;
+    } else if (key == "ROUTER.POOLSIZE") {
+        /* @q Router.PoolSize:Int (Config)
+           Number of %c2server (c2play-server) processes to keep in standby.
+           A standby process has already completed the part of its startup that does not depend on the game;
+           a new session uses one of them instead of starting a new process, which reduces session startup latency.
+           Standby processes do not count towards {Router.MaxSessions (Config)|Router.MaxSessions}.
+           The {LIST (Router Command)|LIST} command reports how many sessions could use the pool.
+           Default is 0 (no standby processes).
+           @since PCC2 2.41 */
+        size_t n;
+        if (afl::string::strToInteger(value, n) && n <= 100) {
+            m_config.poolSize = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
+    } else if (key == "ROUTER.CACHEDIR") {
+        /* @q Router.CacheDir:Str (Config)
+           Directory for precompiled ship lists.
+           If set, all %c2server (c2play-server) processes store the ship lists they load here,
+           and sessions for games with the same specification files load them from here instead of parsing the files again.
+           The directory must exist and be writable; it can be cleared at any time.
+           Default is empty (no cache).
+           @since PCC2 2.41 */
+        m_config.cacheDir = value;
+        return true;
     } else if (key == "ROUTER.FILENOTIFY") {
         /* @q Router.FileNotify:Str (Config)
            If "y" or "1", the {SAVE (Router Command)|SAVE} command will notify the {File (Service)|file server}. */
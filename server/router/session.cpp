@@ -172,28 +172,56 @@ server::router::Session::checkConflict(const String_t& query, bool queryIsWild)
 
 // Start this session.
 bool
-server::router::Session::start(const String_t& serverPath)
+server::router::Session::start(const String_t& serverPath, afl::base::Memory<const String_t> serverArgs)
 {
     logCommandLine();
-    bool ok = m_process->start(serverPath, m_args);
+    afl::data::StringList_t args;
+    while (const String_t* p = serverArgs.eat()) {
+        args.push_back(*p);
+    }
+    args.insert(args.end(), m_args.begin(), m_args.end());
+    bool ok = m_process->start(serverPath, args);
     if (ok) {
-        // Wait for child to start up. It will write a "hello" message with a "100" code, or some error messages.
-        String_t greeting;
-        if (readLine(greeting) && greeting.compare(0, 3, "100", 3) == 0) {
-            // Looks like a success message
-            logProcess(afl::sys::LogListener::Info, "started");
-        } else {
-            // Looks like a failure message
-            logProcess(afl::sys::LogListener::Warn, "failed to start");
-            do {
-                util::removeTrailingCharacter(greeting, '\n');
-                m_log.write(afl::sys::LogListener::Trace, LOG_NAME, greeting);
-            } while (readLine(greeting));
-            stop();
+        ok = waitForGreeting();
+    } else {
+        m_log.write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("[%s] failed to start: %s", m_id, m_process->getStatus()));
+    }
+    return ok;
+}
+
+// Start this session using a standby process.
+bool
+server::router::Session::startFromPool(std::auto_ptr<util::process::Subprocess> process)
+{
+    // Build the parameter block: one parameter per line, terminated by "." (see server::play::ConsoleApplication).
+    String_t command;
+    bool ok = true;
+    for (size_t i = 0, n = m_args.size(); i < n; ++i) {
+        if (m_args[i].find('\n') != String_t::npos || m_args[i] == ".") {
             ok = false;
         }
+        command += m_args[i];
+        command += '\n';
+    }
+    command += ".\n";
+
+    // Take over the process.
+    // It confirms readiness with a "100" message once it has completed its startup.
+    String_t greeting;
+    if (ok) {
+        logCommandLine();
+        m_process = process;
+        ok = readLine(greeting)
+            && greeting.compare(0, 3, "100", 3) == 0
+            && m_process->writeLine(command);
+        if (ok) {
+            ok = waitForGreeting();
+        } else {
+            logProcess(afl::sys::LogListener::Warn, "standby process not usable");
+            m_process->stop();
+        }
     } else {
-        m_log.write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("[%s] failed to start: %s", m_id, m_process->getStatus()));
+        process->stop();
     }
     return ok;
 }
@@ -298,6 +326,27 @@ server::router::Session::logProcess(afl::sys::LogListener::Level level, const St
     m_log.write(level, LOG_NAME, afl::string::Format("[%s:%d] %s", m_id.substr(0, 10), pid, msg));
 }
 
+bool
+server::router::Session::waitForGreeting()
+{
+    // Wait for child to start up. It will write a "hello" message with a "100" code, or some error messages.
+    String_t greeting;
+    if (readLine(greeting) && greeting.compare(0, 3, "100", 3) == 0) {
+        // Looks like a success message
+        logProcess(afl::sys::LogListener::Info, "started");
+        return true;
+    } else {
+        // Looks like a failure message
+        logProcess(afl::sys::LogListener::Warn, "failed to start");
+        do {
+            util::removeTrailingCharacter(greeting, '\n');
+            m_log.write(afl::sys::LogListener::Trace, LOG_NAME, greeting);
+        } while (readLine(greeting));
+        stop();
+        return false;
+    }
+}
+
 void
 server::router::Session::setLastAccessTime()
 {
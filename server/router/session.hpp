@@ -77,8 +77,21 @@ namespace server { namespace router {
 
         /** Start this session.
             \param serverPath Program name
+            \param serverArgs Additional arguments for the server, placed before the session's arguments
             \return true if session started successfully (process started; greeting received) */
-        bool start(const String_t& serverPath);
+        bool start(const String_t& serverPath, afl::base::Memory<const String_t> serverArgs);
+
+        /** Start this session using a standby process.
+            The process must have been started with the "--standby" option and not been used otherwise.
+            This session takes ownership of it, sends it the command line, and waits for the normal greeting.
+
+            If the command line cannot be transferred (contains line breaks or a line consisting of just a dot),
+            the process is stopped and discarded without being used.
+
+            If this function fails, the session is not active, and can still be started using start().
+            \param process Standby process
+            \return true if session started successfully (greeting received) */
+        bool startFromPool(std::auto_ptr<util::process::Subprocess> process);
 
         /** Stop this session. */
         void stop();
@@ -108,6 +121,7 @@ namespace server { namespace router {
         void logProcess(afl::sys::LogListener::Level level, const String_t& msg);
         void logProcess(afl::sys::LogListener::Level level, const String_t& msg, uint32_t pid);
 
+        bool waitForGreeting();
         void setLastAccessTime();
         bool readLine(String_t& line);
         void readResponse(String_t& header, String_t& body);
@@ -23,6 +23,11 @@ server::router::SessionRouter::getStatus()
     const Root::Sessions_t& sessions = m_root.sessions();
 
     String_t result = afl::string::Format("200 OK, %d sessions\n", sessions.size());
+    if (m_root.config().poolSize > 0) {
+        util::removeTrailingCharacter(result, '\n');
+        result += afl::string::Format(", %d standby, %d started from pool, %d started normally\n",
+                                      m_root.getNumStandbyProcesses(), m_root.getNumPoolHits(), m_root.getNumPoolMisses());
+    }
 
     afl::sys::Time now = afl::sys::Time::getCurrentTime();
     for (size_t i = 0, n = sessions.size(); i < n; ++i) {
@@ -143,11 +148,13 @@ server::router::SessionRouter::getConfiguration()
                                "Router.Timeout=%d\n"
                                "Router.VirginTimeout=%d\n"
                                "Router.MaxSessions=%d\n"
-                               "Router.NewSessionsWin=%d\n")
+                               "Router.NewSessionsWin=%d\n"
+                               "Router.PoolSize=%d\n")
         << config.normalTimeout
         << config.virginTimeout
         << config.maxSessions
-        << int(config.newSessionsWin);
+        << int(config.newSessionsWin)
+        << config.poolSize;
 }
 
 void
@@ -168,9 +168,11 @@ server::talk::CommandHandler::getHelp(String_t topic) const
             "POSTMRENDER <mid>...\n"
             "POSTMSTAT <mid>...\n"
             "POSTNEW <fid> <subj> <text> [USER|READPERM|ANSWERPERM <arg>]\n"
+            "POSTREINDEX <fid>\n"
             "POSTRENDER <mid> <renderoptions>\n"
             "POSTREPLY <mid> <subj> <text> [USER <arg>]\n"
             "POSTRM <mid>\n"
+            "POSTSEARCH <fid> <query> [<listparams>]\n"
             "POSTSTAT <mid>\n";
     } else if (topic == "THREAD") {
         return "Thread commands:\n"
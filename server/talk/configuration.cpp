@@ -9,5 +9,6 @@
 server::talk::Configuration::Configuration()
     : messageIdSuffix("@localhost"),
       baseUrl("http://localhost/"),
-      pathHost("localhost")
+      pathHost("localhost"),
+      renderCacheSize(1000)
 { }
@@ -5,6 +5,7 @@
 #ifndef C2NG_SERVER_TALK_CONFIGURATION_HPP
 #define C2NG_SERVER_TALK_CONFIGURATION_HPP
 
+#include "afl/base/types.hpp"
 #include "afl/string/string.hpp"
 
 namespace server { namespace talk {
@@ -24,6 +25,9 @@ namespace server { namespace talk {
 
         /// Path host. Hostname of this server to use in RfC "Path" and "Xref" headers.
         String_t pathHost;
+
+        /// Render cache size. Maximum number of parsed postings to keep in memory.
+        size_t renderCacheSize;
     };
 
 } }
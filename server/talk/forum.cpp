@@ -145,6 +145,20 @@ server::talk::Forum::watchers()
     return m_forum.stringSetKey("watchers");
 }
 
+// Access search postings.
+afl::net::redis::IntegerSetKey
+server::talk::Forum::searchPostings(const String_t& term)
+{
+    return m_forum.subtree("search").intSetKey(term);
+}
+
+// Access users with unread counters.
+afl::net::redis::StringSetKey
+server::talk::Forum::unreadUsers()
+{
+    return m_forum.stringSetKey("unreadusers");
+}
+
 // Set parent group.
 void
 server::talk::Forum::setParent(String_t newParent, Root& root)
@@ -128,6 +128,19 @@ namespace server { namespace talk {
             \return watchers field */
         afl::net::redis::StringSetKey watchers();
 
+        /** Access search postings.
+            This set contains the post Ids of all messages that contain the given term,
+            see addToSearchIndex().
+            \param term Search term (normalized)
+            \return search postings field */
+        afl::net::redis::IntegerSetKey searchPostings(const String_t& term);
+
+        /** Access users with unread counters.
+            This set contains the user Ids of all users that have an unread counter for this forum,
+            see getUnreadCount().
+            \return unread users field */
+        afl::net::redis::StringSetKey unreadUsers();
+
         /*
          *  Other Operations
          */
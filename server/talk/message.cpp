@@ -11,7 +11,9 @@
 #include "server/errors.hpp"
 #include "server/talk/forum.hpp"
 #include "server/talk/root.hpp"
+#include "server/talk/search.hpp"
 #include "server/talk/topic.hpp"
+#include "server/talk/unreadcounter.hpp"
 #include "server/talk/user.hpp"
 #include "util/string.hpp"
 
@@ -129,6 +131,13 @@ server::talk::Message::text()
     return m_message.stringKey("text");
 }
 
+// Access search terms.
+afl::net::redis::StringSetKey
+server::talk::Message::searchTerms()
+{
+    return m_message.stringSetKey("terms");
+}
+
 // Check existance.
 bool
 server::talk::Message::exists()
@@ -147,8 +156,10 @@ server::talk::Message::remove(Root& root)
     // Remove from sets, so it becomes invisible
     Topic t(topic(root));
     Forum f(t.forum(root));
+    removeFromSearchIndex(*this, f);
     t.messages().remove(m_messageId);
     f.messages().remove(m_messageId);
+    resetUnreadCounts(f, root);
     User(root, author().get()).postedMessages().remove(m_messageId);
 
     // Remove from NNTP side
@@ -162,6 +173,7 @@ server::talk::Message::remove(Root& root)
     // Remove post
     text().remove();
     header().remove();
+    root.renderCache().remove(m_messageId);
 }
 
 // Access message topic.
@@ -10,6 +10,7 @@
 #include "afl/net/redis/integerfield.hpp"
 #include "afl/net/redis/stringfield.hpp"
 #include "afl/net/redis/stringkey.hpp"
+#include "afl/net/redis/stringsetkey.hpp"
 #include "server/interface/talkpost.hpp"
 #include "server/talk/sorter.hpp"
 #include "afl/data/hash.hpp"
@@ -106,6 +107,12 @@ namespace server { namespace talk {
             \return text */
         afl::net::redis::StringKey text();
 
+        /** Access search terms.
+            This set contains all terms under which this message is listed in its forum's search index
+            (see addToSearchIndex()), so it can be removed from the index again.
+            \return search terms set */
+        afl::net::redis::StringSetKey searchTerms();
+
         /** Check existance.
             \return true if this message exists. */
         bool exists();
@@ -12,8 +12,13 @@
   *          - treat all lines < index as "all-1"
   *          - otherwise, look into the hash
   *          - if line is missing, treat as "all-0"
-  *
-  *  FIXME: this needs a little love; it has been taken over verbatim.
+  *          Each line is stored in one of two formats:
+  *          - plain bitmap: 1024 bytes
+  *          - run list: "R", followed by 4 bytes per run of 1-bits
+  *            (big-endian 16-bit first column, big-endian 16-bit length minus 1).
+  *            Its size is never a multiple of 4, so it cannot be confused with a bitmap.
+  *          The run list is used if it is smaller than the bitmap,
+  *          which is the case for the typical "everything read except a few" line.
   */
 
 #include "server/talk/newsrc.hpp"
@@ -30,10 +35,133 @@ namespace {
         LineBytes = LineSize / 8
     };
 
+    /** Marker for a line stored as run list. */
+    const char RUN_MARKER = 'R';
+
+    /** Size of a run in a run list. */
+    const size_t RUN_SIZE = 4;
+
     String_t itoa(int32_t n)
     {
         return afl::string::Format("%d", n);
     }
+
+    /** Check bit in a line.
+        \param bits   Line (bitmap)
+        \param column Column
+        \return bit value */
+    bool getBit(const String_t& bits, int32_t column)
+    {
+        return (uint8_t(bits[column >> 3]) & (1 << (column & 7))) != 0;
+    }
+
+    /** Set bit in a line.
+        \param bits   Line (bitmap)
+        \param column Column */
+    void setBit(String_t& bits, int32_t column)
+    {
+        bits[column >> 3] = char(uint8_t(bits[column >> 3]) | (1 << (column & 7)));
+    }
+
+    /** Count 1-bits in a byte.
+        \param v Byte
+        \return number of 1-bits */
+    int32_t countBits(uint8_t v)
+    {
+        int32_t n = 0;
+        while (v != 0) {
+            v = uint8_t(v & (v-1));
+            ++n;
+        }
+        return n;
+    }
+
+    /** Get index of lowest 1-bit in a byte.
+        \param v Byte, nonzero
+        \return bit index */
+    int32_t findBit(uint8_t v)
+    {
+        int32_t n = 0;
+        while ((v & 1) == 0) {
+            v = uint8_t(v >> 1);
+            ++n;
+        }
+        return n;
+    }
+
+    /** Encode a line for storage.
+        \param bits Line (bitmap, LineBytes bytes)
+        \return run list if that is smaller than the bitmap, otherwise the bitmap */
+    String_t encodeLine(const String_t& bits)
+    {
+        String_t runs(1, RUN_MARKER);
+        int32_t i = 0;
+        while (i < LineSize) {
+            if ((i & 7) == 0 && bits[i >> 3] == 0) {
+                // Quickly skip empty bytes
+                i += 8;
+            } else if (getBit(bits, i)) {
+                int32_t start = i;
+                while (i < LineSize && getBit(bits, i)) {
+                    ++i;
+                }
+                int32_t length = i - start - 1;
+                runs += char(start >> 8);
+                runs += char(start & 255);
+                runs += char(length >> 8);
+                runs += char(length & 255);
+                if (runs.size() >= size_t(LineBytes)) {
+                    return bits;
+                }
+            } else {
+                ++i;
+            }
+        }
+        return runs;
+    }
+
+    /** Decode a stored line.
+        \param [in]  stored Stored value, see encodeLine()
+        \param [out] bits   Line (bitmap, LineBytes bytes) */
+    void decodeLine(const String_t& stored, String_t& bits)
+    {
+        if (stored.size() % RUN_SIZE == 1 && stored[0] == RUN_MARKER) {
+            bits.assign(size_t(LineBytes), char(0));
+            for (size_t pos = 1; pos < stored.size(); pos += RUN_SIZE) {
+                int32_t start  = (uint8_t(stored[pos])   << 8) + uint8_t(stored[pos+1]);
+                int32_t length = (uint8_t(stored[pos+2]) << 8) + uint8_t(stored[pos+3]) + 1;
+                for (int32_t i = start; i < start + length && i < LineSize; ++i) {
+                    setBit(bits, i);
+                }
+            }
+        } else {
+            // Bitmap. Make value canonical.
+            bits = stored;
+            if (bits.size() > LineBytes) {
+                bits.erase(LineBytes);
+            }
+            if (bits.size() < LineBytes) {
+                bits.append(LineBytes - bits.size(), char(0));
+            }
+        }
+    }
+
+    /** Make bitmap of the messages that are in one line.
+        \param [in]  messageIds Message Ids, sorted
+        \param [in]  pos        Index of first message Id to process
+        \param [out] mask       Bitmap (LineBytes bytes)
+        \param [out] line       Line number
+        \return index of first message Id not in this line */
+    size_t makeLineMask(const afl::data::IntegerList_t& messageIds, size_t pos, String_t& mask, int32_t& line)
+    {
+        line = messageIds[pos] >> LineShift;
+        mask.assign(size_t(LineBytes), char(0));
+        while (pos < messageIds.size() && (messageIds[pos] >> LineShift) == line) {
+            setBit(mask, messageIds[pos] & LineMask);
+            ++pos;
+        }
+        return pos;
+    }
 }
 
 server::talk::Newsrc::Newsrc(afl::net::redis::Subtree root)
@@ -66,7 +194,7 @@ server::talk::Newsrc::save()
         if (cache.find_first_not_of(char(0)) == String_t::npos) {
             data().field(itoa(cacheIndex)).remove();
         } else {
-            data().stringField(itoa(cacheIndex)).set(cache);
+            data().stringField(itoa(cacheIndex)).set(encodeLine(cache));
             cacheDirty = false;
         }
     }
@@ -87,12 +215,10 @@ server::talk::Newsrc::get(int32_t messageId)
 
     // Use cache
     loadCache(line);
-    int32_t byte = column >> 3;
-    int32_t bit = (column & 7);
-    return ((uint8_t(cache[byte]) & (1 << bit)) != 0);
+    return getBit(cache, column);
 }
 
-void
+bool
 server::talk::Newsrc::set(int32_t messageId)
 {
     // ex Newsrc::set
@@ -110,11 +236,13 @@ server::talk::Newsrc::set(int32_t messageId)
         if ((uint8_t(cache[byte]) & mask) == 0) {
             cache[byte] = uint8_t(cache[byte] | mask);
             cacheDirty = true;
+            return true;
         }
     }
+    return false;
 }
 
-void
+bool
 server::talk::Newsrc::clear(int32_t messageId)
 {
     // ex Newsrc::clear
@@ -123,12 +251,18 @@ server::talk::Newsrc::clear(int32_t messageId)
     int32_t column = messageId & LineMask;
 
     // Is the line we need actually available?
-    while (line < readAllBelowLine) {
-        // No, we have to create a new all-FF line
+    if (line < readAllBelowLine) {
+        // No, we have to re-create all-FF lines down to the one we need.
+        // Lines above it are stored directly; going through the cache would have save() remove them again.
         save();
-        --readAllBelowLine;
-        cache.assign(size_t(LineSize), char(0xFF));
-        cacheIndex = readAllBelowLine;
+        const String_t fullLine(size_t(LineBytes), char(0xFF));
+        while (readAllBelowLine > line + 1) {
+            --readAllBelowLine;
+            data().stringField(itoa(readAllBelowLine)).set(encodeLine(fullLine));
+        }
+        readAllBelowLine = line;
+        cache = fullLine;
+        cacheIndex = line;
         cacheDirty = true;
         index().set(readAllBelowLine);
     }
@@ -141,7 +275,112 @@ server::talk::Newsrc::clear(int32_t messageId)
     if ((uint8_t(cache[byte]) & mask) != 0) {
         cache[byte] = uint8_t(cache[byte] & ~mask);
         cacheDirty = true;
+        return true;
+    }
+    return false;
+}
+
+int32_t
+server::talk::Newsrc::count(const afl::data::IntegerList_t& messageIds, bool value)
+{
+    int32_t result = 0;
+    String_t mask;
+    size_t pos = 0;
+    while (pos < messageIds.size()) {
+        int32_t line;
+        size_t next = makeLineMask(messageIds, pos, mask, line);
+        if (line < readAllBelowLine) {
+            // Everything read
+            if (value) {
+                result += int32_t(next - pos);
+            }
+        } else {
+            // Combine line with mask
+            loadCache(line);
+            for (size_t i = 0; i < size_t(LineBytes); ++i) {
+                uint8_t m = uint8_t(mask[i]);
+                if (m != 0) {
+                    uint8_t c = uint8_t(cache[i]);
+                    result += countBits(uint8_t(value ? (m & c) : (m & ~c)));
+                }
+            }
+        }
+        pos = next;
+    }
+    return result;
+}
+
+int32_t
+server::talk::Newsrc::findFirst(const afl::data::IntegerList_t& messageIds, bool value)
+{
+    String_t mask;
+    size_t pos = 0;
+    while (pos < messageIds.size()) {
+        int32_t line;
+        size_t next = makeLineMask(messageIds, pos, mask, line);
+        if (line < readAllBelowLine) {
+            // Everything read
+            if (value) {
+                return messageIds[pos];
+            }
+        } else {
+            // Combine line with mask
+            loadCache(line);
+            for (size_t i = 0; i < size_t(LineBytes); ++i) {
+                uint8_t m = uint8_t(mask[i]);
+                if (m != 0) {
+                    uint8_t c = uint8_t(cache[i]);
+                    uint8_t v = uint8_t(value ? (m & c) : (m & ~c));
+                    if (v != 0) {
+                        return (line << LineShift) + int32_t(8*i) + findBit(v);
+                    }
+                }
+            }
+        }
+        pos = next;
+    }
+    return 0;
+}
+
+int32_t
+server::talk::Newsrc::setAll(const afl::data::IntegerList_t& messageIds)
+{
+    int32_t result = 0;
+    String_t mask;
+    size_t pos = 0;
+    while (pos < messageIds.size()) {
+        int32_t line;
+        size_t next = makeLineMask(messageIds, pos, mask, line);
+        if (line >= readAllBelowLine) {
+            // Merge mask into line
+            loadCache(line);
+            for (size_t i = 0; i < size_t(LineBytes); ++i) {
+                uint8_t m = uint8_t(mask[i]);
+                uint8_t c = uint8_t(cache[i]);
+                uint8_t v = uint8_t(m & ~c);
+                if (v != 0) {
+                    result += countBits(v);
+                    cache[i] = char(c | m);
+                    cacheDirty = true;
+                }
+            }
+        }
+        pos = next;
     }
+    return result;
+}
+
+int32_t
+server::talk::Newsrc::clearAll(const afl::data::IntegerList_t& messageIds)
+{
+    // Clearing may need to re-create lines below readAllBelowLine; clear() deals with that.
+    int32_t result = 0;
+    for (size_t i = 0; i < messageIds.size(); ++i) {
+        if (clear(messageIds[i])) {
+            ++result;
+        }
+    }
+    return result;
 }
 
 afl::net::redis::IntegerKey
@@ -177,15 +416,7 @@ void
 server::talk::Newsrc::doLoad(int32_t index)
 {
     // ex Newsrc::doLoad
-    cache      = data().stringField(itoa(index)).get();
+    decodeLine(data().stringField(itoa(index)).get(), cache);
     cacheIndex = index;
     cacheDirty = false;
-
-    // Make cache value canonical
-    if (cache.size() > LineBytes) {
-        cache.erase(LineBytes);
-    }
-    if (cache.size() < LineBytes) {
-        cache.append(LineBytes - cache.size(), char(0));
-    }
 }
@@ -8,6 +8,7 @@
 #include "afl/net/redis/subtree.hpp"
 #include "afl/net/redis/integerkey.hpp"
 #include "afl/net/redis/hashkey.hpp"
+#include "afl/data/integerlist.hpp"
 #include "afl/string/string.hpp"
 #include "afl/base/types.hpp"
 
@@ -15,10 +16,14 @@ namespace server { namespace talk {
 
     /** Newsrc.
         Stores a set of postings the user already read.
-        Optimized for conserving space.
+        Optimized for conserving space: the set is stored as a compressed bitmap,
+        split into lines that are stored either as a plain bitmap or as a list of runs, whichever is smaller.
 
         This implements a simple cache so that not each operation on newsrc hits the database.
-        Use save() after modifications. */
+        Use save() after modifications.
+
+        Operations on a list of messages (e.g. all messages of a forum) work line-by-line,
+        by combining the line with a bitmap of the requested messages. */
     class Newsrc {
      public:
         /** Constructor.
@@ -35,12 +40,36 @@ namespace server { namespace talk {
         bool get(int32_t messageId);
 
         /** Set message state (mark read).
-            \param messageId Message Id */
-        void set(int32_t messageId);
+            \param messageId Message Id
+            \return true if the state changed */
+        bool set(int32_t messageId);
 
         /** Clear message state (mark unread).
-            \param messageId Message Id */
-        void clear(int32_t messageId);
+            \param messageId Message Id
+            \return true if the state changed */
+        bool clear(int32_t messageId);
+
+        /** Count messages in a given state.
+            \param messageIds Message Ids, sorted in ascending order, no duplicates
+            \param value      true to count read messages, false to count unread messages
+            \return number of messages in the given state */
+        int32_t count(const afl::data::IntegerList_t& messageIds, bool value);
+
+        /** Find first message in a given state.
+            \param messageIds Message Ids, sorted in ascending order, no duplicates
+            \param value      true to find a read message, false to find an unread message
+            \return Id of first message in the given state; 0 if none */
+        int32_t findFirst(const afl::data::IntegerList_t& messageIds, bool value);
+
+        /** Set state of multiple messages (mark read).
+            \param messageIds Message Ids, sorted in ascending order, no duplicates
+            \return number of messages whose state changed */
+        int32_t setAll(const afl::data::IntegerList_t& messageIds);
+
+        /** Clear state of multiple messages (mark unread).
+            \param messageIds Message Ids, sorted in ascending order, no duplicates
+            \return number of messages whose state changed */
+        int32_t clearAll(const afl::data::IntegerList_t& messageIds);
 
      private:
         afl::net::redis::IntegerKey index();
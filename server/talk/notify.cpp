@@ -73,7 +73,7 @@ server::talk::notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root
         opts.setBaseUrl(root.config().baseUrl);
         opts.setFormat("mail");
 
-        const String_t renderedText = server::talk::render::renderText(msg.text().get(), ctx, opts, root);
+        const String_t renderedText = server::talk::render::renderMessage(msg, ctx, opts, root);
 
         mq.startMessage("talk-topic-message", afl::base::Nothing);
         mq.addParameter("forum", forum.name().get());
@@ -127,7 +127,7 @@ server::talk::notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root
         opts.setBaseUrl(root.config().baseUrl);
         opts.setFormat("mail");
 
-        const String_t renderedText = server::talk::render::renderText(msg.text().get(), ctx, opts, root);
+        const String_t renderedText = server::talk::render::renderMessage(msg, ctx, opts, root);
 
         mq.startMessage("talk-forum-message", afl::base::Nothing);
         mq.addParameter("forum", forum.name().get());
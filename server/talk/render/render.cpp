@@ -107,6 +107,39 @@ namespace server { namespace talk { namespace render { namespace {
         }
     }
 
+    // Handle output formats that do not require parsing.
+    // @param [in]  text    Text (with type tag)
+    // @param [in]  opts    Rendering options
+    // @param [out] result  Result
+    // @return true if result has been produced, false if text needs to be parsed and rendered
+    bool renderWithoutParsing(const String_t& text, const Options& opts, String_t& result)
+    {
+        const String_t& format = opts.getFormat();
+        if (format == "raw") {
+            // raw format requested
+            result = text;
+            return true;
+        } else if (format == "format") {
+            // format requested
+            String_t::size_type n = text.find(':');
+            if (n == String_t::npos) {
+                n = text.size();
+            }
+            result = text.substr(0, n);
+            return true;
+        } else if (format.find(':') == format.npos
+                   && text.size() > format.size()
+                   && text.compare(0, format.size(), format) == 0
+                   && text[format.size()] == ':')
+        {
+            // requested same format as stored
+            result = text.substr(format.size()+1);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
     bool stripBreak(TextNode* n)
     {
         if (n->major == TextNode::maParagraph && n->minor == TextNode::miParBreak) {
@@ -196,24 +229,9 @@ String_t
 server::talk::render::renderText(const String_t& text, const Context& ctx, const Options& opts, Root& root)
 {
     // ex RenderState::render
-    const String_t& format = opts.getFormat();
-    if (format == "raw") {
-        // raw format requested
-        return text;
-    } else if (format == "format") {
-        // format requested
-        String_t::size_type n = text.find(':');
-        if (n == String_t::npos) {
-            n = text.size();
-        }
-        return text.substr(0, n);
-    } else if (format.find(':') == format.npos
-               && text.size() > format.size()
-               && text.compare(0, format.size(), format) == 0
-               && text[format.size()] == ':')
-    {
-        // requested same format as stored
-        return text.substr(format.size()+1);
+    String_t result;
+    if (renderWithoutParsing(text, opts, result)) {
+        return result;
     } else {
         // transformation required
         std::auto_ptr<TextNode> tree(doParse(text, root.recognizer()));
@@ -221,6 +239,26 @@ server::talk::render::renderText(const String_t& text, const Context& ctx, const
     }
 }
 
+String_t
+server::talk::render::renderMessage(Message& msg, const Context& ctx, const Options& opts, Root& root)
+{
+    const String_t text = msg.text().get();
+    String_t result;
+    if (renderWithoutParsing(text, opts, result)) {
+        return result;
+    } else {
+        // transformation required; try to avoid re-parsing
+        const int32_t messageId = msg.getId();
+        const int32_t sequenceNumber = msg.sequenceNumber().get();
+        std::auto_ptr<TextNode> tree(root.renderCache().get(messageId, sequenceNumber));
+        if (tree.get() == 0) {
+            tree.reset(doParse(text, root.recognizer()));
+            root.renderCache().put(messageId, sequenceNumber, *tree);
+        }
+        return renderText(tree, ctx, opts, root);
+    }
+}
+
 String_t
 server::talk::render::renderText(std::auto_ptr<TextNode> tree, const Context& ctx, const Options& opts, Root& root)
 {
@@ -10,6 +10,8 @@
 #include "server/talk/root.hpp"
 #include "server/talk/textnode.hpp"
 
+namespace server { namespace talk { class Message; } }
+
 namespace server { namespace talk { namespace render {
 
     class Context;
@@ -27,6 +29,17 @@ namespace server { namespace talk { namespace render {
         \return formatted text */
     String_t renderText(const String_t& text, const Context& ctx, const Options& opts, Root& root);
 
+    /** Render a message's text.
+        Same as renderText(msg.text().get(), ctx, opts, root),
+        but uses the Root's RenderCache to avoid parsing the message again.
+
+        \param msg  Message
+        \param ctx  Rendering context
+        \param opts Rendering options (includes output format)
+        \param root Service root
+        \return formatted text */
+    String_t renderMessage(Message& msg, const Context& ctx, const Options& opts, Root& root);
+
     /** Render pre-parsed text.
         \param tree Parsed text
         \param ctx  Rendering context
@@ -0,0 +1,116 @@
+/**
+  *  \file server/talk/render/rendercache.cpp
+  *  \brief Class server::talk::render::RenderCache
+  */
+
+#include "server/talk/render/rendercache.hpp"
+
+const size_t server::talk::render::RenderCache::DEFAULT_MAX_ENTRIES;
+
+// Constructor.
+server::talk::render::RenderCache::RenderCache(size_t maxEntries)
+    : m_maxEntries(maxEntries),
+      m_order(),
+      m_entries(),
+      m_numHits(0),
+      m_numMisses(0)
+{ }
+
+// Destructor.
+server::talk::render::RenderCache::~RenderCache()
+{ }
+
+// Look up a parsed text.
+server::talk::TextNode*
+server::talk::render::RenderCache::get(int32_t messageId, int32_t sequenceNumber)
+{
+    Map_t::iterator it = m_entries.find(messageId);
+    if (it != m_entries.end() && it->second->sequenceNumber == sequenceNumber) {
+        // Move to front
+        m_order.splice(m_order.begin(), m_order, it->second->position);
+        ++m_numHits;
+        return it->second->tree->clone();
+    } else {
+        ++m_numMisses;
+        return 0;
+    }
+}
+
+// Store a parsed text.
+void
+server::talk::render::RenderCache::put(int32_t messageId, int32_t sequenceNumber, const TextNode& tree)
+{
+    if (m_maxEntries != 0) {
+        Entry* e;
+        Map_t::iterator it = m_entries.find(messageId);
+        if (it != m_entries.end()) {
+            e = it->second;
+            m_order.splice(m_order.begin(), m_order, e->position);
+        } else {
+            trim(m_maxEntries - 1);
+            e = m_entries.insertNew(messageId, new Entry());
+            m_order.push_front(messageId);
+            e->position = m_order.begin();
+        }
+        e->tree.reset(tree.clone());
+        e->sequenceNumber = sequenceNumber;
+    }
+}
+
+// Remove a message.
+void
+server::talk::render::RenderCache::remove(int32_t messageId)
+{
+    Map_t::iterator it = m_entries.find(messageId);
+    if (it != m_entries.end()) {
+        removeEntry(it);
+    }
+}
+
+// Set maximum number of entries.
+void
+server::talk::render::RenderCache::setMaxEntries(size_t maxEntries)
+{
+    m_maxEntries = maxEntries;
+    trim(m_maxEntries);
+}
+
+// Get number of entries.
+size_t
+server::talk::render::RenderCache::getNumEntries() const
+{
+    return m_entries.size();
+}
+
+// Get number of get() calls that found a result.
+size_t
+server::talk::render::RenderCache::getNumHits() const
+{
+    return m_numHits;
+}
+
+// Get number of get() calls that did not find a result.
+size_t
+server::talk::render::RenderCache::getNumMisses() const
+{
+    return m_numMisses;
+}
+
+/** Remove an entry.
+    \param it Entry */
+void
+server::talk::render::RenderCache::removeEntry(Map_t::iterator it)
+{
+    m_order.erase(it->second->position);
+    m_entries.erase(it);
+}
+
+/** Drop least-recently-used entries until the cache has at most the given number of entries.
+    \param maxEntries Number of entries to keep */
+void
+server::talk::render::RenderCache::trim(size_t maxEntries)
+{
+    while (m_entries.size() > maxEntries && !m_order.empty()) {
+        removeEntry(m_entries.find(m_order.back()));
+    }
+}
@@ -0,0 +1,101 @@
+/**
+  *  \file server/talk/render/rendercache.hpp
+  *  \brief Class server::talk::render::RenderCache
+  */
+#ifndef C2NG_SERVER_TALK_RENDER_RENDERCACHE_HPP
+#define C2NG_SERVER_TALK_RENDER_RENDERCACHE_HPP
+
+#include <list>
+#include <memory>
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrmap.hpp"
+#include "server/talk/textnode.hpp"
+
+namespace server { namespace talk { namespace render {
+
+    /** Cache for parsed message text.
+        Rendering a posting consists of parsing its source text into a TextNode tree, and rendering that tree.
+        Parsing depends only on the text, but rendering depends on the viewer (Context, Options)
+        and on the current database content (user names, thread titles, game visibility).
+        This cache therefore stores the parsed trees, and rendering is done on a copy for each request.
+
+        Entries are keyed by message Id and sequence number.
+        Since editing a posting assigns a new sequence number, a stale entry is never used;
+        still, remove() should be called when a posting is edited or removed, to release memory early.
+
+        The cache is limited by number of entries; when it is full, the least-recently used entry is dropped.
+
+        This class is not thread-safe; c2talk-server processes all requests in one thread. */
+    class RenderCache : private afl::base::Uncopyable {
+     public:
+        /** Default maximum number of entries. */
+        static const size_t DEFAULT_MAX_ENTRIES = 1000;
+
+        /** Constructor.
+            \param maxEntries Maximum number of entries. 0 means the cache stores nothing. */
+        explicit RenderCache(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+        /** Destructor. */
+        ~RenderCache();
+
+        /** Look up a parsed text.
+            \param messageId       Message Id
+            \param sequenceNumber  Sequence number of message
+            \return Copy of cached tree, to be owned by caller; null if not cached */
+        TextNode* get(int32_t messageId, int32_t sequenceNumber);
+
+        /** Store a parsed text.
+            \param messageId       Message Id
+            \param sequenceNumber  Sequence number of message
+            \param tree            Parsed text (will be copied) */
+        void put(int32_t messageId, int32_t sequenceNumber, const TextNode& tree);
+
+        /** Remove a message.
+            \param messageId Message Id */
+        void remove(int32_t messageId);
+
+        /** Set maximum number of entries.
+            Drops old entries as needed.
+            \param maxEntries Maximum number of entries */
+        void setMaxEntries(size_t maxEntries);
+
+        /** Get number of entries.
+            \return number of entries */
+        size_t getNumEntries() const;
+
+        /** Get number of get() calls that found a result.
+            \return number */
+        size_t getNumHits() const;
+
+        /** Get number of get() calls that did not find a result.
+            \return number */
+        size_t getNumMisses() const;
+
+     private:
+        typedef std::list<int32_t> List_t;
+        struct Entry {
+            std::auto_ptr<TextNode> tree;
+            int32_t sequenceNumber;
+            List_t::iterator position;
+        };
+        typedef afl::container::PtrMap<int32_t, Entry> Map_t;
+
+        size_t m_maxEntries;
+
+        /** Message Ids, most-recently-used first. */
+        List_t m_order;
+
+        /** Entries by message Id. */
+        Map_t m_entries;
+
+        size_t m_numHits;
+        size_t m_numMisses;
+
+        void removeEntry(Map_t::iterator it);
+        void trim(size_t maxEntries);
+    };
+
+} } }
+
+#endif
@@ -31,6 +31,7 @@ server::talk::Root::Root(afl::net::CommandHandler& db, afl::net::CommandHandler&
       m_keywordTable(),
       m_recognizer(),
       m_linkFormatter(),
+      m_renderCache(config.renderCacheSize),
       m_db(db),
       m_mailQueue(mail),
       m_config(config)
@@ -68,6 +69,13 @@ server::talk::Root::linkFormatter()
     return m_linkFormatter;
 }
 
+// Access render cache.
+server::talk::render::RenderCache&
+server::talk::Root::renderCache()
+{
+    return m_renderCache;
+}
+
 // Access configuration.
 const server::talk::Configuration&
 server::talk::Root::config() const
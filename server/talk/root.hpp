@@ -13,6 +13,7 @@
 #include "server/talk/configuration.hpp"
 #include "server/talk/inlinerecognizer.hpp"
 #include "server/talk/linkformatter.hpp"
+#include "server/talk/render/rendercache.hpp"
 #include "server/types.hpp"
 #include "util/syntax/keywordtable.hpp"
 #include "server/common/root.hpp"
@@ -64,6 +65,10 @@ namespace server { namespace talk {
             \return link formatter */
         LinkFormatter& linkFormatter();
 
+        /** Access render cache.
+            \return render cache */
+        render::RenderCache& renderCache();
+
         /** Access configuration.
             \return configuration */
         const Configuration& config() const;
@@ -119,6 +124,7 @@ namespace server { namespace talk {
         util::syntax::KeywordTable m_keywordTable;
         InlineRecognizer m_recognizer;
         LinkFormatter m_linkFormatter;
+        render::RenderCache m_renderCache;
 
         afl::net::CommandHandler& m_db;
         server::interface::MailQueueClient m_mailQueue;
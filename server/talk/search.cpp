@@ -0,0 +1,353 @@
+/**
+  *  \file server/talk/search.cpp
+  *  \brief Full-text search for forum postings
+  */
+
+#include <algorithm>
+#include <iterator>
+#include "server/talk/search.hpp"
+#include "server/talk/forum.hpp"
+#include "server/talk/message.hpp"
+#include "server/talk/render/context.hpp"
+#include "server/talk/render/options.hpp"
+#include "server/talk/render/render.hpp"
+#include "server/talk/root.hpp"
+#include "util/doc/searchindex.hpp"
+
+using afl::data::IntegerList_t;
+using afl::data::StringList_t;
+using util::doc::SearchIndex;
+
+namespace {
+    /** Split text into normalized terms.
+        \param [in]  text Text
+        \param [out] out  Terms are appended here; overlong words are skipped */
+    void splitTerms(const String_t& text, StringList_t& out)
+    {
+        std::vector<SearchIndex::Word> words;
+        SearchIndex::splitWords(text, words);
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (words[i].length <= SearchIndex::MAX_TERM_LENGTH) {
+                out.push_back(SearchIndex::getTerm(text, words[i]));
+            }
+        }
+    }
+
+    /** Check for query whitespace.
+        \param ch Character
+        \return true if ch separates query items */
+    bool isSpace(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+    }
+
+    /** Intersect sorted lists.
+        \param [in,out] a  First list; receives the result
+        \param [in]     b  Second list */
+    void intersectList(IntegerList_t& a, const IntegerList_t& b)
+    {
+        IntegerList_t result;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        a.swap(result);
+    }
+
+    /** Subtract sorted lists.
+        \param [in,out] a  First list; receives the result
+        \param [in]     b  Second list */
+    void subtractList(IntegerList_t& a, const IntegerList_t& b)
+    {
+        IntegerList_t result;
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        a.swap(result);
+    }
+
+    /** Merge sorted lists.
+        \param [in,out] a  First list; receives the result
+        \param [in]     b  Second list */
+    void mergeList(IntegerList_t& a, const IntegerList_t& b)
+    {
+        IntegerList_t result;
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        a.swap(result);
+    }
+
+    /** Get sorted content of a set.
+        \param [in]  key Set
+        \param [out] out Content */
+    void getSortedList(afl::net::redis::IntegerSetKey key, IntegerList_t& out)
+    {
+        key.getAll(out);
+        std::sort(out.begin(), out.end());
+    }
+}
+
+// Get words of a message.
+void
+server::talk::getMessageWords(Message& msg, Root& root, afl::data::StringList_t& out)
+{
+    render::Context ctx("");
+    render::Options opts;
+    opts.setFormat("noquote:text");
+
+    splitTerms(msg.subject().get(), out);
+    splitTerms(render::renderText(msg.text().get(), ctx, opts, root), out);
+}
+
+// Add a message to the search index.
+void
+server::talk::addToSearchIndex(Message& msg, Forum& forum, Root& root)
+{
+    StringList_t terms;
+    getMessageWords(msg, root, terms);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    for (size_t i = 0; i < terms.size(); ++i) {
+        forum.searchPostings(terms[i]).add(msg.getId());
+        msg.searchTerms().add(terms[i]);
+    }
+}
+
+// Remove a message from the search index.
+void
+server::talk::removeFromSearchIndex(Message& msg, Forum& forum)
+{
+    StringList_t terms;
+    msg.searchTerms().getAll(terms);
+    for (size_t i = 0; i < terms.size(); ++i) {
+        forum.searchPostings(terms[i]).remove(msg.getId());
+    }
+    msg.searchTerms().remove();
+}
+
+int32_t
+server::talk::rebuildSearchIndex(Forum& forum, Root& root)
+{
+    IntegerList_t messageIds;
+    forum.messages().getAll(messageIds);
+    for (size_t i = 0; i < messageIds.size(); ++i) {
+        Message msg(root, messageIds[i]);
+        removeFromSearchIndex(msg, forum);
+        addToSearchIndex(msg, forum, root);
+    }
+    return int32_t(messageIds.size());
+}
+
+
+/*
+ *  SearchQuery
+ */
+
+const size_t server::talk::SearchQuery::DEFAULT_MAX_VERIFY;
+
+// Constructor.
+server::talk::SearchQuery::SearchQuery(const String_t& query, size_t maxVerify)
+    : m_clauses(),
+      m_maxVerify(maxVerify),
+      m_numVerified(0),
+      m_truncated(false)
+{
+    bool newClause = true;
+    size_t i = 0, n = query.size();
+    while (i < n) {
+        if (isSpace(query[i])) {
+            ++i;
+        } else {
+            // Exclusion
+            bool negated = false;
+            if (query[i] == '-') {
+                negated = true;
+                ++i;
+            }
+
+            if (i < n && query[i] == '"') {
+                // Phrase
+                size_t start = i+1;
+                size_t end = query.find('"', start);
+                if (end == String_t::npos) {
+                    end = n;
+                }
+                addItem(query.substr(start, end - start), negated, newClause);
+                i = (end < n ? end+1 : n);
+            } else {
+                // Word
+                size_t start = i;
+                while (i < n && !isSpace(query[i]) && query[i] != '"') {
+                    ++i;
+                }
+                String_t word = query.substr(start, i - start);
+                if (!negated && word == "OR") {
+                    newClause = true;
+                } else {
+                    addItem(word, negated, newClause);
+                }
+            }
+        }
+    }
+}
+
+// Destructor.
+server::talk::SearchQuery::~SearchQuery()
+{ }
+
+// Check for empty query.
+bool
+server::talk::SearchQuery::isEmpty() const
+{
+    return m_clauses.empty();
+}
+
+// Find messages in a forum.
+void
+server::talk::SearchQuery::findMessages(Forum& forum, Root& root, afl::data::IntegerList_t& result)
+{
+    IntegerList_t found;
+    for (size_t i = 0; i < m_clauses.size(); ++i) {
+        IntegerList_t clauseResult;
+        findClauseMessages(m_clauses[i], forum, root, clauseResult);
+        mergeList(found, clauseResult);
+    }
+    result.insert(result.end(), found.begin(), found.end());
+}
+
+// Check whether results were truncated.
+bool
+server::talk::SearchQuery::isTruncated() const
+{
+    return m_truncated;
+}
+
+// Get number of postings checked for phrases.
+size_t
+server::talk::SearchQuery::getNumVerified() const
+{
+    return m_numVerified;
+}
+
+// Check whether a word sequence matches this query.
+bool
+server::talk::SearchQuery::matchWords(const afl::data::StringList_t& words) const
+{
+    for (size_t i = 0; i < m_clauses.size(); ++i) {
+        if (matchClause(m_clauses[i], words)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Add item to query.
+    \param text      Item text (word or phrase)
+    \param negated   true if item is negated
+    \param newClause [in/out] true to start a new clause; reset when the item is added */
+void
+server::talk::SearchQuery::addItem(const String_t& text, bool negated, bool& newClause)
+{
+    Item it;
+    it.negated = negated;
+    splitTerms(text, it.words);
+    if (!it.words.empty()) {
+        if (newClause || m_clauses.empty()) {
+            m_clauses.push_back(Clause());
+            newClause = false;
+        }
+        m_clauses.back().items.push_back(it);
+    }
+}
+
+/** Find messages matching a clause.
+    Single words are resolved using the postings alone.
+    If the clause contains phrases, candidates are verified by checking their text,
+    up to the query's limit; candidates beyond the limit are dropped.
+    \param [in]  c      Clause
+    \param [in]  forum  Forum
+    \param [in]  root   Service root
+    \param [out] result Message Ids, sorted */
+void
+server::talk::SearchQuery::findClauseMessages(const Clause& c, Forum& forum, Root& root, afl::data::IntegerList_t& result)
+{
+    // Intersect postings of all required words
+    IntegerList_t candidates;
+    bool haveCandidates = false;
+    bool needVerify = false;
+    for (size_t i = 0; i < c.items.size(); ++i) {
+        const Item& it = c.items[i];
+        if (!it.negated) {
+            for (size_t j = 0; j < it.words.size(); ++j) {
+                IntegerList_t postings;
+                getSortedList(forum.searchPostings(it.words[j]), postings);
+                if (haveCandidates) {
+                    intersectList(candidates, postings);
+                } else {
+                    candidates.swap(postings);
+                    haveCandidates = true;
+                }
+                if (candidates.empty()) {
+                    return;
+                }
+            }
+        }
+        if (it.words.size() > 1) {
+            needVerify = true;
+        }
+    }
+
+    // Only exclusions: start with all messages
+    if (!haveCandidates) {
+        getSortedList(forum.messages(), candidates);
+    }
+
+    // Remove postings of excluded words
+    for (size_t i = 0; i < c.items.size(); ++i) {
+        const Item& it = c.items[i];
+        if (it.negated && it.words.size() == 1) {
+            IntegerList_t postings;
+            getSortedList(forum.searchPostings(it.words[0]), postings);
+            subtractList(candidates, postings);
+        }
+    }
+
+    // Verify phrases
+    if (needVerify) {
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (m_numVerified >= m_maxVerify) {
+                m_truncated = true;
+                break;
+            }
+            ++m_numVerified;
+            Message msg(root, candidates[i]);
+            StringList_t words;
+            getMessageWords(msg, root, words);
+            if (matchClause(c, words)) {
+                result.push_back(candidates[i]);
+            }
+        }
+    } else {
+        result.swap(candidates);
+    }
+}
+
+/** Check whether a word sequence matches a clause.
+    \param c     Clause
+    \param words Words
+    \return true if all items match */
+bool
+server::talk::SearchQuery::matchClause(const Clause& c, const afl::data::StringList_t& words)
+{
+    for (size_t i = 0; i < c.items.size(); ++i) {
+        if (matchItem(c.items[i], words) == c.items[i].negated) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Check whether a word sequence contains an item.
+    \param it    Item
+    \param words Words
+    \return true if the item's words appear in sequence (ignoring negation) */
+bool
+server::talk::SearchQuery::matchItem(const Item& it, const afl::data::StringList_t& words)
+{
+    return std::search(words.begin(), words.end(), it.words.begin(), it.words.end()) != words.end();
+}
@@ -0,0 +1,132 @@
+/**
+  *  \file server/talk/search.hpp
+  *  \brief Full-text search for forum postings
+  */
+#ifndef C2NG_SERVER_TALK_SEARCH_HPP
+#define C2NG_SERVER_TALK_SEARCH_HPP
+
+#include <vector>
+#include "afl/data/integerlist.hpp"
+#include "afl/data/stringlist.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace talk {
+
+    class Forum;
+    class Message;
+    class Root;
+
+    /*
+     *  The search index is an inverted index maintained incrementally in the database:
+     *  - forum:$FID:search:$TERM is the set of all postings in the forum that contain the term;
+     *  - msg:$MID:terms is the set of all terms the posting is listed under.
+     *  Postings are kept per forum, so a search can be limited to a forum,
+     *  and permissions can be checked forum-by-forum.
+     */
+
+    /** Get words of a message.
+        Produces the normalized words (see util::doc::SearchIndex::getTerm()) of the message's subject and text, in order.
+        The text is rendered as plain text with quotes removed, so a posting is not found by text it quotes.
+        \param [in]  msg  Message
+        \param [in]  root Service root
+        \param [out] out  Words are appended here */
+    void getMessageWords(Message& msg, Root& root, afl::data::StringList_t& out);
+
+    /** Add a message to the search index.
+        Call after the message has been created or edited, with the final subject and text.
+        \param msg   Message
+        \param forum Forum containing the message
+        \param root  Service root */
+    void addToSearchIndex(Message& msg, Forum& forum, Root& root);
+
+    /** Remove a message from the search index.
+        Call before the message is removed, edited, or moved to another forum.
+        \param msg   Message
+        \param forum Forum containing the message */
+    void removeFromSearchIndex(Message& msg, Forum& forum);
+
+    /** Rebuild the search index of a forum.
+        Removes every message of the forum from the index and adds it again.
+        This indexes postings that were created before the search index existed,
+        and refreshes postings whose index entries are incomplete.
+        \param forum Forum
+        \param root  Service root
+        
+eturn number of messages indexed */
+    int32_t rebuildSearchIndex(Forum& forum, Root& root);
+
+    /** Search query.
+        A query consists of items separated by spaces. Each item is
+        - a word, e.g. <tt>ship</tt>
+        - a phrase in double-quotes, e.g. <tt>"fuel tank"</tt>; the words must appear in this order.
+          A word containing punctuation is treated as a phrase, e.g. <tt>e-mail</tt>.
+        - an item prefixed with "-" to exclude postings containing it, e.g. <tt>-torpedo</tt>.
+
+        All items must match. Alternatives are separated by the word "OR" (in upper-case),
+        e.g. <tt>fuel OR "neutronic fuel" -torpedo</tt>.
+        Matching is case-insensitive.
+
+        Words are resolved using the index alone.
+        Phrases and excluded phrases need the candidate postings to be rendered and checked,
+        which is expensive; the number of postings checked per query is therefore limited.
+        When the limit is reached, remaining candidates are not reported (see isTruncated()). */
+    class SearchQuery {
+     public:
+        /** Default maximum number of postings checked per query. */
+        static const size_t DEFAULT_MAX_VERIFY = 1000;
+
+        /** Constructor.
+            \param query     Query string
+            \param maxVerify Maximum number of postings checked for phrases, over all findMessages() calls */
+        explicit SearchQuery(const String_t& query, size_t maxVerify = DEFAULT_MAX_VERIFY);
+
+        /** Destructor. */
+        ~SearchQuery();
+
+        /** Check for empty query.
+            \return true if the query has no items and therefore does not find anything */
+        bool isEmpty() const;
+
+        /** Find messages in a forum.
+            Does not check permissions.
+            Can be called for multiple forums; postings checked for phrases count towards the query's limit.
+            \param [in]  forum  Forum
+            \param [in]  root   Service root
+            \param [out] result Message Ids, sorted in ascending order, are appended here */
+        void findMessages(Forum& forum, Root& root, afl::data::IntegerList_t& result);
+
+        /** Check whether results were truncated.
+            \return true if findMessages() skipped candidates because the limit of checked postings was reached */
+        bool isTruncated() const;
+
+        /** Get number of postings checked for phrases.
+            \return number */
+        size_t getNumVerified() const;
+
+        /** Check whether a word sequence matches this query.
+            \param words Words, see getMessageWords()
+            \return true if the words match */
+        bool matchWords(const afl::data::StringList_t& words) const;
+
+     private:
+        struct Item {
+            afl::data::StringList_t words;
+            bool negated;
+        };
+        struct Clause {
+            std::vector<Item> items;
+        };
+        std::vector<Clause> m_clauses;
+        size_t m_maxVerify;
+        size_t m_numVerified;
+        bool m_truncated;
+
+        void addItem(const String_t& text, bool negated, bool& newClause);
+        void findClauseMessages(const Clause& c, Forum& forum, Root& root, afl::data::IntegerList_t& result);
+        static bool matchClause(const Clause& c, const afl::data::StringList_t& words);
+        static bool matchItem(const Item& it, const afl::data::StringList_t& words);
+    };
+
+} }
+
+#endif
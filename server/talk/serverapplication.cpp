@@ -5,9 +5,11 @@
 
 #include "server/talk/serverapplication.hpp"
 #include "afl/async/controller.hpp"
+#include "afl/except/commandlineexception.hpp"
 #include "afl/net/resp/protocolhandler.hpp"
 #include "afl/net/server.hpp"
 #include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
 #include "afl/sys/thread.hpp"
 #include "server/common/sessionprotocolhandlerfactory.hpp"
 #include "server/ports.hpp"
@@ -123,6 +125,20 @@ server::talk::ServerApplication::handleConfiguration(const String_t& key, const
            If not specified, the syntax database will be empty ({SYNTAXGET} will always fail). */
         m_keywordTableName = value;
         return true;
+    } else if (key == "TALK.RENDERCACHE") {
+        /* @q Talk.RenderCache:Int (Config)
+           Number of parsed postings to keep in memory.
+           Postings are parsed once and rendered from the cached form for each view.
+           0 disables the cache.
+           Default is 1000.
+           @since PCC2 2.41 */
+        size_t n;
+        if (afl::string::strToInteger(value, n)) {
+            m_config.renderCacheSize = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (key == "REDIS.HOST") {
         m_dbAddress.setName(value);
         return true;
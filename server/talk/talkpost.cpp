@@ -3,8 +3,14 @@
   *  \brief Class server::talk::TalkPost
   */
 
+#include <algorithm>
+#include <memory>
 #include "server/talk/talkpost.hpp"
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
+#include "afl/string/format.hpp"
 #include "server/errors.hpp"
+#include "server/types.hpp"
 #include "server/talk/accesschecker.hpp"
 #include "server/talk/forum.hpp"
 #include "server/talk/message.hpp"
@@ -12,9 +18,12 @@
 #include "server/talk/render/context.hpp"
 #include "server/talk/render/render.hpp"
 #include "server/talk/root.hpp"
+#include "server/talk/search.hpp"
 #include "server/talk/session.hpp"
 #include "server/talk/spam.hpp"
+#include "server/talk/talkforum.hpp"
 #include "server/talk/topic.hpp"
+#include "server/talk/unreadcounter.hpp"
 #include "server/talk/user.hpp"
 
 namespace {
@@ -110,6 +119,8 @@ server::talk::TalkPost::create(int32_t forumId, String_t subject, String_t text,
     f.messages().add(mid);
     f.topics().add(tid);
     u.postedMessages().add(mid);
+    addToSearchIndex(msg, f, m_root);
+    countNewMessage(f, m_root);
 
     // Notify
     if (!isSpam) {
@@ -196,6 +207,8 @@ server::talk::TalkPost::reply(int32_t parentPostId, String_t subject, String_t t
     topic.messages().add(mid);
     f.messages().add(mid);
     u.postedMessages().add(mid);
+    addToSearchIndex(msg, f, m_root);
+    countNewMessage(f, m_root);
 
     // Notify
     notifyMessage(msg, topic, f, m_root);
@@ -230,6 +243,7 @@ server::talk::TalkPost::edit(int32_t postId, String_t subject, String_t text)
     msg.subject().set(subject);
     msg.text().set(text);
     msg.editTime().set(time);
+    m_root.renderCache().remove(postId);
 
     // Update topic
     Topic topic(m_root, msg.topicId().get());
@@ -248,6 +262,10 @@ server::talk::TalkPost::edit(int32_t postId, String_t subject, String_t text)
     msg.sequenceNumber().set(++f.lastMessageSequenceNumber());
     msg.rfcMessageId().remove();
     msg.rfcHeaders().remove();
+
+    // Update search index
+    removeFromSearchIndex(msg, f);
+    addToSearchIndex(msg, f, m_root);
 }
 
 String_t
@@ -266,7 +284,7 @@ server::talk::TalkPost::render(int32_t postId, const server::interface::TalkRend
     render::Options temporaryOptions(m_session.renderOptions());
     temporaryOptions.updateFrom(options);
 
-    return render::renderText(msg.text().get(), ctx, temporaryOptions, m_root);
+    return render::renderMessage(msg, ctx, temporaryOptions, m_root);
 }
 
 void
@@ -281,7 +299,7 @@ server::talk::TalkPost::render(afl::base::Memory<const int32_t> postIds, afl::da
             result.push_back("");
         } else {
             ctx.setMessageId(*p);
-            result.push_back(render::renderText(msg.text().get(), ctx, m_session.renderOptions(), m_root));
+            result.push_back(render::renderMessage(msg, ctx, m_session.renderOptions(), m_root));
         }
     }
 }
@@ -377,3 +395,105 @@ server::talk::TalkPost::getNewest(int count, afl::data::IntegerList_t& postIds)
         ++did;
     }
 }
+
+afl::data::Value*
+server::talk::TalkPost::search(int32_t forumId, String_t query, const ListParameters& params)
+{
+    // Determine forums to search
+    afl::data::IntegerList_t forumIds;
+    if (forumId != 0) {
+        if (!Forum(m_root, forumId).exists(m_root)) {
+            throw std::runtime_error(FORUM_NOT_FOUND);
+        }
+        forumIds.push_back(forumId);
+    } else {
+        m_root.allForums().getAll(forumIds);
+    }
+
+    // Find matching postings the user can see
+    SearchQuery q(query);
+    afl::data::IntegerList_t postIds;
+    AccessChecker checker(m_root, m_session);
+    for (size_t i = 0; i < forumIds.size() && !q.isEmpty(); ++i) {
+        Forum f(m_root, forumIds[i]);
+        afl::data::IntegerList_t found;
+        q.findMessages(f, m_root, found);
+        for (size_t j = 0; j < found.size(); ++j) {
+            Message msg(m_root, found[j]);
+            if (checker.isAllowed(msg)) {
+                postIds.push_back(found[j]);
+            }
+        }
+    }
+    std::sort(postIds.begin(), postIds.end());
+    if (q.isTruncated()) {
+        m_root.log().write(afl::sys::LogListener::Info, "talk.search", afl::string::Format("Search for \"%s\" stopped after checking %d postings", query, q.getNumVerified()));
+    }
+
+    // Produce result
+    switch (params.mode) {
+     case ListParameters::WantAll:
+     case ListParameters::WantRange:
+        if (params.sortKey.get() != 0) {
+            // Sorting by message attributes needs a database key; use a temporary one
+            afl::net::redis::IntegerSetKey tmp(m_root.messageRoot().intSetKey("search"));
+            tmp.remove();
+            for (size_t i = 0; i < postIds.size(); ++i) {
+                tmp.add(postIds[i]);
+            }
+            std::auto_ptr<afl::data::Value> result;
+            try {
+                result.reset(TalkForum::executeListOperation(params, tmp, Message::MessageSorter(m_root)));
+            }
+            catch (...) {
+                tmp.remove();
+                throw;
+            }
+            tmp.remove();
+            return result.release();
+        } else {
+            size_t start = 0, end = postIds.size();
+            if (params.mode == ListParameters::WantRange) {
+                start = std::min(size_t(std::max(params.start, int32_t(0))), end);
+                end = start + std::min(size_t(std::max(params.count, int32_t(0))), end - start);
+            }
+            afl::data::Vector::Ref_t vv(afl::data::Vector::create());
+            for (size_t i = start; i < end; ++i) {
+                vv->pushBackInteger(postIds[i]);
+            }
+            return new afl::data::VectorValue(vv);
+        }
+
+     case ListParameters::WantMemberCheck:
+        return makeIntegerValue(std::binary_search(postIds.begin(), postIds.end(), params.item));
+
+     case ListParameters::WantSize:
+        return makeIntegerValue(int32_t(postIds.size()));
+    }
+    return 0;
+}
+
+int32_t
+server::talk::TalkPost::reindex(int32_t forumId)
+{
+    m_session.checkAdmin();
+
+    // Determine forums to process
+    afl::data::IntegerList_t forumIds;
+    if (forumId != 0) {
+        if (!Forum(m_root, forumId).exists(m_root)) {
+            throw std::runtime_error(FORUM_NOT_FOUND);
+        }
+        forumIds.push_back(forumId);
+    } else {
+        m_root.allForums().getAll(forumIds);
+    }
+
+    // Process
+    int32_t result = 0;
+    for (size_t i = 0; i < forumIds.size(); ++i) {
+        Forum f(m_root, forumIds[i]);
+        result += rebuildSearchIndex(f, m_root);
+    }
+    return result;
+}
@@ -31,6 +31,8 @@ namespace server { namespace talk {
         virtual String_t getHeaderField(int32_t postId, String_t fieldName);
         virtual bool remove(int32_t postId);
         virtual void getNewest(int count, afl::data::IntegerList_t& postIds);
+        virtual afl::data::Value* search(int32_t forumId, String_t query, const ListParameters& params);
+        virtual int32_t reindex(int32_t forumId);
 
      private:
         Session& m_session;
@@ -11,6 +11,8 @@
 #include "server/talk/talkforum.hpp"
 #include "server/talk/message.hpp"
 #include "server/talk/forum.hpp"
+#include "server/talk/search.hpp"
+#include "server/talk/unreadcounter.hpp"
 #include "afl/net/redis/sortoperation.hpp"
 #include "afl/net/redis/integersetoperation.hpp"
 #include "server/errors.hpp"
@@ -161,11 +163,17 @@ server::talk::TalkThread::moveToForum(int32_t threadId, int32_t forumId)
         msg.previousSequenceNumber().set(oldSeq1);
         msg.sequenceNumber().set(newSeq);
         msg.rfcMessageId().remove();
+
+        // Move search index entries
+        removeFromSearchIndex(msg, src);
+        addToSearchIndex(msg, dst, m_root);
     }
 
     // Move the postings into the new forum
     src.messages().remove(t.messages()).storeTo(src.messages());
     dst.messages().merge(t.messages()).storeTo(dst.messages());
+    resetUnreadCounts(src, m_root);
+    resetUnreadCounts(dst, m_root);
 
     // Move the thread
     if (t.isSticky()) {
@@ -9,17 +9,35 @@
 #include "server/talk/session.hpp"
 #include "server/talk/talkforum.hpp"
 #include "server/talk/topic.hpp"
+#include "server/talk/unreadcounter.hpp"
 #include "server/talk/user.hpp"
 #include "server/talk/newsrc.hpp"
 #include "server/errors.hpp"
 
 namespace {
+    /** Maximum number of individually-changed messages to account in unread counters.
+        If more messages change, the user's counters are discarded instead. */
+    const size_t MAX_COUNTED_MESSAGES = 100;
+
+    /** Record a message changed by a newsrc operation.
+        \param [in,out] list      Changed messages
+        \param [in,out] tooMany   Set if there are more than MAX_COUNTED_MESSAGES changed messages
+        \param [in]     messageId Message Id */
+    void recordChange(afl::data::IntegerList_t& list, bool& tooMany, int32_t messageId)
+    {
+        if (list.size() >= MAX_COUNTED_MESSAGES) {
+            tooMany = true;
+        } else {
+            list.push_back(messageId);
+        }
+    }
+
     // FIXME: this class is copied from PCC2 c2talk and needs a little love.
     class NewsrcAction {
      public:
         NewsrcAction(afl::net::redis::Subtree n);
-        void process(int32_t messageId);
-        void process(afl::net::redis::IntegerSetKey set);
+        bool process(int32_t messageId);
+        int32_t process(afl::net::redis::IntegerSetKey set);
         void save();
 
         void setModification(server::interface::TalkUser::Modification modif);
@@ -27,6 +45,7 @@ namespace {
         void markFind(bool value);
         void markWantId();
         bool isStopped() const;
+        int32_t getUnreadDelta(int32_t numChanged) const;
         afl::data::Value* getResult();
 
      private:
@@ -59,7 +78,7 @@ NewsrcAction::NewsrcAction(afl::net::redis::Subtree n)
       firstId(0)
 { }
 
-void
+bool
 NewsrcAction::process(int32_t messageId)
 {
     if (get) {
@@ -80,23 +99,51 @@ NewsrcAction::process(int32_t messageId)
     }
 
     switch (m_modification) {
-     case server::talk::TalkUser::NoModification:                      break;
-     case server::talk::TalkUser::MarkRead:        n.set(messageId);   break;
-     case server::talk::TalkUser::MarkUnread:      n.clear(messageId); break;
+     case server::talk::TalkUser::NoModification:  return false;
+     case server::talk::TalkUser::MarkRead:        return n.set(messageId);
+     case server::talk::TalkUser::MarkUnread:      return n.clear(messageId);
     }
+    return false;
 }
 
-void
+int32_t
 NewsrcAction::process(afl::net::redis::IntegerSetKey set)
 {
-    // FIXME: possible optimisation: if we're just checking for any unread message
-    // (find && !value && !wantId && !set && !clear), process the list backwards.
-    afl::data::IntegerList_t result;
-    set.getAll(result);
-    std::sort(result.begin(), result.end());
-    for (size_t i = 0, n = result.size(); i < n && !stop; ++i) {
-        process(result[i]);
+    afl::data::IntegerList_t list;
+    set.getAll(list);
+    std::sort(list.begin(), list.end());
+
+    if (get && !find) {
+        // We need every single value
+        int32_t numChanged = 0;
+        for (size_t i = 0, n = list.size(); i < n; ++i) {
+            if (process(list[i])) {
+                ++numChanged;
+            }
+        }
+        return numChanged;
+    }
+
+    // Bulk operation
+    if (find) {
+        int32_t id = n.findFirst(list, value);
+        if (id != 0) {
+            found = true;
+            if (m_modification == server::talk::TalkUser::NoModification) {
+                stop = true;
+            }
+            if (firstId == 0) {
+                firstId = id;
+            }
+        }
+    }
+
+    switch (m_modification) {
+     case server::talk::TalkUser::NoModification:  return 0;
+     case server::talk::TalkUser::MarkRead:        return n.setAll(list);
+     case server::talk::TalkUser::MarkUnread:      return n.clearAll(list);
     }
+    return 0;
 }
 
 inline void
@@ -137,6 +184,12 @@ NewsrcAction::isStopped() const
     return stop;
 }
 
+inline int32_t
+NewsrcAction::getUnreadDelta(int32_t numChanged) const
+{
+    return m_modification == server::talk::TalkUser::MarkUnread ? numChanged : -numChanged;
+}
+
 afl::data::Value*
 NewsrcAction::getResult()
 {
@@ -168,7 +221,10 @@ server::talk::TalkUser::accessNewsrc(Modification modif, Result res, afl::base::
 {
     m_session.checkUser();
 
-    NewsrcAction action(User(m_root, m_session.getUser()).newsrc());
+    const String_t user = m_session.getUser();
+    NewsrcAction action(User(m_root, user).newsrc());
+    afl::data::IntegerList_t changedMessages;
+    bool tooManyChanges = false;
     int32_t limit = -1;
 
     action.setModification(modif);
@@ -192,17 +248,21 @@ server::talk::TalkUser::accessNewsrc(Modification modif, Result res, afl::base::
                 throw std::runtime_error(MESSAGE_NOT_FOUND);   // @change: was 413 Range error in PCC2, but actually means Message not found.
             }
             for (int32_t i = p->id; i <= p->lastId && !action.isStopped(); ++i) {
-                action.process(i);
+                if (action.process(i)) {
+                    recordChange(changedMessages, tooManyChanges, i);
+                }
             }
             break;
 
          case ForumScope:
-            action.process(Forum(m_root, p->id).messages());
+            adjustUnreadCount(m_root, user, p->id, action.getUnreadDelta(action.process(Forum(m_root, p->id).messages())));
             break;
 
-         case ThreadScope:
-            action.process(Topic(m_root, p->id).messages());
+         case ThreadScope: {
+            Topic t(m_root, p->id);
+            adjustUnreadCount(m_root, user, t.forumId().get(), action.getUnreadDelta(action.process(t.messages())));
             break;
+         }
         }
     }
 
@@ -216,11 +276,26 @@ server::talk::TalkUser::accessNewsrc(Modification modif, Result res, afl::base::
             if (*p <= 0 || *p > limit) {
                 throw std::runtime_error(MESSAGE_NOT_FOUND);   // @change: was 413 Range error in PCC2, but actually means Message not found.
             }
-            action.process(*p);
+            if (action.process(*p)) {
+                recordChange(changedMessages, tooManyChanges, *p);
+            }
         }
     }
 
     action.save();
+
+    // Update unread counters for individually-changed messages
+    if (tooManyChanges) {
+        resetUnreadCounts(m_root, user);
+    } else {
+        for (size_t i = 0; i < changedMessages.size(); ++i) {
+            Message msg(m_root, changedMessages[i]);
+            if (msg.exists()) {
+                adjustUnreadCount(m_root, user, msg.topic(m_root).forumId().get(), action.getUnreadDelta(1));
+            }
+        }
+    }
+
     return action.getResult();
 }
 
@@ -265,6 +340,21 @@ server::talk::TalkUser::getPostedMessages(String_t user, const ListParameters& p
     return TalkForum::executeListOperation(params, User(m_root, user).postedMessages(), Message::MessageSorter(m_root));
 }
 
+void
+server::talk::TalkUser::getUnreadCounts(afl::base::Memory<const int32_t> forumIds, afl::data::IntegerList_t& result)
+{
+    const String_t user = m_session.getUser();
+    m_session.checkUser();
+
+    while (const int32_t* p = forumIds.eat()) {
+        Forum f(m_root, *p);
+        if (!f.exists(m_root)) {
+            throw std::runtime_error(FORUM_NOT_FOUND);
+        }
+        result.push_back(getUnreadCount(m_root, user, f));
+    }
+}
+
 void
 server::talk::TalkUser::processWatch(WatchAction action, afl::base::Memory<const Selection> selections)
 {
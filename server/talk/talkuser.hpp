@@ -22,6 +22,7 @@ namespace server { namespace talk {
         virtual afl::data::Value* getWatchedThreads(const ListParameters& params);
         virtual afl::data::Value* getWatchedForums(const ListParameters& params);
         virtual afl::data::Value* getPostedMessages(String_t user, const ListParameters& params);
+        virtual void getUnreadCounts(afl::base::Memory<const int32_t> forumIds, afl::data::IntegerList_t& result);
 
      private:
         Session& m_session;
@@ -2,6 +2,7 @@
   *  \file server/talk/textnode.cpp
   */
 
+#include <memory>
 #include "server/talk/textnode.hpp"
 
 bool
@@ -70,3 +71,13 @@ server::talk::TextNode::getTextContent() const
         return result;
     }
 }
+
+server::talk::TextNode*
+server::talk::TextNode::clone() const
+{
+    std::auto_ptr<TextNode> result(new TextNode(major, minor, text));
+    for (size_t i = 0, n = children.size(); i != n; ++i) {
+        result->children.pushBackNew(children[i]->clone());
+    }
+    return result.release();
+}
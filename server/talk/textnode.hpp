@@ -95,6 +95,10 @@ namespace server { namespace talk {
         /** Get content of this node as raw text.
             \return text */
         String_t getTextContent() const;
+
+        /** Create a copy of this node, including all children.
+            \return newly-allocated copy, to be owned by caller */
+        TextNode* clone() const;
     };
 
 } }
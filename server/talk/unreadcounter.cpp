@@ -0,0 +1,102 @@
+/**
+  *  \file server/talk/unreadcounter.cpp
+  *  \brief Per-forum unread counters
+  */
+
+#include <algorithm>
+#include "server/talk/unreadcounter.hpp"
+#include "afl/data/integerlist.hpp"
+#include "afl/data/stringlist.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/string/format.hpp"
+#include "server/talk/forum.hpp"
+#include "server/talk/newsrc.hpp"
+#include "server/talk/root.hpp"
+#include "server/talk/user.hpp"
+
+using afl::data::StringList_t;
+
+namespace {
+    /** Get counter.
+        \param root    Service root
+        \param userId  User Id
+        \param forumId Forum Id
+        \return counter field */
+    afl::net::redis::IntegerField getCounter(server::talk::Root& root, const String_t& userId, int32_t forumId)
+    {
+        return server::talk::User(root, userId).unreadCounters().intField(afl::string::Format("%d", forumId));
+    }
+}
+
+// Get number of unread messages in a forum.
+int32_t
+server::talk::getUnreadCount(Root& root, const String_t& userId, Forum& forum)
+{
+    afl::net::redis::IntegerField counter = getCounter(root, userId, forum.getId());
+    if (counter.exists()) {
+        return counter.get();
+    }
+
+    // Compute it
+    afl::data::IntegerList_t messages;
+    forum.messages().getAll(messages);
+    std::sort(messages.begin(), messages.end());
+
+    int32_t result = Newsrc(User(root, userId).newsrc()).count(messages, false);
+    counter.set(result);
+    forum.unreadUsers().add(userId);
+    return result;
+}
+
+// Account for a new message in a forum.
+void
+server::talk::countNewMessage(Forum& forum, Root& root)
+{
+    StringList_t users;
+    forum.unreadUsers().getAll(users);
+    for (size_t i = 0; i < users.size(); ++i) {
+        afl::net::redis::IntegerField counter = getCounter(root, users[i], forum.getId());
+        if (counter.exists()) {
+            ++counter;
+        } else {
+            // Counter has been discarded by resetUnreadCounts(Root&, const String_t&)
+            forum.unreadUsers().remove(users[i]);
+        }
+    }
+}
+
+// Adjust a user's unread counter.
+void
+server::talk::adjustUnreadCount(Root& root, const String_t& userId, int32_t forumId, int32_t delta)
+{
+    afl::net::redis::IntegerField counter = getCounter(root, userId, forumId);
+    if (delta != 0 && counter.exists()) {
+        int32_t newValue = counter.get() + delta;
+        if (newValue < 0) {
+            // Cannot happen if everything is consistent; recompute on next use
+            counter.remove();
+        } else {
+            counter.set(newValue);
+        }
+    }
+}
+
+// Discard all counters for a forum.
+void
+server::talk::resetUnreadCounts(Forum& forum, Root& root)
+{
+    StringList_t users;
+    forum.unreadUsers().getAll(users);
+    for (size_t i = 0; i < users.size(); ++i) {
+        getCounter(root, users[i], forum.getId()).remove();
+    }
+    forum.unreadUsers().remove();
+}
+
+// Discard all counters of a user.
+void
+server::talk::resetUnreadCounts(Root& root, const String_t& userId)
+{
+    // Leaves the users in the forums' unreadUsers() sets; countNewMessage() cleans that up.
+    User(root, userId).unreadCounters().remove();
+}
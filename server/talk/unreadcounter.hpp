@@ -0,0 +1,64 @@
+/**
+  *  \file server/talk/unreadcounter.hpp
+  *  \brief Per-forum unread counters
+  */
+#ifndef C2NG_SERVER_TALK_UNREADCOUNTER_HPP
+#define C2NG_SERVER_TALK_UNREADCOUNTER_HPP
+
+#include "afl/base/types.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace talk {
+
+    class Forum;
+    class Root;
+
+    /*
+     *  Unread counters cache the number of unread messages in a forum for a user:
+     *  - user:$UID:forum:unread maps Forum Ids to counters;
+     *  - forum:$FID:unreadusers is the set of users that (possibly) have a counter for the forum.
+     *  Counters are created on demand by getUnreadCount(), and maintained incrementally
+     *  when messages are posted or marked read/unread.
+     *  Operations where an incremental update is not easily possible (removing or moving messages)
+     *  simply discard the counters; they will be recomputed on next use.
+     */
+
+    /** Get number of unread messages in a forum.
+        Uses the stored counter if available, otherwise computes it from the user's newsrc and stores it.
+        \param root   Service root
+        \param userId User Id
+        \param forum  Forum
+        \return number of unread messages */
+    int32_t getUnreadCount(Root& root, const String_t& userId, Forum& forum);
+
+    /** Account for a new message in a forum.
+        Call after the message has been added to the forum.
+        Increments the counters of all users.
+        \param forum Forum
+        \param root  Service root */
+    void countNewMessage(Forum& forum, Root& root);
+
+    /** Adjust a user's unread counter.
+        Call after messages in the forum have been marked read or unread.
+        Does nothing if the user has no counter for this forum.
+        \param root    Service root
+        \param userId  User Id
+        \param forumId Forum Id
+        \param delta   Change to apply (negative if messages have been marked read) */
+    void adjustUnreadCount(Root& root, const String_t& userId, int32_t forumId, int32_t delta);
+
+    /** Discard all counters for a forum.
+        Call after messages have been removed from the forum or moved into or out of it.
+        \param forum Forum
+        \param root  Service root */
+    void resetUnreadCounts(Forum& forum, Root& root);
+
+    /** Discard all counters of a user.
+        Call after changing the user's newsrc in a way that cannot easily be accounted per forum.
+        \param root   Service root
+        \param userId User Id */
+    void resetUnreadCounts(Root& root, const String_t& userId);
+
+} }
+
+#endif
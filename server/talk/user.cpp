@@ -69,6 +69,13 @@ server::talk::User::newsrc()
     return forumData().subtree("newsrc");
 }
 
+// Get user's unread counters.
+afl::net::redis::HashKey
+server::talk::User::unreadCounters()
+{
+    return forumData().hashKey("unread");
+}
+
 // Get PM data for user.
 afl::net::redis::Subtree
 server::talk::User::pmFolderData()
@@ -54,6 +54,11 @@ namespace server { namespace talk {
             \return subtree for newsrc data */
         afl::net::redis::Subtree newsrc();
 
+        /** Get user's unread counters.
+            Maps Forum Ids to number of unread messages, see getUnreadCount().
+            \return hash containing counters */
+        afl::net::redis::HashKey unreadCounters();
+
         /** Get PM data for user.
             Used for manual access to user's PM data (not recommended normally).
             \return subtree containing forum data. */
@@ -11,6 +11,13 @@ build_test_app('dirbrowser',    ['gamelib', 'afl']);
 build_test_app('overview',      ['gamelib', 'afl']);
 build_test_app('processrunner', ['gamelib', 'afl']);
 build_test_app('testvcr',       ['gamelib', 'afl']);
+build_test_app('benchvcr',      ['gamelib', 'afl']);
+build_test_app('benchforeach',  ['gamelib', 'afl']);
+build_test_app('benchscript',   ['gamelib', 'afl']);
+build_test_app('benchloadrst',  ['gamelib', 'afl']);
+build_test_app('benchfile',     ['serverlib', 'gamelib', 'afl']);
+build_test_app('benchexport',   ['serverlib', 'gamelib', 'afl']);
+build_test_app('benchpack',     ['serverlib', 'gamelib', 'afl']);
 build_test_app('testflak',      ['gamelib', 'afl']);
 build_test_app('msgparse',      ['gamelib', 'afl']);
 build_test_app('ui_root',       ['guilib', 'gamelib', 'afl']);
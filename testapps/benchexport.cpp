@@ -0,0 +1,123 @@
+/**
+  *  \file testapps/benchexport.cpp
+  *  \brief Throughput test for host exports
+  *
+  *  Runs a c2file server in-process on a local port, with a game-like directory tree in memory,
+  *  and copies that tree to a local directory and back, the way server::host::Exporter does.
+  *  This is done once using a regular afl::net::resp::Client (one round-trip per file),
+  *  and once using a server::interface::PipelinedClient (files transferred in batches).
+  *
+  *  The target directory should be empty.
+  */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include "afl/io/filesystem.hpp"
+#include "afl/io/internaldirectory.hpp"
+#include "afl/net/name.hpp"
+#include "afl/net/networkstack.hpp"
+#include "afl/net/resp/client.hpp"
+#include "afl/net/resp/protocolhandler.hpp"
+#include "afl/net/server.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/thread.hpp"
+#include "afl/sys/time.hpp"
+#include "server/common/sessionprotocolhandlerfactory.hpp"
+#include "server/file/clientdirectoryhandler.hpp"
+#include "server/file/commandhandler.hpp"
+#include "server/file/directoryitem.hpp"
+#include "server/file/filesystemhandler.hpp"
+#include "server/file/internaldirectoryhandler.hpp"
+#include "server/file/root.hpp"
+#include "server/file/session.hpp"
+#include "server/file/utils.hpp"
+#include "server/interface/filebaseclient.hpp"
+#include "server/interface/pipelinedclient.hpp"
+
+using afl::string::Format;
+
+namespace {
+    /* Populate the source tree: numDirs directories with numFiles files each, sizes in the range of typical game files. */
+    void populate(afl::net::CommandHandler& conn, int numDirs, int numFiles)
+    {
+        server::interface::FileBaseClient file(conn);
+        for (int d = 0; d < numDirs; ++d) {
+            const String_t dirName = Format("game/d%d", d);
+            file.createDirectoryTree(dirName);
+            for (int f = 0; f < numFiles; ++f) {
+                file.putFile(Format("%s/file%d.dat", dirName, f), String_t(100 + (f * 997) % 20000, 'x'));
+            }
+        }
+    }
+
+    /* Export "game" into a fresh local directory and import it back; report times. */
+    void runBenchmark(const char* label, afl::net::CommandHandler& conn, afl::io::FileSystem& fs, const String_t& localName)
+    {
+        std::auto_ptr<server::file::DirectoryHandler> local(new server::file::FileSystemHandler(fs, localName));
+        server::file::removeDirectoryContent(*local);
+
+        // Export: like Exporter::exportSubdirectory
+        uint32_t start = afl::sys::Time::getTickCounter();
+        {
+            server::file::ClientDirectoryHandler source(conn, "game");
+            server::file::copyDirectory(*local, source, server::file::CopyFlags_t(server::file::CopyRecursively));
+        }
+        const uint32_t exportTime = afl::sys::Time::getTickCounter() - start;
+
+        // Import: like Exporter::importSubdirectory (everything changed)
+        server::interface::FileBaseClient(conn).createDirectoryTree(Format("back/%s", label));
+        start = afl::sys::Time::getTickCounter();
+        {
+            server::file::ClientDirectoryHandler target(conn, Format("back/%s", label));
+            server::file::synchronizeDirectories(target, *local);
+        }
+        const uint32_t importTime = afl::sys::Time::getTickCounter() - start;
+
+        std::cout << Format("%-10s export %6d ms, import %6d ms\n", label, exportTime, importTime);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* dirName = (argc > 1 ? argv[1] : 0);
+    const int numDirs   = (argc > 2 ? std::atoi(argv[2]) : 10);
+    const int numFiles  = (argc > 3 ? std::atoi(argv[3]) : 100);
+    if (dirName == 0 || numDirs <= 0 || numFiles <= 0) {
+        std::cout << "Usage: benchexport emptydir [numDirs [numFiles]]\n";
+        return 1;
+    }
+
+    try {
+        afl::io::FileSystem& fs = afl::io::FileSystem::getInstance();
+        afl::net::NetworkStack& net = afl::net::NetworkStack::getInstance();
+        afl::net::Name name("127.0.0.1", uint16_t(std::rand() % 10000 + 20000));
+
+        // Server, with data in memory so the file server's disk does not dominate
+        server::file::InternalDirectoryHandler::Directory rootDir("");
+        server::file::DirectoryItem item("(root)", 0, std::auto_ptr<server::file::DirectoryHandler>(new server::file::InternalDirectoryHandler("(root)", rootDir)));
+        server::file::Root root(item, afl::io::InternalDirectory::create("(spec)"));
+        server::common::SessionProtocolHandlerFactory<server::file::Root, server::file::Session, afl::net::resp::ProtocolHandler, server::file::CommandHandler> factory(root);
+        afl::net::Server networkServer(net.listen(name, 10), factory);
+        afl::sys::Thread serverThread("benchexport.server", networkServer);
+        serverThread.start();
+
+        {
+            afl::net::resp::Client plain(net, name);
+            server::interface::PipelinedClient pipelined(net, name);
+            populate(plain, numDirs, numFiles);
+
+            std::cout << Format("%d directories, %d files each\n", numDirs, numFiles);
+            runBenchmark("plain", plain, fs, dirName);
+            runBenchmark("pipelined", pipelined, fs, dirName);
+        }
+
+        networkServer.stop();
+        serverThread.join();
+    }
+    catch (std::exception& e) {
+        std::cout << "Exception: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
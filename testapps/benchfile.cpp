@@ -0,0 +1,212 @@
+/**
+  *  \file testapps/benchfile.cpp
+  *  \brief Load test for the file server
+  *
+  *  Runs a c2file server in-process on a local port, once with the classic
+  *  single-threaded network server and once with a pool of worker threads
+  *  (File.Workers), and runs the same mixed workload against both:
+  *  a number of clients, each mostly reading (GET, LS, STAT) and sometimes
+  *  writing a large file (PUT). Reports latency percentiles for reads and writes.
+  *
+  *  The server operates on a real directory, which should be empty.
+  */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "afl/base/runnable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/io/filesystem.hpp"
+#include "afl/io/internaldirectory.hpp"
+#include "afl/net/name.hpp"
+#include "afl/net/networkstack.hpp"
+#include "afl/net/resp/client.hpp"
+#include "afl/net/resp/protocolhandler.hpp"
+#include "afl/net/server.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "afl/sys/time.hpp"
+#include "server/common/sessionprotocolhandlerfactory.hpp"
+#include "server/common/threadpoolserver.hpp"
+#include "server/file/commandhandler.hpp"
+#include "server/file/directoryitem.hpp"
+#include "server/file/filesystemhandler.hpp"
+#include "server/file/root.hpp"
+#include "server/file/session.hpp"
+#include "server/interface/filebaseclient.hpp"
+
+using afl::string::Format;
+
+namespace {
+    const size_t SMALL_SIZE = 1024;
+    const size_t LARGE_SIZE = 4*1024*1024;
+
+    /* Every WRITE_RATIO'th request of a client is a PUT */
+    const int WRITE_RATIO = 10;
+
+    /* Collected latencies, in milliseconds */
+    struct Result {
+        std::vector<uint32_t> reads;
+        std::vector<uint32_t> writes;
+    };
+
+    /* A client. Runs its requests on its own connection and adds the latencies to the result. */
+    class Client : public afl::base::Runnable {
+     public:
+        Client(afl::net::NetworkStack& net, const afl::net::Name& name, int index, int numRequests, afl::sys::Mutex& mutex, Result& result)
+            : m_net(net), m_name(name), m_index(index), m_numRequests(numRequests), m_mutex(mutex), m_result(result)
+            { }
+        virtual void run()
+            {
+                try {
+                    afl::net::resp::Client conn(m_net, m_name);
+                    server::interface::FileBaseClient file(conn);
+                    const String_t large(LARGE_SIZE, 'x');
+                    const String_t dirName = Format("bench/c%d", m_index);
+                    file.createDirectoryTree(dirName);
+
+                    Result mine;
+                    for (int i = 0; i < m_numRequests; ++i) {
+                        const uint32_t start = afl::sys::Time::getTickCounter();
+                        if ((i + m_index) % WRITE_RATIO == 0) {
+                            file.putFile(dirName + "/large", large);
+                            mine.writes.push_back(afl::sys::Time::getTickCounter() - start);
+                        } else {
+                            switch (i % 3) {
+                             case 0:
+                                file.getFile("bench/small");
+                                break;
+                             case 1: {
+                                server::interface::FileBase::ContentInfoMap_t content;
+                                file.getDirectoryContent("bench", content);
+                                break;
+                             }
+                             default:
+                                file.getFileInformation("bench/small");
+                                break;
+                            }
+                            mine.reads.push_back(afl::sys::Time::getTickCounter() - start);
+                        }
+                    }
+
+                    afl::sys::MutexGuard g(m_mutex);
+                    m_result.reads.insert(m_result.reads.end(), mine.reads.begin(), mine.reads.end());
+                    m_result.writes.insert(m_result.writes.end(), mine.writes.begin(), mine.writes.end());
+                }
+                catch (std::exception& e) {
+                    std::cout << "Client " << m_index << ": " << e.what() << "\n";
+                }
+            }
+     private:
+        afl::net::NetworkStack& m_net;
+        afl::net::Name m_name;
+        int m_index;
+        int m_numRequests;
+        afl::sys::Mutex& m_mutex;
+        Result& m_result;
+    };
+
+    uint32_t getPercentile(const std::vector<uint32_t>& sorted, int percent)
+    {
+        if (sorted.empty()) {
+            return 0;
+        } else {
+            return sorted[std::min(sorted.size() - 1, sorted.size() * percent / 100)];
+        }
+    }
+
+    void showLatencies(const char* label, std::vector<uint32_t> times)
+    {
+        std::sort(times.begin(), times.end());
+        std::cout << Format("  %-6s %6d requests, p50 %5d ms, p90 %5d ms, p99 %5d ms, max %5d ms\n",
+                            label, times.size(),
+                            getPercentile(times, 50), getPercentile(times, 90), getPercentile(times, 99),
+                            times.empty() ? 0 : times.back());
+    }
+
+    /* Run one benchmark: start a server, run the clients, report. */
+    void runBenchmark(afl::io::FileSystem& fs, const String_t& dirName, uint16_t port, size_t numWorkers, int numClients, int numRequests)
+    {
+        afl::net::NetworkStack& net = afl::net::NetworkStack::getInstance();
+        afl::net::Name name("127.0.0.1", port);
+
+        // Server
+        server::file::DirectoryItem item("(root)", 0, std::auto_ptr<server::file::DirectoryHandler>(new server::file::FileSystemHandler(fs, dirName)));
+        server::file::Root root(item, afl::io::InternalDirectory::create("(spec)"));
+        server::common::SessionProtocolHandlerFactory<server::file::Root, server::file::Session, afl::net::resp::ProtocolHandler, server::file::CommandHandler> factory(root);
+        std::auto_ptr<afl::base::Stoppable> networkServer;
+        if (numWorkers == 0) {
+            networkServer.reset(new afl::net::Server(net.listen(name, 10), factory));
+        } else {
+            networkServer.reset(new server::common::ThreadPoolServer(net.listen(name, 10), factory, numWorkers));
+        }
+        afl::sys::Thread serverThread("benchfile.server", *networkServer);
+        serverThread.start();
+
+        // Test data
+        {
+            afl::net::resp::Client conn(net, name);
+            server::interface::FileBaseClient file(conn);
+            file.createDirectoryTree("bench");
+            file.putFile("bench/small", String_t(SMALL_SIZE, 'y'));
+        }
+
+        // Clients
+        afl::sys::Mutex mutex;
+        Result result;
+        afl::container::PtrVector<Client> clients;
+        afl::container::PtrVector<afl::sys::Thread> threads;
+        const uint32_t start = afl::sys::Time::getTickCounter();
+        for (int i = 0; i < numClients; ++i) {
+            Client* c = clients.pushBackNew(new Client(net, name, i, numRequests, mutex, result));
+            threads.pushBackNew(new afl::sys::Thread(Format("benchfile.client%d", i), *c))->start();
+        }
+        for (size_t i = 0, n = threads.size(); i < n; ++i) {
+            threads[i]->join();
+        }
+        const uint32_t elapsed = afl::sys::Time::getTickCounter() - start;
+
+        networkServer->stop();
+        serverThread.join();
+
+        // Report
+        if (numWorkers == 0) {
+            std::cout << "Single thread:\n";
+        } else {
+            std::cout << numWorkers << " workers:\n";
+        }
+        showLatencies("read", result.reads);
+        showLatencies("write", result.writes);
+        std::cout << Format("  total  %d ms\n", elapsed);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* dirName   = (argc > 1 ? argv[1] : 0);
+    const int numClients  = (argc > 2 ? std::atoi(argv[2]) : 8);
+    const int numRequests = (argc > 3 ? std::atoi(argv[3]) : 200);
+    const int numWorkers  = (argc > 4 ? std::atoi(argv[4]) : numClients);
+    if (dirName == 0 || numClients <= 0 || numRequests <= 0 || numWorkers < numClients) {
+        std::cout << "Usage: benchfile emptydir [numClients [numRequests [numWorkers]]]\n"
+                  << "numWorkers must be at least numClients.\n";
+        return 1;
+    }
+
+    try {
+        afl::io::FileSystem& fs = afl::io::FileSystem::getInstance();
+        const uint16_t port = uint16_t(std::rand() % 10000 + 20000);
+
+        // Same workload, same directory (with the data of the first run still in it).
+        runBenchmark(fs, dirName, port,                0,                  numClients, numRequests);
+        runBenchmark(fs, dirName, uint16_t(port + 1), size_t(numWorkers), numClients, numRequests);
+    }
+    catch (std::exception& e) {
+        std::cout << "Exception: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
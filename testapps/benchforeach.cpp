@@ -0,0 +1,82 @@
+/**
+  *  \file testapps/benchforeach.cpp
+  *  \brief Benchmark for name lookups in ship/planet loops
+  *
+  *  Runs a "ForEach Ship" loop that reads a few properties of every ship.
+  *  This is dominated by name lookups in ShipContext; use it to compare builds
+  *  (e.g. with/without the interpreter's inline cache).
+  */
+
+#include <cstdlib>
+#include <iostream>
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/io/textfile.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/time.hpp"
+#include "game/game.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/test/root.hpp"
+#include "game/turn.hpp"
+#include "interpreter/defaultstatementcompilationcontext.hpp"
+#include "interpreter/filecommandsource.hpp"
+#include "interpreter/statementcompiler.hpp"
+
+namespace {
+    const char CODE[] =
+        "Dim sum = 0\n"
+        "ForEach Ship Do\n"
+        "  sum := sum + Id + Loc.X + Loc.Y + Owner$\n"
+        "  If Ship.Name = '' Then sum := sum + 1\n"
+        "Next\n";
+}
+
+int main(int argc, char** argv)
+{
+    const int numShips = (argc > 1 ? std::atoi(argv[1]) : 500);
+    const int numRuns  = (argc > 2 ? std::atoi(argv[2]) : 1000);
+    if (numShips <= 0 || numShips > 999 || numRuns <= 0) {
+        std::cout << "Usage: benchforeach [numShips [numRuns]]\n";
+        return 1;
+    }
+
+    // Build universe
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    const game::PlayerSet_t S(3);
+    session.setRoot(game::test::makeRoot(game::HostVersion()).asPtr());
+    session.setShipList(new game::spec::ShipList());
+    session.setGame(new game::Game());
+    game::map::Universe& univ = session.getGame()->currentTurn().universe();
+    for (int i = 1; i <= numShips; ++i) {
+        univ.ships().create(i)->addShipXYData(game::map::Point(1000 + i, 2000 - i), 3, 100, S);
+    }
+    session.postprocessTurn(session.getGame()->currentTurn(), S, S, game::map::Object::Playable);
+
+    // Compile
+    afl::io::ConstMemoryStream ms(afl::string::toBytes(CODE));
+    afl::io::TextFile tf(ms);
+    interpreter::FileCommandSource fcs(tf);
+    interpreter::BCORef_t bco = interpreter::BytecodeObject::create(true);
+    interpreter::StatementCompiler(fcs).compileList(*bco, interpreter::DefaultStatementCompilationContext(session.world()));
+
+    // Run
+    uint32_t t0 = afl::sys::Time::getTickCounter();
+    for (int i = 0; i < numRuns; ++i) {
+        interpreter::Process& proc = session.processList().create(session.world(), "bench");
+        proc.pushFrame(bco, false);
+        proc.run();
+        if (proc.getState() != interpreter::Process::Ended) {
+            std::cout << "Script failed: " << proc.getError().what() << "\n";
+            return 1;
+        }
+        session.processList().removeTerminatedProcesses();
+    }
+    uint32_t t1 = afl::sys::Time::getTickCounter();
+
+    std::cout << numRuns << " runs with " << numShips << " ships: " << (t1 - t0) << " ms\n";
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+  *  \file testapps/benchloadrst.cpp
+  *  \brief Benchmark for loading v3 result files
+  *
+  *  Creates a result file with 999 ships, 500 planets and 500 starbases,
+  *  and loads it repeatedly using game::v3::Loader::loadResult().
+  *  Use it to compare builds (e.g. block-wise vs. record-wise reading).
+  */
+
+#include <cstdlib>
+#include <iostream>
+#include "afl/base/growablememory.hpp"
+#include "afl/charset/codepage.hpp"
+#include "afl/charset/codepagecharset.hpp"
+#include "afl/checksums/bytesum.hpp"
+#include "afl/io/filesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/log.hpp"
+#include "afl/sys/time.hpp"
+#include "game/game.hpp"
+#include "game/root.hpp"
+#include "game/test/root.hpp"
+#include "game/timestamp.hpp"
+#include "game/turn.hpp"
+#include "game/v3/loader.hpp"
+#include "game/v3/structures.hpp"
+
+namespace gt = game::v3::structures;
+
+namespace {
+    const int PLAYER = 3;
+    const int NUM_SHIPS = gt::NUM_SHIPS;
+    const int NUM_PLANETS = gt::NUM_PLANETS;
+
+    /* Build a result file.
+       Layout is as in game::test::makeEmptyResult(), but with units. */
+    afl::base::GrowableBytes_t makeResult()
+    {
+        // Records
+        gt::Ship ships[NUM_SHIPS];
+        gt::Planet planets[NUM_PLANETS];
+        gt::Base bases[NUM_PLANETS];
+        gt::ShipXY coordinates[NUM_SHIPS];
+        afl::base::fromObject(ships).fill(0);
+        afl::base::fromObject(planets).fill(0);
+        afl::base::fromObject(bases).fill(0);
+        afl::base::fromObject(coordinates).fill(0);
+        for (int i = 0; i < NUM_SHIPS; ++i) {
+            ships[i].shipId = static_cast<int16_t>(i+1);
+            ships[i].owner = PLAYER;
+            ships[i].x = static_cast<int16_t>(1000 + i);
+            ships[i].y = static_cast<int16_t>(2000 + i);
+            coordinates[i].x = static_cast<int16_t>(1000 + i);
+            coordinates[i].y = static_cast<int16_t>(2000 + i);
+            coordinates[i].owner = PLAYER;
+            coordinates[i].mass = 100;
+        }
+        for (int i = 0; i < NUM_PLANETS; ++i) {
+            planets[i].planetId = static_cast<int16_t>(i+1);
+            planets[i].owner = PLAYER;
+            bases[i].baseId = static_cast<int16_t>(i+1);
+            bases[i].owner = PLAYER;
+        }
+
+        gt::ResultGen gen;
+        afl::base::fromObject(gen).fill(0);
+        game::Timestamp(2020, 1, 1, 12, 0, 0).storeRawData(gen.timestamp);
+        gen.playerId          = PLAYER;
+        gen.turnNumber        = 10;
+        gen.timestampChecksum = static_cast<int16_t>(afl::checksums::ByteSum().add(gen.timestamp, 0));
+
+        gt::Int16_t numShips, numTargets, numPlanets, numBases, numMessages, numVcrs;
+        numShips = NUM_SHIPS;
+        numTargets = 0;
+        numPlanets = NUM_PLANETS;
+        numBases = NUM_PLANETS;
+        numMessages = 0;
+        numVcrs = 0;
+
+        // Header
+        gt::Int32_t addr[8];
+        int32_t pos = 1 + static_cast<int32_t>(sizeof(addr));
+        addr[0] = pos; pos += static_cast<int32_t>(sizeof(numShips) + sizeof(ships));
+        addr[1] = pos; pos += static_cast<int32_t>(sizeof(numTargets));
+        addr[2] = pos; pos += static_cast<int32_t>(sizeof(numPlanets) + sizeof(planets));
+        addr[3] = pos; pos += static_cast<int32_t>(sizeof(numBases) + sizeof(bases));
+        addr[4] = pos; pos += static_cast<int32_t>(sizeof(numMessages));
+        addr[5] = pos; pos += static_cast<int32_t>(sizeof(coordinates));
+        addr[6] = pos; pos += static_cast<int32_t>(sizeof(gen));
+        addr[7] = pos;
+
+        afl::base::GrowableBytes_t result;
+        result.append(afl::base::fromObject(addr));
+        result.append(afl::base::fromObject(numShips));
+        result.append(afl::base::fromObject(ships));
+        result.append(afl::base::fromObject(numTargets));
+        result.append(afl::base::fromObject(numPlanets));
+        result.append(afl::base::fromObject(planets));
+        result.append(afl::base::fromObject(numBases));
+        result.append(afl::base::fromObject(bases));
+        result.append(afl::base::fromObject(numMessages));
+        result.append(afl::base::fromObject(coordinates));
+        result.append(afl::base::fromObject(gen));
+        result.append(afl::base::fromObject(numVcrs));
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* fileName = (argc > 1 ? argv[1] : "benchloadrst.tmp");
+    const int numRuns    = (argc > 2 ? std::atoi(argv[2]) : 100);
+    if (numRuns <= 0) {
+        std::cout << "Usage: benchloadrst [tempfile [numRuns]]\n";
+        return 1;
+    }
+
+    try {
+        // Create file
+        afl::io::FileSystem& fs = afl::io::FileSystem::getInstance();
+        fs.openFile(fileName, afl::io::FileSystem::Create)->fullWrite(makeResult());
+
+        // Environment
+        afl::string::NullTranslator tx;
+        afl::sys::Log log;
+        afl::charset::CodepageCharset cs(afl::charset::g_codepageLatin1);
+        afl::base::Ref<game::Root> root = game::test::makeRoot(game::HostVersion());
+        game::v3::Loader loader(cs, tx, log);
+
+        // Run
+        uint32_t t0 = afl::sys::Time::getTickCounter();
+        for (int i = 0; i < numRuns; ++i) {
+            afl::base::Ref<afl::io::Stream> file = fs.openFile(fileName, afl::io::FileSystem::OpenRead);
+            game::Game g;
+            game::Turn& turn = g.currentTurn();
+            loader.prepareUniverse(turn.universe());
+            loader.loadResult(turn, *root, g, *file, PLAYER);
+        }
+        uint32_t t1 = afl::sys::Time::getTickCounter();
+
+        fs.openDirectory(fs.getDirectoryName(fileName))->eraseNT(fs.getFileName(fileName));
+
+        std::cout << numRuns << " loads of " << NUM_SHIPS << " ships, " << NUM_PLANETS << " planets: " << (t1 - t0) << " ms\n";
+    }
+    catch (std::exception& e) {
+        std::cout << "Exception: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+  *  \file testapps/benchpack.cpp
+  *  \brief Benchmark for pack files in the content-addressable file store
+  *
+  *  Creates a number of data objects as loose objects in an ObjectStore on a real directory,
+  *  and reads them back using a fresh ObjectStore instance (so the InternalObjectCache is cold).
+  *  Then repacks the store and reads the objects again.
+  *  Reports timings and the number of files on disk for both layouts.
+  *
+  *  Note that the operating system's file cache is not flushed between the runs;
+  *  the difference therefore mostly shows the per-file overhead (open/close, directory lookup),
+  *  not disk seeks.
+  *
+  *  The directory should be empty.
+  */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "afl/base/ptr.hpp"
+#include "afl/io/directory.hpp"
+#include "afl/io/directoryentry.hpp"
+#include "afl/io/filesystem.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/time.hpp"
+#include "server/file/ca/objectid.hpp"
+#include "server/file/ca/objectstore.hpp"
+#include "server/file/filesystemhandler.hpp"
+
+using afl::string::Format;
+using server::file::ca::ObjectId;
+using server::file::ca::ObjectStore;
+
+namespace {
+    /* Count files (not directories) below a directory. */
+    size_t countFiles(afl::io::Directory& dir)
+    {
+        size_t result = 0;
+        afl::base::Ref<afl::base::Enumerator<afl::base::Ptr<afl::io::DirectoryEntry> > > it = dir.getDirectoryEntries();
+        afl::base::Ptr<afl::io::DirectoryEntry> e;
+        while (it->getNextElement(e)) {
+            if (e->getFileType() == afl::io::DirectoryEntry::tDirectory) {
+                result += countFiles(*e->openDirectory());
+            } else {
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    /* Read all objects using a fresh ObjectStore; report time. */
+    void readAll(const char* label, afl::io::FileSystem& fs, const String_t& dirName, const std::vector<ObjectId>& ids)
+    {
+        server::file::FileSystemHandler handler(fs, dirName);
+        const uint32_t start = afl::sys::Time::getTickCounter();
+        size_t totalSize = 0;
+        {
+            ObjectStore store(handler);
+            for (size_t i = 0, n = ids.size(); i < n; ++i) {
+                totalSize += store.getObject(ids[i], ObjectStore::DataObject)->get().size();
+            }
+        }
+        const uint32_t elapsed = afl::sys::Time::getTickCounter() - start;
+        std::cout << Format("%-7s read %d objects (%d bytes) in %d ms; %d files on disk\n",
+                            label, ids.size(), totalSize, elapsed, countFiles(*fs.openDirectory(dirName)));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* dirName   = (argc > 1 ? argv[1] : 0);
+    const int numObjects  = (argc > 2 ? std::atoi(argv[2]) : 20000);
+    const int maxSize     = (argc > 3 ? std::atoi(argv[3]) : 10000);
+    if (dirName == 0 || numObjects <= 0 || maxSize <= 0) {
+        std::cout << "Usage: benchpack emptydir [numObjects [maxSize]]\n";
+        return 1;
+    }
+
+    try {
+        afl::io::FileSystem& fs = afl::io::FileSystem::getInstance();
+        std::vector<ObjectId> ids;
+
+        // Create loose objects. Sizes vary, content is made unique by a prefix.
+        {
+            server::file::FileSystemHandler handler(fs, dirName);
+            ObjectStore store(handler);
+            const uint32_t start = afl::sys::Time::getTickCounter();
+            for (int i = 0; i < numObjects; ++i) {
+                String_t content = Format("object %d\n", i);
+                content.append(size_t(std::rand() % maxSize), char('a' + i % 26));
+                ids.push_back(store.addObject(ObjectStore::DataObject, afl::string::toBytes(content)));
+            }
+            std::cout << Format("created %d objects in %d ms\n", numObjects, afl::sys::Time::getTickCounter() - start);
+        }
+
+        readAll("loose", fs, dirName, ids);
+
+        // Repack
+        {
+            server::file::FileSystemHandler handler(fs, dirName);
+            ObjectStore store(handler);
+            const uint32_t start = afl::sys::Time::getTickCounter();
+            const size_t n = store.repack();
+            std::cout << Format("packed %d objects into %d packs in %d ms\n", n, store.getNumPacks(), afl::sys::Time::getTickCounter() - start);
+        }
+
+        readAll("packed", fs, dirName, ids);
+    }
+    catch (std::exception& e) {
+        std::cout << "Exception: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
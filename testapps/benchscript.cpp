@@ -0,0 +1,108 @@
+/**
+  *  \file testapps/benchscript.cpp
+  *  \brief Micro-benchmarks for the script interpreter
+  *
+  *  Runs a few arithmetic-heavy scripts and reports the time needed for each.
+  *  Use it to compare builds when changing the interpreter's execution loop or value handling.
+  */
+
+#include <cstdlib>
+#include <iostream>
+#include "afl/base/countof.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/io/textfile.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/time.hpp"
+#include "game/game.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/test/root.hpp"
+#include "game/turn.hpp"
+#include "interpreter/defaultstatementcompilationcontext.hpp"
+#include "interpreter/filecommandsource.hpp"
+#include "interpreter/statementcompiler.hpp"
+
+namespace {
+    struct Benchmark {
+        const char* name;
+        const char* code;
+    };
+
+    const Benchmark BENCHMARKS[] = {
+        { "loop",
+          "Dim i, s = 0\n"
+          "For i := 1 To 1000000 Do s := s + i\n" },
+        { "arith",
+          "Dim i, s = 0, t = 0\n"
+          "For i := 1 To 300000 Do\n"
+          "  s := s + i * 3 - 1\n"
+          "  t := (t + s) Mod 1000 + i / 7\n"
+          "Next\n" },
+        { "array",
+          "Dim a(1000), i, j, s = 0\n"
+          "For i := 0 To 999 Do a(i) := 999 - i\n"
+          "For j := 1 To 100 Do\n"
+          "  For i := 0 To 999 Do s := s + a(i)\n"
+          "Next\n" },
+        { "find",
+          "Dim i, s = 0\n"
+          "For i := 1 To 300 Do s := s + Find(Ship, Id = i, Loc.X)\n" },
+    };
+
+    void runBenchmark(game::Session& session, const Benchmark& b)
+    {
+        // Compile
+        afl::io::ConstMemoryStream ms(afl::string::toBytes(b.code));
+        afl::io::TextFile tf(ms);
+        interpreter::FileCommandSource fcs(tf);
+        interpreter::BCORef_t bco = interpreter::BytecodeObject::create(true);
+        interpreter::StatementCompiler(fcs).compileList(*bco, interpreter::DefaultStatementCompilationContext(session.world()));
+
+        // Run
+        uint32_t t0 = afl::sys::Time::getTickCounter();
+        interpreter::Process& proc = session.processList().create(session.world(), b.name);
+        proc.pushFrame(bco, false);
+        proc.run();
+        uint32_t t1 = afl::sys::Time::getTickCounter();
+
+        if (proc.getState() != interpreter::Process::Ended) {
+            std::cout << b.name << ": failed: " << proc.getError().what() << "\n";
+        } else {
+            std::cout << b.name << ": " << (t1 - t0) << " ms\n";
+        }
+        session.processList().removeTerminatedProcesses();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // Environment (ships for Find)
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    const game::PlayerSet_t S(3);
+    session.setRoot(game::test::makeRoot(game::HostVersion()).asPtr());
+    session.setShipList(new game::spec::ShipList());
+    session.setGame(new game::Game());
+    game::map::Universe& univ = session.getGame()->currentTurn().universe();
+    for (int i = 1; i <= 300; ++i) {
+        univ.ships().create(i)->addShipXYData(game::map::Point(1000 + i, 2000 - i), 3, 100, S);
+    }
+    session.postprocessTurn(session.getGame()->currentTurn(), S, S, game::map::Object::Playable);
+
+    // Run all benchmarks, or those named on the command line
+    for (size_t i = 0; i < countof(BENCHMARKS); ++i) {
+        bool want = (argc <= 1);
+        for (int j = 1; j < argc; ++j) {
+            if (String_t(argv[j]) == BENCHMARKS[i].name) {
+                want = true;
+            }
+        }
+        if (want) {
+            runBenchmark(session, BENCHMARKS[i]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,248 @@
+/**
+  *  \file testapps/benchvcr.cpp
+  *  \brief Benchmark for classic VCR playback
+  *
+  *  Plays all fights of a VCR file repeatedly, once with a NullVisualizer
+  *  (outcome only, as used by the simulator) and once with a visualizer that
+  *  receives all events (as used by the player), and reports battles per second.
+  *  Both runs must produce identical results; differences are reported.
+  */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "afl/base/ptr.hpp"
+#include "afl/charset/codepage.hpp"
+#include "afl/charset/codepagecharset.hpp"
+#include "afl/charset/utf8charset.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/environment.hpp"
+#include "afl/sys/time.hpp"
+#include "game/specificationloader.hpp"
+#include "game/v3/rootloader.hpp"
+#include "game/vcr/classic/algorithm.hpp"
+#include "game/vcr/classic/database.hpp"
+#include "game/vcr/classic/nullvisualizer.hpp"
+#include "game/vcr/classic/visualizer.hpp"
+#include "util/consolelogger.hpp"
+
+namespace {
+    using game::vcr::classic::Algorithm;
+    using game::vcr::classic::Side;
+
+    void help()
+    {
+        std::cout << "Usage: benchvcr vcrfile [rootdir [repeat]]\n";
+        std::exit(1);
+    }
+
+    /* Visualizer that receives all events, but does nothing with them */
+    class FullVisualizer : public game::vcr::classic::Visualizer {
+     public:
+        FullVisualizer()
+            : m_count(0)
+            { }
+        virtual void startFighter(Algorithm& /*algo*/, Side /*side*/, int /*track*/)
+            { ++m_count; }
+        virtual void landFighter(Algorithm& /*algo*/, Side /*side*/, int /*track*/)
+            { ++m_count; }
+        virtual void killFighter(Algorithm& /*algo*/, Side /*side*/, int /*track*/)
+            { ++m_count; }
+        virtual void fireBeam(Algorithm& /*algo*/, Side /*side*/, int /*track*/, int /*target*/, int /*hit*/, int /*damage*/, int /*kill*/)
+            { ++m_count; }
+        virtual void fireTorpedo(Algorithm& /*algo*/, Side /*side*/, int /*hit*/, int /*launcher*/)
+            { ++m_count; }
+        virtual void updateBeam(Algorithm& /*algo*/, Side /*side*/, int /*id*/)
+            { ++m_count; }
+        virtual void updateLauncher(Algorithm& /*algo*/, Side /*side*/, int /*id*/)
+            { ++m_count; }
+        virtual void killObject(Algorithm& /*algo*/, Side /*side*/)
+            { ++m_count; }
+        long getCount() const
+            { return m_count; }
+     private:
+        long m_count;
+    };
+
+    /* Outcome of a fight */
+    struct Outcome {
+        int result;
+        int time;
+        int shield[2];
+        int damage[2];
+        int crew[2];
+        int torpedoes[2];
+        int fighters[2];
+
+        bool operator==(const Outcome& other) const
+            {
+                for (int i = 0; i < 2; ++i) {
+                    if (shield[i] != other.shield[i] || damage[i] != other.damage[i] || crew[i] != other.crew[i]
+                        || torpedoes[i] != other.torpedoes[i] || fighters[i] != other.fighters[i])
+                    {
+                        return false;
+                    }
+                }
+                return result == other.result && time == other.time;
+            }
+    };
+
+    /* Play one fight. Returns false if the fight cannot be played. */
+    bool playFight(game::vcr::classic::Battle& en, game::vcr::classic::Visualizer& vis, game::Root& root, const game::spec::ShipList& shipList, Outcome& out)
+    {
+        std::auto_ptr<Algorithm> algo(en.createAlgorithm(vis, root.hostConfiguration(), shipList));
+        if (algo.get() == 0 || !algo->setCapabilities(en.getCapabilities())) {
+            return false;
+        }
+
+        game::vcr::Object left(*en.getObject(0, false));
+        game::vcr::Object right(*en.getObject(1, false));
+        uint16_t seed(en.getSeed());
+        if (algo->checkBattle(left, right, seed)) {
+            return false;
+        }
+
+        algo->playBattle(left, right, seed);
+        algo->doneBattle(left, right);
+
+        const game::vcr::Object* objs[] = { &left, &right };
+        out.result = algo->getResult().toInteger();
+        out.time = algo->getTime();
+        for (int i = 0; i < 2; ++i) {
+            out.shield[i]    = objs[i]->getShield();
+            out.damage[i]    = objs[i]->getDamage();
+            out.crew[i]      = objs[i]->getCrew();
+            out.torpedoes[i] = objs[i]->getNumTorpedoes();
+            out.fighters[i]  = objs[i]->getNumFighters();
+        }
+        return true;
+    }
+
+    void report(const char* name, int numBattles, uint32_t ms)
+    {
+        std::cout << name << ": " << numBattles << " battles in " << ms << " ms";
+        if (ms != 0) {
+            std::cout << ", " << (1000.0 * numBattles / ms) << " battles/sec";
+        }
+        std::cout << "\n";
+    }
+}
+
+int
+main(int, char** argv)
+{
+    const char* file = 0;
+    const char* dir = 0;
+    bool repeat_set = false;
+    int repeat = 100;
+
+    while (const char* p = *++argv) {
+        if (!file) {
+            file = p;
+        } else if (!dir) {
+            dir = p;
+        } else if (!repeat_set) {
+            repeat_set = true;
+            repeat = std::atoi(p);
+            if (repeat <= 0) {
+                help();
+            }
+        } else {
+            help();
+        }
+    }
+
+    if (!file) {
+        help();
+    }
+
+    try {
+        // Root loader
+        afl::sys::Environment& env = afl::sys::Environment::getInstance(argv);
+        afl::io::FileSystem& fs = afl::io::FileSystem::getInstance();
+        afl::string::NullTranslator tx;
+        util::ConsoleLogger logger;
+        afl::charset::Utf8Charset cs;
+        game::v3::RootLoader loader(fs.openDirectory(fs.makePathName(fs.makePathName(env.getInstallationDirectoryName(), "share"), "specs")),
+                                    0, 0,
+                                    tx, logger,
+                                    fs);
+
+        // Root
+        afl::base::Ptr<game::Root> root(loader.load(fs.openDirectory(dir ? dir : "."),
+                                                    cs,
+                                                    game::config::UserConfiguration(),
+                                                    true));
+        if (root.get() == 0) {
+            std::cerr << "No game data found.\n";
+            return 1;
+        }
+
+        // Specification
+        game::spec::ShipList shipList;
+        root->specificationLoader().loadShipList(shipList, *root, std::auto_ptr<game::StatusTask_t>(game::StatusTask_t::makeNull()))->call();
+
+        // Load VCRs
+        afl::base::Ref<afl::io::Stream> vcrFile = fs.openFile(file, afl::io::FileSystem::OpenRead);
+        game::vcr::classic::Database db;
+        afl::charset::CodepageCharset charset(afl::charset::g_codepageLatin1);
+        db.load(*vcrFile, root->hostConfiguration(), charset);
+        std::cout << "VCR file contains " << db.getNumBattles() << " entries\n";
+
+        // Outcome only
+        std::vector<Outcome> fastOutcomes(db.getNumBattles());
+        std::vector<bool> valid(db.getNumBattles());
+        int numFast = 0;
+        uint32_t t0 = afl::sys::Time::getTickCounter();
+        for (int rc = 0; rc < repeat; ++rc) {
+            for (size_t i = 0; i < db.getNumBattles(); ++i) {
+                if (game::vcr::classic::Battle* en = db.getBattle(i)) {
+                    game::vcr::classic::NullVisualizer vis;
+                    valid[i] = playFight(*en, vis, *root, shipList, fastOutcomes[i]);
+                    ++numFast;
+                }
+            }
+        }
+        uint32_t t1 = afl::sys::Time::getTickCounter();
+        report("Outcome only", numFast, t1 - t0);
+
+        // Full visualisation
+        FullVisualizer fullVis;
+        int numFull = 0;
+        int numDifferent = 0;
+        t0 = afl::sys::Time::getTickCounter();
+        for (int rc = 0; rc < repeat; ++rc) {
+            for (size_t i = 0; i < db.getNumBattles(); ++i) {
+                if (game::vcr::classic::Battle* en = db.getBattle(i)) {
+                    Outcome out;
+                    bool ok = playFight(*en, fullVis, *root, shipList, out);
+                    if (ok != valid[i] || (ok && !(out == fastOutcomes[i]))) {
+                        if (rc == 0) {
+                            std::cout << "Record #" << (i+1) << ": results differ\n";
+                        }
+                        ++numDifferent;
+                    }
+                    ++numFull;
+                }
+            }
+        }
+        t1 = afl::sys::Time::getTickCounter();
+        report("Full", numFull, t1 - t0);
+        std::cout << fullVis.getCount() << " visualizer events\n";
+
+        if (numDifferent != 0) {
+            std::cout << numDifferent << " differences\n";
+            return 1;
+        }
+    }
+    catch (afl::except::FileProblemException& e) {
+        std::cout << "Exception: " << e.getFileName() << ": " << e.what() << "\n";
+        return 1;
+    }
+    catch (std::exception& e) {
+        std::cout << "Exception: " << e.what() << "\n";
+        return 1;
+    }
+}
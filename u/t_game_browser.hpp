@@ -14,6 +14,15 @@ class TestGameBrowserAccount : public CxxTest::TestSuite {
     void testEncode();
 };
 
+class TestGameBrowserFileCache : public CxxTest::TestSuite {
+ public:
+    void testBasic();
+    void testPersistence();
+    void testLimit();
+    void testDamaged();
+    void testValue();
+};
+
 class TestGameBrowserFolder : public CxxTest::TestSuite {
  public:
     void testIt();
@@ -0,0 +1,185 @@
+/**
+  *  \file u/t_game_browser_filecache.cpp
+  *  \brief Test for game::browser::FileCache
+  */
+
+#include "game/browser/filecache.hpp"
+
+#include "t_game_browser.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/data/access.hpp"
+#include "afl/data/hash.hpp"
+#include "afl/data/hashvalue.hpp"
+#include "afl/data/integervalue.hpp"
+#include "afl/data/stringvalue.hpp"
+#include "afl/io/filesystem.hpp"
+#include "afl/io/internalfilesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/internalenvironment.hpp"
+#include "afl/sys/log.hpp"
+
+using afl::base::Ptr;
+using afl::io::FileMapping;
+using afl::io::FileSystem;
+using game::browser::FileCache;
+
+namespace {
+    String_t getContent(Ptr<FileMapping> p)
+    {
+        TS_ASSERT(p.get() != 0);
+        return p.get() != 0 ? afl::string::fromBytes(p->get()) : String_t();
+    }
+
+    String_t getBlobName(const String_t& content)
+    {
+        afl::checksums::SHA1 hasher;
+        hasher.add(afl::string::toBytes(content));
+        return "/profile/cache/test/" + hasher.getHashAsHexString();
+    }
+}
+
+/** Test basic operations.
+    A: store files, retrieve them with different validators.
+    E: validators are checked; empty validator accepts any version. */
+void
+TestGameBrowserFileCache::testBasic()
+{
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::InternalFileSystem fs;
+    afl::sys::InternalEnvironment env;
+    fs.createDirectory("/profile");
+    env.setSettingsDirectoryName("/profile");
+    util::ProfileDirectory profile(env, fs, tx, log);
+    FileCache testee(profile, "test", log, tx);
+
+    // Initially empty
+    TS_ASSERT(testee.getFile("a", "v1").get() == 0);
+    TS_ASSERT(testee.getFile("a", "").get() == 0);
+    TS_ASSERT(!testee.hasFile("a", ""));
+
+    // Store
+    testee.putFile("a", "v1", afl::string::toBytes("content"));
+    TS_ASSERT_EQUALS(getContent(testee.getFile("a", "v1")), "content");
+    TS_ASSERT_EQUALS(getContent(testee.getFile("a", "")), "content");
+    TS_ASSERT(testee.getFile("a", "v2").get() == 0);
+    TS_ASSERT(testee.hasFile("a", "v1"));
+    TS_ASSERT(!testee.hasFile("a", "v2"));
+    TS_ASSERT(!testee.hasFile("b", ""));
+
+    // Replace
+    testee.putFile("a", "v2", afl::string::toBytes("new content"));
+    TS_ASSERT(testee.getFile("a", "v1").get() == 0);
+    TS_ASSERT_EQUALS(getContent(testee.getFile("a", "v2")), "new content");
+
+    // Content is stored in the profile, by hash; old content has been removed
+    TS_ASSERT(fs.openFileNT(getBlobName("new content"), FileSystem::OpenRead).get() != 0);
+    TS_ASSERT(fs.openFileNT(getBlobName("content"), FileSystem::OpenRead).get() == 0);
+}
+
+/** Test persistence.
+    A: store files, create new instance.
+    E: files are still available. */
+void
+TestGameBrowserFileCache::testPersistence()
+{
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::InternalFileSystem fs;
+    afl::sys::InternalEnvironment env;
+    fs.createDirectory("/profile");
+    env.setSettingsDirectoryName("/profile");
+    util::ProfileDirectory profile(env, fs, tx, log);
+    {
+        FileCache testee(profile, "test", log, tx);
+        testee.putFile("dir/file.dat", "v1", afl::string::toBytes("one"));
+        testee.putFile("dir/other.dat", "", afl::string::toBytes("two"));
+    }
+    {
+        FileCache testee(profile, "test", log, tx);
+        TS_ASSERT_EQUALS(getContent(testee.getFile("dir/file.dat", "v1")), "one");
+        TS_ASSERT_EQUALS(getContent(testee.getFile("dir/other.dat", "")), "two");
+        TS_ASSERT(testee.getFile("dir/other.dat", "v1").get() == 0);
+    }
+}
+
+/** Test entry limit.
+    A: set limit, store more files than the limit.
+    E: least recently used files are discarded; shared content is kept while referenced. */
+void
+TestGameBrowserFileCache::testLimit()
+{
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::InternalFileSystem fs;
+    afl::sys::InternalEnvironment env;
+    fs.createDirectory("/profile");
+    env.setSettingsDirectoryName("/profile");
+    util::ProfileDirectory profile(env, fs, tx, log);
+    FileCache testee(profile, "test", log, tx);
+    testee.setMaxEntries(2);
+
+    testee.putFile("a", "", afl::string::toBytes("same"));
+    testee.putFile("b", "", afl::string::toBytes("same"));
+    testee.putFile("c", "", afl::string::toBytes("other"));
+
+    // "a" is gone; "b" still has the content
+    TS_ASSERT(!testee.hasFile("a", ""));
+    TS_ASSERT_EQUALS(getContent(testee.getFile("b", "")), "same");
+
+    // Accessing "b" makes it most recent, so "c" is discarded next
+    testee.putFile("d", "", afl::string::toBytes("fourth"));
+    TS_ASSERT(testee.hasFile("b", ""));
+    TS_ASSERT(!testee.hasFile("c", ""));
+    TS_ASSERT(fs.openFileNT(getBlobName("other"), FileSystem::OpenRead).get() == 0);
+}
+
+/** Test damaged content.
+    A: store a file, modify its content on disk.
+    E: file is no longer reported. */
+void
+TestGameBrowserFileCache::testDamaged()
+{
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::InternalFileSystem fs;
+    afl::sys::InternalEnvironment env;
+    fs.createDirectory("/profile");
+    env.setSettingsDirectoryName("/profile");
+    util::ProfileDirectory profile(env, fs, tx, log);
+    FileCache testee(profile, "test", log, tx);
+    testee.putFile("a", "v", afl::string::toBytes("content"));
+
+    fs.openFile(getBlobName("content"), FileSystem::Create)->fullWrite(afl::string::toBytes("garbage"));
+    TS_ASSERT(testee.getFile("a", "v").get() == 0);
+    TS_ASSERT(!testee.hasFile("a", ""));
+}
+
+/** Test JSON values.
+    A: store a value, retrieve it.
+    E: same value retrieved. */
+void
+TestGameBrowserFileCache::testValue()
+{
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::InternalFileSystem fs;
+    afl::sys::InternalEnvironment env;
+    fs.createDirectory("/profile");
+    env.setSettingsDirectoryName("/profile");
+    util::ProfileDirectory profile(env, fs, tx, log);
+    FileCache testee(profile, "test", log, tx);
+
+    afl::base::Ref<afl::data::Hash> h = afl::data::Hash::create();
+    h->setNew("result", new afl::data::IntegerValue(1));
+    h->setNew("name", new afl::data::StringValue("x y"));
+    afl::data::HashValue hv(h);
+    testee.putValue("k", "", &hv);
+
+    std::auto_ptr<afl::data::Value> result(testee.getValue("k", ""));
+    afl::data::Access a(result);
+    TS_ASSERT_EQUALS(a("result").toInteger(), 1);
+    TS_ASSERT_EQUALS(a("name").toString(), "x y");
+
+    TS_ASSERT(testee.getValue("other", "").get() == 0);
+}
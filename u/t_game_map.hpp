@@ -210,6 +210,12 @@ class TestGameMapLocation : public CxxTest::TestSuite {
     void testGetOtherPositionUfo();
 };
 
+class TestGameMapLocationIndex : public CxxTest::TestSuite {
+ public:
+    void testPoint();
+    void testRange();
+};
+
 class TestGameMapLocationReverter : public CxxTest::TestSuite {
  public:
     void testInterface();
@@ -749,6 +755,7 @@ class TestGameMapUniverse : public CxxTest::TestSuite {
     void testBasics();
     void testGetObject();
     void testFind();
+    void testLocationIndex();
 };
 
 class TestGameMapViewport : public CxxTest::TestSuite {
@@ -0,0 +1,114 @@
+/**
+  *  \file u/t_game_map_locationindex.cpp
+  *  \brief Test for game::map::LocationIndex
+  */
+
+#include "game/map/locationindex.hpp"
+
+#include "t_game_map.hpp"
+#include "afl/string/format.hpp"
+#include "game/map/configuration.hpp"
+
+using game::Id_t;
+using game::map::Configuration;
+using game::map::LocationIndex;
+using game::map::Point;
+
+namespace {
+    String_t toString(const std::vector<Id_t>& ids)
+    {
+        String_t result;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (i != 0) {
+                result += ",";
+            }
+            result += afl::string::Format("%d", ids[i]);
+        }
+        return result;
+    }
+}
+
+/** Test point and rectangle queries. */
+void
+TestGameMapLocationIndex::testPoint()
+{
+    LocationIndex testee;
+    testee.add(7, Point(1000, 1000));
+    testee.add(3, Point(1000, 1000));
+    testee.add(5, Point(1001, 1000));
+    testee.add(9, Point(2500, 1800));
+    testee.add(1, Point(-100, -50));
+    testee.sort();
+    TS_ASSERT_EQUALS(testee.size(), 5U);
+
+    // Point queries; results sorted by Id
+    std::vector<Id_t> ids;
+    testee.findAt(Point(1000, 1000), ids);
+    TS_ASSERT_EQUALS(toString(ids), "3,7");
+
+    ids.clear();
+    testee.findAt(Point(1000, 1001), ids);
+    TS_ASSERT_EQUALS(toString(ids), "");
+
+    ids.clear();
+    testee.findAt(Point(-100, -50), ids);
+    TS_ASSERT_EQUALS(toString(ids), "1");
+
+    // Rectangle queries, spanning multiple cells; corners in any order
+    ids.clear();
+    testee.findInRectangle(Point(2500, 1800), Point(1000, 1000), ids);
+    TS_ASSERT_EQUALS(toString(ids), "3,5,7,9");
+
+    ids.clear();
+    testee.findInRectangle(Point(1001, 0), Point(-1000, 1000), ids);
+    TS_ASSERT_EQUALS(toString(ids), "1,3,5,7");
+
+    // Results are appended
+    testee.findAt(Point(2500, 1800), ids);
+    TS_ASSERT_EQUALS(toString(ids), "1,3,5,7,9");
+
+    // Clear
+    testee.clear();
+    TS_ASSERT_EQUALS(testee.size(), 0U);
+    ids.clear();
+    testee.findAt(Point(1000, 1000), ids);
+    TS_ASSERT_EQUALS(toString(ids), "");
+}
+
+/** Test range queries. */
+void
+TestGameMapLocationIndex::testRange()
+{
+    LocationIndex testee;
+    testee.add(1, Point(1000, 1000));
+    testee.add(2, Point(1003, 1003));
+    testee.add(3, Point(2995, 2000));
+    testee.add(4, Point(1500, 1500));
+    testee.sort();
+
+    // Flat map
+    Configuration flat;
+    std::vector<Id_t> ids;
+    testee.findInRange(Point(1002, 1001), 3, flat, ids);
+    TS_ASSERT_EQUALS(toString(ids), "1,2");
+
+    ids.clear();
+    testee.findInRange(Point(1002, 1001), 1, flat, ids);
+    TS_ASSERT_EQUALS(toString(ids), "");
+
+    ids.clear();
+    testee.findInRange(Point(1001, 2000), 10, flat, ids);
+    TS_ASSERT_EQUALS(toString(ids), "");
+
+    // Wrapped map: #3 is near the left border when wrapping
+    Configuration wrap;
+    wrap.setConfiguration(Configuration::Wrapped, Point(2000, 2000), Point(2000, 2000));
+    ids.clear();
+    testee.findInRange(Point(1001, 2000), 10, wrap, ids);
+    TS_ASSERT_EQUALS(toString(ids), "3");
+
+    // Large range covering everything, no duplicates
+    ids.clear();
+    testee.findInRange(Point(2000, 2000), 1500, wrap, ids);
+    TS_ASSERT_EQUALS(toString(ids), "1,2,3,4");
+}
@@ -255,3 +255,40 @@ TestGameMapUniverse::testFind()
     TS_ASSERT_EQUALS(u.findLocationUnitNames(Point(1020, 1000), 4, pl, mapConfig, tx, iface), "Planet #40: Fourty\nShip #8: Eight");
 }
 
+
+/** Test location index maintenance. */
+void
+TestGameMapUniverse::testLocationIndex()
+{
+    const game::map::Configuration mapConfig;
+    game::HostVersion host(game::HostVersion::PHost, MKVERSION(3,2,5));
+    HostConfiguration config;
+    game::spec::ShipList sl;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+
+    Universe u;
+    u.planets().create(10)->setPosition(Point(1000, 1000));
+    u.planets().create(20)->setPosition(Point(1200, 1000));
+    u.postprocess(game::PlayerSet_t(5), game::PlayerSet_t(5), game::map::Object::Playable, mapConfig, host, config, 7, sl, tx, log);
+    TS_ASSERT_EQUALS(u.findPlanetAt(Point(1000, 1000)), 10);
+    TS_ASSERT_EQUALS(u.findPlanetAt(Point(1200, 1000)), 20);
+    TS_ASSERT_EQUALS(u.planetLocations().size(), 2U);
+
+    // Adding an object is picked up
+    u.planets().create(30)->setPosition(Point(1300, 1000));
+    u.postprocess(game::PlayerSet_t(5), game::PlayerSet_t(5), game::map::Object::Playable, mapConfig, host, config, 7, sl, tx, log);
+    TS_ASSERT_EQUALS(u.findPlanetAt(Point(1300, 1000)), 30);
+
+    // Moving an object is picked up after markChanged()
+    u.planets().get(10)->setPosition(Point(1100, 1000));
+    u.markChanged();
+    TS_ASSERT_EQUALS(u.findPlanetAt(Point(1000, 1000)), 0);
+    TS_ASSERT_EQUALS(u.findPlanetAt(Point(1100, 1000)), 10);
+
+    // Ships
+    u.ships().create(5)->addShipXYData(Point(1100, 1000), 4, 100, game::PlayerSet_t(5));
+    u.postprocess(game::PlayerSet_t(5), game::PlayerSet_t(5), game::map::Object::Playable, mapConfig, host, config, 7, sl, tx, log);
+    TS_ASSERT_EQUALS(u.findFirstShipAt(Point(1100, 1000)), 5);
+    TS_ASSERT_EQUALS(u.shipLocations().size(), 1U);
+}
@@ -60,6 +60,8 @@ class TestGameParserMessageParser : public CxxTest::TestSuite {
     void testTimAllies();
     void testFailId();
     void testMarker();
+    void testKindIndex();
+    void testParseMessages();
 };
 
 class TestGameParserMessageTemplate : public CxxTest::TestSuite {
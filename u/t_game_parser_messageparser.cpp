@@ -727,3 +727,133 @@ TestGameParserMessageParser::testMarker()
     TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_DrawingShape, "shape"), 3);
     TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_Color, "color"), 5);
 }
+
+/** Test template selection by message kind.
+    A: define templates with and without kind restriction, all with continue flag. Parse messages of different kinds.
+    E: for each message, exactly the templates matching its kind or accepting any kind are applied, in definition order. */
+void
+TestGameParserMessageParser::testKindIndex()
+{
+    const char* FILE =
+        "marker,Any\n"
+        "  continue = yes\n"
+        "  check  = Hello\n"
+        "  values = 1, 1, 1\n"
+        "  assign = X, Y, Color\n"
+        "marker,Kind R\n"
+        "  kind   = r\n"
+        "  continue = yes\n"
+        "  check  = Hello\n"
+        "  values = 2, 2, 2\n"
+        "  assign = X, Y, Color\n"
+        "marker,Kind G\n"
+        "  kind   = g\n"
+        "  continue = yes\n"
+        "  check  = Hello\n"
+        "  values = 3, 3, 3\n"
+        "  assign = X, Y, Color\n"
+        "marker,Any again\n"
+        "  continue = yes\n"
+        "  check  = Hello\n"
+        "  values = 4, 4, 4\n"
+        "  assign = X, Y, Color\n";
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::ConstMemoryStream ms(afl::string::toBytes(FILE));
+
+    // Load
+    game::parser::MessageParser testee;
+    TS_ASSERT_THROWS_NOTHING(testee.load(ms, tx, log));
+    TS_ASSERT_EQUALS(testee.getNumTemplates(), 4U);
+    MockDataInterface ifc;
+
+    // Kind r
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        TS_ASSERT_THROWS_NOTHING(testee.parseMessage("(-r1000)Hello\n", ifc, 30, info, tx, log));
+        TS_ASSERT_EQUALS(info.size(), 3U);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_Color, "color 0"), 1);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[1], game::parser::mi_Color, "color 1"), 2);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[2], game::parser::mi_Color, "color 2"), 4);
+    }
+
+    // Kind g
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        TS_ASSERT_THROWS_NOTHING(testee.parseMessage("(-g0000)Hello\n", ifc, 30, info, tx, log));
+        TS_ASSERT_EQUALS(info.size(), 3U);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_Color, "color 0"), 1);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[1], game::parser::mi_Color, "color 1"), 3);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[2], game::parser::mi_Color, "color 2"), 4);
+    }
+
+    // Other kind
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        TS_ASSERT_THROWS_NOTHING(testee.parseMessage("(-x0000)Hello\n", ifc, 30, info, tx, log));
+        TS_ASSERT_EQUALS(info.size(), 2U);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_Color, "color 0"), 1);
+        TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[1], game::parser::mi_Color, "color 1"), 4);
+    }
+
+    // No header
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        TS_ASSERT_THROWS_NOTHING(testee.parseMessage("Hello\n", ifc, 30, info, tx, log));
+        TS_ASSERT_EQUALS(info.size(), 2U);
+    }
+}
+
+/** Test parseMessages().
+    A: parse a list of messages with multiple threads.
+    E: result is identical to parsing each message individually, in message order. */
+void
+TestGameParserMessageParser::testParseMessages()
+{
+    const char* FILE =
+        "marker,Test\n"
+        "  check  = Distress call\n"
+        "  check  = starship at:\n"
+        "  parse  = +1,( $, $ )\n"
+        "  assign = X, Y\n"
+        "  values = 3, 5\n"
+        "  assign = Shape, Color\n";
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::ConstMemoryStream ms(afl::string::toBytes(FILE));
+
+    // Load
+    game::parser::MessageParser testee;
+    TS_ASSERT_THROWS_NOTHING(testee.load(ms, tx, log));
+    MockDataInterface ifc;
+
+    // Messages; every third one does not match
+    std::vector<String_t> messages;
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            messages.push_back("(-r1000)<<< Sub Space Message >>>\nHi\n");
+        } else {
+            messages.push_back(afl::string::Format("(-x0005)<< Long Range Sensors >>\n"
+                                                   "Distress call and explosion\n"
+                                                   "detected from a starship at:\n"
+                                                   "( %d , 2728 )\n", 1000 + i));
+        }
+    }
+
+    // Parse
+    afl::container::PtrVector<afl::container::PtrVector<game::parser::MessageInformation> > result;
+    TS_ASSERT_THROWS_NOTHING(testee.parseMessages(messages, ifc, 30, result, tx, log, 4));
+
+    // Verify
+    TS_ASSERT_EQUALS(result.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        const afl::container::PtrVector<game::parser::MessageInformation>& info = *result[i];
+        if (i % 3 == 0) {
+            TS_ASSERT_EQUALS(info.size(), 0U);
+        } else {
+            TS_ASSERT_EQUALS(info.size(), 1U);
+            TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_X, "X"), int32_t(1000 + i));
+            TS_ASSERT_EQUALS(getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_Y, "Y"), 2728);
+        }
+    }
+}
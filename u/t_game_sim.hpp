@@ -91,6 +91,7 @@ class TestGameSimResultList : public CxxTest::TestSuite {
     void testDescribe();
     void testDescribe2();
     void testToString();
+    void testPrecision();
 };
 
 class TestGameSimRun : public CxxTest::TestSuite {
@@ -148,6 +149,7 @@ class TestGameSimRunner : public CxxTest::TestSuite {
     void testRegression1();
     void testRegression2();
     void testInterrupt();
+    void testPrecision();
 };
 
 class TestGameSimSession : public CxxTest::TestSuite {
@@ -199,6 +201,20 @@ class TestGameSimStructures : public CxxTest::TestSuite {
     void testHeader();
 };
 
+class TestGameSimSweep : public CxxTest::TestSuite {
+ public:
+    void testEmpty();
+    void testParse();
+    void testErrors();
+    void testBuild();
+};
+
+class TestGameSimSweepRunner : public CxxTest::TestSuite {
+ public:
+    void testIt();
+    void testSingleVariant();
+};
+
 class TestGameSimTransfer : public CxxTest::TestSuite {
  public:
     void testCopyFromEmptyShip();
@@ -389,3 +389,39 @@ TestGameSimResultList::testToString()
     }
 }
 
+
+/** Test getPrecision(), getEffectiveNumBattles().
+    A: add results of two classes.
+    E: precision improves with number of battles; a result list containing a single battle is not precise */
+void
+TestGameSimResultList::testPrecision()
+{
+    Setup before; addShip(before, 1, 0, 10);    addShip(before, 2, 0, 10);
+    Setup after1; addShip(after1, 1, 30, 10);   addShip(after1, 0, 100, 10);
+    Setup after2; addShip(after2, 0, 100, 10);  addShip(after2, 2, 50, 10);
+    Statistic stats[] = { makeStatistic(8), makeStatistic(18) };
+
+    // Single battle
+    game::sim::ResultList testee;
+    testee.addResult(before, after1, stats, makeResult(0));  // 0 to initialize
+    TS_ASSERT_EQUALS(testee.getEffectiveNumBattles(), 1.0);
+    TS_ASSERT_EQUALS(testee.getPrecision(), 1.0);
+
+    // Ten battles, alternating results
+    for (int i = 1; i < 10; ++i) {
+        testee.addResult(before, (i % 2) != 0 ? after2 : after1, stats, makeResult(i));
+    }
+    TS_ASSERT_DELTA(testee.getEffectiveNumBattles(), 10.0, 0.0001);
+    double p10 = testee.getPrecision();
+    TS_ASSERT(p10 > 0.25);
+    TS_ASSERT(p10 < 0.35);
+
+    // 1000 battles; precision improves by about sqrt(100)
+    for (int i = 10; i < 1000; ++i) {
+        testee.addResult(before, (i % 2) != 0 ? after2 : after1, stats, makeResult(i));
+    }
+    TS_ASSERT_DELTA(testee.getEffectiveNumBattles(), 1000.0, 0.0001);
+    double p1000 = testee.getPrecision();
+    TS_ASSERT(p1000 > 0.025);
+    TS_ASSERT(p1000 < 0.035);
+}
@@ -307,3 +307,60 @@ TestGameSimRunner::testInterrupt()
     checkInterrupt("SimpleRunner", parallelRunner);
 }
 
+
+/** Test precision limit.
+    A: create a Runner for a fight with varying outcome. Run with a precision limit.
+    E: runner stops when precision has been reached, not at the maximum count */
+void
+TestGameSimRunner::testPrecision()
+{
+    // Ship list
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+    game::test::addOutrider(shipList);
+    game::test::addTranswarp(shipList);
+
+    // Setup
+    game::sim::Setup setup;
+    addOutrider(setup, 1, 4, shipList);
+    addOutrider(setup, 2, 6, shipList);
+
+    // Host configuration
+    game::config::HostConfiguration config;
+    game::vcr::flak::Configuration flakConfiguration;
+
+    // Configuration
+    game::sim::Configuration opts;
+    opts.setMode(game::sim::Configuration::VcrHost, 0, config);
+
+    // Stop signal (not used)
+    util::StopSignal sig;
+
+    // Logger (not used)
+    afl::sys::Log log;
+
+    // SimpleRunner
+    util::RandomNumberGenerator simpleRNG(77);
+    game::sim::SimpleRunner simpleRunner(setup, opts, shipList, config, flakConfiguration, log, simpleRNG);
+    simpleRunner.init();
+    simpleRunner.run(simpleRunner.makePrecisionLimit(0.1, 5000), sig);
+    TS_ASSERT(simpleRunner.resultList().getPrecision() <= 0.1);
+    TS_ASSERT(simpleRunner.resultList().getNumBattles() > 1U);
+    TS_ASSERT(simpleRunner.resultList().getNumBattles() < 5000U);
+
+    // ParallelRunner
+    util::RandomNumberGenerator parallelRNG(77);
+    game::sim::ParallelRunner parallelRunner(setup, opts, shipList, config, flakConfiguration, log, parallelRNG, 3);
+    parallelRunner.init();
+    parallelRunner.run(parallelRunner.makePrecisionLimit(0.1, 5000), sig);
+    TS_ASSERT(parallelRunner.resultList().getPrecision() <= 0.1);
+    TS_ASSERT(parallelRunner.resultList().getNumBattles() < 5000U);
+
+    // Maximum count is honored
+    util::RandomNumberGenerator limitRNG(77);
+    game::sim::SimpleRunner limitRunner(setup, opts, shipList, config, flakConfiguration, log, limitRNG);
+    limitRunner.init();
+    limitRunner.run(limitRunner.makePrecisionLimit(0.0001, 10), sig);
+    TS_ASSERT_EQUALS(limitRunner.resultList().getNumBattles(), 11U);
+}
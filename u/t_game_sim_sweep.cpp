@@ -0,0 +1,128 @@
+/**
+  *  \file u/t_game_sim_sweep.cpp
+  *  \brief Test for game::sim::Sweep
+  */
+
+#include "game/sim/sweep.hpp"
+
+#include "t_game_sim.hpp"
+#include "game/sim/planet.hpp"
+#include "game/sim/setup.hpp"
+#include "game/sim/ship.hpp"
+
+/** Test empty sweep.
+    A: create empty Sweep.
+    E: one variant, identical to base setup */
+void
+TestGameSimSweep::testEmpty()
+{
+    game::sim::Sweep testee;
+    TS_ASSERT_EQUALS(testee.getNumParameters(), 0U);
+    TS_ASSERT_EQUALS(testee.getNumVariants(), 1U);
+    TS_ASSERT_EQUALS(testee.getParameterName(0), "");
+
+    game::sim::Setup setup;
+    TS_ASSERT(testee.buildVariant(0, setup));
+}
+
+/** Test parsing parameters.
+    A: add parameters with lists and ranges.
+    E: correct number of variants and values; last parameter varies fastest */
+void
+TestGameSimSweep::testParse()
+{
+    game::sim::Sweep testee;
+    TS_ASSERT(testee.addParameter("12:ammo=10..50/10"));
+    TS_ASSERT(testee.addParameter("12:fcode=abc,NUK"));
+    TS_ASSERT(testee.addParameter("planet:defense=5,1..2"));
+
+    TS_ASSERT_EQUALS(testee.getNumParameters(), 3U);
+    TS_ASSERT_EQUALS(testee.getNumVariants(), 30U);
+    TS_ASSERT_EQUALS(testee.getParameterName(0), "12:ammo");
+    TS_ASSERT_EQUALS(testee.getParameterName(1), "12:fcode");
+    TS_ASSERT_EQUALS(testee.getParameterName(2), "planet:defense");
+
+    TS_ASSERT_EQUALS(testee.getVariantValue(0, 0), "10");
+    TS_ASSERT_EQUALS(testee.getVariantValue(0, 1), "abc");
+    TS_ASSERT_EQUALS(testee.getVariantValue(0, 2), "5");
+
+    TS_ASSERT_EQUALS(testee.getVariantValue(1, 0), "10");
+    TS_ASSERT_EQUALS(testee.getVariantValue(1, 1), "abc");
+    TS_ASSERT_EQUALS(testee.getVariantValue(1, 2), "1");
+
+    TS_ASSERT_EQUALS(testee.getVariantValue(3, 0), "10");
+    TS_ASSERT_EQUALS(testee.getVariantValue(3, 1), "NUK");
+    TS_ASSERT_EQUALS(testee.getVariantValue(3, 2), "5");
+
+    TS_ASSERT_EQUALS(testee.getVariantValue(29, 0), "50");
+    TS_ASSERT_EQUALS(testee.getVariantValue(29, 1), "NUK");
+    TS_ASSERT_EQUALS(testee.getVariantValue(29, 2), "2");
+}
+
+/** Test parsing errors.
+    A: add invalid parameters.
+    E: addParameter() fails, sweep unchanged */
+void
+TestGameSimSweep::testErrors()
+{
+    game::sim::Sweep testee;
+    TS_ASSERT(!testee.addParameter(""));
+    TS_ASSERT(!testee.addParameter("12:ammo"));
+    TS_ASSERT(!testee.addParameter("ammo=10"));
+    TS_ASSERT(!testee.addParameter("12:foo=10"));
+    TS_ASSERT(!testee.addParameter("x:ammo=10"));
+    TS_ASSERT(!testee.addParameter("planet:ammo=10"));
+    TS_ASSERT(!testee.addParameter("12:defense=10"));
+    TS_ASSERT(!testee.addParameter("12:ammo=x"));
+    TS_ASSERT(!testee.addParameter("12:ammo=10..5"));
+    TS_ASSERT(!testee.addParameter("12:ammo=1..5/0"));
+    TS_ASSERT(!testee.addParameter("12:ammo=1,,2"));
+    TS_ASSERT(!testee.addParameter("12:fcode=abcd"));
+    TS_ASSERT(!testee.addParameter("12:ammo=1..1000000"));
+    TS_ASSERT_EQUALS(testee.getNumVariants(), 1U);
+
+    // Too many variants in total
+    TS_ASSERT(testee.addParameter("12:ammo=1..1000"));
+    TS_ASSERT(!testee.addParameter("13:ammo=1..1000"));
+    TS_ASSERT_EQUALS(testee.getNumVariants(), 1000U);
+}
+
+/** Test building variants.
+    A: create setup and sweep. Build variants.
+    E: units modified as expected; error if unit does not exist */
+void
+TestGameSimSweep::testBuild()
+{
+    game::sim::Setup base;
+    game::sim::Ship* sh = base.addShip();
+    sh->setId(12);
+    sh->setAmmo(3);
+    sh->setFriendlyCode("xyz");
+    game::sim::Planet* pl = base.addPlanet();
+    pl->setDefense(7);
+
+    game::sim::Sweep testee;
+    TS_ASSERT(testee.addParameter("12:aggressiveness=kill,passive,5"));
+    TS_ASSERT(testee.addParameter("planet:defense=10..20/10"));
+    TS_ASSERT_EQUALS(testee.getNumVariants(), 6U);
+
+    {
+        game::sim::Setup v(base);
+        TS_ASSERT(testee.buildVariant(0, v));
+        TS_ASSERT_EQUALS(v.findShipById(12)->getAggressiveness(), game::sim::Ship::agg_Kill);
+        TS_ASSERT_EQUALS(v.findShipById(12)->getAmmo(), 3);
+        TS_ASSERT_EQUALS(v.findShipById(12)->getFriendlyCode(), "xyz");
+        TS_ASSERT_EQUALS(v.getPlanet()->getDefense(), 10);
+    }
+    {
+        game::sim::Setup v(base);
+        TS_ASSERT(testee.buildVariant(5, v));
+        TS_ASSERT_EQUALS(v.findShipById(12)->getAggressiveness(), 5);
+        TS_ASSERT_EQUALS(v.getPlanet()->getDefense(), 20);
+    }
+
+    // Missing unit
+    TS_ASSERT(testee.addParameter("13:ammo=1"));
+    game::sim::Setup v(base);
+    TS_ASSERT(!testee.buildVariant(0, v));
+}
@@ -0,0 +1,159 @@
+/**
+  *  \file u/t_game_sim_sweeprunner.cpp
+  *  \brief Test for game::sim::SweepRunner
+  */
+
+#include "game/sim/sweeprunner.hpp"
+
+#include "t_game_sim.hpp"
+#include "afl/sys/log.hpp"
+#include "game/sim/configuration.hpp"
+#include "game/sim/run.hpp"
+#include "game/sim/ship.hpp"
+#include "game/sim/simplerunner.hpp"
+#include "game/test/shiplist.hpp"
+
+using game::sim::Ship;
+
+namespace {
+    void addOutrider(game::sim::Setup& setup, int id, int owner, const game::spec::ShipList& list)
+    {
+        Ship* ship = setup.addShip();
+        ship->setId(id);
+        ship->setFriendlyCode("???");
+        ship->setDamage(0);
+        ship->setShield(100);
+        ship->setOwner(owner);
+        ship->setExperienceLevel(0);
+        ship->setFlags(0);
+        ship->setHullType(game::test::OUTRIDER_HULL_ID, list);
+        ship->setEngineType(game::test::TRANSWARP_ENGINE_ID);
+        ship->setAggressiveness(Ship::agg_Kill);
+        ship->setInterceptId(0);
+    }
+
+    /* Check that two result lists contain the same class results */
+    void checkSameClasses(const game::sim::ResultList& a, const game::sim::ResultList& b)
+    {
+        TS_ASSERT_EQUALS(a.getNumBattles(), b.getNumBattles());
+        TS_ASSERT_EQUALS(a.getCumulativeWeight(), b.getCumulativeWeight());
+        TS_ASSERT_EQUALS(a.getNumClassResults(), b.getNumClassResults());
+        for (size_t i = 0; i < a.getNumClassResults(); ++i) {
+            const game::sim::ClassResult* ca = a.getClassResult(i);
+            bool found = false;
+            for (size_t j = 0; j < b.getNumClassResults(); ++j) {
+                const game::sim::ClassResult* cb = b.getClassResult(j);
+                if (cb->getClass() == ca->getClass()) {
+                    TS_ASSERT_EQUALS(cb->getWeight(), ca->getWeight());
+                    found = true;
+                }
+            }
+            TS_ASSERT(found);
+        }
+    }
+}
+
+/** Test SweepRunner.
+    A: create two variants of a 3:3 fight, run them with a SweepRunner using multiple threads.
+    E: each variant produces the same result as a SimpleRunner with the same seed */
+void
+TestGameSimSweepRunner::testIt()
+{
+    // Ship list
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+    game::test::addOutrider(shipList);
+    game::test::addTranswarp(shipList);
+
+    // Setups
+    game::sim::Setup setup1;
+    addOutrider(setup1, 50, 4, shipList);
+    addOutrider(setup1, 51, 4, shipList);
+    addOutrider(setup1, 52, 4, shipList);
+    addOutrider(setup1, 70, 6, shipList);
+    addOutrider(setup1, 71, 6, shipList);
+    addOutrider(setup1, 72, 6, shipList);
+
+    game::sim::Setup setup2(setup1);
+    setup2.findShipById(70)->setDamage(50);
+
+    // Environment
+    game::config::HostConfiguration config;
+    game::vcr::flak::Configuration flakConfiguration;
+    game::sim::Configuration opts;
+    opts.setMode(game::sim::Configuration::VcrHost, 0, config);
+    util::StopSignal sig;
+    afl::sys::Log log;
+
+    // SweepRunner
+    game::sim::SweepRunner testee(opts, shipList, config, flakConfiguration, log);
+    TS_ASSERT_EQUALS(testee.addVariant(setup1, 77), 0U);
+    TS_ASSERT_EQUALS(testee.addVariant(setup2, 77), 1U);
+    TS_ASSERT_EQUALS(testee.getNumVariants(), 2U);
+    testee.run(4, 200, 0.0, sig);
+
+    TS_ASSERT(testee.getResultList(0) != 0);
+    TS_ASSERT(testee.getResultList(1) != 0);
+    TS_ASSERT(testee.getResultList(2) == 0);
+    TS_ASSERT_EQUALS(testee.getResultList(0)->getNumBattles(), 200U);
+    TS_ASSERT_EQUALS(testee.getResultList(1)->getNumBattles(), 200U);
+
+    // Compare against SimpleRunner
+    const game::sim::Setup* setups[] = { &setup1, &setup2 };
+    for (size_t i = 0; i < 2; ++i) {
+        game::sim::Setup s(*setups[i]);
+        util::RandomNumberGenerator rng(77);
+        game::sim::prepareSimulation(s, opts, rng);
+        game::sim::SimpleRunner r(s, opts, shipList, config, flakConfiguration, log, rng);
+        r.init();
+        r.run(r.makeFiniteLimit(199), sig);
+        checkSameClasses(r.resultList(), *testee.getResultList(i));
+    }
+}
+
+/** Test SweepRunner with fewer variants than threads.
+    A: create a single variant, run it with a SweepRunner using multiple threads.
+    E: threads that find no job while the first simulation runs do not quit; all simulations are run, results match SimpleRunner. */
+void
+TestGameSimSweepRunner::testSingleVariant()
+{
+    // Ship list
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+    game::test::addOutrider(shipList);
+    game::test::addTranswarp(shipList);
+
+    // Setup
+    game::sim::Setup setup;
+    addOutrider(setup, 50, 4, shipList);
+    addOutrider(setup, 51, 4, shipList);
+    addOutrider(setup, 70, 6, shipList);
+    addOutrider(setup, 71, 6, shipList);
+
+    // Environment
+    game::config::HostConfiguration config;
+    game::vcr::flak::Configuration flakConfiguration;
+    game::sim::Configuration opts;
+    opts.setMode(game::sim::Configuration::VcrHost, 0, config);
+    util::StopSignal sig;
+    afl::sys::Log log;
+
+    // SweepRunner
+    game::sim::SweepRunner testee(opts, shipList, config, flakConfiguration, log);
+    testee.addVariant(setup, 42);
+    testee.run(4, 1000, 0.0, sig);
+
+    TS_ASSERT(testee.getResultList(0) != 0);
+    TS_ASSERT_EQUALS(testee.getResultList(0)->getNumBattles(), 1000U);
+
+    // Compare against SimpleRunner
+    game::sim::Setup s(setup);
+    util::RandomNumberGenerator rng(42);
+    game::sim::prepareSimulation(s, opts, rng);
+    game::sim::SimpleRunner r(s, opts, shipList, config, flakConfiguration, log, rng);
+    r.init();
+    r.run(r.makeFiniteLimit(999), sig);
+    checkSameClasses(r.resultList(), *testee.getResultList(0));
+}
@@ -184,6 +184,7 @@ class TestGameV3Loader : public CxxTest::TestSuite {
     void testGameNamePConfig();
     void testGameNameFromDirectory();
     void testGameNameFromGamestat();
+    void testLoadBlock();
 };
 
 class TestGameV3OutboxReader : public CxxTest::TestSuite {
@@ -8,6 +8,7 @@
 #include "t_game_v3.hpp"
 #include "afl/charset/utf8charset.hpp"
 #include "afl/except/fileformatexception.hpp"
+#include "afl/except/filetooshortexception.hpp"
 #include "afl/io/constmemorystream.hpp"
 #include "afl/io/internaldirectory.hpp"
 #include "afl/io/nullfilesystem.hpp"
@@ -23,6 +24,7 @@
 #include "game/v3/command.hpp"
 #include "game/v3/commandcontainer.hpp"
 #include "game/v3/commandextra.hpp"
+#include "game/v3/structures.hpp"
 #include "afl/io/internalfilesystem.hpp"
 
 using game::Element;
@@ -951,3 +953,44 @@ TestGameV3Loader::testGameNameFromGamestat()
     TS_ASSERT_EQUALS(h.root.hostConfiguration()[game::config::HostConfiguration::GameName](), "Game  3");
 }
 
+/** Test loading records from a block.
+    A: prepare a file containing two ship records followed by extra data. Load two, three ships.
+    E: loading two ships succeeds and positions the file after the records; loading three ships fails without consuming data. */
+void
+TestGameV3Loader::testLoadBlock()
+{
+    // Prepare file
+    game::v3::structures::Ship ships[2];
+    afl::base::fromObject(ships).fill(0);
+    ships[0].shipId = 10;
+    ships[0].owner = 3;
+    ships[1].shipId = 20;
+    ships[1].owner = 3;
+
+    afl::base::GrowableBytes_t data;
+    data.append(afl::base::fromObject(ships));
+    data.append(afl::string::toBytes("xyz"));
+
+    // Environment
+    afl::charset::Utf8Charset cs;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    game::map::Universe univ;
+    game::v3::Loader testee(cs, tx, log);
+    testee.prepareUniverse(univ);
+
+    // Load two ships
+    {
+        afl::io::ConstMemoryStream ms(data);
+        TS_ASSERT_THROWS_NOTHING(testee.loadShips(univ, ms, 2, game::v3::Loader::LoadCurrent, false, game::PlayerSet_t(3)));
+        TS_ASSERT_EQUALS(ms.getPos(), sizeof(ships));
+        TS_ASSERT_EQUALS(univ.ships().get(10)->getOwner().orElse(0), 3);
+        TS_ASSERT_EQUALS(univ.ships().get(20)->getOwner().orElse(0), 3);
+    }
+
+    // Load three ships
+    {
+        afl::io::ConstMemoryStream ms(data);
+        TS_ASSERT_THROWS(testee.loadShips(univ, ms, 3, game::v3::Loader::LoadCurrent, false, game::PlayerSet_t(3)), afl::except::FileTooShortException);
+    }
+}
@@ -16,6 +16,7 @@ class TestGameVcrBattle : public CxxTest::TestSuite {
 class TestGameVcrDatabase : public CxxTest::TestSuite {
  public:
     void testIt();
+    void testPrepareResults();
 };
 
 class TestGameVcrInfo : public CxxTest::TestSuite {
@@ -50,6 +50,7 @@ class TestGameVcrClassicHostAlgorithm : public CxxTest::TestSuite {
     void testLast();
     void testDeadFire();
     void testTenth();
+    void testVisualizerEquivalence();
 };
 
 class TestGameVcrClassicMirroringEventListener : public CxxTest::TestSuite {
@@ -69,6 +70,7 @@ class TestGameVcrClassicPVCRAlgorithm : public CxxTest::TestSuite {
     void testRandomBonus();
     void testToken();
     void testAsymmetricFighterConfig();
+    void testVisualizerEquivalence();
 };
 
 class TestGameVcrClassicStatusToken : public CxxTest::TestSuite {
@@ -12,6 +12,7 @@
 #include "afl/base/countof.hpp"
 #include "game/vcr/classic/nullvisualizer.hpp"
 #include "game/vcr/classic/statustoken.hpp"
+#include "game/vcr/classic/visualizer.hpp"
 #include "game/test/shiplist.hpp"
 
 
@@ -134,6 +135,91 @@ namespace {
 
         return result;
     }
+
+    /* Visualizer that counts calls.
+       Being not a NullVisualizer, it makes the algorithm take the visualizing code path. */
+    class CountingVisualizer : public game::vcr::classic::Visualizer {
+     public:
+        CountingVisualizer()
+            : m_count(0)
+            { }
+        virtual void startFighter(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/, int /*track*/)
+            { ++m_count; }
+        virtual void landFighter(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/, int /*track*/)
+            { ++m_count; }
+        virtual void killFighter(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/, int /*track*/)
+            { ++m_count; }
+        virtual void fireBeam(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/, int /*track*/, int /*target*/, int /*hit*/, int /*damage*/, int /*kill*/)
+            { ++m_count; }
+        virtual void fireTorpedo(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/, int /*hit*/, int /*launcher*/)
+            { ++m_count; }
+        virtual void updateBeam(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/, int /*id*/)
+            { ++m_count; }
+        virtual void updateLauncher(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/, int /*id*/)
+            { ++m_count; }
+        virtual void killObject(game::vcr::classic::Algorithm& /*algo*/, game::vcr::classic::Side /*side*/)
+            { ++m_count; }
+        int getCount() const
+            { return m_count; }
+     private:
+        int m_count;
+    };
+
+    /* Play a battle on two algorithm instances in lock-step and verify that they behave identically. */
+    void verifyEquivalence(game::vcr::classic::Algorithm& fast, game::vcr::classic::Algorithm& slow, const Battle& b)
+    {
+        using game::vcr::classic::LeftSide;
+        using game::vcr::classic::RightSide;
+
+        game::vcr::Object fastLeft(convertObject(b.object[0])), fastRight(convertObject(b.object[1]));
+        game::vcr::Object slowLeft(convertObject(b.object[0])), slowRight(convertObject(b.object[1]));
+        uint16_t fastSeed = b.seed, slowSeed = b.seed;
+        TS_ASSERT_EQUALS(fast.checkBattle(fastLeft, fastRight, fastSeed), slow.checkBattle(slowLeft, slowRight, slowSeed));
+
+        fast.initBattle(fastLeft, fastRight, fastSeed);
+        slow.initBattle(slowLeft, slowRight, slowSeed);
+        fast.playFastForward();
+        slow.playFastForward();
+        while (1) {
+            bool fastResult = fast.playCycle();
+            bool slowResult = slow.playCycle();
+            TS_ASSERT_EQUALS(fastResult, slowResult);
+            TS_ASSERT_EQUALS(fast.getTime(), slow.getTime());
+            TS_ASSERT_EQUALS(fast.getDistance(), slow.getDistance());
+            for (int i = 0; i < 2; ++i) {
+                game::vcr::classic::Side side = (i == 0 ? LeftSide : RightSide);
+                TS_ASSERT_EQUALS(fast.getShield(side), slow.getShield(side));
+                TS_ASSERT_EQUALS(fast.getDamage(side), slow.getDamage(side));
+                TS_ASSERT_EQUALS(fast.getCrew(side), slow.getCrew(side));
+                TS_ASSERT_EQUALS(fast.getNumTorpedoes(side), slow.getNumTorpedoes(side));
+                TS_ASSERT_EQUALS(fast.getNumFighters(side), slow.getNumFighters(side));
+            }
+            if (!fastResult || !slowResult) {
+                break;
+            }
+        }
+        fast.doneBattle(fastLeft, fastRight);
+        slow.doneBattle(slowLeft, slowRight);
+
+        TS_ASSERT_EQUALS(fast.getResult().toInteger(), slow.getResult().toInteger());
+        TS_ASSERT_EQUALS(fastLeft.getShield(),       slowLeft.getShield());
+        TS_ASSERT_EQUALS(fastLeft.getDamage(),       slowLeft.getDamage());
+        TS_ASSERT_EQUALS(fastLeft.getCrew(),         slowLeft.getCrew());
+        TS_ASSERT_EQUALS(fastLeft.getNumTorpedoes(), slowLeft.getNumTorpedoes());
+        TS_ASSERT_EQUALS(fastLeft.getNumFighters(),  slowLeft.getNumFighters());
+        TS_ASSERT_EQUALS(fastRight.getShield(),       slowRight.getShield());
+        TS_ASSERT_EQUALS(fastRight.getDamage(),       slowRight.getDamage());
+        TS_ASSERT_EQUALS(fastRight.getCrew(),         slowRight.getCrew());
+        TS_ASSERT_EQUALS(fastRight.getNumTorpedoes(), slowRight.getNumTorpedoes());
+        TS_ASSERT_EQUALS(fastRight.getNumFighters(),  slowRight.getNumFighters());
+        for (int i = 0; i < 2; ++i) {
+            game::vcr::classic::Side side = (i == 0 ? LeftSide : RightSide);
+            game::vcr::Statistic fastStat = fast.getStatistic(side), slowStat = slow.getStatistic(side);
+            TS_ASSERT_EQUALS(fastStat.getNumTorpedoHits(),    slowStat.getNumTorpedoHits());
+            TS_ASSERT_EQUALS(fastStat.getMinFightersAboard(), slowStat.getMinFightersAboard());
+            TS_ASSERT_EQUALS(fastStat.getNumFights(),         slowStat.getNumFights());
+        }
+    }
 }
 
 /** Test first battle: Freighter vs Torper, normal playback.
@@ -434,3 +520,25 @@ TestGameVcrClassicHostAlgorithm::testTenth()
     TS_ASSERT_EQUALS(right.getNumTorpedoes(), 10);
 }
 
+/** Test that skipping visualisation does not change the outcome.
+    A: play all test battles using a NullVisualizer (which skips all visualizer calls) and a visualizer that counts calls.
+    E: both produce identical state after each cycle, identical results and statistics. */
+void
+TestGameVcrClassicHostAlgorithm::testVisualizerEquivalence()
+{
+    game::config::HostConfiguration config;
+    game::spec::ShipList list;
+    initShipList(list);
+
+    for (size_t i = 0; i < countof(battles); ++i) {
+        game::vcr::classic::NullVisualizer nullVis;
+        CountingVisualizer countVis;
+        game::vcr::classic::HostAlgorithm fast(false, nullVis, config, list.beams(), list.launchers());
+        game::vcr::classic::HostAlgorithm slow(false, countVis, config, list.beams(), list.launchers());
+        TS_ASSERT(!fast.isVisualizing());
+        TS_ASSERT(slow.isVisualizing());
+
+        verifyEquivalence(fast, slow, battles[i]);
+        TS_ASSERT(countVis.getCount() > 0);
+    }
+}
@@ -6,6 +6,57 @@
 #include "game/vcr/database.hpp"
 
 #include "t_game_vcr.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "game/config/hostconfiguration.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/vcr/test/battle.hpp"
+
+namespace {
+    class CountingBattle : public game::vcr::test::Battle {
+     public:
+        CountingBattle()
+            : m_count(0), m_level(0)
+            { }
+        virtual void prepareResult(const game::config::HostConfiguration& /*config*/, const game::spec::ShipList& /*shipList*/, int resultLevel)
+            { ++m_count; m_level = resultLevel; }
+        int getCount() const
+            { return m_count; }
+        int getLevel() const
+            { return m_level; }
+     private:
+        int m_count;
+        int m_level;
+    };
+
+    class CountingDatabase : public game::vcr::Database {
+     public:
+        CountingDatabase(size_t n)
+            : m_battles()
+            {
+                for (size_t i = 0; i < n; ++i) {
+                    m_battles.pushBackNew(new CountingBattle());
+                }
+            }
+        virtual size_t getNumBattles() const
+            { return m_battles.size(); }
+        virtual CountingBattle* getBattle(size_t nr)
+            { return nr < m_battles.size() ? m_battles[nr] : 0; }
+     private:
+        afl::container::PtrVector<CountingBattle> m_battles;
+    };
+
+    void checkPrepareResults(size_t numBattles, size_t numThreads)
+    {
+        game::config::HostConfiguration config;
+        game::spec::ShipList shipList;
+        CountingDatabase db(numBattles);
+        db.prepareResults(config, shipList, game::vcr::Battle::NeedCompleteResult, numThreads);
+        for (size_t i = 0; i < numBattles; ++i) {
+            TS_ASSERT_EQUALS(db.getBattle(i)->getCount(), 1);
+            TS_ASSERT_EQUALS(db.getBattle(i)->getLevel(), game::vcr::Battle::NeedCompleteResult);
+        }
+    }
+}
 
 /** Interface test. */
 void
@@ -21,3 +72,17 @@ TestGameVcrDatabase::testIt()
     Tester t;
 }
 
+
+/** Test prepareResults().
+    A: create database. Call prepareResults() with different numbers of threads.
+    E: prepareResult() called exactly once for each battle */
+void
+TestGameVcrDatabase::testPrepareResults()
+{
+    checkPrepareResults(0, 0);
+    checkPrepareResults(0, 4);
+    checkPrepareResults(10, 1);
+    checkPrepareResults(10, 4);
+    checkPrepareResults(3, 10);
+    checkPrepareResults(200, 7);
+}
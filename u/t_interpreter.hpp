@@ -70,6 +70,7 @@ class TestInterpreterBinaryExecution : public CxxTest::TestSuite {
     void testKeyFind();
     void testArrayDim();
     void testExecuteComparison();
+    void testInPlace();
 };
 
 class TestInterpreterBinaryOperation : public CxxTest::TestSuite {
@@ -103,6 +104,7 @@ class TestInterpreterBytecodeObject : public CxxTest::TestSuite {
     void testAppend();
     void testDisassembly();
     void testMergeByteCodeObjects();
+    void testLookupCache();
 };
 
 class TestInterpreterCallableValue : public CxxTest::TestSuite {
@@ -487,11 +489,13 @@ class TestInterpreterProcess : public CxxTest::TestSuite {
     void testExecFusedBinary();
     void testExecFusedComparison();
     void testExecFusedComparison2();
+    void testExecBooleanArithmetic();
     void testExecInplaceUnary();
     void testContextEnter();
     void testContextEnterError();
     void testContextEnterCatch();
     void testContextEnterReject();
+    void testLookupCache();
 };
 
 class TestInterpreterProcessList : public CxxTest::TestSuite {
@@ -760,6 +764,7 @@ class TestInterpreterUnaryExecution : public CxxTest::TestSuite {
     void testIsArray();
     void testUCase();
     void testLCase();
+    void testInPlace();
 };
 
 class TestInterpreterUnaryOperation : public CxxTest::TestSuite {
@@ -1231,3 +1231,51 @@ TestInterpreterBinaryExecution::testExecuteComparison()
     TS_ASSERT_THROWS(interpreter::executeComparison(interpreter::biAdd, addr(IntegerValue(1)), addr(IntegerValue(1))), interpreter::Error);
 }
 
+
+/** Test executeBinaryOperationInPlace. */
+void
+TestInterpreterBinaryExecution::testInPlace()
+{
+    // Integer add/sub: performed
+    {
+        IntegerValue a(10);
+        TS_ASSERT(interpreter::executeBinaryOperationInPlace(interpreter::biAdd, &a, addr(IntegerValue(5))));
+        TS_ASSERT_EQUALS(a.getValue(), 15);
+        TS_ASSERT(interpreter::executeBinaryOperationInPlace(interpreter::biSub, &a, addr(IntegerValue(20))));
+        TS_ASSERT_EQUALS(a.getValue(), -5);
+    }
+
+    // Other types: not performed, value unchanged
+    {
+        IntegerValue a(10);
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biAdd, &a, addr(FloatValue(5))));
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biAdd, &a, addr(StringValue("x"))));
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biAdd, &a, 0));
+        TS_ASSERT_EQUALS(a.getValue(), 10);
+    }
+    {
+        FloatValue a(10);
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biAdd, &a, addr(IntegerValue(5))));
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biAdd, 0, addr(IntegerValue(5))));
+    }
+
+    // Booleans produce an integer: not performed
+    {
+        BooleanValue a(true);
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biAdd, &a, addr(IntegerValue(1))));
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biSub, &a, addr(IntegerValue(1))));
+        TS_ASSERT_EQUALS(a.getValue(), 1);
+
+        IntegerValue b(10);
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biAdd, &b, addr(BooleanValue(true))));
+        TS_ASSERT_EQUALS(b.getValue(), 10);
+    }
+
+    // Other operations: not performed
+    {
+        IntegerValue a(10);
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biMult, &a, addr(IntegerValue(5))));
+        TS_ASSERT(!interpreter::executeBinaryOperationInPlace(interpreter::biCompareEQ, &a, addr(IntegerValue(5))));
+        TS_ASSERT_EQUALS(a.getValue(), 10);
+    }
+}
@@ -716,3 +716,41 @@ TestInterpreterBytecodeObject::testMergeByteCodeObjects()
     }
 }
 
+
+/** Test inline cache (getCachedLookup, setCachedLookup). */
+void
+TestInterpreterBytecodeObject::testLookupCache()
+{
+    static const char TYPE_A[] = "a", TYPE_B[] = "b";
+    interpreter::BytecodeObject testee;
+    uint16_t na = testee.addName("A");
+    uint16_t nb = testee.addName("B");
+    testee.addInstruction(Opcode::maPush, Opcode::sNamedVariable, na);
+    testee.addInstruction(Opcode::maPush, Opcode::sNamedVariable, nb);
+
+    // Initially empty
+    interpreter::Context::PropertyIndex_t index = 0;
+    const interpreter::Context::LookupKey ka(TYPE_A, 1);
+    TS_ASSERT(!testee.getCachedLookup(0, na, ka, index));
+
+    // Store and retrieve
+    testee.setCachedLookup(0, na, ka, 42);
+    TS_ASSERT(testee.getCachedLookup(0, na, ka, index));
+    TS_ASSERT_EQUALS(index, 42U);
+
+    // Mismatches
+    TS_ASSERT(!testee.getCachedLookup(1, na, ka, index));
+    TS_ASSERT(!testee.getCachedLookup(0, nb, ka, index));
+    TS_ASSERT(!testee.getCachedLookup(0, na, interpreter::Context::LookupKey(TYPE_A, 2), index));
+    TS_ASSERT(!testee.getCachedLookup(0, na, interpreter::Context::LookupKey(TYPE_B, 1), index));
+    TS_ASSERT(!testee.getCachedLookup(0, na, interpreter::Context::LookupKey(), index));
+
+    // Replace
+    testee.setCachedLookup(0, na, interpreter::Context::LookupKey(TYPE_B, 1), 7);
+    TS_ASSERT(!testee.getCachedLookup(0, na, ka, index));
+    TS_ASSERT(testee.getCachedLookup(0, na, interpreter::Context::LookupKey(TYPE_B, 1), index));
+    TS_ASSERT_EQUALS(index, 7U);
+
+    // Out of range is accepted and ignored
+    TS_ASSERT(!testee.getCachedLookup(1000, na, ka, index));
+}
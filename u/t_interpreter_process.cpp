@@ -26,6 +26,7 @@
 #include "interpreter/hashvalue.hpp"
 #include "interpreter/indexablevalue.hpp"
 #include "interpreter/keymapvalue.hpp"
+#include "interpreter/singlecontext.hpp"
 #include "interpreter/structuretype.hpp"
 #include "interpreter/structuretypedata.hpp"
 #include "interpreter/structurevalue.hpp"
@@ -290,6 +291,47 @@ namespace {
         bool m_reject;
     };
 
+    /* Context that counts lookups and allows caching them. */
+    class CountingContext : public interpreter::SingleContext, public interpreter::Context::PropertyAccessor {
+     public:
+        CountingContext(int& numLookups, size_t& generation)
+            : m_numLookups(numLookups), m_generation(generation)
+            { }
+        virtual PropertyAccessor* lookup(const afl::data::NameQuery& name, PropertyIndex_t& result)
+            {
+                ++m_numLookups;
+                if (name.match("X")) {
+                    result = 7;
+                    return this;
+                } else {
+                    return 0;
+                }
+            }
+        virtual PropertyAccessor* getCacheableAccessor(LookupKey& key)
+            {
+                static const char TYPE[] = "counting";
+                key = LookupKey(TYPE, m_generation);
+                return this;
+            }
+        virtual void set(PropertyIndex_t /*index*/, const afl::data::Value* /*value*/)
+            { }
+        virtual afl::data::Value* get(PropertyIndex_t index)
+            { return interpreter::makeIntegerValue(int32_t(index)); }
+        virtual interpreter::Context* clone() const
+            { return new CountingContext(m_numLookups, m_generation); }
+        virtual afl::base::Deletable* getObject()
+            { return 0; }
+        virtual void enumProperties(interpreter::PropertyAcceptor& /*acceptor*/) const
+            { }
+        virtual String_t toString(bool /*readable*/) const
+            { return "#<counting>"; }
+        virtual void store(interpreter::TagNode& /*out*/, afl::io::DataSink& /*aux*/, interpreter::SaveContext& /*ctx*/) const
+            { TS_FAIL("CountingContext::store unexpected"); }
+     private:
+        int& m_numLookups;
+        size_t& m_generation;
+    };
+
     /* Common environment for all tests. */
     struct Environment {
         afl::sys::Log log;
@@ -3373,3 +3415,126 @@ TestInterpreterProcess::testContextEnterReject()
     TS_ASSERT_EQUALS(trace, "(enter)");
 }
 
+
+/** Test inline cache for name lookups.
+    Repeated execution of an instruction must not repeat the lookup,
+    unless the context's key changes. */
+void
+TestInterpreterProcess::testLookupCache()
+{
+    Environment env;
+    int numLookups = 0;
+    size_t generation = 1;
+    env.proc.pushNewContext(new CountingContext(numLookups, generation));
+
+    BCORef_t bco = makeBCO();
+    bco->addInstruction(Opcode::maPush, Opcode::sNamedVariable, bco->addName("X"));
+
+    // First execution: lookup
+    runBCO(env, bco);
+    TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+    TS_ASSERT_EQUALS(toInteger(env), 7);
+    TS_ASSERT_EQUALS(numLookups, 1);
+
+    // Second execution: cached
+    runBCO(env, bco);
+    TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+    TS_ASSERT_EQUALS(toInteger(env), 7);
+    TS_ASSERT_EQUALS(numLookups, 1);
+
+    // Key changes: lookup again
+    generation = 2;
+    runBCO(env, bco);
+    TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+    TS_ASSERT_EQUALS(toInteger(env), 7);
+    TS_ASSERT_EQUALS(numLookups, 2);
+
+    // Member reference is cached as well
+    CountingContext lit(numLookups, generation);
+    BCORef_t bco2 = makeBCO();
+    bco2->addPushLiteral(&lit);
+    bco2->addInstruction(Opcode::maMemref, Opcode::miIMLoad, bco2->addName("X"));
+    runBCO(env, bco2);
+    runBCO(env, bco2);
+    TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+    TS_ASSERT_EQUALS(toInteger(env), 7);
+    TS_ASSERT_EQUALS(numLookups, 3);
+}
+
+/** Test arithmetic on booleans.
+    Integer arithmetic is performed in-place on the stack; booleans must still produce integers.
+    A: execute badd, uinc, upos on booleans, using maBinary, maUnary, maFusedBinary.
+    E: results are integers, not booleans. */
+void
+TestInterpreterProcess::testExecBooleanArithmetic()
+{
+    // True+1 (maBinary)
+    {
+        Environment env;
+        env.proc.pushNewValue(interpreter::makeBooleanValue(1));
+        env.proc.pushNewValue(interpreter::makeIntegerValue(1));
+        runInstruction(env, Opcode::maBinary, interpreter::biAdd, 0);
+        TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+        TS_ASSERT(dynamic_cast<const BooleanValue*>(env.proc.getResult()) == 0);
+        TS_ASSERT_EQUALS(toInteger(env), 2);
+    }
+
+    // 1-True (maBinary)
+    {
+        Environment env;
+        env.proc.pushNewValue(interpreter::makeIntegerValue(1));
+        env.proc.pushNewValue(interpreter::makeBooleanValue(1));
+        runInstruction(env, Opcode::maBinary, interpreter::biSub, 0);
+        TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+        TS_ASSERT(dynamic_cast<const BooleanValue*>(env.proc.getResult()) == 0);
+        TS_ASSERT_EQUALS(toInteger(env), 0);
+    }
+
+    // +True (maUnary)
+    {
+        Environment env;
+        env.proc.pushNewValue(interpreter::makeBooleanValue(1));
+        runInstruction(env, Opcode::maUnary, interpreter::unPos, 0);
+        TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+        TS_ASSERT(dynamic_cast<const BooleanValue*>(env.proc.getResult()) == 0);
+        TS_ASSERT_EQUALS(toInteger(env), 1);
+    }
+
+    // Incr True (maUnary)
+    {
+        Environment env;
+        env.proc.pushNewValue(interpreter::makeBooleanValue(1));
+        runInstruction(env, Opcode::maUnary, interpreter::unInc, 0);
+        TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+        TS_ASSERT(dynamic_cast<const BooleanValue*>(env.proc.getResult()) == 0);
+        TS_ASSERT_EQUALS(toInteger(env), 2);
+    }
+
+    // True+1 (maFusedBinary)
+    {
+        Environment env;
+        BCORef_t bco = makeBCO();
+        env.world.globalValues().setNew(77, interpreter::makeIntegerValue(1));     // second arg
+        env.proc.pushNewValue(interpreter::makeBooleanValue(1));                   // first arg
+        bco->addInstruction(Opcode::maFusedBinary, Opcode::sShared, 77);
+        bco->addInstruction(Opcode::maBinary, interpreter::biAdd, 0);
+        runBCO(env, bco);
+        TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+        TS_ASSERT(dynamic_cast<const BooleanValue*>(env.proc.getResult()) == 0);
+        TS_ASSERT_EQUALS(toInteger(env), 2);
+    }
+
+    // 1+True (maFusedBinary)
+    {
+        Environment env;
+        BCORef_t bco = makeBCO();
+        env.world.globalValues().setNew(77, interpreter::makeBooleanValue(1));     // second arg
+        env.proc.pushNewValue(interpreter::makeIntegerValue(1));                   // first arg
+        bco->addInstruction(Opcode::maFusedBinary, Opcode::sShared, 77);
+        bco->addInstruction(Opcode::maBinary, interpreter::biAdd, 0);
+        runBCO(env, bco);
+        TS_ASSERT_EQUALS(env.proc.getState(), Process::Ended);
+        TS_ASSERT(dynamic_cast<const BooleanValue*>(env.proc.getResult()) == 0);
+        TS_ASSERT_EQUALS(toInteger(env), 2);
+    }
+}
@@ -1153,3 +1153,37 @@ TestInterpreterUnaryExecution::testLCase()
     // Type error
     TS_ASSERT_THROWS(p.reset(executeUnaryOperation(h.world, interpreter::unLCase, addr(IntegerValue(42)))), interpreter::Error);
 }
+
+/** Test executeUnaryOperationInPlace. */
+void
+TestInterpreterUnaryExecution::testInPlace()
+{
+    // Integer
+    IntegerValue iv(10);
+    TS_ASSERT(interpreter::executeUnaryOperationInPlace(interpreter::unInc, &iv));
+    TS_ASSERT_EQUALS(iv.getValue(), 11);
+    TS_ASSERT(interpreter::executeUnaryOperationInPlace(interpreter::unDec, &iv));
+    TS_ASSERT(interpreter::executeUnaryOperationInPlace(interpreter::unDec, &iv));
+    TS_ASSERT_EQUALS(iv.getValue(), 9);
+    TS_ASSERT(interpreter::executeUnaryOperationInPlace(interpreter::unPos, &iv));
+    TS_ASSERT_EQUALS(iv.getValue(), 9);
+
+    // Float
+    FloatValue fv(2.5);
+    TS_ASSERT(interpreter::executeUnaryOperationInPlace(interpreter::unInc, &fv));
+    TS_ASSERT_EQUALS(fv.getValue(), 3.5);
+
+    // Booleans produce an integer: not performed
+    BooleanValue bv(true);
+    TS_ASSERT(!interpreter::executeUnaryOperationInPlace(interpreter::unInc, &bv));
+    TS_ASSERT(!interpreter::executeUnaryOperationInPlace(interpreter::unDec, &bv));
+    TS_ASSERT(!interpreter::executeUnaryOperationInPlace(interpreter::unPos, &bv));
+    TS_ASSERT_EQUALS(bv.getValue(), 1);
+
+    // Not performed
+    StringValue sv("x");
+    TS_ASSERT(!interpreter::executeUnaryOperationInPlace(interpreter::unNeg, &iv));
+    TS_ASSERT(!interpreter::executeUnaryOperationInPlace(interpreter::unInc, &sv));
+    TS_ASSERT(!interpreter::executeUnaryOperationInPlace(interpreter::unInc, 0));
+    TS_ASSERT_EQUALS(iv.getValue(), 9);
+}
@@ -24,6 +24,12 @@ class TestServerCommonRandomIdGenerator : public CxxTest::TestSuite {
     void testLoop();
 };
 
+class TestServerCommonReadWriteLock : public CxxTest::TestSuite {
+ public:
+    void testReaders();
+    void testWriter();
+};
+
 class TestServerCommonRoot : public CxxTest::TestSuite {
  public:
     void testIt();
@@ -45,6 +51,11 @@ class TestServerCommonSessionProtocolHandlerFactory : public CxxTest::TestSuite
     void testIt();
 };
 
+class TestServerCommonThreadPoolServer : public CxxTest::TestSuite {
+ public:
+    void testParallel();
+};
+
 class TestServerCommonUser : public CxxTest::TestSuite {
  public:
     void testRealName();
@@ -0,0 +1,86 @@
+/**
+  *  \file u/t_server_common_readwritelock.cpp
+  *  \brief Test for server::common::ReadWriteLock
+  */
+
+#include "server/common/readwritelock.hpp"
+
+#include "t_server_common.hpp"
+#include "afl/base/runnable.hpp"
+#include "afl/sys/semaphore.hpp"
+#include "afl/sys/thread.hpp"
+
+using server::common::ReadWriteLock;
+
+namespace {
+    /* Thread body: acquire the lock, report, and release it again. */
+    class Locker : public afl::base::Runnable {
+     public:
+        Locker(ReadWriteLock& lock, bool exclusive, afl::sys::Semaphore& done)
+            : m_lock(lock), m_exclusive(exclusive), m_done(done)
+            { }
+        virtual void run()
+            {
+                if (m_exclusive) {
+                    ReadWriteLock::WriteGuard g(m_lock);
+                    m_done.post();
+                } else {
+                    ReadWriteLock::ReadGuard g(m_lock);
+                    m_done.post();
+                }
+            }
+     private:
+        ReadWriteLock& m_lock;
+        bool m_exclusive;
+        afl::sys::Semaphore& m_done;
+    };
+}
+
+/** Test that readers do not block each other. */
+void
+TestServerCommonReadWriteLock::testReaders()
+{
+    ReadWriteLock testee;
+    afl::sys::Semaphore done(0);
+    Locker locker(testee, false, done);
+
+    // Hold the lock shared; another reader must still get it.
+    ReadWriteLock::ReadGuard g(testee);
+    afl::sys::Thread t("testReaders", locker);
+    t.start();
+    TS_ASSERT(done.wait(10000));
+    t.join();
+}
+
+/** Test that a writer excludes readers and vice versa. */
+void
+TestServerCommonReadWriteLock::testWriter()
+{
+    ReadWriteLock testee;
+    afl::sys::Semaphore writerDone(0);
+    afl::sys::Semaphore readerDone(0);
+    Locker writer(testee, true, writerDone);
+    Locker reader(testee, false, readerDone);
+    afl::sys::Thread writerThread("testWriter.writer", writer);
+    afl::sys::Thread readerThread("testWriter.reader", reader);
+
+    // Hold the lock shared; writer must wait.
+    testee.lockShared();
+    writerThread.start();
+    TS_ASSERT(!writerDone.wait(100));
+
+    // A reader arriving after the writer must wait, too.
+    readerThread.start();
+    TS_ASSERT(!readerDone.wait(100));
+
+    // Release; both must get through.
+    testee.unlockShared();
+    TS_ASSERT(writerDone.wait(10000));
+    TS_ASSERT(readerDone.wait(10000));
+    writerThread.join();
+    readerThread.join();
+
+    // Exclusive lock can be taken again
+    testee.lockExclusive();
+    testee.unlockExclusive();
+}
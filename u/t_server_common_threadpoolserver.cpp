@@ -0,0 +1,104 @@
+/**
+  *  \file u/t_server_common_threadpoolserver.cpp
+  *  \brief Test for server::common::ThreadPoolServer
+  */
+
+#include "server/common/threadpoolserver.hpp"
+
+#include <cstdlib>
+#include "t_server_common.hpp"
+#include "afl/async/controller.hpp"
+#include "afl/async/receiveoperation.hpp"
+#include "afl/async/sendoperation.hpp"
+#include "afl/net/line/linehandler.hpp"
+#include "afl/net/line/linesink.hpp"
+#include "afl/net/line/protocolhandler.hpp"
+#include "afl/net/name.hpp"
+#include "afl/net/networkstack.hpp"
+#include "afl/sys/semaphore.hpp"
+#include "afl/sys/thread.hpp"
+
+namespace {
+    /* Line server.
+       "WAIT" blocks until another connection sends "POST".
+       This needs two connections being served in parallel. */
+    class Handler : public afl::net::line::LineHandler,
+                    public afl::net::ProtocolHandlerFactory
+    {
+     public:
+        Handler()
+            : m_sem(0)
+            { }
+        virtual afl::net::ProtocolHandler* create()
+            { return new afl::net::line::ProtocolHandler(*this); }
+        virtual bool handleOpening(afl::net::line::LineSink& /*response*/)
+            { return false; }
+        virtual bool handleLine(const String_t& line, afl::net::line::LineSink& response)
+            {
+                if (line.compare(0, 4, "WAIT") == 0) {
+                    m_sem.wait();
+                    response.handleLine("waited");
+                } else if (line.compare(0, 4, "POST") == 0) {
+                    m_sem.post();
+                    response.handleLine("posted");
+                } else {
+                    response.handleLine("error");
+                }
+                return false;
+            }
+        virtual void handleConnectionClose()
+            { }
+     private:
+        afl::sys::Semaphore m_sem;
+    };
+
+    void sendLine(afl::net::Socket& sock, const char* line)
+    {
+        afl::async::Controller ctl;
+        afl::async::SendOperation op(afl::string::toBytes(line));
+        TS_ASSERT(sock.send(ctl, op, 10000));
+    }
+
+    String_t receiveLine(afl::net::Socket& sock)
+    {
+        afl::async::Controller ctl;
+        String_t result;
+        while (result.find('\n') == String_t::npos) {
+            uint8_t buffer[100];
+            afl::async::ReceiveOperation op(buffer);
+            if (!sock.receive(ctl, op, 10000) || op.getReceivedBytes().empty()) {
+                break;
+            }
+            result += afl::string::fromBytes(op.getReceivedBytes());
+        }
+        return result;
+    }
+}
+
+/** Test parallel connections. */
+void
+TestServerCommonThreadPoolServer::testParallel()
+{
+    // Server
+    afl::net::NetworkStack& ns = afl::net::NetworkStack::getInstance();
+    afl::net::Name name("127.0.0.1", uint16_t(std::rand() % 10000 + 20000));
+    Handler handler;
+    server::common::ThreadPoolServer testee(ns.listen(name, 10), handler, 2);
+    afl::sys::Thread serverThread("TestServerCommonThreadPoolServer", testee);
+    serverThread.start();
+
+    {
+        // First connection blocks...
+        afl::base::Ref<afl::net::Socket> a = ns.connect(name, 10000);
+        sendLine(*a, "WAIT\n");
+
+        // ...until second connection releases it.
+        afl::base::Ref<afl::net::Socket> b = ns.connect(name, 10000);
+        sendLine(*b, "POST\n");
+        TS_ASSERT_EQUALS(receiveLine(*b).substr(0, 6), "posted");
+        TS_ASSERT_EQUALS(receiveLine(*a).substr(0, 6), "waited");
+    }
+
+    testee.stop();
+    serverThread.join();
+}
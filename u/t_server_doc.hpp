@@ -11,6 +11,15 @@ class TestServerDocDocumentationImpl : public CxxTest::TestSuite {
  public:
     void testGetBlob();
     void testNodeAccess();
+    void testRenderCache();
+    void testSearch();
+};
+
+class TestServerDocRenderCache : public CxxTest::TestSuite {
+ public:
+    void testIt();
+    void testLimit();
+    void testKey();
 };
 
 #endif
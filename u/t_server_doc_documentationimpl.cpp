@@ -7,9 +7,11 @@
 #include "server/doc/documentationimpl.hpp"
 
 #include "t_server_doc.hpp"
+#include "afl/io/internalstream.hpp"
 #include "util/doc/internalblobstore.hpp"
 #include "server/doc/root.hpp"
 #include "util/doc/index.hpp"
+#include "util/doc/searchindexbuilder.hpp"
 
 using server::doc::Root;
 using server::doc::DocumentationImpl;
@@ -198,3 +200,124 @@ TestServerDocDocumentationImpl::testNodeAccess()
     }
 }
 
+
+/** Test render cache.
+    A: render pages repeatedly, pre-render all pages.
+    E: repeated requests are answered from cache; pre-rendering renders each page once per document Id */
+void
+TestServerDocDocumentationImpl::testRenderCache()
+{
+    // Environment
+    InternalBlobStore blobs;
+    Root r(blobs);
+
+    // Same content in two documents, one other page
+    String_t p1 = "<p>First page, see <a href=\"p2\">second</a></p>";
+    String_t p2 = "<p>Second page</p>";
+    String_t id1 = blobs.addObject(afl::string::toBytes(p1));
+    String_t id2 = blobs.addObject(afl::string::toBytes(p2));
+
+    Index& idx = r.index();
+    Index::Handle_t v1 = idx.addDocument(idx.root(), "v1", "Version 1", "");
+    Index::Handle_t v2 = idx.addDocument(idx.root(), "v2", "Version 2", "");
+    idx.addPage(v1, "p1", "Page 1", id1);
+    idx.addPage(v2, "p1", "Page 1", id1);
+    idx.addPage(v1, "p2", "Page 2", id2);
+
+    DocumentationImpl testee(r);
+    Documentation::RenderOptions opts;
+    opts.docRoot = "/doc/";
+
+    // Render twice: second is a hit
+    TS_ASSERT_EQUALS(testee.renderNode("v1/p1", opts), "<p>First page, see <a href=\"/doc/v1/p2\">second</a></p>");
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numMisses, 1);
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numHits, 0);
+    TS_ASSERT_EQUALS(testee.renderNode("v1/p1", opts), "<p>First page, see <a href=\"/doc/v1/p2\">second</a></p>");
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numHits, 1);
+
+    // Same content, different document: different result
+    TS_ASSERT_EQUALS(testee.renderNode("v2/p1", opts), "<p>First page, see <a href=\"/doc/v2/p2\">second</a></p>");
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numMisses, 2);
+
+    // Different options: different result
+    Documentation::RenderOptions opts2;
+    opts2.docRoot = "/other/";
+    TS_ASSERT_EQUALS(testee.renderNode("v1/p1", opts2), "<p>First page, see <a href=\"/other/v1/p2\">second</a></p>");
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numMisses, 3);
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numEntries, 3);
+
+    // Pre-render: only v1/p2 is missing
+    TS_ASSERT_EQUALS(testee.prerenderNodes(opts), 1);
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numEntries, 4);
+    TS_ASSERT_EQUALS(testee.prerenderNodes(opts), 0);
+
+    // Pre-rendered page is a hit
+    TS_ASSERT_EQUALS(testee.renderNode("v1/p2", opts), "<p>Second page</p>");
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numHits, 2);
+    TS_ASSERT_EQUALS(testee.getCacheStatus().numMisses, 3);
+    TS_ASSERT(testee.getCacheStatus().totalSize > 0);
+}
+
+/** Test search(). */
+void
+TestServerDocDocumentationImpl::testSearch()
+{
+    // Environment
+    InternalBlobStore blobs;
+    Root r(blobs);
+
+    Index& idx = r.index();
+    Index::Handle_t v1 = idx.addDocument(idx.root(), "v1,current", "Version 1", "");
+    Index::Handle_t v2 = idx.addDocument(idx.root(), "v2", "Version 2", "");
+    idx.addPage(v1, "fuel", "Fuel usage", blobs.addObject(afl::string::toBytes("<p>Ships need fuel to move.</p>")));
+    idx.addPage(v1, "combat", "Combat", blobs.addObject(afl::string::toBytes("<p>Combat does not need fuel.</p>")));
+    idx.addPage(v2, "fuel", "Fuel usage", blobs.addObject(afl::string::toBytes("<p>Ships need fuel to move.</p>")));
+
+    // Build search index
+    util::doc::SearchIndexBuilder builder;
+    builder.addIndex(idx, blobs);
+    afl::io::InternalStream stream;
+    builder.save(stream);
+    stream.setPos(0);
+    r.searchIndex().load(stream);
+
+    DocumentationImpl testee(r);
+
+    // Unrestricted search; title match ranks higher
+    {
+        std::vector<Documentation::SearchResult> result = testee.search("FUEL", Documentation::SearchOptions());
+        TS_ASSERT_EQUALS(result.size(), 3U);
+        TS_ASSERT_EQUALS(result[2].nodeId, "v1/combat");
+        TS_ASSERT_EQUALS(result[2].title, "Combat");
+        TS_ASSERT_EQUALS(result[2].snippet, "Combat does not need fuel.");
+        TS_ASSERT(result[1].score > result[2].score);
+    }
+
+    // Restricted to document, using alias
+    {
+        Documentation::SearchOptions opts;
+        opts.docId = "current";
+        std::vector<Documentation::SearchResult> result = testee.search("fuel", opts);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0].nodeId, "current/fuel");
+        TS_ASSERT_EQUALS(result[0].title, "Fuel usage");
+        TS_ASSERT_EQUALS(result[1].nodeId, "current/combat");
+    }
+
+    // Limit
+    {
+        Documentation::SearchOptions opts;
+        opts.maxResults = 1;
+        TS_ASSERT_EQUALS(testee.search("fuel", opts).size(), 1U);
+    }
+
+    // No match
+    TS_ASSERT_EQUALS(testee.search("fuel starbase", Documentation::SearchOptions()).size(), 0U);
+
+    // Invalid document
+    {
+        Documentation::SearchOptions opts;
+        opts.docId = "v3";
+        TS_ASSERT_THROWS(testee.search("fuel", opts), std::exception);
+    }
+}
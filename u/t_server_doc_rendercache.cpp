@@ -0,0 +1,142 @@
+/**
+  *  \file u/t_server_doc_rendercache.cpp
+  *  \brief Test for server::doc::RenderCache
+  */
+
+#include "server/doc/rendercache.hpp"
+
+#include "t_server_doc.hpp"
+#include "util/doc/renderoptions.hpp"
+
+using server::doc::RenderCache;
+using util::doc::RenderOptions;
+
+/** Basic operation.
+    A: store a page, retrieve it.
+    E: page is returned; statistics are updated */
+void
+TestServerDocRenderCache::testIt()
+{
+    RenderCache testee(1000);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+    TS_ASSERT_EQUALS(testee.getTotalSize(), 0U);
+
+    // Miss
+    String_t result;
+    TS_ASSERT(!testee.get("k", result));
+    TS_ASSERT_EQUALS(testee.getNumMisses(), 1U);
+    TS_ASSERT_EQUALS(testee.getNumHits(), 0U);
+
+    // Store
+    testee.put("k", "<p>page</p>");
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+    TS_ASSERT_EQUALS(testee.getTotalSize(), 12U);
+    TS_ASSERT(testee.contains("k"));
+
+    // Hit
+    TS_ASSERT(testee.get("k", result));
+    TS_ASSERT_EQUALS(result, "<p>page</p>");
+    TS_ASSERT_EQUALS(testee.getNumMisses(), 1U);
+    TS_ASSERT_EQUALS(testee.getNumHits(), 1U);
+
+    // Replace
+    testee.put("k", "<p>x</p>");
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+    TS_ASSERT_EQUALS(testee.getTotalSize(), 9U);
+    TS_ASSERT(testee.get("k", result));
+    TS_ASSERT_EQUALS(result, "<p>x</p>");
+
+    // Clear
+    testee.clear();
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+    TS_ASSERT_EQUALS(testee.getTotalSize(), 0U);
+    TS_ASSERT(!testee.contains("k"));
+    TS_ASSERT_EQUALS(testee.getNumHits(), 2U);
+}
+
+/** Test size limit.
+    A: store more pages than fit into the cache, accessing one of the old ones in between.
+    E: least-recently-used pages are dropped */
+void
+TestServerDocRenderCache::testLimit()
+{
+    // Each entry is 1+9 = 10 bytes
+    RenderCache testee(30);
+    String_t result;
+    testee.put("a", "123456789");
+    testee.put("b", "123456789");
+    testee.put("c", "123456789");
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 3U);
+
+    // Use a, then add d: b is dropped
+    TS_ASSERT(testee.get("a", result));
+    testee.put("d", "123456789");
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 3U);
+    TS_ASSERT(testee.contains("a"));
+    TS_ASSERT(!testee.contains("b"));
+    TS_ASSERT(testee.contains("c"));
+    TS_ASSERT(testee.contains("d"));
+
+    // Too large: not stored, nothing dropped
+    testee.put("e", String_t(100, 'x'));
+    TS_ASSERT(!testee.contains("e"));
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 3U);
+
+    // Reduce limit: keeps most recent
+    testee.setLimit(10);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+    TS_ASSERT(testee.contains("d"));
+
+    // Zero limit disables cache
+    testee.setLimit(0);
+    testee.put("f", "1");
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+    TS_ASSERT_EQUALS(testee.getTotalSize(), 0U);
+}
+
+/** Test makeKey().
+    A: build keys from different parameters.
+    E: every parameter affects the key */
+void
+TestServerDocRenderCache::testKey()
+{
+    RenderOptions opts;
+    opts.setDocumentId("doc");
+    const String_t base = RenderCache::makeKey("abc", opts);
+    TS_ASSERT_EQUALS(base, RenderCache::makeKey("abc", opts));
+    TS_ASSERT_DIFFERS(base, RenderCache::makeKey("abd", opts));
+
+    {
+        RenderOptions o2(opts);
+        o2.setDocumentId("other");
+        TS_ASSERT_DIFFERS(base, RenderCache::makeKey("abc", o2));
+    }
+    {
+        RenderOptions o2(opts);
+        o2.setSiteRoot("/");
+        TS_ASSERT_DIFFERS(base, RenderCache::makeKey("abc", o2));
+    }
+    {
+        RenderOptions o2(opts);
+        o2.setAssetRoot("/");
+        TS_ASSERT_DIFFERS(base, RenderCache::makeKey("abc", o2));
+    }
+    {
+        RenderOptions o2(opts);
+        o2.setDocumentRoot("/");
+        TS_ASSERT_DIFFERS(base, RenderCache::makeKey("abc", o2));
+    }
+    {
+        RenderOptions o2(opts);
+        o2.setDocumentLinkSuffix("/");
+        TS_ASSERT_DIFFERS(base, RenderCache::makeKey("abc", o2));
+    }
+
+    // Separators are not ambiguous
+    {
+        RenderOptions o1, o2;
+        o1.setSiteRoot("a");
+        o2.setAssetRoot("a");
+        TS_ASSERT_DIFFERS(RenderCache::makeKey("x", o1), RenderCache::makeKey("x", o2));
+    }
+}
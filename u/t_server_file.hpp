@@ -25,6 +25,7 @@ class TestServerFileClientDirectoryHandler : public CxxTest::TestSuite {
 class TestServerFileCommandHandler : public CxxTest::TestSuite {
  public:
     void testIt();
+    void testReadOnly();
 };
 
 class TestServerFileDirectoryHandler : public CxxTest::TestSuite {
@@ -124,6 +125,9 @@ class TestServerFileReadOnlyDirectoryHandler : public CxxTest::TestSuite {
 class TestServerFileRoot : public CxxTest::TestSuite {
  public:
     void testIt();
+    void testFlush();
+    void testCheckFlush();
+    void testStorageMutex();
 };
 
 class TestServerFileSession : public CxxTest::TestSuite {
@@ -144,6 +148,8 @@ class TestServerFileUtils : public CxxTest::TestSuite {
     void testSyncSame();
     void testSyncFileOverDir();
     void testSyncDirOverFile();
+    void testSyncContentId();
+    void testSyncClient();
 };
 
 #endif
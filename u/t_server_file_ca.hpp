@@ -42,6 +42,7 @@ class TestServerFileCaGarbageCollector : public CxxTest::TestSuite {
     void testModified();
     void testErrorCommit();
     void testErrorTree();
+    void testPack();
 };
 
 class TestServerFileCaInternalObjectCache : public CxxTest::TestSuite {
@@ -73,6 +74,43 @@ class TestServerFileCaObjectStore : public CxxTest::TestSuite {
     void testLarge();
     void testCache();
     void testCache2();
+    void testRepack();
+    void testRepackUnlink();
+    void testDeferred();
+    void testComputeId();
+};
+
+class TestServerFileCaPackBuilder : public CxxTest::TestSuite {
+ public:
+    void testEmpty();
+    void testIt();
+};
+
+class TestServerFileCaPackFile : public CxxTest::TestSuite {
+ public:
+    void testIt();
+    void testUnload();
+    void testBadIndex();
+    void testBadPack();
+};
+
+class TestServerFileCaPersistentIndex : public CxxTest::TestSuite {
+ public:
+    void testEmpty();
+    void testPersist();
+    void testMismatch();
+    void testDamaged();
+    void testCollision();
+};
+
+class TestServerFileCaPersistentObjectCache : public CxxTest::TestSuite {
+ public:
+    void testIt();
+};
+
+class TestServerFileCaPersistentReferenceCounter : public CxxTest::TestSuite {
+ public:
+    void testIt();
 };
 
 class TestServerFileCaReferenceCounter : public CxxTest::TestSuite {
@@ -90,6 +128,8 @@ class TestServerFileCaRoot : public CxxTest::TestSuite {
     void testEmpty();
     void testPreload();
     void testGarbage();
+    void testPersistentIndex();
+    void testDeferred();
 };
 
 #endif
@@ -353,3 +353,50 @@ TestServerFileCaGarbageCollector::testErrorTree()
     }
 }
 
+
+/** Test garbage collection with packs.
+    A: create some files. Repack. Modify with a new instance (=creates garbage). Repack again. Run GC.
+    E: garbage removed from packs. */
+void
+TestServerFileCaGarbageCollector::testPack()
+{
+    CxxTest::setAbortTestOnFail(true);
+
+    // Storage
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    createSomeFiles(rootHandler);
+    {
+        server::file::ca::Root t(rootHandler);
+        TS_ASSERT_EQUALS(t.objectStore().repack(), 4U);
+    }
+    modifyFiles(rootHandler);
+    {
+        server::file::ca::Root t(rootHandler);
+        TS_ASSERT_EQUALS(t.objectStore().repack(), 4U);
+        TS_ASSERT_EQUALS(t.objectStore().getNumPacks(), 2U);
+    }
+
+    // Garbage collector
+    {
+        afl::sys::Log log;
+        server::file::ca::Root t(rootHandler);
+        server::file::ca::GarbageCollector testee(t.objectStore(), log);
+        runGC(t, testee);
+
+        // Must not find any errors
+        TS_ASSERT_EQUALS(testee.getNumErrors(), 0U);
+
+        // Must keep 5 objects (commit, root tree, 'd', 'f', 'g')
+        TS_ASSERT_EQUALS(testee.getNumObjectsToKeep(), 5U);
+
+        // Must remove 3 objects (old commit, old root, old 'd')
+        TS_ASSERT_EQUALS(testee.getNumObjectsRemoved(), 3U);
+
+        // First pack has been rewritten, second one is unchanged
+        TS_ASSERT_EQUALS(t.objectStore().getNumPacks(), 2U);
+    }
+
+    // Verify content
+    checkFileContent(rootHandler, "moretext", "text");
+}
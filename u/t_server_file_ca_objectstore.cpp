@@ -314,3 +314,142 @@ TestServerFileCaObjectStore::testCache2()
     TS_ASSERT(count > 0);
     TS_ASSERT(count < 10);
 }
+
+/** Test repack().
+    A: create some objects. Repack.
+    E: objects moved into a pack; loose object directories removed; objects still accessible with a new ObjectStore. */
+void
+TestServerFileCaObjectStore::testRepack()
+{
+    using server::file::ca::ObjectId;
+    using server::file::ca::ObjectStore;
+
+    // Create test setup
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    ObjectId a, b, c;
+    {
+        ObjectStore testee(rootHandler);
+        a = testee.addObject(ObjectStore::DataObject, afl::string::toBytes("alpha"));
+        b = testee.addObject(ObjectStore::DataObject, afl::string::toBytes("bravo"));
+        c = testee.addObject(ObjectStore::TreeObject, afl::string::toBytes("charlie"));
+        TS_ASSERT_EQUALS(testee.getNumPacks(), 0U);
+
+        // Repack
+        TS_ASSERT_EQUALS(testee.repack(), 3U);
+        TS_ASSERT_EQUALS(testee.getNumPacks(), 1U);
+        TS_ASSERT(testee.getObjectDirectory(a.m_bytes[0]) == 0);
+
+        // Nothing more to pack
+        TS_ASSERT_EQUALS(testee.repack(), 0U);
+        TS_ASSERT_EQUALS(testee.getNumPacks(), 1U);
+    }
+
+    // Only the pack directory remains
+    server::file::DirectoryHandler::Info info;
+    TS_ASSERT(rootHandler.findItem("pack", info));
+    TS_ASSERT(!rootHandler.findItem(a.toHex().substr(0, 2), info));
+    TS_ASSERT(!rootHandler.findItem(b.toHex().substr(0, 2), info));
+    TS_ASSERT(!rootHandler.findItem(c.toHex().substr(0, 2), info));
+
+    // Retrieve with new instance
+    {
+        ObjectStore testee(rootHandler);
+        TS_ASSERT_EQUALS(testee.getNumPacks(), 1U);
+        TS_ASSERT_EQUALS(testee.getObjectSize(a, ObjectStore::DataObject), 5U);
+        TS_ASSERT(testee.getObject(b, ObjectStore::DataObject)->get().equalContent(afl::string::toBytes("bravo")));
+        TS_ASSERT(testee.getObject(c, ObjectStore::TreeObject)->get().equalContent(afl::string::toBytes("charlie")));
+        TS_ASSERT_THROWS(testee.getObject(c, ObjectStore::DataObject), std::runtime_error);
+
+        // Adding an existing object finds it in the pack
+        TS_ASSERT_EQUALS(testee.addObject(ObjectStore::DataObject, afl::string::toBytes("alpha")), a);
+
+        // Adding a new object creates a loose object; can be repacked
+        ObjectId d = testee.addObject(ObjectStore::DataObject, afl::string::toBytes("delta"));
+        TS_ASSERT(testee.getObjectDirectory(d.m_bytes[0]) != 0);
+        TS_ASSERT_EQUALS(testee.repack(), 1U);
+        TS_ASSERT_EQUALS(testee.getNumPacks(), 2U);
+        TS_ASSERT(testee.getObject(d, ObjectStore::DataObject)->get().equalContent(afl::string::toBytes("delta")));
+    }
+}
+
+/** Test unlinking packed objects.
+    A: create object, repack, unlink it.
+    E: must not fail; object remains in pack */
+void
+TestServerFileCaObjectStore::testRepackUnlink()
+{
+    using server::file::ca::ObjectId;
+    using server::file::ca::ObjectStore;
+
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    ObjectStore testee(rootHandler);
+    ObjectId a = testee.addObject(ObjectStore::DataObject, afl::string::toBytes("alpha"));
+    TS_ASSERT_EQUALS(testee.repack(), 1U);
+
+    TS_ASSERT_THROWS_NOTHING(testee.unlinkObject(ObjectStore::DataObject, a));
+    TS_ASSERT_EQUALS(testee.getObjectSize(a, ObjectStore::DataObject), 5U);
+}
+
+/** Test deferred write mode. */
+void
+TestServerFileCaObjectStore::testDeferred()
+{
+    using server::file::ca::ObjectId;
+    using server::file::ca::ObjectStore;
+
+    // A tree object (see testAddObject)
+    static const uint8_t CONTENT[] = {
+        0x31, 0x30, 0x30, 0x36, 0x34, 0x34, 0x20, 0x66, 0x69, 0x6c, 0x65, 0x00, 0x40, 0x14, 0x2d, 0x09,
+        0xc7, 0x2b, 0x2c, 0x25, 0x57, 0x0b, 0x98, 0x30, 0x0c, 0x27, 0xd8, 0x9c, 0x57, 0xed, 0x13, 0x2d
+    };
+
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    ObjectStore testee(rootHandler);
+    testee.setDeferredWrite(true);
+
+    // Data objects are written immediately; trees are kept
+    ObjectId data = testee.addObject(ObjectStore::DataObject, afl::string::toBytes("alpha"));
+    ObjectId tree = testee.addObject(ObjectStore::TreeObject, CONTENT);
+    TS_ASSERT_EQUALS(testee.getNumPendingObjects(), 1U);
+    TS_ASSERT_EQUALS(testee.getObjectSize(tree, ObjectStore::TreeObject), 32U);
+    TS_ASSERT_EQUALS(ObjectStore(rootHandler).getObjectSize(data, ObjectStore::DataObject), 5U);
+    TS_ASSERT_THROWS(ObjectStore(rootHandler).getObjectSize(tree, ObjectStore::TreeObject), afl::except::FileProblemException);
+
+    // A pending object that is released is never written
+    ObjectId empty = testee.addObject(ObjectStore::TreeObject, afl::base::Nothing);
+    TS_ASSERT_EQUALS(testee.getNumPendingObjects(), 2U);
+    testee.unlinkObject(ObjectStore::TreeObject, empty);
+    TS_ASSERT_EQUALS(testee.getNumPendingObjects(), 1U);
+
+    // Flush
+    TS_ASSERT_EQUALS(testee.flush(), 1U);
+    TS_ASSERT_EQUALS(testee.getNumPendingObjects(), 0U);
+    TS_ASSERT_EQUALS(testee.flush(), 0U);
+    TS_ASSERT_EQUALS(ObjectStore(rootHandler).getObjectSize(tree, ObjectStore::TreeObject), 32U);
+    TS_ASSERT_THROWS(ObjectStore(rootHandler).getObjectSize(empty, ObjectStore::TreeObject), afl::except::FileProblemException);
+}
+
+/** Test computeObjectId().
+    Ids must match those produced by addObject() and git. */
+void
+TestServerFileCaObjectStore::testComputeId()
+{
+    // "hello\n" -> ce013625030ba8dba906f756967f9e9ca394464a (git hash-object)
+    static const uint8_t CONTENT[] = {'h','e','l','l','o','\n'};
+    TS_ASSERT_EQUALS(server::file::ca::ObjectStore::computeObjectId(server::file::ca::ObjectStore::DataObject, CONTENT).toHex(),
+                     "ce013625030ba8dba906f756967f9e9ca394464a");
+
+    // Empty blob -> e69de29bb2d1d6434b8b29ae775ad8c2e48c5391
+    TS_ASSERT_EQUALS(server::file::ca::ObjectStore::computeObjectId(server::file::ca::ObjectStore::DataObject, afl::base::ConstBytes_t()).toHex(),
+                     "e69de29bb2d1d6434b8b29ae775ad8c2e48c5391");
+
+    // Same as addObject
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    server::file::ca::ObjectStore testee(rootHandler);
+    TS_ASSERT_EQUALS(testee.addObject(testee.DataObject, CONTENT),
+                     server::file::ca::ObjectStore::computeObjectId(server::file::ca::ObjectStore::DataObject, CONTENT));
+}
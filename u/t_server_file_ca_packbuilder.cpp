@@ -0,0 +1,92 @@
+/**
+  *  \file u/t_server_file_ca_packbuilder.cpp
+  *  \brief Test for server::file::ca::PackBuilder
+  */
+
+#include "server/file/ca/packbuilder.hpp"
+
+#include "t_server_file_ca.hpp"
+#include "server/file/internaldirectoryhandler.hpp"
+
+using server::file::ca::ObjectId;
+using server::file::ca::ObjectStore;
+using server::file::ca::PackBuilder;
+
+/** Test empty pack.
+    A: create PackBuilder, call finish() without adding objects.
+    E: pack and index created with correct size */
+void
+TestServerFileCaPackBuilder::testEmpty()
+{
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler handler("pack", dir);
+
+    PackBuilder testee;
+    TS_ASSERT_EQUALS(testee.getNumObjects(), 0U);
+    TS_ASSERT_EQUALS(testee.getSize(), 12U);
+
+    String_t name = testee.finish(handler);
+    TS_ASSERT_EQUALS(name.size(), 45U);
+    TS_ASSERT_EQUALS(name.substr(0, 5), "pack-");
+
+    // Pack: header (12) + checksum (20)
+    afl::base::Ref<afl::io::FileMapping> pack = handler.getFileByName(name + ".pack");
+    TS_ASSERT_EQUALS(pack->get().size(), 32U);
+    TS_ASSERT_SAME_DATA(pack->get().unsafeData(), "PACK\0\0\0\2\0\0\0\0", 12);
+
+    // Index: header (8) + fanout (1024) + checksums (40)
+    afl::base::Ref<afl::io::FileMapping> index = handler.getFileByName(name + ".idx");
+    TS_ASSERT_EQUALS(index->get().size(), 1072U);
+    TS_ASSERT_SAME_DATA(index->get().unsafeData(), "\377tOc\0\0\0\2", 8);
+
+    // Builder has been reset
+    TS_ASSERT_EQUALS(testee.getSize(), 12U);
+}
+
+/** Test pack with content.
+    A: create PackBuilder, add some objects, finish.
+    E: pack and index have correct header, index is sorted and has correct fan-out table */
+void
+TestServerFileCaPackBuilder::testIt()
+{
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler handler("pack", dir);
+
+    PackBuilder testee;
+    testee.addObject(ObjectId::fromHex("fd594a59b16db3e1f6fec8f05f703765a000bdb7"), ObjectStore::DataObject, afl::string::toBytes("000"));
+    testee.addObject(ObjectId::fromHex("3968aef87f28b2029667d95cd6e22f31b0bd2e50"), ObjectStore::DataObject, afl::string::toBytes("170"));
+    testee.addObject(ObjectId::fromHex("397bbf059739cbfa73aad2f8bf404d04f478b38a"), ObjectStore::TreeObject, afl::string::toBytes("xxx"));
+    TS_ASSERT_EQUALS(testee.getNumObjects(), 3U);
+    TS_ASSERT(testee.getSize() > 12U);
+
+    String_t name = testee.finish(handler);
+
+    // Pack header
+    afl::base::Ref<afl::io::FileMapping> pack = handler.getFileByName(name + ".pack");
+    TS_ASSERT_SAME_DATA(pack->get().unsafeData(), "PACK\0\0\0\2\0\0\0\3", 12);
+
+    // First object header: blob (3), size 3
+    TS_ASSERT_EQUALS(*pack->get().at(12), 0x33);
+
+    // Index: header (8) + fanout (1024) + 3 entries (28 each) + checksums (40)
+    afl::base::Ref<afl::io::FileMapping> index = handler.getFileByName(name + ".idx");
+    afl::base::ConstBytes_t indexBytes = index->get();
+    TS_ASSERT_EQUALS(indexBytes.size(), 1156U);
+
+    // Fan-out: 0 below 0x39, 2 for 0x39..0xFC, 3 from 0xFD
+    TS_ASSERT_SAME_DATA(indexBytes.subrange(8 + 4*0x38, 4).unsafeData(), "\0\0\0\0", 4);
+    TS_ASSERT_SAME_DATA(indexBytes.subrange(8 + 4*0x39, 4).unsafeData(), "\0\0\0\2", 4);
+    TS_ASSERT_SAME_DATA(indexBytes.subrange(8 + 4*0xFC, 4).unsafeData(), "\0\0\0\2", 4);
+    TS_ASSERT_SAME_DATA(indexBytes.subrange(8 + 4*0xFD, 4).unsafeData(), "\0\0\0\3", 4);
+    TS_ASSERT_SAME_DATA(indexBytes.subrange(8 + 4*0xFF, 4).unsafeData(), "\0\0\0\3", 4);
+
+    // Sorted Ids
+    TS_ASSERT_EQUALS(*indexBytes.at(1032), 0x39);
+    TS_ASSERT_EQUALS(*indexBytes.at(1033), 0x68);
+    TS_ASSERT_EQUALS(*indexBytes.at(1052), 0x39);
+    TS_ASSERT_EQUALS(*indexBytes.at(1053), 0x7b);
+    TS_ASSERT_EQUALS(*indexBytes.at(1072), 0xfd);
+
+    // Offset of first object ("fd...", added first)
+    TS_ASSERT_SAME_DATA(indexBytes.subrange(1032 + 3*24 + 8, 4).unsafeData(), "\0\0\0\14", 4);
+}
@@ -0,0 +1,199 @@
+/**
+  *  \file u/t_server_file_ca_packfile.cpp
+  *  \brief Test for server::file::ca::PackFile
+  */
+
+#include "server/file/ca/packfile.hpp"
+
+#include "t_server_file_ca.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/string/format.hpp"
+#include "server/file/ca/packbuilder.hpp"
+#include "server/file/internaldirectoryhandler.hpp"
+
+using server::file::ca::ObjectId;
+using server::file::ca::ObjectStore;
+using server::file::ca::PackBuilder;
+using server::file::ca::PackFile;
+
+namespace {
+    const char*const ID_A = "fd594a59b16db3e1f6fec8f05f703765a000bdb7";
+    const char*const ID_B = "3968aef87f28b2029667d95cd6e22f31b0bd2e50";
+    const char*const ID_C = "397bbf059739cbfa73aad2f8bf404d04f478b38a";
+
+    String_t createPack(server::file::DirectoryHandler& handler, afl::base::ConstBytes_t large)
+    {
+        PackBuilder b;
+        b.addObject(ObjectId::fromHex(ID_A), ObjectStore::DataObject, afl::string::toBytes("000"));
+        b.addObject(ObjectId::fromHex(ID_B), ObjectStore::CommitObject, afl::string::toBytes("170"));
+        b.addObject(ObjectId::fromHex(ID_C), ObjectStore::TreeObject, large);
+        return b.finish(handler);
+    }
+}
+
+/** Test regular operation.
+    A: create a pack. Open it with PackFile.
+    E: objects can be found and read back */
+void
+TestServerFileCaPackFile::testIt()
+{
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler handler("pack", dir);
+
+    // Some large content that needs multi-byte size and multiple inflate buffers
+    afl::base::GrowableBytes_t large;
+    for (int i = 0; i < 10000; ++i) {
+        large.append(afl::string::toBytes(afl::string::Format("%07d\n", i)));
+    }
+    String_t name = createPack(handler, large);
+
+    PackFile testee(handler, name);
+    TS_ASSERT_EQUALS(testee.getBaseName(), name);
+    TS_ASSERT_EQUALS(testee.getNumObjects(), 3U);
+    TS_ASSERT(!testee.isLoaded());
+
+    // Objects are sorted
+    TS_ASSERT_EQUALS(testee.getObjectId(0).toHex(), ID_B);
+    TS_ASSERT_EQUALS(testee.getObjectId(1).toHex(), ID_C);
+    TS_ASSERT_EQUALS(testee.getObjectId(2).toHex(), ID_A);
+    TS_ASSERT_EQUALS(testee.getObjectId(3), ObjectId::nil);
+
+    // Find
+    size_t a = 0, b = 0, c = 0, x = 0;
+    TS_ASSERT(testee.findObject(ObjectId::fromHex(ID_A), a));
+    TS_ASSERT(testee.findObject(ObjectId::fromHex(ID_B), b));
+    TS_ASSERT(testee.findObject(ObjectId::fromHex(ID_C), c));
+    TS_ASSERT(!testee.findObject(ObjectId::fromHex("397bbf059739cbfa73aad2f8bf404d04f478b38b"), x));
+    TS_ASSERT(!testee.findObject(ObjectId::fromHex("0000000000000000000000000000000000000000"), x));
+    TS_ASSERT(!testee.findObject(ObjectId::fromHex("ffffffffffffffffffffffffffffffffffffffff"), x));
+    TS_ASSERT_EQUALS(a, 2U);
+    TS_ASSERT_EQUALS(b, 0U);
+    TS_ASSERT_EQUALS(c, 1U);
+
+    // Read
+    {
+        ObjectStore::Type type;
+        size_t size;
+        afl::base::GrowableBytes_t content;
+        testee.readObject(a, type, size, &content);
+        TS_ASSERT_EQUALS(type, ObjectStore::DataObject);
+        TS_ASSERT_EQUALS(size, 3U);
+        TS_ASSERT(afl::base::ConstBytes_t(content).equalContent(afl::string::toBytes("000")));
+        TS_ASSERT(testee.isLoaded());
+    }
+    {
+        ObjectStore::Type type;
+        size_t size;
+        testee.readObject(b, type, size, 0);
+        TS_ASSERT_EQUALS(type, ObjectStore::CommitObject);
+        TS_ASSERT_EQUALS(size, 3U);
+    }
+    {
+        ObjectStore::Type type;
+        size_t size;
+        afl::base::GrowableBytes_t content;
+        testee.readObject(c, type, size, &content);
+        TS_ASSERT_EQUALS(type, ObjectStore::TreeObject);
+        TS_ASSERT_EQUALS(size, 80000U);
+        TS_ASSERT(afl::base::ConstBytes_t(content).equalContent(large));
+    }
+}
+
+/** Test unload().
+    A: create a pack, read object, unload, read again.
+    E: object can be read again after unload */
+void
+TestServerFileCaPackFile::testUnload()
+{
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler handler("pack", dir);
+    String_t name = createPack(handler, afl::string::toBytes("hi"));
+
+    PackFile testee(handler, name);
+    size_t index = 0;
+    TS_ASSERT(testee.findObject(ObjectId::fromHex(ID_C), index));
+
+    ObjectStore::Type type;
+    size_t size;
+    testee.readObject(index, type, size, 0);
+    TS_ASSERT(testee.isLoaded());
+
+    testee.unload();
+    TS_ASSERT(!testee.isLoaded());
+
+    afl::base::GrowableBytes_t content;
+    testee.readObject(index, type, size, &content);
+    TS_ASSERT(testee.isLoaded());
+    TS_ASSERT(afl::base::ConstBytes_t(content).equalContent(afl::string::toBytes("hi")));
+}
+
+/** Test bad index.
+    A: create bad index files.
+    E: constructor throws */
+void
+TestServerFileCaPackFile::testBadIndex()
+{
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler handler("pack", dir);
+
+    // Missing
+    TS_ASSERT_THROWS(PackFile(handler, "pack-missing"), std::exception);
+
+    // Too short
+    handler.createFile("pack-short.idx", afl::string::toBytes("\377tOc"));
+    TS_ASSERT_THROWS(PackFile(handler, "pack-short"), afl::except::FileProblemException);
+
+    // Wrong magic
+    {
+        afl::base::GrowableBytes_t data;
+        data.appendN(0, 1072);
+        handler.createFile("pack-magic.idx", data);
+        TS_ASSERT_THROWS(PackFile(handler, "pack-magic"), afl::except::FileProblemException);
+    }
+
+    // Count does not match size
+    {
+        afl::base::GrowableBytes_t data;
+        data.append(afl::string::toBytes("\377tOc"));
+        data.appendN(0, 3);
+        data.append(uint8_t(2));
+        data.appendN(0, 1020);
+        data.appendN(0, 3);
+        data.append(uint8_t(5));
+        data.appendN(0, 40);
+        handler.createFile("pack-count.idx", data);
+        TS_ASSERT_THROWS(PackFile(handler, "pack-count"), afl::except::FileProblemException);
+    }
+}
+
+/** Test bad pack.
+    A: create valid index but missing or bad pack.
+    E: constructor succeeds, readObject() throws */
+void
+TestServerFileCaPackFile::testBadPack()
+{
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler handler("pack", dir);
+    String_t name = createPack(handler, afl::string::toBytes("hi"));
+
+    ObjectStore::Type type;
+    size_t size;
+
+    // Missing pack
+    handler.removeFile(name + ".pack");
+    {
+        PackFile testee(handler, name);
+        TS_ASSERT_THROWS(testee.readObject(0, type, size, 0), std::exception);
+    }
+
+    // Bad pack header
+    static const uint8_t BAD_PACK[] = {
+        'P','A','C','K',0,0,0,2,0,0,0,4,
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+    };
+    handler.createFile(name + ".pack", BAD_PACK);
+    {
+        PackFile testee(handler, name);
+        TS_ASSERT_THROWS(testee.readObject(0, type, size, 0), afl::except::FileProblemException);
+    }
+}
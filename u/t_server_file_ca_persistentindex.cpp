@@ -0,0 +1,205 @@
+/**
+  *  \file u/t_server_file_ca_persistentindex.cpp
+  *  \brief Test for server::file::ca::PersistentIndex
+  */
+
+#include "server/file/ca/persistentindex.hpp"
+
+#include "t_server_file_ca.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "server/file/internaldirectoryhandler.hpp"
+
+using server::file::InternalDirectoryHandler;
+using server::file::ca::ObjectId;
+using server::file::ca::ObjectStore;
+using server::file::ca::PersistentIndex;
+
+namespace {
+    const ObjectId ID1 = ObjectId::fromHex("78d16fb0b0c1dede94861a7a328d8c4d16b5d7ff");
+    const ObjectId ID2 = ObjectId::fromHex("a7f8d9e5dcf3a68fdd2bfb727cde12029875260b");
+    const ObjectId MARKER1 = ObjectId::fromHex("1ec5873554c8cd604036b4b6c0221a5ded967637");
+    const ObjectId MARKER2 = ObjectId::fromHex("9aa7c49a27dd00dd2bdb9ce354f9a68cf04396b9");
+}
+
+/** Test empty index. */
+void
+TestServerFileCaPersistentIndex::testEmpty()
+{
+    InternalDirectoryHandler::Directory dir("");
+    InternalDirectoryHandler dh("index", dir);
+
+    PersistentIndex testee(dh, ObjectId::nil);
+    TS_ASSERT_EQUALS(testee.getNumObjects(), 0U);
+    TS_ASSERT_EQUALS(testee.getNumLogFiles(), 0U);
+
+    int32_t v;
+    size_t size;
+    TS_ASSERT(!testee.modifyReferenceCount(ID1, +1, v));
+    TS_ASSERT(!testee.getObjectSize(ID1, ObjectStore::DataObject, size));
+
+    // Committing without change does not write anything
+    testee.commit(ObjectId::nil);
+    TS_ASSERT_EQUALS(dir.files.size(), 0U);
+}
+
+/** Test persisting data across instances. */
+void
+TestServerFileCaPersistentIndex::testPersist()
+{
+    InternalDirectoryHandler::Directory dir("");
+    InternalDirectoryHandler dh("index", dir);
+
+    // Create data
+    {
+        PersistentIndex testee(dh, ObjectId::nil);
+        testee.setReferenceCount(ID1, 1);
+        testee.setObjectSize(ID1, ObjectStore::DataObject, 1234);
+        testee.setObjectSize(ID2, ObjectStore::TreeObject, 99);
+
+        int32_t v = 0;
+        TS_ASSERT(testee.modifyReferenceCount(ID1, +2, v));
+        TS_ASSERT_EQUALS(v, 3);
+        testee.commit(MARKER1);
+        TS_ASSERT_EQUALS(testee.getNumLogFiles(), 1U);
+    }
+
+    // Reload
+    {
+        PersistentIndex testee(dh, MARKER1);
+        TS_ASSERT_EQUALS(testee.getNumObjects(), 2U);
+        TS_ASSERT_EQUALS(testee.getNumLogFiles(), 1U);
+
+        int32_t v = 0;
+        TS_ASSERT(testee.modifyReferenceCount(ID1, 0, v));
+        TS_ASSERT_EQUALS(v, 3);
+        TS_ASSERT(!testee.modifyReferenceCount(ID2, 0, v));
+
+        size_t size = 0;
+        TS_ASSERT(testee.getObjectSize(ID1, ObjectStore::DataObject, size));
+        TS_ASSERT_EQUALS(size, 1234U);
+        TS_ASSERT(testee.getObjectSize(ID2, ObjectStore::TreeObject, size));
+        TS_ASSERT_EQUALS(size, 99U);
+
+        // Remove an object
+        testee.removeObject(ID2);
+        testee.commit(MARKER2);
+        TS_ASSERT_EQUALS(testee.getNumLogFiles(), 2U);
+    }
+
+    // Reload again
+    {
+        PersistentIndex testee(dh, MARKER2);
+        TS_ASSERT_EQUALS(testee.getNumObjects(), 1U);
+
+        size_t size = 0;
+        TS_ASSERT(!testee.getObjectSize(ID2, ObjectStore::TreeObject, size));
+
+        // Compact
+        testee.compact(MARKER2);
+        TS_ASSERT_EQUALS(testee.getNumLogFiles(), 0U);
+        TS_ASSERT_EQUALS(dir.files.size(), 1U);
+    }
+
+    // Reload from snapshot
+    {
+        PersistentIndex testee(dh, MARKER2);
+        TS_ASSERT_EQUALS(testee.getNumObjects(), 1U);
+        TS_ASSERT_EQUALS(testee.getNumLogFiles(), 0U);
+
+        int32_t v = 0;
+        TS_ASSERT(testee.modifyReferenceCount(ID1, -3, v));
+        TS_ASSERT_EQUALS(v, 0);
+        TS_ASSERT(!testee.modifyReferenceCount(ID1, 0, v));
+
+        size_t size = 0;
+        TS_ASSERT(testee.getObjectSize(ID1, ObjectStore::DataObject, size));
+        TS_ASSERT_EQUALS(size, 1234U);
+    }
+}
+
+/** Test marker mismatch.
+    If the master commit does not match the index, reference counts must be discarded, sizes are kept. */
+void
+TestServerFileCaPersistentIndex::testMismatch()
+{
+    InternalDirectoryHandler::Directory dir("");
+    InternalDirectoryHandler dh("index", dir);
+    {
+        PersistentIndex testee(dh, ObjectId::nil);
+        testee.setReferenceCount(ID1, 5);
+        testee.setReferenceCount(ID2, 7);
+        testee.setObjectSize(ID1, ObjectStore::DataObject, 1234);
+        testee.commit(MARKER1);
+    }
+
+    {
+        PersistentIndex testee(dh, MARKER2);
+        TS_ASSERT_EQUALS(testee.getNumObjects(), 1U);
+
+        int32_t v = 0;
+        TS_ASSERT(!testee.modifyReferenceCount(ID1, 0, v));
+        TS_ASSERT(!testee.modifyReferenceCount(ID2, 0, v));
+
+        size_t size = 0;
+        TS_ASSERT(testee.getObjectSize(ID1, ObjectStore::DataObject, size));
+        TS_ASSERT_EQUALS(size, 1234U);
+
+        // Index has been rewritten
+        TS_ASSERT_EQUALS(dir.files.size(), 1U);
+    }
+}
+
+/** Test damaged log file.
+    Loading must stop at the damaged file; later files must not be overwritten. */
+void
+TestServerFileCaPersistentIndex::testDamaged()
+{
+    InternalDirectoryHandler::Directory dir("");
+    InternalDirectoryHandler dh("index", dir);
+    {
+        PersistentIndex testee(dh, ObjectId::nil);
+        testee.setReferenceCount(ID1, 5);
+        testee.commit(MARKER1);
+        testee.setReferenceCount(ID2, 7);
+        testee.commit(MARKER1);
+    }
+
+    // Damage second log file
+    InternalDirectoryHandler::File* f = dh.findFile("log-00000002");
+    TS_ASSERT(f != 0);
+    if (f != 0) {
+        *f->content.at(f->content.size() - 1) ^= 1;
+    }
+
+    {
+        PersistentIndex testee(dh, MARKER1);
+        int32_t v = 0;
+        TS_ASSERT(testee.modifyReferenceCount(ID1, 0, v));
+        TS_ASSERT_EQUALS(v, 5);
+        TS_ASSERT(!testee.modifyReferenceCount(ID2, 0, v));
+
+        // Index has been rewritten; further updates must be loadable
+        TS_ASSERT(dh.findFile("log-00000002") == 0);
+        testee.setReferenceCount(ID2, 3);
+        testee.commit(MARKER2);
+    }
+    {
+        PersistentIndex testee(dh, MARKER2);
+        int32_t v = 0;
+        TS_ASSERT(testee.modifyReferenceCount(ID2, 0, v));
+        TS_ASSERT_EQUALS(v, 3);
+    }
+}
+
+/** Test type mismatch (hash collision). */
+void
+TestServerFileCaPersistentIndex::testCollision()
+{
+    InternalDirectoryHandler::Directory dir("");
+    InternalDirectoryHandler dh("index", dir);
+    PersistentIndex testee(dh, ObjectId::nil);
+    testee.setObjectSize(ID1, ObjectStore::DataObject, 10);
+
+    size_t size = 0;
+    TS_ASSERT_THROWS(testee.getObjectSize(ID1, ObjectStore::TreeObject, size), afl::except::FileProblemException);
+}
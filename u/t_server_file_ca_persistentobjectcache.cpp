@@ -0,0 +1,64 @@
+/**
+  *  \file u/t_server_file_ca_persistentobjectcache.cpp
+  *  \brief Test for server::file::ca::PersistentObjectCache
+  */
+
+#include "server/file/ca/persistentobjectcache.hpp"
+
+#include "t_server_file_ca.hpp"
+#include "afl/io/internalfilemapping.hpp"
+#include "server/file/ca/persistentindex.hpp"
+#include "server/file/internaldirectoryhandler.hpp"
+
+using server::file::ca::ObjectId;
+using server::file::ca::ObjectStore;
+
+/** Simple test. This plays a simple add/get/remove cycle, and checks that sizes survive. */
+void
+TestServerFileCaPersistentObjectCache::testIt()
+{
+    const ObjectId id = ObjectId::fromHex("78d16fb0b0c1dede94861a7a328d8c4d16b5d7ff");
+    const ObjectId id2 = ObjectId::fromHex("a7f8d9e5dcf3a68fdd2bfb727cde12029875260b");
+    size_t tmp = 0;
+
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler dh("index", dir);
+    {
+        server::file::ca::PersistentIndex index(dh, ObjectId::nil);
+        server::file::ca::PersistentObjectCache testee(index);
+
+        // Cache is empty and answers with negative response
+        TS_ASSERT(testee.getObject(id, ObjectStore::TreeObject).get() == 0);
+        TS_ASSERT(!testee.getObjectSize(id, ObjectStore::TreeObject).isValid());
+
+        // Add content
+        afl::base::GrowableMemory<uint8_t> mem;
+        mem.append(afl::string::toBytes("abcde"));
+        testee.addObject(id, ObjectStore::TreeObject, *new afl::io::InternalFileMapping(mem));
+        TS_ASSERT(testee.getObject(id, ObjectStore::TreeObject).get() != 0);
+        TS_ASSERT(testee.getObjectSize(id, ObjectStore::TreeObject).get(tmp));
+        TS_ASSERT_EQUALS(tmp, 5U);
+
+        // Add size
+        testee.addObjectSize(id2, ObjectStore::DataObject, 77);
+        TS_ASSERT(testee.getObject(id2, ObjectStore::DataObject).get() == 0);
+        TS_ASSERT(testee.getObjectSize(id2, ObjectStore::DataObject).get(tmp));
+        TS_ASSERT_EQUALS(tmp, 77U);
+
+        // Remove
+        testee.removeObject(id);
+        TS_ASSERT(testee.getObject(id, ObjectStore::TreeObject).get() == 0);
+        TS_ASSERT(!testee.getObjectSize(id, ObjectStore::TreeObject).isValid());
+
+        index.commit(ObjectId::nil);
+    }
+
+    // Sizes survive, content does not
+    {
+        server::file::ca::PersistentIndex index(dh, ObjectId::nil);
+        server::file::ca::PersistentObjectCache testee(index);
+        TS_ASSERT(!testee.getObjectSize(id, ObjectStore::TreeObject).isValid());
+        TS_ASSERT(testee.getObjectSize(id2, ObjectStore::DataObject).get(tmp));
+        TS_ASSERT_EQUALS(tmp, 77U);
+    }
+}
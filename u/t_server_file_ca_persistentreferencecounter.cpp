@@ -0,0 +1,47 @@
+/**
+  *  \file u/t_server_file_ca_persistentreferencecounter.cpp
+  *  \brief Test for server::file::ca::PersistentReferenceCounter
+  */
+
+#include "server/file/ca/persistentreferencecounter.hpp"
+
+#include "t_server_file_ca.hpp"
+#include "server/file/ca/persistentindex.hpp"
+#include "server/file/internaldirectoryhandler.hpp"
+
+/** Simple test. Same as for InternalReferenceCounter. */
+void
+TestServerFileCaPersistentReferenceCounter::testIt()
+{
+    using server::file::ca::ObjectId;
+
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::InternalDirectoryHandler dh("index", dir);
+    server::file::ca::PersistentIndex index(dh, ObjectId::nil);
+    server::file::ca::PersistentReferenceCounter testee(index);
+
+    ObjectId id = ObjectId::fromHex("12345");
+
+    // Initially empty
+    int32_t v;
+    TS_ASSERT(!testee.modify(id, +1, v));
+    TS_ASSERT(!testee.modify(id, -1, v));
+
+    // Set it
+    testee.set(id, 1);
+    TS_ASSERT(testee.modify(id, 0, v));
+    TS_ASSERT_EQUALS(v, 1);
+    TS_ASSERT(testee.modify(id, 2, v));
+    TS_ASSERT_EQUALS(v, 3);
+    TS_ASSERT(testee.modify(id, -3, v));
+    TS_ASSERT_EQUALS(v, 0);
+
+    // It's now zero, and should no longer be modifiable
+    TS_ASSERT(!testee.modify(id, 1, v));
+    TS_ASSERT_EQUALS(index.getNumObjects(), 0U);
+
+    // Set it again
+    testee.set(id, 1);
+    TS_ASSERT(testee.modify(id, 0, v));
+    TS_ASSERT_EQUALS(v, 1);
+}
@@ -186,3 +186,96 @@ TestServerFileCaRoot::testGarbage()
     TS_ASSERT_EQUALS(countObjects(rootHandler), 4U);
 }
 
+
+/** Test persistent index.
+    With the index enabled, garbage cleanup must continue to work after a restart. */
+void
+TestServerFileCaRoot::testPersistentIndex()
+{
+    using server::file::DirectoryHandler;
+
+    // Storage
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+
+    // Create stuff
+    {
+        server::file::ca::Root testee(rootHandler);
+        testee.enablePersistentIndex();
+        std::auto_ptr<DirectoryHandler> root(testee.createRootHandler());
+        std::auto_ptr<DirectoryHandler> dir1(root->getDirectory(root->createDirectory("dir1")));
+        std::auto_ptr<DirectoryHandler> dir2(root->getDirectory(root->createDirectory("dir2")));
+        dir1->createFile("a", afl::string::toBytes("content"));
+        dir2->createFile("a", afl::string::toBytes("content"));
+        TS_ASSERT_EQUALS(countObjects(rootHandler), 4U);
+    }
+    TS_ASSERT(rootHandler.findDirectory("c2index") != 0);
+
+    // Restart and update both files. Old objects must be removed.
+    {
+        server::file::ca::Root testee(rootHandler);
+        testee.enablePersistentIndex();
+        std::auto_ptr<DirectoryHandler> root(testee.createRootHandler());
+
+        DirectoryHandler::Info info;
+        TS_ASSERT(root->findItem("dir1", info));
+        std::auto_ptr<DirectoryHandler> dir1(root->getDirectory(info));
+        TS_ASSERT(root->findItem("dir2", info));
+        std::auto_ptr<DirectoryHandler> dir2(root->getDirectory(info));
+
+        dir2->createFile("a", afl::string::toBytes("newcontent"));
+        TS_ASSERT_EQUALS(countObjects(rootHandler), 6U);
+        dir1->createFile("a", afl::string::toBytes("newcontent"));
+        TS_ASSERT_EQUALS(countObjects(rootHandler), 4U);
+    }
+}
+
+/** Test deferred updates.
+    Changes must be kept in memory until flush(), and be complete afterwards. */
+void
+TestServerFileCaRoot::testDeferred()
+{
+    using server::file::DirectoryHandler;
+    using server::file::ca::ObjectId;
+
+    // Storage
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+
+    // Create stuff
+    {
+        server::file::ca::Root testee(rootHandler);
+        testee.setDeferredUpdates(true);
+        std::auto_ptr<DirectoryHandler> root(testee.createRootHandler());
+        std::auto_ptr<DirectoryHandler> dir(root->getDirectory(root->createDirectory("dir")));
+        dir->createFile("a", afl::string::toBytes("one"));
+        dir->createFile("b", afl::string::toBytes("two"));
+        dir->createFile("c", afl::string::toBytes("three"));
+
+        // Only file content has been written so far
+        TS_ASSERT_EQUALS(testee.getMasterCommitId(), ObjectId::nil);
+        TS_ASSERT_EQUALS(countObjects(rootHandler), 3U);
+
+        // Flush: 3 files, 2 trees, 1 commit; intermediate states have never been written
+        testee.flush();
+        TS_ASSERT_DIFFERS(testee.getMasterCommitId(), ObjectId::nil);
+        TS_ASSERT_EQUALS(countObjects(rootHandler), 6U);
+
+        // Modify again; destructor saves
+        dir->removeFile("c");
+        TS_ASSERT_EQUALS(countObjects(rootHandler), 6U);
+    }
+
+    // Verify
+    {
+        server::file::ca::Root testee(rootHandler);
+        std::auto_ptr<DirectoryHandler> root(testee.createRootHandler());
+        DirectoryHandler::Info info;
+        TS_ASSERT(root->findItem("dir", info));
+        std::auto_ptr<DirectoryHandler> dir(root->getDirectory(info));
+        TS_ASSERT(dir->findItem("a", info));
+        TS_ASSERT(dir->findItem("b", info));
+        TS_ASSERT(!dir->findItem("c", info));
+        TS_ASSERT_EQUALS(countObjects(rootHandler), 5U);
+    }
+}
@@ -56,3 +56,23 @@ TestServerFileCommandHandler::testIt()
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("LSREG").pushBackString("bar")), std::exception);
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("LSGAME").pushBackString("bar")), std::exception);
 }
+
+/** Test isReadOnlyCommand(). */
+void
+TestServerFileCommandHandler::testReadOnly()
+{
+    using server::file::CommandHandler;
+    TS_ASSERT(CommandHandler::isReadOnlyCommand("GET"));
+    TS_ASSERT(CommandHandler::isReadOnlyCommand("LS"));
+    TS_ASSERT(CommandHandler::isReadOnlyCommand("STAT"));
+    TS_ASSERT(CommandHandler::isReadOnlyCommand("LSGAME"));
+    TS_ASSERT(CommandHandler::isReadOnlyCommand("USAGE"));
+
+    TS_ASSERT(!CommandHandler::isReadOnlyCommand("PUT"));
+    TS_ASSERT(!CommandHandler::isReadOnlyCommand("CP"));
+    TS_ASSERT(!CommandHandler::isReadOnlyCommand("FORGET"));
+    TS_ASSERT(!CommandHandler::isReadOnlyCommand("PROPSET"));
+    TS_ASSERT(!CommandHandler::isReadOnlyCommand("RMDIR"));
+    TS_ASSERT(!CommandHandler::isReadOnlyCommand("XYZZY"));
+    TS_ASSERT(!CommandHandler::isReadOnlyCommand("get"));
+}
@@ -8,7 +8,10 @@
 #include "t_server_file.hpp"
 #include "server/file/directoryhandler.hpp"
 #include "server/file/directoryitem.hpp"
+#include "server/file/internaldirectoryhandler.hpp"
 #include "afl/io/internaldirectory.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/thread.hpp"
 
 /** Simple test. */
 void
@@ -48,3 +51,124 @@ TestServerFileRoot::testIt()
     testee.setMaxFileSize(16777216);
     TS_ASSERT_EQUALS(testee.getMaxFileSize(), 16777216U);
 }
+
+/** Test flush handler. */
+void
+TestServerFileRoot::testFlush()
+{
+    class Counter : public afl::base::Closure<void()> {
+     public:
+        Counter(int& count)
+            : m_count(count)
+            { }
+        void call()
+            { ++m_count; }
+     private:
+        int& m_count;
+    };
+
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::DirectoryItem item("(root)", 0, std::auto_ptr<server::file::DirectoryHandler>(new server::file::InternalDirectoryHandler("root", dir)));
+    server::file::Root testee(item, afl::io::InternalDirectory::create("(spec)"));
+
+    // No handler: no-op
+    TS_ASSERT_THROWS_NOTHING(testee.finishCommand());
+    TS_ASSERT_THROWS_NOTHING(testee.flush());
+
+    // Delay 0: flush after every command
+    int count = 0;
+    testee.setFlushHandler(new Counter(count), 0);
+    testee.finishCommand();
+    TS_ASSERT_EQUALS(count, 1);
+    testee.finishCommand();
+    TS_ASSERT_EQUALS(count, 2);
+
+    // Long delay: flush only on request
+    testee.setFlushHandler(new Counter(count), 1000000);
+    testee.finishCommand();
+    testee.finishCommand();
+    TS_ASSERT_EQUALS(count, 2);
+    testee.flush();
+    TS_ASSERT_EQUALS(count, 3);
+}
+
+/** Test periodic flush.
+    A: set a flush handler with a short delay; execute a command; call checkFlush() before and after the delay.
+    E: flush handler called once after the delay has elapsed */
+void
+TestServerFileRoot::testCheckFlush()
+{
+    class Counter : public afl::base::Closure<void()> {
+     public:
+        Counter(int& count)
+            : m_count(count)
+            { }
+        void call()
+            { ++m_count; }
+     private:
+        int& m_count;
+    };
+
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::DirectoryItem item("(root)", 0, std::auto_ptr<server::file::DirectoryHandler>(new server::file::InternalDirectoryHandler("root", dir)));
+    server::file::Root testee(item, afl::io::InternalDirectory::create("(spec)"));
+
+    // No handler: no-op
+    TS_ASSERT_THROWS_NOTHING(testee.checkFlush());
+
+    // Nothing pending: no flush
+    int count = 0;
+    testee.setFlushHandler(new Counter(count), 10);
+    afl::sys::Thread::sleep(20);
+    testee.checkFlush();
+    TS_ASSERT_EQUALS(count, 0);
+
+    // Command starts the clock; checkFlush() saves after the delay, once
+    testee.finishCommand();
+    TS_ASSERT_EQUALS(count, 0);
+    afl::sys::Thread::sleep(20);
+    testee.checkFlush();
+    TS_ASSERT_EQUALS(count, 1);
+    testee.checkFlush();
+    TS_ASSERT_EQUALS(count, 1);
+
+    // Long delay: checkFlush() does not save
+    testee.setFlushHandler(new Counter(count), 1000000);
+    testee.finishCommand();
+    testee.checkFlush();
+    TS_ASSERT_EQUALS(count, 1);
+}
+
+/** Test storage mutex.
+    A: lock the storage mutex, then call functions that lock it again from the same thread.
+    E: no deadlock; storageMutex() is documented to be locked recursively (afl::sys::Mutex is recursive). */
+void
+TestServerFileRoot::testStorageMutex()
+{
+    class Counter : public afl::base::Closure<void()> {
+     public:
+        Counter(int& count)
+            : m_count(count)
+            { }
+        void call()
+            { ++m_count; }
+     private:
+        int& m_count;
+    };
+
+    server::file::InternalDirectoryHandler::Directory dir("");
+    server::file::DirectoryItem item("(root)", 0, std::auto_ptr<server::file::DirectoryHandler>(new server::file::InternalDirectoryHandler("root", dir)));
+    server::file::Root testee(item, afl::io::InternalDirectory::create("(spec)"));
+    int count = 0;
+    testee.setFlushHandler(new Counter(count), 0);
+
+    afl::sys::MutexGuard outer(testee.storageMutex());
+    {
+        afl::sys::MutexGuard inner(testee.storageMutex());
+        item.readContent(testee);
+        testee.flush();
+    }
+    testee.finishCommand();
+    TS_ASSERT_EQUALS(count, 2);
+    TS_ASSERT(item.wasRead());
+}
@@ -7,7 +7,10 @@
 #include "server/file/utils.hpp"
 
 #include "t_server_file.hpp"
+#include "server/file/clientdirectoryhandler.hpp"
 #include "server/file/internaldirectoryhandler.hpp"
+#include "server/file/internalfileserver.hpp"
+#include "server/interface/filebaseclient.hpp"
 #include "afl/except/fileproblemexception.hpp"
 
 using server::file::InternalDirectoryHandler;
@@ -22,6 +25,47 @@ namespace {
         std::auto_ptr<server::file::DirectoryHandler> d(rootHandler.getDirectory(rootHandler.createDirectory("d")));
         d->createFile("f", afl::string::toBytes("abc"));
     }
+
+    /** DirectoryHandler that reports content Ids and counts file creations.
+        Uses the file content as content Id. */
+    class ContentIdDirectoryHandler : public InternalDirectoryHandler {
+     public:
+        ContentIdDirectoryHandler(String_t name, Directory& dir)
+            : InternalDirectoryHandler(name, dir),
+              m_numCreates(0)
+            { }
+        virtual void readContent(Callback& callback)
+            {
+                class Adder : public Callback {
+                 public:
+                    Adder(ContentIdDirectoryHandler& parent, Callback& callback)
+                        : m_parent(parent), m_callback(callback)
+                        { }
+                    virtual void addItem(const Info& info)
+                        {
+                            Info copy(info);
+                            if (copy.type == IsFile) {
+                                copy.contentId = afl::string::fromBytes(m_parent.getFileByName(copy.name)->get());
+                            }
+                            m_callback.addItem(copy);
+                        }
+                 private:
+                    ContentIdDirectoryHandler& m_parent;
+                    Callback& m_callback;
+                };
+                Adder a(*this, callback);
+                InternalDirectoryHandler::readContent(a);
+            }
+        virtual Info createFile(String_t name, afl::base::ConstBytes_t content)
+            {
+                ++m_numCreates;
+                return InternalDirectoryHandler::createFile(name, content);
+            }
+        int getNumCreates() const
+            { return m_numCreates; }
+     private:
+        int m_numCreates;
+    };
 }
 
 /** Test copying, recursively. */
@@ -228,3 +272,55 @@ TestServerFileUtils::testSyncDirOverFile()
     TS_ASSERT(outHandler.findDirectory("d") != 0);
 }
 
+/** Test synchronizeDirectories with content Ids.
+    Only files with differing content Id must be copied. */
+void
+TestServerFileUtils::testSyncContentId()
+{
+    InternalDirectoryHandler::Directory inDir("in");
+    ContentIdDirectoryHandler inHandler("in", inDir);
+    inHandler.createFile("a", afl::string::toBytes("xyz"));
+    inHandler.createFile("b", afl::string::toBytes("pqr"));
+
+    InternalDirectoryHandler::Directory outDir("out");
+    ContentIdDirectoryHandler outHandler("out", outDir);
+    outHandler.createFile("a", afl::string::toBytes("xyz"));
+    outHandler.createFile("b", afl::string::toBytes("old"));
+    TS_ASSERT_EQUALS(outHandler.getNumCreates(), 2);
+
+    TS_ASSERT_THROWS_NOTHING(server::file::synchronizeDirectories(outHandler, inHandler));
+
+    TS_ASSERT(outHandler.getFileByName("a")->get().equalContent(afl::string::toBytes("xyz")));
+    TS_ASSERT(outHandler.getFileByName("b")->get().equalContent(afl::string::toBytes("pqr")));
+    TS_ASSERT_EQUALS(outHandler.getNumCreates(), 3);
+}
+
+/** Test synchronizeDirectories from and to a ClientDirectoryHandler.
+    This transfers files in batches. */
+void
+TestServerFileUtils::testSyncClient()
+{
+    server::file::InternalFileServer fileServer;
+    server::interface::FileBaseClient client(fileServer);
+    client.createDirectoryTree("in/d");
+    client.putFile("in/a", "xyz");
+    client.putFile("in/b", "pqr");
+    client.putFile("in/d/f", "abc");
+
+    // Download
+    server::file::ClientDirectoryHandler inHandler(fileServer, "in");
+    InternalDirectoryHandler::Directory outDir("out");
+    InternalDirectoryHandler outHandler("out", outDir);
+    TS_ASSERT_THROWS_NOTHING(server::file::synchronizeDirectories(outHandler, inHandler));
+    TS_ASSERT(outHandler.getFileByName("a")->get().equalContent(afl::string::toBytes("xyz")));
+    TS_ASSERT(outHandler.getFileByName("b")->get().equalContent(afl::string::toBytes("pqr")));
+    TS_ASSERT(outHandler.findDirectory("d") != 0);
+
+    // Upload
+    client.createDirectory("copy");
+    server::file::ClientDirectoryHandler copyHandler(fileServer, "copy");
+    TS_ASSERT_THROWS_NOTHING(server::file::synchronizeDirectories(copyHandler, outHandler));
+    TS_ASSERT_EQUALS(client.getFile("copy/a"), "xyz");
+    TS_ASSERT_EQUALS(client.getFile("copy/b"), "pqr");
+    TS_ASSERT_EQUALS(client.getFile("copy/d/f"), "abc");
+}
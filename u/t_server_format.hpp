@@ -22,6 +22,7 @@ class TestServerFormatFormat : public CxxTest::TestSuite {
     void testPack();
     void testUnpack();
     void testUnpackAll();
+    void testUnpackCache();
 };
 
 class TestServerFormatHullPacker : public CxxTest::TestSuite {
@@ -63,6 +64,14 @@ class TestServerFormatTruehullPacker : public CxxTest::TestSuite {
     void testSmall();
 };
 
+class TestServerFormatUnpackCache : public CxxTest::TestSuite {
+ public:
+    void testIt();
+    void testKey();
+    void testExpire();
+    void testDisabled();
+};
+
 class TestServerFormatutils : public CxxTest::TestSuite {
  public:
     void testPackCost();
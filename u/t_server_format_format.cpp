@@ -11,6 +11,7 @@
 #include "afl/data/access.hpp"
 #include "afl/data/stringvalue.hpp"
 #include "game/test/files.hpp"
+#include "server/format/unpackcache.hpp"
 
 /** Test pack(). */
 void
@@ -244,3 +245,39 @@ TestServerFormatFormat::testUnpackAll()
     }
 }
 
+
+/** Test unpack() with cache.
+    A: create Format with an UnpackCache. Unpack the same data repeatedly.
+    E: repeated requests are answered from the cache and produce the same result */
+void
+TestServerFormatFormat::testUnpackCache()
+{
+    using afl::data::Access;
+    server::format::UnpackCache cache(10);
+    server::format::Format testee(&cache);
+
+    afl::data::StringValue sv("\x84");
+
+    // First call: cache miss
+    std::auto_ptr<afl::data::Value> p1(testee.unpack("string", &sv, afl::base::Nothing, String_t("cp437")));
+    TS_ASSERT_EQUALS(Access(p1).toString(), "\xC3\xA4");
+    TS_ASSERT_EQUALS(cache.getNumHits(), 0U);
+    TS_ASSERT_EQUALS(cache.getNumMisses(), 1U);
+    TS_ASSERT_EQUALS(cache.getNumEntries(), 1U);
+
+    // Second call: cache hit
+    std::auto_ptr<afl::data::Value> p2(testee.unpack("string", &sv, afl::base::Nothing, String_t("cp437")));
+    TS_ASSERT_EQUALS(Access(p2).toString(), "\xC3\xA4");
+    TS_ASSERT_EQUALS(cache.getNumHits(), 1U);
+    TS_ASSERT_EQUALS(cache.getNumEntries(), 1U);
+
+    // Different character set: cache miss
+    std::auto_ptr<afl::data::Value> p3(testee.unpack("string", &sv, afl::base::Nothing, afl::base::Nothing));
+    TS_ASSERT_EQUALS(Access(p3).toString(), "\xC2\x84");
+    TS_ASSERT_EQUALS(cache.getNumHits(), 1U);
+    TS_ASSERT_EQUALS(cache.getNumEntries(), 2U);
+
+    // Errors are not cached
+    TS_ASSERT_THROWS(testee.unpack("whatever", &sv, afl::base::Nothing, afl::base::Nothing), std::exception);
+    TS_ASSERT_EQUALS(cache.getNumEntries(), 2U);
+}
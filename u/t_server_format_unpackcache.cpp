@@ -0,0 +1,102 @@
+/**
+  *  \file u/t_server_format_unpackcache.cpp
+  *  \brief Test for server::format::UnpackCache
+  */
+
+#include <memory>
+#include "server/format/unpackcache.hpp"
+
+#include "t_server_format.hpp"
+#include "afl/data/access.hpp"
+#include "afl/data/integervalue.hpp"
+#include "afl/data/stringvalue.hpp"
+
+using afl::data::Access;
+using afl::data::Value;
+using server::format::UnpackCache;
+
+/** Basic operation.
+    A: store a value, retrieve it.
+    E: a copy of the value is returned; statistics are updated */
+void
+TestServerFormatUnpackCache::testIt()
+{
+    UnpackCache testee(10);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+
+    // Miss
+    const String_t key = UnpackCache::makeKey("string", false, "", "data");
+    TS_ASSERT(testee.get(key) == 0);
+    TS_ASSERT_EQUALS(testee.getNumMisses(), 1U);
+
+    // Store
+    afl::data::StringValue sv("result");
+    testee.put(key, &sv);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+
+    // Hit
+    std::auto_ptr<Value> p(testee.get(key));
+    TS_ASSERT(p.get() != 0);
+    TS_ASSERT_DIFFERS(p.get(), static_cast<Value*>(&sv));
+    TS_ASSERT_EQUALS(Access(p.get()).toString(), "result");
+    TS_ASSERT_EQUALS(testee.getNumHits(), 1U);
+
+    // Store null (e.g. unpacking produced nothing): hit, but null
+    const String_t key2 = UnpackCache::makeKey("string", false, "", "other");
+    testee.put(key2, 0);
+    TS_ASSERT(testee.get(key2) == 0);
+    TS_ASSERT_EQUALS(testee.getNumHits(), 2U);
+}
+
+/** Test makeKey().
+    A: build keys from different parameters.
+    E: every parameter affects the key */
+void
+TestServerFormatUnpackCache::testKey()
+{
+    const String_t base = UnpackCache::makeKey("hullspec", false, "", "data");
+    TS_ASSERT_EQUALS(base, UnpackCache::makeKey("hullspec", false, "", "data"));
+    TS_ASSERT_DIFFERS(base, UnpackCache::makeKey("engspec", false, "", "data"));
+    TS_ASSERT_DIFFERS(base, UnpackCache::makeKey("hullspec", true, "", "data"));
+    TS_ASSERT_DIFFERS(base, UnpackCache::makeKey("hullspec", false, "cp437", "data"));
+    TS_ASSERT_DIFFERS(base, UnpackCache::makeKey("hullspec", false, "", "date"));
+}
+
+/** Test expiry.
+    A: store more values than the cache can hold.
+    E: least-recently used value is dropped */
+void
+TestServerFormatUnpackCache::testExpire()
+{
+    UnpackCache testee(2);
+    afl::data::IntegerValue v1(1), v2(2), v3(3);
+    testee.put("a", &v1);
+    testee.put("b", &v2);
+
+    // Use "a", so "b" is oldest
+    delete testee.get("a");
+
+    // Store third value
+    testee.put("c", &v3);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 2U);
+
+    std::auto_ptr<Value> pa(testee.get("a"));
+    std::auto_ptr<Value> pb(testee.get("b"));
+    std::auto_ptr<Value> pc(testee.get("c"));
+    TS_ASSERT_EQUALS(Access(pa.get()).toInteger(), 1);
+    TS_ASSERT(pb.get() == 0);
+    TS_ASSERT_EQUALS(Access(pc.get()).toInteger(), 3);
+}
+
+/** Test disabled cache.
+    A: create cache with size 0; store a value.
+    E: nothing is stored */
+void
+TestServerFormatUnpackCache::testDisabled()
+{
+    UnpackCache testee(0);
+    afl::data::IntegerValue v1(1);
+    testee.put("a", &v1);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+    TS_ASSERT(testee.get("a") == 0);
+}
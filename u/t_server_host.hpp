@@ -68,6 +68,7 @@ class TestServerHostExporter : public CxxTest::TestSuite {
  public:
     void testIt();
     void testUnpackBackups();
+    void testIncremental();
 };
 
 class TestServerHostGame : public CxxTest::TestSuite {
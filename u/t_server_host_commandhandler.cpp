@@ -92,6 +92,9 @@ namespace {
 
         virtual void suspendScheduler(server::Time_t /*absTime*/)
             { }
+
+        virtual Status_t getStatus()
+            { return Status_t(); }
     };
 }
 
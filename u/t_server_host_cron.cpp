@@ -21,6 +21,8 @@ TestServerHostCron::testInterface()
             { }
         virtual void suspendScheduler(server::Time_t /*absTime*/)
             { }
+        virtual Status_t getStatus()
+            { return Status_t(); }
     };
     Tester t;
 }
@@ -375,3 +375,83 @@ TestServerHostExporter::testUnpackBackups()
     TS_ASSERT_THROWS(hostFile.getFile("games/0042/backup/other/other.txt"), std::exception);
 }
 
+/** Test incremental export.
+    A second export into the same directory must produce the same result as a fresh export,
+    i.e. pick up changes from the host filer and remove stale files. */
+void
+TestServerHostExporter::testIncremental()
+{
+    // Prepare:
+    server::host::Configuration config;
+    config.incrementalExport = true;
+    TestHarness h(config);
+
+    // - static files
+    server::interface::FileBaseClient hostFile(h.hostFile());
+    hostFile.createDirectory("bin");
+    hostFile.createDirectory("defaults");
+    hostFile.createDirectory("games");
+    hostFile.putFile("bin/runhost.sh", "script...");
+
+    // - game files
+    hostFile.createDirectory("games/0042");
+    hostFile.createDirectory("games/0042/data");
+    hostFile.createDirectory("games/0042/in");
+    hostFile.createDirectory("games/0042/out");
+    hostFile.putFile("games/0042/data/data.txt", "data file");
+    hostFile.putFile("games/0042/data/keep.txt", "unchanged file");
+
+    // - game data
+    StringKey(h.db(), "game:42:dir").set("games/0042");
+    StringKey(h.db(), "game:42:name").set("Inc");
+    HashKey(h.db(), "game:42:settings").intField("turn").set(12);
+    IntegerSetKey(h.db(), "game:all").add(42);
+
+    // - game object
+    server::host::Game game(h.root(), 42);
+
+    // Directory name
+    TS_ASSERT_EQUALS(server::host::getExportDirectoryName(config, 42, "check"), "game42");
+    TS_ASSERT_EQUALS(server::host::getExportDirectoryName(server::host::Configuration(), 42, "check"), "check");
+
+    // First export
+    afl::io::FileSystem& fs = h.fileSystem();
+    server::host::Exporter testee(h.hostFile(), fs, h.root().log());
+    const String_t relativeName = testee.exportGame(game, h.root(), h.getWorkDirName());
+    const String_t baseDirName = fs.makePathName(fs.getWorkingDirectoryName(), h.getWorkDirName());
+    const String_t gameDirName = fs.makePathName(baseDirName, relativeName);
+    TS_ASSERT_EQUALS(readFileContent(fs, fs.makePathName(gameDirName, "data/data.txt")), "data file");
+
+    // Simulate a host run: modify a file, create a file, a log file and a backup
+    fs.openFile(fs.makePathName(gameDirName, "data/data.txt"), fs.Create)->fullWrite(afl::string::toBytes("hosted data"));
+    fs.openFile(fs.makePathName(gameDirName, "out/out.txt"), fs.Create)->fullWrite(afl::string::toBytes("result"));
+    fs.openFile(fs.makePathName(gameDirName, "host.log"), fs.Create)->fullWrite(afl::string::toBytes("log"));
+    fs.openFile(fs.makePathName(gameDirName, "backup/b.txt"), fs.Create)->fullWrite(afl::string::toBytes("backup"));
+    TS_ASSERT_THROWS_NOTHING(testee.importGame(game, h.root(), h.getWorkDirName()));
+
+    TS_ASSERT_EQUALS(hostFile.getFile("games/0042/data/data.txt"), "hosted data");
+    TS_ASSERT_EQUALS(hostFile.getFile("games/0042/data/keep.txt"), "unchanged file");
+    TS_ASSERT_EQUALS(hostFile.getFile("games/0042/out/out.txt"), "result");
+    TS_ASSERT_EQUALS(hostFile.getFile("games/0042/host.log"), "log");
+
+    // Modify host filer; leave junk in work directory
+    hostFile.putFile("games/0042/in/player3.trn", "turn");
+    hostFile.removeFile("games/0042/out/out.txt");
+    fs.openFile(fs.makePathName(gameDirName, "data/junk.txt"), fs.Create)->fullWrite(afl::string::toBytes("junk"));
+    fs.openFile(fs.makePathName(baseDirName, "junk.txt"), fs.Create)->fullWrite(afl::string::toBytes("junk"));
+
+    // Second export
+    TS_ASSERT_EQUALS(testee.exportGame(game, h.root(), h.getWorkDirName()), relativeName);
+
+    // Verify
+    TS_ASSERT_EQUALS(readFileContent(fs, fs.makePathName(gameDirName, "data/data.txt")), "hosted data");
+    TS_ASSERT_EQUALS(readFileContent(fs, fs.makePathName(gameDirName, "data/keep.txt")), "unchanged file");
+    TS_ASSERT_EQUALS(readFileContent(fs, fs.makePathName(gameDirName, "in/player3.trn")), "turn");
+    TS_ASSERT_EQUALS(readFileContent(fs, fs.makePathName(baseDirName, "bin/runhost.sh")), "script...");
+    TS_ASSERT_THROWS(fs.openFile(fs.makePathName(gameDirName, "out/out.txt"), fs.OpenRead), std::exception);
+    TS_ASSERT_THROWS(fs.openFile(fs.makePathName(gameDirName, "data/junk.txt"), fs.OpenRead), std::exception);
+    TS_ASSERT_THROWS(fs.openFile(fs.makePathName(gameDirName, "host.log"), fs.OpenRead), std::exception);
+    TS_ASSERT_THROWS(fs.openFile(fs.makePathName(gameDirName, "backup/b.txt"), fs.OpenRead), std::exception);
+    TS_ASSERT_THROWS(fs.openFile(fs.makePathName(baseDirName, "junk.txt"), fs.OpenRead), std::exception);
+    TS_ASSERT_DIFFERS(readFileContent(fs, fs.makePathName(gameDirName, "c2host.ini")), "");
+}
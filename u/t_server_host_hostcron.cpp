@@ -52,6 +52,12 @@ namespace {
         virtual void suspendScheduler(server::Time_t absTime)
             { checkCall(Format("suspendScheduler(%d)", absTime ? 1 : 0)); }
 
+        virtual Status_t getStatus()
+            {
+                checkCall("getStatus()");
+                return consumeReturnValue<Status_t>();
+            }
+
         void provideSampleList();
     };
 
@@ -142,6 +148,12 @@ TestServerHostHostCron::testNull()
     // Suspend
     TS_ASSERT_THROWS_NOTHING(testee.suspendScheduler(0));
     TS_ASSERT_THROWS_NOTHING(testee.suspendScheduler(1));
+
+    // Status
+    HostCron::Status st = testee.getStatus();
+    TS_ASSERT_EQUALS(st.numWaitingGames, 0);
+    TS_ASSERT_EQUALS(st.numRunningGames, 0);
+    TS_ASSERT_EQUALS(st.numWorkers, 0);
 }
 
 /** Test operation with a cron instance (standard). */
@@ -209,6 +221,28 @@ TestServerHostHostCron::testNonNull()
     m.expectCall("suspendScheduler(1)");
     TS_ASSERT_THROWS_NOTHING(testee.suspendScheduler(77));
 
+    // Status
+    {
+        HostCron::Status st;
+        st.numWaitingGames = 3;
+        st.numRunningGames = 2;
+        st.numWorkers = 4;
+        m.expectCall("getStatus()");
+        m.provideReturnValue(st);
+
+        HostCron::Status result = testee.getStatus();
+        TS_ASSERT_EQUALS(result.numWaitingGames, 3);
+        TS_ASSERT_EQUALS(result.numRunningGames, 2);
+        TS_ASSERT_EQUALS(result.numWorkers, 4);
+    }
+
+    // Status requires admin
+    {
+        server::host::Session userSession;
+        userSession.setUser("u");
+        TS_ASSERT_THROWS(server::host::HostCron(userSession, h.root()).getStatus(), std::exception);
+    }
+
     m.checkFinish();
 }
 
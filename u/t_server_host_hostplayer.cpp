@@ -94,6 +94,9 @@ namespace {
 
         virtual void suspendScheduler(server::Time_t absTime)
             { checkCall(Format("suspendScheduler(%d)", absTime)); }
+
+        virtual Status_t getStatus()
+            { return Status_t(); }
     };
 }
 
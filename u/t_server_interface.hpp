@@ -17,6 +17,13 @@ class TestServerInterfaceBaseClient : public CxxTest::TestSuite {
     void testIt();
 };
 
+class TestServerInterfaceCommandBatch : public CxxTest::TestSuite {
+ public:
+    void testSequential();
+    void testBatch();
+    void testRemoteError();
+};
+
 class TestServerInterfaceComposableCommandHandler : public CxxTest::TestSuite {
  public:
     void testIt();
@@ -49,6 +56,7 @@ class TestServerInterfaceFileBase : public CxxTest::TestSuite {
 class TestServerInterfaceFileBaseClient : public CxxTest::TestSuite {
  public:
     void testIt();
+    void testMultiple();
 };
 
 class TestServerInterfaceFileBaseServer : public CxxTest::TestSuite {
@@ -323,6 +331,12 @@ class TestServerInterfaceMailQueueServer : public CxxTest::TestSuite {
     void testRoundtrip();
 };
 
+class TestServerInterfacePipelinedClient : public CxxTest::TestSuite {
+ public:
+    void testIt();
+    void testReconnect();
+};
+
 class TestServerInterfaceSessionRouter : public CxxTest::TestSuite {
  public:
     void testInterface();
@@ -0,0 +1,145 @@
+/**
+  *  \file u/t_server_interface_commandbatch.cpp
+  *  \brief Test for server::interface::CommandBatch
+  */
+
+#include <stdexcept>
+#include "server/interface/commandbatch.hpp"
+
+#include "t_server_interface.hpp"
+#include "afl/except/remoteerrorexception.hpp"
+#include "server/interface/batchcommandhandler.hpp"
+#include "server/types.hpp"
+
+using server::interface::CommandBatch;
+
+namespace {
+    /* CommandHandler that echoes its first parameter, or fails for "FAIL" and "REMOTE". */
+    class EchoHandler : public afl::net::CommandHandler {
+     public:
+        EchoHandler()
+            : m_numCalls(0)
+            { }
+        virtual Value_t* call(const Segment_t& command)
+            {
+                ++m_numCalls;
+                String_t verb = server::toString(command[0]);
+                if (verb == "FAIL") {
+                    throw std::runtime_error("fail");
+                }
+                if (verb == "REMOTE") {
+                    throw afl::except::RemoteErrorException("echo", "401 denied");
+                }
+                return server::makeStringValue(server::toString(command[1]));
+            }
+        virtual void callVoid(const Segment_t& command)
+            { delete call(command); }
+        int getNumCalls() const
+            { return m_numCalls; }
+     private:
+        int m_numCalls;
+    };
+
+    /* BatchCommandHandler that records the batches it receives. */
+    class BatchHandler : public server::interface::BatchCommandHandler {
+     public:
+        BatchHandler()
+            : m_numBatches(0)
+            { }
+        virtual Value_t* call(const Segment_t& /*command*/)
+            {
+                TS_FAIL("call unexpected");
+                return 0;
+            }
+        virtual void callVoid(const Segment_t& /*command*/)
+            { TS_FAIL("callVoid unexpected"); }
+        virtual void callBatch(CommandBatch& batch)
+            {
+                ++m_numBatches;
+                for (size_t i = 0, n = batch.size(); i < n; ++i) {
+                    batch.setResult(i, server::makeIntegerValue(int32_t(batch.getCommand(i).size())));
+                }
+            }
+        int getNumBatches() const
+            { return m_numBatches; }
+     private:
+        int m_numBatches;
+    };
+}
+
+/** Test executing a batch on a regular CommandHandler. */
+void
+TestServerInterfaceCommandBatch::testSequential()
+{
+    CommandBatch testee;
+    testee.add().pushBackString("ECHO").pushBackString("a");
+    testee.add().pushBackString("FAIL");
+    testee.add().pushBackString("ECHO").pushBackString("c");
+    TS_ASSERT_EQUALS(testee.size(), 3U);
+
+    // All commands are executed, despite the failure
+    EchoHandler handler;
+    testee.execute(handler);
+    TS_ASSERT_EQUALS(handler.getNumCalls(), 3);
+
+    TS_ASSERT(!testee.isError(0));
+    TS_ASSERT_EQUALS(server::toString(testee.getResult(0)), "a");
+    TS_ASSERT(testee.isError(1));
+    TS_ASSERT_THROWS(testee.getResult(1), std::exception);
+    TS_ASSERT(!testee.isError(2));
+    TS_ASSERT_EQUALS(server::toString(testee.getResult(2)), "c");
+
+    testee.clear();
+    TS_ASSERT_EQUALS(testee.size(), 0U);
+}
+
+/** Test executing a batch on a BatchCommandHandler. */
+void
+TestServerInterfaceCommandBatch::testBatch()
+{
+    CommandBatch testee;
+    testee.add().pushBackString("A");
+    testee.add().pushBackString("B").pushBackString("b");
+
+    BatchHandler handler;
+    testee.execute(handler);
+    TS_ASSERT_EQUALS(handler.getNumBatches(), 1);
+    TS_ASSERT_EQUALS(server::toInteger(testee.getResult(0)), 1);
+    TS_ASSERT_EQUALS(server::toInteger(testee.getResult(1)), 2);
+}
+
+/** Test remote errors.
+    A: execute a batch where one command fails with a RemoteErrorException.
+    E: getResult() reports the same exception type as a single call; other errors are unaffected. */
+void
+TestServerInterfaceCommandBatch::testRemoteError()
+{
+    CommandBatch testee;
+    testee.add().pushBackString("REMOTE");
+    testee.add().pushBackString("FAIL");
+
+    EchoHandler handler;
+    testee.execute(handler);
+
+    TS_ASSERT(testee.isError(0));
+    TS_ASSERT_THROWS(testee.getResult(0), afl::except::RemoteErrorException);
+    try {
+        testee.getResult(0);
+    }
+    catch (afl::except::RemoteErrorException& e) {
+        TS_ASSERT_EQUALS(e.getFileName(), "echo");
+        TS_ASSERT_EQUALS(String_t(e.what()), "401 denied");
+    }
+
+    TS_ASSERT(testee.isError(1));
+    TS_ASSERT_THROWS(testee.getResult(1), std::runtime_error);
+
+    // Remote error set by a BatchCommandHandler
+    testee.setRemoteError(1, "other", "500 error");
+    TS_ASSERT_THROWS(testee.getResult(1), afl::except::RemoteErrorException);
+
+    // Result resets the error
+    testee.setResult(1, 0);
+    TS_ASSERT(!testee.isError(1));
+    TS_ASSERT(testee.getResult(1) == 0);
+}
@@ -17,6 +17,10 @@ TestServerInterfaceDocumentation::testInterface()
             { return String_t(); }
         virtual String_t renderNode(String_t /*nodeId*/, const RenderOptions& /*opts*/)
             { return String_t(); }
+        virtual int32_t prerenderNodes(const RenderOptions& /*opts*/)
+            { return 0; }
+        virtual CacheStatus getCacheStatus()
+            { return CacheStatus(); }
         virtual NodeInfo getNodeInfo(String_t /*nodeId*/)
             { return NodeInfo(); }
         virtual std::vector<NodeInfo> getNodeChildren(String_t /*nodeId*/, const ChildOptions& /*opts*/)
@@ -27,6 +31,8 @@ TestServerInterfaceDocumentation::testInterface()
             { return std::vector<NodeInfo>(); }
         virtual std::vector<NodeInfo> getNodeRelatedVersions(String_t /*nodeId*/)
             { return std::vector<NodeInfo>(); }
+        virtual std::vector<SearchResult> search(String_t /*query*/, const SearchOptions& /*opts*/)
+            { return std::vector<SearchResult>(); }
     };
     Tester t;
 }
@@ -74,6 +74,33 @@ TestServerInterfaceDocumentationClient::testIt()
         TS_ASSERT_EQUALS(testee.renderNode("a/b", opts), "more text");
     }
 
+    // prerenderNodes
+    {
+        mock.expectCall("PRERENDER, DOC, d/");
+        mock.provideNewResult(makeIntegerValue(42));
+
+        Documentation::RenderOptions opts;
+        opts.docRoot = "d/";
+        TS_ASSERT_EQUALS(testee.prerenderNodes(opts), 42);
+    }
+
+    // getCacheStatus
+    {
+        Hash::Ref_t h = Hash::create();
+        h->setNew("entries", makeIntegerValue(5));
+        h->setNew("size", makeIntegerValue(12345));
+        h->setNew("hits", makeIntegerValue(100));
+        h->setNew("misses", makeIntegerValue(20));
+        mock.expectCall("CACHESTAT");
+        mock.provideNewResult(new HashValue(h));
+
+        Documentation::CacheStatus st = testee.getCacheStatus();
+        TS_ASSERT_EQUALS(st.numEntries, 5);
+        TS_ASSERT_EQUALS(st.totalSize, 12345);
+        TS_ASSERT_EQUALS(st.numHits, 100);
+        TS_ASSERT_EQUALS(st.numMisses, 20);
+    }
+
     // getNodeInfo
     {
         mock.expectCall("STAT, x");
@@ -148,6 +175,35 @@ TestServerInterfaceDocumentationClient::testIt()
         TS_ASSERT_EQUALS(nis.size(), 0U);
     }
 
+    // search
+    {
+        Hash::Ref_t h = Hash::create();
+        h->setNew("id", makeStringValue("doc/page"));
+        h->setNew("title", makeStringValue("The Page"));
+        h->setNew("snippet", makeStringValue("some text"));
+        h->setNew("score", makeIntegerValue(120));
+        Vector::Ref_t v = Vector::create();
+        v->pushBackNew(new HashValue(h));
+
+        mock.expectCall("SEARCH, fuel, IN, doc, LIMIT, 10");
+        mock.provideNewResult(new VectorValue(v));
+
+        Documentation::SearchOptions opts;
+        opts.docId = "doc";
+        opts.maxResults = 10;
+        std::vector<Documentation::SearchResult> result = testee.search("fuel", opts);
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0].nodeId, "doc/page");
+        TS_ASSERT_EQUALS(result[0].title, "The Page");
+        TS_ASSERT_EQUALS(result[0].snippet, "some text");
+        TS_ASSERT_EQUALS(result[0].score, 120);
+    }
+    {
+        mock.expectCall("SEARCH, fuel");
+        mock.provideNewResult(new VectorValue(Vector::create()));
+        TS_ASSERT_EQUALS(testee.search("fuel", Documentation::SearchOptions()).size(), 0U);
+    }
+
     mock.checkFinish();
 }
 
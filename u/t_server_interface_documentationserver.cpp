@@ -46,6 +46,20 @@ namespace {
                           << opts.siteRoot.orElse("-"));
                 return consumeReturnValue<String_t>();
             }
+        virtual int32_t prerenderNodes(const RenderOptions& opts)
+            {
+                checkCall(Format("prerenderNodes(a=%s,d=%s|%s,s=%s)")
+                          << opts.assetRoot.orElse("-")
+                          << opts.docRoot.orElse("-")
+                          << opts.docSuffix.orElse("-")
+                          << opts.siteRoot.orElse("-"));
+                return consumeReturnValue<int32_t>();
+            }
+        virtual CacheStatus getCacheStatus()
+            {
+                checkCall("getCacheStatus()");
+                return consumeReturnValue<CacheStatus>();
+            }
         virtual NodeInfo getNodeInfo(String_t nodeId)
             {
                 checkCall(Format("getNodeInfo(%s)", nodeId));
@@ -71,6 +85,17 @@ namespace {
                 checkCall(Format("getNodeRelatedVersions(%s)", nodeId));
                 return consumeNodeInfoVector();
             }
+        virtual std::vector<SearchResult> search(String_t query, const SearchOptions& opts)
+            {
+                checkCall(Format("search(%s,in=%s,n=%d)", query, opts.docId.orElse("-"), opts.maxResults.orElse(-1)));
+                std::vector<SearchResult> result;
+                int n = consumeReturnValue<int>();
+                while (n > 0) {
+                    result.push_back(consumeReturnValue<SearchResult>());
+                    --n;
+                }
+                return result;
+            }
      private:
         std::vector<NodeInfo> consumeNodeInfoVector()
             {
@@ -135,6 +160,39 @@ TestServerInterfaceDocumentationServer::testIt()
                          "<p>");
     }
 
+    // PRERENDER
+    {
+        mock.expectCall("prerenderNodes(a=-,d=-|-,s=-)");
+        mock.provideReturnValue(int32_t(12));
+        TS_ASSERT_EQUALS(testee.callInt(Segment().pushBackString("PRERENDER")), 12);
+    }
+    {
+        mock.expectCall("prerenderNodes(a=/a/,d=/d/|-,s=-)");
+        mock.provideReturnValue(int32_t(7));
+        TS_ASSERT_EQUALS(testee.callInt(Segment().pushBackString("PRERENDER")
+                                        .pushBackString("DOC").pushBackString("/d/")
+                                        .pushBackString("ASSET").pushBackString("/a/")),
+                         7);
+    }
+
+    // CACHESTAT
+    {
+        Documentation::CacheStatus st;
+        st.numEntries = 3;
+        st.totalSize = 4000;
+        st.numHits = 10;
+        st.numMisses = 5;
+        mock.expectCall("getCacheStatus()");
+        mock.provideReturnValue(st);
+
+        std::auto_ptr<Value_t> p(testee.call(Segment().pushBackString("CACHESTAT")));
+        Access a(p.get());
+        TS_ASSERT_EQUALS(a("entries").toInteger(), 3);
+        TS_ASSERT_EQUALS(a("size").toInteger(), 4000);
+        TS_ASSERT_EQUALS(a("hits").toInteger(), 10);
+        TS_ASSERT_EQUALS(a("misses").toInteger(), 5);
+    }
+
     // STAT
     {
         mock.expectCall("getNodeInfo(si)");
@@ -210,6 +268,35 @@ TestServerInterfaceDocumentationServer::testIt()
         TS_ASSERT_EQUALS(a.getArraySize(), 1U);
     }
 
+    // SEARCH
+    {
+        Documentation::SearchResult r;
+        r.nodeId = "d/p";
+        r.title = "Page";
+        r.snippet = "...text...";
+        r.score = 250;
+        mock.expectCall("search(fuel usage,in=d,n=5)");
+        mock.provideReturnValue(1);
+        mock.provideReturnValue(r);
+
+        std::auto_ptr<Value_t> p(testee.call(Segment().pushBackString("SEARCH").pushBackString("fuel usage")
+                                             .pushBackString("IN").pushBackString("d")
+                                             .pushBackString("LIMIT").pushBackInteger(5)));
+        Access a(p.get());
+        TS_ASSERT_EQUALS(a.getArraySize(), 1U);
+        TS_ASSERT_EQUALS(a[0]("id").toString(), "d/p");
+        TS_ASSERT_EQUALS(a[0]("title").toString(), "Page");
+        TS_ASSERT_EQUALS(a[0]("snippet").toString(), "...text...");
+        TS_ASSERT_EQUALS(a[0]("score").toInteger(), 250);
+    }
+    {
+        mock.expectCall("search(x,in=-,n=-1)");
+        mock.provideReturnValue(0);
+
+        std::auto_ptr<Value_t> p(testee.call(Segment().pushBackString("SEARCH").pushBackString("x")));
+        TS_ASSERT_EQUALS(Access(p.get()).getArraySize(), 0U);
+    }
+
     // Variants
     mock.expectCall("renderNode(n,a=/a/,d=/d/|-,s=/s/)");
     mock.provideReturnValue(String_t("<q>"));
@@ -243,9 +330,12 @@ TestServerInterfaceDocumentationServer::testErrors()
     // Wrong parameter
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("RENDER").pushBackString("x").pushBackString("LOLWHAT")), std::exception);
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("LS").pushBackString("x").pushBackString("LOLWHAT")), std::exception);
+    TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("PRERENDER").pushBackString("LOLWHAT")), std::exception);
+    TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("SEARCH").pushBackString("x").pushBackString("LOLWHAT")), std::exception);
 
     // Too many parameters
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("GET").pushBackString("a").pushBackString("b")), std::exception);
+    TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("CACHESTAT").pushBackString("a")), std::exception);
 
     // Wrong type parameter
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("LS").pushBackString("a").pushBackString("DEPTH").pushBackString("xx")), std::exception);
@@ -286,6 +376,36 @@ TestServerInterfaceDocumentationServer::testRoundtrip()
         TS_ASSERT_EQUALS(level4.renderNode("n", opts), "<p>");
     }
 
+    // prerenderNodes
+    {
+        mock.expectCall("prerenderNodes(a=/a/,d=/d/|?q,s=/s/)");
+        mock.provideReturnValue(int32_t(99));
+
+        Documentation::RenderOptions opts;
+        opts.siteRoot = "/s/";
+        opts.docRoot = "/d/";
+        opts.assetRoot = "/a/";
+        opts.docSuffix = "?q";
+        TS_ASSERT_EQUALS(level4.prerenderNodes(opts), 99);
+    }
+
+    // getCacheStatus
+    {
+        Documentation::CacheStatus st;
+        st.numEntries = 3;
+        st.totalSize = 4000;
+        st.numHits = 10;
+        st.numMisses = 5;
+        mock.expectCall("getCacheStatus()");
+        mock.provideReturnValue(st);
+
+        Documentation::CacheStatus result = level4.getCacheStatus();
+        TS_ASSERT_EQUALS(result.numEntries, 3);
+        TS_ASSERT_EQUALS(result.totalSize, 4000);
+        TS_ASSERT_EQUALS(result.numHits, 10);
+        TS_ASSERT_EQUALS(result.numMisses, 5);
+    }
+
     // getNodeInfo
     {
         mock.expectCall("getNodeInfo(si)");
@@ -358,6 +478,28 @@ TestServerInterfaceDocumentationServer::testRoundtrip()
         TS_ASSERT_EQUALS(nis.size(), 1U);
     }
 
+    // search
+    {
+        Documentation::SearchResult r;
+        r.nodeId = "d/p";
+        r.title = "Page";
+        r.snippet = "...text...";
+        r.score = 250;
+        mock.expectCall("search(q,in=d,n=3)");
+        mock.provideReturnValue(1);
+        mock.provideReturnValue(r);
+
+        Documentation::SearchOptions opts;
+        opts.docId = "d";
+        opts.maxResults = 3;
+        std::vector<Documentation::SearchResult> result = level4.search("q", opts);
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0].nodeId, "d/p");
+        TS_ASSERT_EQUALS(result[0].title, "Page");
+        TS_ASSERT_EQUALS(result[0].snippet, "...text...");
+        TS_ASSERT_EQUALS(result[0].score, 250);
+    }
+
     mock.checkFinish();
 }
 
@@ -218,3 +218,60 @@ TestServerInterfaceFileBaseClient::testIt()
     mock.checkFinish();
 }
 
+
+/** Test batch operations.
+    The mock does not support batches, so this sends the commands one-by-one. */
+void
+TestServerInterfaceFileBaseClient::testMultiple()
+{
+    using server::interface::FileBase;
+
+    afl::test::CommandHandler mock("testMultiple");
+    server::interface::FileBaseClient testee(mock);
+    const String_t fileNames[] = { "a/x", "a/y" };
+
+    // getMultipleFiles
+    {
+        mock.expectCall("GET, a/x");
+        mock.provideNewResult(server::makeStringValue("xx"));
+        mock.expectCall("GET, a/y");
+        mock.provideNewResult(server::makeStringValue("yy"));
+
+        afl::data::StringList_t result;
+        testee.getMultipleFiles(fileNames, result);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0], "xx");
+        TS_ASSERT_EQUALS(result[1], "yy");
+    }
+
+    // putMultipleFiles
+    {
+        const String_t contents[] = { "1", "2" };
+        mock.expectCall("PUT, a/x, 1");
+        mock.provideNewResult(0);
+        mock.expectCall("PUT, a/y, 2");
+        mock.provideNewResult(0);
+        testee.putMultipleFiles(fileNames, contents);
+    }
+
+    // getMultipleFileInformation
+    {
+        Hash::Ref_t in = Hash::create();
+        in->setNew("type", server::makeStringValue("file"));
+        in->setNew("size", server::makeIntegerValue(42));
+
+        mock.expectCall("STAT, a/x");
+        mock.provideNewResult(new HashValue(in));
+        mock.expectCall("STAT, a/y");
+        mock.provideNewResult(new HashValue(in));
+
+        std::vector<afl::base::Optional<FileBase::Info> > result;
+        testee.getMultipleFileInformation(fileNames, result);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT(result[0].isValid());
+        TS_ASSERT_EQUALS(result[0].get()->type, FileBase::IsFile);
+        TS_ASSERT_EQUALS(result[1].get()->size.orElse(0), 42);
+    }
+
+    mock.checkFinish();
+}
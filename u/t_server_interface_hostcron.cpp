@@ -23,6 +23,8 @@ TestServerInterfaceHostCron::testInterface()
             { }
         virtual void getBrokenGames(BrokenMap_t& /*result*/)
             { }
+        virtual Status getStatus()
+            { return Status(); }
     };
     Tester t;
 }
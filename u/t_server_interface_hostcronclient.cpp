@@ -182,6 +182,21 @@ TestServerInterfaceHostCronClient::testIt()
         TS_ASSERT_EQUALS(m[77], "z");
     }
 
+    // getStatus
+    {
+        Hash::Ref_t h = Hash::create();
+        h->setNew("waiting", server::makeIntegerValue(5));
+        h->setNew("running", server::makeIntegerValue(2));
+        h->setNew("workers", server::makeIntegerValue(3));
+        mock.expectCall("CRONSTATUS");
+        mock.provideNewResult(new HashValue(h));
+
+        HostCron::Status st = testee.getStatus();
+        TS_ASSERT_EQUALS(st.numWaitingGames, 5);
+        TS_ASSERT_EQUALS(st.numRunningGames, 2);
+        TS_ASSERT_EQUALS(st.numWorkers, 3);
+    }
+
     mock.checkFinish();
 }
 
@@ -55,6 +55,11 @@ namespace {
                     result[gid] = consumeReturnValue<String_t>();
                 }
             }
+        virtual Status getStatus()
+            {
+                checkCall("getStatus()");
+                return consumeReturnValue<Status>();
+            }
     };
 }
 
@@ -147,6 +152,22 @@ TestServerInterfaceHostCronServer::testIt()
         TS_ASSERT_EQUALS(a[3].toString(), "second excuse");
     }
 
+    // CRONSTATUS
+    {
+        HostCron::Status st;
+        st.numWaitingGames = 7;
+        st.numRunningGames = 1;
+        st.numWorkers = 2;
+        mock.expectCall("getStatus()");
+        mock.provideReturnValue(st);
+
+        std::auto_ptr<server::Value_t> p(testee.call(Segment().pushBackString("CRONSTATUS")));
+        afl::data::Access a(p);
+        TS_ASSERT_EQUALS(a("waiting").toInteger(), 7);
+        TS_ASSERT_EQUALS(a("running").toInteger(), 1);
+        TS_ASSERT_EQUALS(a("workers").toInteger(), 2);
+    }
+
     // Variations
     mock.expectCall("kick(77)");
     mock.provideReturnValue(false);
@@ -172,6 +193,7 @@ TestServerInterfaceHostCronServer::testErrors()
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("CRONKICK")), std::exception);
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("CRONLIST").pushBackString("LIMIT")), std::exception);
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("CRONSUSPEND")), std::exception);
+    TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("CRONSTATUS").pushBackInteger(1)), std::exception);
 
     // Bad keywords
     TS_ASSERT_THROWS(testee.callVoid(Segment().pushBackString("CRONLIST").pushBackString("")), std::exception);
@@ -262,5 +284,20 @@ TestServerInterfaceHostCronServer::testRoundtrip()
         TS_ASSERT_EQUALS(result[42], "first excuse");
         TS_ASSERT_EQUALS(result[77], "second excuse");
     }
+
+    // getStatus
+    {
+        HostCron::Status st;
+        st.numWaitingGames = 4;
+        st.numRunningGames = 3;
+        st.numWorkers = 8;
+        mock.expectCall("getStatus()");
+        mock.provideReturnValue(st);
+
+        HostCron::Status result = level4.getStatus();
+        TS_ASSERT_EQUALS(result.numWaitingGames, 4);
+        TS_ASSERT_EQUALS(result.numRunningGames, 3);
+        TS_ASSERT_EQUALS(result.numWorkers, 8);
+    }
     mock.checkFinish();
 }
@@ -0,0 +1,154 @@
+/**
+  *  \file u/t_server_interface_pipelinedclient.cpp
+  *  \brief Test for server::interface::PipelinedClient
+  */
+
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include "server/interface/pipelinedclient.hpp"
+
+#include "t_server_interface.hpp"
+#include "afl/except/remoteerrorexception.hpp"
+#include "afl/net/protocolhandlerfactory.hpp"
+#include "afl/net/resp/protocolhandler.hpp"
+#include "afl/net/server.hpp"
+#include "afl/sys/thread.hpp"
+#include "server/interface/commandbatch.hpp"
+#include "server/types.hpp"
+
+namespace {
+    /* Service: "ECHO x" returns x, "FAIL" fails. */
+    class Handler : public afl::net::CommandHandler,
+                    public afl::net::ProtocolHandlerFactory
+    {
+     public:
+        virtual Value_t* call(const Segment_t& command)
+            {
+                String_t verb = server::toString(command[0]);
+                if (verb == "FAIL") {
+                    throw std::runtime_error("fail");
+                }
+                return server::makeStringValue(server::toString(command[1]));
+            }
+        virtual void callVoid(const Segment_t& command)
+            { delete call(command); }
+        virtual afl::net::ProtocolHandler* create()
+            { return new afl::net::resp::ProtocolHandler(*this); }
+    };
+
+    /* Server running Handler in a separate thread. Destroying it drops all connections. */
+    class TestServer {
+     public:
+        TestServer(afl::net::NetworkStack& ns, const afl::net::Name& name)
+            : m_handler(),
+              m_server(ns.listen(name, 10), m_handler),
+              m_thread("TestServerInterfacePipelinedClient", m_server)
+            { m_thread.start(); }
+        ~TestServer()
+            {
+                m_server.stop();
+                m_thread.join();
+            }
+     private:
+        Handler m_handler;
+        afl::net::Server m_server;
+        afl::sys::Thread m_thread;
+    };
+
+    String_t callEcho(server::interface::PipelinedClient& testee, const char* text)
+    {
+        std::auto_ptr<afl::data::Value> p(testee.call(afl::data::Segment().pushBackString("ECHO").pushBackString(text)));
+        return server::toString(p.get());
+    }
+}
+
+/** Test calls and batches against a real server. */
+void
+TestServerInterfacePipelinedClient::testIt()
+{
+    // Server
+    afl::net::NetworkStack& ns = afl::net::NetworkStack::getInstance();
+    afl::net::Name name("127.0.0.1", uint16_t(std::rand() % 10000 + 20000));
+    Handler handler;
+    afl::net::Server networkServer(ns.listen(name, 10), handler);
+    afl::sys::Thread serverThread("TestServerInterfacePipelinedClient", networkServer);
+    serverThread.start();
+
+    {
+        server::interface::PipelinedClient testee(ns, name);
+
+        // Single calls
+        std::auto_ptr<afl::data::Value> p(testee.call(afl::data::Segment().pushBackString("ECHO").pushBackString("hi")));
+        TS_ASSERT_EQUALS(server::toString(p.get()), "hi");
+        TS_ASSERT_THROWS(testee.callVoid(afl::data::Segment().pushBackString("FAIL")), std::exception);
+
+        // Batch; includes a large parameter that needs multiple packets
+        const String_t large(100000, 'x');
+        server::interface::CommandBatch batch;
+        batch.add().pushBackString("ECHO").pushBackString("a");
+        batch.add().pushBackString("FAIL");
+        batch.add().pushBackString("ECHO").pushBackString(large);
+        batch.add().pushBackString("ECHO").pushBackString("d");
+        batch.execute(testee);
+
+        TS_ASSERT_EQUALS(server::toString(batch.getResult(0)), "a");
+        TS_ASSERT(batch.isError(1));
+        TS_ASSERT_THROWS(batch.getResult(1), afl::except::RemoteErrorException);
+        TS_ASSERT_EQUALS(server::toString(batch.getResult(2)), large);
+        TS_ASSERT_EQUALS(server::toString(batch.getResult(3)), "d");
+
+        // Connection is still usable
+        p.reset(testee.call(afl::data::Segment().pushBackString("ECHO").pushBackString("end")));
+        TS_ASSERT_EQUALS(server::toString(p.get()), "end");
+    }
+
+    networkServer.stop();
+    serverThread.join();
+}
+
+/** Test reconnect.
+    A: make a call; restart the server so the client's connection is closed; make more calls with different reconnect modes.
+    E: reused connection is replaced and the request re-sent only if the mode permits; Once permits it only once. */
+void
+TestServerInterfacePipelinedClient::testReconnect()
+{
+    afl::net::NetworkStack& ns = afl::net::NetworkStack::getInstance();
+    afl::net::Name name("127.0.0.1", uint16_t(std::rand() % 10000 + 20000));
+    server::interface::PipelinedClient testee(ns, name);
+
+    // Initial connection
+    {
+        TestServer s(ns, name);
+        TS_ASSERT_EQUALS(callEcho(testee, "a"), "a");
+    }
+
+    // Once: request is re-sent on a new connection
+    {
+        TestServer s(ns, name);
+        testee.setReconnectMode(afl::net::Reconnectable::Once);
+        TS_ASSERT_EQUALS(callEcho(testee, "b"), "b");
+    }
+
+    // Once has been used up: fails, and stays failed
+    {
+        TestServer s(ns, name);
+        TS_ASSERT_THROWS(callEcho(testee, "c"), std::exception);
+        TS_ASSERT_THROWS(callEcho(testee, "c"), std::exception);
+
+        // Always: reconnects
+        testee.setReconnectMode(afl::net::Reconnectable::Always);
+        TS_ASSERT_EQUALS(callEcho(testee, "d"), "d");
+    }
+
+    // Always: batch is re-sent on a new connection
+    {
+        TestServer s(ns, name);
+        server::interface::CommandBatch batch;
+        batch.add().pushBackString("ECHO").pushBackString("e");
+        batch.add().pushBackString("ECHO").pushBackString("f");
+        batch.execute(testee);
+        TS_ASSERT_EQUALS(server::toString(batch.getResult(0)), "e");
+        TS_ASSERT_EQUALS(server::toString(batch.getResult(1)), "f");
+    }
+}
@@ -33,6 +33,10 @@ TestServerInterfaceTalkPost::testInterface()
             { return false; }
         virtual void getNewest(int /*count*/, std::vector<int32_t>& /*postIds*/)
             { }
+        virtual afl::data::Value* search(int32_t /*forumId*/, String_t /*query*/, const ListParameters& /*params*/)
+            { return 0; }
+        virtual int32_t reindex(int32_t /*forumId*/)
+            { return 0; }
     };
     Tester t;
 }
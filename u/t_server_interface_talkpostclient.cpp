@@ -5,7 +5,9 @@
 
 #include "server/interface/talkpostclient.hpp"
 
+#include <memory>
 #include "t_server_interface.hpp"
+#include "afl/data/access.hpp"
 #include "afl/data/hash.hpp"
 #include "afl/data/hashvalue.hpp"
 #include "afl/data/segment.hpp"
@@ -159,5 +161,29 @@ TestServerInterfaceTalkPostClient::testIt()
         TS_ASSERT_EQUALS(result[3], 36);
     }
 
+    // POSTSEARCH
+    {
+        mock.expectCall("POSTSEARCH, 0, fuel -tank");
+        mock.provideNewResult(new VectorValue(Vector::create(Segment().pushBackInteger(3).pushBackInteger(9))));
+        std::auto_ptr<afl::data::Value> result(testee.search(0, "fuel -tank", server::interface::TalkPost::ListParameters()));
+        TS_ASSERT_EQUALS(afl::data::Access(result).getArraySize(), 2U);
+        TS_ASSERT_EQUALS(afl::data::Access(result)[1].toInteger(), 9);
+    }
+    {
+        mock.expectCall("POSTSEARCH, 5, x, LIMIT, 20, 10, SORT, TIME");
+        mock.provideNewResult(makeIntegerValue(0));
+        server::interface::TalkPost::ListParameters params;
+        params.mode = params.WantRange;
+        params.start = 20;
+        params.count = 10;
+        params.sortKey = "TIME";
+        std::auto_ptr<afl::data::Value> result(testee.search(5, "x", params));
+    }
+
+    // POSTREINDEX
+    mock.expectCall("POSTREINDEX, 3");
+    mock.provideNewResult(makeIntegerValue(17));
+    TS_ASSERT_EQUALS(testee.reindex(3), 17);
+
     mock.checkFinish();
 }
@@ -89,6 +89,39 @@ namespace {
                     postIds.push_back(i+1);
                 }
             }
+        virtual afl::data::Value* search(int32_t forumId, String_t query, const ListParameters& params)
+            {
+                checkCall(Format("search(%d,%s,%s)", forumId, query, formatListParameters(params)));
+                return consumeReturnValue<afl::data::Value*>();
+            }
+        virtual int32_t reindex(int32_t forumId)
+            {
+                checkCall(Format("reindex(%d)", forumId));
+                return consumeReturnValue<int32_t>();
+            }
+
+        static String_t formatListParameters(const ListParameters& params)
+            {
+                String_t result;
+                switch (params.mode) {
+                 case ListParameters::WantAll:
+                    result = "all";
+                    break;
+                 case ListParameters::WantRange:
+                    result = Format("range(%d,%d)", params.start, params.count);
+                    break;
+                 case ListParameters::WantSize:
+                    result = "size";
+                    break;
+                 case ListParameters::WantMemberCheck:
+                    result = Format("member(%d)", params.item);
+                    break;
+                }
+                if (const String_t* p = params.sortKey.get()) {
+                    result += Format(",sort(%s)", *p);
+                }
+                return result;
+            }
     };
 }
 
@@ -183,6 +216,26 @@ TestServerInterfaceTalkPostServer::testIt()
     mock.expectCall("getNewest(9)");
     testee.callVoid(Segment().pushBackString("POSTLSNEW").pushBackInteger(9));
 
+    // POSTSEARCH
+    mock.expectCall("search(0,fuel tank,all)");
+    mock.provideReturnValue<afl::data::Value*>(server::makeIntegerValue(7));
+    TS_ASSERT_EQUALS(testee.callInt(Segment().pushBackString("POSTSEARCH").pushBackInteger(0).pushBackString("fuel tank")), 7);
+
+    mock.expectCall("search(3,x,range(10,5),sort(TIME))");
+    mock.provideReturnValue<afl::data::Value*>(server::makeIntegerValue(8));
+    TS_ASSERT_EQUALS(testee.callInt(Segment().pushBackString("POSTSEARCH").pushBackInteger(3).pushBackString("x")
+                                    .pushBackString("LIMIT").pushBackInteger(10).pushBackInteger(5)
+                                    .pushBackString("sort").pushBackString("time")), 8);
+
+    mock.expectCall("search(3,x,size)");
+    mock.provideReturnValue<afl::data::Value*>(server::makeIntegerValue(9));
+    TS_ASSERT_EQUALS(testee.callInt(Segment().pushBackString("POSTSEARCH").pushBackInteger(3).pushBackString("x").pushBackString("SIZE")), 9);
+
+    // POSTREINDEX
+    mock.expectCall("reindex(0)");
+    mock.provideReturnValue<int32_t>(150);
+    TS_ASSERT_EQUALS(testee.callInt(Segment().pushBackString("POSTREINDEX").pushBackInteger(0)), 150);
+
     mock.checkFinish();
 }
 
@@ -345,6 +398,22 @@ TestServerInterfaceTalkPostServer::testRoundtrip()
         TS_ASSERT_EQUALS(result[2], 3);
     }
 
+    // search
+    {
+        mock.expectCall("search(4,q,member(12))");
+        mock.provideReturnValue<afl::data::Value*>(server::makeIntegerValue(1));
+        server::interface::TalkPost::ListParameters params;
+        params.mode = params.WantMemberCheck;
+        params.item = 12;
+        std::auto_ptr<afl::data::Value> result(level4.search(4, "q", params));
+        TS_ASSERT_EQUALS(server::toInteger(result.get()), 1);
+    }
+
+    // reindex
+    mock.expectCall("reindex(7)");
+    mock.provideReturnValue<int32_t>(12);
+    TS_ASSERT_EQUALS(level4.reindex(7), 12);
+
     mock.checkFinish();
 }
 
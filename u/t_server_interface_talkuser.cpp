@@ -27,6 +27,8 @@ TestServerInterfaceTalkUser::testInterface()
             { return 0; }
         virtual afl::data::Value* getPostedMessages(String_t /*user*/, const ListParameters& /*params*/)
             { return 0; }
+        virtual void getUnreadCounts(afl::base::Memory<const int32_t> /*forumIds*/, afl::data::IntegerList_t& /*result*/)
+            { }
     };
     Tester t;
 }
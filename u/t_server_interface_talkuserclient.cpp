@@ -7,6 +7,8 @@
 
 #include <memory>
 #include "t_server_interface.hpp"
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
 #include "afl/test/commandhandler.hpp"
 #include "server/types.hpp"
 
@@ -174,6 +176,22 @@ TestServerInterfaceTalkUserClient::testIt()
         TS_ASSERT_EQUALS(server::toInteger(p.get()), 7);
     }
 
+    // USERUNREAD
+    {
+        static const int32_t forumIds[] = { 3, 8 };
+        afl::data::Vector::Ref_t vec = afl::data::Vector::create();
+        vec->pushBackInteger(12);
+        vec->pushBackInteger(0);
+        mock.expectCall("USERUNREAD, 3, 8");
+        mock.provideNewResult(new afl::data::VectorValue(vec));
+
+        afl::data::IntegerList_t result;
+        testee.getUnreadCounts(forumIds, result);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0], 12);
+        TS_ASSERT_EQUALS(result[1], 0);
+    }
+
     mock.checkFinish();
 }
 
@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <memory>
 #include "t_server_interface.hpp"
+#include "afl/data/access.hpp"
 #include "afl/string/format.hpp"
 #include "afl/test/callreceiver.hpp"
 #include "server/interface/talkuser.hpp"
@@ -70,6 +71,19 @@ namespace {
                 checkCall(Format("getPostedMessages(%s,%s)", user, formatListParameters(params)));
                 return consumeReturnValue<afl::data::Value*>();
             }
+        virtual void getUnreadCounts(afl::base::Memory<const int32_t> forumIds, afl::data::IntegerList_t& result)
+            {
+                // Result is 10 times the forum Id, so we need not pass in lists as return values
+                String_t ids;
+                while (const int32_t* p = forumIds.eat()) {
+                    ids += Format("%d", *p);
+                    if (!forumIds.empty()) {
+                        ids += ",";
+                    }
+                    result.push_back(10 * *p);
+                }
+                checkCall(Format("getUnreadCounts(%s)", ids));
+            }
 
         // Maks this function as we only have one return type
         void provideReturnValue(afl::data::Value* p)
@@ -288,6 +302,18 @@ TestServerInterfaceTalkUserServer::testIt()
         TS_ASSERT_EQUALS(server::toInteger(p.get()), 97);
     }
 
+    // unread
+    {
+        mock.expectCall("getUnreadCounts(3,7)");
+        std::auto_ptr<afl::data::Value> p(testee.call(Segment().pushBackString("USERUNREAD").pushBackInteger(3).pushBackInteger(7)));
+        afl::data::Access a(p);
+        TS_ASSERT_EQUALS(a.getArraySize(), 2U);
+        TS_ASSERT_EQUALS(a[0].toInteger(), 30);
+        TS_ASSERT_EQUALS(a[1].toInteger(), 70);
+    }
+    mock.expectCall("getUnreadCounts()");
+    testee.callVoid(Segment().pushBackString("USERUNREAD"));
+
     mock.checkFinish();
 }
 
@@ -469,6 +495,17 @@ TestServerInterfaceTalkUserServer::testRoundtrip()
         TS_ASSERT_EQUALS(server::toInteger(p.get()), 99);
     }
 
+    // unread
+    {
+        static const int32_t forumIds[] = { 4, 1 };
+        afl::data::IntegerList_t result;
+        mock.expectCall("getUnreadCounts(4,1)");
+        level4.getUnreadCounts(forumIds, result);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0], 40);
+        TS_ASSERT_EQUALS(result[1], 10);
+    }
+
     mock.checkFinish();
 }
 
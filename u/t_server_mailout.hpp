@@ -62,6 +62,14 @@ class TestServerMailoutSession : public CxxTest::TestSuite {
     void testIt();
 };
 
+class TestServerMailoutSmtpSession : public CxxTest::TestSuite {
+ public:
+    void testSimple();
+    void testPipelining();
+    void testNoPipelining();
+    void testHelo();
+};
+
 class TestServerMailoutTemplate : public CxxTest::TestSuite {
  public:
     void testSimple();
@@ -71,6 +79,11 @@ class TestServerMailoutTemplate : public CxxTest::TestSuite {
     void testAttachment();
 };
 
+class TestServerMailoutTemplateCache : public CxxTest::TestSuite {
+ public:
+    void testIt();
+};
+
 class TestServerMailoutTransmitter : public CxxTest::TestSuite {
  public:
     void testInterface();
@@ -79,6 +92,7 @@ class TestServerMailoutTransmitter : public CxxTest::TestSuite {
 class TestServerMailoutTransmitterImpl : public CxxTest::TestSuite {
  public:
     void testStartup();
+    void testSend();
 };
 
 #endif
@@ -16,11 +16,17 @@ TestServerMailoutConfiguration::testDefault()
     TS_ASSERT_EQUALS(testee.confirmationKey, "");
     TS_ASSERT_DIFFERS(testee.maximumAge, 0);
     TS_ASSERT_EQUALS(testee.useTransmitter, true);
+    TS_ASSERT_EQUALS(testee.numTransmitters, 1);
+    TS_ASSERT_EQUALS(testee.usePipelining, true);
+    TS_ASSERT_EQUALS(testee.statisticsInterval, 60);
 
     server::mailout::Configuration copy(testee);
     TS_ASSERT_EQUALS(copy.baseUrl,         testee.baseUrl);
     TS_ASSERT_EQUALS(copy.confirmationKey, testee.confirmationKey);
     TS_ASSERT_EQUALS(copy.maximumAge,      testee.maximumAge);
     TS_ASSERT_EQUALS(copy.useTransmitter,  testee.useTransmitter);
+    TS_ASSERT_EQUALS(copy.numTransmitters, testee.numTransmitters);
+    TS_ASSERT_EQUALS(copy.usePipelining,   testee.usePipelining);
+    TS_ASSERT_EQUALS(copy.statisticsInterval, testee.statisticsInterval);
 }
 
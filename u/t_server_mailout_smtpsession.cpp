@@ -0,0 +1,247 @@
+/**
+  *  \file u/t_server_mailout_smtpsession.cpp
+  *  \brief Test for server::mailout::SmtpSession
+  */
+
+#include "server/mailout/smtpsession.hpp"
+
+#include <cstdlib>
+#include "t_server_mailout.hpp"
+#include "afl/data/stringlist.hpp"
+#include "afl/net/line/client.hpp"
+#include "afl/net/line/linesink.hpp"
+#include "afl/net/line/protocolhandler.hpp"
+#include "afl/net/name.hpp"
+#include "afl/net/networkstack.hpp"
+#include "afl/net/protocolhandlerfactory.hpp"
+#include "afl/net/server.hpp"
+#include "afl/string/string.hpp"
+#include "afl/sys/thread.hpp"
+
+using server::mailout::SmtpSession;
+
+namespace {
+    /* Fake SMTP server.
+       Accepts every receiver except those containing "bad", and records the conversation. */
+    class FakeSmtpServer : public afl::net::line::LineHandler,
+                           public afl::net::ProtocolHandlerFactory
+    {
+     public:
+        FakeSmtpServer(bool esmtp, bool pipelining)
+            : m_esmtp(esmtp), m_pipelining(pipelining), m_inData(false), m_numReceivers(0),
+              m_commands(), m_messages(), m_currentMessage()
+            { }
+        virtual afl::net::ProtocolHandler* create()
+            { return new afl::net::line::ProtocolHandler(*this); }
+        virtual bool handleOpening(afl::net::line::LineSink& response)
+            {
+                m_inData = false;
+                m_numReceivers = 0;
+                response.handleLine("220 fake.invalid ESMTP");
+                return false;
+            }
+        virtual bool handleLine(const String_t& rawLine, afl::net::line::LineSink& response)
+            {
+                String_t line = rawLine;
+                if (!line.empty() && line[line.size()-1] == '\r') {
+                    line.erase(line.size()-1);
+                }
+
+                // Data
+                if (m_inData) {
+                    if (line == ".") {
+                        m_messages.push_back(m_currentMessage);
+                        m_inData = false;
+                        m_numReceivers = 0;
+                        response.handleLine("250 queued");
+                    } else {
+                        if (!line.empty() && line[0] == '.') {
+                            line.erase(0, 1);
+                        }
+                        m_currentMessage += line;
+                        m_currentMessage += "\n";
+                    }
+                    return false;
+                }
+
+                // Commands
+                m_commands.push_back(line.substr(0, 4));
+                const String_t cmd = afl::string::strUCase(line.substr(0, 4));
+                if (cmd == "EHLO") {
+                    if (m_esmtp) {
+                        response.handleLine("250-fake.invalid");
+                        if (m_pipelining) {
+                            response.handleLine("250-PIPELINING");
+                        }
+                        response.handleLine("250 8BITMIME");
+                    } else {
+                        response.handleLine("500 unknown command");
+                    }
+                } else if (cmd == "HELO") {
+                    response.handleLine("250 fake.invalid");
+                } else if (cmd == "MAIL") {
+                    m_numReceivers = 0;
+                    response.handleLine("250 ok");
+                } else if (cmd == "RCPT") {
+                    if (line.find("bad") != String_t::npos) {
+                        response.handleLine("550 no such user");
+                    } else {
+                        m_currentMessage = line.substr(9) + "\n";
+                        ++m_numReceivers;
+                        response.handleLine("250 ok");
+                    }
+                } else if (cmd == "DATA") {
+                    if (m_numReceivers > 0) {
+                        m_inData = true;
+                        response.handleLine("354 go ahead");
+                    } else {
+                        response.handleLine("554 no valid receivers");
+                    }
+                } else if (cmd == "RSET") {
+                    m_numReceivers = 0;
+                    response.handleLine("250 ok");
+                } else if (cmd == "QUIT") {
+                    response.handleLine("221 bye");
+                    return true;
+                } else {
+                    response.handleLine("500 unknown command");
+                }
+                return false;
+            }
+        virtual void handleConnectionClose()
+            { }
+
+        String_t getCommands() const
+            {
+                String_t result;
+                for (size_t i = 0; i < m_commands.size(); ++i) {
+                    if (i != 0) {
+                        result += ",";
+                    }
+                    result += m_commands[i];
+                }
+                return result;
+            }
+
+        const afl::data::StringList_t& getMessages() const
+            { return m_messages; }
+
+     private:
+        const bool m_esmtp;
+        const bool m_pipelining;
+        bool m_inData;
+        int m_numReceivers;
+        afl::data::StringList_t m_commands;
+        afl::data::StringList_t m_messages;
+        String_t m_currentMessage;
+    };
+
+    /* Run a session against a fake server */
+    void runSession(FakeSmtpServer& fake, SmtpSession& session)
+    {
+        afl::net::NetworkStack& ns = afl::net::NetworkStack::getInstance();
+        afl::net::Name name("127.0.0.1", uint16_t(std::rand() % 10000 + 20000));
+        afl::net::Server server(ns.listen(name, 10), fake);
+        afl::sys::Thread serverThread("TestServerMailoutSmtpSession", server);
+        serverThread.start();
+
+        afl::net::line::Client(ns, name).call(session);
+
+        server.stop();
+        serverThread.join();
+    }
+
+    afl::net::smtp::Configuration makeConfig()
+    {
+        return afl::net::smtp::Configuration("client.invalid", "sender@client.invalid");
+    }
+}
+
+/** Test sending multiple mails on one connection, without pipelining.
+    A: server does not offer PIPELINING. Add two mails, one containing a line starting with a dot.
+    E: both mails sent in sequence on one connection; content transferred unchanged. */
+void
+TestServerMailoutSmtpSession::testSimple()
+{
+    FakeSmtpServer fake(true, false);
+    SmtpSession testee(makeConfig(), true);
+    TS_ASSERT_EQUALS(testee.addMail("a@x.invalid", "Subject: a\r\n\r\nhello\r\n"), 0U);
+    TS_ASSERT_EQUALS(testee.addMail("b@x.invalid", "Subject: b\r\n\r\n.dot\r\n..two\r\n"), 1U);
+    TS_ASSERT_EQUALS(testee.getNumMails(), 2U);
+    TS_ASSERT_EQUALS(testee.getStatus(0), SmtpSession::Pending);
+
+    runSession(fake, testee);
+
+    TS_ASSERT_EQUALS(testee.getStatus(0), SmtpSession::Sent);
+    TS_ASSERT_EQUALS(testee.getStatus(1), SmtpSession::Sent);
+    TS_ASSERT_EQUALS(testee.isPipelining(), false);
+    TS_ASSERT_EQUALS(fake.getCommands(), "EHLO,MAIL,RCPT,DATA,MAIL,RCPT,DATA,QUIT");
+
+    const afl::data::StringList_t& msgs = fake.getMessages();
+    TS_ASSERT_EQUALS(msgs.size(), 2U);
+    TS_ASSERT_EQUALS(msgs[0], "<a@x.invalid>\nSubject: a\n\nhello\n");
+    TS_ASSERT_EQUALS(msgs[1], "<b@x.invalid>\nSubject: b\n\n.dot\n..two\n");
+}
+
+/** Test pipelining.
+    A: server offers PIPELINING. Add three mails, the second one to a rejected receiver.
+    E: session uses pipelining; first and third mail sent, second one failed; transaction reset after failure. */
+void
+TestServerMailoutSmtpSession::testPipelining()
+{
+    FakeSmtpServer fake(true, true);
+    SmtpSession testee(makeConfig(), true);
+    testee.addMail("a@x.invalid", "Subject: a\r\n\r\none\r\n");
+    testee.addMail("bad@x.invalid", "Subject: b\r\n\r\ntwo\r\n");
+    testee.addMail("c@x.invalid", "Subject: c\r\n\r\nthree\r\n");
+
+    runSession(fake, testee);
+
+    TS_ASSERT_EQUALS(testee.getStatus(0), SmtpSession::Sent);
+    TS_ASSERT_EQUALS(testee.getStatus(1), SmtpSession::Failed);
+    TS_ASSERT_EQUALS(testee.getStatus(2), SmtpSession::Sent);
+    TS_ASSERT_EQUALS(testee.isPipelining(), true);
+    TS_ASSERT_EQUALS(fake.getCommands(), "EHLO,MAIL,RCPT,DATA,MAIL,RCPT,DATA,RSET,MAIL,RCPT,DATA,QUIT");
+
+    const afl::data::StringList_t& msgs = fake.getMessages();
+    TS_ASSERT_EQUALS(msgs.size(), 2U);
+    TS_ASSERT_EQUALS(msgs[0], "<a@x.invalid>\nSubject: a\n\none\n");
+    TS_ASSERT_EQUALS(msgs[1], "<c@x.invalid>\nSubject: c\n\nthree\n");
+}
+
+/** Test disabled pipelining.
+    A: server offers PIPELINING, but session does not allow it. Add a mail to a rejected receiver, and a good one.
+    E: session does not use pipelining; DATA not sent for rejected receiver. */
+void
+TestServerMailoutSmtpSession::testNoPipelining()
+{
+    FakeSmtpServer fake(true, true);
+    SmtpSession testee(makeConfig(), false);
+    testee.addMail("bad@x.invalid", "Subject: b\r\n\r\ntwo\r\n");
+    testee.addMail("c@x.invalid", "Subject: c\r\n\r\nthree\r\n");
+
+    runSession(fake, testee);
+
+    TS_ASSERT_EQUALS(testee.getStatus(0), SmtpSession::Failed);
+    TS_ASSERT_EQUALS(testee.getStatus(1), SmtpSession::Sent);
+    TS_ASSERT_EQUALS(testee.isPipelining(), false);
+    TS_ASSERT_EQUALS(fake.getCommands(), "EHLO,MAIL,RCPT,RSET,MAIL,RCPT,DATA,QUIT");
+    TS_ASSERT_EQUALS(fake.getMessages().size(), 1U);
+}
+
+/** Test fallback to HELO.
+    A: server does not understand EHLO.
+    E: session falls back to HELO and sends the mail. */
+void
+TestServerMailoutSmtpSession::testHelo()
+{
+    FakeSmtpServer fake(false, false);
+    SmtpSession testee(makeConfig(), true);
+    testee.addMail("a@x.invalid", "Subject: a\r\n\r\nhello\r\n");
+
+    runSession(fake, testee);
+
+    TS_ASSERT_EQUALS(testee.getStatus(0), SmtpSession::Sent);
+    TS_ASSERT_EQUALS(testee.isPipelining(), false);
+    TS_ASSERT_EQUALS(fake.getCommands(), "EHLO,HELO,MAIL,RCPT,DATA,QUIT");
+}
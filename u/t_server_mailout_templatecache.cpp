@@ -0,0 +1,39 @@
+/**
+  *  \file u/t_server_mailout_templatecache.cpp
+  *  \brief Test for server::mailout::TemplateCache
+  */
+
+#include "server/mailout/templatecache.hpp"
+
+#include "t_server_mailout.hpp"
+#include "afl/io/internaldirectory.hpp"
+
+/** Test basic operation.
+    A: create directory with a template file. Retrieve it repeatedly.
+    E: file content returned; one cache entry; missing file reported as exception. */
+void
+TestServerMailoutTemplateCache::testIt()
+{
+    afl::base::Ref<afl::io::InternalDirectory> dir = afl::io::InternalDirectory::create("tpl");
+    dir->openFile("t1", afl::io::FileSystem::Create)->fullWrite(afl::string::toBytes("Subject: hi\n\nText\n"));
+
+    server::mailout::TemplateCache testee(dir);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+
+    // Load
+    TS_ASSERT_EQUALS(testee.get("t1"), "Subject: hi\n\nText\n");
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+
+    // Load again
+    TS_ASSERT_EQUALS(testee.get("t1"), "Subject: hi\n\nText\n");
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+
+    // Missing file
+    TS_ASSERT_THROWS_ANYTHING(testee.get("t2"));
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+
+    // Clear
+    testee.clear();
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+    TS_ASSERT_EQUALS(testee.get("t1"), "Subject: hi\n\nText\n");
+}
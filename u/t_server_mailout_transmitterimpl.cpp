@@ -5,10 +5,24 @@
 
 #include "server/mailout/transmitterimpl.hpp"
 
+#include <cstdlib>
 #include "t_server_mailout.hpp"
+#include "afl/data/stringlist.hpp"
 #include "afl/io/internaldirectory.hpp"
+#include "afl/net/line/linehandler.hpp"
+#include "afl/net/line/linesink.hpp"
+#include "afl/net/line/protocolhandler.hpp"
 #include "afl/net/nullnetworkstack.hpp"
-#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/protocolhandlerfactory.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/stringsetkey.hpp"
+#include "afl/net/server.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "server/mailout/message.hpp"
 #include "server/mailout/root.hpp"
 
 /** Test startup/shutdown.
@@ -27,3 +41,114 @@ TestServerMailoutTransmitterImpl::testStartup()
                                             afl::net::smtp::Configuration("hello", "from"));
 }
 
+
+/** Test sending mails.
+    A: configure two workers. Create a message with two receivers. Send it to a fake SMTP server.
+    E: both mails delivered on one connection; message removed from database; statistics updated. */
+void
+TestServerMailoutTransmitterImpl::testSend()
+{
+    // Fake SMTP server that accepts everything
+    class FakeSmtpServer : public afl::net::line::LineHandler,
+                           public afl::net::ProtocolHandlerFactory
+    {
+     public:
+        FakeSmtpServer()
+            : m_mutex(), m_inData(false), m_messages()
+            { }
+        virtual afl::net::ProtocolHandler* create()
+            { return new afl::net::line::ProtocolHandler(*this); }
+        virtual bool handleOpening(afl::net::line::LineSink& response)
+            {
+                response.handleLine("220 fake.invalid ESMTP");
+                return false;
+            }
+        virtual bool handleLine(const String_t& line, afl::net::line::LineSink& response)
+            {
+                afl::sys::MutexGuard g(m_mutex);
+                if (m_inData) {
+                    if (line == "." || line == ".\r") {
+                        m_inData = false;
+                        response.handleLine("250 queued");
+                    } else {
+                        m_messages.back() += line;
+                    }
+                } else if (line.compare(0, 4, "DATA") == 0) {
+                    m_inData = true;
+                    m_messages.push_back(String_t());
+                    response.handleLine("354 go ahead");
+                } else if (line.compare(0, 4, "QUIT") == 0) {
+                    response.handleLine("221 bye");
+                    return true;
+                } else {
+                    response.handleLine("250 ok");
+                }
+                return false;
+            }
+        virtual void handleConnectionClose()
+            { }
+        afl::data::StringList_t getMessages()
+            {
+                afl::sys::MutexGuard g(m_mutex);
+                return m_messages;
+            }
+     private:
+        afl::sys::Mutex m_mutex;
+        bool m_inData;
+        afl::data::StringList_t m_messages;
+    };
+    afl::net::NetworkStack& ns = afl::net::NetworkStack::getInstance();
+    afl::net::Name name("127.0.0.1", uint16_t(std::rand() % 10000 + 20000));
+    FakeSmtpServer fake;
+    afl::net::Server server(ns.listen(name, 10), fake);
+    afl::sys::Thread serverThread("testSend", server);
+    serverThread.start();
+
+    // Environment
+    afl::net::redis::InternalDatabase db;
+    server::mailout::Configuration config;
+    config.numTransmitters = 2;
+    server::mailout::Root root(db, config);
+
+    afl::base::Ref<afl::io::InternalDirectory> dir = afl::io::InternalDirectory::create("");
+    dir->openFile("tpl", afl::io::FileSystem::Create)->fullWrite(afl::string::toBytes("Subject: hi\n\nHello $(name)\n"));
+
+    server::mailout::Message msg(root, 7, server::mailout::Message::Sending);
+    msg.templateName().set("tpl");
+    msg.arguments().stringField("name").set("Joe");
+    msg.receivers().add("mail:a@x.invalid");
+    msg.receivers().add("mail:b@x.invalid");
+    msg.expireTime().set(root.getCurrentTime() + 100);
+
+    // Send
+    {
+        server::mailout::TransmitterImpl testee(root, dir, ns, name, afl::net::smtp::Configuration("hello", "from"));
+        TS_ASSERT_EQUALS(testee.getStatistics().numWorkers, 2U);
+        testee.send(7);
+
+        // Wait for completion
+        int n = 0;
+        while (testee.getStatistics().numSent < 2 && n < 500) {
+            afl::sys::Thread::sleep(10);
+            ++n;
+        }
+
+        server::mailout::TransmitterImpl::Statistics st = testee.getStatistics();
+        TS_ASSERT_EQUALS(st.numSent, 2);
+        TS_ASSERT_EQUALS(st.numFailed, 0);
+        TS_ASSERT_EQUALS(st.numConnections, 1);
+        TS_ASSERT_EQUALS(st.numQueued, 0U);
+        TS_ASSERT_EQUALS(st.numActive, 0U);
+        TS_ASSERT_EQUALS(st.numPostponed, 0U);
+    }
+    server.stop();
+    serverThread.join();
+
+    // Verify
+    afl::data::StringList_t mails = fake.getMessages();
+    TS_ASSERT_EQUALS(mails.size(), 2U);
+    for (size_t i = 0; i < mails.size(); ++i) {
+        TS_ASSERT(mails[i].find("Hello Joe") != String_t::npos);
+    }
+    TS_ASSERT_EQUALS(msg.templateName().get(), "");
+}
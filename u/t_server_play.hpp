@@ -69,6 +69,13 @@ class TestServerPlayPackerList : public CxxTest::TestSuite {
     void testIt();
 };
 
+class TestServerPlaySpecificationCache : public CxxTest::TestSuite {
+ public:
+    void testImage();
+    void testDamagedImage();
+    void testSaveLoad();
+};
+
 class TestServerPlayTorpedoPacker : public CxxTest::TestSuite {
  public:
     void testIt();
@@ -0,0 +1,234 @@
+/**
+  *  \file u/t_server_play_specificationcache.cpp
+  *  \brief Test for server::play::SpecificationCache
+  */
+
+#include "server/play/specificationcache.hpp"
+
+#include "t_server_play.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/internaldirectory.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/log.hpp"
+#include "game/spec/basichullfunction.hpp"
+#include "game/spec/hullfunction.hpp"
+#include "game/spec/mission.hpp"
+#include "game/test/shiplist.hpp"
+
+using game::config::HostConfiguration;
+using game::spec::ShipList;
+
+namespace {
+    /* Create a ship list that populates all parts of the image. */
+    void initShipList(ShipList& sl)
+    {
+        afl::string::NullTranslator tx;
+        game::test::initStandardBeams(sl);
+        game::test::initStandardTorpedoes(sl);
+        game::test::addTranswarp(sl);
+        game::test::addOutrider(sl);
+        game::test::addAnnihilation(sl);
+
+        // Hull functions
+        game::spec::BasicHullFunction* bhf = sl.basicHullFunctions().addFunction(game::spec::BasicHullFunction::Cloak, "Cloak");
+        bhf->setDescription("cloaking device");
+        bhf->setPictureName("cloak");
+        game::spec::HullFunction hf(game::spec::BasicHullFunction::Cloak, game::ExperienceLevelSet_t(2));
+        const game::spec::ModifiedHullFunctionList::Function_t fn = sl.modifiedHullFunctions().getFunctionIdFromDefinition(hf);
+        sl.hulls().get(game::test::OUTRIDER_HULL_ID)->changeHullFunction(fn, game::PlayerSet_t(3), game::PlayerSet_t(), true);
+        sl.hulls().get(game::test::OUTRIDER_HULL_ID)->changeHullFunction(game::spec::BasicHullFunction::Tow, game::PlayerSet_t(), game::PlayerSet_t(4), false);
+        sl.racialAbilities().change(game::spec::BasicHullFunction::Cloak, game::PlayerSet_t(5), game::PlayerSet_t());
+
+        // Hull assignments
+        sl.hullAssignments().add(3, 1, game::test::ANNIHILATION_HULL_ID);
+        sl.hullAssignments().add(3, 2, game::test::OUTRIDER_HULL_ID);
+
+        // Names
+        sl.componentNamer().addTranslation(game::spec::ComponentNameProvider::Hull, "Outrider Class Scout", "Outrider");
+
+        // Friendly codes
+        sl.friendlyCodes().addCode(game::spec::FriendlyCode("abc", "s,Shipcode", tx));
+        sl.friendlyCodes().addCode(game::spec::FriendlyCode("pqr", "p-3,Planetcode", tx));
+
+        // Missions
+        game::spec::Mission m(10, "!is,Special Mission");
+        m.setHotkey('q');
+        m.setParameterType(game::InterceptParameter, game::spec::Mission::ShipParameter);
+        m.setParameterName(game::InterceptParameter, "Target");
+        m.setConditionExpression("Owner$=3");
+        sl.missions().addMission(m);
+    }
+}
+
+/** Test storeImage(), loadImage().
+    A: create a ship list and configuration. Create an image and load it into a new ship list.
+    E: loaded ship list and configuration have the same content. */
+void
+TestServerPlaySpecificationCache::testImage()
+{
+    using server::play::SpecificationCache;
+    afl::string::NullTranslator tx;
+
+    // Original data
+    ShipList origList;
+    initShipList(origList);
+    HostConfiguration origConfig;
+    origConfig.setDefaultValues();
+    origConfig[HostConfiguration::GameName].set("The Game");
+    origConfig.setOption("Unknown.Option", "42", game::config::ConfigurationOption::Game);
+
+    afl::base::GrowableBytes_t image;
+    SpecificationCache::storeImage(image, origList, origConfig);
+
+    // Load
+    ShipList list;
+    HostConfiguration config;
+    config.setDefaultValues();
+    TS_ASSERT_THROWS_NOTHING(SpecificationCache::loadImage(image, list, config, tx));
+
+    // Verify configuration
+    TS_ASSERT_EQUALS(config[HostConfiguration::GameName](), "The Game");
+    const game::config::ConfigurationOption* opt = config.getOptionByName("Unknown.Option");
+    TS_ASSERT(opt != 0);
+    TS_ASSERT_EQUALS(opt->toString(), "42");
+    TS_ASSERT_EQUALS(opt->getSource(), game::config::ConfigurationOption::Game);
+
+    // Verify components
+    TS_ASSERT_EQUALS(list.beams().size(), origList.beams().size());
+    TS_ASSERT_EQUALS(list.beams().get(10)->getKillPower(), origList.beams().get(10)->getKillPower());
+    TS_ASSERT_EQUALS(list.beams().get(10)->cost().toCargoSpecString(), origList.beams().get(10)->cost().toCargoSpecString());
+    TS_ASSERT_EQUALS(list.launchers().get(10)->torpedoCost().toCargoSpecString(), origList.launchers().get(10)->torpedoCost().toCargoSpecString());
+    TS_ASSERT_EQUALS(list.engines().get(game::test::TRANSWARP_ENGINE_ID)->getMaxEfficientWarp(), origList.engines().get(game::test::TRANSWARP_ENGINE_ID)->getMaxEfficientWarp());
+
+    const game::spec::Hull* h = list.hulls().get(game::test::OUTRIDER_HULL_ID);
+    const game::spec::Hull* origHull = origList.hulls().get(game::test::OUTRIDER_HULL_ID);
+    TS_ASSERT(h != 0);
+    TS_ASSERT_EQUALS(h->getName(list.componentNamer()), origHull->getName(origList.componentNamer()));
+    TS_ASSERT_EQUALS(h->getShortName(list.componentNamer()), "Outrider");
+    TS_ASSERT_EQUALS(h->getMaxCargo(), origHull->getMaxCargo());
+    TS_ASSERT_EQUALS(h->getMaxBeams(), origHull->getMaxBeams());
+    TS_ASSERT_EQUALS(h->getHullFunctions(true).getNumEntries(), origHull->getHullFunctions(true).getNumEntries());
+    TS_ASSERT_EQUALS(h->getHullFunctions(false).getNumEntries(), origHull->getHullFunctions(false).getNumEntries());
+
+    const game::spec::HullFunctionAssignmentList::Entry* e = h->getHullFunctions(false).findEntry(game::spec::BasicHullFunction::Tow);
+    TS_ASSERT(e != 0);
+    TS_ASSERT_EQUALS(e->m_removedPlayers, game::PlayerSet_t(4));
+
+    // Verify hull functions
+    TS_ASSERT_EQUALS(list.basicHullFunctions().getNumFunctions(), 1U);
+    TS_ASSERT_EQUALS(list.basicHullFunctions().getFunctionById(game::spec::BasicHullFunction::Cloak)->getDescription(), "cloaking device");
+    TS_ASSERT_EQUALS(list.modifiedHullFunctions().getNumFunctions(), origList.modifiedHullFunctions().getNumFunctions());
+    TS_ASSERT(list.racialAbilities().findEntry(game::spec::BasicHullFunction::Cloak) != 0);
+
+    // Verify hull assignments
+    TS_ASSERT_EQUALS(list.hullAssignments().getHullFromIndex(config, 3, 1), game::test::ANNIHILATION_HULL_ID);
+    TS_ASSERT_EQUALS(list.hullAssignments().getHullFromIndex(config, 3, 2), game::test::OUTRIDER_HULL_ID);
+
+    // Verify friendly codes
+    TS_ASSERT_EQUALS(list.friendlyCodes().size(), 2U);
+    TS_ASSERT_EQUALS(list.friendlyCodes().at(0)->getCode(), "abc");
+    TS_ASSERT_EQUALS(list.friendlyCodes().at(1)->getRaces(), origList.friendlyCodes().at(1)->getRaces());
+
+    // Verify missions
+    TS_ASSERT_EQUALS(list.missions().size(), 1U);
+    const game::spec::Mission* m = list.missions().at(0);
+    TS_ASSERT_EQUALS(m->getNumber(), 10);
+    TS_ASSERT_EQUALS(m->getName(), "Special Mission");
+    TS_ASSERT_EQUALS(m->getHotkey(), 'q');
+    TS_ASSERT_EQUALS(m->getParameterType(game::InterceptParameter), game::spec::Mission::ShipParameter);
+    TS_ASSERT_EQUALS(m->getParameterName(game::InterceptParameter), "Target");
+    TS_ASSERT_EQUALS(m->getConditionExpression(), "Owner$=3");
+    TS_ASSERT_EQUALS(m->getFlags(), origList.missions().at(0)->getFlags());
+}
+
+/** Test loadImage() with damaged images.
+    A: create an image. Load a truncated, extended, and mis-tagged copy.
+    E: all attempts throw FileProblemException. */
+void
+TestServerPlaySpecificationCache::testDamagedImage()
+{
+    using server::play::SpecificationCache;
+    afl::string::NullTranslator tx;
+
+    ShipList origList;
+    initShipList(origList);
+    HostConfiguration origConfig;
+    afl::base::GrowableBytes_t image;
+    SpecificationCache::storeImage(image, origList, origConfig);
+
+    // Truncated
+    {
+        ShipList list;
+        HostConfiguration config;
+        TS_ASSERT_THROWS(SpecificationCache::loadImage(afl::base::ConstBytes_t(image).subrange(0, image.size() - 1), list, config, tx), afl::except::FileProblemException);
+    }
+
+    // Extended
+    {
+        afl::base::GrowableBytes_t copy;
+        copy.append(image);
+        copy.append(uint8_t(0));
+        ShipList list;
+        HostConfiguration config;
+        TS_ASSERT_THROWS(SpecificationCache::loadImage(copy, list, config, tx), afl::except::FileProblemException);
+    }
+
+    // Bad signature
+    {
+        afl::base::GrowableBytes_t copy;
+        copy.append(uint8_t('x'));
+        copy.append(afl::base::ConstBytes_t(image).subrange(1));
+        ShipList list;
+        HostConfiguration config;
+        TS_ASSERT_THROWS(SpecificationCache::loadImage(copy, list, config, tx), afl::except::FileProblemException);
+    }
+
+    // Empty
+    {
+        ShipList list;
+        HostConfiguration config;
+        TS_ASSERT_THROWS(SpecificationCache::loadImage(afl::base::ConstBytes_t(), list, config, tx), afl::except::FileProblemException);
+    }
+}
+
+/** Test save(), load().
+    A: save a ship list into a directory. Load it with the same and a different key.
+    E: loading with the same key succeeds, a different key reports a miss. */
+void
+TestServerPlaySpecificationCache::testSaveLoad()
+{
+    using server::play::SpecificationCache;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::base::Ref<afl::io::InternalDirectory> dir = afl::io::InternalDirectory::create("cache");
+
+    ShipList origList;
+    initShipList(origList);
+    HostConfiguration origConfig;
+
+    SpecificationCache testee(dir, log, tx);
+    testee.save("1234", origList, origConfig);
+
+    // Same key
+    {
+        ShipList list;
+        HostConfiguration config;
+        TS_ASSERT(testee.load("1234", list, config));
+        TS_ASSERT_EQUALS(list.hulls().size(), origList.hulls().size());
+    }
+
+    // Other key
+    {
+        ShipList list;
+        HostConfiguration config;
+        TS_ASSERT(!testee.load("5678", list, config));
+    }
+
+    // Damaged file
+    dir->openFile("5678.spec", afl::io::FileSystem::Create)->fullWrite(afl::string::toBytes("hi"));
+    {
+        ShipList list;
+        HostConfiguration config;
+        TS_ASSERT(!testee.load("5678", list, config));
+    }
+}
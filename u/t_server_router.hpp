@@ -20,6 +20,7 @@ class TestServerRouterRoot : public CxxTest::TestSuite {
     void testConflict();
     void testConflictNewWins();
     void testRestart();
+    void testPool();
 };
 
 class TestServerRouterSession : public CxxTest::TestSuite {
@@ -29,6 +30,9 @@ class TestServerRouterSession : public CxxTest::TestSuite {
     void testTalk();
     void testWriteError();
     void testStartupError();
+    void testStartFromPool();
+    void testStartFromPoolBadArgs();
+    void testStartServerArgs();
 };
 
 #endif
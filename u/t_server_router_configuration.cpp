@@ -17,4 +17,5 @@ TestServerRouterConfiguration::testInit()
     TS_ASSERT(testee.virginTimeout > 0);
     TS_ASSERT(testee.maxSessions > 0);
     TS_ASSERT(!testee.newSessionsWin);
+    TS_ASSERT_EQUALS(testee.poolSize, 0U);
 }
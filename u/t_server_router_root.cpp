@@ -43,7 +43,11 @@ namespace {
                 return true;
             }
         virtual bool writeLine(const String_t& /*line*/)
-            { return false; }
+            {
+                // Only used for standby processes receiving their parameters
+                m_replies.push("100 loaded\n");
+                return true;
+            }
         virtual bool readLine(String_t& result)
             {
                 if (m_replies.empty()) {
@@ -238,3 +242,44 @@ TestServerRouterRoot::testRestart()
     TS_ASSERT_DIFFERS(pid1, pid2);
 }
 
+
+/** Test warm pool.
+    A: create root with poolSize=2. Fill pool, create sessions.
+    E: sessions are started from pool; pool is refilled; sessions whose parameters cannot be transferred are started normally */
+void
+TestServerRouterRoot::testPool()
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.poolSize = 2;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    TS_ASSERT_EQUALS(testee.getNumStandbyProcesses(), 0U);
+    testee.fillPool();
+    TS_ASSERT_EQUALS(testee.getNumStandbyProcesses(), 2U);
+
+    // Create session; uses the pool
+    String_t args1[] = { "1", "dir" };
+    server::router::Session& s1 = testee.createSession(args1);
+    TS_ASSERT(s1.isActive());
+    TS_ASSERT_EQUALS(testee.getNumPoolHits(), 1U);
+    TS_ASSERT_EQUALS(testee.getNumPoolMisses(), 0U);
+    TS_ASSERT_EQUALS(testee.getNumStandbyProcesses(), 2U);
+
+    // Create session with parameter that cannot be transferred
+    String_t args2[] = { "1", "a\nb" };
+    server::router::Session& s2 = testee.createSession(args2);
+    TS_ASSERT(s2.isActive());
+    TS_ASSERT_EQUALS(testee.getNumPoolHits(), 1U);
+    TS_ASSERT_EQUALS(testee.getNumPoolMisses(), 1U);
+    TS_ASSERT_EQUALS(testee.getNumStandbyProcesses(), 2U);
+    TS_ASSERT_EQUALS(testee.sessions().size(), 2U);
+
+    // Stop everything
+    testee.stopAllSessions();
+    TS_ASSERT_EQUALS(testee.sessions().size(), 0U);
+    TS_ASSERT_EQUALS(testee.getNumStandbyProcesses(), 0U);
+}
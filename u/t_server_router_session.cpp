@@ -135,7 +135,7 @@ TestServerRouterSession::testInit()
     TS_ASSERT_EQUALS(testee.talk("hello"), server::SESSION_TIMED_OUT);
 
     // We cannot start this session (NullFactory refuses)
-    TS_ASSERT_EQUALS(testee.start("prog"), false);
+    TS_ASSERT_EQUALS(testee.start("prog", afl::base::Memory<const String_t>()), false);
 }
 
 /** Test conflict resolution.
@@ -210,7 +210,7 @@ TestServerRouterSession::testTalk()
     proc->provideReturnValue(true);
     proc->provideReturnValue(String_t("100 hi there\n"));
 
-    bool ok = testee.start("prog");
+    bool ok = testee.start("prog", afl::base::Memory<const String_t>());
     TS_ASSERT(ok);
     TS_ASSERT_EQUALS(testee.getProcessId(), 42U);
     TS_ASSERT_EQUALS(testee.isUsed(), false);
@@ -297,7 +297,7 @@ TestServerRouterSession::testWriteError()
     proc->provideReturnValue(true);
     proc->provideReturnValue(String_t("100 hi there\n"));
 
-    bool ok = testee.start("prog");
+    bool ok = testee.start("prog", afl::base::Memory<const String_t>());
     TS_ASSERT(ok);
 
     // Submit a command which fails. This causes us to stop immediately.
@@ -343,8 +343,112 @@ TestServerRouterSession::testStartupError()
     proc->provideStatus(false, 0, "stopped");
     proc->provideReturnValue(true);
 
-    bool ok = testee.start("prog");
+    bool ok = testee.start("prog", afl::base::Memory<const String_t>());
     TS_ASSERT(!ok);
     TS_ASSERT(!testee.isActive());
 }
 
+
+/** Test startFromPool().
+    A: create a session. Start it with a standby process mock.
+    E: parameters are transferred to the process; session is active */
+void
+TestServerRouterSession::testStartFromPool()
+{
+    // Testee/environment
+    NullFactory factory;
+    String_t args[] = { "a", "b" };
+    afl::sys::Log log;
+    Session testee(factory, args, "session_id", log, 0);
+
+    // Standby process
+    std::auto_ptr<SubprocessMock> proc(new SubprocessMock("testStartFromPool"));
+    proc->expectCall("start(prog,1)");
+    proc->provideStatus(true, 42, "started");
+    proc->provideReturnValue(true);
+    String_t standbyArgs[] = { "--standby" };
+    TS_ASSERT(proc->start("prog", standbyArgs));
+
+    // Startup sequence
+    proc->expectCall("readLine()");
+    proc->provideReturnValue(true);
+    proc->provideReturnValue(String_t("100 standby\n"));
+    proc->expectCall("writeLine(a\nb\n.\n)");
+    proc->provideReturnValue(true);
+    proc->expectCall("readLine()");
+    proc->provideReturnValue(true);
+    proc->provideReturnValue(String_t("100 hi there\n"));
+
+    SubprocessMock& procRef = *proc;
+    bool ok = testee.startFromPool(std::auto_ptr<util::process::Subprocess>(proc.release()));
+    TS_ASSERT(ok);
+    TS_ASSERT_EQUALS(testee.getProcessId(), 42U);
+    TS_ASSERT_EQUALS(testee.isActive(), true);
+
+    // Stop
+    procRef.expectCall("stop()");
+    procRef.provideStatus(false, 0, "stopped");
+    procRef.provideReturnValue(true);
+    testee.stop();
+}
+
+/** Test startFromPool() with parameters that cannot be transferred.
+    A: create a session with a parameter containing a line break. Start it with a standby process mock.
+    E: process is stopped without being used; session is not active */
+void
+TestServerRouterSession::testStartFromPoolBadArgs()
+{
+    // Testee/environment
+    NullFactory factory;
+    String_t args[] = { "a", "b\nc" };
+    afl::sys::Log log;
+    Session testee(factory, args, "session_id", log, 0);
+
+    // Standby process
+    std::auto_ptr<SubprocessMock> proc(new SubprocessMock("testStartFromPoolBadArgs"));
+    proc->expectCall("stop()");
+    proc->provideStatus(false, 0, "stopped");
+    proc->provideReturnValue(true);
+
+    bool ok = testee.startFromPool(std::auto_ptr<util::process::Subprocess>(proc.release()));
+    TS_ASSERT(!ok);
+    TS_ASSERT_EQUALS(testee.isActive(), false);
+}
+
+/** Test start() with server arguments.
+    A: create a session. Start it with additional server arguments.
+    E: server arguments are passed to the process, but are not part of the session's command line */
+void
+TestServerRouterSession::testStartServerArgs()
+{
+    // Provide a mock
+    FactoryMock factory;
+    SubprocessMock* proc = new SubprocessMock("testStartServerArgs");
+    factory.pushBackNew(proc);
+
+    // Testee/environment
+    String_t args[] = { "a", "b" };
+    afl::sys::Log log;
+    Session testee(factory, args, "session_id", log, 0);
+
+    // Startup sequence
+    proc->expectCall("start(prog,3)");
+    proc->provideStatus(true, 42, "started");
+    proc->provideReturnValue(true);
+
+    proc->expectCall("readLine()");
+    proc->provideReturnValue(true);
+    proc->provideReturnValue(String_t("100 hi there\n"));
+
+    String_t serverArgs[] = { "--cache=/tmp" };
+    bool ok = testee.start("prog", serverArgs);
+    TS_ASSERT(ok);
+    TS_ASSERT_EQUALS(testee.isActive(), true);
+    TS_ASSERT_EQUALS(testee.getCommandLine().size(), 2U);
+
+    // Stop
+    proc->expectCall("stop()");
+    proc->provideStatus(false, 0, "stopped");
+    proc->provideReturnValue(true);
+    testee.stop();
+}
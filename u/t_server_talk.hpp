@@ -61,6 +61,9 @@ class TestServerTalkNewsrc : public CxxTest::TestSuite {
  public:
     void testIt();
     void testBackward();
+    void testFormat();
+    void testBulk();
+    void testClearBelow();
 };
 
 class TestServerTalkRoot : public CxxTest::TestSuite {
@@ -69,6 +72,12 @@ class TestServerTalkRoot : public CxxTest::TestSuite {
     void testGetUserIdFromLogin();
 };
 
+class TestServerTalkSearch : public CxxTest::TestSuite {
+ public:
+    void testQuery();
+    void testIndex();
+};
+
 class TestServerTalkSession : public CxxTest::TestSuite {
  public:
     void testPermission();
@@ -144,6 +153,9 @@ class TestServerTalkTalkPost : public CxxTest::TestSuite {
     void testGetNewest2();
     void testGetHeader();
     void testRemove();
+    void testRenderCache();
+    void testSearch();
+    void testReindex();
 };
 
 class TestServerTalkTalkRender : public CxxTest::TestSuite {
@@ -167,6 +179,7 @@ class TestServerTalkTalkUser : public CxxTest::TestSuite {
     void testNewsrcErrors();
     void testNewsrcSingle();
     void testNewsrcSet();
+    void testUnread();
     void testRoot();
     void testWatch();
     void testPostedMessages();
@@ -179,6 +192,7 @@ class TestServerTalkTextNode : public CxxTest::TestSuite {
     void testSimpleList();
     void testSimpleList2();
     void testTextContent();
+    void testClone();
 };
 
 class TestServerTalkTopic : public CxxTest::TestSuite {
@@ -188,6 +202,11 @@ class TestServerTalkTopic : public CxxTest::TestSuite {
     void testSort();
 };
 
+class TestServerTalkUnreadCounter : public CxxTest::TestSuite {
+ public:
+    void testIt();
+};
+
 class TestServerTalkUser : public CxxTest::TestSuite {
  public:
     void testBasicProperties();
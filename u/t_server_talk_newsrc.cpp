@@ -8,6 +8,9 @@
 #include "t_server_talk.hpp"
 #include "afl/net/redis/internaldatabase.hpp"
 #include "afl/net/redis/subtree.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/integerkey.hpp"
 
 /** Basic newsrc test. */
 void
@@ -116,3 +119,169 @@ TestServerTalkNewsrc::testBackward()
     }
 }
 
+
+/** Test storage format.
+    A: set different bit patterns; save.
+    E: lines with few runs are stored as run list, others as bitmap; both read back correctly. */
+void
+TestServerTalkNewsrc::testFormat()
+{
+    // Set up
+    afl::net::redis::InternalDatabase db;
+    afl::net::redis::Subtree tree(db, "x:");
+
+    // Legacy bitmap: [0,7] read, [8,15] unread, [16,23] read
+    tree.hashKey("data").stringField("0").set(String_t("\xFF\0\xFF", 3));
+
+    // Line 1: a few runs
+    {
+        server::talk::Newsrc testee(tree);
+        for (int32_t i = 8192+100; i < 8192+200; ++i) {
+            testee.set(i);
+        }
+        testee.set(8192+300);
+        testee.set(16383);
+        testee.save();
+    }
+    TS_ASSERT_EQUALS(tree.hashKey("data").stringField("1").get().size(), 13U);
+
+    // Line 2: every other bit
+    {
+        server::talk::Newsrc testee(tree);
+        for (int32_t i = 16384; i < 24576; i += 2) {
+            testee.set(i);
+        }
+        testee.save();
+    }
+    TS_ASSERT_EQUALS(tree.hashKey("data").stringField("2").get().size(), 1024U);
+
+    // Verify
+    server::talk::Newsrc testee(tree);
+    TS_ASSERT( testee.get(7));
+    TS_ASSERT(!testee.get(8));
+    TS_ASSERT( testee.get(16));
+    TS_ASSERT(!testee.get(24));
+    TS_ASSERT(!testee.get(8192+99));
+    TS_ASSERT( testee.get(8192+100));
+    TS_ASSERT( testee.get(8192+199));
+    TS_ASSERT(!testee.get(8192+200));
+    TS_ASSERT( testee.get(8192+300));
+    TS_ASSERT( testee.get(16383));
+    TS_ASSERT( testee.get(16384));
+    TS_ASSERT(!testee.get(16385));
+    TS_ASSERT( testee.get(24574));
+    TS_ASSERT(!testee.get(24575));
+}
+
+/** Test bulk operations.
+    A: use count(), findFirst(), setAll(), clearAll() on a list spanning multiple lines.
+    E: results consistent with individual operations. */
+void
+TestServerTalkNewsrc::testBulk()
+{
+    // Set up
+    afl::net::redis::InternalDatabase db;
+    afl::net::redis::Subtree tree(db, "x:");
+    server::talk::Newsrc testee(tree);
+
+    // Message list: 1,3,5,...,19999 (3 lines)
+    afl::data::IntegerList_t list;
+    for (int32_t i = 1; i < 20000; i += 2) {
+        list.push_back(i);
+    }
+
+    // Initial state
+    TS_ASSERT_EQUALS(testee.count(list, false), 10000);
+    TS_ASSERT_EQUALS(testee.count(list, true), 0);
+    TS_ASSERT_EQUALS(testee.findFirst(list, false), 1);
+    TS_ASSERT_EQUALS(testee.findFirst(list, true), 0);
+
+    // Mark some read individually
+    TS_ASSERT(testee.set(1));
+    TS_ASSERT(!testee.set(1));
+    TS_ASSERT(testee.set(2));
+    TS_ASSERT(testee.set(9001));
+    TS_ASSERT_EQUALS(testee.count(list, true), 2);
+    TS_ASSERT_EQUALS(testee.findFirst(list, false), 3);
+    TS_ASSERT_EQUALS(testee.findFirst(list, true), 1);
+
+    // Mark all read
+    TS_ASSERT_EQUALS(testee.setAll(list), 9998);
+    TS_ASSERT_EQUALS(testee.setAll(list), 0);
+    TS_ASSERT_EQUALS(testee.count(list, false), 0);
+    TS_ASSERT_EQUALS(testee.findFirst(list, false), 0);
+    TS_ASSERT(testee.get(19999));
+    TS_ASSERT(!testee.get(19998));
+
+    // Fill everything in the first line; it becomes "all read"
+    for (int32_t i = 0; i < 8192; ++i) {
+        testee.set(i);
+    }
+    testee.save();
+    TS_ASSERT_EQUALS(tree.intKey("index").get(), 1);
+    TS_ASSERT_EQUALS(testee.count(list, true), 10000);
+    TS_ASSERT_EQUALS(testee.findFirst(list, true), 1);
+
+    // Mark some unread, including in the "all read" line
+    afl::data::IntegerList_t unread;
+    unread.push_back(5);
+    unread.push_back(8193);
+    unread.push_back(8194);
+    unread.push_back(19999);
+    TS_ASSERT_EQUALS(testee.clearAll(unread), 3);
+    TS_ASSERT_EQUALS(testee.clearAll(unread), 0);
+    testee.save();
+    TS_ASSERT_EQUALS(tree.intKey("index").get(), 0);
+    TS_ASSERT_EQUALS(testee.count(list, false), 3);
+    TS_ASSERT_EQUALS(testee.findFirst(list, false), 5);
+    TS_ASSERT(testee.get(4));
+    TS_ASSERT(!testee.get(5));
+    TS_ASSERT(testee.get(6));
+}
+
+/** Test clearing messages below readAllBelowLine.
+    A: mark two lines entirely read so they are dropped; clear a message in the first line.
+    E: both lines are re-created with the correct size; only the cleared message reads as unread, also after reloading. */
+void
+TestServerTalkNewsrc::testClearBelow()
+{
+    afl::net::redis::InternalDatabase db;
+    afl::net::redis::Subtree tree(db, "x:");
+    {
+        server::talk::Newsrc testee(tree);
+        for (int32_t i = 0; i < 2*8192; ++i) {
+            testee.set(i);
+        }
+        testee.save();
+        TS_ASSERT_EQUALS(tree.intKey("index").get(), 2);
+        TS_ASSERT_EQUALS(tree.hashKey("data").size(), 0);
+
+        // Clear a message two lines down
+        TS_ASSERT(testee.clear(100));
+        TS_ASSERT(!testee.clear(100));
+        TS_ASSERT(!testee.get(100));
+        TS_ASSERT(testee.get(99));
+        TS_ASSERT(testee.get(8191));
+        TS_ASSERT(testee.get(8192));
+        TS_ASSERT(testee.get(16383));
+        TS_ASSERT(!testee.get(16384));
+        testee.save();
+        TS_ASSERT_EQUALS(tree.intKey("index").get(), 0);
+    }
+
+    // Reload
+    {
+        server::talk::Newsrc testee(tree);
+        TS_ASSERT(!testee.get(100));
+        TS_ASSERT(testee.get(0));
+        TS_ASSERT(testee.get(99));
+        TS_ASSERT(testee.get(101));
+        TS_ASSERT(testee.get(8191));
+        TS_ASSERT(testee.get(8192));
+        TS_ASSERT(testee.get(16383));
+        TS_ASSERT(!testee.get(16384));
+
+        // Line 1 is fully read, but line 0 is not; both are kept.
+        TS_ASSERT_EQUALS(tree.intKey("index").get(), 0);
+    }
+}
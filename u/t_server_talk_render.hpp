@@ -40,4 +40,12 @@ class TestServerTalkRenderOptions : public CxxTest::TestSuite {
     void testIt();
 };
 
+class TestServerTalkRenderRenderCache : public CxxTest::TestSuite {
+ public:
+    void testIt();
+    void testLimit();
+    void testDisabled();
+    void testReplace();
+};
+
 #endif
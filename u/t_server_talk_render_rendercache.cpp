@@ -0,0 +1,131 @@
+/**
+  *  \file u/t_server_talk_render_rendercache.cpp
+  *  \brief Test for server::talk::render::RenderCache
+  */
+
+#include <memory>
+#include "server/talk/render/rendercache.hpp"
+
+#include "t_server_talk_render.hpp"
+
+using server::talk::TextNode;
+using server::talk::render::RenderCache;
+
+/** Basic operation.
+    A: store a tree; retrieve it with matching and mismatching sequence number; remove it.
+    E: copies returned as expected; statistics updated. */
+void
+TestServerTalkRenderRenderCache::testIt()
+{
+    RenderCache testee;
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+
+    TextNode tree(TextNode::maGroup, TextNode::miGroupRoot);
+    tree.children.pushBackNew(new TextNode(TextNode::maPlain, 0, "hi"));
+    testee.put(7, 100, tree);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+
+    // Hit; result is a copy
+    std::auto_ptr<TextNode> p(testee.get(7, 100));
+    TS_ASSERT(p.get() != 0);
+    TS_ASSERT_EQUALS(p->getTextContent(), "hi");
+    p->children[0]->text = "changed";
+
+    std::auto_ptr<TextNode> p2(testee.get(7, 100));
+    TS_ASSERT(p2.get() != 0);
+    TS_ASSERT_EQUALS(p2->getTextContent(), "hi");
+
+    // Misses: wrong sequence number, wrong Id
+    TS_ASSERT(testee.get(7, 101) == 0);
+    TS_ASSERT(testee.get(8, 100) == 0);
+    TS_ASSERT_EQUALS(testee.getNumHits(), 2U);
+    TS_ASSERT_EQUALS(testee.getNumMisses(), 2U);
+
+    // Replace with new sequence number
+    testee.put(7, 101, tree);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+    TS_ASSERT(testee.get(7, 100) == 0);
+    std::auto_ptr<TextNode> p3(testee.get(7, 101));
+    TS_ASSERT(p3.get() != 0);
+
+    // Remove
+    testee.remove(7);
+    testee.remove(9);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+    TS_ASSERT(testee.get(7, 101) == 0);
+}
+
+/** Test size limit.
+    A: create cache with limit 2; add 3 entries, using the first one in between.
+    E: least-recently used entry is dropped. */
+void
+TestServerTalkRenderRenderCache::testLimit()
+{
+    RenderCache testee(2);
+    TextNode tree(TextNode::maGroup, TextNode::miGroupRoot);
+
+    testee.put(1, 1, tree);
+    testee.put(2, 2, tree);
+    delete testee.get(1, 1);
+    testee.put(3, 3, tree);
+
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 2U);
+    std::auto_ptr<TextNode> p1(testee.get(1, 1));
+    std::auto_ptr<TextNode> p2(testee.get(2, 2));
+    std::auto_ptr<TextNode> p3(testee.get(3, 3));
+    TS_ASSERT(p1.get() != 0);
+    TS_ASSERT(p2.get() == 0);
+    TS_ASSERT(p3.get() != 0);
+
+    // Reduce limit; most-recently-used entry survives
+    p3.reset();
+    p3.reset(testee.get(3, 3));
+    testee.setMaxEntries(1);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+    p3.reset(testee.get(3, 3));
+    TS_ASSERT(p3.get() != 0);
+}
+
+/** Test disabled cache.
+    A: create cache with limit 0; add entry.
+    E: nothing is stored. */
+void
+TestServerTalkRenderRenderCache::testDisabled()
+{
+    RenderCache testee(0);
+    TextNode tree(TextNode::maGroup, TextNode::miGroupRoot);
+    testee.put(1, 1, tree);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 0U);
+    TS_ASSERT(testee.get(1, 1) == 0);
+}
+
+/** Test replacing and removing entries.
+    A: create cache with limit 2; add entries, replace one, remove one.
+    E: replacing an entry makes it most-recently-used; removed entries are gone. */
+void
+TestServerTalkRenderRenderCache::testReplace()
+{
+    RenderCache testee(2);
+    TextNode tree(TextNode::maGroup, TextNode::miGroupRoot);
+
+    testee.put(1, 1, tree);
+    testee.put(2, 2, tree);
+    testee.put(1, 5, tree);            // replaces entry 1, making entry 2 the oldest
+    testee.put(3, 3, tree);            // drops entry 2
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 2U);
+    TS_ASSERT(testee.get(1, 1) == 0);
+    TS_ASSERT(testee.get(2, 2) == 0);
+
+    std::auto_ptr<TextNode> p(testee.get(1, 5));
+    TS_ASSERT(p.get() != 0);
+
+    testee.remove(1);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+    TS_ASSERT(testee.get(1, 5) == 0);
+    p.reset(testee.get(3, 3));
+    TS_ASSERT(p.get() != 0);
+
+    // Removing a nonexistent entry is harmless
+    testee.remove(77);
+    TS_ASSERT_EQUALS(testee.getNumEntries(), 1U);
+}
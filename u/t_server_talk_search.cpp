@@ -0,0 +1,178 @@
+/**
+  *  \file u/t_server_talk_search.cpp
+  *  \brief Test for server::talk::Search
+  */
+
+#include "server/talk/search.hpp"
+
+#include "t_server_talk.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "server/talk/forum.hpp"
+#include "server/talk/message.hpp"
+#include "server/talk/root.hpp"
+
+using afl::data::IntegerList_t;
+using afl::data::StringList_t;
+using server::talk::SearchQuery;
+
+namespace {
+    StringList_t makeWords(const char* a, const char* b, const char* c)
+    {
+        StringList_t result;
+        result.push_back(a);
+        result.push_back(b);
+        result.push_back(c);
+        return result;
+    }
+
+    void makeMessage(server::talk::Root& root, int32_t id, String_t subject, String_t text)
+    {
+        server::talk::Message msg(root, id);
+        msg.subject().set(subject);
+        msg.text().set(text);
+    }
+}
+
+/** Test query parsing and matching.
+    A: create queries; match against word lists.
+    E: boolean and phrase semantics as documented. */
+void
+TestServerTalkSearch::testQuery()
+{
+    const StringList_t fuelTank = makeWords("the", "fuel", "tank");
+    const StringList_t tankFuel = makeWords("tank", "of", "fuel");
+
+    // Empty
+    TS_ASSERT(SearchQuery("").isEmpty());
+    TS_ASSERT(SearchQuery("  \"\" - OR ").isEmpty());
+    TS_ASSERT(!SearchQuery("").matchWords(fuelTank));
+
+    // Words, case-insensitive
+    TS_ASSERT(SearchQuery("fuel").matchWords(fuelTank));
+    TS_ASSERT(SearchQuery("TANK Fuel").matchWords(fuelTank));
+    TS_ASSERT(!SearchQuery("fuel torpedo").matchWords(fuelTank));
+
+    // Phrase
+    TS_ASSERT( SearchQuery("\"fuel tank\"").matchWords(fuelTank));
+    TS_ASSERT(!SearchQuery("\"fuel tank\"").matchWords(tankFuel));
+    TS_ASSERT( SearchQuery("fuel-tank").matchWords(fuelTank));
+    TS_ASSERT(!SearchQuery("fuel-tank").matchWords(tankFuel));
+    TS_ASSERT( SearchQuery("\"fuel tank").matchWords(fuelTank));
+
+    // Exclusion
+    TS_ASSERT(!SearchQuery("fuel -the").matchWords(fuelTank));
+    TS_ASSERT( SearchQuery("fuel -the").matchWords(tankFuel));
+    TS_ASSERT( SearchQuery("fuel -\"fuel tank\"").matchWords(tankFuel));
+    TS_ASSERT(!SearchQuery("fuel -\"fuel tank\"").matchWords(fuelTank));
+
+    // Alternatives
+    TS_ASSERT( SearchQuery("torpedo OR of").matchWords(tankFuel));
+    TS_ASSERT(!SearchQuery("torpedo OR of").matchWords(fuelTank));
+    TS_ASSERT( SearchQuery("torpedo OR \"fuel tank\"").matchWords(fuelTank));
+    TS_ASSERT(!SearchQuery("torpedo or \"fuel tank\"").matchWords(fuelTank));
+}
+
+/** Test index maintenance and findMessages().
+    A: add messages to the index, search, remove them.
+    E: correct results; index keys removed after removal. */
+void
+TestServerTalkSearch::testIndex()
+{
+    afl::net::NullCommandHandler mq;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, mq, server::talk::Configuration());
+    server::talk::Forum f(root, 3);
+
+    makeMessage(root, 1, "Fuel",    "forum:The [b]fuel[/b] tank is empty.");
+    makeMessage(root, 2, "Re: Fuel", "forum:[quote=a]fuel tank[/quote]Get a tank of fuel!");
+    makeMessage(root, 3, "Torpedo", "text:Fire at will");
+    for (int32_t i = 1; i <= 3; ++i) {
+        server::talk::Message msg(root, i);
+        f.messages().add(i);
+        server::talk::addToSearchIndex(msg, f, root);
+    }
+
+    // Index content
+    TS_ASSERT(f.searchPostings("fuel").contains(1));
+    TS_ASSERT(f.searchPostings("fuel").contains(2));
+    TS_ASSERT(f.searchPostings("empty").contains(1));
+    TS_ASSERT(!f.searchPostings("quote").contains(2));
+    TS_ASSERT(server::talk::Message(root, 3).searchTerms().contains("will"));
+
+    // Searches
+    {
+        IntegerList_t result;
+        SearchQuery("fuel").findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0], 1);
+        TS_ASSERT_EQUALS(result[1], 2);
+    }
+    {
+        // Phrase in quote is not found
+        IntegerList_t result;
+        SearchQuery("\"fuel tank\"").findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0], 1);
+    }
+    {
+        IntegerList_t result;
+        SearchQuery("fuel -empty OR fire").findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0], 2);
+        TS_ASSERT_EQUALS(result[1], 3);
+    }
+    {
+        IntegerList_t result;
+        SearchQuery("-fuel").findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0], 3);
+    }
+    {
+        IntegerList_t result;
+        SearchQuery("nothing").findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 0U);
+    }
+    {
+        // Words need no verification
+        IntegerList_t result;
+        SearchQuery q("fuel", 0);
+        q.findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(q.getNumVerified(), 0U);
+        TS_ASSERT(!q.isTruncated());
+    }
+    {
+        // Phrase: both candidates are verified
+        IntegerList_t result;
+        SearchQuery q("\"fuel tank\"");
+        q.findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(q.getNumVerified(), 2U);
+        TS_ASSERT(!q.isTruncated());
+    }
+    {
+        // Phrase with limit: only first candidate is verified
+        IntegerList_t result;
+        SearchQuery q("\"fuel tank\"", 1);
+        q.findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0], 1);
+        TS_ASSERT_EQUALS(q.getNumVerified(), 1U);
+        TS_ASSERT(q.isTruncated());
+
+        // Limit applies to the whole query
+        result.clear();
+        q.findMessages(f, root, result);
+        TS_ASSERT_EQUALS(result.size(), 0U);
+        TS_ASSERT_EQUALS(q.getNumVerified(), 1U);
+    }
+
+    // Remove
+    for (int32_t i = 1; i <= 3; ++i) {
+        server::talk::Message msg(root, i);
+        server::talk::removeFromSearchIndex(msg, f);
+    }
+    TS_ASSERT(!f.searchPostings("fuel").exists());
+    TS_ASSERT(!server::talk::Message(root, 3).searchTerms().exists());
+}
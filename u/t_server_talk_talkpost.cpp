@@ -5,7 +5,9 @@
 
 #include "server/talk/talkpost.hpp"
 
+#include <memory>
 #include "t_server_talk.hpp"
+#include "afl/data/access.hpp"
 #include "afl/net/nullcommandhandler.hpp"
 #include "afl/net/redis/integerfield.hpp"
 #include "afl/net/redis/internaldatabase.hpp"
@@ -13,9 +15,21 @@
 #include "server/talk/forum.hpp"
 #include "server/talk/message.hpp"
 #include "server/talk/root.hpp"
+#include "server/talk/search.hpp"
 #include "server/talk/session.hpp"
 #include "server/talk/topic.hpp"
 #include "server/talk/user.hpp"
+#include "server/types.hpp"
+
+namespace {
+    afl::data::IntegerList_t doSearch(server::talk::TalkPost& testee, int32_t forumId, String_t query, const server::talk::TalkPost::ListParameters& params)
+    {
+        std::auto_ptr<afl::data::Value> p(testee.search(forumId, query, params));
+        afl::data::IntegerList_t result;
+        afl::data::Access(p.get()).toIntegerList(result);
+        return result;
+    }
+}
 
 /** Test create(), regular case, including notification. */
 void
@@ -911,3 +925,219 @@ TestServerTalkTalkPost::testRemove()
     }
 }
 
+/** Test rendering with render cache.
+    A: create a posting. Render it multiple times, edit it, render again, remove it.
+    E: posting is parsed once; edit and remove invalidate the cache. */
+void
+TestServerTalkTalkPost::testRenderCache()
+{
+    // Infrastructure
+    afl::net::NullCommandHandler mq;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, mq, server::talk::Configuration());
+
+    // Set up database
+    const int32_t FORUM_ID = 42;
+    root.allForums().add(FORUM_ID);
+    server::talk::Forum f(root, FORUM_ID);
+    f.name().set("Foorum");
+    f.writePermissions().set("all");
+    f.readPermissions().set("all");
+
+    server::talk::Session session;
+    server::talk::TalkPost testee(session, root);
+    session.setUser("a");
+    session.renderOptions().setFormat("html");
+    int32_t id = testee.create(FORUM_ID, "subj", "text:hello", server::talk::TalkPost::CreateOptions());
+
+    // Render twice: second is a cache hit
+    TS_ASSERT_EQUALS(testee.render(id, server::interface::TalkRender::Options()), "<p>hello</p>\n");
+    TS_ASSERT_EQUALS(root.renderCache().getNumEntries(), 1U);
+    TS_ASSERT_EQUALS(root.renderCache().getNumMisses(), 1U);
+    TS_ASSERT_EQUALS(testee.render(id, server::interface::TalkRender::Options()), "<p>hello</p>\n");
+    TS_ASSERT_EQUALS(root.renderCache().getNumHits(), 1U);
+
+    // Different format uses same cache entry
+    server::interface::TalkRender::Options opts;
+    opts.format = "noquote:html";
+    TS_ASSERT_EQUALS(testee.render(id, opts), "<p>hello</p>\n");
+    TS_ASSERT_EQUALS(root.renderCache().getNumHits(), 2U);
+
+    // Same format as stored does not need the cache
+    opts.format = "text";
+    TS_ASSERT_EQUALS(testee.render(id, opts), "hello");
+    TS_ASSERT_EQUALS(root.renderCache().getNumHits(), 2U);
+    TS_ASSERT_EQUALS(root.renderCache().getNumMisses(), 1U);
+
+    // Edit
+    testee.edit(id, "subj", "text:world");
+    TS_ASSERT_EQUALS(root.renderCache().getNumEntries(), 0U);
+    TS_ASSERT_EQUALS(testee.render(id, server::interface::TalkRender::Options()), "<p>world</p>\n");
+    TS_ASSERT_EQUALS(root.renderCache().getNumEntries(), 1U);
+
+    // Remove
+    TS_ASSERT_EQUALS(testee.remove(id), 1);
+    TS_ASSERT_EQUALS(root.renderCache().getNumEntries(), 0U);
+}
+
+/** Test search().
+    A: create postings in a public and a hidden forum. Search as another user, with different list parameters. Edit and remove postings.
+    E: only accessible postings are found; index follows edits and removals. */
+void
+TestServerTalkTalkPost::testSearch()
+{
+    typedef server::talk::TalkPost::ListParameters ListParameters_t;
+
+    // Infrastructure
+    afl::net::NullCommandHandler mq;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, mq, server::talk::Configuration());
+
+    // Set up database
+    // - a public forum and a forum nobody can read
+    const int32_t FORUM_ID = 42, HIDDEN_ID = 43;
+    root.allForums().add(FORUM_ID);
+    root.allForums().add(HIDDEN_ID);
+    server::talk::Forum f(root, FORUM_ID);
+    f.writePermissions().set("all");
+    f.readPermissions().set("all");
+    server::talk::Forum h(root, HIDDEN_ID);
+    h.writePermissions().set("all");
+
+    // - postings by "a"
+    server::talk::Session sessionA;
+    server::talk::TalkPost testeeA(sessionA, root);
+    sessionA.setUser("a");
+    int32_t p1 = testeeA.create(FORUM_ID, "Fuel", "text:The fuel tank is empty", server::talk::TalkPost::CreateOptions());
+    int32_t p2 = testeeA.reply(p1, "Another", "text:Buy more fuel", server::talk::TalkPost::ReplyOptions());
+    int32_t p3 = testeeA.create(HIDDEN_ID, "Secret", "text:Hidden fuel depot", server::talk::TalkPost::CreateOptions());
+
+    // Search as "b"
+    server::talk::Session sessionB;
+    server::talk::TalkPost testeeB(sessionB, root);
+    sessionB.setUser("b");
+    {
+        afl::data::IntegerList_t result = doSearch(testeeB, 0, "fuel", ListParameters_t());
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0], p1);
+        TS_ASSERT_EQUALS(result[1], p2);
+    }
+    {
+        afl::data::IntegerList_t result = doSearch(testeeB, FORUM_ID, "\"Fuel Tank\"", ListParameters_t());
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0], p1);
+    }
+    TS_ASSERT_EQUALS(doSearch(testeeB, HIDDEN_ID, "fuel", ListParameters_t()).size(), 0U);
+    TS_ASSERT_THROWS(doSearch(testeeB, 99, "fuel", ListParameters_t()), std::exception);
+
+    // Author sees their hidden posting
+    TS_ASSERT_EQUALS(doSearch(testeeA, HIDDEN_ID, "fuel", ListParameters_t()).size(), 1U);
+
+    // List parameters
+    {
+        ListParameters_t params;
+        params.mode = ListParameters_t::WantSize;
+        std::auto_ptr<afl::data::Value> p(testeeB.search(0, "fuel", params));
+        TS_ASSERT_EQUALS(server::toInteger(p.get()), 2);
+    }
+    {
+        ListParameters_t params;
+        params.mode = ListParameters_t::WantMemberCheck;
+        params.item = p2;
+        std::auto_ptr<afl::data::Value> p(testeeB.search(0, "fuel", params));
+        TS_ASSERT_EQUALS(server::toInteger(p.get()), 1);
+
+        params.item = p3;
+        p.reset(testeeB.search(0, "fuel", params));
+        TS_ASSERT_EQUALS(server::toInteger(p.get()), 0);
+    }
+    {
+        ListParameters_t params;
+        params.mode = ListParameters_t::WantRange;
+        params.start = 1;
+        params.count = 5;
+        afl::data::IntegerList_t result = doSearch(testeeB, 0, "fuel", params);
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0], p2);
+    }
+    {
+        ListParameters_t params;
+        params.sortKey = "SUBJECT";
+        afl::data::IntegerList_t result = doSearch(testeeB, 0, "fuel", params);
+        TS_ASSERT_EQUALS(result.size(), 2U);
+        TS_ASSERT_EQUALS(result[0], p2);
+        TS_ASSERT_EQUALS(result[1], p1);
+        TS_ASSERT(!root.messageRoot().intSetKey("search").exists());
+    }
+
+    // Edit
+    testeeA.edit(p1, "Fuel", "text:Full tank");
+    TS_ASSERT_EQUALS(doSearch(testeeB, 0, "empty", ListParameters_t()).size(), 0U);
+    TS_ASSERT_EQUALS(doSearch(testeeB, 0, "full", ListParameters_t()).size(), 1U);
+
+    // Remove
+    TS_ASSERT_EQUALS(testeeA.remove(p2), 1);
+    {
+        afl::data::IntegerList_t result = doSearch(testeeB, 0, "fuel", ListParameters_t());
+        TS_ASSERT_EQUALS(result.size(), 1U);
+        TS_ASSERT_EQUALS(result[0], p1);
+    }
+    TS_ASSERT(!f.searchPostings("buy").exists());
+}
+
+/** Test reindex().
+    A: create postings, remove them from the search index (simulating postings created before the index existed). Call reindex().
+    E: postings are found again; command requires admin permissions. */
+void
+TestServerTalkTalkPost::testReindex()
+{
+    // Infrastructure
+    afl::net::NullCommandHandler mq;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, mq, server::talk::Configuration());
+
+    // Set up database
+    const int32_t FORUM_ID = 42, OTHER_ID = 43;
+    root.allForums().add(FORUM_ID);
+    root.allForums().add(OTHER_ID);
+    server::talk::Forum f(root, FORUM_ID);
+    f.writePermissions().set("all");
+    f.readPermissions().set("all");
+    server::talk::Forum g(root, OTHER_ID);
+    g.writePermissions().set("all");
+    g.readPermissions().set("all");
+
+    server::talk::Session userSession;
+    server::talk::TalkPost userTestee(userSession, root);
+    userSession.setUser("a");
+    int32_t p1 = userTestee.create(FORUM_ID, "Fuel", "text:The fuel tank is empty", server::talk::TalkPost::CreateOptions());
+    int32_t p2 = userTestee.reply(p1, "Another", "text:Buy more fuel", server::talk::TalkPost::ReplyOptions());
+    int32_t p3 = userTestee.create(OTHER_ID, "Depot", "text:Fuel depot", server::talk::TalkPost::CreateOptions());
+
+    // Drop index
+    {
+        server::talk::Message m1(root, p1), m2(root, p2), m3(root, p3);
+        server::talk::removeFromSearchIndex(m1, f);
+        server::talk::removeFromSearchIndex(m2, f);
+        server::talk::removeFromSearchIndex(m3, g);
+    }
+    TS_ASSERT_EQUALS(doSearch(userTestee, 0, "fuel", server::talk::TalkPost::ListParameters()).size(), 0U);
+
+    // Reindex requires admin
+    TS_ASSERT_THROWS(userTestee.reindex(0), std::exception);
+
+    // Reindex single forum
+    server::talk::Session rootSession;
+    server::talk::TalkPost rootTestee(rootSession, root);
+    TS_ASSERT_EQUALS(rootTestee.reindex(FORUM_ID), 2);
+    TS_ASSERT_EQUALS(doSearch(userTestee, 0, "fuel", server::talk::TalkPost::ListParameters()).size(), 2U);
+
+    // Reindex everything; can be repeated
+    TS_ASSERT_EQUALS(rootTestee.reindex(0), 3);
+    TS_ASSERT_EQUALS(rootTestee.reindex(0), 3);
+    TS_ASSERT_EQUALS(doSearch(userTestee, 0, "fuel", server::talk::TalkPost::ListParameters()).size(), 3U);
+    TS_ASSERT_EQUALS(doSearch(userTestee, OTHER_ID, "depot", server::talk::TalkPost::ListParameters()).size(), 1U);
+
+    // Error
+    TS_ASSERT_THROWS(rootTestee.reindex(99), std::exception);
+}
@@ -16,6 +16,7 @@
 #include "server/talk/root.hpp"
 #include "afl/net/redis/stringfield.hpp"
 #include "server/talk/forum.hpp"
+#include "server/talk/message.hpp"
 #include "server/talk/topic.hpp"
 #include "afl/data/access.hpp"
 
@@ -316,6 +317,96 @@ TestServerTalkTalkUser::testNewsrcSet()
     TS_ASSERT_EQUALS(server::toInteger(p.get()), 3);
 }
 
+/** Test getUnreadCounts().
+    A: create forum; mark messages read/unread using different scopes.
+    E: unread counters correctly maintained. */
+void
+TestServerTalkTalkUser::testUnread()
+{
+    using server::talk::TalkUser;
+
+    // Infrastructure
+    afl::net::redis::InternalDatabase db;
+    afl::net::NullCommandHandler mq;
+    server::talk::Session session;
+    server::talk::Root root(db, mq, server::talk::Configuration());
+    server::talk::TalkUser testee(session, root);
+
+    // Preload database: forum 3 with topic 42, messages 3..19
+    const int FORUM_ID = 3;
+    server::talk::Forum f(root, FORUM_ID);
+    f.name().set("f");
+    root.allForums().add(FORUM_ID);
+
+    const int TOPIC_ID = 42;
+    server::talk::Topic t(root, TOPIC_ID);
+    t.subject().set("s");
+    t.forumId().set(FORUM_ID);
+    f.topics().add(TOPIC_ID);
+
+    for (int i = 3; i < 20; ++i) {
+        server::talk::Message(root, i).topicId().set(TOPIC_ID);
+        f.messages().add(i);
+        t.messages().add(i);
+    }
+    root.lastMessageId().set(19);
+
+    // Needs user context
+    static const int32_t forumIds[] = { FORUM_ID };
+    afl::data::IntegerList_t result;
+    TS_ASSERT_THROWS(testee.getUnreadCounts(forumIds, result), std::exception);
+    session.setUser("1004");
+
+    // Nonexistant forum
+    static const int32_t badForumIds[] = { FORUM_ID, 77 };
+    TS_ASSERT_THROWS(testee.getUnreadCounts(badForumIds, result), std::exception);
+
+    // Initial state: all unread
+    result.clear();
+    testee.getUnreadCounts(forumIds, result);
+    TS_ASSERT_EQUALS(result.size(), 1U);
+    TS_ASSERT_EQUALS(result[0], 17);
+
+    // Mark forum read
+    std::auto_ptr<afl::data::Value> p;
+    static const TalkUser::Selection forumSelection[] = {
+        { TalkUser::ForumScope, FORUM_ID, 0 }
+    };
+    p.reset(testee.accessNewsrc(TalkUser::MarkRead, TalkUser::NoResult, forumSelection, afl::base::Nothing));
+    result.clear();
+    testee.getUnreadCounts(forumIds, result);
+    TS_ASSERT_EQUALS(result[0], 0);
+
+    // Mark thread unread
+    static const TalkUser::Selection topicSelection[] = {
+        { TalkUser::ThreadScope, TOPIC_ID, 0 }
+    };
+    p.reset(testee.accessNewsrc(TalkUser::MarkUnread, TalkUser::NoResult, topicSelection, afl::base::Nothing));
+    result.clear();
+    testee.getUnreadCounts(forumIds, result);
+    TS_ASSERT_EQUALS(result[0], 17);
+
+    // Mark individual posts read (one of them twice)
+    static const int32_t posts[] = { 3, 4, 4 };
+    p.reset(testee.accessNewsrc(TalkUser::MarkRead, TalkUser::NoResult, afl::base::Nothing, posts));
+    result.clear();
+    testee.getUnreadCounts(forumIds, result);
+    TS_ASSERT_EQUALS(result[0], 15);
+
+    // Mark range read
+    static const TalkUser::Selection rangeSelection[] = {
+        { TalkUser::RangeScope, 1, 9 }
+    };
+    p.reset(testee.accessNewsrc(TalkUser::MarkRead, TalkUser::NoResult, rangeSelection, afl::base::Nothing));
+    result.clear();
+    testee.getUnreadCounts(forumIds, result);
+    TS_ASSERT_EQUALS(result[0], 10);
+
+    // Cross-check with newsrc
+    p.reset(testee.accessNewsrc(TalkUser::NoModification, TalkUser::GetFirstUnread, forumSelection, afl::base::Nothing));
+    TS_ASSERT_EQUALS(server::toInteger(p.get()), 10);
+}
+
 /** Test commands as root. */
 void
 TestServerTalkTalkUser::testRoot()
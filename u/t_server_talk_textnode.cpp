@@ -3,6 +3,7 @@
   *  \brief Test for server::talk::TextNode
   */
 
+#include <memory>
 #include "server/talk/textnode.hpp"
 
 #include "t_server_talk.hpp"
@@ -157,3 +158,26 @@ TestServerTalkTextNode::testTextContent()
     }
 }
 
+/** Test clone(). */
+void
+TestServerTalkTextNode::testClone()
+{
+    using server::talk::TextNode;
+
+    TextNode testee(TextNode::maGroup, TextNode::miGroupRoot);
+    testee.children.pushBackNew(new TextNode(TextNode::maParagraph, TextNode::miParCode, "lang"));
+    testee.children[0]->children.pushBackNew(new TextNode(TextNode::maPlain, 0, "text"));
+
+    std::auto_ptr<TextNode> copy(testee.clone());
+    TS_ASSERT_EQUALS(copy->major, TextNode::maGroup);
+    TS_ASSERT_EQUALS(copy->minor, TextNode::miGroupRoot);
+    TS_ASSERT_EQUALS(copy->children.size(), 1U);
+    TS_ASSERT_EQUALS(copy->children[0]->major, TextNode::maParagraph);
+    TS_ASSERT_EQUALS(copy->children[0]->minor, TextNode::miParCode);
+    TS_ASSERT_EQUALS(copy->children[0]->text, "lang");
+    TS_ASSERT_EQUALS(copy->getTextContent(), "text");
+
+    // Copy is independent
+    copy->children[0]->children[0]->text = "changed";
+    TS_ASSERT_EQUALS(testee.getTextContent(), "text");
+}
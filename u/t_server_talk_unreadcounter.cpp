@@ -0,0 +1,80 @@
+/**
+  *  \file u/t_server_talk_unreadcounter.cpp
+  *  \brief Test for server::talk::UnreadCounter
+  */
+
+#include "server/talk/unreadcounter.hpp"
+
+#include "t_server_talk.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "server/talk/forum.hpp"
+#include "server/talk/newsrc.hpp"
+#include "server/talk/root.hpp"
+#include "server/talk/user.hpp"
+
+/** Test counter maintenance.
+    A: create forum and newsrc; query and update counters.
+    E: counters computed on first use, updated incrementally afterwards, recomputed after reset. */
+void
+TestServerTalkUnreadCounter::testIt()
+{
+    afl::net::NullCommandHandler mq;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, mq, server::talk::Configuration());
+
+    // Forum with messages 1..10, user has read 1..3
+    const int32_t FORUM_ID = 5;
+    server::talk::Forum f(root, FORUM_ID);
+    for (int32_t i = 1; i <= 10; ++i) {
+        f.messages().add(i);
+    }
+    server::talk::User u(root, "u");
+    {
+        server::talk::Newsrc n(u.newsrc());
+        n.set(1);
+        n.set(2);
+        n.set(3);
+        n.save();
+    }
+
+    // Initial computation
+    TS_ASSERT(!u.unreadCounters().intField("5").exists());
+    TS_ASSERT_EQUALS(server::talk::getUnreadCount(root, "u", f), 7);
+    TS_ASSERT_EQUALS(u.unreadCounters().intField("5").get(), 7);
+    TS_ASSERT(f.unreadUsers().contains("u"));
+
+    // Counter is cached; newsrc is not consulted again
+    {
+        server::talk::Newsrc n(u.newsrc());
+        n.set(4);
+        n.save();
+    }
+    TS_ASSERT_EQUALS(server::talk::getUnreadCount(root, "u", f), 7);
+
+    // Incremental updates
+    f.messages().add(11);
+    server::talk::countNewMessage(f, root);
+    TS_ASSERT_EQUALS(server::talk::getUnreadCount(root, "u", f), 8);
+    server::talk::adjustUnreadCount(root, "u", FORUM_ID, -3);
+    TS_ASSERT_EQUALS(server::talk::getUnreadCount(root, "u", f), 5);
+
+    // Adjusting a nonexistant counter does not create it
+    server::talk::adjustUnreadCount(root, "v", FORUM_ID, 1);
+    TS_ASSERT(!server::talk::User(root, "v").unreadCounters().intField("5").exists());
+
+    // Reset forum: counter is recomputed (messages 5..11 unread)
+    server::talk::resetUnreadCounts(f, root);
+    TS_ASSERT(!u.unreadCounters().intField("5").exists());
+    TS_ASSERT(!f.unreadUsers().contains("u"));
+    TS_ASSERT_EQUALS(server::talk::getUnreadCount(root, "u", f), 7);
+
+    // Reset user: counter is gone; next countNewMessage() cleans up the user list
+    server::talk::resetUnreadCounts(root, "u");
+    TS_ASSERT(!u.unreadCounters().intField("5").exists());
+    TS_ASSERT(f.unreadUsers().contains("u"));
+    server::talk::countNewMessage(f, root);
+    TS_ASSERT(!u.unreadCounters().intField("5").exists());
+    TS_ASSERT(!f.unreadUsers().contains("u"));
+}
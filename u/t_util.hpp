@@ -204,6 +204,13 @@ class TestUtilNumberFormatter : public CxxTest::TestSuite {
     void testFormat();
 };
 
+class TestUtilParallelFor : public CxxTest::TestSuite {
+ public:
+    void testSingle();
+    void testMulti();
+    void testEmpty();
+};
+
 class TestUtilPrefixArgument : public CxxTest::TestSuite {
  public:
     void testIt();
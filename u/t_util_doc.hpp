@@ -80,6 +80,22 @@ class TestUtilDocRenderOptions : public CxxTest::TestSuite {
     void testLink();
 };
 
+class TestUtilDocSearchIndex : public CxxTest::TestSuite {
+ public:
+    void testEmpty();
+    void testSearch();
+    void testPhrase();
+    void testSnippet();
+    void testSplit();
+    void testLoadError();
+};
+
+class TestUtilDocSearchIndexBuilder : public CxxTest::TestSuite {
+ public:
+    void testExtractText();
+    void testAddIndex();
+};
+
 class TestUtilDocSingleBlobStore : public CxxTest::TestSuite {
  public:
     void testIt();
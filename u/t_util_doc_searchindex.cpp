@@ -0,0 +1,195 @@
+/**
+  *  \file u/t_util_doc_searchindex.cpp
+  *  \brief Test for util::doc::SearchIndex
+  */
+
+#include "util/doc/searchindex.hpp"
+
+#include "t_util_doc.hpp"
+#include "afl/except/fileformatexception.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/string/format.hpp"
+#include "util/doc/searchindexbuilder.hpp"
+
+using afl::io::ConstMemoryStream;
+using afl::io::InternalStream;
+using util::doc::SearchIndex;
+using util::doc::SearchIndexBuilder;
+
+namespace {
+    void load(SearchIndex& out, const SearchIndexBuilder& builder)
+    {
+        InternalStream stream;
+        builder.save(stream);
+        stream.setPos(0);
+        out.load(stream);
+    }
+}
+
+/** Test empty index.
+    A: create empty SearchIndex, or load empty file.
+    E: searches find nothing. */
+void
+TestUtilDocSearchIndex::testEmpty()
+{
+    SearchIndex testee;
+    TS_ASSERT_EQUALS(testee.getNumNodes(), 0U);
+    TS_ASSERT_EQUALS(testee.search("foo", String_t(), 10).size(), 0U);
+
+    load(testee, SearchIndexBuilder());
+    TS_ASSERT_EQUALS(testee.getNumNodes(), 0U);
+    TS_ASSERT_EQUALS(testee.getNumTerms(), 0U);
+    TS_ASSERT_EQUALS(testee.search("foo", String_t(), 10).size(), 0U);
+}
+
+/** Test search.
+    A: build index with some pages. Search.
+    E: correct nodes found in expected order. */
+void
+TestUtilDocSearchIndex::testSearch()
+{
+    SearchIndexBuilder b;
+    b.addNode("doc/a", "Starbase", "A starbase can build ships.");
+    b.addNode("doc/b", "Ships", "Ships are built at a Starbase. Ships can carry fuel.");
+    b.addNode("doc/c", "Fuel", "Fuel is needed to move ships.");
+    b.addNode("other/d", "Misc", "Nothing to see here, build or not.");
+
+    SearchIndex testee;
+    load(testee, b);
+    TS_ASSERT_EQUALS(testee.getNumNodes(), 4U);
+
+    // Single word; title match ranks first
+    std::vector<SearchIndex::Result> r = testee.search("starbase", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 2U);
+    TS_ASSERT_EQUALS(r[0].address, "doc/a");
+    TS_ASSERT_EQUALS(r[1].address, "doc/b");
+    TS_ASSERT(r[0].score > r[1].score);
+
+    // Case-insensitive, multiple words: all must match
+    r = testee.search("SHIPS, Fuel!", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 2U);
+    TS_ASSERT_EQUALS(r[0].address, "doc/c");
+    TS_ASSERT_EQUALS(r[1].address, "doc/b");
+
+    // Word not found
+    r = testee.search("ships torpedo", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 0U);
+
+    // Restrict to document
+    r = testee.search("build", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 2U);
+    r = testee.search("build", "other", 10);
+    TS_ASSERT_EQUALS(r.size(), 1U);
+    TS_ASSERT_EQUALS(r[0].address, "other/d");
+    r = testee.search("build", "oth", 10);
+    TS_ASSERT_EQUALS(r.size(), 0U);
+
+    // Limit
+    r = testee.search("ships", String_t(), 1);
+    TS_ASSERT_EQUALS(r.size(), 1U);
+
+    // Empty query
+    r = testee.search("...", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 0U);
+}
+
+/** Test phrase ranking.
+    A: build index with two pages containing the same words, one as a phrase.
+    E: page containing the phrase ranks first. */
+void
+TestUtilDocSearchIndex::testPhrase()
+{
+    SearchIndexBuilder b;
+    b.addNode("a", "", "beta alpha gamma");
+    b.addNode("b", "", "gamma alpha beta");
+
+    SearchIndex testee;
+    load(testee, b);
+
+    std::vector<SearchIndex::Result> r = testee.search("alpha beta", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 2U);
+    TS_ASSERT_EQUALS(r[0].address, "b");
+    TS_ASSERT_EQUALS(r[1].address, "a");
+
+    r = testee.search("beta alpha", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 2U);
+    TS_ASSERT_EQUALS(r[0].address, "a");
+    TS_ASSERT_EQUALS(r[1].address, "b");
+}
+
+/** Test snippet generation.
+    A: build index with a long page. Search.
+    E: snippet shows the match with surrounding words. */
+void
+TestUtilDocSearchIndex::testSnippet()
+{
+    String_t text, expect;
+    for (int i = 1; i <= 40; ++i) {
+        text += afl::string::Format("w%d\n  ", i);
+        if (i >= 12 && i <= 36) {
+            expect += afl::string::Format(" w%d", i);
+        }
+    }
+    text += "end.";
+
+    SearchIndexBuilder b;
+    b.addNode("a", "Title", text);
+    b.addNode("b", "Title", "Short text.");
+
+    SearchIndex testee;
+    load(testee, b);
+
+    std::vector<SearchIndex::Result> r = testee.search("w20", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 1U);
+    TS_ASSERT_EQUALS(r[0].snippet, "..." + expect.substr(1) + "...");
+
+    r = testee.search("title", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 2U);
+    TS_ASSERT_EQUALS(r[1].address, "b");
+    TS_ASSERT_EQUALS(r[1].snippet, "Short text.");
+}
+
+/** Test splitWords(), getTerm(). */
+void
+TestUtilDocSearchIndex::testSplit()
+{
+    String_t text = "Hello, World_2 (\xC3\xA4h)";
+    std::vector<SearchIndex::Word> words;
+    SearchIndex::splitWords(text, words);
+    TS_ASSERT_EQUALS(words.size(), 3U);
+    TS_ASSERT_EQUALS(SearchIndex::getTerm(text, words[0]), "hello");
+    TS_ASSERT_EQUALS(SearchIndex::getTerm(text, words[1]), "world_2");
+    TS_ASSERT_EQUALS(SearchIndex::getTerm(text, words[2]), "\xC3\xA4h");
+}
+
+/** Test loading invalid files.
+    A: load invalid files.
+    E: exception. */
+void
+TestUtilDocSearchIndex::testLoadError()
+{
+    // Bad signature
+    {
+        static const uint8_t DATA[] = { 'C','2','X','X',0,0,0,1, 0,0,0,0, 0,0,0,0 };
+        ConstMemoryStream ms(DATA);
+        SearchIndex testee;
+        TS_ASSERT_THROWS(testee.load(ms), afl::except::FileFormatException);
+    }
+
+    // Truncated
+    {
+        static const uint8_t DATA[] = { 'C','2','S','X',0,0,0,1, 0,0,0,1, 0,0,0,0 };
+        ConstMemoryStream ms(DATA);
+        SearchIndex testee;
+        TS_ASSERT_THROWS(testee.load(ms), afl::except::FileFormatException);
+    }
+
+    // Too short
+    {
+        static const uint8_t DATA[] = { 'C','2','S','X',0,0,0,1 };
+        ConstMemoryStream ms(DATA);
+        SearchIndex testee;
+        TS_ASSERT_THROWS(testee.load(ms), afl::except::FileFormatException);
+    }
+}
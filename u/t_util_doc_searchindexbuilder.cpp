@@ -0,0 +1,60 @@
+/**
+  *  \file u/t_util_doc_searchindexbuilder.cpp
+  *  \brief Test for util::doc::SearchIndexBuilder
+  */
+
+#include "util/doc/searchindexbuilder.hpp"
+
+#include "t_util_doc.hpp"
+#include "afl/io/internalstream.hpp"
+#include "util/doc/index.hpp"
+#include "util/doc/internalblobstore.hpp"
+#include "util/doc/searchindex.hpp"
+
+using util::doc::Index;
+using util::doc::InternalBlobStore;
+using util::doc::SearchIndex;
+using util::doc::SearchIndexBuilder;
+
+/** Test extractText().
+    A: extract text from XML content.
+    E: block elements separate words, inline elements do not. */
+void
+TestUtilDocSearchIndexBuilder::testExtractText()
+{
+    TS_ASSERT_EQUALS(SearchIndexBuilder::extractText(afl::string::toBytes("<p>Star<b>base</b></p><p>Ship</p>")),
+                     "Starbase\nShip\n");
+    TS_ASSERT_EQUALS(SearchIndexBuilder::extractText(afl::string::toBytes("<ul><li>one</li><li>two &amp; three</li></ul>")),
+                     "one\ntwo & three\n");
+}
+
+/** Test addIndex().
+    A: create Index and BlobStore. Build search index.
+    E: pages with content are indexed using their canonical address. */
+void
+TestUtilDocSearchIndexBuilder::testAddIndex()
+{
+    InternalBlobStore blobs;
+    Index idx;
+    Index::Handle_t doc = idx.addDocument(idx.root(), "doc,alias", "Document", "");
+    idx.addPage(doc, "page", "Page", blobs.addObject(afl::string::toBytes("<p>Some text</p>")));
+    idx.addPage(doc, "empty", "Empty", "");
+
+    SearchIndexBuilder testee;
+    testee.addIndex(idx, blobs);
+    TS_ASSERT_EQUALS(testee.getNumNodes(), 1U);
+
+    afl::io::InternalStream stream;
+    testee.save(stream);
+    stream.setPos(0);
+
+    SearchIndex result;
+    result.load(stream);
+    std::vector<SearchIndex::Result> r = result.search("text", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 1U);
+    TS_ASSERT_EQUALS(r[0].address, "doc/page");
+    TS_ASSERT_EQUALS(r[0].snippet, "Some text");
+
+    r = result.search("page", String_t(), 10);
+    TS_ASSERT_EQUALS(r.size(), 1U);
+}
@@ -0,0 +1,95 @@
+/**
+  *  \file u/t_util_parallelfor.cpp
+  *  \brief Test for util::parallelFor
+  */
+
+#include <vector>
+#include "util/parallelfor.hpp"
+
+#include "t_util.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+
+namespace {
+    /* Body that counts calls per index and the maximum number of concurrent calls */
+    class CountingBody : public afl::base::Closure<void(size_t)> {
+     public:
+        CountingBody(size_t n)
+            : m_mutex(), m_counts(n), m_numActive(0), m_maxActive(0)
+            { }
+
+        virtual void call(size_t index)
+            {
+                {
+                    afl::sys::MutexGuard g(m_mutex);
+                    TS_ASSERT(index < m_counts.size());
+                    if (index < m_counts.size()) {
+                        ++m_counts[index];
+                    }
+                    ++m_numActive;
+                    if (m_numActive > m_maxActive) {
+                        m_maxActive = m_numActive;
+                    }
+                }
+
+                // Slow down a little so other threads get a chance
+                afl::sys::Thread::sleep(1);
+
+                afl::sys::MutexGuard g(m_mutex);
+                --m_numActive;
+            }
+
+        void checkCounts()
+            {
+                for (size_t i = 0; i < m_counts.size(); ++i) {
+                    TSM_ASSERT_EQUALS(i, m_counts[i], 1);
+                }
+            }
+
+        size_t getMaxActive() const
+            { return m_maxActive; }
+
+     private:
+        afl::sys::Mutex m_mutex;
+        std::vector<int> m_counts;
+        size_t m_numActive;
+        size_t m_maxActive;
+    };
+}
+
+/** Test single thread.
+    A: call parallelFor() with numThreads=1.
+    E: every index processed exactly once, never concurrently. */
+void
+TestUtilParallelFor::testSingle()
+{
+    CountingBody body(20);
+    util::parallelFor(20, 1, "testSingle", body);
+    body.checkCounts();
+    TS_ASSERT_EQUALS(body.getMaxActive(), 1U);
+}
+
+/** Test multiple threads.
+    A: call parallelFor() with numThreads=4.
+    E: every index processed exactly once, no more than 4 calls active at a time. */
+void
+TestUtilParallelFor::testMulti()
+{
+    CountingBody body(100);
+    util::parallelFor(100, 4, "testMulti", body);
+    body.checkCounts();
+    TS_ASSERT(body.getMaxActive() >= 1U);
+    TS_ASSERT(body.getMaxActive() <= 4U);
+}
+
+/** Test empty range.
+    A: call parallelFor() with n=0.
+    E: body not called. */
+void
+TestUtilParallelFor::testEmpty()
+{
+    CountingBody body(0);
+    util::parallelFor(0, 4, "testEmpty", body);
+    TS_ASSERT_EQUALS(body.getMaxActive(), 0U);
+}
@@ -28,6 +28,7 @@
 #include "util/doc/index.hpp"
 #include "util/doc/loggingverifier.hpp"
 #include "util/doc/renderoptions.hpp"
+#include "util/doc/searchindexbuilder.hpp"
 #include "util/doc/singleblobstore.hpp"
 #include "util/doc/summarizingverifier.hpp"
 #include "util/doc/textimport.hpp"
@@ -221,7 +222,13 @@ util::doc::Application::saveData(DataReference& ref, const DataParameters& data)
     }
 
     // Save the XML file
-    ref.index.save(*fileSystem().openDirectory(*dirName)->openFile("index.xml", FileSystem::Create));
+    Ref<Directory> dir = fileSystem().openDirectory(*dirName);
+    ref.index.save(*dir->openFile("index.xml", FileSystem::Create));
+
+    // Rebuild the search index, so it always matches the content
+    SearchIndexBuilder builder;
+    builder.addIndex(ref.index, *ref.blobStore);
+    builder.save(*dir->openFile("search.idx", FileSystem::Create));
 }
 
 /*
@@ -0,0 +1,406 @@
+/**
+  *  \file util/doc/searchindex.cpp
+  *  \brief Class util::doc::SearchIndex
+  */
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include "util/doc/searchindex.hpp"
+#include "afl/except/fileformatexception.hpp"
+
+using afl::base::ConstBytes_t;
+
+namespace {
+    /* Weight of a match in the title, relative to a match in the body */
+    const int TITLE_WEIGHT = 5;
+
+    /* Bonus factor for phrase matches */
+    const double PHRASE_FACTOR = 2.0;
+
+    /* Snippet size: words before the match, total words */
+    const size_t SNIPPET_BEFORE = 8;
+    const size_t SNIPPET_WORDS = 25;
+
+    bool isWordCharacter(uint8_t ch)
+    {
+        return (ch >= 'A' && ch <= 'Z')
+            || (ch >= 'a' && ch <= 'z')
+            || (ch >= '0' && ch <= '9')
+            || ch == '_'
+            || ch >= 0x80;
+    }
+
+    bool isSpace(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+    }
+
+    /* Read a variable-length integer (7 bits per byte, least-significant first, high bit set on all but the last byte) */
+    bool readVarint(ConstBytes_t& in, uint32_t& out)
+    {
+        out = 0;
+        int shift = 0;
+        while (const uint8_t* p = in.eat()) {
+            out |= uint32_t(*p & 0x7F) << shift;
+            if ((*p & 0x80) == 0) {
+                return true;
+            }
+            shift += 7;
+            if (shift > 28) {
+                break;
+            }
+        }
+        return false;
+    }
+
+    /* Check whether an address lies within a document */
+    bool isWithinDocument(const String_t& address, const String_t& docId)
+    {
+        return docId.empty()
+            || address == docId
+            || (address.size() > docId.size() && address.compare(0, docId.size(), docId) == 0 && address[docId.size()] == '/');
+    }
+}
+
+/* A posting: occurrences of a term in a node */
+struct util::doc::SearchIndex::Posting {
+    uint32_t node;
+    std::vector<uint32_t> positions;
+};
+
+/* A search result candidate */
+struct util::doc::SearchIndex::Candidate {
+    uint32_t node;
+    double score;
+    Candidate(uint32_t node, double score)
+        : node(node), score(score)
+        { }
+    bool operator<(const Candidate& other) const
+        {
+            if (score != other.score) {
+                return score > other.score;
+            }
+            return node < other.node;
+        }
+};
+
+const uint8_t util::doc::SearchIndex::SIGNATURE[8] = { 'C', '2', 'S', 'X', 0, 0, 0, 1 };
+const size_t util::doc::SearchIndex::HEADER_SIZE;
+const size_t util::doc::SearchIndex::NODE_SIZE;
+const size_t util::doc::SearchIndex::TERM_SIZE;
+const size_t util::doc::SearchIndex::MAX_TERM_LENGTH;
+
+// Constructor.
+util::doc::SearchIndex::SearchIndex()
+    : m_mapping(),
+      m_data(),
+      m_numNodes(0),
+      m_numTerms(0)
+{ }
+
+// Destructor.
+util::doc::SearchIndex::~SearchIndex()
+{ }
+
+// Load from file.
+void
+util::doc::SearchIndex::load(afl::io::Stream& in)
+{
+    afl::base::Ref<afl::io::FileMapping> mapping = in.createVirtualMapping();
+    ConstBytes_t data = mapping->get();
+
+    // Check header
+    if (data.size() < HEADER_SIZE || !data.subrange(0, sizeof(SIGNATURE)).equalContent(SIGNATURE)) {
+        throw afl::except::FileFormatException(in, "Invalid file signature");
+    }
+
+    // Check table sizes
+    const uint8_t* p = data.at(sizeof(SIGNATURE));
+    const size_t numNodes = (size_t(p[0]) << 24) + (size_t(p[1]) << 16) + (size_t(p[2]) << 8) + p[3];
+    const size_t numTerms = (size_t(p[4]) << 24) + (size_t(p[5]) << 16) + (size_t(p[6]) << 8) + p[7];
+    const size_t available = data.size() - HEADER_SIZE;
+    if (numNodes > available / NODE_SIZE || numTerms > (available - numNodes*NODE_SIZE) / TERM_SIZE) {
+        throw afl::except::FileFormatException(in, "File is truncated");
+    }
+
+    m_mapping = mapping.asPtr();
+    m_data = data;
+    m_numNodes = numNodes;
+    m_numTerms = numTerms;
+}
+
+// Get number of nodes.
+size_t
+util::doc::SearchIndex::getNumNodes() const
+{
+    return m_numNodes;
+}
+
+// Get number of terms.
+size_t
+util::doc::SearchIndex::getNumTerms() const
+{
+    return m_numTerms;
+}
+
+// Search.
+std::vector<util::doc::SearchIndex::Result>
+util::doc::SearchIndex::search(const String_t& query, const String_t& docId, size_t maxResults) const
+{
+    std::vector<Result> result;
+
+    // Parse query
+    std::vector<Word> words;
+    splitWords(query, words);
+    std::vector<String_t> terms;
+    for (size_t i = 0; i < words.size(); ++i) {
+        String_t term = getTerm(query, words[i]);
+        if (term.size() <= MAX_TERM_LENGTH && std::find(terms.begin(), terms.end(), term) == terms.end()) {
+            terms.push_back(term);
+        }
+    }
+    if (terms.empty() || maxResults == 0) {
+        return result;
+    }
+
+    // Fetch postings; all terms must be present
+    std::vector<std::vector<Posting> > lists(terms.size());
+    size_t driver = 0;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        size_t termIndex;
+        if (!findTerm(terms[i], termIndex)) {
+            return result;
+        }
+        readPostings(termIndex, lists[i]);
+        if (lists[i].size() < lists[driver].size()) {
+            driver = i;
+        }
+    }
+
+    // Intersect, driven by the shortest list
+    std::vector<Candidate> candidates;
+    std::vector<size_t> cursor(terms.size());
+    std::vector<const Posting*> match(terms.size());
+    for (size_t i = 0; i < lists[driver].size(); ++i) {
+        const uint32_t node = lists[driver][i].node;
+        bool ok = true;
+        for (size_t t = 0; t < terms.size() && ok; ++t) {
+            const std::vector<Posting>& list = lists[t];
+            while (cursor[t] < list.size() && list[cursor[t]].node < node) {
+                ++cursor[t];
+            }
+            if (cursor[t] < list.size() && list[cursor[t]].node == node) {
+                match[t] = &list[cursor[t]];
+            } else {
+                ok = false;
+            }
+        }
+        if (!ok || !isWithinDocument(getString(HEADER_SIZE + node*NODE_SIZE), docId)) {
+            continue;
+        }
+
+        // Score: sum of tf*idf, with title matches counting more
+        const uint32_t numTitleWords = getValue(HEADER_SIZE + node*NODE_SIZE + 16);
+        double score = 0;
+        for (size_t t = 0; t < terms.size(); ++t) {
+            const std::vector<uint32_t>& pos = match[t]->positions;
+            const size_t titleHits = std::lower_bound(pos.begin(), pos.end(), numTitleWords) - pos.begin();
+            const double weight = double(pos.size() - titleHits) + TITLE_WEIGHT * double(titleHits);
+            const double idf = std::log(1.0 + double(m_numNodes) / double(lists[t].size()));
+            score += (1.0 + std::log(weight)) * idf;
+        }
+
+        // Phrase bonus: all terms in sequence
+        if (terms.size() > 1) {
+            const std::vector<uint32_t>& first = match[0]->positions;
+            bool phrase = false;
+            for (size_t i = 0; i < first.size() && !phrase; ++i) {
+                phrase = true;
+                for (size_t t = 1; t < terms.size() && phrase; ++t) {
+                    phrase = std::binary_search(match[t]->positions.begin(), match[t]->positions.end(), uint32_t(first[i] + t));
+                }
+            }
+            if (phrase) {
+                score *= PHRASE_FACTOR;
+            }
+        }
+        candidates.push_back(Candidate(node, score));
+    }
+
+    // Produce result
+    std::sort(candidates.begin(), candidates.end());
+    for (size_t i = 0; i < candidates.size() && i < maxResults; ++i) {
+        const uint32_t node = candidates[i].node;
+        result.push_back(Result(getString(HEADER_SIZE + node*NODE_SIZE),
+                                int32_t(candidates[i].score * 100),
+                                makeSnippet(node, terms)));
+    }
+    return result;
+}
+
+// Split text into words.
+void
+util::doc::SearchIndex::splitWords(const String_t& text, std::vector<Word>& out)
+{
+    size_t i = 0, n = text.size();
+    while (i < n) {
+        if (isWordCharacter(text[i])) {
+            size_t start = i;
+            while (i < n && isWordCharacter(text[i])) {
+                ++i;
+            }
+            out.push_back(Word(start, i - start));
+        } else {
+            ++i;
+        }
+    }
+}
+
+// Get normalized term for a word.
+String_t
+util::doc::SearchIndex::getTerm(const String_t& text, const Word& word)
+{
+    String_t result = text.substr(word.pos, word.length);
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (result[i] >= 'A' && result[i] <= 'Z') {
+            result[i] = char(result[i] - 'A' + 'a');
+        }
+    }
+    return result;
+}
+
+/** Get 32-bit value from file image.
+    @param pos Position
+    @return value; 0 if out of range */
+uint32_t
+util::doc::SearchIndex::getValue(size_t pos) const
+{
+    ConstBytes_t bytes = m_data.subrange(pos, 4);
+    if (bytes.size() == 4) {
+        const uint8_t* p = bytes.unsafeData();
+        return (uint32_t(p[0]) << 24) + (uint32_t(p[1]) << 16) + (uint32_t(p[2]) << 8) + uint32_t(p[3]);
+    } else {
+        return 0;
+    }
+}
+
+/** Get string from file image.
+    @param pos Position of string reference (offset, length)
+    @return string */
+String_t
+util::doc::SearchIndex::getString(size_t pos) const
+{
+    return afl::string::fromBytes(m_data.subrange(getValue(pos), getValue(pos + 4)));
+}
+
+/** Find term.
+    @param [in]  term   Term
+    @param [out] index  Index into term table
+    @return true if found */
+bool
+util::doc::SearchIndex::findTerm(const String_t& term, size_t& index) const
+{
+    const size_t termTable = HEADER_SIZE + m_numNodes*NODE_SIZE;
+    size_t lo = 0, hi = m_numTerms;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = getString(termTable + mid*TERM_SIZE).compare(term);
+        if (cmp == 0) {
+            index = mid;
+            return true;
+        } else if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return false;
+}
+
+/** Read posting list of a term.
+    @param [in]  termIndex  Index into term table
+    @param [out] out        Postings, sorted by node */
+void
+util::doc::SearchIndex::readPostings(size_t termIndex, std::vector<Posting>& out) const
+{
+    const size_t entry = HEADER_SIZE + m_numNodes*NODE_SIZE + termIndex*TERM_SIZE;
+    ConstBytes_t in = m_data.subrange(getValue(entry + 8), getValue(entry + 12));
+    const uint32_t count = getValue(entry + 16);
+
+    uint32_t node = 0;
+    uint32_t nodeDelta, numPositions;
+    while (out.size() < count && readVarint(in, nodeDelta) && readVarint(in, numPositions)) {
+        node += nodeDelta;
+        if (node >= m_numNodes || numPositions > in.size()) {
+            break;
+        }
+
+        out.push_back(Posting());
+        Posting& p = out.back();
+        p.node = node;
+        p.positions.reserve(numPositions);
+
+        uint32_t pos = 0, delta;
+        while (p.positions.size() < numPositions && readVarint(in, delta)) {
+            pos += delta;
+            p.positions.push_back(pos);
+        }
+    }
+}
+
+/** Make snippet for a search result.
+    @param nodeIndex  Node
+    @param terms      Search terms
+    @return snippet */
+String_t
+util::doc::SearchIndex::makeSnippet(size_t nodeIndex, const std::vector<String_t>& terms) const
+{
+    const String_t text = getString(HEADER_SIZE + nodeIndex*NODE_SIZE + 8);
+    std::vector<Word> words;
+    splitWords(text, words);
+    if (words.empty()) {
+        return String_t();
+    }
+
+    // Find first match; if the match is only in the title, start at the beginning
+    size_t hit = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (std::find(terms.begin(), terms.end(), getTerm(text, words[i])) != terms.end()) {
+            hit = i;
+            break;
+        }
+    }
+
+    // Determine range
+    const size_t first = (hit > SNIPPET_BEFORE ? hit - SNIPPET_BEFORE : 0);
+    const size_t last = std::min(words.size(), first + SNIPPET_WORDS) - 1;
+    const size_t start = words[first].pos;
+    size_t end = words[last].pos + words[last].length;
+    while (end < text.size() && !isSpace(text[end])) {
+        // Include trailing punctuation
+        ++end;
+    }
+
+    // Build it, normalizing whitespace
+    String_t result;
+    if (first > 0) {
+        result += "...";
+    }
+    bool space = false;
+    for (size_t i = start; i < end; ++i) {
+        if (isSpace(text[i])) {
+            space = true;
+        } else {
+            if (space) {
+                result += ' ';
+                space = false;
+            }
+            result += text[i];
+        }
+    }
+    if (last + 1 < words.size()) {
+        result += "...";
+    }
+    return result;
+}
@@ -0,0 +1,125 @@
+/**
+  *  \file util/doc/searchindex.hpp
+  *  \brief Class util::doc::SearchIndex
+  */
+#ifndef C2NG_UTIL_DOC_SEARCHINDEX_HPP
+#define C2NG_UTIL_DOC_SEARCHINDEX_HPP
+
+#include <vector>
+#include "afl/base/memory.hpp"
+#include "afl/base/ptr.hpp"
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/io/stream.hpp"
+#include "afl/string/string.hpp"
+
+namespace util { namespace doc {
+
+    /** Full-text search index.
+        Allows searching the text of a documentation repository.
+        The index is created by SearchIndexBuilder, and stored next to the Index ("search.idx").
+
+        The file is used directly as an in-memory image (memory-mapped if possible):
+        it contains sorted tables of nodes and terms, and a posting list for each term
+        that lists the nodes containing the term together with the word positions.
+
+        A search finds nodes that contain all words of the query,
+        ranked by term frequency and rarity; matches in titles and phrase matches rank higher.
+        Each result comes with a snippet of the page text around the match.
+
+        After load(), the object is only read and can be used by multiple threads. */
+    class SearchIndex : private afl::base::Uncopyable {
+     public:
+        /** A word in a text. */
+        struct Word {
+            size_t pos;          ///< Byte position in text.
+            size_t length;       ///< Length in bytes.
+            Word(size_t pos, size_t length)
+                : pos(pos), length(length)
+                { }
+        };
+
+        /** A search result. */
+        struct Result {
+            String_t address;    ///< Node address, see Index::getNodeAddress().
+            int32_t score;       ///< Score; higher is better.
+            String_t snippet;    ///< Excerpt of the text showing the match.
+            Result(const String_t& address, int32_t score, const String_t& snippet)
+                : address(address), score(score), snippet(snippet)
+                { }
+        };
+
+        /** File signature. */
+        static const uint8_t SIGNATURE[8];
+
+        /** Size of file header (signature, number of nodes, number of terms). */
+        static const size_t HEADER_SIZE = 16;
+
+        /** Size of a node entry (address offset/length, text offset/length, number of title words). */
+        static const size_t NODE_SIZE = 20;
+
+        /** Size of a term entry (term offset/length, postings offset/length, number of postings). */
+        static const size_t TERM_SIZE = 20;
+
+        /** Maximum length of a term in bytes. Longer words are not indexed. */
+        static const size_t MAX_TERM_LENGTH = 64;
+
+        /** Constructor.
+            Makes an empty index that finds nothing. */
+        SearchIndex();
+
+        /** Destructor. */
+        ~SearchIndex();
+
+        /** Load from file.
+            @param in File
+            @throw afl::except::FileFormatException if the file is not a valid search index */
+        void load(afl::io::Stream& in);
+
+        /** Get number of nodes.
+            @return number of indexed nodes */
+        size_t getNumNodes() const;
+
+        /** Get number of terms.
+            @return number of distinct words */
+        size_t getNumTerms() const;
+
+        /** Search.
+            @param query       Search query (words separated by spaces or punctuation)
+            @param docId       If nonempty, only report nodes within this document (address prefix)
+            @param maxResults  Maximum number of results
+            @return results, best first */
+        std::vector<Result> search(const String_t& query, const String_t& docId, size_t maxResults) const;
+
+        /** Split text into words.
+            A word is a sequence of letters, digits, underscores, and non-ASCII (UTF-8) characters.
+            @param [in]  text  Text
+            @param [out] out   Words are appended here */
+        static void splitWords(const String_t& text, std::vector<Word>& out);
+
+        /** Get normalized term for a word.
+            @param text  Text
+            @param word  Word in text, see splitWords()
+            @return term (lower-case) */
+        static String_t getTerm(const String_t& text, const Word& word);
+
+     private:
+        struct Posting;
+        struct Candidate;
+
+        afl::base::Ptr<afl::io::FileMapping> m_mapping;
+        afl::base::ConstBytes_t m_data;
+        size_t m_numNodes;
+        size_t m_numTerms;
+
+        uint32_t getValue(size_t pos) const;
+        String_t getString(size_t pos) const;
+        bool findTerm(const String_t& term, size_t& index) const;
+        void readPostings(size_t termIndex, std::vector<Posting>& out) const;
+        String_t makeSnippet(size_t nodeIndex, const std::vector<String_t>& terms) const;
+    };
+
+} }
+
+#endif
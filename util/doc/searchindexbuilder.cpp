@@ -0,0 +1,225 @@
+/**
+  *  \file util/doc/searchindexbuilder.cpp
+  *  \brief Class util::doc::SearchIndexBuilder
+  */
+
+#include "util/doc/searchindexbuilder.hpp"
+#include "afl/base/growablememory.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/io/xml/defaultentityhandler.hpp"
+#include "afl/io/xml/node.hpp"
+#include "afl/io/xml/parser.hpp"
+#include "afl/io/xml/reader.hpp"
+#include "afl/io/xml/tagnode.hpp"
+#include "afl/io/xml/textnode.hpp"
+#include "afl/io/xml/visitor.hpp"
+#include "util/charsetfactory.hpp"
+#include "util/doc/blobstore.hpp"
+#include "util/doc/searchindex.hpp"
+
+using afl::base::ConstBytes_t;
+using afl::base::GrowableBytes_t;
+using util::doc::SearchIndex;
+
+namespace {
+    /* Tags that do not separate words, e.g. "<b>Star</b>base" */
+    const char*const INLINE_TAGS[] = {
+        "a", "b", "big", "cfg", "em", "font", "i", "kbd", "small", "strong", "sub", "sup", "tt", "u",
+    };
+
+    /* Extract text from parsed XML */
+    class TextExtractor : public afl::io::xml::Visitor {
+     public:
+        TextExtractor(String_t& out)
+            : m_out(out)
+            { }
+        virtual void visitPI(const afl::io::xml::PINode& /*node*/)
+            { }
+        virtual void visitTag(const afl::io::xml::TagNode& node)
+            {
+                bool isInline = false;
+                for (size_t i = 0; i < sizeof(INLINE_TAGS)/sizeof(INLINE_TAGS[0]); ++i) {
+                    if (node.getName() == INLINE_TAGS[i]) {
+                        isInline = true;
+                        break;
+                    }
+                }
+                if (!isInline) {
+                    separate();
+                }
+                visit(node.getChildren());
+                if (!isInline) {
+                    separate();
+                }
+            }
+        virtual void visitText(const afl::io::xml::TextNode& node)
+            { m_out += node.get(); }
+     private:
+        String_t& m_out;
+
+        void separate()
+            {
+                if (!m_out.empty() && m_out[m_out.size()-1] != '\n') {
+                    m_out += '\n';
+                }
+            }
+    };
+
+    /* Append variable-length integer, see readVarint() in searchindex.cpp */
+    void appendVarint(std::vector<uint8_t>& out, uint32_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(uint8_t((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(uint8_t(value));
+    }
+
+    void appendUInt32BE(GrowableBytes_t& out, uint32_t value)
+    {
+        const uint8_t bytes[4] = { uint8_t(value >> 24), uint8_t(value >> 16), uint8_t(value >> 8), uint8_t(value) };
+        out.append(bytes);
+    }
+
+    /* Append a data block to the data area, and a reference (offset, length) to a table */
+    void appendReference(GrowableBytes_t& table, GrowableBytes_t& data, size_t dataStart, ConstBytes_t bytes)
+    {
+        appendUInt32BE(table, uint32_t(dataStart + data.size()));
+        appendUInt32BE(table, uint32_t(bytes.size()));
+        data.append(bytes);
+    }
+
+    /* Record occurrences of words */
+    void addWords(std::map<String_t, std::vector<uint32_t> >& out, const String_t& text, const std::vector<SearchIndex::Word>& words, uint32_t& pos)
+    {
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (words[i].length <= SearchIndex::MAX_TERM_LENGTH) {
+                out[SearchIndex::getTerm(text, words[i])].push_back(pos);
+            }
+            ++pos;
+        }
+    }
+}
+
+// Constructor.
+util::doc::SearchIndexBuilder::SearchIndexBuilder()
+    : m_nodes(),
+      m_terms()
+{ }
+
+// Destructor.
+util::doc::SearchIndexBuilder::~SearchIndexBuilder()
+{ }
+
+// Add a node.
+void
+util::doc::SearchIndexBuilder::addNode(const String_t& address, const String_t& title, const String_t& text)
+{
+    const uint32_t node = uint32_t(m_nodes.size());
+
+    // Split into words. Title words come first.
+    std::vector<SearchIndex::Word> titleWords, textWords;
+    SearchIndex::splitWords(title, titleWords);
+    SearchIndex::splitWords(text, textWords);
+
+    std::map<String_t, std::vector<uint32_t> > occurrences;
+    uint32_t pos = 0;
+    addWords(occurrences, title, titleWords, pos);
+    addWords(occurrences, text, textWords, pos);
+
+    // Append postings
+    for (std::map<String_t, std::vector<uint32_t> >::const_iterator it = occurrences.begin(); it != occurrences.end(); ++it) {
+        Term& t = m_terms[it->first];
+        appendVarint(t.postings, node - t.lastNode);
+        appendVarint(t.postings, uint32_t(it->second.size()));
+        uint32_t last = 0;
+        for (size_t i = 0; i < it->second.size(); ++i) {
+            appendVarint(t.postings, it->second[i] - last);
+            last = it->second[i];
+        }
+        t.lastNode = node;
+        ++t.numPostings;
+    }
+
+    m_nodes.push_back(Node(address, text, uint32_t(titleWords.size())));
+}
+
+// Add all nodes of a documentation repository.
+void
+util::doc::SearchIndexBuilder::addIndex(const Index& idx, const BlobStore& blobStore)
+{
+    addTree(idx, idx.root(), blobStore);
+}
+
+// Get number of nodes.
+size_t
+util::doc::SearchIndexBuilder::getNumNodes() const
+{
+    return m_nodes.size();
+}
+
+// Save search index.
+void
+util::doc::SearchIndexBuilder::save(afl::io::Stream& out) const
+{
+    const size_t dataStart = SearchIndex::HEADER_SIZE + m_nodes.size() * SearchIndex::NODE_SIZE + m_terms.size() * SearchIndex::TERM_SIZE;
+
+    GrowableBytes_t header;
+    header.append(SearchIndex::SIGNATURE);
+    appendUInt32BE(header, uint32_t(m_nodes.size()));
+    appendUInt32BE(header, uint32_t(m_terms.size()));
+
+    GrowableBytes_t tables, data;
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        appendReference(tables, data, dataStart, afl::string::toBytes(m_nodes[i].address));
+        appendReference(tables, data, dataStart, afl::string::toBytes(m_nodes[i].text));
+        appendUInt32BE(tables, m_nodes[i].numTitleWords);
+    }
+    for (std::map<String_t, Term>::const_iterator it = m_terms.begin(); it != m_terms.end(); ++it) {
+        const std::vector<uint8_t>& p = it->second.postings;
+        appendReference(tables, data, dataStart, afl::string::toBytes(it->first));
+        appendReference(tables, data, dataStart, ConstBytes_t::unsafeCreate(p.empty() ? 0 : &p[0], p.size()));
+        appendUInt32BE(tables, it->second.numPostings);
+    }
+
+    out.fullWrite(header);
+    out.fullWrite(tables);
+    out.fullWrite(data);
+}
+
+// Extract plain text from content.
+String_t
+util::doc::SearchIndexBuilder::extractText(afl::base::ConstBytes_t content)
+{
+    afl::io::ConstMemoryStream ms(content);
+    util::CharsetFactory csFactory;
+    afl::io::xml::DefaultEntityHandler eh;
+    afl::io::xml::Nodes_t nodes;
+    afl::io::xml::Reader rdr(ms, eh, csFactory);
+    rdr.setWhitespaceMode(afl::io::xml::Reader::AllWS);
+    afl::io::xml::Parser(rdr).parseNodes(nodes);
+
+    String_t result;
+    TextExtractor(result).visit(nodes);
+    return result;
+}
+
+/** Add a node and its children.
+    @param idx        Index
+    @param node       Node
+    @param blobStore  Blob store */
+void
+util::doc::SearchIndexBuilder::addTree(const Index& idx, Index::Handle_t node, const BlobStore& blobStore)
+{
+    const BlobStore::ObjectId_t objId = idx.getNodeContentId(node);
+    const String_t address = idx.getNodeAddress(node, String_t());
+    if (!objId.empty() && !address.empty()) {
+        addNode(address, idx.getNodeTitle(node), extractText(blobStore.getObject(objId)->get()));
+    }
+
+    for (size_t i = 0, n = idx.getNumNodeChildren(node); i < n; ++i) {
+        addTree(idx, idx.getNodeChildByIndex(node, i), blobStore);
+    }
+}
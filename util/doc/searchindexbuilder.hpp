@@ -0,0 +1,86 @@
+/**
+  *  \file util/doc/searchindexbuilder.hpp
+  *  \brief Class util::doc::SearchIndexBuilder
+  */
+#ifndef C2NG_UTIL_DOC_SEARCHINDEXBUILDER_HPP
+#define C2NG_UTIL_DOC_SEARCHINDEXBUILDER_HPP
+
+#include <map>
+#include <vector>
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/io/stream.hpp"
+#include "afl/string/string.hpp"
+#include "util/doc/index.hpp"
+
+namespace util { namespace doc {
+
+    class BlobStore;
+
+    /** Full-text search index builder.
+        Collects the text of documentation nodes and produces a file that can be loaded into a SearchIndex.
+
+        To use,
+        - call addIndex() or addNode() to add content
+        - call save() */
+    class SearchIndexBuilder : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            Makes an empty builder. */
+        SearchIndexBuilder();
+
+        /** Destructor. */
+        ~SearchIndexBuilder();
+
+        /** Add a node.
+            @param address Node address
+            @param title   Node title; words in the title rank higher
+            @param text    Plain text */
+        void addNode(const String_t& address, const String_t& title, const String_t& text);
+
+        /** Add all nodes of a documentation repository.
+            Adds all nodes that have content.
+            @param idx        Index
+            @param blobStore  Blob store containing the content */
+        void addIndex(const Index& idx, const BlobStore& blobStore);
+
+        /** Get number of nodes.
+            @return number of nodes added so far */
+        size_t getNumNodes() const;
+
+        /** Save search index.
+            @param out Stream */
+        void save(afl::io::Stream& out) const;
+
+        /** Extract plain text from content.
+            @param content Content (XML, as stored in a BlobStore)
+            @return text */
+        static String_t extractText(afl::base::ConstBytes_t content);
+
+     private:
+        struct Node {
+            String_t address;
+            String_t text;
+            uint32_t numTitleWords;
+            Node(const String_t& address, const String_t& text, uint32_t numTitleWords)
+                : address(address), text(text), numTitleWords(numTitleWords)
+                { }
+        };
+        struct Term {
+            uint32_t numPostings;
+            uint32_t lastNode;
+            std::vector<uint8_t> postings;
+            Term()
+                : numPostings(0), lastNode(0), postings()
+                { }
+        };
+
+        std::vector<Node> m_nodes;
+        std::map<String_t, Term> m_terms;
+
+        void addTree(const Index& idx, Index::Handle_t node, const BlobStore& blobStore);
+    };
+
+} }
+
+#endif
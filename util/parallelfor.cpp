@@ -0,0 +1,67 @@
+/**
+  *  \file util/parallelfor.cpp
+  *  \brief Function util::parallelFor
+  */
+
+#include "util/parallelfor.hpp"
+#include "afl/base/runnable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+
+namespace {
+    /* Worker for parallelFor().
+       All workers share one instance of this object. */
+    class Worker : public afl::base::Runnable {
+     public:
+        Worker(size_t n, afl::base::Closure<void(size_t)>& body)
+            : m_mutex(), m_next(0), m_limit(n), m_body(body)
+            { }
+
+        virtual void run()
+            {
+                size_t index;
+                while (fetch(index)) {
+                    m_body.call(index);
+                }
+            }
+
+     private:
+        afl::sys::Mutex m_mutex;
+        size_t m_next;
+        const size_t m_limit;
+        afl::base::Closure<void(size_t)>& m_body;
+
+        bool fetch(size_t& index)
+            {
+                afl::sys::MutexGuard g(m_mutex);
+                if (m_next < m_limit) {
+                    index = m_next++;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+    };
+}
+
+void
+util::parallelFor(size_t n, size_t numThreads, const char* threadName, afl::base::Closure<void(size_t)>& body)
+{
+    Worker worker(n, body);
+    if (numThreads > n) {
+        numThreads = n;
+    }
+    if (numThreads <= 1) {
+        worker.run();
+    } else {
+        afl::container::PtrVector<afl::sys::Thread> threads;
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.pushBackNew(new afl::sys::Thread(threadName, worker))->start();
+        }
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads[i]->join();
+        }
+    }
+}
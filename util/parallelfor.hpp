@@ -0,0 +1,31 @@
+/**
+  *  \file util/parallelfor.hpp
+  *  \brief Function util::parallelFor
+  */
+#ifndef C2NG_UTIL_PARALLELFOR_HPP
+#define C2NG_UTIL_PARALLELFOR_HPP
+
+#include "afl/base/closure.hpp"
+#include "afl/base/types.hpp"
+
+namespace util {
+
+    /** Process a range of indexes using multiple threads.
+        Calls body.call(i) for every i in [0, n).
+        All threads share the range and take the next unprocessed index until none is left,
+        so the order in which indexes are processed is unspecified.
+
+        The function returns when all indexes have been processed.
+        If numThreads (limited to n) is 1 or less, the body is called in the calling thread, without creating threads.
+        The body is called from multiple threads in parallel and must synchronize accesses to shared data.
+        Exceptions must not leave body.call().
+
+        \param n          Number of indexes
+        \param numThreads Maximum number of threads
+        \param threadName Name for created threads
+        \param body       Body */
+    void parallelFor(size_t n, size_t numThreads, const char* threadName, afl::base::Closure<void(size_t)>& body);
+
+}
+
+#endif